@@ -47,6 +47,7 @@
 
 #define MP42TS_PRINT_TIME_MS 500 /*refresh printed info every CLOCK_REFRESH ms*/
 #define MP42TS_VIDEO_FREQ 1000 /*meant to send AVC IDR only every CLOCK_REFRESH ms*/
+#define MP42TS_UDP_BURST 32 /*max number of UDP datagrams sent in one call*/
 
 
 s32 temi_id_1 = -1;
@@ -123,6 +124,7 @@ static GFINLINE void usage()
 	        "                          in this mode, PAT, PMT and PCR will be inserted before the first TS packet of the RAP PES\n"
 	        "-flush-rap             same as -rap but flushes all other streams (sends remaining PES packets) before inserting PAT/PMT\n"
 	        "-nb-pack N             specifies to pack up to N TS packets together before sending on network or writing to file\n"
+	        "-prog-threads N        fetches up to N AUs ahead of the muxer on one thread per program (file sources only). Default is 0 (disabled)\n"
 	        "-pcr-ms N              sets max interval in ms between 2 PCR. Default is 100 ms or at each PES header\n"
 	        "-force-pcr-only        allows sending PCR-only packets to enforce the requested PCR rate - STILL EXPERIMENTAL.\n"
 	        "-ttl N                 specifies Time-To-Live for multicast. Default is 1.\n"
@@ -1936,7 +1938,7 @@ static GFINLINE GF_Err parse_args(int argc, char **argv, u32 *mux_rate, u32 *car
                                   Bool *real_time, u32 *run_time, char **video_buffer, u32 *video_buffer_size,
                                   u32 *audio_input_type, char **audio_input_ip, u16 *audio_input_port,
                                   u32 *output_type, char **ts_out, char **udp_out, char **rtp_out, u16 *output_port,
-                                  char** segment_dir, u32 *segment_duration, char **segment_manifest, u32 *segment_number, char **segment_http_prefix, u32 *split_rap, u32 *nb_pck_pack, u32 *pcr_ms, u32 *ttl, const char **ip_ifce, const char **temi_url, u32 *sdt_refresh_rate, Bool *enable_forced_pcr)
+                                  char** segment_dir, u32 *segment_duration, char **segment_manifest, u32 *segment_number, char **segment_http_prefix, u32 *split_rap, u32 *nb_pck_pack, u32 *pcr_ms, u32 *ttl, const char **ip_ifce, const char **temi_url, u32 *sdt_refresh_rate, Bool *enable_forced_pcr, u32 *prog_threads)
 {
 	Bool rate_found=0, mpeg4_carousel_found=0, time_found=0, src_found=0, dst_found=0, audio_input_found=0, video_input_found=0,
 	     seg_dur_found=0, seg_dir_found=0, seg_manifest_found=0, seg_number_found=0, seg_http_found=0, real_time_found=0, insert_ntp=0;
@@ -2089,6 +2091,8 @@ static GFINLINE GF_Err parse_args(int argc, char **argv, u32 *mux_rate, u32 *car
 			*nb_pck_pack = atoi(next_arg);
 		} else if (CHECK_PARAM("-nb-pck")) {
 			*nb_pck_pack = atoi(next_arg);
+		} else if (CHECK_PARAM("-prog-threads")) {
+			*prog_threads = atoi(next_arg);
 		} else if (CHECK_PARAM("-pcr-ms")) {
 			*pcr_ms = atoi(next_arg);
 		} else if (CHECK_PARAM("-ttl")) {
@@ -2370,6 +2374,16 @@ static GF_Err write_manifest(char *manifest, char *segment_dir, u32 segment_dura
 	}
 }
 
+static void send_udp_burst(GF_Socket *sk, GF_SockDatagram *dgrams, u32 *nb_dgrams)
+{
+	u32 nb_sent = 0;
+	GF_Err e = gf_sk_send_batch(sk, dgrams, *nb_dgrams, &nb_sent);
+	if (e) {
+		fprintf(stderr, "Error %s sending UDP packet (%d/%d sent)\n", gf_error_to_string(e), nb_sent, *nb_dgrams);
+	}
+	*nb_dgrams = 0;
+}
+
 int main(int argc, char **argv)
 {
 	/********************/
@@ -2377,13 +2391,16 @@ int main(int argc, char **argv)
 	/********************/
 	const char *ts_pck;
 	char *ts_pack_buffer = NULL;
+	char *udp_burst_buffer = NULL;
+	GF_SockDatagram udp_burst[MP42TS_UDP_BURST];
+	u32 nb_udp_burst = 0;
 	GF_Err e;
 	u32 run_time;
 	Bool real_time, is_stdout;
 	s64 pcr_init_val = -1;
 	u32 usec_till_next, ttl, split_rap, sdt_refresh_rate;
 	GF_M2TS_PackMode pes_packing_mode;
-	u32 i, j, mux_rate, nb_sources, cur_pid, carrousel_rate, last_print_time, last_video_time, bifs_use_pes, psi_refresh_rate, nb_pck_pack, nb_pck_in_pack, pcr_ms;
+	u32 i, j, mux_rate, nb_sources, cur_pid, carrousel_rate, last_print_time, last_video_time, bifs_use_pes, psi_refresh_rate, nb_pck_pack, nb_pck_in_pack, pcr_ms, prog_threads;
 	char *ts_out = NULL, *udp_out = NULL, *rtp_out = NULL, *audio_input_ip = NULL;
 	FILE *ts_output_file = NULL;
 	GF_Socket *ts_output_udp_sk = NULL, *audio_input_udp_sk = NULL;
@@ -2450,6 +2467,7 @@ int main(int argc, char **argv)
 	video_buffer_size = 0;
 	nb_pck_pack = 1;
 	pcr_ms = 100;
+	prog_threads = 0;
 #ifndef GPAC_DISABLE_PLAYER
 	aac_reader = AAC_Reader_new();
 #endif
@@ -2468,7 +2486,7 @@ int main(int argc, char **argv)
 	                        &real_time, &run_time, &video_buffer, &video_buffer_size,
 	                        &audio_input_type, &audio_input_ip, &audio_input_port,
 	                        &output_type, &ts_out, &udp_out, &rtp_out, &output_port,
-	                        &segment_dir, &segment_duration, &segment_manifest, &segment_number, &segment_http_prefix, &split_rap, &nb_pck_pack, &pcr_ms, &ttl, &ip_ifce, &insert_temi, &sdt_refresh_rate, &enable_forced_pcr)) {
+	                        &segment_dir, &segment_duration, &segment_manifest, &segment_number, &segment_http_prefix, &split_rap, &nb_pck_pack, &pcr_ms, &ttl, &ip_ifce, &insert_temi, &sdt_refresh_rate, &enable_forced_pcr, &prog_threads)) {
 		goto exit;
 	}
 
@@ -2685,8 +2703,20 @@ int main(int argc, char **argv)
 	}
 	gf_m2ts_mux_update_config(muxer, 1);
 
-	if (nb_pck_pack>1) {
-		ts_pack_buffer = gf_malloc(sizeof(char) * 188 * nb_pck_pack);
+	if (prog_threads) {
+		if (real_time || audio_input_type || video_buffer) {
+			fprintf(stderr, "Program threads are only supported for file sources - disabling\n");
+		} else {
+			gf_m2ts_mux_enable_program_threads(muxer, prog_threads);
+		}
+	}
+
+	/*packets are written by the muxer directly in the pack buffer*/
+	if (!nb_pck_pack) nb_pck_pack = 1;
+	ts_pack_buffer = gf_malloc(sizeof(char) * 188 * nb_pck_pack);
+	/*UDP datagrams are queued while flushing the muxer and sent in bursts*/
+	if (ts_output_udp_sk) {
+		udp_burst_buffer = gf_malloc(sizeof(char) * 188 * nb_pck_pack * MP42TS_UDP_BURST);
 	}
 
 	/*****************/
@@ -2731,22 +2761,11 @@ int main(int argc, char **argv)
 		}
 
 		/*flush all packets*/
-		nb_pck_in_pack=0;
-		while ((ts_pck = gf_m2ts_mux_process(muxer, &status, &usec_till_next)) != NULL) {
-
-			if (ts_pack_buffer) {
-				memcpy(ts_pack_buffer + 188 * nb_pck_in_pack, ts_pck, 188);
-				nb_pck_in_pack++;
-
-				if (nb_pck_in_pack < nb_pck_pack)
-					continue;
-
-				ts_pck = (const char *) ts_pack_buffer;
-			} else {
-				nb_pck_in_pack = 1;
-			}
+		while (1) {
+			gf_m2ts_mux_process_burst(muxer, (u8 *) ts_pack_buffer, nb_pck_pack, &nb_pck_in_pack, &status, &usec_till_next);
+			if (!nb_pck_in_pack) break;
+			ts_pck = (const char *) ts_pack_buffer;
 
-call_flush:
 			if (ts_output_file != NULL) {
 				gf_fwrite(ts_pck, 1, 188 * nb_pck_in_pack, ts_output_file);
 				if (segment_duration && (muxer->time.sec > prev_seg_time.sec + segment_duration)) {
@@ -2788,9 +2807,15 @@ call_flush:
 			}
 
 			if (ts_output_udp_sk != NULL) {
-				e = gf_sk_send(ts_output_udp_sk, (char*)ts_pck, 188 * nb_pck_in_pack);
-				if (e) {
-					fprintf(stderr, "Error %s sending UDP packet\n", gf_error_to_string(e));
+				char *dgram = udp_burst_buffer + 188 * nb_pck_pack * nb_udp_burst;
+				memcpy(dgram, ts_pck, 188 * nb_pck_in_pack);
+				udp_burst[nb_udp_burst].header = NULL;
+				udp_burst[nb_udp_burst].header_size = 0;
+				udp_burst[nb_udp_burst].data = dgram;
+				udp_burst[nb_udp_burst].size = 188 * nb_pck_in_pack;
+				nb_udp_burst++;
+				if (nb_udp_burst == MP42TS_UDP_BURST) {
+					send_udp_burst(ts_output_udp_sk, udp_burst, &nb_udp_burst);
 				}
 			}
 #ifndef GPAC_DISABLE_STREAMING
@@ -2809,15 +2834,12 @@ call_flush:
 			}
 #endif
 
-			nb_pck_in_pack = 0;
-
 			if (status>=GF_M2TS_STATE_PADDING) {
 				break;
 			}
 		}
-		if (nb_pck_in_pack) {
-			ts_pck = (const char *) ts_pack_buffer;
-			goto call_flush;
+		if (nb_udp_burst) {
+			send_udp_burst(ts_output_udp_sk, udp_burst, &nb_udp_burst);
 		}
 
 		/*push video*/
@@ -2881,6 +2903,7 @@ call_flush:
 
 exit:
 	if (ts_pack_buffer) gf_free(ts_pack_buffer);
+	if (udp_burst_buffer) gf_free(udp_burst_buffer);
 	run = 0;
 	if (segment_duration) {
 		write_manifest(segment_manifest, segment_dir, segment_duration, segment_prefix, segment_http_prefix, segment_index - segment_number, segment_index, 1);
@@ -430,6 +430,7 @@ void PrintDASHUsage()
 			"   \"sdtp\":          use sdtp box to indicate sample dependencies and don't write info in trun sample flags\n"
 			"   \"both\":          use sdtp box to indicate sample dependencies and also write info in trun sample flags\n"
 	        " -no-cache            disable file cache for dash inputs .\n"
+	        " -dash-threads N      segments representations of an adaptation set in parallel on N threads. Output is identical to sequential segmentation. Ignored with -dash-ctx\n"
 	        " -no-loop             disables looping content in live mode and uses period switch instead.\n"
 	        " -bound               enables video segmentation with same method as audio (i.e.: always try to split before or at the segment boundary - not after)\n"
 	        " -closest             enables video segmentation closest to the segment boundary (before or after)\n"
@@ -714,6 +715,7 @@ void PrintEncryptUsage()
 {
 	fprintf(stderr, "ISMA Encryption/Decryption Options\n"
 	        " -crypt drm_file      crypts a specific track using ISMA AES CTR 128\n"
+	        " -crypt-threads N     encrypts CENC tracks and samples in parallel on N threads. Output is identical to single-threaded encryption\n"
 	        " -decrypt [drm_file]  decrypts a specific track using ISMA AES CTR 128\n"
 	        "                       * Note: drm_file can be omitted if keys are in file\n"
 	        " -set-kms kms_uri     changes KMS location for all tracks or a given one.\n"
@@ -2343,6 +2345,8 @@ FILE *logfile = NULL;
 static u32 run_for=0;
 static u32 dash_cumulated_time,dash_prev_time,dash_now_time;
 static Bool no_cache=GF_FALSE;
+static u32 dash_threads=0;
+static u32 crypt_threads=0;
 static Bool no_loop=GF_FALSE;
 static Bool split_on_bound=GF_FALSE;
 static Bool split_on_closest=GF_FALSE;
@@ -3012,6 +3016,11 @@ u32 mp4box_parse_args_continue(int argc, char **argv, u32 *current_index)
 			open_edit = GF_TRUE;
 			i += 1;
 		}
+		else if (!strcmp(arg, "-crypt-threads")) {
+			CHECK_NEXT_ARG
+			crypt_threads = atoi(argv[i + 1]);
+			i += 1;
+		}
 		else if (!strcmp(arg, "-decrypt")) {
 			CHECK_NEXT_ARG
 			crypt = 2;
@@ -3812,6 +3821,11 @@ Bool mp4box_parse_args(int argc, char **argv)
 		else if (!stricmp(arg, "-no-cache")) {
 			no_cache = GF_TRUE;
 		}
+		else if (!stricmp(arg, "-dash-threads")) {
+			CHECK_NEXT_ARG
+			dash_threads = atoi(argv[i + 1]);
+			i++;
+		}
 		else if (!stricmp(arg, "-no-loop")) {
 			no_loop = GF_TRUE;
 		}
@@ -4699,6 +4713,7 @@ int mp4boxMain(int argc, char **argv)
 		if (!e) e = gf_dasher_set_split_on_closest(dasher, split_on_closest);
 		if (!e && dash_cues) e = gf_dasher_set_cues(dasher, dash_cues, strict_cues);
 		if (!e) e = gf_dasher_set_isobmff_options(dasher, mvex_after_traks, sdtp_in_traf);
+		if (!e) e = gf_dasher_set_threads(dasher, dash_threads);
 
 		for (i=0; i < nb_dash_inputs; i++) {
 			if (!e) e = gf_dasher_add_input(dasher, &dash_inputs[i]);
@@ -5471,7 +5486,7 @@ int mp4boxMain(int argc, char **argv)
 				goto err_exit;
 			}
 			if (crypt == 1) {
-				e = gf_crypt_file(file, drm_file);
+				e = gf_crypt_file_ex(file, drm_file, crypt_threads);
 			} else if (crypt ==2) {
 				e = gf_decrypt_file(file, drm_file);
 			}
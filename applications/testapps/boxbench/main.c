@@ -0,0 +1,202 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - ISOBMFF box parsing benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/isomedia.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: boxbench [options] [file.mp4]\n"
+	        "\n"
+	        "If no file is given, a fragmented file is generated in the current directory and parsed.\n"
+	        "\n"
+	        "-frags N: number of fragments of the generated file (default 10000)\n"
+	        "-loops N: number of times the file is parsed (default 10)\n"
+	        "-out name: name of the generated file (default boxbench.mp4)\n"
+	       );
+}
+
+static GF_Err generate_fragmented_file(const char *name, u32 nb_frags)
+{
+	GF_GenericSampleDescription udesc;
+	GF_ISOSample *samp;
+	GF_ISOFile *file;
+	GF_Err e;
+	u32 i, j, track, di;
+	char data[100];
+
+	file = gf_isom_open(name, GF_ISOM_OPEN_WRITE, NULL);
+	if (!file) return gf_isom_last_error(NULL);
+
+	track = gf_isom_new_track(file, 1, GF_ISOM_MEDIA_VISUAL, 1000);
+	gf_isom_set_track_enabled(file, track, 1);
+	memset(&udesc, 0, sizeof(GF_GenericSampleDescription));
+	udesc.codec_tag = GF_4CC('b','e','n','c');
+	udesc.width = 320;
+	udesc.height = 240;
+	e = gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &di);
+	if (!e) e = gf_isom_setup_track_fragment(file, 1, 1, 40, 0, 0, 0, 0, 0);
+	if (!e) e = gf_isom_finalize_for_fragment(file, 0);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+
+	memset(data, 0, sizeof(data));
+	samp = gf_isom_sample_new();
+	samp->data = data;
+	samp->dataLength = sizeof(data);
+	for (i=0; i<nb_frags; i++) {
+		e = gf_isom_start_fragment(file, GF_TRUE);
+		if (!e) e = gf_isom_set_traf_base_media_decode_time(file, 1, i*40*4);
+		for (j=0; !e && (j<4); j++) {
+			samp->DTS = (i*4 + j)*40;
+			samp->IsRAP = j ? RAP_NO : RAP;
+			e = gf_isom_fragment_add_sample(file, 1, samp, 1, 40, 0, 0, GF_FALSE);
+		}
+		if (e) break;
+	}
+	samp->data = NULL;
+	gf_isom_sample_del(&samp);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+static Bool is_container(u32 type)
+{
+	switch (type) {
+	case GF_4CC('m','o','o','v'):
+	case GF_4CC('t','r','a','k'):
+	case GF_4CC('m','d','i','a'):
+	case GF_4CC('m','i','n','f'):
+	case GF_4CC('d','i','n','f'):
+	case GF_4CC('s','t','b','l'):
+	case GF_4CC('m','v','e','x'):
+	case GF_4CC('e','d','t','s'):
+	case GF_4CC('m','o','o','f'):
+	case GF_4CC('t','r','a','f'):
+	case GF_4CC('m','f','r','a'):
+		return GF_TRUE;
+	}
+	return GF_FALSE;
+}
+
+/*counts boxes the library will instantiate when parsing the file - only plain containers are walked*/
+static u32 count_boxes(GF_BitStream *bs, u64 end)
+{
+	u32 nb_boxes = 0;
+	while (gf_bs_get_position(bs) + 8 <= end) {
+		u64 start = gf_bs_get_position(bs);
+		u64 size = gf_bs_read_u32(bs);
+		u32 type = gf_bs_read_u32(bs);
+		if (size==1) size = gf_bs_read_u64(bs);
+		else if (!size) size = end - start;
+		if (size < 8) break;
+
+		nb_boxes++;
+		if (is_container(type)) nb_boxes += count_boxes(bs, start + size);
+		gf_bs_seek(bs, start + size);
+	}
+	return nb_boxes;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, nb_frags=10000, nb_loops=10, nb_boxes;
+	u64 start, parse_time;
+	const char *file_name = NULL;
+	const char *out_name = "boxbench.mp4";
+	FILE *f;
+	GF_BitStream *bs;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-frags") && (i+1<(u32) argc)) {
+			nb_frags = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-loops") && (i+1<(u32) argc)) {
+			nb_loops = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-out") && (i+1<(u32) argc)) {
+			out_name = argv[i+1];
+			i++;
+		} else if ((arg[0]=='-') || file_name) {
+			usage();
+			return 1;
+		} else {
+			file_name = arg;
+		}
+	}
+	if (!nb_loops) nb_loops = 1;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	if (!file_name) {
+		fprintf(stderr, "Generating %d fragments in %s\n", nb_frags, out_name);
+		e = generate_fragmented_file(out_name, nb_frags);
+		if (e) {
+			fprintf(stderr, "Failed to generate test file: %s\n", gf_error_to_string(e));
+			gf_sys_close();
+			return 1;
+		}
+		file_name = out_name;
+	}
+
+	f = gf_fopen(file_name, "rb");
+	if (!f) {
+		fprintf(stderr, "Cannot open %s\n", file_name);
+		gf_sys_close();
+		return 1;
+	}
+	bs = gf_bs_from_file(f, GF_BITSTREAM_READ);
+	nb_boxes = count_boxes(bs, gf_bs_get_size(bs));
+	gf_bs_del(bs);
+	gf_fclose(f);
+
+	parse_time = 0;
+	for (i=0; i<nb_loops; i++) {
+		GF_ISOFile *file;
+		start = gf_sys_clock_high_res();
+		file = gf_isom_open(file_name, GF_ISOM_OPEN_READ, NULL);
+		parse_time += gf_sys_clock_high_res() - start;
+		if (!file) {
+			fprintf(stderr, "Failed to parse %s: %s\n", file_name, gf_error_to_string(gf_isom_last_error(NULL)) );
+			gf_sys_close();
+			return 1;
+		}
+		gf_isom_close(file);
+	}
+	if (!parse_time) parse_time = 1;
+
+	fprintf(stdout, "%s: %d boxes parsed %d times in "LLU" us - %.2f boxes/sec\n", file_name, nb_boxes, nb_loops, parse_time, ((Double) nb_boxes) * nb_loops * 1000000 / parse_time);
+
+	gf_sys_close();
+	return 0;
+}
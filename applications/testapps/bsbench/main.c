@@ -0,0 +1,205 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - bitstream reader benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/bitstream.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: bsbench [options] [file]\n"
+	        "\n"
+	        "Reads the file (typically a large AVC/HEVC bitstream) from memory with a fixed pattern of\n"
+	        "bit fields and exp-Golomb codes, once bit by bit (previous reader behaviour) and once with gf_bs_read_int.\n"
+	        "If no file is given, a pseudo-random buffer is used.\n"
+	        "\n"
+	        "-size N: size in MB of the generated buffer (default 32)\n"
+	        "-loops N: number of passes over the data (default 4)\n"
+	       );
+}
+
+static u32 nb_eos;
+static void on_eos(void *par)
+{
+	nb_eos++;
+}
+
+/*exported by libgpac but not part of the public API*/
+u8 gf_bs_read_bit(GF_BitStream *bs);
+
+/*previous reader behaviour: every field is assembled bit by bit*/
+static u32 read_bits_ref(GF_BitStream *bs, u32 nBits)
+{
+	u32 ret = 0;
+	while (nBits--) {
+		ret <<= 1;
+		ret |= gf_bs_read_bit(bs);
+	}
+	return ret;
+}
+
+static u32 read_ue_ref(GF_BitStream *bs)
+{
+	u32 nb_zeros = 0;
+	while (!gf_bs_read_bit(bs) && (nb_zeros<32)) nb_zeros++;
+	if (!nb_zeros) return 0;
+	return (1<<nb_zeros) - 1 + read_bits_ref(bs, nb_zeros);
+}
+
+static u32 read_ue(GF_BitStream *bs)
+{
+	u32 nb_zeros = 0;
+	while (!gf_bs_read_int(bs, 1) && (nb_zeros<32)) nb_zeros++;
+	if (!nb_zeros) return 0;
+	return (1<<nb_zeros) - 1 + gf_bs_read_int(bs, nb_zeros);
+}
+
+/*field widths mimicking slice/SPS header parsing: small flags, ue(v) codes, a few long fields*/
+static const u32 pattern[] = {1, 2, 0, 1, 3, 8, 0, 5, 16, 1, 0, 4, 32, 7, 0, 1, 24, 6, 12, 0, 2, 13};
+#define NB_FIELDS	(sizeof(pattern)/sizeof(u32))
+
+static u64 run_pass(char *data, u32 size, Bool ref, u64 *checksum)
+{
+	u32 i = 0;
+	u64 start, sum = 0;
+	GF_BitStream *bs = gf_bs_new(data, size, GF_BITSTREAM_READ);
+	gf_bs_set_eos_callback(bs, on_eos, NULL);
+
+	start = gf_sys_clock_high_res();
+	/*stop before the end, tail reads are checked separately*/
+	while (gf_bs_get_position(bs) + 16 < size) {
+		u32 nb = pattern[i];
+		u32 v;
+		if (ref) v = nb ? read_bits_ref(bs, nb) : read_ue_ref(bs);
+		else v = nb ? gf_bs_read_int(bs, nb) : read_ue(bs);
+		sum = sum*31 + v;
+		if (++i == NB_FIELDS) {
+			i = 0;
+			/*byte-aligned reads as done for NAL headers and box fields*/
+			gf_bs_align(bs);
+			sum += gf_bs_read_u8(bs);
+			sum += gf_bs_read_u16(bs);
+			sum += gf_bs_read_u32(bs);
+		}
+	}
+	start = gf_sys_clock_high_res() - start;
+
+	/*read past the end: values and EOS notifications must match*/
+	for (i=0; i<64; i++) {
+		u32 nb = 1 + (i*7) % 32;
+		sum = sum*31 + (ref ? read_bits_ref(bs, nb) : gf_bs_read_int(bs, nb));
+	}
+	sum += gf_bs_get_position(bs) + gf_bs_get_bit_position(bs);
+	gf_bs_del(bs);
+	*checksum = sum;
+	return start;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, size = 32, nb_loops = 4, eos_ref, eos_new;
+	u64 time_ref, time_new, sum_ref, sum_new;
+	const char *file_name = NULL;
+	char *data;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			size = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-loops") && (i+1<(u32) argc)) {
+			nb_loops = atoi(argv[i+1]);
+			i++;
+		} else if ((arg[0]=='-') || file_name) {
+			usage();
+			return 1;
+		} else {
+			file_name = arg;
+		}
+	}
+	if (!nb_loops) nb_loops = 1;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	if (file_name) {
+		u64 fsize;
+		FILE *f = gf_fopen(file_name, "rb");
+		if (!f) {
+			fprintf(stderr, "Cannot open %s\n", file_name);
+			gf_sys_close();
+			return 1;
+		}
+		gf_fseek(f, 0, SEEK_END);
+		fsize = gf_ftell(f);
+		gf_fseek(f, 0, SEEK_SET);
+		if (fsize > 0x7FFFFFFF) fsize = 0x7FFFFFFF;
+		size = (u32) fsize;
+		data = gf_malloc(size);
+		if ((u32) fread(data, 1, size, f) != size) {
+			fprintf(stderr, "Failed to read %s\n", file_name);
+			gf_fclose(f);
+			gf_free(data);
+			gf_sys_close();
+			return 1;
+		}
+		gf_fclose(f);
+	} else {
+		if (!size) size = 1;
+		size *= 1024*1024;
+		data = gf_malloc(size);
+		gf_rand_init(GF_TRUE);
+		for (i=0; i<size; i++) data[i] = (char) gf_rand();
+		file_name = "random buffer";
+	}
+	if (size < 32) {
+		fprintf(stderr, "Input too small\n");
+		gf_free(data);
+		gf_sys_close();
+		return 1;
+	}
+
+	time_ref = time_new = 0;
+	sum_ref = sum_new = 0;
+	nb_eos = 0;
+	for (i=0; i<nb_loops; i++) time_ref += run_pass(data, size, GF_TRUE, &sum_ref);
+	eos_ref = nb_eos;
+	nb_eos = 0;
+	for (i=0; i<nb_loops; i++) time_new += run_pass(data, size, GF_FALSE, &sum_new);
+	eos_new = nb_eos;
+	gf_free(data);
+	if (!time_ref) time_ref = 1;
+	if (!time_new) time_new = 1;
+
+	fprintf(stdout, "%s: %d bytes read %d times\n", file_name, size, nb_loops);
+	fprintf(stdout, "\tbit by bit: "LLU" us - %.2f MB/s\n", time_ref, ((Double) size) * nb_loops / time_ref);
+	fprintf(stdout, "\tgf_bs_read_int: "LLU" us - %.2f MB/s (x%.2f)\n", time_new, ((Double) size) * nb_loops / time_new, ((Double) time_ref) / time_new);
+	if ((sum_ref != sum_new) || (eos_ref != eos_new)) {
+		fprintf(stderr, "Error: readers differ (checksum "LLX" vs "LLX", %d vs %d EOS)\n", sum_ref, sum_new, eos_ref, eos_new);
+		gf_sys_close();
+		return 1;
+	}
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,196 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - CENC encryption benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/crypt.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: cryptbench [options]\n"
+	        "\n"
+	        "Encrypts and decrypts a pseudo-random buffer split in NAL-like subsamples with the cenc, cbc1, cens and cbcs schemes,\n"
+	        "using the generic AES implementation and the AES-NI one when available, checks the results are identical and reports MB/s.\n"
+	        "\n"
+	        "-size N: size in MB of the buffer (default 64)\n"
+	        "-loops N: number of passes over the buffer (default 4)\n"
+	       );
+}
+
+static const char *key = "\xcc\xc0\xf2\xb3\xb2\x79\x92\x64\x96\xa7\xf5\xd2\x5d\xa6\x92\xf6";
+static const char *IV = "\x0a\x61\x06\x76\xcb\x88\xf3\x02\xd1\x0a\xc8\xbc\x66\xe0\x39\xed";
+
+static struct {
+	const char *name;
+	GF_CRYPTO_MODE mode;
+	u8 crypt_block, skip_block;
+	Bool const_IV;
+} schemes[] =
+{
+	{"cenc", GF_CTR, 0, 0, GF_FALSE},
+	{"cbc1", GF_CBC, 0, 0, GF_FALSE},
+	{"cens", GF_CTR, 1, 9, GF_FALSE},
+	{"cbcs", GF_CBC, 1, 9, GF_TRUE},
+};
+
+/*splits the buffer in NAL units of a few kbytes with a small clear header, CBC ranges are block aligned*/
+static u32 make_ranges(GF_CryptRange *ranges, u32 size, Bool block_align)
+{
+	u32 nb_ranges = 0, pos = 0;
+	while (pos < size) {
+		u32 unit = 100 + gf_rand() % 8000;
+		u32 clear = 4 + gf_rand() % 40;
+		if (pos + unit > size) unit = size - pos;
+		if (clear > unit) clear = unit;
+		ranges[nb_ranges].clear_bytes = clear;
+		ranges[nb_ranges].crypt_bytes = unit - clear;
+		if (block_align) {
+			ranges[nb_ranges].clear_bytes += ranges[nb_ranges].crypt_bytes % 16;
+			ranges[nb_ranges].crypt_bytes -= ranges[nb_ranges].crypt_bytes % 16;
+		}
+		pos += unit;
+		nb_ranges++;
+	}
+	return nb_ranges;
+}
+
+static GF_Err run_scheme(u32 scheme, u8 *data, u32 size, GF_CryptRange *ranges, u32 nb_ranges, u32 nb_loops, Bool decrypt, u64 *time)
+{
+	GF_Err e;
+	u64 start;
+	u32 i;
+	GF_Crypt *mc = gf_crypt_open(GF_AES_128, schemes[scheme].mode);
+	if (!mc) return GF_IO_ERR;
+
+	*time = 0;
+	for (i=0; i<nb_loops; i++) {
+		e = gf_crypt_init(mc, (void *) key, IV);
+		if (e) return e;
+		start = gf_sys_clock_high_res();
+		if (decrypt)
+			e = gf_crypt_decrypt_ranges(mc, data, ranges, nb_ranges, schemes[scheme].crypt_block, schemes[scheme].skip_block, schemes[scheme].const_IV ? (u8 *) IV : NULL);
+		else
+			e = gf_crypt_encrypt_ranges(mc, data, ranges, nb_ranges, schemes[scheme].crypt_block, schemes[scheme].skip_block, schemes[scheme].const_IV ? (u8 *) IV : NULL);
+		*time += gf_sys_clock_high_res() - start;
+		if (e) break;
+		/*restore the input for the next pass*/
+		if (i+1<nb_loops) {
+			e = gf_crypt_init(mc, (void *) key, IV);
+			if (e) return e;
+			if (decrypt)
+				e = gf_crypt_encrypt_ranges(mc, data, ranges, nb_ranges, schemes[scheme].crypt_block, schemes[scheme].skip_block, schemes[scheme].const_IV ? (u8 *) IV : NULL);
+			else
+				e = gf_crypt_decrypt_ranges(mc, data, ranges, nb_ranges, schemes[scheme].crypt_block, schemes[scheme].skip_block, schemes[scheme].const_IV ? (u8 *) IV : NULL);
+			if (e) break;
+		}
+	}
+	gf_crypt_close(mc);
+	if (!*time) *time = 1;
+	return e;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, j, size=64, nb_loops=4, nb_ranges, nb_impl;
+	u8 *src, *ref, *data;
+	GF_CryptRange *ranges;
+	u32 impls[2];
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			size = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-loops") && (i+1<(u32) argc)) {
+			nb_loops = atoi(argv[i+1]);
+			i++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!size) size = 1;
+	if (!nb_loops) nb_loops = 1;
+	size *= 1024*1024;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	src = gf_malloc(size);
+	ref = gf_malloc(size);
+	data = gf_malloc(size);
+	ranges = gf_malloc(sizeof(GF_CryptRange) * (size/100 + 1));
+	gf_rand_init(GF_TRUE);
+	for (i=0; i<size; i++) src[i] = gf_rand();
+
+	nb_impl = 0;
+	impls[nb_impl++] = GF_CRYPT_IMPL_GENERIC;
+	if (gf_crypt_set_impl(GF_CRYPT_IMPL_AESNI) == GF_CRYPT_IMPL_AESNI)
+		impls[nb_impl++] = GF_CRYPT_IMPL_AESNI;
+	else
+		fprintf(stdout, "AES-NI not available, only testing the generic implementation\n");
+
+	for (i=0; i<sizeof(schemes)/sizeof(schemes[0]); i++) {
+		gf_rand_init(GF_TRUE);
+		nb_ranges = make_ranges(ranges, size, (schemes[i].mode==GF_CBC) ? GF_TRUE : GF_FALSE);
+		fprintf(stdout, "%s: %d MB in %d subsamples\n", schemes[i].name, size/1024/1024, nb_ranges);
+
+		for (j=0; j<nb_impl; j++) {
+			u64 enc_time, dec_time;
+			GF_Err e;
+			gf_crypt_set_impl(impls[j]);
+
+			memcpy(data, src, size);
+			e = run_scheme(i, data, size, ranges, nb_ranges, nb_loops, GF_FALSE, &enc_time);
+			if (!e) {
+				if (!j) memcpy(ref, data, size);
+				else if (memcmp(ref, data, size)) {
+					fprintf(stderr, "Error: %s encryption differs from the generic implementation\n", schemes[i].name);
+					ret = 1;
+				}
+				e = run_scheme(i, data, size, ranges, nb_ranges, nb_loops, GF_TRUE, &dec_time);
+			}
+			if (e) {
+				fprintf(stderr, "Error running %s: %s\n", schemes[i].name, gf_error_to_string(e));
+				ret = 1;
+				continue;
+			}
+			if (memcmp(src, data, size)) {
+				fprintf(stderr, "Error: %s decryption does not match the source\n", schemes[i].name);
+				ret = 1;
+			}
+			fprintf(stdout, "\t%s: encrypt %.2f MB/s - decrypt %.2f MB/s\n", j ? "AES-NI " : "generic",
+			        ((Double) size) * nb_loops / enc_time, ((Double) size) * nb_loops / dec_time);
+		}
+	}
+	gf_crypt_set_impl(GF_CRYPT_IMPL_AUTO);
+
+	gf_free(src);
+	gf_free(ref);
+	gf_free(data);
+	gf_free(ranges);
+	gf_sys_close();
+	return ret;
+}
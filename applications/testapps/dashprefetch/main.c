@@ -0,0 +1,520 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - DASH segment prefetch test
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/network.h>
+#include <gpac/download.h>
+#include <gpac/thread.h>
+#include <gpac/list.h>
+#include <gpac/dash.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: dashprefetch [options]\n"
+	        "\n"
+	        "Plays a static DASH session from a local HTTP server adding a fixed delay to each reply, and checks\n"
+	        "segments are delivered in order with and without segment prefetching, including across an immediate quality switch.\n"
+	        "Reports the time needed to fetch the session for each prefetch depth.\n"
+	        "\n"
+	        "-port N: loopback port to use (default 18180)\n"
+	        "-rtt N: delay in ms added to each reply (default 50)\n"
+	        "-segs N: number of segments (default 40)\n"
+	        "-size N: segment size in bytes for the lowest quality (default 20000)\n"
+	        "-depth N: prefetch depth to compare with no prefetch (default 4)\n"
+	       );
+}
+
+static u32 rtt = 50, seg_size = 20000;
+
+/*local HTTP server delaying replies, single thread*/
+typedef struct
+{
+	GF_Socket *sock;
+	char buf[4096];
+	u32 size;
+} HTTPClient;
+
+typedef struct
+{
+	HTTPClient *cl;
+	u32 send_at;
+	char *data;
+	u32 size;
+} HTTPReply;
+
+typedef struct
+{
+	GF_Socket *listen;
+	GF_SockGroup *sg;
+	GF_List *clients, *replies;
+	GF_Thread *th;
+	volatile Bool run;
+	volatile u32 nb_requests, nb_connections;
+} HTTPServer;
+
+static void server_close_client(HTTPServer *srv, HTTPClient *cl)
+{
+	u32 i;
+	for (i=0; i<gf_list_count(srv->replies); i++) {
+		HTTPReply *r = gf_list_get(srv->replies, i);
+		if (r->cl != cl) continue;
+		gf_list_rem(srv->replies, i);
+		gf_free(r->data);
+		gf_free(r);
+		i--;
+	}
+	gf_list_del_item(srv->clients, cl);
+	gf_sk_group_unregister(srv->sg, cl->sock);
+	gf_sk_del(cl->sock);
+	gf_free(cl);
+}
+
+/*GET /seg_R_N.m4s returns a segment of representation R, GET /init_R.mp4 an init segment*/
+static void server_queue_reply(HTTPServer *srv, HTTPClient *cl, const char *path)
+{
+	char hdr[512];
+	u32 body_size = 0, hdr_size;
+	Bool found = GF_TRUE;
+	HTTPReply *r;
+
+	if (!strncmp(path, "/seg_", 5)) body_size = (path[5]=='B') ? 2*seg_size : seg_size;
+	else if (!strncmp(path, "/init_", 6)) body_size = 100;
+	else found = GF_FALSE;
+
+	if (found)
+		sprintf(hdr, "HTTP/1.1 200 OK\r\nContent-Type: video/mp4\r\nContent-Length: %d\r\n\r\n", body_size);
+	else
+		sprintf(hdr, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+	hdr_size = (u32) strlen(hdr);
+
+	GF_SAFEALLOC(r, HTTPReply);
+	r->cl = cl;
+	r->send_at = gf_sys_clock() + rtt;
+	r->size = hdr_size + body_size;
+	r->data = gf_malloc(r->size);
+	memcpy(r->data, hdr, hdr_size);
+	memset(r->data + hdr_size, 'a', body_size);
+	gf_list_add(srv->replies, r);
+	srv->nb_requests++;
+}
+
+static Bool server_process_client(HTTPServer *srv, HTTPClient *cl)
+{
+	char *hdr_end;
+	u32 size = 0;
+	GF_Err e = gf_sk_receive_no_select(cl->sock, cl->buf + cl->size, sizeof(cl->buf) - cl->size - 1, 0, &size);
+	if (e == GF_IP_NETWORK_EMPTY) return GF_TRUE;
+	if (e || !size) return GF_FALSE;
+	cl->size += size;
+	cl->buf[cl->size] = 0;
+
+	while ((hdr_end = strstr(cl->buf, "\r\n\r\n"))) {
+		char path[256];
+		u32 req_size = (u32) (hdr_end + 4 - cl->buf);
+		path[0] = 0;
+		if (!strncmp(cl->buf, "GET ", 4)) {
+			char *sep = strchr(cl->buf + 4, ' ');
+			u32 len = sep ? (u32) (sep - cl->buf - 4) : 0;
+			if (len >= sizeof(path)) len = sizeof(path) - 1;
+			memcpy(path, cl->buf + 4, len);
+			path[len] = 0;
+		}
+		server_queue_reply(srv, cl, path);
+		memmove(cl->buf, cl->buf + req_size, cl->size - req_size + 1);
+		cl->size -= req_size;
+	}
+	return GF_TRUE;
+}
+
+static u32 server_run(void *par)
+{
+	HTTPServer *srv = (HTTPServer *) par;
+	while (srv->run) {
+		u32 i, pos = 0, now;
+		GF_Socket *sk;
+
+		if (gf_sk_group_select(srv->sg, 1000) == GF_OK) {
+			while ((sk = gf_sk_group_enum_ready(srv->sg, &pos))) {
+				if (sk == srv->listen) {
+					GF_Socket *new_conn = NULL;
+					if ((gf_sk_accept(srv->listen, &new_conn) == GF_OK) && new_conn) {
+						HTTPClient *cl;
+						GF_SAFEALLOC(cl, HTTPClient);
+						cl->sock = new_conn;
+						gf_list_add(srv->clients, cl);
+						gf_sk_group_register(srv->sg, new_conn);
+						srv->nb_connections++;
+					}
+					continue;
+				}
+				for (i=0; i<gf_list_count(srv->clients); i++) {
+					HTTPClient *cl = gf_list_get(srv->clients, i);
+					if (cl->sock != sk) continue;
+					if (!server_process_client(srv, cl))
+						server_close_client(srv, cl);
+					break;
+				}
+			}
+		}
+		/*send replies whose delay expired*/
+		now = gf_sys_clock();
+		for (i=0; i<gf_list_count(srv->replies); i++) {
+			GF_Err e;
+			HTTPReply *r = gf_list_get(srv->replies, i);
+			if ((s32) (now - r->send_at) < 0) continue;
+			gf_list_rem(srv->replies, i);
+			e = gf_sk_send(r->cl->sock, r->data, r->size);
+			/*closing the client removes its other replies, restart from the first one*/
+			if (e) server_close_client(srv, r->cl);
+			gf_free(r->data);
+			gf_free(r);
+			if (e) i = 0;
+			i--;
+		}
+	}
+	return 0;
+}
+
+static HTTPServer *server_new(u16 port)
+{
+	HTTPServer *srv;
+	GF_SAFEALLOC(srv, HTTPServer);
+	srv->clients = gf_list_new();
+	srv->replies = gf_list_new();
+	srv->sg = gf_sk_group_new();
+	srv->listen = gf_sk_new(GF_SOCK_TYPE_TCP);
+	if (gf_sk_bind(srv->listen, "127.0.0.1", port, NULL, 0, GF_SOCK_REUSE_PORT) || gf_sk_listen(srv->listen, 64)) {
+		fprintf(stderr, "Cannot listen on port %d\n", port);
+		gf_sk_del(srv->listen);
+		gf_sk_group_del(srv->sg);
+		gf_list_del(srv->clients);
+		gf_list_del(srv->replies);
+		gf_free(srv);
+		return NULL;
+	}
+	gf_sk_group_register(srv->sg, srv->listen);
+	srv->run = GF_TRUE;
+	srv->th = gf_th_new("HTTPServer");
+	gf_th_run(srv->th, server_run, srv);
+	return srv;
+}
+
+static void server_del(HTTPServer *srv)
+{
+	if (!srv) return;
+	srv->run = GF_FALSE;
+	gf_th_stop(srv->th);
+	gf_th_del(srv->th);
+	while (gf_list_count(srv->clients)) {
+		server_close_client(srv, gf_list_get(srv->clients, 0));
+	}
+	gf_list_del(srv->clients);
+	gf_list_del(srv->replies);
+	gf_sk_group_unregister(srv->sg, srv->listen);
+	gf_sk_del(srv->listen);
+	gf_sk_group_del(srv->sg);
+	gf_free(srv);
+}
+
+/*DASH IO over the download manager, segments are kept in memory*/
+static GF_DownloadManager *dm = NULL;
+static GF_DashClient *dash = NULL;
+static volatile Bool playback_created, buffering_done;
+
+static void dash_netio(void *cbk, GF_NETIO_Parameter *par)
+{
+}
+
+static GF_DASHFileIOSession dash_io_create(GF_DASHFileIO *dashio, Bool persistent, const char *url, s32 group_idx)
+{
+	GF_Err e;
+	char szURL[GF_MAX_PATH];
+	u32 flags = GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_MEMORY_CACHE;
+	if (persistent) flags |= GF_NETIO_SESSION_PERSISTENT;
+	strncpy(szURL, url, GF_MAX_PATH-1);
+	szURL[GF_MAX_PATH-1] = 0;
+	return gf_dm_sess_new(dm, szURL, flags, dash_netio, NULL, &e);
+}
+static void dash_io_del(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	gf_dm_sess_del((GF_DownloadSession *)session);
+}
+static void dash_io_delete_cache_file(GF_DASHFileIO *dashio, GF_DASHFileIOSession session, const char *cache_url)
+{
+	gf_dm_delete_cached_file_entry_session((GF_DownloadSession *)session, cache_url);
+}
+static void dash_io_abort(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	gf_dm_sess_abort((GF_DownloadSession *)session);
+}
+static GF_Err dash_io_setup_from_url(GF_DASHFileIO *dashio, GF_DASHFileIOSession session, const char *url, s32 group_idx)
+{
+	char szURL[GF_MAX_PATH];
+	strncpy(szURL, url, GF_MAX_PATH-1);
+	szURL[GF_MAX_PATH-1] = 0;
+	return gf_dm_sess_setup_from_url((GF_DownloadSession *)session, szURL);
+}
+static GF_Err dash_io_set_range(GF_DASHFileIO *dashio, GF_DASHFileIOSession session, u64 start_range, u64 end_range, Bool discontinue_cache)
+{
+	return gf_dm_sess_set_range((GF_DownloadSession *)session, start_range, end_range, discontinue_cache);
+}
+static GF_Err dash_io_init(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_process_headers((GF_DownloadSession *)session);
+}
+static GF_Err dash_io_run(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_process((GF_DownloadSession *)session);
+}
+static const char *dash_io_get_url(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_get_resource_name((GF_DownloadSession *)session);
+}
+static const char *dash_io_get_cache_name(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_get_cache_name((GF_DownloadSession *)session);
+}
+static const char *dash_io_get_mime(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_mime_type((GF_DownloadSession *)session);
+}
+static const char *dash_io_get_header_value(GF_DASHFileIO *dashio, GF_DASHFileIOSession session, const char *header_name)
+{
+	return gf_dm_sess_get_header((GF_DownloadSession *)session, header_name);
+}
+static u64 dash_io_get_utc_start_time(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	return gf_dm_sess_get_utc_start((GF_DownloadSession *)session);
+}
+static u32 dash_io_get_bytes_per_sec(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	u32 bps = 0;
+	if (session) gf_dm_sess_get_stats((GF_DownloadSession *)session, NULL, NULL, NULL, NULL, &bps, NULL);
+	return bps;
+}
+static u32 dash_io_get_total_size(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	u32 size = 0;
+	gf_dm_sess_get_stats((GF_DownloadSession *)session, NULL, NULL, &size, NULL, NULL, NULL);
+	return size;
+}
+static u32 dash_io_get_bytes_done(GF_DASHFileIO *dashio, GF_DASHFileIOSession session)
+{
+	u32 size = 0;
+	gf_dm_sess_get_stats((GF_DownloadSession *)session, NULL, NULL, NULL, &size, NULL, NULL);
+	return size;
+}
+static GF_Err dash_io_on_dash_event(GF_DASHFileIO *dashio, GF_DASHEventType evt, s32 group_idx, GF_Err error_code)
+{
+	if (evt==GF_DASH_EVENT_CREATE_PLAYBACK) {
+		gf_dash_group_select(dash, 0, GF_TRUE);
+		playback_created = GF_TRUE;
+	}
+	else if (evt==GF_DASH_EVENT_BUFFER_DONE) buffering_done = GF_TRUE;
+	return GF_OK;
+}
+
+static GF_DASHFileIO dash_io = {
+	NULL, dash_io_on_dash_event, NULL, dash_io_delete_cache_file,
+	dash_io_create, dash_io_del, dash_io_abort, dash_io_setup_from_url, dash_io_set_range, dash_io_init, dash_io_run,
+	dash_io_get_url, dash_io_get_cache_name, dash_io_get_mime, dash_io_get_header_value, dash_io_get_utc_start_time,
+	dash_io_get_bytes_per_sec, dash_io_get_total_size, dash_io_get_bytes_done
+};
+
+/*plays the session as fast as possible, checking segments come in order. If switch_at is set, switches quality up
+with an immediate switch once switch_at segments have been played*/
+static int play(const char *mpd, u32 depth, Bool threaded, u32 nb_segs, u32 switch_at, u32 *time)
+{
+	u32 start, next_num = 1, nb_played = 0;
+	*time = 0;
+	Bool done = GF_FALSE, switched = GF_FALSE;
+	char rep_played = 'A';
+	int ret = 0;
+	GF_Err e;
+
+	playback_created = buffering_done = GF_FALSE;
+	dash = gf_dash_new(&dash_io, 8000, 0, GF_FALSE, GF_TRUE, GF_DASH_SELECT_BANDWIDTH_LOWEST, GF_TRUE, 0);
+	gf_dash_set_threaded_download(dash, threaded);
+	gf_dash_set_prefetch_depth(dash, depth);
+
+	start = gf_sys_clock();
+	e = gf_dash_open(dash, mpd);
+	if (e) {
+		fprintf(stderr, "Cannot open %s: %s\n", mpd, gf_error_to_string(e));
+		gf_dash_del(dash);
+		dash = NULL;
+		return 1;
+	}
+	while (!playback_created && (gf_sys_clock() - start < 10000))
+		gf_sleep(1);
+
+	while (playback_created && (gf_sys_clock() - start < 30000)) {
+		const char *url, *orig_url, *name;
+		char rep;
+		u32 num;
+		if (!gf_dash_group_get_num_segments_ready(dash, 0, &done)) {
+			if (done) break;
+			gf_sleep(1);
+			continue;
+		}
+		e = gf_dash_group_get_next_segment_location(dash, 0, 0, &url, NULL, NULL, NULL, NULL, NULL, NULL, &orig_url, NULL, NULL, NULL);
+		if (e || !orig_url) break;
+		/*init segments are queued first*/
+		if (strstr(orig_url, "init_")) {
+			gf_dash_group_discard_segment(dash, 0);
+			continue;
+		}
+		name = strstr(orig_url, "seg_");
+		if (!name || (sscanf(name, "seg_%c_%u.m4s", &rep, &num) != 2)) {
+			fprintf(stderr, "Unexpected segment %s\n", orig_url);
+			ret = 1;
+			break;
+		}
+		if (num != next_num) {
+			fprintf(stderr, "Segment %s played instead of number %d\n", orig_url, next_num);
+			ret = 1;
+		}
+		/*no segment of the previous quality once switched*/
+		if ((rep != rep_played) && ((rep != 'B') || !switched)) {
+			fprintf(stderr, "Segment %s of unexpected representation\n", orig_url);
+			ret = 1;
+		}
+		rep_played = rep;
+		next_num = num + 1;
+		nb_played++;
+		gf_dash_group_discard_segment(dash, 0);
+
+		if (switch_at && (nb_played == switch_at)) {
+			gf_dash_switch_quality(dash, GF_TRUE, GF_TRUE);
+			switched = GF_TRUE;
+		}
+	}
+	*time = gf_sys_clock() - start;
+	if (nb_played != nb_segs) {
+		fprintf(stderr, "%d segments played out of %d\n", nb_played, nb_segs);
+		ret = 1;
+	}
+	if (switch_at && (rep_played != 'B')) {
+		fprintf(stderr, "Quality switch not performed\n");
+		ret = 1;
+	}
+	if (!buffering_done) {
+		fprintf(stderr, "Buffering never completed\n");
+		ret = 1;
+	}
+	gf_dash_close(dash);
+	gf_dash_del(dash);
+	dash = NULL;
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, port=18180, nb_segs=40, depth=4;
+	u32 time_ref = 0;
+	char mpd[GF_MAX_PATH];
+	HTTPServer *srv;
+	FILE *f;
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-port") && (i+1<(u32) argc)) {
+			port = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-rtt") && (i+1<(u32) argc)) {
+			rtt = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-segs") && (i+1<(u32) argc)) {
+			nb_segs = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			seg_size = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-depth") && (i+1<(u32) argc)) {
+			depth = atoi(argv[i+1]);
+			i++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (nb_segs < 10) nb_segs = 10;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+
+	srv = server_new(port);
+	if (!srv) {
+		gf_sys_close();
+		return 1;
+	}
+	dm = gf_dm_new(NULL);
+
+	sprintf(mpd, "%s/dashprefetch_%d.mpd", gf_get_default_cache_directory(), port);
+	f = gf_fopen(mpd, "wt");
+	if (!f) {
+		fprintf(stderr, "Cannot create %s\n", mpd);
+		ret = 1;
+		goto exit;
+	}
+	fprintf(f, "<?xml version=\"1.0\"?>\n"
+	        "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" type=\"static\" mediaPresentationDuration=\"PT%dS\" minBufferTime=\"PT2S\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\">\n"
+	        " <BaseURL>http://127.0.0.1:%d/</BaseURL>\n"
+	        " <Period id=\"1\">\n"
+	        "  <AdaptationSet segmentAlignment=\"true\" mimeType=\"video/mp4\">\n"
+	        "   <SegmentTemplate timescale=\"1000\" duration=\"1000\" startNumber=\"1\" initialization=\"init_$RepresentationID$.mp4\" media=\"seg_$RepresentationID$_$Number$.m4s\"/>\n"
+	        "   <Representation id=\"A\" bandwidth=\"100000\" codecs=\"avc1.42c01e\" width=\"320\" height=\"240\"/>\n"
+	        "   <Representation id=\"B\" bandwidth=\"200000\" codecs=\"avc1.42c01e\" width=\"640\" height=\"480\"/>\n"
+	        "  </AdaptationSet>\n"
+	        " </Period>\n"
+	        "</MPD>\n", nb_segs, port);
+	gf_fclose(f);
+
+	fprintf(stdout, "%d segments of %d bytes - reply delay %d ms\n", nb_segs, seg_size, rtt);
+	for (i=0; i<4; i++) {
+		int res;
+		u32 time, nb_reqs, nb_conns;
+		u32 d = (i<2) ? 1 : depth;
+		Bool threaded = (i%2) ? GF_TRUE : GF_FALSE;
+		u32 switch_at = 0;
+		/*quality switch while prefetches are pending*/
+		if (i==3) switch_at = nb_segs/3;
+
+		nb_reqs = srv->nb_requests;
+		nb_conns = srv->nb_connections;
+		res = play(mpd, d, threaded, nb_segs, switch_at, &time);
+		if (d==1) time_ref = time;
+		fprintf(stdout, "\tdepth %d%s%s: %s - %d ms (%.2fx) - %d requests on %d connections\n", d, threaded ? " threaded" : "", switch_at ? " with switch" : "", res ? "FAILED" : "OK", time, time ? ((Double) time_ref) / time : 0, srv->nb_requests - nb_reqs, srv->nb_connections - nb_conns);
+		ret |= res;
+	}
+	gf_delete_file(mpd);
+
+exit:
+	gf_dm_del(dm);
+	server_del(srv);
+	gf_sys_close();
+	return ret;
+}
@@ -0,0 +1,388 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - HTTP connection pool test
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/network.h>
+#include <gpac/download.h>
+#include <gpac/thread.h>
+#include <gpac/list.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: httppool [options]\n"
+	        "\n"
+	        "Runs local HTTP/1.1 servers and checks that download sessions reuse idle keep-alive connections\n"
+	        "of the download manager, then compares request rates with and without the connection pool.\n"
+	        "\n"
+	        "-port N: first loopback port to use (default 18080)\n"
+	        "-reqs N: number of requests for the rate test (default 2000)\n"
+	        "-size N: response body size in bytes (default 1000)\n"
+	       );
+}
+
+/*local HTTP server, one thread per server*/
+typedef struct
+{
+	u16 port;
+	/*answer with Connection: close and close the connection*/
+	Bool close_after_reply;
+	/*close connections idle for more than this time in ms, 0 means never*/
+	u32 idle_close;
+
+	GF_Socket *listen;
+	GF_SockGroup *sg;
+	GF_List *clients;
+	GF_Thread *th;
+	volatile Bool run;
+	volatile u32 nb_accepted, nb_requests;
+} HTTPServer;
+
+typedef struct
+{
+	GF_Socket *sock;
+	char buf[4096];
+	u32 size;
+	u32 last_active;
+} HTTPClient;
+
+static void server_close_client(HTTPServer *srv, HTTPClient *cl)
+{
+	gf_list_del_item(srv->clients, cl);
+	gf_sk_group_unregister(srv->sg, cl->sock);
+	gf_sk_del(cl->sock);
+	gf_free(cl);
+}
+
+static Bool server_process_client(HTTPServer *srv, HTTPClient *cl)
+{
+	char *hdr_end, *body;
+	char reply[512];
+	u32 size = 0, body_size;
+	GF_Err e = gf_sk_receive_no_select(cl->sock, cl->buf + cl->size, sizeof(cl->buf) - cl->size - 1, 0, &size);
+	if (e == GF_IP_NETWORK_EMPTY) return GF_TRUE;
+	if (e || !size) return GF_FALSE;
+	cl->size += size;
+	cl->buf[cl->size] = 0;
+	cl->last_active = gf_sys_clock();
+
+	//answer all complete requests, GET /N returns N bytes
+	while ((hdr_end = strstr(cl->buf, "\r\n\r\n"))) {
+		u32 req_size = (u32) (hdr_end + 4 - cl->buf);
+		body_size = 0;
+		if (!strncmp(cl->buf, "GET /", 5)) body_size = atoi(cl->buf + 5);
+
+		sprintf(reply, "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: %d\r\n%s\r\n", body_size, srv->close_after_reply ? "Connection: close\r\n" : "");
+		body = gf_malloc(strlen(reply) + body_size);
+		strcpy(body, reply);
+		memset(body + strlen(reply), 'a', body_size);
+		srv->nb_requests++;
+		e = gf_sk_send(cl->sock, body, (u32) strlen(reply) + body_size);
+		gf_free(body);
+		if (e || srv->close_after_reply) return GF_FALSE;
+
+		memmove(cl->buf, cl->buf + req_size, cl->size - req_size + 1);
+		cl->size -= req_size;
+	}
+	return GF_TRUE;
+}
+
+static u32 server_run(void *par)
+{
+	HTTPServer *srv = (HTTPServer *) par;
+	while (srv->run) {
+		u32 i, pos = 0;
+		GF_Socket *sk;
+
+		if (gf_sk_group_select(srv->sg, 1000) == GF_OK) {
+			while ((sk = gf_sk_group_enum_ready(srv->sg, &pos))) {
+				if (sk == srv->listen) {
+					GF_Socket *new_conn = NULL;
+					if ((gf_sk_accept(srv->listen, &new_conn) == GF_OK) && new_conn) {
+						HTTPClient *cl;
+						GF_SAFEALLOC(cl, HTTPClient);
+						cl->sock = new_conn;
+						cl->last_active = gf_sys_clock();
+						gf_list_add(srv->clients, cl);
+						gf_sk_group_register(srv->sg, new_conn);
+						srv->nb_accepted++;
+					}
+					continue;
+				}
+				for (i=0; i<gf_list_count(srv->clients); i++) {
+					HTTPClient *cl = gf_list_get(srv->clients, i);
+					if (cl->sock != sk) continue;
+					if (!server_process_client(srv, cl))
+						server_close_client(srv, cl);
+					break;
+				}
+			}
+		}
+		if (srv->idle_close) {
+			u32 now = gf_sys_clock();
+			for (i=0; i<gf_list_count(srv->clients); i++) {
+				HTTPClient *cl = gf_list_get(srv->clients, i);
+				if (now - cl->last_active < srv->idle_close) continue;
+				server_close_client(srv, cl);
+				i--;
+			}
+		}
+	}
+	return 0;
+}
+
+static HTTPServer *server_new(u16 port, Bool close_after_reply, u32 idle_close)
+{
+	HTTPServer *srv;
+	GF_SAFEALLOC(srv, HTTPServer);
+	srv->port = port;
+	srv->close_after_reply = close_after_reply;
+	srv->idle_close = idle_close;
+	srv->clients = gf_list_new();
+	srv->sg = gf_sk_group_new();
+	srv->listen = gf_sk_new(GF_SOCK_TYPE_TCP);
+	if (gf_sk_bind(srv->listen, "127.0.0.1", port, NULL, 0, GF_SOCK_REUSE_PORT) || gf_sk_listen(srv->listen, 64)) {
+		fprintf(stderr, "Cannot listen on port %d\n", port);
+		gf_sk_del(srv->listen);
+		gf_sk_group_del(srv->sg);
+		gf_list_del(srv->clients);
+		gf_free(srv);
+		return NULL;
+	}
+	gf_sk_group_register(srv->sg, srv->listen);
+	srv->run = GF_TRUE;
+	srv->th = gf_th_new("HTTPServer");
+	gf_th_run(srv->th, server_run, srv);
+	return srv;
+}
+
+static void server_del(HTTPServer *srv)
+{
+	if (!srv) return;
+	srv->run = GF_FALSE;
+	gf_th_stop(srv->th);
+	gf_th_del(srv->th);
+	while (gf_list_count(srv->clients)) {
+		server_close_client(srv, gf_list_get(srv->clients, 0));
+	}
+	gf_list_del(srv->clients);
+	gf_sk_group_unregister(srv->sg, srv->listen);
+	gf_sk_del(srv->listen);
+	gf_sk_group_del(srv->sg);
+	gf_free(srv);
+}
+
+static u32 nb_bytes;
+
+static void on_data(void *cbk, GF_NETIO_Parameter *par)
+{
+	if (par->msg_type == GF_NETIO_DATA_EXCHANGE) nb_bytes += par->size;
+}
+
+static GF_Err fetch(GF_DownloadSession *sess, u16 port, u32 size)
+{
+	char url[100];
+	GF_Err e;
+	sprintf(url, "http://127.0.0.1:%d/%d", port, size);
+	e = gf_dm_sess_setup_from_url(sess, url);
+	if (!e) e = gf_dm_sess_process(sess);
+	return e;
+}
+
+/*creates a session, fetches a resource and deletes the session*/
+static GF_Err fetch_new(GF_DownloadManager *dm, u16 port, u32 size)
+{
+	char url[100];
+	GF_Err e;
+	GF_DownloadSession *sess;
+	sprintf(url, "http://127.0.0.1:%d/%d", port, size);
+	sess = gf_dm_sess_new(dm, url, GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_NOT_CACHED, on_data, NULL, &e);
+	if (!sess) return e ? e : GF_IO_ERR;
+	e = gf_dm_sess_process(sess);
+	gf_dm_sess_del(sess);
+	return e;
+}
+
+static int check(const char *name, Bool ok, GF_DownloadManager *dm, u32 nb_accepted)
+{
+	u32 nb_idle, nb_hits, nb_misses, nb_evicted;
+	gf_dm_get_connection_pool_stats(dm, &nb_idle, &nb_hits, &nb_misses, &nb_evicted);
+	fprintf(stdout, "\t%-40s: %s - %d connections - pool: %d idle, %d hits, %d misses, %d evicted\n", name, ok ? "OK" : "FAILED", nb_accepted, nb_idle, nb_hits, nb_misses, nb_evicted);
+	return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, port=18080, nb_reqs=2000, size=1000;
+	u32 nb_idle, nb_hits, nb_misses, nb_evicted, nb_err, nb_accepted;
+	HTTPServer *srv_a=NULL, *srv_b=NULL, *srv_close=NULL, *srv_idle=NULL;
+	GF_DownloadManager *dm;
+	GF_DownloadSession *sess, *sessions[4];
+	char url[100];
+	u64 start, time_pool, time_no_pool;
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-port") && (i+1<(u32) argc)) {
+			port = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-reqs") && (i+1<(u32) argc)) {
+			nb_reqs = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			size = atoi(argv[i+1]);
+			i++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+
+	gf_sys_init(GF_MemTrackerNone);
+	//uncached sessions warn about missing cache entries
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+
+	srv_a = server_new(port, GF_FALSE, 0);
+	srv_b = server_new(port+1, GF_FALSE, 0);
+	srv_close = server_new(port+2, GF_TRUE, 0);
+	srv_idle = server_new(port+3, GF_FALSE, 50);
+	if (!srv_a || !srv_b || !srv_close || !srv_idle) {
+		ret = 1;
+		goto exit;
+	}
+	fprintf(stdout, "HTTP servers on loopback ports %d to %d\n", port, port+3);
+
+	dm = gf_dm_new(NULL);
+	gf_dm_set_connection_pool(dm, 16, 2, 10000);
+
+	/*sessions created and destroyed one after the other share a single connection*/
+	nb_err = 0;
+	for (i=0; i<20; i++) {
+		if (fetch_new(dm, srv_a->port, size)) nb_err++;
+	}
+	gf_dm_get_connection_pool_stats(dm, &nb_idle, &nb_hits, &nb_misses, &nb_evicted);
+	ret |= check("sequential sessions", !nb_err && (srv_a->nb_accepted==1) && (srv_a->nb_requests==20) && (nb_hits==19) && (nb_misses==1) && (nb_idle==1), dm, srv_a->nb_accepted);
+
+	/*a persistent session switching between two servers, as done by the DASH client*/
+	e = GF_OK;
+	sprintf(url, "http://127.0.0.1:%d/%d", srv_a->port, size);
+	sess = gf_dm_sess_new(dm, url, GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_NOT_CACHED | GF_NETIO_SESSION_PERSISTENT, on_data, NULL, &e);
+	nb_err = 0;
+	for (i=0; i<20; i++) {
+		if (fetch(sess, (i%2) ? srv_b->port : srv_a->port, size)) nb_err++;
+	}
+	gf_dm_sess_del(sess);
+	ret |= check("persistent session across servers", !nb_err && (srv_a->nb_accepted==1) && (srv_b->nb_accepted==1) && (srv_b->nb_requests==10), dm, srv_a->nb_accepted + srv_b->nb_accepted);
+
+	/*Connection: close replies are never pooled*/
+	gf_dm_get_connection_pool_stats(dm, &nb_idle, NULL, NULL, NULL);
+	nb_err = 0;
+	for (i=0; i<5; i++) {
+		if (fetch_new(dm, srv_close->port, size)) nb_err++;
+	}
+	{
+		u32 nb_idle_after;
+		gf_dm_get_connection_pool_stats(dm, &nb_idle_after, NULL, NULL, NULL);
+		ret |= check("Connection: close", !nb_err && (srv_close->nb_accepted==5) && (nb_idle_after==nb_idle), dm, srv_close->nb_accepted);
+	}
+
+	/*idle connection closed by the server is detected before reuse*/
+	nb_err = 0;
+	if (fetch_new(dm, srv_idle->port, size)) nb_err++;
+	gf_sleep(200);
+	gf_dm_get_connection_pool_stats(dm, NULL, NULL, NULL, &nb_evicted);
+	if (fetch_new(dm, srv_idle->port, size)) nb_err++;
+	{
+		u32 nb_evicted_after;
+		gf_dm_get_connection_pool_stats(dm, NULL, NULL, NULL, &nb_evicted_after);
+		ret |= check("connection closed by server while idle", !nb_err && (srv_idle->nb_accepted==2) && (srv_idle->nb_requests==2) && (nb_evicted_after==nb_evicted+1), dm, srv_idle->nb_accepted);
+	}
+
+	/*idle timeout of the pool*/
+	gf_dm_set_connection_pool(dm, 16, 2, 50);
+	gf_sleep(100);
+	nb_err = 0;
+	if (fetch_new(dm, srv_a->port, size)) nb_err++;
+	gf_dm_get_connection_pool_stats(dm, &nb_idle, NULL, NULL, NULL);
+	ret |= check("pool idle timeout", !nb_err && (srv_a->nb_accepted==2) && (nb_idle==1), dm, srv_a->nb_accepted);
+
+	/*per server limit: 4 simultaneous sessions, only 2 connections are kept*/
+	gf_dm_set_connection_pool(dm, 16, 2, 10000);
+	nb_err = 0;
+	nb_accepted = srv_b->nb_accepted;
+	for (i=0; i<4; i++) {
+		sprintf(url, "http://127.0.0.1:%d/%d", srv_b->port, size);
+		sessions[i] = gf_dm_sess_new(dm, url, GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_NOT_CACHED | GF_NETIO_SESSION_PERSISTENT, on_data, NULL, &e);
+		if (!sessions[i] || gf_dm_sess_process(sessions[i])) nb_err++;
+	}
+	for (i=0; i<4; i++) {
+		if (sessions[i]) gf_dm_sess_del(sessions[i]);
+	}
+	//the 2 kept connections are reused by 2 simultaneous sessions
+	for (i=0; i<2; i++) {
+		sprintf(url, "http://127.0.0.1:%d/%d", srv_b->port, size);
+		sessions[i] = gf_dm_sess_new(dm, url, GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_NOT_CACHED | GF_NETIO_SESSION_PERSISTENT, on_data, NULL, &e);
+		if (!sessions[i] || gf_dm_sess_process(sessions[i])) nb_err++;
+	}
+	for (i=0; i<2; i++) {
+		if (sessions[i]) gf_dm_sess_del(sessions[i]);
+	}
+	ret |= check("per server limit", !nb_err && (srv_b->nb_accepted == nb_accepted + 4), dm, srv_b->nb_accepted - nb_accepted);
+	gf_dm_del(dm);
+
+	/*request rate with and without connection reuse*/
+	nb_bytes = 0;
+	dm = gf_dm_new(NULL);
+	start = gf_sys_clock_high_res();
+	nb_err = 0;
+	for (i=0; i<nb_reqs; i++) {
+		if (fetch_new(dm, srv_a->port, size)) nb_err++;
+	}
+	time_pool = gf_sys_clock_high_res() - start;
+	gf_dm_del(dm);
+
+	dm = gf_dm_new(NULL);
+	gf_dm_set_connection_pool(dm, 0, 0, 0);
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_reqs; i++) {
+		if (fetch_new(dm, srv_a->port, size)) nb_err++;
+	}
+	time_no_pool = gf_sys_clock_high_res() - start;
+	gf_dm_del(dm);
+
+	if (!time_pool) time_pool = 1;
+	if (!time_no_pool) time_no_pool = 1;
+	fprintf(stdout, "\t%d requests of %d bytes: %.0f req/s with pool - %.0f req/s without pool%s\n", nb_reqs, size, ((Double) nb_reqs) * 1000000 / time_pool, ((Double) nb_reqs) * 1000000 / time_no_pool, nb_err ? " - ERRORS" : "");
+	if (nb_err || (nb_bytes != 2 * nb_reqs * size)) ret = 1;
+
+exit:
+	server_del(srv_a);
+	server_del(srv_b);
+	server_del(srv_close);
+	server_del(srv_idle);
+	gf_sys_close();
+	return ret;
+}
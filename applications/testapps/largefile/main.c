@@ -8,11 +8,77 @@ void PrintUsage()
 	        "-flat        test file writing in flat mode (moov at end)\n"
 	        "-inter       test file writing in interleaved mode (moov at begin)\n"
 	        "-size size   specifies target media size in GB. Default is 5.0 GB\n"
+	        "-check       only check an existing test file through memory-mapped sample references\n"
 	        ""
 	       );
 }
 #define TEST_FILE_NAME	"largefile.mp4"
 
+static u32 get_sample_stamp(const char *data)
+{
+	const u8 *p = (const u8 *) data;
+	return ((u32)p[0]<<24) | ((u32)p[1]<<16) | ((u32)p[2]<<8) | p[3];
+}
+
+/*reads back all samples in place from the file mapping - each sample starts with its sample number*/
+static int check_file()
+{
+	GF_ISOFile *movie;
+	GF_ISOSample samp;
+	GF_ISOMapToken *first_ref, *last_ref, *ref;
+	GF_Err e;
+	u32 i, count, di;
+	u64 offset, last_offset = 0;
+	const char *first_data, *last_data;
+
+	movie = gf_isom_open(TEST_FILE_NAME, GF_ISOM_OPEN_READ_MMAP, NULL);
+	if (!movie) {
+		fprintf(stdout, "Error opening file: %s\n", gf_error_to_string(gf_isom_last_error(NULL)));
+		return 1;
+	}
+	count = gf_isom_get_sample_count(movie, 1);
+	e = gf_isom_get_sample_ref(movie, 1, 1, &samp, &di, NULL, &first_ref);
+	if (e) {
+		fprintf(stdout, "Error getting sample reference: %s\n", gf_error_to_string(e));
+		gf_isom_close(movie);
+		return 1;
+	}
+	first_data = samp.data;
+	last_ref = NULL;
+	last_data = NULL;
+	for (i=0; i<count; i++) {
+		e = gf_isom_get_sample_ref(movie, 1, i+1, &samp, &di, &offset, &ref);
+		if (e || (samp.dataLength != 1024*1024) || (get_sample_stamp(samp.data) != i+1)) {
+			fprintf(stdout, "\nError checking sample %d: %s\n", i+1, e ? gf_error_to_string(e) : "corrupted data");
+			gf_isom_sample_ref_release(ref);
+			gf_isom_sample_ref_release(first_ref);
+			gf_isom_close(movie);
+			return 1;
+		}
+		fprintf(stdout, "Checking sample %d / %d \r", i+1, count);
+		if (i+1==count) {
+			last_ref = ref;
+			last_data = samp.data;
+			last_offset = offset;
+		} else {
+			gf_isom_sample_ref_release(ref);
+		}
+	}
+	gf_isom_close(movie);
+
+	/*references must remain valid after the file is closed*/
+	if (get_sample_stamp(first_data) != 1) e = GF_IO_ERR;
+	if (last_data && (get_sample_stamp(last_data) != count)) e = GF_IO_ERR;
+	gf_isom_sample_ref_release(first_ref);
+	gf_isom_sample_ref_release(last_ref);
+	if (e) {
+		fprintf(stdout, "\nError accessing samples after close\n");
+		return 1;
+	}
+	fprintf(stdout, "\nDone checking %d samples - last sample at offset "LLU"\n", count, last_offset);
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
 	GF_ISOFile *movie;
@@ -31,6 +97,9 @@ int main(int argc, char **argv)
 			gb_size = atof(argv[i+1]);
 			i++;
 		}
+		else if (!strcmp(argv[i], "-check")) {
+			return check_file();
+		}
 		else if (!strcmp(argv[i], "-h")) {
 			PrintUsage();
 			return 0;
@@ -59,6 +128,10 @@ int main(int argc, char **argv)
 	for (i=0; i<nb_samp; i++) {
 		if (samp->DTS % 25) samp->IsRAP = 0;
 		else samp->IsRAP = 1;
+		samp->data[0] = ((i+1)>>24) & 0xFF;
+		samp->data[1] = ((i+1)>>16) & 0xFF;
+		samp->data[2] = ((i+1)>>8) & 0xFF;
+		samp->data[3] = (i+1) & 0xFF;
 		e = gf_isom_add_sample(movie, track, di, samp);
 		samp->DTS += 1;
 
@@ -79,7 +152,7 @@ int main(int argc, char **argv)
 		fprintf(stdout, "Error writing file\n");
 		return 1;
 	}
-	return 0;
+	return check_file();
 }
 
 
@@ -0,0 +1,345 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - MPEG-2 TS multi-program mux test
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/mpegts.h>
+#include <gpac/constants.h>
+
+#define VIDEO_RATE	2500000
+#define VIDEO_FRAME_DUR	3600
+#define AUDIO_FRAME_DUR	1152
+#define AUDIO_FRAME_SIZE	576
+/*per program: video + audio + PSI/PES overhead*/
+#define PROGRAM_RATE	3000000
+/*PCR interval requested to the muxer, ISO/IEC 13818-1 maximum is 100 ms*/
+#define PCR_INTERVAL_MS	40
+#define PCR_MAX_INTERVAL_MS	100
+/*ISO/IEC 13818-1 PCR accuracy is +/- 500 ns, i.e. 13.5 ticks of the 27 MHz clock*/
+#define PCR_MAX_JITTER	13
+
+static void usage()
+{
+	fprintf(stderr, "usage: m2tsmpts [options]\n"
+	        "\n"
+	        "Muxes N synthetic video + audio programs in a CBR transport stream with the linear stream scan, the scheduling\n"
+	        "heap, and the scheduling heap with program threads. Sources generate their AU payloads when flushed.\n"
+	        "All outputs are checked to be identical, PCR jitter and interval are checked for each program, and\n"
+	        "packets/sec are reported for each mode.\n"
+	        "\n"
+	        "-progs N: number of programs (default 32)\n"
+	        "-dur N: muxed duration in seconds (default 10)\n"
+	        "-ahead N: number of AUs prepared ahead by program threads (default 4)\n"
+	       );
+}
+
+typedef struct
+{
+	GF_ESInterface ifce;
+	u32 au_num, nb_au, au_dur, rap_period;
+	u32 avg_size, seed;
+	u8 *data;
+} MuxSource;
+
+/*deterministic AU sizes so that all runs mux the same content*/
+static u32 source_au_size(MuxSource *src)
+{
+	u32 v;
+	if (src->rap_period == 1) return src->avg_size;
+	v = (src->au_num + 1) * 2654435761U + src->seed;
+	v ^= v >> 15;
+	/*RAPs are 3 times bigger*/
+	if (!(src->au_num % src->rap_period)) return 3*src->avg_size;
+	return src->avg_size/2 + v % src->avg_size;
+}
+
+/*generates and pushes one AU per flush*/
+static GF_Err source_input_ctrl(GF_ESInterface *ifce, u32 act_type, void *param)
+{
+	GF_ESIPacket pck;
+	u32 i, size, v;
+	MuxSource *src = (MuxSource *)ifce->input_udta;
+
+	if (act_type != GF_ESI_INPUT_DATA_FLUSH) return GF_OK;
+	if (src->au_num >= src->nb_au) return GF_OK;
+
+	size = source_au_size(src);
+	v = src->seed ^ src->au_num;
+	for (i=0; i<size; i++) {
+		v ^= v << 13;
+		v ^= v >> 17;
+		v ^= v << 5;
+		src->data[i] = (u8) v;
+	}
+
+	memset(&pck, 0, sizeof(GF_ESIPacket));
+	pck.data = (char *) src->data;
+	pck.data_len = size;
+	pck.flags = GF_ESI_DATA_AU_START | GF_ESI_DATA_AU_END | GF_ESI_DATA_HAS_CTS;
+	if (!(src->au_num % src->rap_period)) pck.flags |= GF_ESI_DATA_AU_RAP;
+	pck.dts = pck.cts = (u64) src->au_num * src->au_dur;
+	if (ifce->caps & GF_ESI_SIGNAL_DTS) {
+		pck.flags |= GF_ESI_DATA_HAS_DTS;
+		pck.cts += src->au_dur;
+	}
+	pck.duration = src->au_dur;
+	ifce->output_ctrl(ifce, GF_ESI_OUTPUT_DATA_DISPATCH, &pck);
+
+	src->au_num++;
+	if (src->au_num == src->nb_au) ifce->caps |= GF_ESI_STREAM_IS_OVER;
+	return GF_OK;
+}
+
+static void source_setup(MuxSource *src, Bool is_video, u32 prog_idx, u32 dur_sec)
+{
+	memset(src, 0, sizeof(MuxSource));
+	src->ifce.input_ctrl = source_input_ctrl;
+	src->ifce.input_udta = src;
+	src->ifce.duration = dur_sec*1000;
+	src->seed = 0x9E3779B9 * (2*prog_idx + (is_video ? 1 : 2));
+	if (is_video) {
+		src->ifce.caps = GF_ESI_SIGNAL_DTS;
+		src->ifce.stream_id = 1;
+		src->ifce.stream_type = GF_STREAM_VISUAL;
+		src->ifce.object_type_indication = GPAC_OTI_VIDEO_AVC;
+		src->ifce.timescale = 90000;
+		src->ifce.bit_rate = VIDEO_RATE;
+		src->au_dur = VIDEO_FRAME_DUR;
+		src->rap_period = 25;
+		src->avg_size = VIDEO_RATE / 8 / 25;
+		src->nb_au = dur_sec * 90000 / VIDEO_FRAME_DUR;
+	} else {
+		src->ifce.stream_id = 2;
+		src->ifce.stream_type = GF_STREAM_AUDIO;
+		src->ifce.object_type_indication = GPAC_OTI_AUDIO_MPEG1;
+		src->ifce.timescale = 48000;
+		src->ifce.bit_rate = AUDIO_FRAME_SIZE*8*48000/AUDIO_FRAME_DUR;
+		src->au_dur = AUDIO_FRAME_DUR;
+		src->rap_period = 1;
+		src->avg_size = AUDIO_FRAME_SIZE;
+		src->nb_au = dur_sec * 48000 / AUDIO_FRAME_DUR;
+	}
+	src->data = gf_malloc(3*src->avg_size);
+}
+
+enum
+{
+	MODE_LINEAR = 0,
+	MODE_HEAP,
+	MODE_THREADS,
+};
+static const char *mode_names[] = {"linear scan", "heap", "heap+threads"};
+
+static u32 video_pid(u32 prog_idx)
+{
+	return 0x100 + 2*prog_idx;
+}
+
+/*muxes nb_progs programs for dur_sec. If out is set, all packets are stored in it*/
+static u64 mux_run(u32 nb_progs, u32 dur_sec, u32 mode, u32 nb_au_ahead, u8 *out, u64 out_size, u64 *elapsed_us)
+{
+	MuxSource *sources;
+	GF_M2TS_Mux *muxer;
+	u8 burst_buf[188*64];
+	u64 nb_pck = 0, start;
+	u32 i, status = GF_M2TS_STATE_IDLE, usec_till_next;
+
+	sources = gf_malloc(sizeof(MuxSource) * 2 * nb_progs);
+	muxer = gf_m2ts_mux_new(nb_progs * PROGRAM_RATE, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, GF_FALSE);
+	gf_m2ts_mux_set_initial_pcr(muxer, 0);
+	gf_m2ts_mux_set_pcr_max_interval(muxer, PCR_INTERVAL_MS);
+	for (i=0; i<nb_progs; i++) {
+		GF_M2TS_Mux_Program *program = gf_m2ts_mux_program_add(muxer, i+1, 0x20 + i, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, 0, GF_M2TS_MPEG4_SIGNALING_NONE, 0, GF_FALSE);
+		source_setup(&sources[2*i], GF_TRUE, i, dur_sec);
+		source_setup(&sources[2*i+1], GF_FALSE, i, dur_sec);
+		gf_m2ts_program_stream_add(program, &sources[2*i].ifce, video_pid(i), GF_TRUE, GF_FALSE);
+		gf_m2ts_program_stream_add(program, &sources[2*i+1].ifce, video_pid(i)+1, GF_FALSE, GF_FALSE);
+	}
+	gf_m2ts_mux_update_config(muxer, GF_TRUE);
+	gf_m2ts_mux_enable_linear_scheduling(muxer, (mode==MODE_LINEAR) ? GF_TRUE : GF_FALSE);
+
+	start = gf_sys_clock_high_res();
+	if (mode==MODE_THREADS) gf_m2ts_mux_enable_program_threads(muxer, nb_au_ahead);
+
+	while (status != GF_M2TS_STATE_EOS) {
+		u32 nb_done;
+		u8 *dst = burst_buf;
+		if (out) {
+			if ((nb_pck+64)*188 > out_size) break;
+			dst = out + nb_pck*188;
+		}
+		gf_m2ts_mux_process_burst(muxer, dst, 64, &nb_done, &status, &usec_till_next);
+		if (!nb_done) break;
+		nb_pck += nb_done;
+	}
+	gf_m2ts_mux_del(muxer);
+	if (elapsed_us) *elapsed_us = gf_sys_clock_high_res() - start;
+
+	for (i=0; i<2*nb_progs; i++) gf_free(sources[i].data);
+	gf_free(sources);
+	return nb_pck;
+}
+
+/*checks PCR of each program against the packet position in the CBR stream*/
+static Bool check_pcr(u8 *data, u64 nb_pck, u32 nb_progs)
+{
+	u64 i, *first_pos, *last_pos, *first_pcr, *last_pcr;
+	u32 *nb_pcr;
+	u32 p, nb_errors = 0;
+	u64 rate = (u64) nb_progs * PROGRAM_RATE;
+	s64 max_jitter = 0;
+	u64 max_interval = 0;
+
+	first_pos = gf_malloc(sizeof(u64)*nb_progs);
+	last_pos = gf_malloc(sizeof(u64)*nb_progs);
+	first_pcr = gf_malloc(sizeof(u64)*nb_progs);
+	last_pcr = gf_malloc(sizeof(u64)*nb_progs);
+	nb_pcr = gf_malloc(sizeof(u32)*nb_progs);
+	memset(nb_pcr, 0, sizeof(u32)*nb_progs);
+
+	for (i=0; i<nb_pck; i++) {
+		u8 *pck = data + i*188;
+		u32 pid = ((pck[1] & 0x1F) << 8) | pck[2];
+		u64 pcr;
+		s64 jitter;
+		if (pck[0] != 0x47) {
+			nb_errors++;
+			continue;
+		}
+		/*adaptation field with PCR flag*/
+		if (!(pck[3] & 0x20) || !pck[4] || !(pck[5] & 0x10)) continue;
+		if ((pid < video_pid(0)) || (pid >= video_pid(nb_progs)) || (pid & 1)) {
+			nb_errors++;
+			continue;
+		}
+		p = (pid - video_pid(0)) / 2;
+
+		pcr = ((u64) pck[6] << 25) | ((u64) pck[7] << 17) | ((u64) pck[8] << 9) | ((u64) pck[9] << 1) | (pck[10] >> 7);
+		pcr = pcr * 300 + (((pck[10] & 1) << 8) | pck[11]);
+
+		if (!nb_pcr[p]) {
+			first_pos[p] = i;
+			first_pcr[p] = pcr;
+		} else {
+			u64 interval = (i - last_pos[p]) * 1504 * 27000000 / rate;
+			if (interval > max_interval) max_interval = interval;
+			if (pcr <= last_pcr[p]) nb_errors++;
+		}
+		/*PCR must follow the packet position at the mux rate*/
+		jitter = (s64) (pcr - first_pcr[p]) - (s64) ((i - first_pos[p]) * 1504 * 27000000 / rate);
+		if (ABS(jitter) > max_jitter) max_jitter = ABS(jitter);
+		last_pos[p] = i;
+		last_pcr[p] = pcr;
+		nb_pcr[p]++;
+	}
+	for (p=0; p<nb_progs; p++) {
+		if (nb_pcr[p] < 2) nb_errors++;
+	}
+	fprintf(stdout, "PCR check: max jitter "LLD" ns (max %d ns), max interval %.2f ms (requested %d ms, max %d ms) - %d errors\n",
+	        max_jitter * 1000 / 27, PCR_MAX_JITTER * 1000 / 27, ((Double) max_interval) / 27000, PCR_INTERVAL_MS, PCR_MAX_INTERVAL_MS, nb_errors);
+
+	gf_free(first_pos);
+	gf_free(last_pos);
+	gf_free(first_pcr);
+	gf_free(last_pcr);
+	gf_free(nb_pcr);
+
+	if (nb_errors) return GF_FALSE;
+	if (max_jitter > PCR_MAX_JITTER) return GF_FALSE;
+	if (max_interval > (u64) PCR_MAX_INTERVAL_MS * 27000) return GF_FALSE;
+	return GF_TRUE;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_progs = 32, dur_sec = 10, nb_au_ahead = 4;
+	u64 out_size, nb_ref = 0;
+	u8 *ref, *res;
+	Bool ok = GF_TRUE;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-progs") && (i+1<(u32) argc)) {
+			nb_progs = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-dur") && (i+1<(u32) argc)) {
+			dur_sec = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-ahead") && (i+1<(u32) argc)) {
+			nb_au_ahead = atoi(argv[i+1]);
+			i++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_progs || (nb_progs>1000) || !dur_sec || !nb_au_ahead) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+	/*RAP frames are sent after their DTS, don't flood the console*/
+	gf_log_set_tool_level(GF_LOG_CONTAINER, GF_LOG_ERROR);
+	gf_rand_init(GF_FALSE);
+
+	/*output is slightly longer than the content*/
+	out_size = (u64) (dur_sec + 2) * nb_progs * PROGRAM_RATE / 8;
+	ref = gf_malloc((size_t) out_size);
+	res = gf_malloc((size_t) out_size);
+
+	fprintf(stdout, "CBR %d kbps mux, %d programs, %d sec:\n", nb_progs * PROGRAM_RATE / 1000, nb_progs, dur_sec);
+	for (i=MODE_LINEAR; i<=MODE_THREADS; i++) {
+		u64 elapsed, nb;
+		Double pps;
+		u8 *dst = (i==MODE_LINEAR) ? ref : res;
+
+		nb = mux_run(nb_progs, dur_sec, i, nb_au_ahead, dst, out_size, &elapsed);
+		pps = elapsed ? ((Double) nb) * 1000000 / elapsed : 0;
+		fprintf(stdout, "%-16s "LLU" packets in %7.1f ms - %10.0f packets/s\n", mode_names[i], nb, ((Double) elapsed)/1000, pps);
+
+		if (i==MODE_LINEAR) {
+			nb_ref = nb;
+			if (!nb || ((nb+64)*188 > out_size)) {
+				fprintf(stdout, "Mux failed ("LLU" packets) - FAILED\n", nb);
+				ok = GF_FALSE;
+				break;
+			}
+		} else if ((nb != nb_ref) || memcmp(ref, res, (size_t) (nb*188))) {
+			fprintf(stdout, "%s output differs from linear scan output ("LLU" vs "LLU" packets) - FAILED\n", mode_names[i], nb, nb_ref);
+			ok = GF_FALSE;
+		}
+	}
+	if (ok) {
+		fprintf(stdout, "Outputs identical - OK\n");
+		ok = check_pcr(ref, nb_ref, nb_progs);
+		fprintf(stdout, "PCR check - %s\n", ok ? "OK" : "FAILED");
+	}
+
+	gf_free(ref);
+	gf_free(res);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
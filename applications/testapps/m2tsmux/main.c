@@ -0,0 +1,338 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - MPEG-2 TS mux test
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/mpegts.h>
+#include <gpac/constants.h>
+
+#define MUX_RATE	100000000
+#define VIDEO_PID	101
+#define AUDIO_PID	102
+#define VIDEO_FRAME_DUR	3600
+#define VIDEO_MIN_SIZE	150000
+#define VIDEO_MAX_SIZE	450000
+#define AUDIO_FRAME_DUR	1152
+#define AUDIO_FRAME_SIZE	576
+
+static void usage()
+{
+	fprintf(stderr, "usage: m2tsmux [options]\n"
+	        "\n"
+	        "Muxes a synthetic 60 Mbps video + audio program in a CBR 100 Mbps transport stream and reports packets/sec\n"
+	        "when fetching one packet per call and when fetching bursts of packets in a caller buffer.\n"
+	        "Burst output is first checked to be identical to single packet output, and the timestamps and PCRs are\n"
+	        "checked by demuxing the result.\n"
+	        "\n"
+	        "-dur N: muxed duration in seconds for the benchmark (default 20)\n"
+	        "-burst N: burst size in packets (default 64)\n"
+	       );
+}
+
+typedef struct
+{
+	GF_ESInterface ifce;
+	u32 au_num, nb_au, au_dur, rap_period;
+	u32 min_size, max_size;
+	u8 *data;
+} MuxSource;
+
+/*deterministic AU sizes so that all runs mux the same content*/
+static u32 source_au_size(MuxSource *src)
+{
+	u32 v;
+	if (src->min_size == src->max_size) return src->min_size;
+	v = (src->au_num + 1) * 2654435761U;
+	v ^= v >> 15;
+	return src->min_size + v % (src->max_size - src->min_size);
+}
+
+/*pushes one AU per flush, as mp42ts sources do*/
+static GF_Err source_input_ctrl(GF_ESInterface *ifce, u32 act_type, void *param)
+{
+	GF_ESIPacket pck;
+	MuxSource *src = (MuxSource *)ifce->input_udta;
+
+	if (act_type != GF_ESI_INPUT_DATA_FLUSH) return GF_OK;
+	if (src->au_num >= src->nb_au) return GF_OK;
+
+	memset(&pck, 0, sizeof(GF_ESIPacket));
+	pck.data = (char *) src->data;
+	pck.data_len = source_au_size(src);
+	pck.flags = GF_ESI_DATA_AU_START | GF_ESI_DATA_AU_END | GF_ESI_DATA_HAS_CTS;
+	if (!(src->au_num % src->rap_period)) pck.flags |= GF_ESI_DATA_AU_RAP;
+	pck.dts = pck.cts = (u64) src->au_num * src->au_dur;
+	if (ifce->caps & GF_ESI_SIGNAL_DTS) {
+		pck.flags |= GF_ESI_DATA_HAS_DTS;
+		pck.cts += src->au_dur;
+	}
+	pck.duration = src->au_dur;
+	ifce->output_ctrl(ifce, GF_ESI_OUTPUT_DATA_DISPATCH, &pck);
+
+	src->au_num++;
+	if (src->au_num == src->nb_au) ifce->caps |= GF_ESI_STREAM_IS_OVER;
+	return GF_OK;
+}
+
+static void source_setup(MuxSource *src, Bool is_video, u32 dur_sec, u8 *data)
+{
+	memset(src, 0, sizeof(MuxSource));
+	src->data = data;
+	src->ifce.input_ctrl = source_input_ctrl;
+	src->ifce.input_udta = src;
+	src->ifce.duration = dur_sec*1000;
+	if (is_video) {
+		src->ifce.caps = GF_ESI_SIGNAL_DTS;
+		src->ifce.stream_id = VIDEO_PID;
+		src->ifce.stream_type = GF_STREAM_VISUAL;
+		src->ifce.object_type_indication = GPAC_OTI_VIDEO_AVC;
+		src->ifce.timescale = 90000;
+		src->ifce.bit_rate = 60000000;
+		src->au_dur = VIDEO_FRAME_DUR;
+		src->rap_period = 25;
+		src->min_size = VIDEO_MIN_SIZE;
+		src->max_size = VIDEO_MAX_SIZE;
+		src->nb_au = dur_sec * 90000 / VIDEO_FRAME_DUR;
+	} else {
+		src->ifce.stream_id = AUDIO_PID;
+		src->ifce.stream_type = GF_STREAM_AUDIO;
+		src->ifce.object_type_indication = GPAC_OTI_AUDIO_MPEG1;
+		src->ifce.timescale = 48000;
+		src->ifce.bit_rate = AUDIO_FRAME_SIZE*8*48000/AUDIO_FRAME_DUR;
+		src->au_dur = AUDIO_FRAME_DUR;
+		src->rap_period = 1;
+		src->min_size = src->max_size = AUDIO_FRAME_SIZE;
+		src->nb_au = dur_sec * 48000 / AUDIO_FRAME_DUR;
+	}
+}
+
+static u8 *au_data = NULL;
+
+/*muxes dur_sec of content, one packet per call if burst is 0. If out is set, all packets are stored in it*/
+static u64 mux_run(u32 dur_sec, u32 burst, u8 *out, u64 out_size, u64 *elapsed_us)
+{
+	MuxSource video, audio;
+	GF_M2TS_Mux *muxer;
+	GF_M2TS_Mux_Program *program;
+	u8 pack[188*7];
+	u8 *burst_buf = NULL;
+	u64 nb_pck = 0, start;
+	u32 status = GF_M2TS_STATE_IDLE, usec_till_next, nb_pack = 0;
+
+	source_setup(&video, GF_TRUE, dur_sec, au_data);
+	source_setup(&audio, GF_FALSE, dur_sec, au_data);
+
+	muxer = gf_m2ts_mux_new(MUX_RATE, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, GF_FALSE);
+	gf_m2ts_mux_set_initial_pcr(muxer, 0);
+	program = gf_m2ts_mux_program_add(muxer, 1, 100, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, 0, GF_M2TS_MPEG4_SIGNALING_NONE, 0, GF_FALSE);
+	gf_m2ts_program_stream_add(program, &video.ifce, VIDEO_PID, GF_TRUE, GF_FALSE);
+	gf_m2ts_program_stream_add(program, &audio.ifce, AUDIO_PID, GF_FALSE, GF_FALSE);
+	gf_m2ts_mux_update_config(muxer, GF_TRUE);
+
+	if (burst && !out) burst_buf = gf_malloc(188*burst);
+
+	start = gf_sys_clock_high_res();
+	while (status != GF_M2TS_STATE_EOS) {
+		if (!burst) {
+			const char *pck = gf_m2ts_mux_process(muxer, &status, &usec_till_next);
+			if (!pck) break;
+			/*same as mp42ts packing*/
+			if (out) {
+				if ((nb_pck+1)*188 > out_size) break;
+				memcpy(out + nb_pck*188, pck, 188);
+			} else {
+				memcpy(pack + 188*nb_pack, pck, 188);
+				nb_pack++;
+				if (nb_pack==7) nb_pack = 0;
+			}
+			nb_pck++;
+		} else {
+			u32 nb_done;
+			u8 *dst = burst_buf;
+			if (out) {
+				if ((nb_pck+burst)*188 > out_size) break;
+				dst = out + nb_pck*188;
+			}
+			gf_m2ts_mux_process_burst(muxer, dst, burst, &nb_done, &status, &usec_till_next);
+			if (!nb_done) break;
+			nb_pck += nb_done;
+		}
+	}
+	if (elapsed_us) *elapsed_us = gf_sys_clock_high_res() - start;
+
+	if (burst_buf) gf_free(burst_buf);
+	gf_m2ts_mux_del(muxer);
+	return nb_pck;
+}
+
+typedef struct
+{
+	u32 nb_video, audio_bytes, nb_pcr, nb_errors;
+	u64 last_dts, last_audio_pts, last_pcr;
+} DemuxCheck;
+
+static void on_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
+{
+	u32 i;
+	DemuxCheck *dc = (DemuxCheck *)ts->user;
+	if (evt_type == GF_M2TS_EVT_PMT_FOUND) {
+		GF_M2TS_Program *prog = (GF_M2TS_Program *)par;
+		for (i=0; i<gf_list_count(prog->streams); i++) {
+			GF_M2TS_ES *es = (GF_M2TS_ES *)gf_list_get(prog->streams, i);
+			if ((es->pid == prog->pmt_pid) || !(es->flags & GF_M2TS_ES_IS_PES)) continue;
+			gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_RAW);
+		}
+	}
+	else if (evt_type == GF_M2TS_EVT_PES_PCK) {
+		GF_M2TS_PES_PCK *pck = (GF_M2TS_PES_PCK *)par;
+		if (pck->stream->pid == VIDEO_PID) {
+			if (pck->PTS != pck->DTS + VIDEO_FRAME_DUR) dc->nb_errors++;
+			if (dc->nb_video && (pck->DTS != dc->last_dts + VIDEO_FRAME_DUR)) dc->nb_errors++;
+			dc->last_dts = pck->DTS;
+			dc->nb_video++;
+		} else if (pck->stream->pid == AUDIO_PID) {
+			/*audio AUs are packed in PES and may span two PES*/
+			if (dc->audio_bytes && (pck->PTS <= dc->last_audio_pts)) dc->nb_errors++;
+			dc->last_audio_pts = pck->PTS;
+			dc->audio_bytes += pck->data_len;
+		}
+	}
+	else if (evt_type == GF_M2TS_EVT_PES_PCR) {
+		GF_M2TS_PES_PCK *pck = (GF_M2TS_PES_PCK *)par;
+		/*CBR: the PCR must match the position of the packet in the stream, 1 ms tolerance*/
+		s64 expected = (s64) (ts->pck_number - 1) * 1504 * 27000000 / MUX_RATE;
+		if (ABS((s64) pck->PTS - expected) > 27000) dc->nb_errors++;
+		if (dc->nb_pcr && (pck->PTS <= dc->last_pcr)) dc->nb_errors++;
+		dc->last_pcr = pck->PTS;
+		dc->nb_pcr++;
+	}
+}
+
+static Bool check_demux(u8 *data, u64 nb_pck, u32 dur_sec)
+{
+	DemuxCheck dc;
+	GF_M2TS_Demuxer *ts = gf_m2ts_demux_new();
+	memset(&dc, 0, sizeof(DemuxCheck));
+	ts->on_event = on_event;
+	ts->user = &dc;
+	gf_m2ts_process_data(ts, (char *) data, (u32) (nb_pck*188));
+	gf_m2ts_demux_del(ts);
+
+	fprintf(stdout, "Demux check: %d video PES, %d audio bytes, %d PCRs - %d errors\n", dc.nb_video, dc.audio_bytes, dc.nb_pcr, dc.nb_errors);
+	if (dc.nb_errors) return GF_FALSE;
+	/*video PES have no length, the last one is never flushed*/
+	if (dc.nb_video + 1 != dur_sec*90000/VIDEO_FRAME_DUR) return GF_FALSE;
+	if (dc.audio_bytes != dur_sec*48000/AUDIO_FRAME_DUR * AUDIO_FRAME_SIZE) return GF_FALSE;
+	if (!dc.nb_pcr) return GF_FALSE;
+	return GF_TRUE;
+}
+
+static Bool check_burst(u32 burst_size)
+{
+	u32 i, dur_sec = 2;
+	u64 nb_ref, out_size = (u64) dur_sec * 2 * MUX_RATE / 8;
+	u8 *ref = gf_malloc(out_size);
+	u8 *res = gf_malloc(out_size);
+	Bool ok = GF_TRUE;
+	u32 bursts[3];
+	bursts[0] = 1;
+	bursts[1] = 7;
+	bursts[2] = burst_size;
+
+	nb_ref = mux_run(dur_sec, 0, ref, out_size, NULL);
+	if (!nb_ref || (nb_ref*188 >= out_size)) {
+		fprintf(stdout, "Single packet mux failed ("LLU" packets)\n", nb_ref);
+		ok = GF_FALSE;
+	}
+	for (i=0; ok && i<3; i++) {
+		u64 nb = mux_run(dur_sec, bursts[i], res, out_size, NULL);
+		if ((nb != nb_ref) || memcmp(ref, res, (size_t) (nb*188))) {
+			fprintf(stdout, "Burst of %d packets: output differs from single packet output ("LLU" vs "LLU" packets) - FAILED\n", bursts[i], nb, nb_ref);
+			ok = GF_FALSE;
+		}
+	}
+	if (ok) {
+		fprintf(stdout, "Burst output identical to single packet output ("LLU" packets) - OK\n", nb_ref);
+		ok = check_demux(ref, nb_ref, dur_sec);
+		fprintf(stdout, "Demux check - %s\n", ok ? "OK" : "FAILED");
+	}
+	gf_free(ref);
+	gf_free(res);
+	return ok;
+}
+
+static void bench(const char *name, u32 dur_sec, u32 burst)
+{
+	u64 elapsed;
+	u64 nb = mux_run(dur_sec, burst, NULL, 0, &elapsed);
+	Double pps = elapsed ? ((Double) nb) * 1000000 / elapsed : 0;
+	fprintf(stdout, "%-16s "LLU" packets in %6.1f ms - %10.0f packets/s - %6.1fx real time\n", name, nb, ((Double) elapsed)/1000, pps, pps * 1504 / (MUX_RATE));
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, dur_sec = 20, burst = 64;
+	char name[100];
+	Bool ok;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-dur") && (i+1<(u32) argc)) {
+			dur_sec = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-burst") && (i+1<(u32) argc)) {
+			burst = atoi(argv[i+1]);
+			i++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!dur_sec || !burst) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+	/*large video frames are always sent after their DTS at this rate, don't flood the console*/
+	gf_log_set_tool_level(GF_LOG_CONTAINER, GF_LOG_ERROR);
+	gf_rand_init(GF_FALSE);
+
+	au_data = gf_malloc(VIDEO_MAX_SIZE);
+	for (i=0; i<VIDEO_MAX_SIZE; i++) au_data[i] = gf_rand();
+
+	ok = check_burst(burst);
+
+	fprintf(stdout, "CBR %d kbps mux, %d sec:\n", MUX_RATE/1000, dur_sec);
+	bench("single packet", dur_sec, 0);
+	sprintf(name, "burst %d", 7);
+	bench(name, dur_sec, 7);
+	sprintf(name, "burst %d", burst);
+	bench(name, dur_sec, burst);
+
+	gf_free(au_data);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,416 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - MPEG-2 TS input path test
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/mpegts.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: m2tsslices [options]\n"
+	        "\n"
+	        "Generates a transport stream with one video and one audio PID and demuxes it with data fed in packet-aligned\n"
+	        "and random-sized chunks, with and without 4-byte packet prefixes and leading garbage. Checks that reassembled\n"
+	        "PES (raw framing) and scatter-gather slices both give back the generated payloads, and compares their speed.\n"
+	        "\n"
+	        "-size N: approximate stream size in MB (default 32)\n"
+	        "-loops N: number of demux runs for the benchmark (default 4)\n"
+	       );
+}
+
+#define VIDEO_PID	0x101
+#define AUDIO_PID	0x102
+#define PMT_PID		0x100
+
+typedef struct
+{
+	u8 *data;
+	u32 size, alloc;
+} Buffer;
+
+static void buf_add(Buffer *b, const u8 *data, u32 size)
+{
+	if (b->size + size > b->alloc) {
+		b->alloc = MAX(2*b->alloc, b->size + size);
+		b->data = gf_realloc(b->data, b->alloc);
+	}
+	memcpy(b->data + b->size, data, size);
+	b->size += size;
+}
+
+typedef struct
+{
+	u32 pid;
+	/*generated PES packets*/
+	Buffer pes;
+	u32 *pes_start;
+	u64 *pes_pts;
+	u32 nb_pes;
+	/*expected payload, without PES headers*/
+	Buffer payload;
+	/*packetization state*/
+	u32 pos, cur_pes;
+	u8 cc;
+
+	/*demux output*/
+	Buffer out;
+	Buffer assemble;
+	u32 nb_out_pes;
+	Bool in_pes;
+	u32 hdr_size;
+	u32 errors;
+} Stream;
+
+static Stream streams[2];
+
+static u32 nb_slices, nb_events;
+static Bool use_slices;
+
+static Stream *get_stream(u32 pid)
+{
+	if (pid==VIDEO_PID) return &streams[0];
+	if (pid==AUDIO_PID) return &streams[1];
+	return NULL;
+}
+
+static void write_pts(u8 *p, u8 marker, u64 pts)
+{
+	p[0] = marker | (u8) (((pts>>30) & 0x7)<<1) | 1;
+	p[1] = (u8) (pts>>22);
+	p[2] = (u8) (((pts>>15) & 0x7F)<<1) | 1;
+	p[3] = (u8) (pts>>7);
+	p[4] = (u8) ((pts & 0x7F)<<1) | 1;
+}
+
+/*generates PES packets for a stream - video PES have no length*/
+static void gen_pes(Stream *st, u32 nb_pes, u32 min_size, u32 max_size, Bool is_video)
+{
+	u32 i, j;
+	u8 hdr[9+5+16], payload[40000];
+	st->pes_start = gf_malloc(sizeof(u32)*(nb_pes+1));
+	st->pes_pts = gf_malloc(sizeof(u64)*(nb_pes+1));
+	for (i=0; i<=nb_pes; i++) {
+		/*last PES is empty and only flushes the previous one*/
+		u32 size = (i==nb_pes) ? 0 : min_size + gf_rand() % (max_size - min_size);
+		u32 stuffing = gf_rand() % 16;
+		u64 pts = 90000 + (u64) i * (is_video ? 3600 : 1920);
+		for (j=0; j<size; j++) payload[j] = (u8) gf_rand();
+
+		hdr[0] = hdr[1] = 0;
+		hdr[2] = 1;
+		hdr[3] = is_video ? 0xE0 : 0xC0;
+		j = (is_video || (i==nb_pes)) ? 0 : (3 + 5 + stuffing + size);
+		hdr[4] = (j>>8) & 0xFF;
+		hdr[5] = j & 0xFF;
+		hdr[6] = 0x80;
+		hdr[7] = 0x80;
+		hdr[8] = 5 + stuffing;
+		write_pts(hdr+9, 0x20, pts);
+		memset(hdr+14, 0xFF, stuffing);
+
+		st->pes_start[i] = st->pes.size;
+		st->pes_pts[i] = pts;
+		buf_add(&st->pes, hdr, 14 + stuffing);
+		buf_add(&st->pes, payload, size);
+		if (i<nb_pes) buf_add(&st->payload, payload, size);
+	}
+	st->nb_pes = nb_pes+1;
+}
+
+static void write_pck(Buffer *ts, u32 pid, Bool pusi, Bool rai, u8 *cc, const u8 *payload, u32 size)
+{
+	u8 pck[188];
+	u32 af_len = 0;
+	pck[0] = 0x47;
+	pck[1] = (pusi ? 0x40 : 0) | ((pid>>8) & 0x1F);
+	pck[2] = pid & 0xFF;
+	if (rai || (size<184)) {
+		af_len = 183 - size;
+		pck[3] = 0x30 | *cc;
+		pck[4] = af_len;
+		if (af_len) {
+			pck[5] = rai ? 0x40 : 0;
+			memset(pck+6, 0xFF, af_len-1);
+		}
+		af_len++;
+	} else {
+		pck[3] = 0x10 | *cc;
+	}
+	memcpy(pck + 4 + af_len, payload, size);
+	*cc = (*cc + 1) & 0xF;
+	buf_add(ts, pck, 188);
+}
+
+static void write_section(Buffer *ts, u32 pid, u8 *section, u32 len, u8 *cc)
+{
+	u8 payload[184];
+	u32 crc = gf_crc_32((char *) section, len);
+	section[len] = (crc>>24) & 0xFF;
+	section[len+1] = (crc>>16) & 0xFF;
+	section[len+2] = (crc>>8) & 0xFF;
+	section[len+3] = crc & 0xFF;
+	len += 4;
+	payload[0] = 0;
+	memcpy(payload+1, section, len);
+	memset(payload+1+len, 0xFF, 183-len);
+	write_pck(ts, pid, GF_TRUE, GF_FALSE, cc, payload, 184);
+}
+
+static void write_tables(Buffer *ts, u8 *pat_cc, u8 *pmt_cc)
+{
+	u8 pat[] = {0x00, 0xB0, 13, 0x00, 0x01, 0xC1, 0x00, 0x00, 0x00, 0x01, 0xE0 | (PMT_PID>>8), PMT_PID & 0xFF, 0, 0, 0, 0};
+	u8 pmt[] = {0x02, 0xB0, 23, 0x00, 0x01, 0xC1, 0x00, 0x00, 0xE0 | (VIDEO_PID>>8), VIDEO_PID & 0xFF, 0xF0, 0x00,
+	            GF_M2TS_VIDEO_H264, 0xE0 | (VIDEO_PID>>8), VIDEO_PID & 0xFF, 0xF0, 0x00,
+	            GF_M2TS_AUDIO_AAC, 0xE0 | (AUDIO_PID>>8), AUDIO_PID & 0xFF, 0xF0, 0x00, 0, 0, 0, 0
+	           };
+	write_section(ts, 0, pat, sizeof(pat)-4, pat_cc);
+	write_section(ts, PMT_PID, pmt, sizeof(pmt)-4, pmt_cc);
+}
+
+/*interleaves the PES of both streams in transport packets*/
+static void gen_ts(Buffer *ts)
+{
+	u8 pat_cc = 0, pmt_cc = 0;
+	u32 nb_pck = 0;
+	write_tables(ts, &pat_cc, &pmt_cc);
+	while (1) {
+		Stream *st;
+		u32 end, size;
+		Bool pusi;
+		if (streams[0].pos < streams[0].pes.size) {
+			st = &streams[0];
+			if ((streams[1].pos < streams[1].pes.size) && (gf_rand() % 4 == 0)) st = &streams[1];
+		} else if (streams[1].pos < streams[1].pes.size) {
+			st = &streams[1];
+		} else {
+			break;
+		}
+		pusi = (st->pos == st->pes_start[st->cur_pes]) ? GF_TRUE : GF_FALSE;
+		end = (st->cur_pes+1 < st->nb_pes) ? st->pes_start[st->cur_pes+1] : st->pes.size;
+		size = MIN(184, end - st->pos);
+		if (pusi && (st == &streams[0]) && (st->cur_pes % 10 == 0)) {
+			size = MIN(182, size);
+			write_pck(ts, st->pid, pusi, GF_TRUE, &st->cc, st->pes.data + st->pos, size);
+		} else {
+			write_pck(ts, st->pid, pusi, GF_FALSE, &st->cc, st->pes.data + st->pos, size);
+		}
+		st->pos += size;
+		if (st->pos == end) st->cur_pes++;
+		nb_pck++;
+		if (nb_pck % 2000 == 0) write_tables(ts, &pat_cc, &pmt_cc);
+	}
+}
+
+static void on_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
+{
+	u32 i;
+	Stream *st;
+	if (evt_type == GF_M2TS_EVT_PMT_FOUND) {
+		GF_M2TS_Program *prog = (GF_M2TS_Program *)par;
+		for (i=0; i<gf_list_count(prog->streams); i++) {
+			GF_M2TS_ES *es = (GF_M2TS_ES *)gf_list_get(prog->streams, i);
+			if ((es->pid == prog->pmt_pid) || !(es->flags & GF_M2TS_ES_IS_PES)) continue;
+			gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, use_slices ? GF_M2TS_PES_FRAMING_SLICES : GF_M2TS_PES_FRAMING_RAW);
+		}
+	}
+	else if (evt_type == GF_M2TS_EVT_PES_PCK) {
+		GF_M2TS_PES_PCK *pck = (GF_M2TS_PES_PCK *)par;
+		st = get_stream(pck->stream->pid);
+		if (!st) return;
+		if ((st->nb_out_pes >= st->nb_pes) || (pck->PTS != st->pes_pts[st->nb_out_pes])) st->errors++;
+		buf_add(&st->out, (u8 *) pck->data, pck->data_len);
+		st->nb_out_pes++;
+	}
+	else if (evt_type == GF_M2TS_EVT_PES_SLICES) {
+		GF_M2TS_PES_SLICES *sl = (GF_M2TS_PES_SLICES *)par;
+		st = get_stream(sl->stream->pid);
+		if (!st) return;
+		nb_events++;
+		nb_slices += sl->nb_slices;
+		if (sl->flags & GF_M2TS_PES_SLICES_DISCARD) {
+			st->errors++;
+			st->in_pes = GF_FALSE;
+			return;
+		}
+		if (sl->flags & GF_M2TS_PES_SLICES_START) {
+			if (st->in_pes || !sl->hdr_size) st->errors++;
+			if ((st->nb_out_pes >= st->nb_pes) || (sl->PTS != st->pes_pts[st->nb_out_pes])) st->errors++;
+			st->in_pes = GF_TRUE;
+			st->hdr_size = sl->hdr_size;
+			st->assemble.size = 0;
+		} else if (!st->in_pes) {
+			st->errors++;
+			return;
+		}
+		for (i=0; i<sl->nb_slices; i++) {
+			buf_add(&st->assemble, sl->slices[i].data, sl->slices[i].size);
+		}
+		if (sl->flags & GF_M2TS_PES_SLICES_END) {
+			buf_add(&st->out, st->assemble.data + st->hdr_size, st->assemble.size - st->hdr_size);
+			st->nb_out_pes++;
+			st->in_pes = GF_FALSE;
+		}
+	}
+}
+
+/*feeds data with chunk size, or random chunk sizes if 0 - returns time spent in the demuxer*/
+static u64 demux(Buffer *ts_data, Bool slices, u32 chunk_size)
+{
+	u32 i, pos = 0;
+	u64 start, time = 0;
+	GF_M2TS_Demuxer *ts = gf_m2ts_demux_new();
+	ts->on_event = on_event;
+	use_slices = slices;
+	for (i=0; i<2; i++) {
+		streams[i].out.size = 0;
+		streams[i].nb_out_pes = 0;
+		streams[i].in_pes = GF_FALSE;
+		streams[i].errors = 0;
+	}
+	nb_slices = nb_events = 0;
+
+	while (pos < ts_data->size) {
+		u32 size = chunk_size;
+		if (!size) {
+			u32 r = gf_rand() % 10;
+			size = (r<3) ? 1 + gf_rand()%4 : 1 + gf_rand()%2000;
+		}
+		if (pos + size > ts_data->size) size = ts_data->size - pos;
+		start = gf_sys_clock_high_res();
+		gf_m2ts_process_data(ts, (char *) ts_data->data + pos, size);
+		time += gf_sys_clock_high_res() - start;
+		pos += size;
+	}
+	gf_m2ts_demux_del(ts);
+	return time;
+}
+
+static Bool check_output(const char *name)
+{
+	u32 i;
+	Bool ok = GF_TRUE;
+	for (i=0; i<2; i++) {
+		Stream *st = &streams[i];
+		/*the last PES of each stream is empty and never completed*/
+		if (st->errors || (st->nb_out_pes != st->nb_pes-1) || (st->out.size != st->payload.size) || memcmp(st->out.data, st->payload.data, st->payload.size)) {
+			fprintf(stdout, "%s: PID %d FAILED - %d/%d PES %d/%d bytes %d errors\n", name, st->pid, st->nb_out_pes, st->nb_pes-1, st->out.size, st->payload.size, st->errors);
+			ok = GF_FALSE;
+		}
+	}
+	if (ok) fprintf(stdout, "%s: OK\n", name);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, j, size_mb=32, nb_loops=4, nb_video;
+	Buffer ts_data, prefixed;
+	u64 t_raw, t_slices, nb_bytes;
+	Bool ok = GF_TRUE;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			size_mb = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-loops") && (i+1<(u32) argc)) {
+			nb_loops = atoi(argv[i+1]);
+			i++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!size_mb) size_mb = 1;
+	if (!nb_loops) nb_loops = 1;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+	gf_rand_init(GF_TRUE);
+
+	memset(streams, 0, sizeof(streams));
+	memset(&ts_data, 0, sizeof(Buffer));
+	memset(&prefixed, 0, sizeof(Buffer));
+	streams[0].pid = VIDEO_PID;
+	streams[1].pid = AUDIO_PID;
+	/*about 20 kB per video PES, one audio PES every 2 video PES*/
+	nb_video = size_mb * 1024 * 1024 / 21000;
+	gen_pes(&streams[0], nb_video, 1000, 39000, GF_TRUE);
+	gen_pes(&streams[1], nb_video/2, 100, 1500, GF_FALSE);
+	gen_ts(&ts_data);
+
+	/*leading garbage and 4-byte prefix before each packet*/
+	for (i=0; i<100; i++) {
+		u8 c = (u8) gf_rand();
+		if (c==0x47) c = 0;
+		buf_add(&prefixed, &c, 1);
+	}
+	for (i=0; i<ts_data.size; i+=188) {
+		u8 prefix[4];
+		for (j=0; j<4; j++) prefix[j] = (u8) j;
+		buf_add(&prefixed, prefix, 4);
+		buf_add(&prefixed, ts_data.data + i, 188);
+	}
+	/*packets are processed with their following prefix, complete the last one*/
+	buf_add(&prefixed, ts_data.data, 4);
+	fprintf(stdout, "Generated %d bytes - %d video and %d audio PES\n", ts_data.size, streams[0].nb_pes-1, streams[1].nb_pes-1);
+
+	for (i=0; i<2; i++) {
+		Bool slices = i ? GF_TRUE : GF_FALSE;
+		const char *mode = slices ? "slices" : "raw";
+		char name[100];
+		sprintf(name, "%s - aligned input", mode);
+		demux(&ts_data, slices, 7*188);
+		if (!check_output(name)) ok = GF_FALSE;
+		sprintf(name, "%s - random chunks", mode);
+		demux(&ts_data, slices, 0);
+		if (!check_output(name)) ok = GF_FALSE;
+		sprintf(name, "%s - prefixed packets with garbage, random chunks", mode);
+		demux(&prefixed, slices, 0);
+		if (!check_output(name)) ok = GF_FALSE;
+	}
+
+	t_raw = t_slices = 0;
+	for (i=0; i<nb_loops; i++) {
+		t_raw += demux(&ts_data, GF_FALSE, 7*188);
+		t_slices += demux(&ts_data, GF_TRUE, 7*188);
+	}
+	nb_bytes = (u64) ts_data.size * nb_loops * 8;
+	if (!t_raw) t_raw = 1;
+	if (!t_slices) t_slices = 1;
+	fprintf(stdout, "1316-byte chunks: raw framing %.2f Mbps - slices %.2f Mbps (%d slices in %d events per run)\n", ((Double) nb_bytes) / t_raw, ((Double) nb_bytes) / t_slices, nb_slices, nb_events);
+
+	for (i=0; i<2; i++) {
+		gf_free(streams[i].pes.data);
+		gf_free(streams[i].payload.data);
+		gf_free(streams[i].out.data);
+		gf_free(streams[i].assemble.data);
+		gf_free(streams[i].pes_start);
+		gf_free(streams[i].pes_pts);
+	}
+	gf_free(ts_data.data);
+	gf_free(prefixed.data);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,380 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - MPD parsing test
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/xml.h>
+#include <gpac/internal/mpd.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: mpdparse [options]\n"
+	        "\n"
+	        "Generates a live MPD with long SegmentTimelines, checks the SAX loader gives the same MPD as the DOM loader\n"
+	        "and reports the load time of both. Also checks SegmentTimeline merging of a sliding window update.\n"
+	        "\n"
+	        "-segs N: number of S elements per timeline (default 14400, 8 hours of 2s segments)\n"
+	        "-runs N: number of loads for timing (default 10)\n"
+	        "-mpd FILE: use FILE instead of generated MPD\n"
+	       );
+}
+
+static void write_timeline(FILE *f, u32 nb_segs, u32 timescale)
+{
+	u32 i;
+	u64 t = 0;
+	fprintf(f, "    <SegmentTimeline>\n");
+	for (i=0; i<nb_segs; i++) {
+		/*drifting durations, one S per segment as produced by most live packagers*/
+		u32 d = 2*timescale + ((i%3) ? 0 : timescale/100);
+		if (!i) fprintf(f, "     <S t=\""LLU"\" d=\"%d\"/>\n", t, d);
+		else if (i%50) fprintf(f, "     <S d=\"%d\"/>\n", d);
+		else {
+			fprintf(f, "     <S t=\""LLU"\" d=\"%d\" r=\"1\"/>\n", t, d);
+			t += d;
+		}
+		t += d;
+	}
+	fprintf(f, "    </SegmentTimeline>\n");
+}
+
+static void write_mpd(const char *name, u32 nb_segs)
+{
+	u32 i;
+	FILE *f = gf_fopen(name, "wt");
+	fprintf(f, "<?xml version=\"1.0\"?>\n"
+	        "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" xmlns:ext=\"urn:gpac:test\" type=\"dynamic\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\" availabilityStartTime=\"2019-01-01T00:00:00Z\" publishTime=\"2019-01-01T08:00:00Z\" minimumUpdatePeriod=\"PT2S\" timeShiftBufferDepth=\"PT8H\" minBufferTime=\"PT4S\" ext:custom=\"1\">\n"
+	        " <ProgramInformation moreInformationURL=\"http://gpac.io\"><Title>Live test</Title><Source>mpdparse</Source></ProgramInformation>\n"
+	        " <Location>http://127.0.0.1/live.mpd</Location>\n"
+	        " <BaseURL>http://127.0.0.1/live/</BaseURL>\n"
+	        " <ext:Info name=\"test\"><ext:Value>some text</ext:Value></ext:Info>\n"
+	        " <Period id=\"p0\" start=\"PT0S\">\n"
+	        "  <AdaptationSet segmentAlignment=\"true\" mimeType=\"video/mp4\" maxWidth=\"1920\" maxHeight=\"1080\" startWithSAP=\"1\">\n"
+	        "   <Role schemeIdUri=\"urn:mpeg:dash:role:2011\" value=\"main\"/>\n"
+	        "   <ContentProtection schemeIdUri=\"urn:mpeg:dash:mp4protection:2011\" value=\"cenc\" ext:kid=\"0123\"><ext:pssh>AAAAAA==</ext:pssh></ContentProtection>\n"
+	        "   <SegmentTemplate timescale=\"90000\" media=\"video_$RepresentationID$_$Time$.m4s\" initialization=\"video_$RepresentationID$_init.mp4\">\n");
+	write_timeline(f, nb_segs, 90000);
+	fprintf(f, "   </SegmentTemplate>\n");
+	for (i=0; i<4; i++) {
+		fprintf(f, "   <Representation id=\"v%d\" bandwidth=\"%d\" width=\"%d\" height=\"%d\" frameRate=\"25\" sar=\"1:1\" codecs=\"avc1.640028\"/>\n", i+1, 500000*(i+1), 480*(i+1), 270*(i+1));
+	}
+	fprintf(f, "  </AdaptationSet>\n"
+	        "  <AdaptationSet segmentAlignment=\"true\" mimeType=\"audio/mp4\" lang=\"en\">\n"
+	        "   <AudioChannelConfiguration schemeIdUri=\"urn:mpeg:dash:23003:3:audio_channel_configuration:2011\" value=\"2\"/>\n"
+	        "   <SegmentTemplate timescale=\"48000\" media=\"audio_$Time$.m4s\" initialization=\"audio_init.mp4\">\n");
+	write_timeline(f, nb_segs, 48000);
+	fprintf(f, "   </SegmentTemplate>\n"
+	        "   <Representation id=\"a1\" bandwidth=\"128000\" audioSamplingRate=\"48000\" codecs=\"mp4a.40.2\"/>\n"
+	        "  </AdaptationSet>\n"
+	        "  <AdaptationSet mimeType=\"video/mp4\" par=\"16:9\">\n"
+	        "   <ContentComponent id=\"1\" contentType=\"video\" par=\"16:9\"/>\n"
+	        "   <ContentComponent id=\"2\" contentType=\"audio\" lang=\"de\">\n"
+	        "    <Role schemeIdUri=\"urn:mpeg:dash:role:2011\" value=\"dub\"/>\n"
+	        "   </ContentComponent>\n"
+	        "   <Representation id=\"m1\" bandwidth=\"800000\" codecs=\"avc1.640028,mp4a.40.2\">\n"
+	        "    <BaseURL>muxed.mp4</BaseURL>\n"
+	        "   </Representation>\n"
+	        "  </AdaptationSet>\n"
+	        "  <AdaptationSet mimeType=\"application/mp4\" lang=\"fr\">\n"
+	        "   <Representation id=\"t1\" bandwidth=\"1000\" codecs=\"wvtt\">\n"
+	        "    <BaseURL>subs/</BaseURL>\n"
+	        "    <SegmentList timescale=\"1000\" duration=\"2000\">\n"
+	        "     <Initialization sourceURL=\"subs_init.mp4\"/>\n");
+	for (i=0; i<100; i++) {
+		fprintf(f, "     <SegmentURL media=\"subs_%d.m4s\" mediaRange=\"%d-%d\"/>\n", i+1, i*1000, i*1000+999);
+	}
+	fprintf(f, "    </SegmentList>\n"
+	        "   </Representation>\n"
+	        "  </AdaptationSet>\n"
+	        " </Period>\n"
+	        "</MPD>\n");
+	gf_fclose(f);
+}
+
+static GF_Err load_dom(const char *name, GF_MPD **out_mpd)
+{
+	GF_Err e;
+	GF_MPD *mpd;
+	GF_DOMParser *dom = gf_xml_dom_new();
+	e = gf_xml_dom_parse(dom, name, NULL, NULL);
+	if (e) {
+		gf_xml_dom_del(dom);
+		return e;
+	}
+	mpd = gf_mpd_new();
+	e = gf_mpd_init_from_dom(gf_xml_dom_get_root(dom), mpd, name);
+	gf_xml_dom_del(dom);
+	if (out_mpd) *out_mpd = mpd;
+	else gf_mpd_del(mpd);
+	return e;
+}
+
+static GF_Err load_sax(const char *name, GF_MPD **out_mpd)
+{
+	GF_Err e;
+	GF_MPD *mpd = gf_mpd_new();
+	e = gf_mpd_init_from_file(name, mpd, name);
+	if (out_mpd) *out_mpd = mpd;
+	else gf_mpd_del(mpd);
+	return e;
+}
+
+static char *dump_mpd(GF_MPD *mpd, const char *name)
+{
+	u32 size;
+	char *data;
+	FILE *f = gf_fopen(name, "w+b");
+	/*namespace prefix is not kept by the loaders*/
+	mpd->xml_namespace = "urn:mpeg:dash:schema:mpd:2011";
+	gf_mpd_write(mpd, f);
+	size = (u32) gf_ftell(f);
+	gf_fseek(f, 0, SEEK_SET);
+	data = gf_malloc(size+1);
+	size = (u32) fread(data, 1, size, f);
+	data[size] = 0;
+	gf_fclose(f);
+	gf_delete_file(name);
+	return data;
+}
+
+/*content components are checked explicitly, they drive the detection of multiplexed sets by the DASH client*/
+static Bool same_string(const char *s1, const char *s2)
+{
+	if (!s1 || !s2) return (s1==s2) ? GF_TRUE : GF_FALSE;
+	return strcmp(s1, s2) ? GF_FALSE : GF_TRUE;
+}
+
+static Bool same_components(GF_MPD *mpd1, GF_MPD *mpd2)
+{
+	u32 i, j, k;
+	if (gf_list_count(mpd1->periods) != gf_list_count(mpd2->periods)) return GF_FALSE;
+	for (i=0; i<gf_list_count(mpd1->periods); i++) {
+		GF_MPD_Period *p1 = gf_list_get(mpd1->periods, i);
+		GF_MPD_Period *p2 = gf_list_get(mpd2->periods, i);
+		if (gf_list_count(p1->adaptation_sets) != gf_list_count(p2->adaptation_sets)) return GF_FALSE;
+		for (j=0; j<gf_list_count(p1->adaptation_sets); j++) {
+			GF_MPD_AdaptationSet *as1 = gf_list_get(p1->adaptation_sets, j);
+			GF_MPD_AdaptationSet *as2 = gf_list_get(p2->adaptation_sets, j);
+			if (gf_list_count(as1->content_component) != gf_list_count(as2->content_component)) return GF_FALSE;
+			for (k=0; k<gf_list_count(as1->content_component); k++) {
+				GF_MPD_ContentComponent *c1 = gf_list_get(as1->content_component, k);
+				GF_MPD_ContentComponent *c2 = gf_list_get(as2->content_component, k);
+				if (c1->id != c2->id) return GF_FALSE;
+				if (!same_string(c1->content_type, c2->content_type) || !same_string(c1->lang, c2->lang)) return GF_FALSE;
+				if (gf_list_count(c1->role) != gf_list_count(c2->role)) return GF_FALSE;
+			}
+		}
+	}
+	return GF_TRUE;
+}
+
+/*timeline of segments [first, last[ with 2s durations every third segment being longer, using repeat counts*/
+static GF_MPD_SegmentTimeline *make_timeline(u32 first, u32 last, u32 run_len)
+{
+	u32 i;
+	u64 t = 0;
+	GF_MPD_SegmentTimelineEntry *ent = NULL;
+	GF_MPD_SegmentTimeline *tl;
+	GF_SAFEALLOC(tl, GF_MPD_SegmentTimeline);
+	tl->entries = gf_list_new();
+	for (i=0; i<last; i++) {
+		u32 d = ((i/run_len) % 2) ? 2001 : 2000;
+		if (i>=first) {
+			if (ent && (ent->duration==d)) {
+				ent->repeat_count++;
+			} else {
+				GF_SAFEALLOC(ent, GF_MPD_SegmentTimelineEntry);
+				ent->duration = d;
+				/*explicit time on first entry only*/
+				if (i==first) ent->start_time = t;
+				gf_list_add(tl->entries, ent);
+			}
+		}
+		t += d;
+	}
+	return tl;
+}
+
+static void del_timeline(GF_MPD_SegmentTimeline *tl)
+{
+	while (gf_list_count(tl->entries)) gf_free(gf_list_pop_back(tl->entries));
+	gf_list_del(tl->entries);
+	gf_free(tl);
+}
+
+/*checks both timelines describe the same segments*/
+static Bool same_segments(GF_MPD_SegmentTimeline *tl1, GF_MPD_SegmentTimeline *tl2)
+{
+	u32 i1=0, i2=0, r1=0, r2=0;
+	u64 t1=0, t2=0;
+	GF_MPD_SegmentTimelineEntry *e1 = gf_list_get(tl1->entries, 0);
+	GF_MPD_SegmentTimelineEntry *e2 = gf_list_get(tl2->entries, 0);
+	if (e1 && e1->start_time) t1 = e1->start_time;
+	if (e2 && e2->start_time) t2 = e2->start_time;
+	while (e1 && e2) {
+		if ((t1 != t2) || (e1->duration != e2->duration)) return GF_FALSE;
+		t1 += e1->duration;
+		t2 += e2->duration;
+		if (r1 < e1->repeat_count) r1++;
+		else {
+			r1 = 0;
+			e1 = gf_list_get(tl1->entries, ++i1);
+			if (e1 && e1->start_time) t1 = e1->start_time;
+		}
+		if (r2 < e2->repeat_count) r2++;
+		else {
+			r2 = 0;
+			e2 = gf_list_get(tl2->entries, ++i2);
+			if (e2 && e2->start_time) t2 = e2->start_time;
+		}
+	}
+	return (!e1 && !e2) ? GF_TRUE : GF_FALSE;
+}
+
+static Bool check_merge(const char *test, u32 old_first, u32 old_last, u32 new_first, u32 new_last, u32 exp_first, u32 run_len, GF_Err exp_err)
+{
+	GF_Err e;
+	u32 nb_new = 0;
+	Bool ok;
+	GF_MPD_SegmentTimeline *tl = make_timeline(old_first, old_last, run_len);
+	GF_MPD_SegmentTimeline *update = make_timeline(new_first, new_last, run_len);
+	GF_MPD_SegmentTimeline *expected = make_timeline(exp_first, exp_err ? old_last : new_last, run_len);
+	u64 start = gf_sys_clock_high_res();
+
+	e = gf_mpd_segment_timeline_merge(tl, update, &nb_new);
+	start = gf_sys_clock_high_res() - start;
+	ok = (e==exp_err) ? GF_TRUE : GF_FALSE;
+	if (ok) ok = same_segments(tl, expected);
+	if (ok && !e && (nb_new != new_last - old_last)) ok = GF_FALSE;
+	fprintf(stdout, "\tmerge %s: %s - %d new segments - %d entries - "LLU" us\n", test, ok ? "OK" : "FAILED", nb_new, gf_list_count(tl->entries), start);
+	del_timeline(tl);
+	del_timeline(update);
+	del_timeline(expected);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, nb_segs=14400, nb_runs=10;
+	u64 dom_time, sax_time, start, size;
+	char *mpd_file = NULL;
+	char *dom_dump, *sax_dump;
+	GF_MPD *dom_mpd, *sax_mpd;
+	FILE *f;
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-segs") && (i+1<(u32) argc)) {
+			nb_segs = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-runs") && (i+1<(u32) argc)) {
+			nb_runs = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-mpd") && (i+1<(u32) argc)) {
+			mpd_file = argv[i+1];
+			i++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_runs) nb_runs = 1;
+	if (nb_segs < 2) nb_segs = 2;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	if (!mpd_file) {
+		mpd_file = "mpdparse_test.mpd";
+		write_mpd(mpd_file, nb_segs);
+	}
+	f = gf_fopen(mpd_file, "rb");
+	if (!f) {
+		fprintf(stderr, "Cannot open %s\n", mpd_file);
+		gf_sys_close();
+		return 1;
+	}
+	gf_fseek(f, 0, SEEK_END);
+	size = gf_ftell(f);
+	gf_fclose(f);
+
+	/*same MPD with both loaders*/
+	dom_mpd = sax_mpd = NULL;
+	e = load_dom(mpd_file, &dom_mpd);
+	if (e) {
+		fprintf(stderr, "DOM loading failed: %s\n", gf_error_to_string(e));
+		ret = 1;
+	}
+	e = load_sax(mpd_file, &sax_mpd);
+	if (e) {
+		fprintf(stderr, "SAX loading failed: %s\n", gf_error_to_string(e));
+		ret = 1;
+	}
+	if (!ret) {
+		dom_dump = dump_mpd(dom_mpd, "mpdparse_dom.mpd");
+		sax_dump = dump_mpd(sax_mpd, "mpdparse_sax.mpd");
+		if (strcmp(dom_dump, sax_dump)) {
+			fprintf(stderr, "SAX and DOM loaded MPDs differ\n");
+			ret = 1;
+		}
+		if (!same_components(dom_mpd, sax_mpd)) {
+			fprintf(stderr, "SAX and DOM loaded MPDs have different content components\n");
+			ret = 1;
+		}
+		fprintf(stdout, "%s: "LLU" bytes - SAX and DOM loaded MPDs %s\n", mpd_file, size, ret ? "DIFFER" : "are identical");
+		gf_free(dom_dump);
+		gf_free(sax_dump);
+	}
+	if (dom_mpd) gf_mpd_del(dom_mpd);
+	if (sax_mpd) gf_mpd_del(sax_mpd);
+
+	if (!ret) {
+		start = gf_sys_clock_high_res();
+		for (i=0; i<nb_runs; i++) load_dom(mpd_file, NULL);
+		dom_time = (gf_sys_clock_high_res() - start) / nb_runs;
+
+		start = gf_sys_clock_high_res();
+		for (i=0; i<nb_runs; i++) load_sax(mpd_file, NULL);
+		sax_time = (gf_sys_clock_high_res() - start) / nb_runs;
+
+		fprintf(stdout, "\tDOM load: "LLU" us - SAX load: "LLU" us - speedup %.2f\n", dom_time, sax_time, sax_time ? ((Double) (s64) dom_time) / (s64) sax_time : 0);
+	}
+
+	/*sliding window update: 2 segments removed, 3 segments added*/
+	if (!check_merge("sliding window", 0, nb_segs, 2, nb_segs+3, 2, 7, GF_OK)) ret = 1;
+	/*first segments already purged by the client are not restored*/
+	if (!check_merge("purged timeline", nb_segs/2, nb_segs, 2, nb_segs+3, MAX(nb_segs/2, 2), 7, GF_OK)) ret = 1;
+	/*last entry of the timeline is extended by the update*/
+	if (!check_merge("extended entry", 0, 10, 0, 13, 0, 1000, GF_OK)) ret = 1;
+	/*update older than the timeline*/
+	if (!check_merge("older update", 0, 100, 0, 90, 0, 7, GF_NOT_SUPPORTED)) ret = 1;
+	/*update not contiguous with the timeline*/
+	if (!check_merge("timeline gap", 0, 100, 200, 300, 0, 7, GF_NOT_SUPPORTED)) ret = 1;
+
+	if (!strcmp(mpd_file, "mpdparse_test.mpd")) gf_delete_file(mpd_file);
+	gf_sys_close();
+	return ret;
+}
@@ -1,10 +1,51 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: Jean Le Feuvre
+ *			Copyright (c) Telecom ParisTech 2019
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - MPEG-2 TS demux test
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
 #include <gpac/mpegts.h>
 
-u32 dump_pid = 130;
-FILE *dest = NULL;
-Bool has_seen_pat = 0;
+static void usage()
+{
+	fprintf(stderr, "usage: mpeg2ts [options] [file.ts]\n"
+	        "\n"
+	        "With a file, dumps the PES payload of a PID to pes.mp3.\n"
+	        "Without a file, generates a multi-program transport stream and compares the demux speed of all programs,\n"
+	        "of a single PID without PID filtering and of a single PID with PID filtering, to the memory read speed.\n"
+	        "The single PID extraction is also checked on a stream with lost bytes.\n"
+	        "\n"
+	        "-pid N: PID to dump (default 130)\n"
+	        "-progs N: number of programs in the generated stream, up to 40 (default 20)\n"
+	        "-size N: generated stream size in MB (default 256)\n"
+	       );
+}
 
-void on_m2ts_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
+static u32 dump_pid = 130;
+static FILE *dest = NULL;
+static Bool has_seen_pat = 0;
+
+static void on_m2ts_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
 {
 	GF_M2TS_PES_PCK *pck;
 	switch (evt_type) {
@@ -40,13 +81,17 @@ void on_m2ts_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
 	}
 }
 
-int main(int argc, char **argv)
+static int dump_file(const char *file)
 {
 	char data[188];
 	u32 size, fsize, fdone;
 	GF_M2TS_Demuxer *ts;
 
-	FILE *src = gf_fopen(argv[1], "rb");
+	FILE *src = gf_fopen(file, "rb");
+	if (!src) {
+		fprintf(stderr, "Cannot open %s\n", file);
+		return 1;
+	}
 	ts = gf_m2ts_demux_new();
 	ts->on_event = on_m2ts_event;
 
@@ -84,5 +129,315 @@ int main(int argc, char **argv)
 	return 0;
 }
 
+/*generated stream: program i has its PMT on PID 0x100+i, video (carrying the PCR) on 0x200+2i and audio on 0x201+2i*/
+#define PMT_PID(_i)		(0x100 + (_i))
+#define VIDEO_PID(_i)	(0x200 + 2*(_i))
+
+typedef struct
+{
+	u32 pid;
+	u8 cc;
+	u32 pes_size, pes_pos, nb_pes;
+	u64 pts;
+} GenStream;
+
+static void write_section(u8 *pck, u32 pid, u8 *cc, u8 *section, u32 len)
+{
+	u32 crc = gf_crc_32((char *) section, len);
+	section[len] = (crc>>24) & 0xFF;
+	section[len+1] = (crc>>16) & 0xFF;
+	section[len+2] = (crc>>8) & 0xFF;
+	section[len+3] = crc & 0xFF;
+	pck[0] = 0x47;
+	pck[1] = 0x40 | ((pid>>8) & 0x1F);
+	pck[2] = pid & 0xFF;
+	pck[3] = 0x10 | *cc;
+	pck[4] = 0;
+	memcpy(pck+5, section, len+4);
+	memset(pck+5+len+4, 0xFF, 188-5-len-4);
+	*cc = (*cc+1) & 0xF;
+}
+
+/*writes PAT and PMTs, returns the number of packets written*/
+static u32 write_tables(u8 *data, u32 nb_progs, u8 *ccs)
+{
+	u8 section[184];
+	u32 i, len;
+	section[0] = 0x00;
+	section[3] = 0x00;
+	section[4] = 0x01;
+	section[5] = 0xC1;
+	section[6] = section[7] = 0;
+	len = 8;
+	for (i=0; i<nb_progs; i++) {
+		section[len++] = ((i+1)>>8) & 0xFF;
+		section[len++] = (i+1) & 0xFF;
+		section[len++] = 0xE0 | (PMT_PID(i)>>8);
+		section[len++] = PMT_PID(i) & 0xFF;
+	}
+	section[1] = 0xB0 | (((len+1)>>8) & 0xF);
+	section[2] = (len+1) & 0xFF;
+	write_section(data, 0, &ccs[0], section, len);
+
+	for (i=0; i<nb_progs; i++) {
+		u32 pid = VIDEO_PID(i);
+		u8 pmt[] = {0x02, 0xB0, 23, 0x00, i+1, 0xC1, 0x00, 0x00, 0xE0 | (pid>>8), pid & 0xFF, 0xF0, 0x00,
+		            GF_M2TS_VIDEO_H264, 0xE0 | (pid>>8), pid & 0xFF, 0xF0, 0x00,
+		            GF_M2TS_AUDIO_AAC, 0xE0 | ((pid+1)>>8), (pid+1) & 0xFF, 0xF0, 0x00, 0, 0, 0, 0
+		           };
+		write_section(data + 188*(i+1), PMT_PID(i), &ccs[i+1], pmt, sizeof(pmt)-4);
+	}
+	return nb_progs+1;
+}
+
+static void write_pts(u8 *p, u64 pts)
+{
+	p[0] = 0x21 | (u8) (((pts>>30) & 0x7)<<1);
+	p[1] = (u8) (pts>>22);
+	p[2] = (u8) (((pts>>15) & 0x7F)<<1) | 1;
+	p[3] = (u8) (pts>>7);
+	p[4] = (u8) ((pts & 0x7F)<<1) | 1;
+}
+
+/*writes the next packet of a stream, with a PCR in the first packet of video PES*/
+static void write_pes_pck(u8 *pck, GenStream *st, Bool is_video)
+{
+	u32 hdr = 4, size;
+	Bool pusi = st->pes_pos ? GF_FALSE : GF_TRUE;
+	if (pusi) {
+		st->pes_size = is_video ? 5000 + gf_rand() % 35000 : 500 + gf_rand() % 1000;
+		st->pts += is_video ? 3600 : 1920;
+	}
+	pck[0] = 0x47;
+	pck[1] = (pusi ? 0x40 : 0) | ((st->pid>>8) & 0x1F);
+	pck[2] = st->pid & 0xFF;
+	size = MIN(184, st->pes_size - st->pes_pos);
+	if (pusi && is_video) size = MIN(size, 176);
+	if (size<184) {
+		u32 af_len = 183 - size;
+		pck[3] = 0x30 | st->cc;
+		pck[4] = af_len;
+		if (af_len) {
+			pck[5] = 0;
+			memset(pck+6, 0xFF, af_len-1);
+			if (pusi && is_video) {
+				u64 pcr = st->pts * 300;
+				pck[5] = 0x50;
+				pck[6] = (u8) ((pcr/300) >> 25);
+				pck[7] = (u8) ((pcr/300) >> 17);
+				pck[8] = (u8) ((pcr/300) >> 9);
+				pck[9] = (u8) ((pcr/300) >> 1);
+				pck[10] = (u8) ((((pcr/300) & 1) << 7) | 0x7E);
+				pck[11] = 0;
+			}
+		}
+		hdr += 1 + af_len;
+	} else {
+		pck[3] = 0x10 | st->cc;
+	}
+	memset(pck+hdr, 0xAB, size);
+	if (pusi) {
+		u32 len = is_video ? 0 : st->pes_size - 6;
+		pck[hdr] = pck[hdr+1] = 0;
+		pck[hdr+2] = 1;
+		pck[hdr+3] = is_video ? 0xE0 : 0xC0;
+		pck[hdr+4] = (len>>8) & 0xFF;
+		pck[hdr+5] = len & 0xFF;
+		pck[hdr+6] = 0x80;
+		pck[hdr+7] = 0x80;
+		pck[hdr+8] = 5;
+		write_pts(pck+hdr+9, st->pts);
+	}
+	st->cc = (st->cc+1) & 0xF;
+	st->pes_pos += size;
+	if (st->pes_pos == st->pes_size) {
+		st->pes_pos = 0;
+		st->nb_pes++;
+	}
+}
+
+static u32 nb_pes, nb_bytes, target_pid;
+static Bool all_pids;
+
+static void on_bench_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
+{
+	u32 i;
+	if (evt_type == GF_M2TS_EVT_PMT_FOUND) {
+		GF_M2TS_Program *prog = (GF_M2TS_Program *)par;
+		for (i=0; i<gf_list_count(prog->streams); i++) {
+			GF_M2TS_ES *es = (GF_M2TS_ES *)gf_list_get(prog->streams, i);
+			if ((es->pid == prog->pmt_pid) || !(es->flags & GF_M2TS_ES_IS_PES)) continue;
+			if (all_pids || (es->pid == target_pid))
+				gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_RAW);
+		}
+	}
+	else if (evt_type == GF_M2TS_EVT_PES_PCK) {
+		GF_M2TS_PES_PCK *pck = (GF_M2TS_PES_PCK *)par;
+		if (pck->stream->pid == target_pid) {
+			nb_pes++;
+			nb_bytes += pck->data_len;
+		}
+	}
+}
+
+/*returns demux time in us*/
+static u64 bench_demux(u8 *data, u32 size, Bool all, Bool filter)
+{
+	u32 pos = 0;
+	u64 start;
+	GF_M2TS_Demuxer *ts = gf_m2ts_demux_new();
+	ts->on_event = on_bench_event;
+	all_pids = all;
+	nb_pes = nb_bytes = 0;
+	if (filter) gf_m2ts_set_pid_interest(ts, target_pid, GF_TRUE);
+
+	start = gf_sys_clock_high_res();
+	while (pos < size) {
+		u32 len = MIN(188*348, size - pos);
+		gf_m2ts_process_data(ts, (char *) data + pos, len);
+		pos += len;
+	}
+	start = gf_sys_clock_high_res() - start;
+	gf_m2ts_demux_del(ts);
+	return start ? start : 1;
+}
+
+static int run_bench(u32 nb_progs, u32 size_mb)
+{
+	u32 i, nb_pck, nb_written, target_pes;
+	u8 *data, ccs[41];
+	GenStream *streams;
+	u64 t_full, t_pid, t_filter, t_mem, sum;
+	u64 *words;
+	u32 nb_pes_pid, nb_bytes_pid;
+	Double mb;
+	int ret = 0;
+
+	if (nb_progs > 40) nb_progs = 40;
+	nb_pck = (u32) ( ((u64) size_mb * 1024 * 1024) / 188);
+	if (nb_pck < 4*(nb_progs+1)) nb_pck = 4*(nb_progs+1);
+	data = gf_malloc(188 * nb_pck);
+	streams = gf_malloc(sizeof(GenStream) * 2 * nb_progs);
+	memset(streams, 0, sizeof(GenStream) * 2 * nb_progs);
+	memset(ccs, 0, sizeof(ccs));
+	for (i=0; i<2*nb_progs; i++) {
+		streams[i].pid = VIDEO_PID(0) + i;
+		streams[i].pts = 90000;
+	}
+	target_pid = VIDEO_PID(0);
+
+	/*one audio packet every 8 packets*/
+	nb_written = 0;
+	while (nb_written < nb_pck) {
+		if ((nb_written % 4000 == 0) && (nb_written + nb_progs + 1 <= nb_pck)) {
+			nb_written += write_tables(data + 188*nb_written, nb_progs, ccs);
+			continue;
+		}
+		i = gf_rand() % nb_progs;
+		if (gf_rand() % 8 == 0) {
+			write_pes_pck(data + 188*nb_written, &streams[2*i+1], GF_FALSE);
+		} else {
+			write_pes_pck(data + 188*nb_written, &streams[2*i], GF_TRUE);
+		}
+		nb_written++;
+	}
+	/*video PES have no length and are dispatched when the next one starts*/
+	target_pes = streams[0].nb_pes + (streams[0].pes_pos ? 1 : 0) - 1;
+	mb = ((Double) nb_pck) * 188 / 1024 / 1024;
+	fprintf(stdout, "Generated %.2f MB - %d programs - PID %d has %d complete PES\n", mb, nb_progs, target_pid, target_pes);
+
+	/*memory read reference*/
+	words = (u64 *) data;
+	sum = 0;
+	t_mem = gf_sys_clock_high_res();
+	for (i=0; i<nb_pck*188/8; i++) sum += words[i];
+	t_mem = gf_sys_clock_high_res() - t_mem;
+	if (!t_mem) t_mem = 1;
+	fprintf(stdout, "\tmemory read: %.2f MB/s (checksum "LLU")\n", mb * 1000000 / t_mem, sum);
+
+	t_full = bench_demux(data, nb_pck*188, GF_TRUE, GF_FALSE);
+	fprintf(stdout, "\tall PIDs reassembled: %.2f MB/s\n", mb * 1000000 / t_full);
+
+	t_pid = bench_demux(data, nb_pck*188, GF_FALSE, GF_FALSE);
+	nb_pes_pid = nb_pes;
+	nb_bytes_pid = nb_bytes;
+	fprintf(stdout, "\tsingle PID, no PID filter: %.2f MB/s - %d PES %d bytes\n", mb * 1000000 / t_pid, nb_pes, nb_bytes);
 
+	t_filter = bench_demux(data, nb_pck*188, GF_FALSE, GF_TRUE);
+	fprintf(stdout, "\tsingle PID, PID filter: %.2f MB/s - %d PES %d bytes - %.2f times faster\n", mb * 1000000 / t_filter, nb_pes, nb_bytes, ((Double) t_pid) / t_filter);
 
+	if ((nb_pes != nb_pes_pid) || (nb_bytes != nb_bytes_pid) || (nb_pes != target_pes)) {
+		fprintf(stdout, "PID filtering: FAILED - %d/%d PES\n", nb_pes, target_pes);
+		ret = 1;
+	} else {
+		fprintf(stdout, "PID filtering: OK\n");
+	}
+
+	/*remove one byte every 1000 packets, each loss should at most cost the current and next PES of the PID*/
+	{
+		u32 nb_lost = 0, dst = 0;
+		for (i=0; i<nb_pck; i++) {
+			if (i && (i % 1000 == 0)) {
+				memmove(data + dst, data + 188*i + 1, 187);
+				dst += 187;
+				nb_lost++;
+			} else {
+				memmove(data + dst, data + 188*i, 188);
+				dst += 188;
+			}
+		}
+		bench_demux(data, dst, GF_FALSE, GF_TRUE);
+		if (nb_pes + 2*nb_lost < target_pes) {
+			fprintf(stdout, "Resync after %d byte losses: FAILED - %d/%d PES\n", nb_lost, nb_pes, target_pes);
+			ret = 1;
+		} else {
+			fprintf(stdout, "Resync after %d byte losses: OK - %d/%d PES\n", nb_lost, nb_pes, target_pes);
+		}
+	}
+
+	gf_free(streams);
+	gf_free(data);
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_progs=20, size_mb=256;
+	char *file = NULL;
+	int ret;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-pid") && (i+1<(u32) argc)) {
+			dump_pid = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-progs") && (i+1<(u32) argc)) {
+			nb_progs = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			size_mb = atoi(argv[i+1]);
+			i++;
+		} else if (arg[0] != '-') {
+			file = arg;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_progs) nb_progs = 1;
+	if (!size_mb) size_mb = 1;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+	gf_rand_init(GF_TRUE);
+
+	if (file) {
+		ret = dump_file(file);
+	} else {
+		/*sync losses are expected in the benchmark*/
+		gf_log_set_tool_level(GF_LOG_CONTAINER, GF_LOG_QUIET);
+		ret = run_bench(nb_progs, size_mb);
+	}
+	gf_sys_close();
+	return ret;
+}
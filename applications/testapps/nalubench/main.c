@@ -0,0 +1,327 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - NAL unit start code scanning benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/bitstream.h>
+#include <gpac/internal/media_dev.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: nalubench [options] [file]\n"
+	        "\n"
+	        "Scans an Annex-B AVC/HEVC file for start codes and removes emulation prevention bytes, with the previous\n"
+	        "byte by byte code and with each NAL scanning implementation, checks the results are identical and reports GB/s.\n"
+	        "The file is processed by blocks and can be larger than the available memory.\n"
+	        "If no file is given, a pseudo-random Annex-B like buffer is used.\n"
+	        "\n"
+	        "-size N: size in MB of the generated buffer (default 256)\n"
+	        "-block N: size in MB of the blocks read from the file (default 64)\n"
+	        "-loops N: number of passes over the generated buffer (default 4)\n"
+	       );
+}
+
+/*previous scanning code, used as reference*/
+static u32 ref_next_start_code(const u8 *data, u32 data_len, u32 *sc_size)
+{
+	u32 v = 0xffffffff, bpos = 0;
+	while (bpos < data_len) {
+		v = ( (v<<8) & 0xFFFFFF00) | ((u32) data[bpos]);
+		bpos++;
+		if (v == 0x00000001) {
+			*sc_size = 4;
+			return bpos-4;
+		}
+		else if ( (v & 0x00FFFFFF) == 0x00000001) {
+			*sc_size = 3;
+			return bpos-3;
+		}
+	}
+	return data_len;
+}
+
+static u32 ref_remove_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size)
+{
+	u32 i = 0, emulation_bytes_count = 0;
+	u8 num_zero = 0;
+
+	while (i < nal_size) {
+		if ((num_zero == 2) && (buffer_src[i] == 0x03) && (i+1 < nal_size) && (buffer_src[i+1] < 0x04)) {
+			num_zero = 0;
+			emulation_bytes_count++;
+			i++;
+		}
+		buffer_dst[i-emulation_bytes_count] = buffer_src[i];
+		if (!buffer_src[i]) num_zero++;
+		else num_zero = 0;
+		i++;
+	}
+	return nal_size-emulation_bytes_count;
+}
+
+static u32 ref_locate_start_code_bs(GF_BitStream *bs, Bool locate_trailing)
+{
+	u32 v = 0xffffffff, nb_cons_zeros = 0;
+	u64 end = 0;
+	u64 start = gf_bs_get_position(bs);
+	if (start<3) return 0;
+
+	while (!end && gf_bs_available(bs)) {
+		v = ( (v<<8) & 0xFFFFFF00) | ((u32) gf_bs_read_u8(bs));
+		if (locate_trailing) {
+			if ( (v & 0x000000FF) == 0) nb_cons_zeros++;
+			else nb_cons_zeros = 0;
+		}
+		if (v == 0x00000001) end = gf_bs_get_position(bs)-4;
+		else if ( (v & 0x00FFFFFF) == 0x00000001) end = gf_bs_get_position(bs)-3;
+	}
+	gf_bs_seek(bs, start);
+	if (!end) end = gf_bs_get_size(bs);
+	if (locate_trailing && (nb_cons_zeros>=3))
+		return (u32) (end - start - nb_cons_zeros);
+	return (u32) (end-start);
+}
+
+/*random NAL units with 3 and 4 bytes start codes, emulation prevention bytes and trailing zeros. With dense set,
+one byte out of 4 is zero to stress the scanners*/
+static void generate_buffer(u8 *data, u32 size, Bool dense)
+{
+	u32 pos = 0;
+	while (pos < size) {
+		u32 i, nal_size = 100 + gf_rand() % (dense ? 200 : 20000);
+		if (pos + nal_size + 4 > size) nal_size = size - pos;
+		for (i=0; i<nal_size; i++) {
+			u32 r = gf_rand();
+			if (dense && !(r & 3)) data[pos+i] = 0;
+			else data[pos+i] = (u8) (r >> 8);
+		}
+		/*start code*/
+		if (nal_size > 8) {
+			i = 0;
+			if (gf_rand() & 1) data[pos + i++] = 0;
+			data[pos + i++] = 0;
+			data[pos + i++] = 0;
+			data[pos + i++] = 1;
+		}
+		/*emulation prevention byte and trailing zeros*/
+		if (nal_size > 64) {
+			i = 16 + gf_rand() % (nal_size - 32);
+			data[pos+i] = 0;
+			data[pos+i+1] = 0;
+			data[pos+i+2] = 3;
+			data[pos+i+3] = gf_rand() % 5;
+			if (!(gf_rand() % 4)) memset(data + pos + nal_size - 8, 0, 8);
+		}
+		pos += nal_size;
+	}
+}
+
+static u32 nb_modes;
+static u32 modes[3];
+static const char *mode_names[] = {"scalar", "SSE2", "AVX2"};
+
+/*scans the block with the reference code and each mode, returns GF_FALSE on mismatch*/
+static Bool process_block(const u8 *data, u32 size, u8 *dst, u8 *dst_ref, u64 *sc_times, u64 *emul_times, u64 *nb_codes, Bool check_bs)
+{
+	u32 i, m, pos, sc_size, nb_ref, out_size, out_ref;
+	u64 start;
+	u32 checksum_ref = 0;
+
+	/*reference*/
+	pos = 0;
+	nb_ref = 0;
+	start = gf_sys_clock_high_res();
+	while (1) {
+		u32 sc = ref_next_start_code(data + pos, size - pos, &sc_size);
+		if (pos + sc == size) break;
+		checksum_ref += (pos + sc) * sc_size;
+		nb_ref++;
+		pos += sc + sc_size;
+	}
+	sc_times[0] += gf_sys_clock_high_res() - start;
+	start = gf_sys_clock_high_res();
+	out_ref = ref_remove_emulation_bytes(data, dst_ref, size);
+	emul_times[0] += gf_sys_clock_high_res() - start;
+	*nb_codes += nb_ref;
+
+	for (m=0; m<nb_modes; m++) {
+		u32 nb = 0, checksum = 0;
+		gf_media_nalu_set_simd(modes[m]);
+
+		pos = 0;
+		start = gf_sys_clock_high_res();
+		while (1) {
+			u32 sc = gf_media_nalu_next_start_code(data + pos, size - pos, &sc_size);
+			if (pos + sc == size) break;
+			checksum += (pos + sc) * sc_size;
+			nb++;
+			pos += sc + sc_size;
+		}
+		sc_times[m+1] += gf_sys_clock_high_res() - start;
+		if ((nb != nb_ref) || (checksum != checksum_ref)) {
+			fprintf(stderr, "Error: %s start codes differ from reference (%d vs %d)\n", mode_names[modes[m]], nb, nb_ref);
+			return GF_FALSE;
+		}
+
+		start = gf_sys_clock_high_res();
+		out_size = gf_media_nalu_remove_emulation_bytes((const char *) data, (char *) dst, size);
+		emul_times[m+1] += gf_sys_clock_high_res() - start;
+		if ((out_size != out_ref) || memcmp(dst, dst_ref, out_size)) {
+			fprintf(stderr, "Error: %s emulation prevention byte removal differs from reference\n", mode_names[modes[m]]);
+			return GF_FALSE;
+		}
+
+		/*bitstream based locators, from every start code*/
+		if (check_bs) {
+			GF_BitStream *bs = gf_bs_new((const char *) data, size, GF_BITSTREAM_READ);
+			pos = 0;
+			while (1) {
+				u32 sc = gf_media_nalu_next_start_code(data + pos, size - pos, &sc_size);
+				if (pos + sc == size) break;
+				pos += sc + sc_size;
+				for (i=0; i<2; i++) {
+					u32 res, res_ref;
+					gf_bs_seek(bs, pos);
+					res_ref = ref_locate_start_code_bs(bs, i);
+					res = i ? gf_media_nalu_payload_end_bs(bs) : gf_media_nalu_next_start_code_bs(bs);
+					if ((res != res_ref) || (gf_bs_get_position(bs) != pos)) {
+						fprintf(stderr, "Error: %s bitstream start code location differs from reference at "LLU" (%s %d vs %d)\n", mode_names[modes[m]], (u64) pos, i ? "payload end" : "next start code", res, res_ref);
+						gf_bs_del(bs);
+						return GF_FALSE;
+					}
+				}
+			}
+			gf_bs_del(bs);
+		}
+	}
+	return GF_TRUE;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, size=256, block=64, nb_loops=4;
+	u64 total, nb_codes, sc_times[4], emul_times[4];
+	const char *file_name = NULL;
+	u8 *data, *dst, *dst_ref;
+	Bool ok = GF_TRUE;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			size = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-block") && (i+1<(u32) argc)) {
+			block = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-loops") && (i+1<(u32) argc)) {
+			nb_loops = atoi(argv[i+1]);
+			i++;
+		} else if ((arg[0]=='-') || file_name) {
+			usage();
+			return 1;
+		} else {
+			file_name = arg;
+		}
+	}
+	if (!size) size = 1;
+	if (!block) block = 1;
+	if (!nb_loops) nb_loops = 1;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	/*list available modes*/
+	nb_modes = 0;
+	modes[nb_modes++] = GF_NALU_SIMD_NONE;
+	if (gf_media_nalu_set_simd(GF_NALU_SIMD_SSE2) == GF_NALU_SIMD_SSE2) modes[nb_modes++] = GF_NALU_SIMD_SSE2;
+	if (gf_media_nalu_set_simd(GF_NALU_SIMD_AVX2) == GF_NALU_SIMD_AVX2) modes[nb_modes++] = GF_NALU_SIMD_AVX2;
+
+	if (!file_name) block = size;
+	block *= 1024*1024;
+	data = gf_malloc(block);
+	dst = gf_malloc(block);
+	dst_ref = gf_malloc(block);
+	if (!data || !dst || !dst_ref) {
+		fprintf(stderr, "Cannot allocate %d bytes\n", block);
+		gf_sys_close();
+		return 1;
+	}
+	memset(sc_times, 0, sizeof(sc_times));
+	memset(emul_times, 0, sizeof(emul_times));
+	total = nb_codes = 0;
+
+	/*correctness first, with zero bytes dense enough to hit every corner case*/
+	gf_rand_init(GF_TRUE);
+	generate_buffer(data, 1024*1024, GF_TRUE);
+	ok = process_block(data, 1024*1024, dst, dst_ref, sc_times, emul_times, &nb_codes, GF_TRUE);
+	for (i=1; ok && (i<64); i++) {
+		/*short buffers exercise the scalar tails of the vector code*/
+		generate_buffer(data, i, GF_TRUE);
+		ok = process_block(data, i, dst, dst_ref, sc_times, emul_times, &nb_codes, GF_TRUE);
+	}
+	memset(sc_times, 0, sizeof(sc_times));
+	memset(emul_times, 0, sizeof(emul_times));
+	nb_codes = 0;
+
+	if (ok && file_name) {
+		FILE *f = gf_fopen(file_name, "rb");
+		if (!f) {
+			fprintf(stderr, "Cannot open %s\n", file_name);
+			ok = GF_FALSE;
+		} else {
+			Bool first = GF_TRUE;
+			while (ok) {
+				u32 read = (u32) fread(data, 1, block, f);
+				if (!read) break;
+				ok = process_block(data, read, dst, dst_ref, sc_times, emul_times, &nb_codes, first);
+				first = GF_FALSE;
+				total += read;
+			}
+			gf_fclose(f);
+		}
+	} else if (ok) {
+		generate_buffer(data, block, GF_FALSE);
+		for (i=0; ok && (i<nb_loops); i++) {
+			ok = process_block(data, block, dst, dst_ref, sc_times, emul_times, &nb_codes, !i);
+			total += block;
+		}
+	}
+
+	if (ok) {
+		fprintf(stdout, "%s: "LLU" bytes - "LLU" start codes\n", file_name ? file_name : "generated buffer", total, nb_codes);
+		for (i=0; i<=nb_modes; i++) {
+			const char *name = i ? mode_names[modes[i-1]] : "reference";
+			if (!sc_times[i]) sc_times[i] = 1;
+			if (!emul_times[i]) emul_times[i] = 1;
+			fprintf(stdout, "\t%s:\tstart codes %.2f GB/s - emulation bytes removal %.2f GB/s\n", name, ((Double) total) / sc_times[i] / 1000, ((Double) total) / emul_times[i] / 1000);
+		}
+	}
+
+	gf_free(data);
+	gf_free(dst);
+	gf_free(dst_ref);
+	gf_media_nalu_set_simd(GF_NALU_SIMD_AUTO);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
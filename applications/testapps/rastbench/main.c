@@ -0,0 +1,378 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - 2D software rasterizer test and benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/color.h>
+#include "rast_soft.h"
+
+GF_Raster2D *EVG_LoadRenderer();
+void EVG_ShutdownRenderer(GF_Raster2D *dr);
+
+static void usage()
+{
+	fprintf(stderr, "usage: rastbench [options]\n"
+	        "\n"
+	        "Checks that all SIMD span kernels of the software rasterizer give the same pixels as the scalar code, then measures their throughput.\n"
+	        "\n"
+	        "-size WxH: benchmark surface size (default 1280x720)\n"
+	        "-frames N: number of frames drawn per format, fill and kernel (default 20)\n"
+	        "-check: only run the conformance check\n"
+	       );
+}
+
+static struct
+{
+	u32 pixel_format;
+	const char *name;
+	u32 bpp;
+} formats[] = {
+	{GF_PIXEL_ARGB, "ARGB", 4},
+	{GF_PIXEL_RGBA, "RGBA", 4},
+	{GF_PIXEL_RGB_32, "RGB32", 4},
+	{GF_PIXEL_BGR_32, "BGR32", 4},
+	{GF_PIXEL_RGB_24, "RGB24", 3},
+	{GF_PIXEL_BGR_24, "BGR24", 3},
+	{GF_PIXEL_RGB_565, "RGB565", 2},
+};
+
+enum
+{
+	FILL_SOLID = 0,
+	FILL_SOLID_ALPHA,
+	FILL_LINEAR,
+	FILL_LINEAR_ALPHA,
+	FILL_RADIAL,
+	FILL_TEXTURE,
+	FILL_TEXTURE_ALPHA,
+	FILL_TEXTURE_STRAIGHT,
+	FILL_TEXTURE_CMAT,
+	FILL_LAST
+};
+
+static const char *fill_names[] = {"solid", "solid alpha", "linear", "linear alpha", "radial", "texture", "texture alpha", "texture straight", "texture cmat"};
+
+static struct
+{
+	u32 pixel_format;
+	u32 bpp;
+} tx_formats[] = {
+	{GF_PIXEL_ARGB, 4},
+	{GF_PIXEL_RGBA, 4},
+	{GF_PIXEL_RGB_32, 4},
+	{GF_PIXEL_RGB_24, 3},
+};
+
+static const char *simd_names[] = {"scalar", "SSE2", "AVX2"};
+
+#define TX_SIZE	37
+
+typedef struct
+{
+	GF_Raster2D *dr;
+	GF_SURFACE surf;
+	GF_Path *path;
+	GF_STENCIL solid, linear, radial, texture;
+	u8 *tx_data;
+} Scene;
+
+/*anti-aliased shapes covering most of the surface, with a hole and partial coverage on all edges*/
+static GF_Path *make_path(u32 width, u32 height)
+{
+	Fixed w = INT2FIX(width);
+	Fixed h = INT2FIX(height);
+	GF_Path *path = gf_path_new();
+	gf_path_add_ellipse(path, w/2, h/2, w*9/10, h*9/10);
+	gf_path_add_rect_center(path, w/2, h/2, w/3 + FIX_ONE/3, h/3 + FIX_ONE/3);
+	gf_path_add_move_to(path, FIX_ONE/2, FIX_ONE/4);
+	gf_path_add_line_to(path, w/3, FIX_ONE/5);
+	gf_path_add_line_to(path, w/7, h - FIX_ONE/3);
+	gf_path_close(path);
+	gf_path_add_move_to(path, w - FIX_ONE/3, h/5);
+	gf_path_add_line_to(path, w*2/3, h - FIX_ONE/7);
+	gf_path_add_line_to(path, w - w/9, h - FIX_ONE);
+	gf_path_close(path);
+	return path;
+}
+
+static void setup_scene(Scene *sc, u32 width, u32 height, u32 tx_idx)
+{
+	u32 i, stride;
+	Fixed pos[4];
+	GF_Color cols[4];
+	GF_Raster2D *dr = sc->dr;
+
+	sc->surf = dr->surface_new(dr, GF_FALSE);
+	dr->surface_set_raster_level(sc->surf, GF_RASTER_HIGH_SPEED);
+	sc->path = make_path(width, height);
+
+	sc->solid = dr->stencil_new(dr, GF_STENCIL_SOLID);
+
+	pos[0] = 0;
+	pos[1] = FIX_ONE/3;
+	pos[2] = FIX_ONE*3/4;
+	pos[3] = FIX_ONE;
+	cols[0] = 0xFFFF0000;
+	cols[1] = 0x8000FF20;
+	cols[2] = 0xFF1020FF;
+	cols[3] = 0x40FFFFFF;
+	sc->linear = dr->stencil_new(dr, GF_STENCIL_LINEAR_GRADIENT);
+	dr->stencil_set_linear_gradient(sc->linear, INT2FIX(width)/5, INT2FIX(height)/7, INT2FIX(width)/2, INT2FIX(height)*2/3);
+	dr->stencil_set_gradient_interpolation(sc->linear, pos, cols, 4);
+
+	sc->radial = dr->stencil_new(dr, GF_STENCIL_RADIAL_GRADIENT);
+	dr->stencil_set_radial_gradient(sc->radial, INT2FIX(width)/2, INT2FIX(height)/2, INT2FIX(width)*2/5, INT2FIX(height)/3, INT2FIX(width)/3, INT2FIX(height)/4);
+	dr->stencil_set_gradient_interpolation(sc->radial, pos, cols, 4);
+
+	/*random texture with all alpha levels, odd size to exercise wrapping*/
+	stride = TX_SIZE * tx_formats[tx_idx].bpp + 3;
+	sc->tx_data = (u8 *) gf_malloc(stride * TX_SIZE);
+	for (i=0; i<stride * TX_SIZE; i++) sc->tx_data[i] = gf_rand() & 0xFF;
+	sc->texture = dr->stencil_new(dr, GF_STENCIL_TEXTURE);
+	dr->stencil_set_texture(sc->texture, (char *) sc->tx_data, TX_SIZE, TX_SIZE, stride, tx_formats[tx_idx].pixel_format, GF_PIXEL_ARGB, GF_TRUE);
+}
+
+static void delete_scene(Scene *sc)
+{
+	GF_Raster2D *dr = sc->dr;
+	dr->stencil_delete(sc->solid);
+	dr->stencil_delete(sc->linear);
+	dr->stencil_delete(sc->radial);
+	dr->stencil_delete(sc->texture);
+	dr->surface_delete(sc->surf);
+	gf_path_del(sc->path);
+	gf_free(sc->tx_data);
+}
+
+/*configures stencils for the given fill, variant selects gradient and tiling modes*/
+static GF_STENCIL setup_fill(Scene *sc, u32 fill, u32 variant)
+{
+	GF_Matrix2D mx;
+	GF_ColorMatrix cmat;
+	GF_Raster2D *dr = sc->dr;
+
+	switch (fill) {
+	case FILL_SOLID:
+		dr->stencil_set_brush_color(sc->solid, 0xFF20A0E0);
+		return sc->solid;
+	case FILL_SOLID_ALPHA:
+		dr->stencil_set_brush_color(sc->solid, 0x9A20A0E0);
+		return sc->solid;
+	case FILL_LINEAR:
+	case FILL_LINEAR_ALPHA:
+		dr->stencil_set_gradient_mode(sc->linear, (GF_GradientMode) (variant % 3));
+		dr->stencil_set_alpha(sc->linear, (fill==FILL_LINEAR_ALPHA) ? 0xA0 : 0xFF);
+		return sc->linear;
+	case FILL_RADIAL:
+		dr->stencil_set_gradient_mode(sc->radial, (GF_GradientMode) (variant % 3));
+		dr->stencil_set_alpha(sc->radial, (variant & 4) ? 0xC0 : 0xFF);
+		return sc->radial;
+	default:
+		break;
+	}
+
+	gf_mx2d_init(mx);
+	if (fill != FILL_TEXTURE_STRAIGHT) {
+		gf_mx2d_add_rotation(&mx, INT2FIX(TX_SIZE)/2, INT2FIX(TX_SIZE)/2, GF_PI/7);
+		gf_mx2d_add_scale(&mx, FIX_ONE*3/10, FIX_ONE/4);
+	} else {
+		gf_mx2d_add_scale(&mx, FIX_ONE/5, FIX_ONE/5);
+		gf_mx2d_add_translation(&mx, -FIX_ONE*7/3, FIX_ONE/3);
+	}
+	dr->stencil_set_matrix(sc->texture, &mx);
+	dr->stencil_set_tiling(sc->texture, (variant & 1) ? (GF_TEXTURE_REPEAT_S | GF_TEXTURE_REPEAT_T) : 0);
+	dr->stencil_set_alpha(sc->texture, (fill==FILL_TEXTURE_ALPHA) ? 0x70 : 0xFF);
+	if (fill==FILL_TEXTURE_CMAT) {
+		gf_cmx_set(&cmat, FIX_ONE/2, FIX_ONE/4, 0, 0, FIX_ONE/10,
+		           0, FIX_ONE, 0, 0, 0,
+		           FIX_ONE/3, 0, FIX_ONE/2, 0, 0,
+		           0, 0, 0, FIX_ONE*3/4, 0);
+		dr->stencil_set_color_matrix(sc->texture, &cmat);
+	} else {
+		dr->stencil_set_color_matrix(sc->texture, NULL);
+	}
+	return sc->texture;
+}
+
+static void draw(Scene *sc, u8 *pixels, u32 fmt_idx, u32 width, u32 height, u32 fill, u32 variant)
+{
+	GF_Raster2D *dr = sc->dr;
+	GF_STENCIL sten = setup_fill(sc, fill, variant);
+	dr->surface_attach_to_buffer(sc->surf, (char *) pixels, width, height, formats[fmt_idx].bpp, formats[fmt_idx].bpp * width, formats[fmt_idx].pixel_format);
+	dr->surface_set_matrix(sc->surf, NULL);
+	dr->surface_set_path(sc->surf, sc->path);
+	dr->surface_fill(sc->surf, sten);
+	dr->surface_detach(sc->surf);
+}
+
+/*random background, with a transparent band to exercise the empty destination paths*/
+static void make_background(u8 *bg, u32 fmt_idx, u32 width, u32 height)
+{
+	u32 i, j, size = formats[fmt_idx].bpp * width * height;
+	for (i=0; i<size; i++) bg[i] = gf_rand() & 0xFF;
+	/*alpha is the last byte in memory for both formats*/
+	if ((formats[fmt_idx].pixel_format == GF_PIXEL_ARGB) || (formats[fmt_idx].pixel_format == GF_PIXEL_RGBA)) {
+		for (j=0; j<height/4; j++) {
+			for (i=0; i<width; i++) bg[4*(j*width+i) + 3] = 0;
+		}
+	}
+}
+
+/*compares all kernels against the scalar code for all fills*/
+static Bool check_format(GF_Raster2D *dr, u32 fmt_idx, u32 width, u32 height)
+{
+	Scene sc;
+	u8 *bg, *ref, *out;
+	u32 fill, variant, tx_idx, simd, size;
+	Bool ok = GF_TRUE;
+
+	size = formats[fmt_idx].bpp * width * height;
+	bg = (u8 *) gf_malloc(size);
+	ref = (u8 *) gf_malloc(size);
+	out = (u8 *) gf_malloc(size);
+	make_background(bg, fmt_idx, width, height);
+
+	for (tx_idx=0; tx_idx<sizeof(tx_formats)/sizeof(tx_formats[0]); tx_idx++) {
+		memset(&sc, 0, sizeof(Scene));
+		sc.dr = dr;
+		setup_scene(&sc, width, height, tx_idx);
+		for (fill=0; fill<FILL_LAST; fill++) {
+			/*only the texture fills depend on the texture format*/
+			if (tx_idx && (fill<FILL_TEXTURE)) continue;
+			for (variant=0; variant<6; variant++) {
+				evg_set_simd(EVG_SIMD_NONE);
+				memcpy(ref, bg, size);
+				draw(&sc, ref, fmt_idx, width, height, fill, variant);
+
+				for (simd=EVG_SIMD_SSE2; simd<=EVG_SIMD_AVX2; simd++) {
+					if (evg_set_simd(simd) != simd) continue;
+					memcpy(out, bg, size);
+					draw(&sc, out, fmt_idx, width, height, fill, variant);
+					if (memcmp(ref, out, size)) {
+						fprintf(stderr, "Error: %s %s fill (variant %d texture %d) %s output differs from scalar code for %dx%d\n", formats[fmt_idx].name, fill_names[fill], variant, tx_idx, simd_names[simd], width, height);
+						ok = GF_FALSE;
+					}
+				}
+			}
+		}
+		delete_scene(&sc);
+	}
+	gf_free(bg);
+	gf_free(ref);
+	gf_free(out);
+	return ok;
+}
+
+static void bench_format(GF_Raster2D *dr, u32 fmt_idx, u32 width, u32 height, u32 nb_frames)
+{
+	Scene sc;
+	u8 *pixels;
+	u32 fill, simd, i;
+
+	pixels = (u8 *) gf_malloc(formats[fmt_idx].bpp * width * height);
+	make_background(pixels, fmt_idx, width, height);
+	memset(&sc, 0, sizeof(Scene));
+	sc.dr = dr;
+	setup_scene(&sc, width, height, 0);
+
+	for (fill=0; fill<FILL_LAST; fill++) {
+		fprintf(stdout, "%s %s:", formats[fmt_idx].name, fill_names[fill]);
+		for (simd=EVG_SIMD_NONE; simd<=EVG_SIMD_AVX2; simd++) {
+			u64 start, time;
+			if (evg_set_simd(simd) != simd) continue;
+			start = gf_sys_clock_high_res();
+			for (i=0; i<nb_frames; i++)
+				draw(&sc, pixels, fmt_idx, width, height, fill, 1);
+			time = gf_sys_clock_high_res() - start;
+			if (!time) time = 1;
+			fprintf(stdout, " %s %.2f Mpix/s", simd_names[simd], ((Double) width) * height * nb_frames / time);
+		}
+		fprintf(stdout, "\n");
+	}
+	delete_scene(&sc);
+	gf_free(pixels);
+}
+
+int main(int argc, char **argv)
+{
+	GF_Raster2D *dr;
+	u32 i, j, width=1280, height=720, nb_frames=20;
+	Bool check_only = GF_FALSE;
+	Bool ok = GF_TRUE;
+	/*widths exercising the SIMD blocks and the scalar tails*/
+	u32 check_widths[] = {640, 131, 46, 17, 5};
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			if (sscanf(argv[i+1], "%dx%d", &width, &height) != 2) {
+				usage();
+				return 1;
+			}
+			i++;
+		} else if (!strcmp(arg, "-frames") && (i+1<(u32) argc)) {
+			nb_frames = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-check")) {
+			check_only = GF_TRUE;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_frames) nb_frames = 1;
+	if ((width<8) || (height<8)) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+	gf_rand_init(GF_TRUE);
+
+	dr = EVG_LoadRenderer();
+	if (!dr) {
+		fprintf(stderr, "Cannot load rasterizer\n");
+		gf_sys_close();
+		return 1;
+	}
+
+	fprintf(stdout, "Best kernels: %s\n", simd_names[evg_set_simd(EVG_SIMD_AUTO)]);
+	for (i=0; i<sizeof(formats)/sizeof(formats[0]); i++) {
+		for (j=0; j<sizeof(check_widths)/sizeof(u32); j++) {
+			if (!check_format(dr, i, check_widths[j], 48)) ok = GF_FALSE;
+		}
+	}
+	fprintf(stdout, "Conformance check %s\n", ok ? "passed" : "failed");
+
+	if (ok && !check_only) {
+		for (i=0; i<sizeof(formats)/sizeof(formats[0]); i++)
+			bench_format(dr, i, width, height, nb_frames);
+	}
+
+	evg_set_simd(EVG_SIMD_AUTO);
+	EVG_ShutdownRenderer(dr);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - ISOBMFF random access benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/isomedia.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: seekbench [options] [file.mp4]\n"
+	        "\n"
+	        "If no file is given, a two-track interleaved file is generated in the current directory.\n"
+	        "\n"
+	        "-dur N: duration in seconds of the generated file (default 10800)\n"
+	        "-seeks N: number of random seeks per test (default 10000)\n"
+	        "-track N: track number to test (default 1)\n"
+	        "-out name: name of the generated file (default seekbench.mp4)\n"
+	       );
+}
+
+static GF_Err generate_file(const char *name, u32 duration)
+{
+	GF_GenericSampleDescription udesc;
+	GF_ISOSample *samp;
+	GF_ISOFile *file;
+	GF_Err e = GF_OK;
+	u32 di, nb_video, nb_audio, v_idx, a_idx;
+	char data[2000];
+
+	file = gf_isom_open(name, GF_ISOM_OPEN_WRITE, NULL);
+	if (!file) return gf_isom_last_error(NULL);
+
+	memset(&udesc, 0, sizeof(GF_GenericSampleDescription));
+	udesc.codec_tag = GF_4CC('b','e','n','v');
+	udesc.width = 320;
+	udesc.height = 240;
+	gf_isom_new_track(file, 1, GF_ISOM_MEDIA_VISUAL, 1000);
+	gf_isom_set_track_enabled(file, 1, 1);
+	gf_isom_new_generic_sample_description(file, 1, NULL, NULL, &udesc, &di);
+
+	memset(&udesc, 0, sizeof(GF_GenericSampleDescription));
+	udesc.codec_tag = GF_4CC('b','e','n','a');
+	udesc.width = 320;
+	udesc.height = 240;
+	/*second track has audio-like timing*/
+	gf_isom_new_track(file, 2, GF_ISOM_MEDIA_VISUAL, 44100);
+	gf_isom_set_track_enabled(file, 2, 1);
+	gf_isom_new_generic_sample_description(file, 2, NULL, NULL, &udesc, &di);
+
+	memset(data, 0, sizeof(data));
+	samp = gf_isom_sample_new();
+	samp->data = data;
+
+	/*25 fps video with a jittered clock (many stts entries) and variable size 1024-sample audio frames*/
+	nb_video = duration * 25;
+	nb_audio = (u32) ( ((u64) duration) * 44100 / 1024);
+	v_idx = a_idx = 0;
+	gf_rand_init(GF_TRUE);
+	while (!e && ((v_idx<nb_video) || (a_idx<nb_audio))) {
+		if ((v_idx<nb_video) && (!(a_idx<nb_audio) || ((u64) v_idx * 40 * 44100 <= (u64) a_idx * 1024 * 1000))) {
+			samp->DTS = v_idx*40 + ((v_idx % 7 == 3) ? 1 : 0);
+			samp->IsRAP = (v_idx % 25) ? RAP_NO : RAP;
+			samp->dataLength = 100 + gf_rand() % 1800;
+			e = gf_isom_add_sample(file, 1, 1, samp);
+			v_idx++;
+		} else {
+			samp->DTS = (u64) a_idx * 1024;
+			samp->IsRAP = RAP;
+			samp->dataLength = 200 + gf_rand() % 200;
+			e = gf_isom_add_sample(file, 2, 1, samp);
+			a_idx++;
+		}
+	}
+	samp->data = NULL;
+	gf_isom_sample_del(&samp);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+static u64 run_seeks(GF_ISOFile *file, u32 track, u32 nb_seeks, Bool use_index, u64 *checksum)
+{
+	u32 i, count, di;
+	u64 start, offset, duration;
+
+	gf_isom_set_sample_index_mode(file, track, use_index);
+	count = gf_isom_get_sample_count(file, track);
+	duration = gf_isom_get_media_duration(file, track);
+	if (!duration) duration = 1;
+
+	/*same pseudo-random sequence for both modes*/
+	gf_rand_init(GF_TRUE);
+	*checksum = 0;
+	start = gf_sys_clock_high_res();
+	for (i=0; i<nb_seeks; i++) {
+		GF_ISOSample *samp = NULL;
+		u32 samp_num = 0;
+		u64 time = ((u64) gf_rand() * gf_rand()) % duration;
+
+		if (gf_isom_get_sample_for_media_time(file, track, time, &di, GF_ISOM_SEARCH_BACKWARD, &samp, &samp_num) == GF_OK) {
+			*checksum += samp->DTS + samp_num;
+			gf_isom_sample_del(&samp);
+		}
+		samp = gf_isom_get_sample_info(file, track, 1 + ((u32) gf_rand() * gf_rand()) % count, &di, &offset);
+		if (samp) {
+			*checksum += offset + samp->DTS + samp->dataLength;
+			gf_isom_sample_del(&samp);
+		}
+	}
+	return gf_sys_clock_high_res() - start;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	GF_ISOFile *file;
+	u32 i, duration=10800, nb_seeks=10000, track=1;
+	u64 time_linear, time_index, sum_linear, sum_index;
+	const char *file_name = NULL;
+	const char *out_name = "seekbench.mp4";
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-dur") && (i+1<(u32) argc)) {
+			duration = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-seeks") && (i+1<(u32) argc)) {
+			nb_seeks = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-track") && (i+1<(u32) argc)) {
+			track = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-out") && (i+1<(u32) argc)) {
+			out_name = argv[i+1];
+			i++;
+		} else if ((arg[0]=='-') || file_name) {
+			usage();
+			return 1;
+		} else {
+			file_name = arg;
+		}
+	}
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	if (!file_name) {
+		fprintf(stderr, "Generating %d seconds of interleaved audio and video in %s\n", duration, out_name);
+		e = generate_file(out_name, duration);
+		if (e) {
+			fprintf(stderr, "Failed to generate test file: %s\n", gf_error_to_string(e));
+			gf_sys_close();
+			return 1;
+		}
+		file_name = out_name;
+	}
+
+	file = gf_isom_open(file_name, GF_ISOM_OPEN_READ, NULL);
+	if (!file) {
+		fprintf(stderr, "Failed to open %s: %s\n", file_name, gf_error_to_string(gf_isom_last_error(NULL)) );
+		gf_sys_close();
+		return 1;
+	}
+	if (!track || (track > gf_isom_get_track_count(file)) || !gf_isom_get_sample_count(file, track)) {
+		fprintf(stderr, "No samples in track %d\n", track);
+		gf_isom_close(file);
+		gf_sys_close();
+		return 1;
+	}
+
+	time_linear = run_seeks(file, track, nb_seeks, GF_FALSE, &sum_linear);
+	time_index = run_seeks(file, track, nb_seeks, GF_TRUE, &sum_index);
+	gf_isom_close(file);
+	if (!time_linear) time_linear = 1;
+	if (!time_index) time_index = 1;
+
+	fprintf(stdout, "%s track %d: %d random seeks\n", file_name, track, nb_seeks);
+	fprintf(stdout, "\ttable walk: "LLU" us - %.2f seeks/sec\n", time_linear, ((Double) nb_seeks) * 1000000 / time_linear);
+	fprintf(stdout, "\tsample index: "LLU" us - %.2f seeks/sec\n", time_index, ((Double) nb_seeks) * 1000000 / time_index);
+	if (sum_linear != sum_index) {
+		fprintf(stderr, "Error: sample index and table walk results differ\n");
+		gf_sys_close();
+		return 1;
+	}
+
+	gf_sys_close();
+	return 0;
+}
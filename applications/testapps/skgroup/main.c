@@ -0,0 +1,235 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - socket group test
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/network.h>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+static void usage()
+{
+	fprintf(stderr, "usage: skgroup [options]\n"
+	        "\n"
+	        "Registers UDP loopback sockets in a socket group, sends datagrams to a random subset of them at each round\n"
+	        "and checks the group reports exactly the sockets holding data. Only one datagram is read per socket and select,\n"
+	        "so that sockets still holding data must be reported again. Reports the select time with active and idle sockets.\n"
+	        "\n"
+	        "-socks N: number of sockets (default 5000)\n"
+	        "-rounds N: number of rounds (default 200)\n"
+	        "-active N: number of sockets receiving data at each round (default 50)\n"
+	        "-port N: first loopback port to use (default 20000)\n"
+	       );
+}
+
+static void set_idx(char *buf, u32 idx)
+{
+	buf[0] = (idx>>24) & 0xFF;
+	buf[1] = (idx>>16) & 0xFF;
+	buf[2] = (idx>>8) & 0xFF;
+	buf[3] = idx & 0xFF;
+}
+
+static u32 get_idx(char *buf)
+{
+	return GF_4CC((u8) buf[0], (u8) buf[1], (u8) buf[2], (u8) buf[3]);
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, j, nb_socks=5000, nb_rounds=200, nb_active=50, port=20000;
+	u32 nb_created, nb_sent, nb_rcv, nb_bad, nb_selects, nb_empty;
+	GF_Socket **socks, **snds, *sk;
+	GF_SockGroup *sg;
+	s32 *pending;
+	u32 *active;
+	char buf[100];
+	u64 start, time;
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-socks") && (i+1<(u32) argc)) {
+			nb_socks = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-rounds") && (i+1<(u32) argc)) {
+			nb_rounds = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-active") && (i+1<(u32) argc)) {
+			nb_active = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-port") && (i+1<(u32) argc)) {
+			port = atoi(argv[i+1]);
+			i++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_socks) nb_socks = 1;
+	if (nb_active > nb_socks) nb_active = nb_socks;
+	if (port + nb_socks + 1 > 0xFFFF) port = 0xFFFF - nb_socks - 1;
+
+#if defined(__linux__)
+	/*one descriptor per socket and per sender*/
+	{
+		struct rlimit rl;
+		if (!getrlimit(RLIMIT_NOFILE, &rl) && (rl.rlim_cur < 2*nb_socks + 64)) {
+			rl.rlim_cur = 2*nb_socks + 64;
+			if (rl.rlim_cur > rl.rlim_max) rl.rlim_cur = rl.rlim_max;
+			setrlimit(RLIMIT_NOFILE, &rl);
+		}
+	}
+#endif
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	socks = gf_malloc(sizeof(GF_Socket *) * nb_socks);
+	snds = gf_malloc(sizeof(GF_Socket *) * nb_socks);
+	pending = gf_malloc(sizeof(s32) * nb_socks);
+	active = gf_malloc(sizeof(u32) * nb_active);
+	memset(pending, 0, sizeof(s32) * nb_socks);
+	sg = gf_sk_group_new();
+
+	nb_created = 0;
+	e = GF_OK;
+	for (i=0; i<nb_socks; i++) {
+		socks[i] = gf_sk_new(GF_SOCK_TYPE_UDP);
+		snds[i] = gf_sk_new(GF_SOCK_TYPE_UDP);
+		/*registered before the socket is bound*/
+		gf_sk_group_register(sg, socks[i]);
+		nb_created++;
+		e = gf_sk_bind(socks[i], "127.0.0.1", port+i, NULL, 0, 0);
+		if (!e) e = gf_sk_bind(snds[i], "127.0.0.1", 0, "127.0.0.1", port+i, 0);
+		if (e) break;
+		gf_sk_set_block_mode(socks[i], GF_TRUE);
+	}
+	if (e) {
+		fprintf(stderr, "Failed to setup loopback sockets (%d created): %s\n", nb_created, gf_error_to_string(e));
+		ret = 1;
+		goto exit;
+	}
+	fprintf(stdout, "%d sockets on loopback ports %d to %d - %d rounds with %d active sockets\n", nb_socks, port, port+nb_socks-1, nb_rounds, nb_active);
+
+	gf_rand_init(GF_TRUE);
+	nb_sent = nb_rcv = nb_bad = nb_selects = nb_empty = 0;
+	time = 0;
+	for (i=0; i<nb_rounds; i++) {
+		u32 round_sent = 0;
+		for (j=0; j<nb_active; j++) {
+			u32 k, nb = 1 + gf_rand() % 3;
+			active[j] = gf_rand() % nb_socks;
+			set_idx(buf, active[j]);
+			for (k=0; k<nb; k++) {
+				if (gf_sk_send(snds[active[j]], buf, 4) == GF_OK) {
+					pending[active[j]]++;
+					round_sent++;
+				}
+			}
+		}
+		nb_sent += round_sent;
+
+		while (round_sent) {
+			u32 pos = 0;
+			start = gf_sys_clock_high_res();
+			e = gf_sk_group_select(sg, 100000);
+			time += gf_sys_clock_high_res() - start;
+			nb_selects++;
+			if (e) {
+				if (++nb_empty > 10) {
+					fprintf(stderr, "Error: %d datagrams never signaled in round %d\n", round_sent, i);
+					ret = 1;
+					break;
+				}
+				continue;
+			}
+			/*every socket holding data must be signaled, and only those*/
+			for (j=0; j<nb_active; j++) {
+				Bool is_set = gf_sk_group_sock_is_set(sg, socks[active[j]]);
+				if (is_set != (pending[active[j]] ? GF_TRUE : GF_FALSE)) nb_bad++;
+			}
+			/*read a single datagram per signaled socket*/
+			while ((sk = gf_sk_group_enum_ready(sg, &pos))) {
+				u32 idx, size = 0;
+				e = gf_sk_receive_no_select(sk, buf, sizeof(buf), 0, &size);
+				if (e || (size != 4)) {
+					nb_bad++;
+					continue;
+				}
+				idx = get_idx(buf);
+				if ((idx >= nb_socks) || (socks[idx] != sk) || !pending[idx]) {
+					nb_bad++;
+					continue;
+				}
+				pending[idx]--;
+				round_sent--;
+				nb_rcv++;
+			}
+		}
+		if (ret) break;
+	}
+	if (!nb_selects) nb_selects = 1;
+	fprintf(stdout, "\tactive: %d selects - %.2f us per select - received %d/%d%s\n", nb_selects, ((Double) time) / nb_selects, nb_rcv, nb_sent, nb_bad ? " - ERRORS" : "");
+	if (nb_bad || (nb_rcv != nb_sent)) ret = 1;
+
+	/*no socket holds data*/
+	time = 0;
+	nb_bad = 0;
+	for (i=0; i<1000; i++) {
+		start = gf_sys_clock_high_res();
+		e = gf_sk_group_select(sg, 0);
+		time += gf_sys_clock_high_res() - start;
+		if (e != GF_IP_NETWORK_EMPTY) nb_bad++;
+	}
+	fprintf(stdout, "\tidle: %.2f us per select%s\n", ((Double) time) / 1000, nb_bad ? " - ERRORS" : "");
+	if (nb_bad) ret = 1;
+
+	/*unregistered sockets are no longer signaled*/
+	for (i=0; i<nb_socks; i+=2) gf_sk_group_unregister(sg, socks[i]);
+	for (i=0; i<MIN(nb_socks, 100); i+=2) {
+		set_idx(buf, i);
+		gf_sk_send(snds[i], buf, 4);
+	}
+	e = gf_sk_group_select(sg, 10000);
+	fprintf(stdout, "\tunregistered sockets: %s\n", (e == GF_IP_NETWORK_EMPTY) ? "not signaled" : "SIGNALED");
+	if (e != GF_IP_NETWORK_EMPTY) ret = 1;
+
+exit:
+	for (i=0; i<nb_created; i++) {
+		gf_sk_group_unregister(sg, socks[i]);
+		gf_sk_del(socks[i]);
+		gf_sk_del(snds[i]);
+	}
+	gf_sk_group_del(sg);
+	gf_free(socks);
+	gf_free(snds);
+	gf_free(pending);
+	gf_free(active);
+	gf_sys_close();
+	return ret;
+}
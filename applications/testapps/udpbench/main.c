@@ -0,0 +1,502 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - UDP/RTP sending and reception benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/network.h>
+#include <gpac/ietf.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: udpbench [options]\n"
+	        "\n"
+	        "Sends UDP and RTP packets on the loopback interface one by one and in bursts, and reports packets/sec.\n"
+	        "Received packets are checked against the sent ones.\n"
+	        "Then receives UDP packets one by one and in batches, receives reordered RTP packets through an RTP channel,\n"
+	        "and checks the socket drop counters.\n"
+	        "\n"
+	        "-pcks N: number of packets per test (default 200000)\n"
+	        "-size N: payload size in bytes (default 1316)\n"
+	        "-burst N: number of packets per burst (default 32)\n"
+	        "-port N: first loopback port to use (default 4500)\n"
+	       );
+}
+
+#define MAX_BURST	1024
+
+typedef struct
+{
+	GF_Socket *rcv;
+	char buf[2000];
+	u32 nb_rcv, nb_bad;
+	u32 hdr_size, size;
+	u32 next_seq;
+} Receiver;
+
+static u32 get_seq(char *pck)
+{
+	return GF_4CC((u8) pck[0], (u8) pck[1], (u8) pck[2], (u8) pck[3]);
+}
+
+/*drains the receiver, checking the sequence number stored at the start of each payload*/
+static void drain(Receiver *r)
+{
+	while (1) {
+		u32 read = 0, seq;
+		GF_Err e = gf_sk_receive_no_select(r->rcv, r->buf, sizeof(r->buf), 0, &read);
+		if (e || !read) break;
+		if (read != r->hdr_size + r->size) {
+			r->nb_bad++;
+			continue;
+		}
+		seq = get_seq(r->buf + r->hdr_size);
+		/*loopback may drop packets when the receive buffer is full, but never reorders them*/
+		if (seq < r->next_seq) r->nb_bad++;
+		r->next_seq = seq+1;
+		r->nb_rcv++;
+	}
+}
+
+static void set_seq(char *pck, u32 seq)
+{
+	pck[0] = (seq>>24) & 0xFF;
+	pck[1] = (seq>>16) & 0xFF;
+	pck[2] = (seq>>8) & 0xFF;
+	pck[3] = seq & 0xFF;
+}
+
+static void report(const char *name, u32 nb_pcks, u64 time, Receiver *r)
+{
+	if (!time) time = 1;
+	fprintf(stdout, "\t%s: %.0f packets/sec - %.2f Mbps - received %d/%d%s\n", name,
+	        ((Double) nb_pcks) * 1000000 / time, ((Double) nb_pcks) * r->size * 8 / time,
+	        r->nb_rcv, nb_pcks, r->nb_bad ? " - CORRUPTED" : "");
+}
+
+/*sends nb_pcks datagrams in bursts and reads them back one by one or in batches*/
+static int test_receive(GF_Socket *snd, GF_Socket *rcv, GF_SockDatagram *dgrams, char **pcks, u32 nb_pcks, u32 size, u32 burst, Bool batch)
+{
+	u32 i, j, nb_rcv=0, nb_bad=0, next_seq=0;
+	char *bufs[MAX_BURST];
+	u32 sizes[MAX_BURST];
+	u64 start, time=0;
+
+	for (i=0; i<burst; i++) bufs[i] = gf_malloc(2000);
+
+	for (i=0; i<nb_pcks; i+=burst) {
+		u32 nb = MIN(burst, nb_pcks-i);
+		u32 left = nb;
+		for (j=0; j<nb; j++) set_seq(pcks[j], i+j);
+		gf_sk_send_batch(snd, dgrams, nb, NULL);
+
+		start = gf_sys_clock_high_res();
+		while (left) {
+			u32 nb_read = 0;
+			if (batch) {
+				if (gf_sk_receive_batch(rcv, bufs, 2000, sizes, left, &nb_read)) break;
+			} else {
+				if (gf_sk_receive(rcv, bufs[0], 2000, 0, &sizes[0])) break;
+				nb_read = 1;
+			}
+			for (j=0; j<nb_read; j++) {
+				if ((sizes[j] != size) || (get_seq(bufs[j]) < next_seq)) nb_bad++;
+				next_seq = get_seq(bufs[j]) + 1;
+			}
+			nb_rcv += nb_read;
+			left -= nb_read;
+		}
+		time += gf_sys_clock_high_res() - start;
+	}
+	if (!time) time = 1;
+	fprintf(stdout, "\t%s: %.0f packets/sec - received %d/%d%s\n", batch ? "UDP gf_sk_receive_batch" : "UDP gf_sk_receive      ",
+	        ((Double) nb_rcv) * 1000000 / time, nb_rcv, nb_pcks, nb_bad ? " - CORRUPTED" : "");
+	for (i=0; i<burst; i++) gf_free(bufs[i]);
+	return nb_bad ? 1 : 0;
+}
+
+#define RTP_FIRST_SN	1000
+#define RTP_REORDER_DELAY	100
+
+/*sends RTP packets with swapped pairs of sequence numbers to a receiving RTP channel, and checks they are reordered*/
+static int test_rtp_receive(u32 port, GF_SockDatagram *dgrams, char **pcks, u32 nb_pcks, u32 size, u32 burst)
+{
+	GF_Err e;
+	GF_Socket *snd;
+	GF_RTPChannel *ch;
+	GF_RTSPTransport tr;
+	u32 i, j, nb_rcv=0, nb_bad=0, last_sn=0;
+	char *hdrs;
+	u64 start, time=0;
+	int ret = 0;
+
+	/*RTP is received on port and sent from port+2*/
+	ch = gf_rtp_new();
+	memset(&tr, 0, sizeof(GF_RTSPTransport));
+	tr.IsUnicast = GF_TRUE;
+	tr.Profile = "RTP/AVP";
+	tr.source = "127.0.0.1";
+	tr.port_first = port+2;
+	tr.port_last = port+3;
+	tr.client_port_first = port;
+	tr.client_port_last = port+1;
+	e = gf_rtp_setup_transport(ch, &tr, NULL);
+	if (!e) e = gf_rtp_initialize(ch, 8*1024*1024, GF_FALSE, 0, 4*burst, RTP_REORDER_DELAY, "127.0.0.1");
+	snd = gf_sk_new(GF_SOCK_TYPE_UDP);
+	if (!e) e = gf_sk_bind(snd, "127.0.0.1", port+2, "127.0.0.1", port, 0);
+	if (e) {
+		fprintf(stderr, "Failed to setup RTP reception: %s\n", gf_error_to_string(e));
+		gf_sk_del(snd);
+		gf_rtp_del(ch);
+		return 1;
+	}
+
+	hdrs = gf_malloc(12*burst);
+	for (i=0; i<nb_pcks; i+=burst) {
+		u32 nb = MIN(burst, nb_pcks-i);
+		for (j=0; j<nb; j++) {
+			/*swap each pair of packets*/
+			u32 sn = RTP_FIRST_SN + i + ((j & 1) ? j-1 : ((j+1<nb) ? j+1 : j));
+			char *h = hdrs + 12*j;
+			memset(h, 0, 12);
+			h[0] = (char) 0x80;
+			h[1] = 96;
+			h[2] = (sn>>8) & 0xFF;
+			h[3] = sn & 0xFF;
+			set_seq(pcks[j], sn);
+			dgrams[j].header = h;
+			dgrams[j].header_size = 12;
+		}
+		gf_sk_send_batch(snd, dgrams, nb, NULL);
+
+		while (1) {
+			u32 pck_size;
+			char *pck;
+			start = gf_sys_clock_high_res();
+			pck = gf_rtp_read_rtp_packet(ch, &pck_size);
+			/*don't count the wait on the empty socket*/
+			if (!pck) break;
+			time += gf_sys_clock_high_res() - start;
+			if ((pck_size != size+12) || (last_sn && (get_seq(pck+12) != last_sn+1))) nb_bad++;
+			last_sn = get_seq(pck+12);
+			nb_rcv++;
+		}
+	}
+	/*the last packets are released once the reordering delay is over*/
+	gf_sleep(2*RTP_REORDER_DELAY);
+	while (1) {
+		u32 pck_size;
+		char *pck = gf_rtp_read_rtp_packet(ch, &pck_size);
+		if (!pck) {
+			if (nb_rcv==nb_pcks) break;
+			gf_sleep(RTP_REORDER_DELAY);
+			pck = gf_rtp_read_rtp_packet(ch, &pck_size);
+			if (!pck) break;
+		}
+		if ((pck_size != size+12) || (last_sn && (get_seq(pck+12) != last_sn+1))) nb_bad++;
+		last_sn = get_seq(pck+12);
+		nb_rcv++;
+	}
+	if (!time) time = 1;
+	fprintf(stdout, "\tRTP read_rtp_packet reordering: %.0f packets/sec - received %d/%d in order%s\n",
+	        ((Double) nb_rcv) * 1000000 / time, nb_rcv, nb_pcks, nb_bad ? " - CORRUPTED" : "");
+	if (nb_bad || (nb_rcv != nb_pcks)) ret = 1;
+
+	for (j=0; j<burst; j++) {
+		dgrams[j].header = NULL;
+		dgrams[j].header_size = 0;
+	}
+	gf_free(hdrs);
+	gf_sk_del(snd);
+	gf_rtp_del(ch);
+	return ret;
+}
+
+#define DROP_TEST_PCKS	2000
+
+/*overflows a small socket buffer and checks received and dropped datagrams match the sent ones*/
+static int test_drops(u32 port, GF_SockDatagram *dgrams, char **pcks, u32 size, u32 burst)
+{
+	GF_Err e;
+	GF_Socket *snd, *rcv;
+	u32 i, j, nb_sent=0, nb_rcv, nb_drop, nb_trunc;
+	char *bufs[MAX_BURST];
+	u32 sizes[MAX_BURST];
+	char big[3000];
+	int ret = 0;
+
+	rcv = gf_sk_new(GF_SOCK_TYPE_UDP);
+	snd = gf_sk_new(GF_SOCK_TYPE_UDP);
+	e = gf_sk_bind(rcv, "127.0.0.1", port, NULL, 0, 0);
+	if (!e) e = gf_sk_bind(snd, "127.0.0.1", port+2, "127.0.0.1", port, 0);
+	if (e) {
+		fprintf(stderr, "Failed to setup loopback sockets: %s\n", gf_error_to_string(e));
+		gf_sk_del(rcv);
+		gf_sk_del(snd);
+		return 1;
+	}
+	gf_sk_set_block_mode(rcv, GF_TRUE);
+	gf_sk_set_buffer_size(rcv, GF_FALSE, 64*1024);
+	for (i=0; i<burst; i++) bufs[i] = gf_malloc(2000);
+
+	/*first read enables the drop counter*/
+	gf_sk_receive_batch(rcv, bufs, 2000, sizes, burst, &nb_rcv);
+
+	for (i=0; i<DROP_TEST_PCKS; i+=burst) {
+		u32 nb = MIN(burst, DROP_TEST_PCKS-i), sent = 0;
+		for (j=0; j<nb; j++) set_seq(pcks[j], i+j);
+		gf_sk_send_batch(snd, dgrams, nb, &sent);
+		nb_sent += sent;
+	}
+	while (1) {
+		if (gf_sk_receive_batch(rcv, bufs, 2000, sizes, burst, &nb_rcv)) break;
+	}
+	/*datagrams larger than the reception buffers*/
+	memset(big, 0, sizeof(big));
+	for (i=0; i<3; i++) gf_sk_send(snd, big, sizeof(big));
+	while (1) {
+		if (gf_sk_receive_batch(rcv, bufs, 2000, sizes, burst, &nb_rcv)) break;
+	}
+	gf_sk_get_receive_stats(rcv, &nb_rcv, &nb_drop, &nb_trunc);
+	fprintf(stdout, "\tUDP drop counters: sent %d - received %d - dropped %d - truncated %d\n", nb_sent+3, nb_rcv, nb_drop, nb_trunc);
+#ifdef __linux__
+	if (nb_rcv + nb_drop + nb_trunc != nb_sent + 3) {
+		fprintf(stderr, "Error: drop counters do not match the sent datagrams\n");
+		ret = 1;
+	}
+#endif
+	if (!nb_drop) fprintf(stdout, "\tno datagram dropped by the system\n");
+
+	for (i=0; i<burst; i++) gf_free(bufs[i]);
+	gf_sk_del(rcv);
+	gf_sk_del(snd);
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, j, nb_pcks=200000, size=1316, burst=32, port=4500;
+	char *payloads;
+	GF_SockDatagram *dgrams;
+	GF_Socket *snd;
+	GF_RTPChannel *ch;
+	GF_RTSPTransport tr;
+	GF_RTPHeader *hdrs;
+	char **pcks;
+	u32 *sizes;
+	Receiver r;
+	u64 start, time;
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-pcks") && (i+1<(u32) argc)) {
+			nb_pcks = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			size = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-burst") && (i+1<(u32) argc)) {
+			burst = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-port") && (i+1<(u32) argc)) {
+			port = atoi(argv[i+1]);
+			i++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (size<4) size = 4;
+	if (size>1400) size = 1400;
+	if (!burst) burst = 1;
+	if (burst>MAX_BURST) burst = MAX_BURST;
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+
+	memset(&r, 0, sizeof(Receiver));
+	r.rcv = gf_sk_new(GF_SOCK_TYPE_UDP);
+	snd = gf_sk_new(GF_SOCK_TYPE_UDP);
+	e = gf_sk_bind(r.rcv, "127.0.0.1", port, NULL, 0, 0);
+	if (!e) e = gf_sk_bind(snd, "127.0.0.1", port+2, "127.0.0.1", port, 0);
+	if (e) {
+		fprintf(stderr, "Failed to setup loopback sockets: %s\n", gf_error_to_string(e));
+		gf_sk_del(r.rcv);
+		gf_sk_del(snd);
+		gf_sys_close();
+		return 1;
+	}
+	/*the receiver is drained after each burst without waiting*/
+	gf_sk_set_block_mode(r.rcv, GF_TRUE);
+	gf_sk_set_buffer_size(r.rcv, GF_FALSE, 8*1024*1024);
+	gf_sk_set_buffer_size(snd, GF_TRUE, 8*1024*1024);
+
+	payloads = gf_malloc(sizeof(char) * size * burst);
+	dgrams = gf_malloc(sizeof(GF_SockDatagram) * burst);
+	hdrs = gf_malloc(sizeof(GF_RTPHeader) * burst);
+	pcks = gf_malloc(sizeof(char *) * burst);
+	sizes = gf_malloc(sizeof(u32) * burst);
+	gf_rand_init(GF_TRUE);
+	for (i=0; i<size*burst; i++) payloads[i] = gf_rand();
+	for (i=0; i<burst; i++) {
+		dgrams[i].header = NULL;
+		dgrams[i].header_size = 0;
+		dgrams[i].data = pcks[i] = payloads + i*size;
+		dgrams[i].size = sizes[i] = size;
+	}
+	r.size = size;
+
+	fprintf(stdout, "%d packets of %d bytes on loopback port %d - bursts of %d packets\n", nb_pcks, size, port, burst);
+
+	/*UDP, one call per packet*/
+	time = 0;
+	for (i=0; i<nb_pcks; i+=burst) {
+		u32 nb = MIN(burst, nb_pcks-i);
+		for (j=0; j<nb; j++) set_seq(pcks[j], i+j);
+		start = gf_sys_clock_high_res();
+		for (j=0; j<nb; j++) {
+			gf_sk_send(snd, pcks[j], size);
+		}
+		time += gf_sys_clock_high_res() - start;
+		drain(&r);
+	}
+	report("UDP gf_sk_send      ", nb_pcks, time, &r);
+
+	/*UDP, batched*/
+	r.nb_rcv = r.next_seq = 0;
+	time = 0;
+	for (i=0; i<nb_pcks; i+=burst) {
+		u32 nb = MIN(burst, nb_pcks-i);
+		for (j=0; j<nb; j++) set_seq(pcks[j], i+j);
+		start = gf_sys_clock_high_res();
+		gf_sk_send_batch(snd, dgrams, nb, NULL);
+		time += gf_sys_clock_high_res() - start;
+		drain(&r);
+	}
+	report("UDP gf_sk_send_batch", nb_pcks, time, &r);
+	if (r.nb_bad) ret = 1;
+	gf_sk_del(snd);
+
+	/*RTP channel to the receiver port*/
+	ch = gf_rtp_new();
+	gf_rtp_set_ports(ch, 0);
+	memset(&tr, 0, sizeof(GF_RTSPTransport));
+	tr.IsUnicast = GF_TRUE;
+	tr.Profile = "RTP/AVP";
+	tr.destination = "127.0.0.1";
+	tr.source = "0.0.0.0";
+	tr.SSRC = 0x12345678;
+	/*sent from port+2 to the receiver port, RTCP from port+3 to port+1*/
+	tr.port_first = port+2;
+	tr.port_last = port+3;
+	tr.client_port_first = port;
+	tr.client_port_last = port+1;
+	e = gf_rtp_setup_transport(ch, &tr, "127.0.0.1");
+	if (!e) e = gf_rtp_initialize(ch, 0, GF_TRUE, 1500, 0, 0, NULL);
+	if (e) {
+		fprintf(stderr, "Failed to setup RTP channel: %s\n", gf_error_to_string(e));
+		ret = 1;
+	} else {
+		char *fast_buf = gf_malloc(sizeof(char) * (size+12));
+		memset(hdrs, 0, sizeof(GF_RTPHeader) * burst);
+		r.hdr_size = 12;
+
+		/*RTP, one call per packet*/
+		r.nb_rcv = r.next_seq = 0;
+		time = 0;
+		for (i=0; i<nb_pcks; i+=burst) {
+			u32 nb = MIN(burst, nb_pcks-i);
+			for (j=0; j<nb; j++) set_seq(pcks[j], i+j);
+			start = gf_sys_clock_high_res();
+			for (j=0; j<nb; j++) {
+				GF_RTPHeader hdr;
+				memset(&hdr, 0, sizeof(GF_RTPHeader));
+				hdr.Version = 2;
+				hdr.PayloadType = 96;
+				hdr.SequenceNumber = i+j;
+				hdr.TimeStamp = i;
+				hdr.Marker = (j+1==nb) ? 1 : 0;
+				/*fast send, as done by the RTP streamer*/
+				memcpy(fast_buf+12, pcks[j], size);
+				gf_rtp_send_packet(ch, &hdr, fast_buf+12, size, GF_TRUE);
+			}
+			time += gf_sys_clock_high_res() - start;
+			drain(&r);
+		}
+		report("RTP send_packet     ", nb_pcks, time, &r);
+		if (r.nb_bad) ret = 1;
+
+		/*RTP, batched*/
+		r.nb_rcv = r.next_seq = 0;
+		time = 0;
+		for (i=0; i<nb_pcks; i+=burst) {
+			u32 nb = MIN(burst, nb_pcks-i);
+			for (j=0; j<nb; j++) set_seq(pcks[j], i+j);
+			start = gf_sys_clock_high_res();
+			for (j=0; j<nb; j++) {
+				hdrs[j].Version = 2;
+				hdrs[j].PayloadType = 96;
+				hdrs[j].SequenceNumber = i+j;
+				hdrs[j].TimeStamp = i;
+				hdrs[j].Marker = (j+1==nb) ? 1 : 0;
+			}
+			gf_rtp_send_packets(ch, hdrs, pcks, sizes, nb);
+			time += gf_sys_clock_high_res() - start;
+			drain(&r);
+		}
+		report("RTP send_packets    ", nb_pcks, time, &r);
+		if (r.nb_bad) ret = 1;
+		gf_free(fast_buf);
+	}
+	gf_rtp_del(ch);
+	gf_sk_del(r.rcv);
+
+	/*reception*/
+	r.rcv = gf_sk_new(GF_SOCK_TYPE_UDP);
+	snd = gf_sk_new(GF_SOCK_TYPE_UDP);
+	e = gf_sk_bind(r.rcv, "127.0.0.1", port, NULL, 0, 0);
+	if (!e) e = gf_sk_bind(snd, "127.0.0.1", port+2, "127.0.0.1", port, 0);
+	if (e) {
+		fprintf(stderr, "Failed to setup loopback sockets: %s\n", gf_error_to_string(e));
+		ret = 1;
+	} else {
+		gf_sk_set_buffer_size(r.rcv, GF_FALSE, 8*1024*1024);
+		if (test_receive(snd, r.rcv, dgrams, pcks, nb_pcks, size, burst, GF_FALSE)) ret = 1;
+		if (test_receive(snd, r.rcv, dgrams, pcks, nb_pcks, size, burst, GF_TRUE)) ret = 1;
+	}
+	gf_sk_del(snd);
+	gf_sk_del(r.rcv);
+
+	if (test_rtp_receive(port, dgrams, pcks, nb_pcks, size, burst)) ret = 1;
+	if (test_drops(port, dgrams, pcks, size, burst)) ret = 1;
+
+	gf_free(payloads);
+	gf_free(dgrams);
+	gf_free(hdrs);
+	gf_free(pcks);
+	gf_free(sizes);
+	gf_sys_close();
+	return ret;
+}
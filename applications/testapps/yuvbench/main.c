@@ -0,0 +1,332 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - YUV to RGB conversion test and benchmark
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/color.h>
+#include <gpac/thread.h>
+
+static void usage()
+{
+	fprintf(stderr, "usage: yuvbench [options]\n"
+	        "\n"
+	        "Checks that all SIMD YUV to RGB kernels and multi-threaded stretch give the same pixels as the scalar code, then measures their throughput.\n"
+	        "\n"
+	        "-size WxH: benchmark frame size (default 1920x1080)\n"
+	        "-frames N: number of frames converted per format and kernel (default 100)\n"
+	        "-threads N: number of threads converting each frame in the benchmark (default 1)\n"
+	        "-check: only run the conformance check\n"
+	       );
+}
+
+static struct
+{
+	u32 pixel_format;
+	const char *name;
+	Bool ten_bits;
+} formats[] = {
+	{GF_PIXEL_YV12, "YV12", GF_FALSE},
+	{GF_PIXEL_YUV422, "YUV422", GF_FALSE},
+	{GF_PIXEL_YUV444, "YUV444", GF_FALSE},
+	{GF_PIXEL_YV12_10, "YV12 10 bits", GF_TRUE},
+	{GF_PIXEL_YUV422_10, "YUV422 10 bits", GF_TRUE},
+	{GF_PIXEL_YUV444_10, "YUV444 10 bits", GF_TRUE},
+	{GF_PIXEL_YUVA, "YUVA", GF_FALSE},
+	{GF_PIXEL_YUY2, "YUY2", GF_FALSE},
+};
+
+static const char *simd_names[] = {"scalar", "SSE2", "AVX2", "NEON"};
+
+/*frames are stored with planes one after the other, as expected by gf_stretch_bits when no plane pointers are given*/
+static u8 *make_frame(GF_VideoSurface *src, u32 pixel_format, Bool ten_bits, u32 width, u32 height)
+{
+	u32 i, size;
+	u8 *data;
+
+	memset(src, 0, sizeof(GF_VideoSurface));
+	src->width = width;
+	src->height = height;
+	src->pixel_format = pixel_format;
+	/*pad lines, odd widths are rounded up by the converter - keep chroma lines of 10 bits formats aligned*/
+	src->pitch_y = (width + 63) & ~31;
+	if (ten_bits) src->pitch_y *= 2;
+	else if (pixel_format==GF_PIXEL_YUY2) src->pitch_y *= 2;
+
+	size = src->pitch_y * height * 3 + 64;
+	data = (u8 *) gf_malloc(size);
+	if (ten_bits) {
+		u16 *d = (u16 *) data;
+		for (i=0; i<size/2; i++) d[i] = gf_rand() & 0x3FF;
+	} else {
+		for (i=0; i<size; i++) data[i] = gf_rand() & 0xFF;
+	}
+	src->video_buffer = (char *) data;
+	return data;
+}
+
+static GF_Err convert(GF_VideoSurface *dst, GF_VideoSurface *src, GF_Window *src_wnd)
+{
+	memset(dst->video_buffer, 0, dst->pitch_y * dst->height);
+	return gf_stretch_bits(dst, src, NULL, src_wnd, 0xFF, GF_FALSE, NULL, NULL);
+}
+
+/*compares all kernels against the scalar code, with and without source window*/
+static Bool check_format(u32 fmt_idx, u32 width, u32 height)
+{
+	GF_VideoSurface src, dst;
+	GF_Window wnd;
+	u8 *data, *ref;
+	u32 simd, k, size;
+	Bool ok = GF_TRUE;
+
+	data = make_frame(&src, formats[fmt_idx].pixel_format, formats[fmt_idx].ten_bits, width, height);
+
+	memset(&dst, 0, sizeof(GF_VideoSurface));
+	dst.width = width;
+	dst.height = height;
+	dst.pitch_x = 4;
+	dst.pitch_y = 4*width;
+	dst.pixel_format = GF_PIXEL_RGBA;
+	size = dst.pitch_y * height;
+	dst.video_buffer = (char *) gf_malloc(size);
+	ref = (u8 *) gf_malloc(2*size);
+
+	wnd.x = 2;
+	wnd.y = 2;
+	wnd.w = width - 4;
+	wnd.h = height - 4;
+
+	gf_color_set_simd(GF_COLOR_SIMD_NONE);
+	convert(&dst, &src, NULL);
+	memcpy(ref, dst.video_buffer, size);
+	convert(&dst, &src, &wnd);
+	memcpy(ref+size, dst.video_buffer, size);
+
+	for (simd=GF_COLOR_SIMD_SSE2; simd<=GF_COLOR_SIMD_NEON; simd++) {
+		if (gf_color_set_simd(simd) != simd) continue;
+		for (k=0; k<2; k++) {
+			convert(&dst, &src, k ? &wnd : NULL);
+			if (memcmp(ref + k*size, dst.video_buffer, size)) {
+				fprintf(stderr, "Error: %s %s output differs from scalar code for %dx%d%s\n", formats[fmt_idx].name, simd_names[simd], width, height, k ? " window" : "");
+				ok = GF_FALSE;
+			}
+		}
+	}
+	gf_free(ref);
+	gf_free(dst.video_buffer);
+	gf_free(data);
+	return ok;
+}
+
+/*compares multi-threaded stretch against a single pass, with scaling and flipping*/
+static Bool check_bands(u32 fmt_idx, u32 src_w, u32 src_h, u32 dst_w, u32 dst_h, Bool flip)
+{
+	GF_VideoSurface src, dst;
+	u8 *data, *ref;
+	u32 size;
+	Bool ok = GF_TRUE;
+
+	data = make_frame(&src, formats[fmt_idx].pixel_format, formats[fmt_idx].ten_bits, src_w, src_h);
+	memset(&dst, 0, sizeof(GF_VideoSurface));
+	dst.width = dst_w;
+	dst.height = dst_h;
+	dst.pitch_x = 3;
+	dst.pitch_y = 3*dst_w;
+	dst.pixel_format = GF_PIXEL_RGB_24;
+	size = dst.pitch_y * dst_h;
+	dst.video_buffer = (char *) gf_malloc(size);
+	ref = (u8 *) gf_malloc(size);
+
+	memset(dst.video_buffer, 0, size);
+	gf_stretch_bits(&dst, &src, NULL, NULL, 0xFF, flip, NULL, NULL);
+	memcpy(ref, dst.video_buffer, size);
+
+	gf_stretch_bits_add_threads(4);
+	memset(dst.video_buffer, 0, size);
+	gf_stretch_bits(&dst, &src, NULL, NULL, 0xFF, flip, NULL, NULL);
+	if (memcmp(ref, dst.video_buffer, size)) {
+		fprintf(stderr, "Error: %s multi-threaded stretch %dx%d to %dx%d%s differs from single pass\n", formats[fmt_idx].name, src_w, src_h, dst_w, dst_h, flip ? " flipped" : "");
+		ok = GF_FALSE;
+	}
+	gf_stretch_bits_remove_threads(4);
+
+	gf_free(ref);
+	gf_free(dst.video_buffer);
+	gf_free(data);
+	return ok;
+}
+
+static volatile Bool resize_run;
+
+/*registers and unregisters stretch threads in a loop, resizing the pool under running stretches*/
+static u32 resize_threads(void *par)
+{
+	u32 nb = 2;
+	while (resize_run) {
+		gf_stretch_bits_add_threads(nb);
+		gf_sleep(0);
+		gf_stretch_bits_remove_threads(nb);
+		nb = (nb==8) ? 2 : nb+1;
+	}
+	return 0;
+}
+
+/*compares stretches done while another thread changes the thread settings against a single pass*/
+static Bool check_resize(u32 fmt_idx)
+{
+	GF_VideoSurface src, dst;
+	GF_Thread *th;
+	u8 *data, *ref;
+	u32 i, size;
+	Bool ok = GF_TRUE;
+
+	data = make_frame(&src, formats[fmt_idx].pixel_format, formats[fmt_idx].ten_bits, 640, 360);
+	memset(&dst, 0, sizeof(GF_VideoSurface));
+	dst.width = 640;
+	dst.height = 360;
+	dst.pitch_x = 3;
+	dst.pitch_y = 3*640;
+	dst.pixel_format = GF_PIXEL_RGB_24;
+	size = dst.pitch_y * 360;
+	dst.video_buffer = (char *) gf_malloc(size);
+	ref = (u8 *) gf_malloc(size);
+
+	memset(dst.video_buffer, 0, size);
+	gf_stretch_bits(&dst, &src, NULL, NULL, 0xFF, GF_FALSE, NULL, NULL);
+	memcpy(ref, dst.video_buffer, size);
+
+	resize_run = GF_TRUE;
+	th = gf_th_new("StretchResize");
+	gf_th_run(th, resize_threads, NULL);
+	for (i=0; i<200; i++) {
+		memset(dst.video_buffer, 0, size);
+		gf_stretch_bits(&dst, &src, NULL, NULL, 0xFF, GF_FALSE, NULL, NULL);
+		if (memcmp(ref, dst.video_buffer, size)) {
+			fprintf(stderr, "Error: %s stretch differs from single pass while changing the thread settings\n", formats[fmt_idx].name);
+			ok = GF_FALSE;
+			break;
+		}
+	}
+	resize_run = GF_FALSE;
+	gf_th_del(th);
+
+	gf_free(ref);
+	gf_free(dst.video_buffer);
+	gf_free(data);
+	return ok;
+}
+
+static void bench_format(u32 fmt_idx, u32 width, u32 height, u32 nb_frames)
+{
+	GF_VideoSurface src, dst;
+	u8 *data;
+	u32 simd, i;
+
+	data = make_frame(&src, formats[fmt_idx].pixel_format, formats[fmt_idx].ten_bits, width, height);
+	memset(&dst, 0, sizeof(GF_VideoSurface));
+	dst.width = width;
+	dst.height = height;
+	dst.pitch_x = 4;
+	dst.pitch_y = 4*width;
+	dst.pixel_format = GF_PIXEL_RGBA;
+	dst.video_buffer = (char *) gf_malloc(dst.pitch_y * height);
+
+	fprintf(stdout, "%s:", formats[fmt_idx].name);
+	for (simd=GF_COLOR_SIMD_NONE; simd<=GF_COLOR_SIMD_NEON; simd++) {
+		u64 start, time;
+		if (gf_color_set_simd(simd) != simd) continue;
+		start = gf_sys_clock_high_res();
+		for (i=0; i<nb_frames; i++)
+			gf_stretch_bits(&dst, &src, NULL, NULL, 0xFF, GF_FALSE, NULL, NULL);
+		time = gf_sys_clock_high_res() - start;
+		if (!time) time = 1;
+		fprintf(stdout, " %s %.2f Mpix/s", simd_names[simd], ((Double) width) * height * nb_frames / time);
+	}
+	fprintf(stdout, "\n");
+	gf_free(dst.video_buffer);
+	gf_free(data);
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, j, width=1920, height=1080, nb_frames=100, nb_threads=1;
+	Bool check_only = GF_FALSE;
+	Bool ok = GF_TRUE;
+	/*widths exercising the SIMD blocks and the scalar tails*/
+	u32 check_widths[] = {1920, 1366, 130, 46, 18, 17};
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-size") && (i+1<(u32) argc)) {
+			if (sscanf(argv[i+1], "%dx%d", &width, &height) != 2) {
+				usage();
+				return 1;
+			}
+			i++;
+		} else if (!strcmp(arg, "-frames") && (i+1<(u32) argc)) {
+			nb_frames = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-threads") && (i+1<(u32) argc)) {
+			nb_threads = atoi(argv[i+1]);
+			i++;
+		} else if (!strcmp(arg, "-check")) {
+			check_only = GF_TRUE;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (!nb_frames) nb_frames = 1;
+	if ((width<8) || (height<8)) {
+		usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_WARNING);
+	gf_rand_init(GF_TRUE);
+
+	fprintf(stdout, "Best kernels: %s\n", simd_names[gf_color_set_simd(GF_COLOR_SIMD_AUTO)]);
+	for (i=0; i<sizeof(formats)/sizeof(formats[0]); i++) {
+		for (j=0; j<sizeof(check_widths)/sizeof(u32); j++) {
+			if (!check_format(i, check_widths[j], 16)) ok = GF_FALSE;
+		}
+		if (!check_bands(i, 640, 360, 640, 360, GF_FALSE)) ok = GF_FALSE;
+		if (!check_bands(i, 640, 360, 1000, 563, GF_TRUE)) ok = GF_FALSE;
+		if (!check_bands(i, 640, 360, 301, 177, GF_FALSE)) ok = GF_FALSE;
+	}
+	if (!check_resize(0)) ok = GF_FALSE;
+	fprintf(stdout, "Conformance check %s\n", ok ? "passed" : "failed");
+
+	if (ok && !check_only) {
+		gf_stretch_bits_add_threads(nb_threads);
+		for (i=0; i<sizeof(formats)/sizeof(formats[0]); i++)
+			bench_format(i, width, height, nb_frames);
+		gf_stretch_bits_remove_threads(nb_threads);
+	}
+
+	gf_color_set_simd(GF_COLOR_SIMD_AUTO);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
@@ -221,6 +221,7 @@ LOCAL_SRC_FILES := \
 	../../../../src/crypto/g_crypt.c \
 	../../../../src/crypto/g_crypt_openssl.c \
 	../../../../src/crypto/g_crypt_tinyaes.c \
+	../../../../src/crypto/g_crypt_aesni.c \
 	../../../../src/crypto/tiny_aes.c \
 	../../../../src/terminal/scene.c \
 	../../../../src/terminal/terminal.c \
@@ -262,6 +262,44 @@ typedef struct
  */
 GF_Err gf_stretch_bits(GF_VideoSurface *dst, GF_VideoSurface *src, GF_Window *dst_wnd, GF_Window *src_wnd, u8 alpha, Bool flip, GF_ColorKey *colorKey, GF_ColorMatrix * cmat);
 
+/*!\brief registers a user of the stretch threads
+ *
+ * Registers a user of the threads converting a single call to \ref gf_stretch_bits. Large destination windows in system memory are split in horizontal bands converted in parallel by the calling thread and a pool of worker threads shared by all callers.
+ * The pool is sized for the largest number of threads requested by the registered users, and destroyed once the last user is removed. This function may be called while stretches are in progress, these complete with the previous pool.
+ *\param nb_threads number of threads converting a blit, including the calling thread. 0 or 1 registers a user not requesting any worker thread
+ */
+void gf_stretch_bits_add_threads(u32 nb_threads);
+
+/*!\brief unregisters a user of the stretch threads
+ *
+ * Unregisters a user previously registered by \ref gf_stretch_bits_add_threads.
+ *\param nb_threads number of threads given when registering the user
+ */
+void gf_stretch_bits_remove_threads(u32 nb_threads);
+
+/*!SIMD instruction sets used for YUV to RGB conversion*/
+enum
+{
+	/*!scalar conversion*/
+	GF_COLOR_SIMD_NONE = 0,
+	/*!SSE2 kernels*/
+	GF_COLOR_SIMD_SSE2,
+	/*!AVX2 kernels*/
+	GF_COLOR_SIMD_AVX2,
+	/*!NEON kernels*/
+	GF_COLOR_SIMD_NEON,
+	/*!best kernels supported by the build and the CPU*/
+	GF_COLOR_SIMD_AUTO = 0xFF
+};
+
+/*!\brief selects YUV to RGB conversion kernels
+ *
+ * Selects the instruction set used by \ref gf_stretch_bits for YUV to RGB conversion. By default, the best kernels supported by the CPU are used on first conversion.
+ *\param simd_type SIMD type to use. If the type is not available in this build or on this CPU, the best available one is used instead
+ *\return the SIMD type now in use
+ */
+u32 gf_color_set_simd(u32 simd_type);
+
 
 /*!\brief copies YUV 420 10 bits to YUV destination (only YUV420 8 bits supported)
  *
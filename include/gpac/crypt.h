@@ -103,6 +103,43 @@ GF_Err gf_crypt_encrypt(GF_Crypt *gfc, void *plaintext, u32 len);
 /*decryption function. It is almost the same with gf_crypt_generic.*/
 GF_Err gf_crypt_decrypt(GF_Crypt *gfc, void *ciphertext, u32 len);
 
+/*clear / encrypted byte range of a buffer, as used by CENC subsamples*/
+typedef struct
+{
+	/*number of bytes left in the clear before the encrypted bytes*/
+	u32 clear_bytes;
+	/*number of encrypted bytes following the clear bytes*/
+	u32 crypt_bytes;
+} GF_CryptRange;
+
+/*
+batch encryption function: encrypts all ranges of a buffer in place in a single call, the cipher state (CTR counter or CBC chaining) carrying over ranges.
+@data: buffer to encrypt, starting with the first range
+@ranges, @nb_ranges: byte ranges of the buffer
+@crypt_block, @skip_block: pattern encryption in 16-byte blocks (cens and cbcs schemes). If one of them is 0, the ranges are fully encrypted
+@const_IV: if not NULL, 16 bytes IV set before each range with encrypted bytes (cbcs constant IV)
+*/
+GF_Err gf_crypt_encrypt_ranges(GF_Crypt *gfc, u8 *data, const GF_CryptRange *ranges, u32 nb_ranges, u8 crypt_block, u8 skip_block, const u8 *const_IV);
+/*batch decryption function, same as gf_crypt_encrypt_ranges*/
+GF_Err gf_crypt_decrypt_ranges(GF_Crypt *gfc, u8 *data, const GF_CryptRange *ranges, u32 nb_ranges, u8 crypt_block, u8 skip_block, const u8 *const_IV);
+
+/*AES implementations*/
+enum
+{
+	/*OpenSSL if available in this build, tinyAES otherwise*/
+	GF_CRYPT_IMPL_GENERIC = 0,
+	/*built-in AES-NI implementation*/
+	GF_CRYPT_IMPL_AESNI,
+	/*best implementation supported by the build and the CPU*/
+	GF_CRYPT_IMPL_AUTO = 0xFF
+};
+
+/*selects the AES implementation used by contexts opened afterwards. By default, AES-NI is used when supported by the CPU.
+@impl: implementation to use. If not available in this build or on this CPU, the generic one is used instead
+returns the implementation now in use
+*/
+u32 gf_crypt_set_impl(u32 impl);
+
 
 /*! @} */
 
@@ -513,6 +513,12 @@ GF_Err gf_dash_group_set_visible_rect(GF_DashClient *dash, u32 idx, u32 min_x, u
  @use_threads: if true, threads are used to download files*/
 void gf_dash_set_threaded_download(GF_DashClient *dash, Bool use_threads);
 
+/*Sets the number of segment requests kept in flight for each group. Segments following the one being downloaded are
+fetched over parallel connections and added to the cache in order. Pending requests are cancelled upon quality switch or seek.
+ Only independent representations played forward are prefetched. Must be called before the session is started.
+ @depth: number of segments downloaded in parallel per group, 0 or 1 disables prefetching (default)*/
+void gf_dash_set_prefetch_depth(GF_DashClient *dash, u32 depth);
+
 /*Ignores xlink on periods if some adaptation sets are specified in the period with xlink*/
 void gf_dash_ignore_xlink(GF_DashClient *dash, Bool ignore_xlink);
 
@@ -542,6 +542,31 @@ u32 gf_dm_get_data_rate(GF_DownloadManager *dm);
  */
 u32 gf_dm_get_global_rate(GF_DownloadManager *dm);
 
+/*
+ *\brief sets idle connection pool limits
+ *
+ *Sets the limits of the pool of idle keep-alive connections, shared by all sessions of the download manager. A session connecting to a server
+ *reuses an idle connection to the same server and port if any, instead of opening a new one. Defaults are read from the "Downloader" section of the
+ *configuration file (keys "MaxIdleConnections", "MaxIdleConnectionsPerHost" and "IdleConnectionTimeout").
+ *\param dm the download manager object
+ *\param max_idle maximum number of idle connections. If 0, connections are never reused across sessions
+ *\param max_idle_per_host maximum number of idle connections to the same server. If 0, only max_idle applies
+ *\param idle_timeout time in milliseconds after which an idle connection is closed
+ */
+void gf_dm_set_connection_pool(GF_DownloadManager *dm, u32 max_idle, u32 max_idle_per_host, u32 idle_timeout);
+
+/*
+ *\brief gets idle connection pool statistics
+ *
+ *Gets the statistics of the idle connection pool. All parameters may be NULL.
+ *\param dm the download manager object
+ *\param nb_idle number of idle connections currently in the pool
+ *\param nb_hits number of connections reused from the pool
+ *\param nb_misses number of connections opened because no idle connection was available
+ *\param nb_evicted number of idle connections closed because of timeout, limits or server close
+ */
+void gf_dm_get_connection_pool_stats(GF_DownloadManager *dm, u32 *nb_idle, u32 *nb_hits, u32 *nb_misses, u32 *nb_evicted);
+
 
 /*
  *\brief fetches remote file in memory
@@ -618,6 +618,9 @@ void gf_rtp_reset_buffers(GF_RTPChannel *ch);
 /*read any data on UDP only (not valid for TCP). Performs re-ordering if configured for it
 returns amount of data read (raw UDP packet size)*/
 u32 gf_rtp_read_rtp(GF_RTPChannel *ch, char *buffer, u32 buffer_size);
+/*same as above without copy: returns the next packet or NULL if none. Packets are fetched from the network in batches;
+the returned packet belongs to the channel and is valid until the next read or reset*/
+char *gf_rtp_read_rtp_packet(GF_RTPChannel *ch, u32 *pck_size);
 u32 gf_rtp_read_rtcp(GF_RTPChannel *ch, char *buffer, u32 buffer_size);
 
 /*decodes an RTP packet and gets the beginning of the RTP payload*/
@@ -644,6 +647,11 @@ GF_Err gf_rtp_send_bye(GF_RTPChannel *ch,
 write the header in place*/
 GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, char *pck, u32 pck_size, Bool fast_send);
 
+/*send a burst of RTP packets, using a single system call when possible. Headers are written in a channel buffer
+and the payloads are not copied. Sender report info is updated and RTCP checked once for the whole burst.
+Packets are checked before sending; if sending fails, the packets before the failing one have been sent*/
+GF_Err gf_rtp_send_packets(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdrs, char **pcks, u32 *pck_sizes, u32 nb_pcks);
+
 enum
 {
 	GF_RTCP_INFO_NAME = 0,
@@ -564,6 +564,8 @@ struct __tag_compositor
 #endif
 
 	Bool texture_from_decoder_memory;
+	/*number of threads registered to the shared stretch pool, 0 if not registered*/
+	u32 stretch_threads;
 
 	u32 networks_time;
 	u32 decoders_time;
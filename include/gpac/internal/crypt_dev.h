@@ -38,7 +38,7 @@ struct _gf_crypt_context
 	GF_CRYPTO_ALGO algo; //single value for now
 	GF_CRYPTO_MODE mode; //CBC or CTR
 
-	/* Internal context for openSSL or tiny AES*/
+	/* Internal context for openSSL, tiny AES or AES-NI*/
 	void *context;
 
 	//ptr to encryption function
@@ -58,6 +58,10 @@ GF_Err gf_crypt_open_open_openssl(GF_Crypt* td, GF_CRYPTO_MODE mode);
 GF_Err gf_crypt_open_open_tinyaes(GF_Crypt* td, GF_CRYPTO_MODE mode);
 #endif
 
+/*built-in AES-NI implementation, GF_NOT_SUPPORTED if not available in this build or on this CPU*/
+GF_Err gf_crypt_open_open_aesni(GF_Crypt* td, GF_CRYPTO_MODE mode);
+Bool gf_crypt_aesni_supported();
+
 
 #ifdef __cplusplus
 }
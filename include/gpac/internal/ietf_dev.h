@@ -59,8 +59,30 @@ typedef struct __PRO_item
 	u32 pck_seq_num;
 	void *pck;
 	u32 size;
+	/*allocated size of the packet, stored right after the item*/
+	u32 alloc_size;
 } GF_POItem;
 
+/*pool of packet buffers shared by the network reception and the reorderer, so that received packets
+are queued without allocation nor copy*/
+typedef struct
+{
+	GF_POItem *free_items;
+	u32 pck_size;
+	u32 nb_free, max_free;
+} GF_RTPPacketPool;
+
+/* creates new packet pool
+	@pck_size: size of the pooled packets
+	@max_free: max number of unused packets kept in the pool. 0 means no limit
+*/
+GF_RTPPacketPool *gf_rtp_packet_pool_new(u32 pck_size, u32 max_free);
+void gf_rtp_packet_pool_del(GF_RTPPacketPool *pool);
+/*gets a packet of at least size bytes, pool->pck_size if size is 0. Larger packets are not pooled*/
+char *gf_rtp_packet_pool_get(GF_RTPPacketPool *pool, u32 size);
+/*gives back a packet obtained through gf_rtp_packet_pool_get or gf_rtp_reorderer_get_packet*/
+void gf_rtp_packet_pool_release(GF_RTPPacketPool *pool, char *pck);
+
 typedef struct __PO
 {
 	struct __PRO_item *in;
@@ -69,6 +91,8 @@ typedef struct __PO
 	u32 MaxCount;
 	u32 IsInit;
 	u32 MaxDelay, LastTime;
+	GF_RTPPacketPool *pool;
+	Bool own_pool;
 } GF_RTPReorder;
 
 /* creates new RTP reorderer
@@ -79,12 +103,23 @@ GF_RTPReorder *gf_rtp_reorderer_new(u32 MaxCount, u32 MaxDelay);
 void gf_rtp_reorderer_del(GF_RTPReorder *po);
 /*reset the Queue*/
 void gf_rtp_reorderer_reset(GF_RTPReorder *po);
+/*sets the packet pool used by the queue, resetting it. The pool must outlive the queue*/
+void gf_rtp_reorderer_set_pool(GF_RTPReorder *po, GF_RTPPacketPool *pool);
 
 /*Adds a packet to the queue. Packet Data is memcopied*/
 GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u32 pck_seqnum);
 /*gets the output of the queue. Packet Data IS YOURS to delete*/
 void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size);
+/*Adds a packet obtained from the queue pool to the queue, without copy. The packet now belongs to the queue*/
+GF_Err gf_rtp_reorderer_add_packet(GF_RTPReorder *po, char *pck, u32 pck_size, u32 pck_seqnum);
+/*gets the output of the queue without copy. The packet must be given back to the queue pool*/
+char *gf_rtp_reorderer_get_packet(GF_RTPReorder *po, u32 *pck_size);
+
 
+/*max number of packets fetched per socket read*/
+#define GF_RTP_RX_BATCH	32
+/*size of the packets in the reception pool, enough for jumbo frames. Larger packets are dropped*/
+#define GF_RTP_RX_PCK_SIZE	9216
 
 /*the RTP channel with both RTP and RTCP sockets and buffers
 each channel is identified by a control string given in RTSP Describe
@@ -104,6 +139,15 @@ struct __tag_rtp_channel
 	max latency at the reordering queue*/
 	GF_RTPReorder *po;
 
+	/*pool of received packets, shared with the reorderer*/
+	GF_RTPPacketPool *rx_pool;
+	/*packets of the last reception batch, consumed from rx_pos*/
+	char *rx_pcks[GF_RTP_RX_BATCH];
+	u32 rx_sizes[GF_RTP_RX_BATCH];
+	u32 rx_nb, rx_pos;
+	/*packet returned by gf_rtp_read_rtp_packet, released at the next read*/
+	char *rx_pck;
+
 	/*RTCP report times*/
 	u32 last_report_time;
 	u32 next_report_time;
@@ -129,6 +173,10 @@ struct __tag_rtp_channel
 	/*static buffer for RTP sending*/
 	char *send_buffer;
 	u32 send_buffer_size;
+	/*headers and datagrams for batched RTP sending*/
+	char *batch_hdrs;
+	GF_SockDatagram *batch_dgrams;
+	u32 batch_alloc;
 	u32 pck_sent_since_last_sr;
 	u32 last_pck_ts;
 	u32 last_pck_ntp_sec, last_pck_ntp_frac;
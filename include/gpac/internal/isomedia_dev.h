@@ -1009,6 +1009,8 @@ typedef struct
 	u32 r_FirstSampleInEntry;
 	u32 r_currentEntryIndex;
 	u64 r_CurrentDTS;
+	/*random access index of the parent sample table if enabled, owned by the sample table*/
+	struct __sample_table_index *r_index;
 } GF_TimeToSampleBox;
 
 
@@ -1732,6 +1734,24 @@ typedef struct
 	u32 *sample_num;
 } GF_TrafToSampleMap;
 
+/*number of samples between two cumulated size checkpoints of the sample table index*/
+#define GF_ISOM_SAMPLE_INDEX_SIZE_STEP	32
+
+/*random access index of a sample table, lazily built in read mode - see gf_isom_set_sample_index_mode*/
+typedef struct __sample_table_index
+{
+	/*first sample number of each stsc entry*/
+	u32 *stsc_first_sample;
+	u32 nb_stsc;
+	/*first sample number and DTS of each stts entry*/
+	u32 *stts_first_sample;
+	u64 *stts_first_dts;
+	u32 nb_stts;
+	/*size_checkpoints[i] is the cumulated size of the first i*GF_ISOM_SAMPLE_INDEX_SIZE_STEP samples*/
+	u64 *size_checkpoints;
+	u32 nb_size_checkpoints, size_sample_count;
+} GF_SampleTableIndex;
+
 typedef struct
 {
 	GF_ISOM_BOX
@@ -1767,6 +1787,9 @@ typedef struct
 	u32 currentEntryIndex;
 
 	Bool no_sync_found;
+
+	/*random access index, NULL if disabled*/
+	GF_SampleTableIndex *sample_index;
 } GF_SampleTableBox;
 
 void stbl_AppendTrafMap(GF_SampleTableBox *stbl);
@@ -3379,6 +3402,9 @@ enum
 	GF_ISOM_DATA_MAP_READ_ONLY = 4,
 	/*write-only access at the end of the movie - only used for movie fragments concatenation*/
 	GF_ISOM_DATA_MAP_CAT = 5,
+	/*read-only access to the movie file through a memory mapping of the complete file, falls back to
+	regular file IO if mapping fails. Mode is set to GF_ISOM_DATA_MAP_READ afterwards*/
+	GF_ISOM_DATA_MAP_READ_MMAP = 6,
 };
 
 /*this is the DataHandler structure each data handler has its own bitstream*/
@@ -3405,6 +3431,15 @@ typedef struct
 #endif
 } GF_FileDataMap;
 
+/*memory mapping of a file, shared between the data map and the sample references handed to the user.
+The mapping is released when the data map is destroyed and all references are released*/
+struct __tag_isom_map_token
+{
+	char *byte_map;
+	u64 size;
+	u32 ref_count;
+};
+
 /*file mapping handler. used if supported, only on read mode for complete files  (not in file download)*/
 typedef struct
 {
@@ -3413,6 +3448,7 @@ typedef struct
 	u64 file_size;
 	char *byte_map;
 	u64 byte_pos;
+	GF_ISOMapToken *token;
 } GF_FileMappingDataMap;
 
 GF_Err gf_isom_datamap_new(const char *location, const char *parentPath, u8 mode, GF_DataMap **outDataMap);
@@ -3434,6 +3470,8 @@ GF_DataMap *gf_isom_fdm_new_temp(const char *sTempPath);
 GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode);
 void gf_isom_fmo_del(GF_FileMappingDataMap *ptr);
 u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, char *buffer, u32 bufferLength, u64 fileOffset);
+/*adds a reference to the mapping and returns it*/
+GF_ISOMapToken *gf_isom_fmo_ref(GF_FileMappingDataMap *ptr);
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 u64 gf_isom_datamap_get_offset(GF_DataMap *map);
@@ -3592,7 +3630,9 @@ Bool IsMP4Description(u32 entryType);
 GF_Err Track_FindRef(GF_TrackBox *trak, u32 ReferenceType, GF_TrackReferenceTypeBox **dpnd);
 /*Time and sample*/
 GF_Err GetMediaTime(GF_TrackBox *trak, Bool force_non_empty, u64 movieTime, u64 *MediaTime, s64 *SegmentStartTime, s64 *MediaOffset, u8 *useEdit, u64 *next_edit_start_plus_one);
-GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sampleDescriptionIndex, Bool no_data, u64 *out_offset);
+/*gets sample info and data. If ext_realloc is set, the sample data buffer is owned by the caller and only reallocated if
+smaller than needed, its allocated size being tracked in alloc_size*/
+GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sampleDescriptionIndex, Bool no_data, u64 *out_offset, Bool ext_realloc);
 GF_Err Media_CheckDataEntry(GF_MediaBox *mdia, u32 dataEntryIndex);
 GF_Err Media_FindSyncSample(GF_SampleTableBox *stbl, u32 searchFromTime, u32 *sampleNumber, u8 mode);
 GF_Err Media_RewriteODFrame(GF_MediaBox *mdia, GF_ISOSample *sample);
@@ -3626,6 +3666,9 @@ GF_Err stbl_GetSampleRAP(GF_SyncSampleBox *stss, u32 SampleNumber, SAPType *IsRA
 /*same as above but only look for open-gop RAPs and GDR (roll)*/
 GF_Err stbl_SearchSAPs(GF_SampleTableBox *stbl, u32 SampleNumber, SAPType *IsRAP, u32 *prevRAP, u32 *nextRAP);
 GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *chunkNumber, u32 *descIndex, GF_StscEntry **scsc_entry);
+/*resets the random access index of the sample table, if any, after its tables have been modified*/
+void stbl_reset_sample_index(GF_SampleTableBox *stbl);
+void stbl_del_sample_index(GF_SampleTableIndex *idx);
 GF_Err stbl_GetSampleShadow(GF_ShadowSyncBox *stsh, u32 *sampleNumber, u32 *syncNum);
 GF_Err stbl_GetPaddingBits(GF_PaddingBitsBox *padb, u32 SampleNumber, u8 *PadBits);
 GF_Err stbl_GetSampleDepType(GF_SampleDependencyTypeBox *stbl, u32 SampleNumber, u32 *isLeading, u32 *dependsOn, u32 *dependedOn, u32 *redundant);
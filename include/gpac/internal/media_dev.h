@@ -43,6 +43,21 @@ void gf_media_get_sample_average_infos(GF_ISOFile *file, u32 Track, u32 *avgSize
 GF_Err gf_import_message(GF_MediaImporter *import, GF_Err e, char *format, ...);
 #endif /*GPAC_DISABLE_MEDIA_IMPORT*/
 
+/*SIMD types used for NAL unit start code and emulation prevention byte scanning*/
+enum
+{
+	GF_NALU_SIMD_NONE = 0,
+	GF_NALU_SIMD_SSE2,
+	GF_NALU_SIMD_AVX2,
+	/*best type supported by the build and the CPU, default*/
+	GF_NALU_SIMD_AUTO = 0xFF
+};
+/*selects the NAL unit scanning code. If the type is not available, the best available one is used. Returns the type now in use*/
+u32 gf_media_nalu_set_simd(u32 simd_type);
+
+/*returns the offset of the first two consecutive zero bytes in data, or data_len if none*/
+u32 gf_media_nalu_next_zero_pair(const u8 *data, u32 data_len);
+
 #ifndef GPAC_DISABLE_AV_PARSERS
 
 u32 gf_latm_get_value(GF_BitStream *bs);
@@ -37,13 +37,6 @@ typedef struct
 	u32 dummy;
 } GF_MPD_Metrics;
 
-/*TODO*/
-typedef struct
-{
-	u32 dummy;
-} GF_MPD_ContentComponent;
-
-
 //some elments are typically overloaded in XML, we keep the attributes / childrne nodes here. The attributes list is NULL if no extensions were found, otherwise it is a list of @GF_XMLAttribute.
 //The children list is NULL if no extensions were found, otherwise it is a list of @GF_XMLNode
 #define MPD_EXTENSIBLE	\
@@ -114,6 +107,19 @@ typedef struct
 	u32 num, den;
 } GF_MPD_Fractional;
 
+typedef struct
+{
+	u32 id;
+	char *lang;
+	char *content_type;
+	GF_MPD_Fractional *par;
+
+	GF_List *accessibility;
+	GF_List *role;
+	GF_List *rating;
+	GF_List *viewpoint;
+} GF_MPD_ContentComponent;
+
 typedef struct
 {
 	u32 trackID;
@@ -388,6 +394,14 @@ typedef struct {
 
 GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url);
 GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url);
+/*loads an MPD file using SAX parsing, without building the XML DOM*/
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *base_url);
+
+/*merges a SegmentTimeline update in a timeline: segments of the update after the end of the timeline are appended to the timeline
+(entries may be moved from the update), segments of the timeline no longer present in the update are removed. nb_new_segments is
+set to the number of segments appended. Returns GF_NOT_SUPPORTED if the timelines cannot be merged (open-ended entries or
+non-contiguous timelines), in which case the timeline is left untouched*/
+GF_Err gf_mpd_segment_timeline_merge(GF_MPD_SegmentTimeline *timeline, GF_MPD_SegmentTimeline *update, u32 *nb_new_segments);
 
 GF_MPD *gf_mpd_new();
 void gf_mpd_del(GF_MPD *mpd);
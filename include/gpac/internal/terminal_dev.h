@@ -346,6 +346,8 @@ enum
 	GF_TERM_THREAD_SINGLE,
 	/*all media (image, video, audio) decoders are threaded*/
 	GF_TERM_THREAD_MULTI,
+	/*all media (video, audio) decoders are tasks scheduled on a pool of worker threads*/
+	GF_TERM_THREAD_POOL,
 };
 
 enum
@@ -355,7 +357,10 @@ enum
 	GF_TERM_SINGLE_THREAD = 1<<22,
 	GF_TERM_MULTI_THREAD = 1<<23,
 	GF_TERM_DROP_LATE_FRAMES = 1<<24,
-	GF_TERM_SINGLE_CLOCK = 1<<25
+	GF_TERM_SINGLE_CLOCK = 1<<25,
+	GF_TERM_POOL_THREAD = 1<<26,
+	/*composition buffers of threaded decoders are single-producer single-consumer lock-free queues*/
+	GF_TERM_LOCK_FREE_CB = 1<<27
 };
 
 /*URI relocators are used for containers like zip or ISO FF with file items. The relocator
@@ -419,6 +424,14 @@ struct _tag_terminal
 	u32 cumulated_priority;
 	/*frame duration*/
 	u32 frame_duration;
+	/*decoder worker pool, created when decoders are scheduled as tasks*/
+	struct _decoder_pool *dec_pool;
+	/*signals the media manager thread when one of its decoders may have work to do*/
+	GF_Semaphore *mm_wake;
+	/*set atomically, see mm_signal*/
+	u32 mm_wake_pending;
+	/*protects changes of the codec list and of the codec semaphores against wake notifications. Never held while decoding*/
+	GF_Mutex *mm_wake_mx;
 
 	/*net services*/
 	GF_List *net_services;
@@ -504,6 +517,10 @@ void gf_term_start_codec(GF_Codec *codec, Bool is_resume);
 void gf_term_stop_codec(GF_Codec *codec, u32 reason);
 void gf_term_set_threading(GF_Terminal *term, u32 mode);
 void gf_term_set_priority(GF_Terminal *term, s32 Priority);
+/*signals the media manager that the codec may have new work to do (composition memory released or new AU received)*/
+void gf_term_wake_codec(GF_Codec *codec);
+/*signals the media manager thread, for instance when buffering is done*/
+void gf_term_wake_scheduler(GF_Terminal *term);
 
 
 Bool gf_term_forward_event(GF_Terminal *term, GF_Event *evt, Bool consumed, Bool forward_only);
@@ -207,6 +207,13 @@ GF_Err gf_decrypt_file(GF_ISOFile *mp4file, const char *drm_file);
 */
 GF_Err gf_crypt_file(GF_ISOFile *mp4file, const char *drm_file);
 
+/*Crypt a the file using several threads, producing the same file as gf_crypt_file
+@drm_file: location of DRM data.
+@nb_threads: number of threads to use. CENC tracks are encrypted in parallel, and samples of a track are encrypted
+in parallel except for CBC schemes with per-sample IVs. 0 or 1 means no threading
+*/
+GF_Err gf_crypt_file_ex(GF_ISOFile *mp4file, const char *drm_file, u32 nb_threads);
+
 #endif /*!defined(GPAC_DISABLE_MCRYPT) && !defined(GPAC_DISABLE_ISOM_WRITE)*/
 
 /*! @} */
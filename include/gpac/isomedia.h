@@ -81,6 +81,10 @@ enum
 	GF_ISOM_WRITE_EDIT,
 	/*Opens an existing file for fragment concatenation*/
 	GF_ISOM_OPEN_CAT_FRAGMENTS,
+	/*Opens a file in READ ONLY mode, mapping the complete file in memory when supported by the platform.
+	Sample data can then be accessed without copy through gf_isom_get_sample_ref. The file shall not be modified
+	or truncated while opened*/
+	GF_ISOM_OPEN_READ_MMAP,
 };
 
 /*Movie Options for file writing*/
@@ -512,6 +516,9 @@ enum
 /*the isomedia file*/
 typedef struct __tag_isom GF_ISOFile;
 
+/*reference to the memory mapping of a file opened with GF_ISOM_OPEN_READ_MMAP*/
+typedef struct __tag_isom_map_token GF_ISOMapToken;
+
 /*Random Access Point flag*/
 typedef enum {
 	RAP_REDUNDANT = -1,
@@ -540,6 +547,8 @@ typedef struct
 	/*number of packed samples in this sample. If 0 or 1, only 1 sample is present
 	only used for constant size and constant duration samples*/
 	u32 nb_pack;
+	/*allocated size of data when the sample buffer is reused by gf_isom_get_sample_ex, 0 otherwise*/
+	u32 alloc_size;
 } GF_ISOSample;
 
 
@@ -766,11 +775,25 @@ reads more data than available. This sets the amount of extra bytes to allocate
 NOTE: the dataLength of the sample does NOT include padding*/
 GF_Err gf_isom_set_sample_padding(GF_ISOFile *the_file, u32 trackNumber, u32 padding_bytes);
 
+/*enables or disables the random access index of the track sample table. When enabled, per-chunk and per-time entry
+checkpoints are lazily built on the first access, so that fetching a sample or looking up a time costs O(log(N)) whatever
+the previous position in the track, rather than walking the tables from the last accessed (or first) entry. This is
+useful for backward or random seeking and when several readers access the same track in parallel.
+Only available for files opened in read mode*/
+GF_Err gf_isom_set_sample_index_mode(GF_ISOFile *the_file, u32 trackNumber, Bool use_index);
+
 /*return a sample given its number, and set the StreamDescIndex of this sample
 this index allows to retrieve the stream description if needed (2 media in 1 track)
 return NULL if error*/
 GF_ISOSample *gf_isom_get_sample(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *StreamDescriptionIndex);
 
+/*same as gf_isom_get_sample but fills the caller-owned @static_sample, whose data buffer is only reallocated when
+smaller than the sample (plus padding) and is otherwise reused across calls. The allocated size is kept in alloc_size.
+The sample is not destroyed on error, and its data buffer shall be freed by the caller (gf_isom_sample_del does so).
+@data_offset (optional): set to sample start offset in file.
+return @static_sample, or NULL if error*/
+GF_ISOSample *gf_isom_get_sample_ex(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *StreamDescriptionIndex, GF_ISOSample *static_sample, u64 *data_offset);
+
 /*same as gf_isom_get_sample but doesn't fetch media data
 @StreamDescriptionIndex (optional): set to stream description index
 @data_offset (optional): set to sample start offset in file.
@@ -780,6 +803,22 @@ retrieved (faster)
 */
 GF_ISOSample *gf_isom_get_sample_info(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *StreamDescriptionIndex, u64 *data_offset);
 
+/*same as gf_isom_get_sample but returns the sample data in place in the file mapping, without allocation or copy.
+The file must have been opened with GF_ISOM_OPEN_READ_MMAP, and the sample must be stored in the file itself
+(no external data reference).
+@samp: sample structure allocated by the caller and filled by the function. samp->data points to the mapped
+sample bytes and shall not be modified nor freed. Data is returned as stored in the file: OD frames and NALU-based samples
+are not rewritten, padding bytes are not added and sample packing is ignored.
+@StreamDescriptionIndex (optional): set to stream description index
+@data_offset (optional): set to sample start offset in file
+@token: set to a reference to the file mapping, keeping samp->data valid (even after the file is closed) until
+gf_isom_sample_ref_release is called on the token. Each successfull call must be matched by one release.
+returns GF_NOT_SUPPORTED if the sample data is not mapped in memory*/
+GF_Err gf_isom_get_sample_ref(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, GF_ISOSample *samp, u32 *StreamDescriptionIndex, u64 *data_offset, GF_ISOMapToken **token);
+
+/*releases a reference obtained through gf_isom_get_sample_ref. This function is thread-safe*/
+void gf_isom_sample_ref_release(GF_ISOMapToken *token);
+
 /*retrieves given sample DTS*/
 u64 gf_isom_get_sample_dts(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber);
 
@@ -965,6 +965,14 @@ GF_Err gf_dasher_set_cues(GF_DASHSegmenter *dasher, const char *cues_file, Bool
  */
 GF_Err gf_dasher_set_isobmff_options(GF_DASHSegmenter *dasher, Bool mvex_after_traks, Bool sdtp_in_traf);
 
+/*!
+ Sets the number of threads used to segment the representations of an adaptation set in parallel. The MPD description of each representation is written in input order once all representations are segmented, so that the output is identical to sequential segmentation. Parallel segmentation is not used when a DASH context is used, since the context is shared by all representations.
+ *	\param dasher the DASH segmenter object
+ *	\param nb_threads number of threads to use, including the calling thread. 0 or 1 disables parallel segmentation
+ *	\return error code if any
+ */
+GF_Err gf_dasher_set_threads(GF_DASHSegmenter *dasher, u32 nb_threads);
+
 /*!
  Adds a media input to the DASHer
  *	\param dasher the DASH segmenter object
@@ -336,6 +336,9 @@ enum
 	GF_M2TS_PES_FRAMING_DEFAULT,
 	/*same as defualt PES framing but forces nal-per-nal dispatch for AVC/HEVC (default mode may dispatch complete frames)*/
 	GF_M2TS_PES_FRAMING_DEFAULT_NAL,
+	/*scatter-gather mode: PES packets are not reassembled, the payload of each transport packet is passed by reference
+	through GF_M2TS_EVT_PES_SLICES events*/
+	GF_M2TS_PES_FRAMING_SLICES,
 };
 
 /*PES packet flags*/
@@ -353,6 +356,19 @@ enum
 	GF_M2TS_PES_PCK_DISCONTINUITY = 1<<5
 };
 
+/*PES slices flags*/
+enum
+{
+	/*first slices of the PES packet, the first slice starts with the PES header*/
+	GF_M2TS_PES_SLICES_START = 1,
+	/*last slices of the PES packet*/
+	GF_M2TS_PES_SLICES_END = 1<<1,
+	/*random access indicator was set in one of the transport packets*/
+	GF_M2TS_PES_SLICES_RAP = 1<<2,
+	/*PES packet is lost (continuity error), slices previously received for this PES shall be discarded - no slices are passed*/
+	GF_M2TS_PES_SLICES_DISCARD = 1<<3,
+};
+
 /*Events used by the MPEGTS demuxer*/
 enum
 {
@@ -382,6 +398,8 @@ enum
 	GF_M2TS_EVT_INT_UPDATE,
 	/*PES packet has been received - assoctiated parameter: PES packet*/
 	GF_M2TS_EVT_PES_PCK,
+	/*PES payload slices have been received in scatter-gather mode - associated parameter: GF_M2TS_PES_SLICES*/
+	GF_M2TS_EVT_PES_SLICES,
 	/*PCR has been received - associated parameter: PES packet with no data*/
 	GF_M2TS_EVT_PES_PCR,
 	/*PTS/DTS/PCR info - assoctiated parameter: PES packet with no data*/
@@ -698,6 +716,13 @@ typedef struct tag_m2ts_metadata_descriptor {
 	u8 decoder_config_service_id;
 } GF_M2TS_MetadataDescriptor;
 
+/*reference to the payload of a transport packet*/
+typedef struct
+{
+	const u8 *data;
+	u32 size;
+} GF_M2TS_PESSlice;
+
 /*MPEG-2 TS ES object*/
 typedef struct tag_m2ts_pes
 {
@@ -765,6 +790,15 @@ typedef struct tag_m2ts_pes
 	//last decoded temi (may be one ahead of time as the last received TEMI)
 	GF_M2TS_TemiTimecodeDescriptor temi_tc;
 	Bool temi_pending;
+
+	/*scatter-gather mode: payload slices of the current PES received during the current gf_m2ts_process_data call*/
+	GF_M2TS_PESSlice *slices;
+	u32 nb_slices, nb_alloc_slices;
+	/*GF_M2TS_PES_SLICES_* flags of the pending slices*/
+	u32 slices_flags;
+	/*next PES with pending slices*/
+	struct tag_m2ts_pes *next_pending;
+	Bool slices_pending;
 } GF_M2TS_PES;
 
 /*SDT information object*/
@@ -888,6 +922,22 @@ typedef struct
 	GF_M2TS_PES *stream;
 } GF_M2TS_PES_PCK;
 
+/*PES slices in scatter-gather mode. The slices point to the transport packets passed to gf_m2ts_process_data (or to the demuxer
+partial packet buffer) and are only valid during the callback. Slices are dispatched when the PES packet ends and at the end of each
+gf_m2ts_process_data call, so a PES packet may be dispatched in several events. Slices cover the complete PES packet, including the PES header*/
+typedef struct
+{
+	GF_M2TS_PESSlice *slices;
+	u32 nb_slices;
+	/*GF_M2TS_PES_SLICES_* flags*/
+	u32 flags;
+	/*only set with GF_M2TS_PES_SLICES_START: timing and size of the PES header, 0 if the header could not be parsed from the slices*/
+	u64 PTS, DTS;
+	u32 hdr_size;
+	/*parent stream*/
+	GF_M2TS_PES *stream;
+} GF_M2TS_PES_SLICES;
+
 /*MPEG-4 SL packet from MPEG-2 TS*/
 typedef struct
 {
@@ -956,9 +1006,16 @@ struct tag_m2ts_demux
 	/*private user data*/
 	void *user;
 
-	/*private resync buffer*/
-	char *buffer;
-	u32 buffer_size, alloc_size;
+	/*private partial packet buffer, holds the end of the input data when not aligned on packets - at most 191 bytes are kept*/
+	u8 partial_pck[192];
+	u32 partial_size;
+	/*set if partial_pck starts with a packet, otherwise holds unsynchronized data*/
+	Bool partial_synced;
+	/*PES with slices pending dispatch in scatter-gather mode*/
+	GF_M2TS_PES *pending_slices;
+	/*PID filtering: one bit per PID, packets of other PIDs are skipped before being parsed*/
+	Bool pid_filter;
+	u32 pid_interest[GF_M2TS_MAX_STREAMS/32];
 	/*default transport PID filters*/
 	GF_M2TS_SectionFilter *pat, *cat, *nit, *sdt, *eit, *tdt_tot;
 
@@ -1026,6 +1083,12 @@ Bool gf_m2ts_crc32_check(char *data, u32 len);
 /*aborts parsing of the current data (typically needed when parsing done by a different thread). If force_reset_pes is set, all pending pes data is discarded*/
 void gf_m2ts_abort_parsing(GF_M2TS_Demuxer *ts, Bool force_reset_pes);
 
+/*sets interest for a PID. Once set, PID filtering is enabled and packets of PIDs without interest are discarded before
+any parsing (no PCR, continuity or table processing). The PAT and PMT PIDs are always processed*/
+void gf_m2ts_set_pid_interest(GF_M2TS_Demuxer *ts, u32 pid, Bool interest);
+/*disables PID filtering*/
+void gf_m2ts_reset_pid_interest(GF_M2TS_Demuxer *ts);
+
 
 typedef struct
 {
@@ -1214,6 +1277,19 @@ typedef struct __m2ts_mux_stream {
 	u32 last_aac_time;
 	/*list of GF_M2TSDescriptor to add to the MPEG-2 stream. By default set to NULL*/
 	GF_List *loop_descriptors;
+
+	/*scheduler state: 1-based position in the muxer heap (0 if the stream is polled), rank in the muxer
+	stream order and next polled stream*/
+	u32 sched_pos, sched_order;
+	struct __m2ts_mux_stream *sched_next;
+	/*input is flushed by the program preparation thread*/
+	Bool prep_by_thread;
+	/*set by the program thread when the last input flush produced no AU, or when the input is over*/
+	volatile Bool prep_starved, prep_eos;
+	/*number of AUs received from input, number of AUs the muxer would have fetched if flushing the input itself,
+	number of AUs consumed by the muxer and number of AUs received when the input was over*/
+	volatile u32 prep_nb_au_in, prep_nb_au_fetched;
+	u32 prep_nb_au_out, prep_nb_au_at_eos;
 } GF_M2TS_Mux_Stream;
 
 enum {
@@ -1263,6 +1339,12 @@ struct __m2ts_mux_program {
 	Bool mpeg4_signaling_for_scene_only;
 
 	char *name, *provider;
+
+	/*PES preparation thread, pulling input AUs ahead of the muxer*/
+	GF_Thread *prep_th;
+	GF_Mutex *prep_mx;
+	GF_Semaphore *prep_sema, *prep_ready_sema;
+	Bool prep_idle, prep_wake, prep_mux_waiting, prep_exit;
 };
 
 enum
@@ -1339,6 +1421,16 @@ struct __m2ts_mux {
 	Bool flush_pes_at_rap;
 	/*cf enum above*/
 	u32 force_pat_pmt_state;
+
+	/*stream scheduling: streams with a PES in progress are kept in a min-heap on their next packet time,
+	other streams are polled at each packet*/
+	Bool linear_scheduling;
+	Bool sched_reset;
+	GF_M2TS_Mux_Stream **sched_heap;
+	u32 sched_nb, sched_alloc, sched_nb_streams;
+	GF_M2TS_Mux_Stream *sched_polled;
+	/*number of AUs prepared ahead by program threads, 0 if disabled*/
+	u32 prep_nb_au;
 };
 
 
@@ -1367,12 +1459,20 @@ void gf_m2ts_mux_update_config(GF_M2TS_Mux *mux, Bool reset_time);
 GF_M2TS_Mux_Program *gf_m2ts_mux_program_find(GF_M2TS_Mux *muxer, u32 program_number);
 
 const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_next);
+/*writes up to nb_max_pck 188-byte packets in buffer, stopping early when no packet can be sent yet or at end of stream.
+nb_pck is set to the number of packets written, status to the state of the last packet (or of the last call if none was written)*/
+GF_Err gf_m2ts_mux_process_burst(GF_M2TS_Mux *muxer, u8 *buffer, u32 nb_max_pck, u32 *nb_pck, u32 *status, u32 *usec_till_next);
 u32 gf_m2ts_get_sys_clock(GF_M2TS_Mux *muxer);
 u32 gf_m2ts_get_ts_clock(GF_M2TS_Mux *muxer);
 
 GF_Err gf_m2ts_mux_use_single_au_pes_mode(GF_M2TS_Mux *muxer, GF_M2TS_PackMode au_pes_mode);
 GF_Err gf_m2ts_mux_set_initial_pcr(GF_M2TS_Mux *muxer, u64 init_pcr_value);
 GF_Err gf_m2ts_mux_enable_pcr_only_packets(GF_M2TS_Mux *muxer, Bool enable_forced_pcr);
+/*uses a linear scan of all streams instead of the scheduling heap to pick the next packet - output is identical, mostly for testing*/
+GF_Err gf_m2ts_mux_enable_linear_scheduling(GF_M2TS_Mux *muxer, Bool enable);
+/*starts one thread per program fetching up to nb_au_ahead AUs ahead of the muxer on push-mode streams, 0 stops the threads.
+Packet interleaving stays on the calling thread, output is identical. Must be called once all programs and streams are declared*/
+GF_Err gf_m2ts_mux_enable_program_threads(GF_M2TS_Mux *muxer, u32 nb_au_ahead);
 
 /*user interface functions*/
 GF_Err gf_m2ts_program_stream_update_ts_scale(GF_ESInterface *_self, u32 time_scale);
@@ -302,6 +302,33 @@ GF_Err gf_sk_connect(GF_Socket *sock, const char *peer_name, u16 port, const cha
  *\param length the data length to send
  */
 GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length);
+/*!
+ *\brief datagram descriptor
+ *
+ *Describes one datagram for batched emission, made of an optional header followed by the payload. Both buffers are sent as a single datagram without being copied.
+ */
+typedef struct
+{
+	/*! header of the datagram, may be NULL*/
+	const char *header;
+	/*! size of the header*/
+	u32 header_size;
+	/*! payload of the datagram*/
+	const char *data;
+	/*! size of the payload*/
+	u32 size;
+} GF_SockDatagram;
+/*!
+ *\brief batched data emission
+ *
+ *Sends several datagrams on the socket, using as few system calls as possible (sendmmsg on Linux, one call per datagram otherwise). The socket must be in a bound or connected mode. For TCP sockets, the datagrams are sent one after the other.
+ *\param sock the socket object
+ *\param dgrams the datagrams to send
+ *\param nb_dgrams the number of datagrams to send
+ *\param nb_sent set to the number of datagrams actually sent (may be NULL)
+ *\return error if any. If an error occurs, the first nb_sent datagrams have been sent and the remaining ones have not.
+ */
+GF_Err gf_sk_send_batch(GF_Socket *sock, const GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_sent);
 /*!
  *\brief data reception
  *
@@ -314,6 +341,29 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length);
  *\return error if any, GF_IP_NETWORK_EMPTY if nothing to read
  */
 GF_Err gf_sk_receive(GF_Socket *sock, char *buffer, u32 length, u32 start_from, u32 *read);
+/*!
+ *\brief batched data reception
+ *
+ *Fetches several datagrams on a socket, using as few system calls as possible (recvmmsg on Linux, one call per datagram otherwise). Waits for the first datagram as gf_sk_receive does, then fetches all pending datagrams without waiting. For TCP sockets, a single buffer is filled.
+ *\param sock the socket object
+ *\param buffers the reception buffers
+ *\param buffer_size the allocated size of each reception buffer
+ *\param sizes set to the size of each received datagram. Datagrams larger than buffer_size are dropped and their size is set to 0
+ *\param nb_buffers the number of reception buffers
+ *\param nb_received set to the number of reception buffers filled
+ *\return error if any, GF_IP_NETWORK_EMPTY if nothing to read
+ */
+GF_Err gf_sk_receive_batch(GF_Socket *sock, char **buffers, u32 buffer_size, u32 *sizes, u32 nb_buffers, u32 *nb_received);
+/*!
+ *\brief reception statistics
+ *
+ *Gets the datagram counters of a socket read through gf_sk_receive_batch.
+ *\param sock the socket object
+ *\param nb_received set to the number of datagrams received (may be NULL)
+ *\param nb_dropped set to the number of datagrams dropped by the system because the socket reception buffer was full. Only available on Linux, 0 otherwise (may be NULL)
+ *\param nb_truncated set to the number of datagrams dropped because they were larger than the reception buffers (may be NULL)
+ */
+void gf_sk_get_receive_stats(GF_Socket *sock, u32 *nb_received, u32 *nb_dropped, u32 *nb_truncated);
 
 /*!
  *\brief socket listening
@@ -451,7 +501,7 @@ s32 gf_sk_get_handle(GF_Socket *sock);
 void gf_sk_set_usec_wait(GF_Socket *sock, u32 usec_wait);
 
 /*!
- *Creates a new socket group
+ *Creates a new socket group. On Linux the group is monitored through epoll and is not limited in size, otherwise select is used
  *\return socket group object
  */
 GF_SockGroup *gf_sk_group_new();
@@ -467,7 +517,7 @@ void gf_sk_group_del(GF_SockGroup *sg);
  */
 void gf_sk_group_register(GF_SockGroup *sg, GF_Socket *sk);
 /*!
- *Unregisters a socket from a socket group
+ *Unregisters a socket from a socket group. Sockets must be unregistered before being destroyed
  *\param sg socket group object
  *\param sk socket object to unregister
  */
@@ -487,6 +537,13 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 wait_usec);
  *\return GF_TRUE if socket is ready to read, 0 otherwise
  */
 Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk);
+/*!
+ *Enumerates the sockets that can be read after gf_sk_group_select. With epoll, this only goes through the readable sockets
+ *\param sg socket group object
+ *\param pos enumeration position, shall be set to 0 before the first call
+ *\return the next readable socket, or NULL if no more
+ */
+GF_Socket *gf_sk_group_enum_ready(GF_SockGroup *sg, u32 *pos);
 
 /*!
  *Fetches data on a socket without performing any select (wait), to be used with socket group on sockets that are set in the selected socket group
@@ -499,6 +556,13 @@ Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk);
  */
 GF_Err gf_sk_receive_no_select(GF_Socket *sock, char *buffer, u32 length, u32 start_from, u32 *read);
 
+/*!
+ *Checks that an idle connected socket can be reused, without consuming any data
+ *\param sock the socket object
+ *\return GF_OK if the connection is still open with nothing to read, GF_IP_CONNECTION_CLOSED if the peer closed it or GF_IP_NETWORK_FAILURE if unexpected data is pending
+ */
+GF_Err gf_sk_probe(GF_Socket *sock);
+
 
 /*!
  *\brief gets ipv6 support
@@ -142,6 +142,16 @@ GF_Err gf_rtp_streamer_send_au_with_sn(GF_RTPStreamer *rtp, char *data, u32 size
 
 GF_Err gf_rtp_streamer_send_data(GF_RTPStreamer *rtp, char *data, u32 size, u32 fullsize, u64 cts, u64 dts, Bool is_rap, Bool au_start, Bool au_end, u32 au_sn, u32 sampleDuration, u32 sampleDescIndex);
 
+/*!
+ *	\brief sets burst mode
+ *
+ *	In burst mode, the RTP packets produced by each call to \ref gf_rtp_streamer_send_data are queued and sent with as few system calls as possible once the data is processed. Burst mode is enabled by default.
+ *	\param rtp RTP streamer object
+ *	\param max_packets maximum number of packets queued before sending; 0 or 1 disables burst mode and sends packets as soon as they are produced
+ *	\return error if any
+ */
+GF_Err gf_rtp_streamer_set_burst(GF_RTPStreamer *rtp, u32 max_packets);
+
 char *gf_rtp_streamer_format_sdp_header(char *app_name, char *ip_dest, char *session_name, char *iod64);
 
 void gf_rtp_streamer_disable_auto_rtcp(GF_RTPStreamer *streamer);
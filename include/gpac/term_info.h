@@ -118,6 +118,11 @@ typedef struct
 	u32 db_unit_count;
 	/*number of CUs in composition memory (if any) and CM capacity*/
 	u16 cb_unit_count, cb_max_count;
+	/*set if the composition memory is a lock-free queue between decoder and compositor*/
+	Bool cb_lock_free;
+	/*cumulated time in microseconds the decoder waited for a free unit in the composition memory, and the compositor
+	waited for a unit to be ready while playing*/
+	u64 cb_producer_stall_time, cb_consumer_stall_time;
 	/*inidciate that thye composition memory is bypassed for this decoder (video only) */
 	Bool direct_video_memory;
 	/*clock drift in ms of object clock: this is the delay set by the audio renderer to keep AV in sync*/
@@ -100,6 +100,8 @@ typedef struct
 	Bool wait_for_segment_switch;
 	/*current sample*/
 	GF_ISOSample *sample;
+	/*sample reused across fetches in regular playback, to avoid reallocating each sample*/
+	GF_ISOSample *static_sample;
 	GF_SLHeader current_slh;
 	GF_Err last_state;
 
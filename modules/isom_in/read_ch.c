@@ -487,6 +487,13 @@ static void init_reader(ISOMChannel *ch)
 	ch->owner->no_order_check = ch->speed < 0 ? GF_TRUE : GF_FALSE;
 }
 
+/*destroys the current sample, unless it is the channel static sample*/
+static void isor_reader_drop_sample(ISOMChannel *ch)
+{
+	if (ch->sample == ch->static_sample) ch->sample = NULL;
+	else gf_isom_sample_del(&ch->sample);
+}
+
 void isor_reader_get_sample_from_item(ISOMChannel *ch)
 {
 	if (ch->current_slh.AU_sequenceNumber) {
@@ -625,10 +632,11 @@ void isor_reader_get_sample(ISOMChannel *ch)
 	} else {
 		ch->sample_num++;
 
-		ch->sample = gf_isom_get_sample(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index);
+		if (!ch->static_sample) ch->static_sample = gf_isom_sample_new();
+		ch->sample = gf_isom_get_sample_ex(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index, ch->static_sample, NULL);
 		/*if sync shadow / carousel RAP skip*/
 		if (ch->sample && (ch->sample->IsRAP==RAP_REDUNDANT)) {
-			gf_isom_sample_del(&ch->sample);
+			isor_reader_drop_sample(ch);
 			ch->sample_num++;
 			isor_reader_get_sample(ch);
 			return;
@@ -639,7 +647,7 @@ void isor_reader_get_sample(ISOMChannel *ch)
 	if (ch->sample && ch->sample->IsRAP && ch->next_track) {
 		ch->track = ch->next_track;
 		ch->next_track = 0;
-		gf_isom_sample_del(&ch->sample);
+		isor_reader_drop_sample(ch);
 		isor_reader_get_sample(ch);
 		return;
 	}
@@ -721,8 +729,7 @@ void isor_reader_get_sample(ISOMChannel *ch)
 		default:
 			//TODO: do we want to support codec changes ?
 			GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[IsoMedia] Change of sample description (%d->%d) for media type %s not supported\n", ch->last_sample_desc_index, sample_desc_index, gf_4cc_to_str(mtype) ));
-			gf_isom_sample_del(&ch->sample);
-			ch->sample = NULL;
+			isor_reader_drop_sample(ch);
 			ch->last_state = GF_NOT_SUPPORTED;
 			return;
 		}
@@ -791,6 +798,7 @@ void isor_reader_get_sample(ISOMChannel *ch)
 			gf_free(ch->sample->data);
 			ch->sample->data = ismasamp->data;
 			ch->sample->dataLength = ismasamp->dataLength;
+			if (ch->sample == ch->static_sample) ch->sample->alloc_size = ismasamp->dataLength;
 			ismasamp->data = NULL;
 			ismasamp->dataLength = 0;
 			ch->current_slh.isma_encrypted = (ismasamp->flags & GF_ISOM_ISMA_IS_ENCRYPTED) ? 1 : 0;
@@ -851,7 +859,7 @@ void isor_reader_release_sample(ISOMChannel *ch)
 		gf_free(ch->current_slh.sai);
 		ch->current_slh.sai = NULL;
 	}
-	if (ch->sample) gf_isom_sample_del(&ch->sample);
+	if (ch->sample) isor_reader_drop_sample(ch);
 	ch->sample = NULL;
 	ch->current_slh.AU_sequenceNumber++;
 	ch->current_slh.packetSequenceNumber++;
@@ -1039,7 +1039,7 @@ GF_Err MPD_ConnectService(GF_InputService *plug, GF_ClientService *serv, const c
 	const char *opt;
 	GF_Err e;
 	s32 shift_utc_ms, debug_adaptation_set;
-	u32 max_cache_duration, auto_switch_count, init_timeshift, tiles_rate_decrease;
+	u32 max_cache_duration, auto_switch_count, init_timeshift, tiles_rate_decrease, prefetch_depth;
 	Bool use_server_utc, ignore_xlink;
 	GF_DASHInitialSelectionMode first_select_mode;
 	GF_DASHTileAdaptationMode tile_adapt_mode;
@@ -1165,6 +1165,12 @@ GF_Err MPD_ConnectService(GF_InputService *plug, GF_ClientService *serv, const c
 	if (opt && !strcmp(opt, "yes")) use_threads = GF_TRUE;
 
 	if (mpdin->low_latency_mode) use_threads = GF_TRUE;
+
+	opt = gf_modules_get_option((GF_BaseInterface *)plug, "DASH", "PrefetchDepth");
+	if (!opt) gf_modules_set_option((GF_BaseInterface *)plug, "DASH", "PrefetchDepth", "1");
+	prefetch_depth = opt ? atoi(opt) : 1;
+	//chunks are only notified for the segment being downloaded
+	if (mpdin->low_latency_mode) prefetch_depth = 1;
 	
 	opt = gf_modules_get_option((GF_BaseInterface *)plug, "DASH", "AllowAbort");
 	if (!opt) gf_modules_set_option((GF_BaseInterface *)plug, "DASH", "AllowAbort", "no");
@@ -1234,6 +1240,7 @@ GF_Err MPD_ConnectService(GF_InputService *plug, GF_ClientService *serv, const c
 	gf_dash_enable_utc_drift_compensation(mpdin->dash, use_server_utc);
 	gf_dash_set_tile_adaptation_mode(mpdin->dash, tile_adapt_mode, tiles_rate_decrease);
 	gf_dash_set_threaded_download(mpdin->dash, use_threads);
+	gf_dash_set_prefetch_depth(mpdin->dash, prefetch_depth);
 	gf_dash_ignore_xlink(mpdin->dash, ignore_xlink);
 
 	opt = gf_modules_get_option((GF_BaseInterface *)plug, "DASH", "UseScreenResolution");
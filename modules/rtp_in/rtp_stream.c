@@ -612,11 +612,12 @@ void RP_ReadStream(RTPStream *ch)
 		RP_ProcessRTCP(ch, ch->buffer, size);
 	}
 
+	/*packets are processed in place in the channel reception pool*/
 	while (1) {
-		size = gf_rtp_read_rtp(ch->rtp_ch, ch->buffer, RTP_BUFFER_SIZE);
-		if (!size) break;
+		char *pck = gf_rtp_read_rtp_packet(ch->rtp_ch, &size);
+		if (!pck) break;
 		tot_size += size;
-		RP_ProcessRTP(ch, ch->buffer, size);
+		RP_ProcessRTP(ch, pck, size);
 	}
 	/*and send the report*/
 	if (ch->flags & RTP_ENABLE_RTCP) gf_rtp_send_rtcp_report(ch->rtp_ch, SendTCPData, ch);
@@ -354,6 +354,64 @@ void evg_user_fill_const_a(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf);
 void evg_user_fill_var(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf);
 
 
+/*SIMD span kernels - they produce the same pixels as the scalar code, and are only used on packed surfaces
+(pitch_x equal to the pixel size). Any kernel left NULL falls back to the scalar code*/
+enum
+{
+	EVG_SIMD_NONE = 0,
+	EVG_SIMD_SSE2,
+	EVG_SIMD_AVX2,
+	/*pick the best set supported by the CPU*/
+	EVG_SIMD_AUTO = 0xFF
+};
+
+/*shorter runs, mostly anti-aliased edges, are faster in the scalar code*/
+#define EVG_SIMD_MIN_RUN	8
+
+typedef struct
+{
+	u32 type;
+
+	/*fills count pixels with val, given in memory byte order (24 bit: 3 lower bytes)*/
+	void (*fill_32)(u32 *dst, u32 val, u32 count);
+	void (*fill_24)(u8 *dst, u32 val, u32 count);
+	void (*fill_16)(u16 *dst, u16 val, u32 count);
+
+	/*constant color runs - src is in memory byte order with its blend alpha in the upper byte*/
+	void (*bgra_const_run)(u32 src, u32 *dst, u32 count);
+	void (*rgba_const_run)(u32 src, u32 *dst, u32 count);
+	/*premultiplied blend of 32 bit RGB surfaces, forcing the 4th byte to 0xFF if set_alpha*/
+	void (*xrgb_const_run)(u32 src, u32 *dst, u32 count, Bool set_alpha);
+	void (*rgb_const_run)(u32 src, u8 *dst, u32 count);
+	void (*rgb565_const_run)(u32 src, u16 *dst, u32 count);
+
+	/*variable color runs - col are ARGB stencil colors, swap_rb writes them in RGB byte order*/
+	void (*bgra_var_run)(const u32 *col, u32 *dst, u32 spanalpha, u32 count);
+	void (*rgba_var_run)(const u32 *col, u32 *dst, u32 spanalpha, u32 count);
+	void (*xrgb_var_run)(const u32 *col, u32 *dst, u32 spanalpha, u32 count, Bool swap_rb);
+	void (*rgb565_var_run)(const u32 *col, u16 *dst, u32 spanalpha, u32 count);
+
+	/*stencil runs - only set in floating point builds*/
+	void (*linear_pos_run)(s32 *pos, Fixed start, Fixed step, u32 count);
+	void (*radial_pos_run)(EVG_RadialGradient *rg, s32 *pos, Fixed dx, Fixed dy, u32 count);
+	/*replaces gradient positions by their color*/
+	void (*gradient_run)(EVG_BaseGradient *grad, u32 *data, u32 count);
+	/*multiplies the alpha of colors*/
+	void (*alpha_run)(u32 *data, u8 alpha, u32 count);
+	/*computes the byte offset in the texture of the pixels of the run*/
+	void (*texture_run)(EVG_Texture *tx, s32 x, s32 y, u32 *data, u32 count);
+	/*same for untransformed and unrotated textures, x being the texture coordinate of the first pixel*/
+	void (*texture_straight_run)(EVG_Texture *tx, Fixed x, u32 line_offset, u32 *data, u32 count);
+	/*replaces 32 bit texture offsets by their ARGB color*/
+	void (*texture_fetch_run)(EVG_Texture *tx, u32 *data, u32 count);
+} EVG_SIMDKernels;
+
+extern EVG_SIMDKernels evg_simd;
+
+/*sets the SIMD kernels used by the rasterizer and returns the set in use*/
+u32 evg_set_simd(u32 simd_type);
+
+
 
 
 #ifdef __cplusplus
@@ -72,6 +72,11 @@ void overmask_565_const_run(u32 src, u16 *dst, s32 dst_pitch_x, u32 count)
 	u8 srcg = (src >> 8) & 0xff;
 	u8 srcb = (src >> 0) & 0xff;
 
+	if (evg_simd.rgb565_const_run && (dst_pitch_x==2) && (count>=EVG_SIMD_MIN_RUN)) {
+		evg_simd.rgb565_const_run(src, dst, count);
+		return;
+	}
+
 	while (count) {
 		register u16 val = *dst;
 		register u8 dstr = (val >> 8) & 0xf8;
@@ -106,6 +111,8 @@ void evg_565_fill_const(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 			a = mul255(0xFF, spans[i].coverage);
 			fin = (a<<24) | (col_no_a);
 			overmask_565_const_run(fin, (u16*) (dst+x), surf->pitch_x, len);
+		} else if (evg_simd.fill_16 && (surf->pitch_x==2) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.fill_16((u16 *) (dst + x), col565, len);
 		} else {
 			while (len--) {
 				*(u16*) (dst + x) = col565;
@@ -146,6 +153,10 @@ void evg_565_fill_var(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 		surf->sten->fill_run(surf->sten, surf, spans[i].x, y, len);
 		col = surf->stencil_pix_run;
 		x = spans[i].x * surf->pitch_x;
+		if (evg_simd.rgb565_var_run && (surf->pitch_x==2) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.rgb565_var_run(col, (u16 *) (dst + x), spanalpha, len);
+			continue;
+		}
 		while (len--) {
 			col_a = GF_COL_A(*col);
 			if (col_a) {
@@ -46,7 +46,7 @@ static void overmask_bgra(u32 src, u8 *dst, u32 alpha)
 	s32 dsta = dst[3];
 	srca = mul255(srca, alpha);
 	if (dsta) {
-		s32 dstr = dst[1];
+		s32 dstr = dst[2];
 		s32 dstg = dst[1];
 		s32 dstb = dst[0];
 		dst[0] = mul255(srca, srcb - dstb) + dstb;
@@ -68,6 +68,10 @@ static void overmask_bgra_const_run(u32 src, u8 *dst, s32 dst_pitch_x, u32 count
 	s32 srcg = (src >> 8) & 0xff;
 	s32 srcb = (src >> 0) & 0xff;
 
+	if (evg_simd.bgra_const_run && (dst_pitch_x==4) && (count>=EVG_SIMD_MIN_RUN)) {
+		evg_simd.bgra_const_run(src, (u32 *) dst, count);
+		return;
+	}
 
 	while (count) {
 		s32 dsta = dst[3];
@@ -82,7 +86,7 @@ static void overmask_bgra_const_run(u32 src, u8 *dst, s32 dst_pitch_x, u32 count
 			dst[2] = mul255(srca, srcr - dstr) + dstr;
 			dst[3] = mul255(srca, srca) + mul255(255-srca, dsta);
 		} else {
-			dst[0] = srcr;
+			dst[0] = srcb;
 			dst[1] = srcg;
 			dst[2] = srcr;
 			dst[3] = srca;
@@ -114,6 +118,8 @@ void evg_bgra_fill_const(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 			a = mul255(0xFF, spans[i].coverage);
 			fin = (a<<24) | col_no_a;
 			overmask_bgra_const_run(fin, dst + x, surf->pitch_x, len);
+		} else if (evg_simd.fill_32 && (surf->pitch_x==4) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.fill_32((u32 *) (dst + x), col, len);
 		} else {
 			while (len--) {
 				dst[x] = col_b;
@@ -157,6 +163,10 @@ void evg_bgra_fill_var(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 		surf->sten->fill_run(surf->sten, surf, spans[i].x, y, len);
 		x = spans[i].x * surf->pitch_x;
 		col = surf->stencil_pix_run;
+		if (evg_simd.bgra_var_run && (surf->pitch_x==4) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.bgra_var_run(col, (u32 *) (dst + x), spanalpha, len);
+			continue;
+		}
 		while (len--) {
 			_col = *col;
 			col_a = GF_COL_A(_col);
@@ -252,6 +262,11 @@ GFINLINE static void overmask_bgrx_const_run(u32 src, u8 *dst, s32 dst_pitch_x,
 	u32 srcb = mul255(srca, ((src) & 0xff)) ;
 	u32 inva = 1 + 0xFF - srca;
 
+	if (evg_simd.xrgb_const_run && (dst_pitch_x==4) && (count>=EVG_SIMD_MIN_RUN)) {
+		evg_simd.xrgb_const_run(src, (u32 *) dst, count, GF_TRUE);
+		return;
+	}
+
 	while (count) {
 		dst[0] = srcb + ((inva*dst[0])>>8);
 		dst[1] = srcg + ((inva*dst[1])>>8);
@@ -283,6 +298,8 @@ void evg_bgrx_fill_const(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 		if (spana != 0xFF) {
 			fin = (spana<<24) | col_no_a;
 			overmask_bgrx_const_run(fin, dst + x, surf->pitch_x, len);
+		} else if (evg_simd.fill_32 && (surf->pitch_x==4) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.fill_32((u32 *) (dst + x), col | 0xFF000000, len);
 		} else {
 			while (len--) {
 				dst[x] = col_b;
@@ -326,6 +343,10 @@ void evg_bgrx_fill_var(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 		surf->sten->fill_run(surf->sten, surf, spans[i].x, y, len);
 		col = surf->stencil_pix_run;
 		x = spans[i].x * surf->pitch_x;
+		if (evg_simd.xrgb_var_run && (surf->pitch_x==4) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.xrgb_var_run(col, (u32 *) (dst + x), spanalpha, len, GF_FALSE);
+			continue;
+		}
 		while (len--) {
 			u32 _col = *col;
 			col_a = GF_COL_A(_col);
@@ -375,6 +396,12 @@ GFINLINE static void overmask_rgbx_const_run(u32 src, u8 *dst, s32 dst_pitch_x,
 	u32 srcb = mul255(srca, ((src) & 0xff)) ;
 	u32 inva = 1 + 0xFF - srca;
 
+	if (evg_simd.xrgb_const_run && (dst_pitch_x==4) && (count>=EVG_SIMD_MIN_RUN)) {
+		/*the kernel works in memory byte order*/
+		evg_simd.xrgb_const_run((src & 0xFF00FF00) | ((src>>16) & 0xFF) | ((src & 0xFF)<<16), (u32 *) dst, count, GF_FALSE);
+		return;
+	}
+
 	while (count) {
 		dst[0] = srcr + ((inva*dst[0])>>8);
 		dst[1] = srcg + ((inva*dst[1])>>8);
@@ -406,6 +433,8 @@ void evg_rgbx_fill_const(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 		if (spana != 0xFF) {
 			fin = (spana<<24) | col_no_a;
 			overmask_rgbx_const_run(fin, dst + x, surf->pitch_x, len);
+		} else if (evg_simd.fill_32 && (surf->pitch_x==4) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.fill_32((u32 *) (dst + x), 0xFF000000 | ((u32) b<<16) | ((u32) g<<8) | r, len);
 		} else {
 			while (len--) {
 				dst[x] = r;
@@ -449,6 +478,10 @@ void evg_rgbx_fill_var(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 		surf->sten->fill_run(surf->sten, surf, spans[i].x, y, len);
 		col = surf->stencil_pix_run;
 		x = spans[i].x * surf->pitch_x;
+		if (evg_simd.xrgb_var_run && (surf->pitch_x==4) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.xrgb_var_run(col, (u32 *) (dst + x), spanalpha, len, GF_TRUE);
+			continue;
+		}
 		while (len--) {
 			_col = *col;
 			col_a = GF_COL_A(_col);
@@ -551,6 +584,13 @@ GFINLINE static void overmask_rgba_const_run(u32 src, u8 *dst, s32 dst_pitch_x,
 	u8 srcg = GF_COL_G(src);
 	u8 srcb = GF_COL_B(src);
 
+	if (evg_simd.rgba_const_run && (dst_pitch_x==4) && (count>=EVG_SIMD_MIN_RUN)) {
+		/*opaque source erases the pixels whatever the destination alpha*/
+		if (srca==0xFF) evg_simd.fill_32((u32 *) dst, srcr | ((u32) srcg<<8) | ((u32) srcb<<16) | 0xFF000000, count);
+		else evg_simd.rgba_const_run((src & 0xFF00FF00) | srcr | ((u32) srcb<<16), (u32 *) dst, count);
+		return;
+	}
+
 	while (count) {
 		u8 dsta = dst[3];
 		/*special case for RGBA:
@@ -640,6 +680,10 @@ void evg_rgba_fill_var(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 		spanalpha = spans[i].coverage;
 		surf->sten->fill_run(surf->sten, surf, spans[i].x, y, len);
 		col = surf->stencil_pix_run;
+		if (evg_simd.rgba_var_run && (surf->pitch_x==4) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.rgba_var_run(col, (u32 *) p, spanalpha, len);
+			continue;
+		}
 		while (len--) {
 			//we must blend in all cases since we have to merge with the dst alpha
 			overmask_rgba(*col, p, spanalpha);
@@ -34,6 +34,8 @@ GF_Raster2D *EVG_LoadRenderer()
 	if (!dr) return NULL;
 	GF_REGISTER_MODULE_INTERFACE(dr, GF_RASTER_2D_INTERFACE, "GPAC 2D Raster", "gpac distribution")
 
+	/*span kernels are picked once, for the CPU we run on*/
+	evg_set_simd(EVG_SIMD_AUTO);
 
 	dr->stencil_new = evg_stencil_new;
 	dr->stencil_delete = evg_stencil_delete;
@@ -62,6 +62,12 @@ static void overmask_rgb_const_run(u32 src, char *dst, s32 dst_pitch_x, u32 coun
 	u8 srcg = (src >> 8) & 0xff;
 	u8 srcb = (src) & 0xff;
 
+	if (evg_simd.rgb_const_run && (dst_pitch_x==3) && (count>=EVG_SIMD_MIN_RUN)) {
+		/*the kernel works in memory byte order*/
+		evg_simd.rgb_const_run((src & 0xFF00FF00) | srcr | ((u32) srcb<<16), (u8 *) dst, count);
+		return;
+	}
+
 	while (count) {
 		u8 dstr = *(dst);
 		u8 dstg = *(dst+1);
@@ -96,6 +102,8 @@ void evg_rgb_fill_const(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 			a = mul255(0xFF, spans[i].coverage);
 			fin = (a<<24) | col_no_a;
 			overmask_rgb_const_run(fin, p, surf->pitch_x, len);
+		} else if (evg_simd.fill_24 && (surf->pitch_x==3) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.fill_24((u8 *) p, r | (g<<8) | (b<<16), len);
 		} else {
 			while (len--) {
 				*(p) = r;
@@ -214,6 +222,11 @@ static void overmask_bgr_const_run(u32 src, char *dst, s32 dst_pitch_x, u32 coun
 	u8 srcg = (src >> 8) & 0xff;
 	u8 srcb = (src) & 0xff;
 
+	if (evg_simd.rgb_const_run && (dst_pitch_x==3) && (count>=EVG_SIMD_MIN_RUN)) {
+		evg_simd.rgb_const_run(src, (u8 *) dst, count);
+		return;
+	}
+
 	while (count) {
 		u8 dstb = *(dst);
 		u8 dstg = *(dst+1);
@@ -248,6 +261,8 @@ void evg_bgr_fill_const(s32 y, s32 count, EVG_Span *spans, EVGSurface *surf)
 			a = mul255(0xFF, spans[i].coverage);
 			fin = (a<<24) | col_no_a;
 			overmask_bgr_const_run(fin, p, surf->pitch_x, len);
+		} else if (evg_simd.fill_24 && (surf->pitch_x==3) && (len>=EVG_SIMD_MIN_RUN)) {
+			evg_simd.fill_24((u8 *) p, b | (g<<8) | (r<<16), len);
 		} else {
 			while (len--) {
 				*(p) = b;
@@ -0,0 +1,1334 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / software 2D rasterizer module
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *
+ */
+
+#include "rast_soft.h"
+
+EVG_SIMDKernels evg_simd;
+
+/*kernels are only built for x86_64: 32 bit x86 builds may evaluate the scalar float code on the x87 unit,
+with a different rounding than the SIMD float code*/
+#if !defined(EVG_BIG_ENDIAN) && (defined(__x86_64__) || defined(_M_X64))
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# else
+#  include <emmintrin.h>
+# endif
+# define GPAC_HAS_SSE2
+
+/*AVX2 code is only built for the functions using it and selected at run time*/
+# if defined(_MSC_VER) || defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))
+#  include <immintrin.h>
+#  define GPAC_HAS_AVX2
+#  if defined(_MSC_VER)
+#   define GF_AVX2_FUNC
+#  else
+#   define GF_AVX2_FUNC __attribute__((target("avx2")))
+#  endif
+# endif
+#endif
+
+
+#ifdef GPAC_HAS_SSE2
+
+/*
+	SSE2 kernels, 4 pixels at a time. Run tails go through a local buffer so that they use the same code
+*/
+
+static GFINLINE __m128i evg_select_sse2(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static GFINLINE __m128i evg_mullo32_sse2(__m128i a, __m128i b)
+{
+	__m128i e = _mm_mul_epu32(a, b);
+	__m128i o = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(e, _MM_SHUFFLE(0,0,2,0)), _mm_shuffle_epi32(o, _MM_SHUFFLE(0,0,2,0)));
+}
+
+/*mul255(a, b) on 32 bit lanes holding values up to 255*/
+static GFINLINE __m128i evg_mul255_sse2(__m128i a, __m128i b)
+{
+	return _mm_srli_epi32(_mm_mullo_epi16(_mm_add_epi32(a, _mm_set1_epi32(1)), b), 8);
+}
+
+static GFINLINE __m128i evg_swap_rb_sse2(__m128i c)
+{
+	__m128i rb = _mm_and_si128(c, _mm_set1_epi32(0x00FF00FF));
+	rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+	return _mm_or_si128(_mm_and_si128(c, _mm_set1_epi32(0xFF00FF00)), rb);
+}
+
+/*mul255(a, s-d) + d, computed as ((a+1)*s + (255-a)*d) >> 8 which never leaves 16 bits*/
+static GFINLINE __m128i evg_lerp16_sse2(__m128i s, __m128i d, __m128i a)
+{
+	__m128i sa = _mm_mullo_epi16(s, _mm_add_epi16(a, _mm_set1_epi16(1)));
+	__m128i da = _mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(255), a));
+	return _mm_srli_epi16(_mm_add_epi16(sa, da), 8);
+}
+
+/*lerps the 4 bytes of 4 pixels, a holding the alpha of each pixel*/
+static GFINLINE __m128i evg_lerp_4px_sse2(__m128i s, __m128i d, __m128i a)
+{
+	__m128i z = _mm_setzero_si128();
+	__m128i lo, hi;
+	a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+	lo = evg_lerp16_sse2(_mm_unpacklo_epi8(s, z), _mm_unpacklo_epi8(d, z), _mm_unpacklo_epi32(a, a));
+	hi = evg_lerp16_sse2(_mm_unpackhi_epi8(s, z), _mm_unpackhi_epi8(d, z), _mm_unpackhi_epi32(a, a));
+	return _mm_packus_epi16(lo, hi);
+}
+
+static GFINLINE __m128i evg_bgra_4px_sse2(__m128i c, __m128i a, __m128i d)
+{
+	__m128i rgb = _mm_set1_epi32(0x00FFFFFF);
+	__m128i dsta = _mm_srli_epi32(d, 24);
+	__m128i res = evg_lerp_4px_sse2(c, d, a);
+	__m128i ra = _mm_add_epi32(evg_mul255_sse2(a, a), evg_mul255_sse2(_mm_sub_epi32(_mm_set1_epi32(255), a), dsta));
+	__m128i cpy = _mm_or_si128(_mm_and_si128(c, rgb), _mm_slli_epi32(a, 24));
+	res = _mm_or_si128(_mm_and_si128(res, rgb), _mm_slli_epi32(ra, 24));
+	/*empty destination pixels are copied*/
+	return evg_select_sse2(_mm_cmpeq_epi32(dsta, _mm_setzero_si128()), cpy, res);
+}
+
+static GFINLINE __m128i evg_rgba_4px_sse2(__m128i c, __m128i a, __m128i d)
+{
+	u32 i;
+	__m128i res;
+	__m128i ff = _mm_set1_epi32(0xFF);
+	__m128i z = _mm_setzero_si128();
+	__m128i dsta = _mm_srli_epi32(d, 24);
+	__m128i fa = _mm_sub_epi32(_mm_add_epi32(dsta, a), evg_mul255_sse2(dsta, a));
+	__m128i blend = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(dsta, z), _mm_cmpeq_epi32(a, ff)), _mm_set1_epi32(-1));
+	__m128 fsa = _mm_cvtepi32_ps(a);
+	__m128 fda = _mm_cvtepi32_ps(_mm_sub_epi32(dsta, a));
+	/*all terms are exact integers in float, and the quotient truncates like the integer division*/
+	__m128 ffa = _mm_cvtepi32_ps(_mm_or_si128(fa, _mm_and_si128(_mm_cmpeq_epi32(fa, z), _mm_set1_epi32(1))));
+
+	res = _mm_slli_epi32(fa, 24);
+	for (i=0; i<24; i+=8) {
+		__m128 s = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(c, i), ff));
+		__m128 dc = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(d, i), ff));
+		__m128 n = _mm_add_ps(_mm_mul_ps(s, fsa), _mm_mul_ps(dc, fda));
+		__m128i q = _mm_and_si128(_mm_cvttps_epi32(_mm_div_ps(n, ffa)), ff);
+		res = _mm_or_si128(res, _mm_slli_epi32(q, i));
+	}
+	return evg_select_sse2(blend, res, _mm_or_si128(_mm_and_si128(c, _mm_set1_epi32(0x00FFFFFF)), _mm_slli_epi32(a, 24)));
+}
+
+static GFINLINE __m128i evg_565_to_32_sse2(__m128i v)
+{
+	__m128i r = _mm_and_si128(_mm_srli_epi32(v, 8), _mm_set1_epi32(0xF8));
+	__m128i g = _mm_and_si128(_mm_srli_epi32(v, 3), _mm_set1_epi32(0xFC));
+	__m128i b = _mm_and_si128(_mm_slli_epi32(v, 3), _mm_set1_epi32(0xF8));
+	return _mm_or_si128(_mm_or_si128(b, _mm_slli_epi32(g, 8)), _mm_slli_epi32(r, 16));
+}
+
+static GFINLINE __m128i evg_32_to_565_sse2(__m128i v)
+{
+	__m128i r = _mm_and_si128(_mm_srli_epi32(v, 8), _mm_set1_epi32(0xF800));
+	__m128i g = _mm_and_si128(_mm_srli_epi32(v, 5), _mm_set1_epi32(0x07E0));
+	__m128i b = _mm_and_si128(_mm_srli_epi32(v, 3), _mm_set1_epi32(0x001F));
+	v = _mm_or_si128(_mm_or_si128(r, g), b);
+	/*sign extend so that the signed pack keeps the values*/
+	v = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+	return _mm_packs_epi32(v, v);
+}
+
+static void evg_fill_32_sse2(u32 *dst, u32 val, u32 count)
+{
+	u32 i;
+	__m128i v = _mm_set1_epi32(val);
+	for (i=0; i+4<=count; i+=4) _mm_storeu_si128((__m128i *) (dst+i), v);
+	for (; i<count; i++) dst[i] = val;
+}
+
+static void evg_fill_16_sse2(u16 *dst, u16 val, u32 count)
+{
+	u32 i;
+	__m128i v = _mm_set1_epi16(val);
+	for (i=0; i+8<=count; i+=8) _mm_storeu_si128((__m128i *) (dst+i), v);
+	for (; i<count; i++) dst[i] = val;
+}
+
+/*48 bytes hold 16 pixels of 3 bytes, built from the 3 words repeating every 4 pixels*/
+static void evg_rgb_pattern(u8 *pat, u32 val)
+{
+	u32 w0, w1, w2;
+	val &= 0x00FFFFFF;
+	w0 = val | (val<<24);
+	w1 = (val>>8) | (val<<16);
+	w2 = (val>>16) | (val<<8);
+	_mm_storeu_si128((__m128i *) pat, _mm_setr_epi32(w0, w1, w2, w0));
+	_mm_storeu_si128((__m128i *) (pat+16), _mm_setr_epi32(w1, w2, w0, w1));
+	_mm_storeu_si128((__m128i *) (pat+32), _mm_setr_epi32(w2, w0, w1, w2));
+}
+
+static void evg_fill_24_sse2(u8 *dst, u32 val, u32 count)
+{
+	u32 i;
+	u8 pat[48];
+	__m128i p0, p1, p2;
+	evg_rgb_pattern(pat, val);
+	p0 = _mm_loadu_si128((const __m128i *) pat);
+	p1 = _mm_loadu_si128((const __m128i *) (pat+16));
+	p2 = _mm_loadu_si128((const __m128i *) (pat+32));
+	for (i=0; i+16<=count; i+=16) {
+		_mm_storeu_si128((__m128i *) (dst+3*i), p0);
+		_mm_storeu_si128((__m128i *) (dst+3*i+16), p1);
+		_mm_storeu_si128((__m128i *) (dst+3*i+32), p2);
+	}
+	if (i<count) memcpy(dst+3*i, pat, 3*(count-i));
+}
+
+static void evg_bgra_const_run_sse2(u32 src, u32 *dst, u32 count)
+{
+	u32 i;
+	__m128i c = _mm_set1_epi32(src);
+	__m128i a = _mm_set1_epi32(src>>24);
+	for (i=0; i+4<=count; i+=4) {
+		__m128i d = _mm_loadu_si128((const __m128i *) (dst+i));
+		_mm_storeu_si128((__m128i *) (dst+i), evg_bgra_4px_sse2(c, a, d));
+	}
+	if (i<count) {
+		u32 tmp[4];
+		memcpy(tmp, dst+i, 4*(count-i));
+		_mm_storeu_si128((__m128i *) tmp, evg_bgra_4px_sse2(c, a, _mm_loadu_si128((const __m128i *) tmp)));
+		memcpy(dst+i, tmp, 4*(count-i));
+	}
+}
+
+static void evg_rgba_const_run_sse2(u32 src, u32 *dst, u32 count)
+{
+	u32 i;
+	__m128i c = _mm_set1_epi32(src);
+	__m128i a = _mm_set1_epi32(src>>24);
+	for (i=0; i+4<=count; i+=4) {
+		__m128i d = _mm_loadu_si128((const __m128i *) (dst+i));
+		_mm_storeu_si128((__m128i *) (dst+i), evg_rgba_4px_sse2(c, a, d));
+	}
+	if (i<count) {
+		u32 tmp[4];
+		memcpy(tmp, dst+i, 4*(count-i));
+		_mm_storeu_si128((__m128i *) tmp, evg_rgba_4px_sse2(c, a, _mm_loadu_si128((const __m128i *) tmp)));
+		memcpy(dst+i, tmp, 4*(count-i));
+	}
+}
+
+static GFINLINE __m128i evg_xrgb_const_4px_sse2(__m128i sp, __m128i inva, __m128i amask, __m128i d)
+{
+	__m128i z = _mm_setzero_si128();
+	__m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, z), inva), 8);
+	__m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, z), inva), 8);
+	__m128i res = _mm_add_epi8(_mm_packus_epi16(lo, hi), sp);
+	return evg_select_sse2(amask, res, d);
+}
+
+static void evg_xrgb_const_run_sse2(u32 src, u32 *dst, u32 count, Bool set_alpha)
+{
+	u32 i, a = src>>24;
+	/*premultiplied source, the 4th byte is set to 0xFF or kept*/
+	u32 sp = (((a+1) * (src & 0xFF)) >> 8) | ((((a+1) * ((src>>8) & 0xFF)) >> 8) << 8) | ((((a+1) * ((src>>16) & 0xFF)) >> 8) << 16);
+	__m128i inva = _mm_set1_epi16(256 - a);
+	__m128i amask = _mm_set1_epi32(0x00FFFFFF);
+	__m128i vsp = _mm_set1_epi32(sp | (set_alpha ? 0xFF000000 : 0));
+	if (set_alpha) amask = _mm_set1_epi32(-1);
+
+	for (i=0; i+4<=count; i+=4) {
+		__m128i d = _mm_loadu_si128((const __m128i *) (dst+i));
+		if (set_alpha) d = _mm_and_si128(d, _mm_set1_epi32(0x00FFFFFF));
+		_mm_storeu_si128((__m128i *) (dst+i), evg_xrgb_const_4px_sse2(vsp, inva, amask, d));
+	}
+	if (i<count) {
+		u32 tmp[4];
+		__m128i d;
+		memcpy(tmp, dst+i, 4*(count-i));
+		d = _mm_loadu_si128((const __m128i *) tmp);
+		if (set_alpha) d = _mm_and_si128(d, _mm_set1_epi32(0x00FFFFFF));
+		_mm_storeu_si128((__m128i *) tmp, evg_xrgb_const_4px_sse2(vsp, inva, amask, d));
+		memcpy(dst+i, tmp, 4*(count-i));
+	}
+}
+
+static void evg_rgb_const_run_sse2(u32 src, u8 *dst, u32 count)
+{
+	u32 i, j, nb_bytes = 3*count;
+	u8 pat[48];
+	__m128i z = _mm_setzero_si128();
+	__m128i a = _mm_set1_epi16(src>>24);
+	__m128i s_lo[3], s_hi[3];
+
+	evg_rgb_pattern(pat, src);
+	for (j=0; j<3; j++) {
+		__m128i s = _mm_loadu_si128((const __m128i *) (pat + 16*j));
+		s_lo[j] = _mm_unpacklo_epi8(s, z);
+		s_hi[j] = _mm_unpackhi_epi8(s, z);
+	}
+	for (i=0; i+48<=nb_bytes; i+=48) {
+		for (j=0; j<3; j++) {
+			__m128i d = _mm_loadu_si128((const __m128i *) (dst+i+16*j));
+			__m128i lo = evg_lerp16_sse2(s_lo[j], _mm_unpacklo_epi8(d, z), a);
+			__m128i hi = evg_lerp16_sse2(s_hi[j], _mm_unpackhi_epi8(d, z), a);
+			_mm_storeu_si128((__m128i *) (dst+i+16*j), _mm_packus_epi16(lo, hi));
+		}
+	}
+	if (i<nb_bytes) {
+		u8 tmp[48];
+		memcpy(tmp, dst+i, nb_bytes-i);
+		for (j=0; j<3; j++) {
+			__m128i d = _mm_loadu_si128((const __m128i *) (tmp+16*j));
+			__m128i lo = evg_lerp16_sse2(s_lo[j], _mm_unpacklo_epi8(d, z), a);
+			__m128i hi = evg_lerp16_sse2(s_hi[j], _mm_unpackhi_epi8(d, z), a);
+			_mm_storeu_si128((__m128i *) (tmp+16*j), _mm_packus_epi16(lo, hi));
+		}
+		memcpy(dst+i, tmp, nb_bytes-i);
+	}
+}
+
+static GFINLINE __m128i evg_565_4px_sse2(__m128i c, __m128i a, u16 *dst)
+{
+	__m128i d = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *) dst), _mm_setzero_si128());
+	return evg_32_to_565_sse2(evg_lerp_4px_sse2(c, evg_565_to_32_sse2(d), a));
+}
+
+static void evg_rgb565_const_run_sse2(u32 src, u16 *dst, u32 count)
+{
+	u32 i;
+	__m128i c = _mm_set1_epi32(src);
+	__m128i a = _mm_set1_epi32(src>>24);
+	for (i=0; i+4<=count; i+=4) {
+		_mm_storel_epi64((__m128i *) (dst+i), evg_565_4px_sse2(c, a, dst+i));
+	}
+	if (i<count) {
+		u16 tmp[4];
+		memcpy(tmp, dst+i, 2*(count-i));
+		_mm_storel_epi64((__m128i *) tmp, evg_565_4px_sse2(c, a, tmp));
+		memcpy(dst+i, tmp, 2*(count-i));
+	}
+}
+
+/*variable runs: pixels with a null alpha are left untouched, except for RGBA which always blends*/
+static GFINLINE __m128i evg_var_alpha_sse2(__m128i c, __m128i spanalpha)
+{
+	return evg_mul255_sse2(_mm_srli_epi32(c, 24), spanalpha);
+}
+static GFINLINE __m128i evg_var_skip_sse2(__m128i c)
+{
+	return _mm_cmpeq_epi32(_mm_srli_epi32(c, 24), _mm_setzero_si128());
+}
+
+static void evg_bgra_var_run_sse2(const u32 *col, u32 *dst, u32 spanalpha, u32 count)
+{
+	u32 i;
+	__m128i sa = _mm_set1_epi32(spanalpha);
+	for (i=0; i<count; i+=4) {
+		u32 tmp_c[4], tmp_d[4];
+		const u32 *pc = col+i;
+		u32 *pd = dst+i;
+		__m128i c, d;
+		if (i+4>count) {
+			memset(tmp_c, 0, sizeof(tmp_c));
+			memcpy(tmp_c, col+i, 4*(count-i));
+			memcpy(tmp_d, dst+i, 4*(count-i));
+			pc = tmp_c;
+			pd = tmp_d;
+		}
+		c = _mm_loadu_si128((const __m128i *) pc);
+		d = _mm_loadu_si128((const __m128i *) pd);
+		d = evg_select_sse2(evg_var_skip_sse2(c), d, evg_bgra_4px_sse2(c, evg_var_alpha_sse2(c, sa), d));
+		_mm_storeu_si128((__m128i *) pd, d);
+		if (pd==tmp_d) memcpy(dst+i, tmp_d, 4*(count-i));
+	}
+}
+
+static void evg_rgba_var_run_sse2(const u32 *col, u32 *dst, u32 spanalpha, u32 count)
+{
+	u32 i;
+	__m128i sa = _mm_set1_epi32(spanalpha);
+	for (i=0; i<count; i+=4) {
+		u32 tmp_c[4], tmp_d[4];
+		const u32 *pc = col+i;
+		u32 *pd = dst+i;
+		__m128i c, d;
+		if (i+4>count) {
+			memset(tmp_c, 0, sizeof(tmp_c));
+			memcpy(tmp_c, col+i, 4*(count-i));
+			memcpy(tmp_d, dst+i, 4*(count-i));
+			pc = tmp_c;
+			pd = tmp_d;
+		}
+		c = _mm_loadu_si128((const __m128i *) pc);
+		d = _mm_loadu_si128((const __m128i *) pd);
+		d = evg_rgba_4px_sse2(evg_swap_rb_sse2(c), evg_var_alpha_sse2(c, sa), d);
+		_mm_storeu_si128((__m128i *) pd, d);
+		if (pd==tmp_d) memcpy(dst+i, tmp_d, 4*(count-i));
+	}
+}
+
+static void evg_xrgb_var_run_sse2(const u32 *col, u32 *dst, u32 spanalpha, u32 count, Bool swap_rb)
+{
+	u32 i;
+	__m128i sa = _mm_set1_epi32(spanalpha);
+	__m128i opaque = _mm_set1_epi32(0xFF000000);
+	for (i=0; i<count; i+=4) {
+		u32 tmp_c[4], tmp_d[4];
+		const u32 *pc = col+i;
+		u32 *pd = dst+i;
+		__m128i c, d, res;
+		if (i+4>count) {
+			memset(tmp_c, 0, sizeof(tmp_c));
+			memcpy(tmp_c, col+i, 4*(count-i));
+			memcpy(tmp_d, dst+i, 4*(count-i));
+			pc = tmp_c;
+			pd = tmp_d;
+		}
+		c = _mm_loadu_si128((const __m128i *) pc);
+		d = _mm_loadu_si128((const __m128i *) pd);
+		res = evg_lerp_4px_sse2(swap_rb ? evg_swap_rb_sse2(c) : c, d, evg_var_alpha_sse2(c, sa));
+		d = evg_select_sse2(evg_var_skip_sse2(c), d, _mm_or_si128(res, opaque));
+		_mm_storeu_si128((__m128i *) pd, d);
+		if (pd==tmp_d) memcpy(dst+i, tmp_d, 4*(count-i));
+	}
+}
+
+static void evg_rgb565_var_run_sse2(const u32 *col, u16 *dst, u32 spanalpha, u32 count)
+{
+	u32 i;
+	__m128i sa = _mm_set1_epi32(spanalpha);
+	for (i=0; i<count; i+=4) {
+		u32 tmp_c[4];
+		u16 tmp_d[4];
+		const u32 *pc = col+i;
+		u16 *pd = dst+i;
+		__m128i c, d, res, skip;
+		if (i+4>count) {
+			memset(tmp_c, 0, sizeof(tmp_c));
+			memcpy(tmp_c, col+i, 4*(count-i));
+			memcpy(tmp_d, dst+i, 2*(count-i));
+			pc = tmp_c;
+			pd = tmp_d;
+		}
+		c = _mm_loadu_si128((const __m128i *) pc);
+		d = _mm_loadl_epi64((const __m128i *) pd);
+		res = evg_565_4px_sse2(c, evg_var_alpha_sse2(c, sa), pd);
+		skip = evg_var_skip_sse2(c);
+		skip = _mm_packs_epi32(skip, skip);
+		_mm_storel_epi64((__m128i *) pd, evg_select_sse2(skip, d, res));
+		if (pd==tmp_d) memcpy(dst+i, tmp_d, 2*(count-i));
+	}
+}
+
+static void evg_alpha_run_sse2(u32 *data, u8 alpha, u32 count)
+{
+	u32 i;
+	__m128i a = _mm_set1_epi32(alpha);
+	__m128i rgb = _mm_set1_epi32(0x00FFFFFF);
+	for (i=0; i+4<=count; i+=4) {
+		__m128i c = _mm_loadu_si128((const __m128i *) (data+i));
+		__m128i ca = evg_mul255_sse2(_mm_srli_epi32(c, 24), a);
+		_mm_storeu_si128((__m128i *) (data+i), _mm_or_si128(_mm_and_si128(c, rgb), _mm_slli_epi32(ca, 24)));
+	}
+	for (; i<count; i++) {
+		u32 ca = ((GF_COL_A(data[i]) + 1) * alpha) >> 8;
+		data[i] = (ca<<24) | (data[i] & 0x00FFFFFF);
+	}
+}
+
+/*gradient table index of each position, following gradient_get_color*/
+static GFINLINE __m128i evg_gradient_index_sse2(__m128i pos, s32 mod)
+{
+	__m128i max_idx = _mm_set1_epi32((1<<EVGGRADIENTBITS) - 1);
+	__m128i s, m;
+	switch (mod) {
+	case GF_GRADIENT_MODE_SPREAD:
+		s = _mm_srai_epi32(pos, 31);
+		pos = _mm_sub_epi32(_mm_xor_si128(pos, s), s);
+		/*odd periods are mirrored*/
+		m = _mm_srai_epi32(_mm_slli_epi32(pos, 31-EVGGRADIENTBITS), 31);
+		return _mm_and_si128(_mm_xor_si128(pos, m), max_idx);
+	case GF_GRADIENT_MODE_REPEAT:
+		return _mm_and_si128(pos, max_idx);
+	case GF_GRADIENT_MODE_PAD:
+	default:
+		pos = _mm_andnot_si128(_mm_srai_epi32(pos, 31), pos);
+		return evg_select_sse2(_mm_cmpgt_epi32(pos, max_idx), max_idx, pos);
+	}
+}
+
+static void evg_gradient_run_sse2(EVG_BaseGradient *grad, u32 *data, u32 count)
+{
+	u32 i, j;
+	for (i=0; i<count; i+=4) {
+		u32 idx[4];
+		u32 nb = MIN(4, count-i);
+		__m128i pos;
+		if (nb<4) {
+			memset(idx, 0, sizeof(idx));
+			memcpy(idx, data+i, 4*nb);
+			pos = _mm_loadu_si128((const __m128i *) idx);
+		} else {
+			pos = _mm_loadu_si128((const __m128i *) (data+i));
+		}
+		_mm_storeu_si128((__m128i *) idx, evg_gradient_index_sse2(pos, grad->mod));
+		for (j=0; j<nb; j++) data[i+j] = grad->pre[idx[j]];
+	}
+}
+
+/*x % w for a u32 w of at least 2, negative x being promoted to unsigned as in the scalar code*/
+static GFINLINE __m128i evg_mod_sse2(__m128i x, u32 width)
+{
+	__m128i w = _mm_set1_epi32(width);
+	__m128i z = _mm_setzero_si128();
+	__m128i neg = _mm_srai_epi32(x, 31);
+	__m128i q = _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(x), _mm_cvtepi32_ps(w)));
+	__m128i r = _mm_sub_epi32(x, evg_mullo32_sse2(q, w));
+	__m128i nw = _mm_sub_epi32(z, w);
+	/*the float quotient may be a few units off for large values*/
+	while (1) {
+		__m128i add = _mm_or_si128(_mm_andnot_si128(neg, _mm_cmplt_epi32(r, z)), _mm_and_si128(neg, _mm_cmpgt_epi32(_mm_add_epi32(nw, _mm_set1_epi32(1)), r)));
+		__m128i sub = _mm_or_si128(_mm_andnot_si128(neg, _mm_cmpgt_epi32(r, _mm_sub_epi32(w, _mm_set1_epi32(1)))), _mm_and_si128(neg, _mm_cmpgt_epi32(r, z)));
+		if (!_mm_movemask_epi8(_mm_or_si128(add, sub))) break;
+		r = _mm_add_epi32(r, _mm_and_si128(add, w));
+		r = _mm_sub_epi32(r, _mm_and_si128(sub, w));
+	}
+	/*r has the sign of x, move negative values to (2^32 + x) % w*/
+	r = _mm_add_epi32(r, _mm_and_si128(neg, _mm_set1_epi32((u32) (0x100000000ULL % width))));
+	return _mm_add_epi32(r, _mm_and_si128(_mm_cmplt_epi32(r, z), w));
+}
+
+#ifndef GPAC_FIXED_POINT
+
+static void evg_linear_pos_run_sse2(s32 *pos, Fixed start, Fixed step, u32 count)
+{
+	u32 i;
+	__m128 s = _mm_set1_ps(start);
+	__m128 st = _mm_set1_ps(step);
+	__m128i k = _mm_setr_epi32(0, 1, 2, 3);
+	for (i=0; i+4<=count; i+=4) {
+		__m128 f = _mm_add_ps(s, _mm_mul_ps(_mm_cvtepi32_ps(k), st));
+		_mm_storeu_si128((__m128i *) (pos+i), _mm_cvttps_epi32(f));
+		k = _mm_add_epi32(k, _mm_set1_epi32(4));
+	}
+	for (; i<count; i++) pos[i] = FIX2INT(start + (s32) i * step);
+}
+
+static GFINLINE __m128i evg_radial_4px_sse2(EVG_RadialGradient *rg, __m128 dx, __m128 dy)
+{
+	__m128 rad = _mm_set1_ps(rg->rad);
+	__m128 b = _mm_mul_ps(rad, _mm_add_ps(_mm_mul_ps(dx, _mm_set1_ps(rg->d_f.x)), _mm_mul_ps(dy, _mm_set1_ps(rg->d_f.y))));
+	__m128 val = _mm_add_ps(_mm_mul_ps(b, b), _mm_mul_ps(rad, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))));
+	b = _mm_add_ps(b, _mm_sqrt_ps(val));
+	return _mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps((Float) (1<<EVGGRADIENTBITS)), b));
+}
+
+static void evg_radial_pos_run_sse2(EVG_RadialGradient *rg, s32 *pos, Fixed dx, Fixed dy, u32 count)
+{
+	u32 i;
+	__m128 vdx = _mm_set1_ps(dx);
+	__m128 vdy = _mm_set1_ps(dy);
+	__m128 ix = _mm_set1_ps(rg->d_i.x);
+	__m128 iy = _mm_set1_ps(rg->d_i.y);
+	__m128i k = _mm_setr_epi32(0, 1, 2, 3);
+	for (i=0; i<count; i+=4) {
+		__m128 fk = _mm_cvtepi32_ps(k);
+		__m128i p = evg_radial_4px_sse2(rg, _mm_add_ps(vdx, _mm_mul_ps(fk, ix)), _mm_add_ps(vdy, _mm_mul_ps(fk, iy)));
+		if (i+4<=count) {
+			_mm_storeu_si128((__m128i *) (pos+i), p);
+		} else {
+			s32 tmp[4];
+			_mm_storeu_si128((__m128i *) tmp, p);
+			memcpy(pos+i, tmp, 4*(count-i));
+		}
+		k = _mm_add_epi32(k, _mm_set1_epi32(4));
+	}
+}
+
+/*see bmp_untransform_coord: the near-zero snapping, the tiling loops and the clamping are done for each lane*/
+static GFINLINE __m128i evg_texture_4px_sse2(EVG_Texture *tx, __m128 fx, __m128 fy)
+{
+	__m128 m0 = _mm_set1_ps(tx->smat.m[0]), m1 = _mm_set1_ps(tx->smat.m[1]), m2 = _mm_set1_ps(tx->smat.m[2]);
+	__m128 m3 = _mm_set1_ps(tx->smat.m[3]), m4 = _mm_set1_ps(tx->smat.m[4]), m5 = _mm_set1_ps(tx->smat.m[5]);
+	__m128 zero = _mm_setzero_ps();
+	__m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 snap = _mm_set1_ps(FIX_ONE/20);
+	__m128 x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fx, m0), _mm_mul_ps(fy, m1)), m2);
+	__m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fx, m3), _mm_mul_ps(fy, m4)), m5);
+	__m128 checkx = _mm_cmplt_ps(_mm_and_ps(x, abs_mask), snap);
+	__m128 checky = _mm_cmplt_ps(_mm_and_ps(y, abs_mask), snap);
+	__m128 dim, m;
+	__m128i x0, y0, w, h;
+
+	if (_mm_movemask_ps(_mm_or_ps(checkx, checky))) {
+		__m128 one = _mm_set1_ps(FIX_ONE);
+		__m128 fx1 = _mm_add_ps(fx, one), fy1 = _mm_add_ps(fy, one);
+		__m128 t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fx1, m0), _mm_mul_ps(fy1, m1)), m2);
+		m = _mm_and_ps(_mm_cmplt_ps(t, zero), _mm_set1_ps(INT2FIX(tx->width - 1)));
+		x = _mm_or_ps(_mm_and_ps(checkx, m), _mm_andnot_ps(checkx, x));
+		t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fx1, m3), _mm_mul_ps(fy1, m4)), m5);
+		m = _mm_and_ps(_mm_cmplt_ps(t, zero), _mm_set1_ps(INT2FIX(tx->height - 1)));
+		y = _mm_or_ps(_mm_and_ps(checky, m), _mm_andnot_ps(checky, y));
+	}
+
+	dim = _mm_set1_ps(INT2FIX(tx->width));
+	if (!(tx->mod & GF_TEXTURE_REPEAT_S)) {
+		m = _mm_cmplt_ps(x, _mm_sub_ps(zero, dim));
+		x = _mm_andnot_ps(m, x);
+		m = _mm_cmpgt_ps(x, dim);
+		x = _mm_or_ps(_mm_and_ps(m, dim), _mm_andnot_ps(m, x));
+	}
+	while (_mm_movemask_ps(m = _mm_cmplt_ps(x, zero))) x = _mm_add_ps(x, _mm_and_ps(m, dim));
+	if (tx->mod & GF_TEXTURE_REPEAT_S) {
+		while (_mm_movemask_ps(m = _mm_cmpgt_ps(x, dim))) x = _mm_sub_ps(x, _mm_and_ps(m, dim));
+	}
+
+	dim = _mm_set1_ps(INT2FIX(tx->height));
+	if (!(tx->mod & GF_TEXTURE_REPEAT_T)) {
+		m = _mm_cmplt_ps(y, _mm_sub_ps(zero, dim));
+		y = _mm_andnot_ps(m, y);
+		m = _mm_cmpgt_ps(y, dim);
+		y = _mm_or_ps(_mm_and_ps(m, dim), _mm_andnot_ps(m, y));
+	}
+	while (_mm_movemask_ps(m = _mm_cmplt_ps(y, zero))) y = _mm_add_ps(y, _mm_and_ps(m, dim));
+	if (tx->mod & GF_TEXTURE_REPEAT_T) {
+		while (_mm_movemask_ps(m = _mm_cmpgt_ps(y, dim))) y = _mm_sub_ps(y, _mm_and_ps(m, dim));
+	}
+
+	/*coordinates are now in [0, dim]*/
+	x0 = _mm_cvttps_epi32(x);
+	y0 = _mm_cvttps_epi32(y);
+	w = _mm_set1_epi32(tx->width);
+	h = _mm_set1_epi32(tx->height);
+	if (tx->mod & GF_TEXTURE_REPEAT_S) {
+		x0 = _mm_sub_epi32(x0, _mm_andnot_si128(_mm_cmplt_epi32(x0, w), w));
+	} else {
+		__m128i wm1 = _mm_sub_epi32(w, _mm_set1_epi32(1));
+		x0 = evg_select_sse2(_mm_cmpgt_epi32(x0, wm1), wm1, x0);
+	}
+	if (tx->mod & GF_TEXTURE_REPEAT_T) {
+		y0 = _mm_sub_epi32(y0, _mm_andnot_si128(_mm_cmplt_epi32(y0, h), h));
+	} else {
+		__m128i hm1 = _mm_sub_epi32(h, _mm_set1_epi32(1));
+		y0 = evg_select_sse2(_mm_cmpgt_epi32(y0, hm1), hm1, y0);
+	}
+	return _mm_add_epi32(evg_mullo32_sse2(y0, _mm_set1_epi32(tx->stride)), evg_mullo32_sse2(x0, _mm_set1_epi32(tx->Bpp)));
+}
+
+static void evg_texture_run_sse2(EVG_Texture *tx, s32 x, s32 y, u32 *data, u32 count)
+{
+	u32 i;
+	__m128 fy = _mm_set1_ps(INT2FIX(y));
+	__m128i k = _mm_setr_epi32(x, x+1, x+2, x+3);
+	for (i=0; i<count; i+=4) {
+		__m128i off = evg_texture_4px_sse2(tx, _mm_cvtepi32_ps(k), fy);
+		if (i+4<=count) {
+			_mm_storeu_si128((__m128i *) (data+i), off);
+		} else {
+			u32 tmp[4];
+			_mm_storeu_si128((__m128i *) tmp, off);
+			memcpy(data+i, tmp, 4*(count-i));
+		}
+		k = _mm_add_epi32(k, _mm_set1_epi32(4));
+	}
+}
+
+static void evg_texture_straight_run_sse2(EVG_Texture *tx, Fixed x, u32 line_offset, u32 *data, u32 count)
+{
+	u32 i;
+	__m128 fx = _mm_set1_ps(x);
+	__m128 inc = _mm_set1_ps(tx->inc_x);
+	__m128i wm1 = _mm_set1_epi32(tx->width - 1);
+	__m128i k = _mm_setr_epi32(0, 1, 2, 3);
+	Bool repeat_s = (tx->mod & GF_TEXTURE_REPEAT_S) ? GF_TRUE : GF_FALSE;
+	for (i=0; i<count; i+=4) {
+		__m128i x0 = _mm_cvttps_epi32(_mm_add_ps(fx, _mm_mul_ps(_mm_cvtepi32_ps(k), inc)));
+		if (!repeat_s) x0 = evg_select_sse2(_mm_cmpgt_epi32(x0, wm1), wm1, x0);
+		else if (tx->width==1) x0 = _mm_setzero_si128();
+		else x0 = evg_mod_sse2(x0, tx->width);
+		x0 = _mm_add_epi32(_mm_set1_epi32(line_offset), evg_mullo32_sse2(x0, _mm_set1_epi32(tx->Bpp)));
+		if (i+4<=count) {
+			_mm_storeu_si128((__m128i *) (data+i), x0);
+		} else {
+			u32 tmp[4];
+			_mm_storeu_si128((__m128i *) tmp, x0);
+			memcpy(data+i, tmp, 4*(count-i));
+		}
+		k = _mm_add_epi32(k, _mm_set1_epi32(4));
+	}
+}
+
+#endif /*GPAC_FIXED_POINT*/
+
+static GFINLINE __m128i evg_texture_convert_sse2(__m128i c, u32 pixel_format)
+{
+	switch (pixel_format) {
+	case GF_PIXEL_RGBA:
+		return evg_swap_rb_sse2(c);
+	case GF_PIXEL_RGB_32:
+		return _mm_or_si128(c, _mm_set1_epi32(0xFF000000));
+	default:
+		return c;
+	}
+}
+
+static void evg_texture_fetch_run_sse2(EVG_Texture *tx, u32 *data, u32 count)
+{
+	u32 i, j;
+	for (i=0; i<count; i+=4) {
+		u32 tmp[4];
+		u32 nb = MIN(4, count-i);
+		for (j=0; j<nb; j++) tmp[j] = *(u32 *) (tx->pixels + data[i+j]);
+		_mm_storeu_si128((__m128i *) tmp, evg_texture_convert_sse2(_mm_loadu_si128((const __m128i *) tmp), tx->pixel_format));
+		memcpy(data+i, tmp, 4*nb);
+	}
+}
+
+
+#ifdef GPAC_HAS_AVX2
+
+/*
+	AVX2 kernels, 8 pixels at a time - same maths as the SSE2 ones
+*/
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_select_avx2(__m256i mask, __m256i a, __m256i b)
+{
+	return _mm256_blendv_epi8(b, a, mask);
+}
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_mul255_avx2(__m256i a, __m256i b)
+{
+	return _mm256_srli_epi32(_mm256_mullo_epi16(_mm256_add_epi32(a, _mm256_set1_epi32(1)), b), 8);
+}
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_swap_rb_avx2(__m256i c)
+{
+	__m256i rb = _mm256_and_si256(c, _mm256_set1_epi32(0x00FF00FF));
+	rb = _mm256_or_si256(_mm256_slli_epi32(rb, 16), _mm256_srli_epi32(rb, 16));
+	return _mm256_or_si256(_mm256_and_si256(c, _mm256_set1_epi32(0xFF00FF00)), rb);
+}
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_lerp16_avx2(__m256i s, __m256i d, __m256i a)
+{
+	__m256i sa = _mm256_mullo_epi16(s, _mm256_add_epi16(a, _mm256_set1_epi16(1)));
+	__m256i da = _mm256_mullo_epi16(d, _mm256_sub_epi16(_mm256_set1_epi16(255), a));
+	return _mm256_srli_epi16(_mm256_add_epi16(sa, da), 8);
+}
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_lerp_8px_avx2(__m256i s, __m256i d, __m256i a)
+{
+	__m256i z = _mm256_setzero_si256();
+	__m256i lo, hi;
+	a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+	lo = evg_lerp16_avx2(_mm256_unpacklo_epi8(s, z), _mm256_unpacklo_epi8(d, z), _mm256_unpacklo_epi32(a, a));
+	hi = evg_lerp16_avx2(_mm256_unpackhi_epi8(s, z), _mm256_unpackhi_epi8(d, z), _mm256_unpackhi_epi32(a, a));
+	return _mm256_packus_epi16(lo, hi);
+}
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_bgra_8px_avx2(__m256i c, __m256i a, __m256i d)
+{
+	__m256i rgb = _mm256_set1_epi32(0x00FFFFFF);
+	__m256i dsta = _mm256_srli_epi32(d, 24);
+	__m256i res = evg_lerp_8px_avx2(c, d, a);
+	__m256i ra = _mm256_add_epi32(evg_mul255_avx2(a, a), evg_mul255_avx2(_mm256_sub_epi32(_mm256_set1_epi32(255), a), dsta));
+	__m256i cpy = _mm256_or_si256(_mm256_and_si256(c, rgb), _mm256_slli_epi32(a, 24));
+	res = _mm256_or_si256(_mm256_and_si256(res, rgb), _mm256_slli_epi32(ra, 24));
+	return evg_select_avx2(_mm256_cmpeq_epi32(dsta, _mm256_setzero_si256()), cpy, res);
+}
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_rgba_8px_avx2(__m256i c, __m256i a, __m256i d)
+{
+	u32 i;
+	__m256i res;
+	__m256i ff = _mm256_set1_epi32(0xFF);
+	__m256i z = _mm256_setzero_si256();
+	__m256i dsta = _mm256_srli_epi32(d, 24);
+	__m256i fa = _mm256_sub_epi32(_mm256_add_epi32(dsta, a), evg_mul255_avx2(dsta, a));
+	__m256i keep = _mm256_or_si256(_mm256_cmpeq_epi32(dsta, z), _mm256_cmpeq_epi32(a, ff));
+	__m256 fsa = _mm256_cvtepi32_ps(a);
+	__m256 fda = _mm256_cvtepi32_ps(_mm256_sub_epi32(dsta, a));
+	__m256 ffa = _mm256_cvtepi32_ps(_mm256_max_epi32(fa, _mm256_set1_epi32(1)));
+
+	res = _mm256_slli_epi32(fa, 24);
+	for (i=0; i<24; i+=8) {
+		__m256 s = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(c, i), ff));
+		__m256 dc = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(d, i), ff));
+		__m256 n = _mm256_add_ps(_mm256_mul_ps(s, fsa), _mm256_mul_ps(dc, fda));
+		__m256i q = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_div_ps(n, ffa)), ff);
+		res = _mm256_or_si256(res, _mm256_slli_epi32(q, i));
+	}
+	return evg_select_avx2(keep, _mm256_or_si256(_mm256_and_si256(c, _mm256_set1_epi32(0x00FFFFFF)), _mm256_slli_epi32(a, 24)), res);
+}
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_565_to_32_avx2(__m256i v)
+{
+	__m256i r = _mm256_and_si256(_mm256_srli_epi32(v, 8), _mm256_set1_epi32(0xF8));
+	__m256i g = _mm256_and_si256(_mm256_srli_epi32(v, 3), _mm256_set1_epi32(0xFC));
+	__m256i b = _mm256_and_si256(_mm256_slli_epi32(v, 3), _mm256_set1_epi32(0xF8));
+	return _mm256_or_si256(_mm256_or_si256(b, _mm256_slli_epi32(g, 8)), _mm256_slli_epi32(r, 16));
+}
+
+static GF_AVX2_FUNC GFINLINE __m128i evg_32_to_565_avx2(__m256i v)
+{
+	__m256i r = _mm256_and_si256(_mm256_srli_epi32(v, 8), _mm256_set1_epi32(0xF800));
+	__m256i g = _mm256_and_si256(_mm256_srli_epi32(v, 5), _mm256_set1_epi32(0x07E0));
+	__m256i b = _mm256_and_si256(_mm256_srli_epi32(v, 3), _mm256_set1_epi32(0x001F));
+	v = _mm256_or_si256(_mm256_or_si256(r, g), b);
+	return _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+static GF_AVX2_FUNC void evg_fill_32_avx2(u32 *dst, u32 val, u32 count)
+{
+	u32 i;
+	__m256i v = _mm256_set1_epi32(val);
+	for (i=0; i+8<=count; i+=8) _mm256_storeu_si256((__m256i *) (dst+i), v);
+	for (; i<count; i++) dst[i] = val;
+}
+
+static GF_AVX2_FUNC void evg_fill_16_avx2(u16 *dst, u16 val, u32 count)
+{
+	u32 i;
+	__m256i v = _mm256_set1_epi16(val);
+	for (i=0; i+16<=count; i+=16) _mm256_storeu_si256((__m256i *) (dst+i), v);
+	for (; i<count; i++) dst[i] = val;
+}
+
+static GF_AVX2_FUNC void evg_bgra_const_run_avx2(u32 src, u32 *dst, u32 count)
+{
+	u32 i;
+	__m256i c = _mm256_set1_epi32(src);
+	__m256i a = _mm256_set1_epi32(src>>24);
+	for (i=0; i+8<=count; i+=8) {
+		__m256i d = _mm256_loadu_si256((const __m256i *) (dst+i));
+		_mm256_storeu_si256((__m256i *) (dst+i), evg_bgra_8px_avx2(c, a, d));
+	}
+	if (i<count) {
+		u32 tmp[8];
+		memcpy(tmp, dst+i, 4*(count-i));
+		_mm256_storeu_si256((__m256i *) tmp, evg_bgra_8px_avx2(c, a, _mm256_loadu_si256((const __m256i *) tmp)));
+		memcpy(dst+i, tmp, 4*(count-i));
+	}
+}
+
+static GF_AVX2_FUNC void evg_rgba_const_run_avx2(u32 src, u32 *dst, u32 count)
+{
+	u32 i;
+	__m256i c = _mm256_set1_epi32(src);
+	__m256i a = _mm256_set1_epi32(src>>24);
+	for (i=0; i+8<=count; i+=8) {
+		__m256i d = _mm256_loadu_si256((const __m256i *) (dst+i));
+		_mm256_storeu_si256((__m256i *) (dst+i), evg_rgba_8px_avx2(c, a, d));
+	}
+	if (i<count) {
+		u32 tmp[8];
+		memcpy(tmp, dst+i, 4*(count-i));
+		_mm256_storeu_si256((__m256i *) tmp, evg_rgba_8px_avx2(c, a, _mm256_loadu_si256((const __m256i *) tmp)));
+		memcpy(dst+i, tmp, 4*(count-i));
+	}
+}
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_xrgb_const_8px_avx2(__m256i sp, __m256i inva, __m256i keep, __m256i d)
+{
+	__m256i z = _mm256_setzero_si256();
+	__m256i lo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, z), inva), 8);
+	__m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, z), inva), 8);
+	__m256i res = _mm256_add_epi8(_mm256_packus_epi16(lo, hi), sp);
+	return _mm256_or_si256(_mm256_andnot_si256(keep, res), _mm256_and_si256(keep, d));
+}
+
+static GF_AVX2_FUNC void evg_xrgb_const_run_avx2(u32 src, u32 *dst, u32 count, Bool set_alpha)
+{
+	u32 i, a = src>>24;
+	u32 sp = (((a+1) * (src & 0xFF)) >> 8) | ((((a+1) * ((src>>8) & 0xFF)) >> 8) << 8) | ((((a+1) * ((src>>16) & 0xFF)) >> 8) << 16);
+	__m256i inva = _mm256_set1_epi16(256 - a);
+	/*bytes kept from the destination*/
+	__m256i keep = _mm256_set1_epi32(set_alpha ? 0 : 0xFF000000);
+	__m256i vsp = _mm256_set1_epi32(sp | (set_alpha ? 0xFF000000 : 0));
+	__m256i dmask = _mm256_set1_epi32(set_alpha ? 0x00FFFFFF : 0xFFFFFFFF);
+
+	for (i=0; i+8<=count; i+=8) {
+		__m256i d = _mm256_and_si256(_mm256_loadu_si256((const __m256i *) (dst+i)), dmask);
+		_mm256_storeu_si256((__m256i *) (dst+i), evg_xrgb_const_8px_avx2(vsp, inva, keep, d));
+	}
+	if (i<count) {
+		u32 tmp[8];
+		__m256i d;
+		memcpy(tmp, dst+i, 4*(count-i));
+		d = _mm256_and_si256(_mm256_loadu_si256((const __m256i *) tmp), dmask);
+		_mm256_storeu_si256((__m256i *) tmp, evg_xrgb_const_8px_avx2(vsp, inva, keep, d));
+		memcpy(dst+i, tmp, 4*(count-i));
+	}
+}
+
+static GF_AVX2_FUNC void evg_rgb_const_run_avx2(u32 src, u8 *dst, u32 count)
+{
+	u32 i, j, nb_bytes = 3*count;
+	u8 pat[96];
+	__m256i z = _mm256_setzero_si256();
+	__m256i a = _mm256_set1_epi16(src>>24);
+	__m256i s_lo[3], s_hi[3];
+
+	/*96 bytes hold 32 pixels*/
+	evg_rgb_pattern(pat, src);
+	memcpy(pat+48, pat, 48);
+	for (j=0; j<3; j++) {
+		__m256i s = _mm256_loadu_si256((const __m256i *) (pat + 32*j));
+		s_lo[j] = _mm256_unpacklo_epi8(s, z);
+		s_hi[j] = _mm256_unpackhi_epi8(s, z);
+	}
+	for (i=0; i<nb_bytes; i+=96) {
+		u8 tmp[96];
+		u8 *p = dst+i;
+		if (i+96>nb_bytes) {
+			memcpy(tmp, dst+i, nb_bytes-i);
+			p = tmp;
+		}
+		for (j=0; j<3; j++) {
+			__m256i d = _mm256_loadu_si256((const __m256i *) (p+32*j));
+			__m256i lo = evg_lerp16_avx2(s_lo[j], _mm256_unpacklo_epi8(d, z), a);
+			__m256i hi = evg_lerp16_avx2(s_hi[j], _mm256_unpackhi_epi8(d, z), a);
+			_mm256_storeu_si256((__m256i *) (p+32*j), _mm256_packus_epi16(lo, hi));
+		}
+		if (p==tmp) memcpy(dst+i, tmp, nb_bytes-i);
+	}
+}
+
+static GF_AVX2_FUNC GFINLINE __m128i evg_565_8px_avx2(__m256i c, __m256i a, u16 *dst)
+{
+	__m256i d = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) dst));
+	return evg_32_to_565_avx2(evg_lerp_8px_avx2(c, evg_565_to_32_avx2(d), a));
+}
+
+static GF_AVX2_FUNC void evg_rgb565_const_run_avx2(u32 src, u16 *dst, u32 count)
+{
+	u32 i;
+	__m256i c = _mm256_set1_epi32(src);
+	__m256i a = _mm256_set1_epi32(src>>24);
+	for (i=0; i+8<=count; i+=8) {
+		_mm_storeu_si128((__m128i *) (dst+i), evg_565_8px_avx2(c, a, dst+i));
+	}
+	if (i<count) {
+		u16 tmp[8];
+		memcpy(tmp, dst+i, 2*(count-i));
+		_mm_storeu_si128((__m128i *) tmp, evg_565_8px_avx2(c, a, tmp));
+		memcpy(dst+i, tmp, 2*(count-i));
+	}
+}
+
+static GF_AVX2_FUNC void evg_bgra_var_run_avx2(const u32 *col, u32 *dst, u32 spanalpha, u32 count)
+{
+	u32 i;
+	__m256i sa = _mm256_set1_epi32(spanalpha);
+	__m256i z = _mm256_setzero_si256();
+	for (i=0; i<count; i+=8) {
+		u32 tmp_c[8], tmp_d[8];
+		const u32 *pc = col+i;
+		u32 *pd = dst+i;
+		__m256i c, d, ca;
+		if (i+8>count) {
+			memset(tmp_c, 0, sizeof(tmp_c));
+			memcpy(tmp_c, col+i, 4*(count-i));
+			memcpy(tmp_d, dst+i, 4*(count-i));
+			pc = tmp_c;
+			pd = tmp_d;
+		}
+		c = _mm256_loadu_si256((const __m256i *) pc);
+		d = _mm256_loadu_si256((const __m256i *) pd);
+		ca = _mm256_srli_epi32(c, 24);
+		d = evg_select_avx2(_mm256_cmpeq_epi32(ca, z), d, evg_bgra_8px_avx2(c, evg_mul255_avx2(ca, sa), d));
+		_mm256_storeu_si256((__m256i *) pd, d);
+		if (pd==tmp_d) memcpy(dst+i, tmp_d, 4*(count-i));
+	}
+}
+
+static GF_AVX2_FUNC void evg_rgba_var_run_avx2(const u32 *col, u32 *dst, u32 spanalpha, u32 count)
+{
+	u32 i;
+	__m256i sa = _mm256_set1_epi32(spanalpha);
+	for (i=0; i<count; i+=8) {
+		u32 tmp_c[8], tmp_d[8];
+		const u32 *pc = col+i;
+		u32 *pd = dst+i;
+		__m256i c, d;
+		if (i+8>count) {
+			memset(tmp_c, 0, sizeof(tmp_c));
+			memcpy(tmp_c, col+i, 4*(count-i));
+			memcpy(tmp_d, dst+i, 4*(count-i));
+			pc = tmp_c;
+			pd = tmp_d;
+		}
+		c = _mm256_loadu_si256((const __m256i *) pc);
+		d = _mm256_loadu_si256((const __m256i *) pd);
+		d = evg_rgba_8px_avx2(evg_swap_rb_avx2(c), evg_mul255_avx2(_mm256_srli_epi32(c, 24), sa), d);
+		_mm256_storeu_si256((__m256i *) pd, d);
+		if (pd==tmp_d) memcpy(dst+i, tmp_d, 4*(count-i));
+	}
+}
+
+static GF_AVX2_FUNC void evg_xrgb_var_run_avx2(const u32 *col, u32 *dst, u32 spanalpha, u32 count, Bool swap_rb)
+{
+	u32 i;
+	__m256i sa = _mm256_set1_epi32(spanalpha);
+	__m256i z = _mm256_setzero_si256();
+	__m256i opaque = _mm256_set1_epi32(0xFF000000);
+	for (i=0; i<count; i+=8) {
+		u32 tmp_c[8], tmp_d[8];
+		const u32 *pc = col+i;
+		u32 *pd = dst+i;
+		__m256i c, d, ca, res;
+		if (i+8>count) {
+			memset(tmp_c, 0, sizeof(tmp_c));
+			memcpy(tmp_c, col+i, 4*(count-i));
+			memcpy(tmp_d, dst+i, 4*(count-i));
+			pc = tmp_c;
+			pd = tmp_d;
+		}
+		c = _mm256_loadu_si256((const __m256i *) pc);
+		d = _mm256_loadu_si256((const __m256i *) pd);
+		ca = _mm256_srli_epi32(c, 24);
+		res = evg_lerp_8px_avx2(swap_rb ? evg_swap_rb_avx2(c) : c, d, evg_mul255_avx2(ca, sa));
+		d = evg_select_avx2(_mm256_cmpeq_epi32(ca, z), d, _mm256_or_si256(res, opaque));
+		_mm256_storeu_si256((__m256i *) pd, d);
+		if (pd==tmp_d) memcpy(dst+i, tmp_d, 4*(count-i));
+	}
+}
+
+static GF_AVX2_FUNC void evg_rgb565_var_run_avx2(const u32 *col, u16 *dst, u32 spanalpha, u32 count)
+{
+	u32 i;
+	__m256i sa = _mm256_set1_epi32(spanalpha);
+	__m256i z = _mm256_setzero_si256();
+	for (i=0; i<count; i+=8) {
+		u32 tmp_c[8];
+		u16 tmp_d[8];
+		const u32 *pc = col+i;
+		u16 *pd = dst+i;
+		__m256i c, ca, skip;
+		__m128i d, res, skip16;
+		if (i+8>count) {
+			memset(tmp_c, 0, sizeof(tmp_c));
+			memcpy(tmp_c, col+i, 4*(count-i));
+			memcpy(tmp_d, dst+i, 2*(count-i));
+			pc = tmp_c;
+			pd = tmp_d;
+		}
+		c = _mm256_loadu_si256((const __m256i *) pc);
+		d = _mm_loadu_si128((const __m128i *) pd);
+		ca = _mm256_srli_epi32(c, 24);
+		res = evg_565_8px_avx2(c, evg_mul255_avx2(ca, sa), pd);
+		skip = _mm256_cmpeq_epi32(ca, z);
+		skip16 = _mm_packs_epi32(_mm256_castsi256_si128(skip), _mm256_extracti128_si256(skip, 1));
+		_mm_storeu_si128((__m128i *) pd, _mm_blendv_epi8(res, d, skip16));
+		if (pd==tmp_d) memcpy(dst+i, tmp_d, 2*(count-i));
+	}
+}
+
+static GF_AVX2_FUNC void evg_alpha_run_avx2(u32 *data, u8 alpha, u32 count)
+{
+	u32 i;
+	__m256i a = _mm256_set1_epi32(alpha);
+	__m256i rgb = _mm256_set1_epi32(0x00FFFFFF);
+	for (i=0; i+8<=count; i+=8) {
+		__m256i c = _mm256_loadu_si256((const __m256i *) (data+i));
+		__m256i ca = evg_mul255_avx2(_mm256_srli_epi32(c, 24), a);
+		_mm256_storeu_si256((__m256i *) (data+i), _mm256_or_si256(_mm256_and_si256(c, rgb), _mm256_slli_epi32(ca, 24)));
+	}
+	for (; i<count; i++) {
+		u32 ca = ((GF_COL_A(data[i]) + 1) * alpha) >> 8;
+		data[i] = (ca<<24) | (data[i] & 0x00FFFFFF);
+	}
+}
+
+static GF_AVX2_FUNC void evg_gradient_run_avx2(EVG_BaseGradient *grad, u32 *data, u32 count)
+{
+	u32 i;
+	__m256i max_idx = _mm256_set1_epi32((1<<EVGGRADIENTBITS) - 1);
+	__m256i z = _mm256_setzero_si256();
+	for (i=0; i<count; i+=8) {
+		u32 tmp[8];
+		u32 *p = data+i;
+		__m256i pos, m;
+		if (i+8>count) {
+			memset(tmp, 0, sizeof(tmp));
+			memcpy(tmp, data+i, 4*(count-i));
+			p = tmp;
+		}
+		pos = _mm256_loadu_si256((const __m256i *) p);
+		switch (grad->mod) {
+		case GF_GRADIENT_MODE_SPREAD:
+			pos = _mm256_abs_epi32(pos);
+			m = _mm256_srai_epi32(_mm256_slli_epi32(pos, 31-EVGGRADIENTBITS), 31);
+			pos = _mm256_and_si256(_mm256_xor_si256(pos, m), max_idx);
+			break;
+		case GF_GRADIENT_MODE_REPEAT:
+			pos = _mm256_and_si256(pos, max_idx);
+			break;
+		case GF_GRADIENT_MODE_PAD:
+		default:
+			pos = _mm256_min_epi32(_mm256_max_epi32(pos, z), max_idx);
+			break;
+		}
+		_mm256_storeu_si256((__m256i *) p, _mm256_i32gather_epi32((const int *) grad->pre, pos, 4));
+		if (p==tmp) memcpy(data+i, tmp, 4*(count-i));
+	}
+}
+
+#ifndef GPAC_FIXED_POINT
+
+static GF_AVX2_FUNC void evg_linear_pos_run_avx2(s32 *pos, Fixed start, Fixed step, u32 count)
+{
+	u32 i;
+	__m256 s = _mm256_set1_ps(start);
+	__m256 st = _mm256_set1_ps(step);
+	__m256i k = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	for (i=0; i+8<=count; i+=8) {
+		__m256 f = _mm256_add_ps(s, _mm256_mul_ps(_mm256_cvtepi32_ps(k), st));
+		_mm256_storeu_si256((__m256i *) (pos+i), _mm256_cvttps_epi32(f));
+		k = _mm256_add_epi32(k, _mm256_set1_epi32(8));
+	}
+	for (; i<count; i++) pos[i] = FIX2INT(start + (s32) i * step);
+}
+
+static GF_AVX2_FUNC void evg_radial_pos_run_avx2(EVG_RadialGradient *rg, s32 *pos, Fixed dx, Fixed dy, u32 count)
+{
+	u32 i;
+	__m256 vdx = _mm256_set1_ps(dx);
+	__m256 vdy = _mm256_set1_ps(dy);
+	__m256 ix = _mm256_set1_ps(rg->d_i.x);
+	__m256 iy = _mm256_set1_ps(rg->d_i.y);
+	__m256 rad = _mm256_set1_ps(rg->rad);
+	__m256 fx = _mm256_set1_ps(rg->d_f.x);
+	__m256 fy = _mm256_set1_ps(rg->d_f.y);
+	__m256 size = _mm256_set1_ps((Float) (1<<EVGGRADIENTBITS));
+	__m256i k = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	for (i=0; i<count; i+=8) {
+		__m256 fk = _mm256_cvtepi32_ps(k);
+		__m256 x = _mm256_add_ps(vdx, _mm256_mul_ps(fk, ix));
+		__m256 y = _mm256_add_ps(vdy, _mm256_mul_ps(fk, iy));
+		__m256 b = _mm256_mul_ps(rad, _mm256_add_ps(_mm256_mul_ps(x, fx), _mm256_mul_ps(y, fy)));
+		__m256 val = _mm256_add_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(rad, _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y))));
+		__m256i p;
+		b = _mm256_add_ps(b, _mm256_sqrt_ps(val));
+		p = _mm256_cvttps_epi32(_mm256_mul_ps(size, b));
+		if (i+8<=count) {
+			_mm256_storeu_si256((__m256i *) (pos+i), p);
+		} else {
+			s32 tmp[8];
+			_mm256_storeu_si256((__m256i *) tmp, p);
+			memcpy(pos+i, tmp, 4*(count-i));
+		}
+		k = _mm256_add_epi32(k, _mm256_set1_epi32(8));
+	}
+}
+
+static GF_AVX2_FUNC GFINLINE __m256 evg_select_ps_avx2(__m256 mask, __m256 a, __m256 b)
+{
+	return _mm256_blendv_ps(b, a, mask);
+}
+
+static GF_AVX2_FUNC GFINLINE __m256i evg_texture_8px_avx2(EVG_Texture *tx, __m256 fx, __m256 fy)
+{
+	__m256 m0 = _mm256_set1_ps(tx->smat.m[0]), m1 = _mm256_set1_ps(tx->smat.m[1]), m2 = _mm256_set1_ps(tx->smat.m[2]);
+	__m256 m3 = _mm256_set1_ps(tx->smat.m[3]), m4 = _mm256_set1_ps(tx->smat.m[4]), m5 = _mm256_set1_ps(tx->smat.m[5]);
+	__m256 zero = _mm256_setzero_ps();
+	__m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	__m256 snap = _mm256_set1_ps(FIX_ONE/20);
+	__m256 x = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(fx, m0), _mm256_mul_ps(fy, m1)), m2);
+	__m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(fx, m3), _mm256_mul_ps(fy, m4)), m5);
+	__m256 checkx = _mm256_cmp_ps(_mm256_and_ps(x, abs_mask), snap, _CMP_LT_OQ);
+	__m256 checky = _mm256_cmp_ps(_mm256_and_ps(y, abs_mask), snap, _CMP_LT_OQ);
+	__m256 dim, m;
+	__m256i x0, y0, w, h;
+
+	if (_mm256_movemask_ps(_mm256_or_ps(checkx, checky))) {
+		__m256 one = _mm256_set1_ps(FIX_ONE);
+		__m256 fx1 = _mm256_add_ps(fx, one), fy1 = _mm256_add_ps(fy, one);
+		__m256 t = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(fx1, m0), _mm256_mul_ps(fy1, m1)), m2);
+		m = _mm256_and_ps(_mm256_cmp_ps(t, zero, _CMP_LT_OQ), _mm256_set1_ps(INT2FIX(tx->width - 1)));
+		x = evg_select_ps_avx2(checkx, m, x);
+		t = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(fx1, m3), _mm256_mul_ps(fy1, m4)), m5);
+		m = _mm256_and_ps(_mm256_cmp_ps(t, zero, _CMP_LT_OQ), _mm256_set1_ps(INT2FIX(tx->height - 1)));
+		y = evg_select_ps_avx2(checky, m, y);
+	}
+
+	dim = _mm256_set1_ps(INT2FIX(tx->width));
+	if (!(tx->mod & GF_TEXTURE_REPEAT_S)) {
+		x = _mm256_andnot_ps(_mm256_cmp_ps(x, _mm256_sub_ps(zero, dim), _CMP_LT_OQ), x);
+		x = evg_select_ps_avx2(_mm256_cmp_ps(x, dim, _CMP_GT_OQ), dim, x);
+	}
+	while (_mm256_movemask_ps(m = _mm256_cmp_ps(x, zero, _CMP_LT_OQ))) x = _mm256_add_ps(x, _mm256_and_ps(m, dim));
+	if (tx->mod & GF_TEXTURE_REPEAT_S) {
+		while (_mm256_movemask_ps(m = _mm256_cmp_ps(x, dim, _CMP_GT_OQ))) x = _mm256_sub_ps(x, _mm256_and_ps(m, dim));
+	}
+
+	dim = _mm256_set1_ps(INT2FIX(tx->height));
+	if (!(tx->mod & GF_TEXTURE_REPEAT_T)) {
+		y = _mm256_andnot_ps(_mm256_cmp_ps(y, _mm256_sub_ps(zero, dim), _CMP_LT_OQ), y);
+		y = evg_select_ps_avx2(_mm256_cmp_ps(y, dim, _CMP_GT_OQ), dim, y);
+	}
+	while (_mm256_movemask_ps(m = _mm256_cmp_ps(y, zero, _CMP_LT_OQ))) y = _mm256_add_ps(y, _mm256_and_ps(m, dim));
+	if (tx->mod & GF_TEXTURE_REPEAT_T) {
+		while (_mm256_movemask_ps(m = _mm256_cmp_ps(y, dim, _CMP_GT_OQ))) y = _mm256_sub_ps(y, _mm256_and_ps(m, dim));
+	}
+
+	x0 = _mm256_cvttps_epi32(x);
+	y0 = _mm256_cvttps_epi32(y);
+	w = _mm256_set1_epi32(tx->width);
+	h = _mm256_set1_epi32(tx->height);
+	if (tx->mod & GF_TEXTURE_REPEAT_S) {
+		x0 = _mm256_sub_epi32(x0, _mm256_andnot_si256(_mm256_cmpgt_epi32(w, x0), w));
+	} else {
+		x0 = _mm256_min_epi32(x0, _mm256_sub_epi32(w, _mm256_set1_epi32(1)));
+	}
+	if (tx->mod & GF_TEXTURE_REPEAT_T) {
+		y0 = _mm256_sub_epi32(y0, _mm256_andnot_si256(_mm256_cmpgt_epi32(h, y0), h));
+	} else {
+		y0 = _mm256_min_epi32(y0, _mm256_sub_epi32(h, _mm256_set1_epi32(1)));
+	}
+	return _mm256_add_epi32(_mm256_mullo_epi32(y0, _mm256_set1_epi32(tx->stride)), _mm256_mullo_epi32(x0, _mm256_set1_epi32(tx->Bpp)));
+}
+
+static GF_AVX2_FUNC void evg_texture_run_avx2(EVG_Texture *tx, s32 x, s32 y, u32 *data, u32 count)
+{
+	u32 i;
+	__m256 fy = _mm256_set1_ps(INT2FIX(y));
+	__m256i k = _mm256_add_epi32(_mm256_set1_epi32(x), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	for (i=0; i<count; i+=8) {
+		__m256i off = evg_texture_8px_avx2(tx, _mm256_cvtepi32_ps(k), fy);
+		if (i+8<=count) {
+			_mm256_storeu_si256((__m256i *) (data+i), off);
+		} else {
+			u32 tmp[8];
+			_mm256_storeu_si256((__m256i *) tmp, off);
+			memcpy(data+i, tmp, 4*(count-i));
+		}
+		k = _mm256_add_epi32(k, _mm256_set1_epi32(8));
+	}
+}
+
+#endif /*GPAC_FIXED_POINT*/
+
+static GF_AVX2_FUNC void evg_texture_fetch_run_avx2(EVG_Texture *tx, u32 *data, u32 count)
+{
+	u32 i;
+	for (i=0; i<count; i+=8) {
+		u32 tmp[8];
+		u32 *p = data+i;
+		__m256i c;
+		if (i+8>count) {
+			memset(tmp, 0, sizeof(tmp));
+			memcpy(tmp, data+i, 4*(count-i));
+			p = tmp;
+		}
+		c = _mm256_i32gather_epi32((const int *) tx->pixels, _mm256_loadu_si256((const __m256i *) p), 1);
+		if (tx->pixel_format==GF_PIXEL_RGBA) c = evg_swap_rb_avx2(c);
+		else if (tx->pixel_format==GF_PIXEL_RGB_32) c = _mm256_or_si256(c, _mm256_set1_epi32(0xFF000000));
+		_mm256_storeu_si256((__m256i *) p, c);
+		if (p==tmp) memcpy(data+i, tmp, 4*(count-i));
+	}
+}
+
+static Bool evg_cpu_has_avx2()
+{
+#if defined(_MSC_VER)
+	int regs[4];
+	__cpuid(regs, 0);
+	if (regs[0] < 7) return GF_FALSE;
+	__cpuid(regs, 1);
+	/*AVX and OS support for YMM registers*/
+	if ((regs[2] & ((1<<27) | (1<<28))) != ((1<<27) | (1<<28))) return GF_FALSE;
+	if ((_xgetbv(0) & 6) != 6) return GF_FALSE;
+	__cpuidex(regs, 7, 0);
+	return (regs[1] & (1<<5)) ? GF_TRUE : GF_FALSE;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") ? GF_TRUE : GF_FALSE;
+#endif
+}
+
+#endif /*GPAC_HAS_AVX2*/
+
+#endif /*GPAC_HAS_SSE2*/
+
+
+u32 evg_set_simd(u32 simd_type)
+{
+	const char *name = "none";
+	memset(&evg_simd, 0, sizeof(evg_simd));
+
+	if (simd_type != EVG_SIMD_NONE) {
+#ifdef GPAC_HAS_SSE2
+		evg_simd.type = EVG_SIMD_SSE2;
+		evg_simd.fill_32 = evg_fill_32_sse2;
+		evg_simd.fill_24 = evg_fill_24_sse2;
+		evg_simd.fill_16 = evg_fill_16_sse2;
+		evg_simd.bgra_const_run = evg_bgra_const_run_sse2;
+		evg_simd.rgba_const_run = evg_rgba_const_run_sse2;
+		evg_simd.xrgb_const_run = evg_xrgb_const_run_sse2;
+		evg_simd.rgb_const_run = evg_rgb_const_run_sse2;
+		evg_simd.rgb565_const_run = evg_rgb565_const_run_sse2;
+		evg_simd.bgra_var_run = evg_bgra_var_run_sse2;
+		evg_simd.rgba_var_run = evg_rgba_var_run_sse2;
+		evg_simd.xrgb_var_run = evg_xrgb_var_run_sse2;
+		evg_simd.rgb565_var_run = evg_rgb565_var_run_sse2;
+		evg_simd.gradient_run = evg_gradient_run_sse2;
+		evg_simd.alpha_run = evg_alpha_run_sse2;
+		evg_simd.texture_fetch_run = evg_texture_fetch_run_sse2;
+#ifndef GPAC_FIXED_POINT
+		evg_simd.linear_pos_run = evg_linear_pos_run_sse2;
+		evg_simd.radial_pos_run = evg_radial_pos_run_sse2;
+		evg_simd.texture_run = evg_texture_run_sse2;
+		evg_simd.texture_straight_run = evg_texture_straight_run_sse2;
+#endif
+		name = "SSE2";
+#ifdef GPAC_HAS_AVX2
+		if ((simd_type != EVG_SIMD_SSE2) && evg_cpu_has_avx2()) {
+			evg_simd.type = EVG_SIMD_AVX2;
+			evg_simd.fill_32 = evg_fill_32_avx2;
+			evg_simd.fill_16 = evg_fill_16_avx2;
+			evg_simd.bgra_const_run = evg_bgra_const_run_avx2;
+			evg_simd.rgba_const_run = evg_rgba_const_run_avx2;
+			evg_simd.xrgb_const_run = evg_xrgb_const_run_avx2;
+			evg_simd.rgb_const_run = evg_rgb_const_run_avx2;
+			evg_simd.rgb565_const_run = evg_rgb565_const_run_avx2;
+			evg_simd.bgra_var_run = evg_bgra_var_run_avx2;
+			evg_simd.rgba_var_run = evg_rgba_var_run_avx2;
+			evg_simd.xrgb_var_run = evg_xrgb_var_run_avx2;
+			evg_simd.rgb565_var_run = evg_rgb565_var_run_avx2;
+			evg_simd.gradient_run = evg_gradient_run_avx2;
+			evg_simd.alpha_run = evg_alpha_run_avx2;
+			evg_simd.texture_fetch_run = evg_texture_fetch_run_avx2;
+#ifndef GPAC_FIXED_POINT
+			evg_simd.linear_pos_run = evg_linear_pos_run_avx2;
+			evg_simd.radial_pos_run = evg_radial_pos_run_avx2;
+			evg_simd.texture_run = evg_texture_run_avx2;
+			/*the tiling modulo is bound by the division, AVX2 brings little*/
+#endif
+			name = "AVX2";
+		}
+#endif
+#endif
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("[EVG] Using %s span kernels\n", name));
+	return evg_simd.type;
+}
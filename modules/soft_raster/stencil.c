@@ -228,7 +228,7 @@ static void lgb_fill_run(EVGStencil *p, EVGSurface *surf, s32 x, s32 y, u32 coun
 {
 	Bool has_cmat, has_a;
 	Fixed _res;
-	s32 val;
+	s32 val, i;
 	u32 col, ca;
 	u32 *data = surf->stencil_pix_run;
 	EVG_LinearGradient *_this = (EVG_LinearGradient *) p;
@@ -238,9 +238,19 @@ static void lgb_fill_run(EVGStencil *p, EVGSurface *surf, s32 x, s32 y, u32 coun
 
 	/*no need to move x & y to fixed*/
 	_res = (Fixed) (x * _this->smat.m[0] + y * _this->smat.m[1] + _this->smat.m[2]);
+
+	if (evg_simd.linear_pos_run && !has_cmat && (count>=EVG_SIMD_MIN_RUN)) {
+		evg_simd.linear_pos_run((s32 *) data, _res, _this->smat.m[0], count);
+		evg_simd.gradient_run((EVG_BaseGradient *)_this, data, count);
+		if (has_a) evg_simd.alpha_run(data, _this->alpha, count);
+		return;
+	}
+
+	/*positions are computed from the run start rather than accumulated, so that SIMD runs give the same pixels*/
+	i = 0;
 	while (count) {
-		val = FIX2INT(_res);
-		_res += _this->smat.m[0];
+		val = FIX2INT(_res + i * _this->smat.m[0]);
+		i++;
 
 		col = gradient_get_color((EVG_BaseGradient *)_this, val );
 		if (has_a) {
@@ -308,9 +318,9 @@ EVGStencil *evg_linear_gradient_brush()
 
 static void rg_fill_run(EVGStencil *p, EVGSurface *surf, s32 _x, s32 _y, u32 count)
 {
-	Fixed x, y, dx, dy, b, val;
+	Fixed x, y, dx0, dy0, dx, dy, b, val;
 	Bool has_cmat, has_a;
-	s32 pos;
+	s32 pos, i;
 	u32 col, ca;
 	u32 *data = surf->stencil_pix_run;
 	EVG_RadialGradient *_this = (EVG_RadialGradient *) p;
@@ -322,9 +332,22 @@ static void rg_fill_run(EVGStencil *p, EVGSurface *surf, s32 _x, s32 _y, u32 cou
 	has_cmat = _this->cmat.identity ? GF_FALSE : GF_TRUE;
 	has_a = (_this->alpha==0xFF) ? GF_FALSE : GF_TRUE;
 
-	dx = x - _this->d_f.x;
-	dy = y - _this->d_f.y;
+	dx0 = x - _this->d_f.x;
+	dy0 = y - _this->d_f.y;
+
+	if (evg_simd.radial_pos_run && !has_cmat && (count>=EVG_SIMD_MIN_RUN)) {
+		evg_simd.radial_pos_run(_this, (s32 *) data, dx0, dy0, count);
+		evg_simd.gradient_run((EVG_BaseGradient *)_this, data, count);
+		if (has_a) evg_simd.alpha_run(data, _this->alpha, count);
+		return;
+	}
+
+	/*as for linear gradients, positions are computed from the run start*/
+	i = 0;
 	while (count) {
+		dx = dx0 + i * _this->d_i.x;
+		dy = dy0 + i * _this->d_i.y;
+		i++;
 		b = gf_mulfix(_this->rad, gf_mulfix(dx, _this->d_f.x) + gf_mulfix(dy,  _this->d_f.y));
 		val = gf_mulfix(b, b) + gf_mulfix(_this->rad, gf_mulfix(dx, dx)+gf_mulfix(dy, dy));
 		b += gf_sqrt(val);
@@ -337,9 +360,6 @@ static void rg_fill_run(EVGStencil *p, EVGSurface *surf, s32 _x, s32 _y, u32 cou
 		}
 		if (has_cmat) col = gf_cmx_apply(&p->cmat, col);
 		*data++ = col;
-
-		dx += _this->d_i.x;
-		dy += _this->d_i.y;
 		count--;
 	}
 }
@@ -499,6 +519,31 @@ static void bmp_untransform_coord(EVG_Texture *_this, s32 _x, s32 _y, Fixed *out
 	*outy=y;
 }
 
+/*fetches the texture pixels and applies alpha and color matrix once the SIMD kernels computed the texel offsets of the run*/
+static void bmp_fill_run_simd(EVG_Texture *_this, EVGSurface *surf, s32 _x, s32 _y, u32 count)
+{
+	u32 i;
+	u32 *data = surf->stencil_pix_run;
+
+	evg_simd.texture_run(_this, _x, _y, data, count);
+	if ((_this->Bpp==4) && evg_simd.texture_fetch_run) {
+		evg_simd.texture_fetch_run(_this, data, count);
+	} else {
+		for (i=0; i<count; i++) data[i] = _this->tx_get_pixel(_this->pixels + data[i]);
+	}
+	if (_this->alpha != 255) evg_simd.alpha_run(data, _this->alpha, count);
+
+	if (_this->cmat_is_replace) {
+		for (i=0; i<count; i++) {
+			u32 __a = GF_COL_A(data[i]);
+			__a = (u32) (_this->cmat.m[18] * __a);
+			data[i] = ((__a<<24) | (_this->replace_col & 0x00FFFFFF));
+		}
+	} else if (!_this->cmat.identity) {
+		for (i=0; i<count; i++) data[i] = gf_cmx_apply(&_this->cmat, data[i]);
+	}
+}
+
 static void bmp_fill_run(EVGStencil *p, EVGSurface *surf, s32 _x, s32 _y, u32 count)
 {
 	s32 cx, x0, y0;
@@ -511,6 +556,11 @@ static void bmp_fill_run(EVGStencil *p, EVGSurface *surf, s32 _x, s32 _y, u32 co
 	u32 *data = surf->stencil_pix_run;
 	EVG_Texture *_this = (EVG_Texture *) p;
 
+	if (evg_simd.texture_run && (count>=EVG_SIMD_MIN_RUN)) {
+		bmp_fill_run_simd(_this, surf, _x, _y, count);
+		return;
+	}
+
 	bmp_untransform_coord(_this, _x, _y, &x, &y);
 
 #if USE_BILINEAR
@@ -625,7 +675,7 @@ static void bmp_fill_run(EVGStencil *p, EVGSurface *surf, s32 _x, s32 _y, u32 co
 /*just a little faster...*/
 static void bmp_fill_run_straight(EVGStencil *p, EVGSurface *surf, s32 _x, s32 _y, u32 count)
 {
-	s32 x0, y0;
+	s32 x0, y0, i;
 	u32 pix;
 	u32 __a;
 	Bool repeat_s = GF_FALSE;
@@ -664,13 +714,27 @@ static void bmp_fill_run_straight(EVGStencil *p, EVGSurface *surf, s32 _x, s32 _
 	y0 = y0 % _this->height;
 	pix_line = _this->pixels + _this->stride*y0;
 
+	/*other pixel formats are fetched one by one, which is not faster than the scalar loop. 24 bit surfaces write the run
+	pixel by pixel, the two-pass SIMD fetch is slower than the scalar loop for them*/
+	if (evg_simd.texture_straight_run && (_this->Bpp==4) && (surf->BPP!=3) && (count>=EVG_SIMD_MIN_RUN)) {
+		u32 j;
+		evg_simd.texture_straight_run(_this, x, _this->stride*y0, data, count);
+		evg_simd.texture_fetch_run(_this, data, count);
+		if (_this->replace_col) {
+			for (j=0; j<count; j++) data[j] = (data[j] & 0xFF000000) | (_this->replace_col & 0x00FFFFFF);
+		}
+		return;
+	}
+
+	/*texture coordinates are computed from the run start rather than accumulated, so that SIMD runs give the same pixels*/
+	i = 0;
 	while (count) {
-		x0 = FIX2INT(x);
+		x0 = FIX2INT(x + i * _this->inc_x);
+		i++;
 		if (repeat_s) {
 			x0 = (x0) % _this->width;
 		} else if (x0 >= (s32) _this->width) x0 = _this->width-1;
 
-		x += _this->inc_x;
 		pix = _this->tx_get_pixel(pix_line + _this->Bpp*x0);
 
 		if (_this->replace_col) {
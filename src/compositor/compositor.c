@@ -683,6 +683,7 @@ void gf_sc_del(GF_Compositor *compositor)
 		compositor->video_out->Shutdown(compositor->video_out);
 		gf_modules_close_interface((GF_BaseInterface *)compositor->video_out);
 	}
+	if (compositor->stretch_threads) gf_stretch_bits_remove_threads(compositor->stretch_threads);
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_COMPOSE, ("[Compositor] Closing visual compositor\n"));
 
 	if (compositor->focus_highlight) {
@@ -1215,6 +1216,7 @@ GF_EXPORT
 void gf_sc_reload_config(GF_Compositor *compositor)
 {
 	const char *sOpt;
+	u32 nb_threads;
 
 
 	/*changing drivers needs exclusive access*/
@@ -1326,6 +1328,21 @@ void gf_sc_reload_config(GF_Compositor *compositor)
 	compositor->cache_tolerance = sOpt ? atoi(sOpt) : 30;
 #endif
 
+	sOpt = gf_cfg_get_key(compositor->user->config, "Compositor", "StretchThreads");
+	if (sOpt && !stricmp(sOpt, "auto")) {
+		GF_SystemRTInfo rti;
+		memset(&rti, 0, sizeof(GF_SystemRTInfo));
+		gf_sys_get_rti(500, &rti, GF_RTI_SYSTEM_MEMORY_ONLY);
+		nb_threads = rti.nb_cores;
+	} else {
+		nb_threads = sOpt ? atoi(sOpt) : 0;
+	}
+	if (nb_threads<2) nb_threads = 0;
+	/*register the new count before releasing the previous one, so that the pool is not destroyed when unchanged*/
+	if (nb_threads) gf_stretch_bits_add_threads(nb_threads);
+	if (compositor->stretch_threads) gf_stretch_bits_remove_threads(compositor->stretch_threads);
+	compositor->stretch_threads = nb_threads;
+
 	sOpt = gf_cfg_get_key(compositor->user->config, "Compositor", "TextureFromDecoderMemory");
 	compositor->texture_from_decoder_memory = (sOpt && !strcmp(sOpt, "yes")) ? GF_TRUE : GF_FALSE;
 	if (!sOpt)
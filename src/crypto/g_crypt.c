@@ -25,6 +25,18 @@
 
 #include <gpac/internal/crypt_dev.h>
 
+static u32 crypt_impl = GF_CRYPT_IMPL_AUTO;
+
+GF_EXPORT
+u32 gf_crypt_set_impl(u32 impl)
+{
+	if ((impl != GF_CRYPT_IMPL_GENERIC) && gf_crypt_aesni_supported())
+		crypt_impl = GF_CRYPT_IMPL_AESNI;
+	else
+		crypt_impl = GF_CRYPT_IMPL_GENERIC;
+	return crypt_impl;
+}
+
 GF_EXPORT
 GF_Crypt *gf_crypt_open(GF_CRYPTO_ALGO algorithm, GF_CRYPTO_MODE mode)
 {
@@ -34,11 +46,17 @@ GF_Crypt *gf_crypt_open(GF_CRYPTO_ALGO algorithm, GF_CRYPTO_MODE mode)
 	GF_SAFEALLOC(td, GF_Crypt);
 	if (td == NULL) return NULL;
 
+	e = GF_NOT_SUPPORTED;
+	if (crypt_impl != GF_CRYPT_IMPL_GENERIC)
+		e = gf_crypt_open_open_aesni(td, mode);
+
+	if (e != GF_OK) {
 #ifdef GPAC_HAS_SSL
-	e = gf_crypt_open_open_openssl(td, mode);
+		e = gf_crypt_open_open_openssl(td, mode);
 #else
-	e = gf_crypt_open_open_tinyaes(td, mode);
+		e = gf_crypt_open_open_tinyaes(td, mode);
 #endif
+	}
 
 	if (e != GF_OK) {
 		gf_free(td);
@@ -103,3 +121,58 @@ GF_Err gf_crypt_decrypt(GF_Crypt *td, void *ciphertext, u32 len)
 	if (!len) return GF_OK;
 	return td->_decrypt(td, ciphertext, len);
 }
+
+static GF_Err gf_crypt_ranges(GF_Crypt *td, u8 *data, const GF_CryptRange *ranges, u32 nb_ranges, u8 crypt_block, u8 skip_block, const u8 *const_IV, Bool encrypt)
+{
+	u32 i;
+	GF_Err e = GF_OK;
+	GF_Err (*crypt_fn)(GF_Crypt *, u8 *, u32);
+
+	if (!td) return GF_BAD_PARAM;
+	if (!nb_ranges) return GF_OK;
+	if (!data || !ranges) return GF_BAD_PARAM;
+	/*one of them 0 means no pattern*/
+	if (!crypt_block || !skip_block) crypt_block = skip_block = 0;
+
+	/*call the implementation directly, once per range or per pattern block*/
+	crypt_fn = encrypt ? td->_crypt : td->_decrypt;
+	for (i=0; i<nb_ranges; i++) {
+		u8 *ptr;
+		u32 res = ranges[i].crypt_bytes;
+
+		data += ranges[i].clear_bytes;
+		ptr = data;
+		data += res;
+		if (!res) continue;
+
+		if (const_IV) {
+			e = td->_set_state(td, const_IV, 16);
+			if (e) return e;
+		}
+		if (!crypt_block) {
+			e = crypt_fn(td, ptr, res);
+			if (e) return e;
+			continue;
+		}
+		while (res) {
+			e = crypt_fn(td, ptr, (res >= 16*(u32)crypt_block) ? 16*crypt_block : res);
+			if (e) return e;
+			if (res < 16 * (u32) (crypt_block + skip_block)) break;
+			ptr += 16 * (crypt_block + skip_block);
+			res -= 16 * (crypt_block + skip_block);
+		}
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_crypt_encrypt_ranges(GF_Crypt *td, u8 *data, const GF_CryptRange *ranges, u32 nb_ranges, u8 crypt_block, u8 skip_block, const u8 *const_IV)
+{
+	return gf_crypt_ranges(td, data, ranges, nb_ranges, crypt_block, skip_block, const_IV, GF_TRUE);
+}
+
+GF_EXPORT
+GF_Err gf_crypt_decrypt_ranges(GF_Crypt *td, u8 *data, const GF_CryptRange *ranges, u32 nb_ranges, u8 crypt_block, u8 skip_block, const u8 *const_IV)
+{
+	return gf_crypt_ranges(td, data, ranges, nb_ranges, crypt_block, skip_block, const_IV, GF_FALSE);
+}
@@ -0,0 +1,400 @@
+/*
+*			GPAC - Multimedia Framework C SDK
+*
+*			Authors: GPAC contributors
+*			Copyright (c) GPAC contributors 2026
+*					All rights reserved
+*
+*  This file is part of GPAC / crypto lib sub-project
+*
+*  GPAC is free software; you can redistribute it and/or modify
+*  it under the terms of the GNU Lesser General Public License as published by
+*  the Free Software Foundation; either version 2, or (at your option)
+*  any later version.
+*
+*  GPAC is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Lesser General Public License for more details.
+*
+*  You should have received a copy of the GNU Lesser General Public
+*  License along with this library; see the file COPYING.  If not, write to
+*  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*/
+
+#include <gpac/internal/crypt_dev.h>
+
+/*AES-NI code is only built for the functions using it and selected at run time*/
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+# include <intrin.h>
+# define GPAC_HAS_AESNI
+# define GF_AESNI_FUNC
+# define AESNI_BSWAP64(_v) _byteswap_uint64(_v)
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+# include <wmmintrin.h>
+# include <cpuid.h>
+# define GPAC_HAS_AESNI
+# define GF_AESNI_FUNC __attribute__((target("aes,sse2")))
+# define AESNI_BSWAP64(_v) __builtin_bswap64(_v)
+#endif
+
+#ifdef GPAC_HAS_AESNI
+
+typedef struct
+{
+	/*expanded keys, 11 round keys each*/
+	u8 enc_keys[11*16];
+	u8 dec_keys[11*16];
+	/*CBC: previous cipher block - CTR: next counter block*/
+	u8 iv[16];
+	/*CTR: keystream of the last counter block and number of its bytes already used*/
+	u8 keystream[16];
+	u32 counter_pos;
+} AESNI_Ctx;
+
+static GF_AESNI_FUNC __m128i aesni_key_step(__m128i key, __m128i gen)
+{
+	gen = _mm_shuffle_epi32(gen, 0xFF);
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	return _mm_xor_si128(key, gen);
+}
+
+/*round constant must be an immediate*/
+#define AESNI_EXPAND(_i, _rcon)	k[_i] = aesni_key_step(k[_i-1], _mm_aeskeygenassist_si128(k[_i-1], _rcon))
+
+static GF_AESNI_FUNC void gf_set_key_aesni(GF_Crypt *td, void *key)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	__m128i k[11];
+	u32 i;
+
+	k[0] = _mm_loadu_si128((const __m128i *)key);
+	AESNI_EXPAND(1, 0x01);
+	AESNI_EXPAND(2, 0x02);
+	AESNI_EXPAND(3, 0x04);
+	AESNI_EXPAND(4, 0x08);
+	AESNI_EXPAND(5, 0x10);
+	AESNI_EXPAND(6, 0x20);
+	AESNI_EXPAND(7, 0x40);
+	AESNI_EXPAND(8, 0x80);
+	AESNI_EXPAND(9, 0x1B);
+	AESNI_EXPAND(10, 0x36);
+
+	for (i=0; i<11; i++) {
+		_mm_storeu_si128((__m128i *)ctx->enc_keys + i, k[i]);
+	}
+	/*equivalent inverse cipher keys*/
+	_mm_storeu_si128((__m128i *)ctx->dec_keys, k[10]);
+	for (i=1; i<10; i++) {
+		_mm_storeu_si128((__m128i *)ctx->dec_keys + i, _mm_aesimc_si128(k[10-i]));
+	}
+	_mm_storeu_si128((__m128i *)ctx->dec_keys + 10, k[0]);
+}
+
+static GF_AESNI_FUNC void aesni_load_keys(__m128i *k, const u8 *keys)
+{
+	u32 i;
+	for (i=0; i<11; i++) {
+		k[i] = _mm_loadu_si128((const __m128i *)keys + i);
+	}
+}
+
+static GF_AESNI_FUNC __m128i aesni_encrypt_block(__m128i b, const __m128i *k)
+{
+	u32 r;
+	b = _mm_xor_si128(b, k[0]);
+	for (r=1; r<10; r++) {
+		b = _mm_aesenc_si128(b, k[r]);
+	}
+	return _mm_aesenclast_si128(b, k[10]);
+}
+
+static GF_AESNI_FUNC __m128i aesni_decrypt_block(__m128i b, const __m128i *k)
+{
+	u32 r;
+	b = _mm_xor_si128(b, k[0]);
+	for (r=1; r<10; r++) {
+		b = _mm_aesdec_si128(b, k[r]);
+	}
+	return _mm_aesdeclast_si128(b, k[10]);
+}
+
+static GF_Err gf_crypt_init_aesni(GF_Crypt *td, void *key, const void *iv)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	/*context is reused when the descriptor is initialized again*/
+	if (!ctx) {
+		GF_SAFEALLOC(ctx, AESNI_Ctx);
+		if (!ctx) return GF_OUT_OF_MEM;
+		td->context = ctx;
+	}
+	ctx->counter_pos = 0;
+	if (iv) memcpy(ctx->iv, iv, 16);
+	else memset(ctx->iv, 0, 16);
+	return GF_OK;
+}
+
+static void gf_crypt_deinit_aesni(GF_Crypt *td)
+{
+}
+
+/** CBC mode **/
+
+static GF_Err gf_crypt_set_IV_aesni_cbc(GF_Crypt *td, const u8 *iv, u32 iv_size)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	if (iv_size>16) return GF_BAD_PARAM;
+	memset(ctx->iv, 0, 16);
+	memcpy(ctx->iv, iv, iv_size);
+	return GF_OK;
+}
+
+static GF_Err gf_crypt_get_IV_aesni_cbc(GF_Crypt *td, u8 *iv, u32 *iv_size)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	memcpy(iv, ctx->iv, 16);
+	*iv_size = 16;
+	return GF_OK;
+}
+
+/*trailing bytes of an incomplete block are left untouched*/
+static GF_AESNI_FUNC GF_Err gf_crypt_encrypt_aesni_cbc(GF_Crypt *td, u8 *buf, u32 len)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	__m128i k[11], iv;
+
+	aesni_load_keys(k, ctx->enc_keys);
+	iv = _mm_loadu_si128((const __m128i *)ctx->iv);
+	while (len >= 16) {
+		iv = aesni_encrypt_block(_mm_xor_si128(_mm_loadu_si128((const __m128i *)buf), iv), k);
+		_mm_storeu_si128((__m128i *)buf, iv);
+		buf += 16;
+		len -= 16;
+	}
+	_mm_storeu_si128((__m128i *)ctx->iv, iv);
+	return GF_OK;
+}
+
+/*unlike encryption, CBC decryption of consecutive blocks is independent and is interleaved*/
+static GF_AESNI_FUNC GF_Err gf_crypt_decrypt_aesni_cbc(GF_Crypt *td, u8 *buf, u32 len)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	__m128i k[11], iv;
+	u32 i, r;
+
+	aesni_load_keys(k, ctx->dec_keys);
+	iv = _mm_loadu_si128((const __m128i *)ctx->iv);
+	while (len >= 8*16) {
+		__m128i c[8], b[8];
+		for (i=0; i<8; i++) {
+			c[i] = _mm_loadu_si128((const __m128i *)buf + i);
+			b[i] = _mm_xor_si128(c[i], k[0]);
+		}
+		for (r=1; r<10; r++) {
+			for (i=0; i<8; i++) b[i] = _mm_aesdec_si128(b[i], k[r]);
+		}
+		b[0] = _mm_xor_si128(_mm_aesdeclast_si128(b[0], k[10]), iv);
+		for (i=1; i<8; i++) {
+			b[i] = _mm_xor_si128(_mm_aesdeclast_si128(b[i], k[10]), c[i-1]);
+		}
+		for (i=0; i<8; i++) {
+			_mm_storeu_si128((__m128i *)buf + i, b[i]);
+		}
+		iv = c[7];
+		buf += 8*16;
+		len -= 8*16;
+	}
+	while (len >= 16) {
+		__m128i c = _mm_loadu_si128((const __m128i *)buf);
+		_mm_storeu_si128((__m128i *)buf, _mm_xor_si128(aesni_decrypt_block(c, k), iv));
+		iv = c;
+		buf += 16;
+		len -= 16;
+	}
+	_mm_storeu_si128((__m128i *)ctx->iv, iv);
+	return GF_OK;
+}
+
+/** CTR mode **/
+
+/*128-bit big endian counter, as in the other backends*/
+static void aesni_get_counter(const u8 *iv, u64 *hi, u64 *lo)
+{
+	memcpy(hi, iv, 8);
+	memcpy(lo, iv+8, 8);
+	*hi = AESNI_BSWAP64(*hi);
+	*lo = AESNI_BSWAP64(*lo);
+}
+
+static void aesni_set_counter(u8 *iv, u64 hi, u64 lo)
+{
+	hi = AESNI_BSWAP64(hi);
+	lo = AESNI_BSWAP64(lo);
+	memcpy(iv, &hi, 8);
+	memcpy(iv+8, &lo, 8);
+}
+
+static GF_AESNI_FUNC __m128i aesni_counter_block(u64 *hi, u64 *lo)
+{
+	__m128i b = _mm_set_epi64x((s64) AESNI_BSWAP64(*lo), (s64) AESNI_BSWAP64(*hi));
+	(*lo)++;
+	if (! *lo) (*hi)++;
+	return b;
+}
+
+static GF_AESNI_FUNC void aesni_ctr_keystream(AESNI_Ctx *ctx, const u8 *counter)
+{
+	__m128i k[11];
+	aesni_load_keys(k, ctx->enc_keys);
+	_mm_storeu_si128((__m128i *)ctx->keystream, aesni_encrypt_block(_mm_loadu_si128((const __m128i *)counter), k));
+}
+
+static GF_Err gf_crypt_set_IV_aesni_ctr(GF_Crypt *td, const u8 *iv, u32 iv_size)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+
+	/*17 bytes IV: first byte is the number of bytes used in the last counter block*/
+	if (iv_size>16) {
+		ctx->counter_pos = iv[0] % 16;
+		memcpy(ctx->iv, iv+1, 16);
+	} else {
+		ctx->counter_pos = 0;
+		memset(ctx->iv, 0, 16);
+		memcpy(ctx->iv, iv, iv_size);
+	}
+	/*restore keystream of the block in use*/
+	if (ctx->counter_pos) {
+		u8 prev[16];
+		u64 hi, lo;
+		aesni_get_counter(ctx->iv, &hi, &lo);
+		if (!lo) hi--;
+		lo--;
+		aesni_set_counter(prev, hi, lo);
+		aesni_ctr_keystream(ctx, prev);
+	}
+	return GF_OK;
+}
+
+static GF_Err gf_crypt_get_IV_aesni_ctr(GF_Crypt *td, u8 *iv, u32 *iv_size)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	iv[0] = ctx->counter_pos;
+	memcpy(iv+1, ctx->iv, 16);
+	*iv_size = 17;
+	return GF_OK;
+}
+
+static GF_AESNI_FUNC GF_Err gf_crypt_crypt_aesni_ctr(GF_Crypt *td, u8 *buf, u32 len)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	__m128i k[11];
+	u64 hi, lo;
+	u32 i, r;
+
+	/*finish the current keystream block*/
+	while (ctx->counter_pos && len) {
+		*buf++ ^= ctx->keystream[ctx->counter_pos];
+		ctx->counter_pos = (ctx->counter_pos + 1) % 16;
+		len--;
+	}
+	if (!len) return GF_OK;
+
+	aesni_load_keys(k, ctx->enc_keys);
+	aesni_get_counter(ctx->iv, &hi, &lo);
+	while (len >= 8*16) {
+		__m128i b[8];
+		for (i=0; i<8; i++) {
+			b[i] = _mm_xor_si128(aesni_counter_block(&hi, &lo), k[0]);
+		}
+		for (r=1; r<10; r++) {
+			for (i=0; i<8; i++) b[i] = _mm_aesenc_si128(b[i], k[r]);
+		}
+		for (i=0; i<8; i++) {
+			b[i] = _mm_aesenclast_si128(b[i], k[10]);
+			_mm_storeu_si128((__m128i *)buf + i, _mm_xor_si128(b[i], _mm_loadu_si128((const __m128i *)buf + i)));
+		}
+		buf += 8*16;
+		len -= 8*16;
+	}
+	while (len >= 16) {
+		__m128i b = aesni_encrypt_block(aesni_counter_block(&hi, &lo), k);
+		_mm_storeu_si128((__m128i *)buf, _mm_xor_si128(b, _mm_loadu_si128((const __m128i *)buf)));
+		buf += 16;
+		len -= 16;
+	}
+	if (len) {
+		_mm_storeu_si128((__m128i *)ctx->keystream, aesni_encrypt_block(aesni_counter_block(&hi, &lo), k));
+		for (i=0; i<len; i++) {
+			buf[i] ^= ctx->keystream[i];
+		}
+		ctx->counter_pos = len;
+	}
+	aesni_set_counter(ctx->iv, hi, lo);
+	return GF_OK;
+}
+
+static Bool aesni_cpu_check()
+{
+#if defined(_MSC_VER)
+	int regs[4];
+	__cpuid(regs, 1);
+	/*AES and SSE2*/
+	return ((regs[2] & (1<<25)) && (regs[3] & (1<<26))) ? GF_TRUE : GF_FALSE;
+#else
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return GF_FALSE;
+	return ((ecx & (1<<25)) && (edx & (1<<26))) ? GF_TRUE : GF_FALSE;
+#endif
+}
+
+Bool gf_crypt_aesni_supported()
+{
+	static u32 aesni_cpu = 0;
+	if (!aesni_cpu) aesni_cpu = aesni_cpu_check() ? 1 : 2;
+	return (aesni_cpu==1) ? GF_TRUE : GF_FALSE;
+}
+
+GF_Err gf_crypt_open_open_aesni(GF_Crypt *td, GF_CRYPTO_MODE mode)
+{
+	if (!gf_crypt_aesni_supported()) return GF_NOT_SUPPORTED;
+
+	td->mode = mode;
+	switch (td->mode) {
+	case GF_CBC:
+		td->_get_state = gf_crypt_get_IV_aesni_cbc;
+		td->_set_state = gf_crypt_set_IV_aesni_cbc;
+		td->_crypt = gf_crypt_encrypt_aesni_cbc;
+		td->_decrypt = gf_crypt_decrypt_aesni_cbc;
+		break;
+	case GF_CTR:
+		td->_get_state = gf_crypt_get_IV_aesni_ctr;
+		td->_set_state = gf_crypt_set_IV_aesni_ctr;
+		td->_crypt = gf_crypt_crypt_aesni_ctr;
+		td->_decrypt = gf_crypt_crypt_aesni_ctr;
+		break;
+	default:
+		return GF_BAD_PARAM;
+	}
+	td->_init_crypt = gf_crypt_init_aesni;
+	td->_deinit_crypt = gf_crypt_deinit_aesni;
+	td->_set_key = gf_set_key_aesni;
+	td->algo = GF_AES_128;
+	return GF_OK;
+}
+
+#else
+
+Bool gf_crypt_aesni_supported()
+{
+	return GF_FALSE;
+}
+
+GF_Err gf_crypt_open_open_aesni(GF_Crypt *td, GF_CRYPTO_MODE mode)
+{
+	return GF_NOT_SUPPORTED;
+}
+
+#endif /*GPAC_HAS_AESNI*/
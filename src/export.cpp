@@ -285,6 +285,17 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_wait) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_wait) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_no_select) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_get_receive_stats) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_register) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_unregister) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_select) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_sock_is_set) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_group_enum_ready) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_probe) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_is_local) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_get_absolute_path) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_concatenate) )
@@ -417,6 +428,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_sess_setup_from_url) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_get_file_memory) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dm_get_global_rate) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dm_set_connection_pool) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dm_get_connection_pool_stats) )
 
 
 
@@ -574,6 +587,9 @@
 
 /*color.h exports*/
 #pragma comment (linker, EXPORT_SYMBOL(gf_stretch_bits) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_stretch_bits_add_threads) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_stretch_bits_remove_threads) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_color_set_simd) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_color_write_yv12_10_to_yuv) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_color_write_yuv422_10_to_yuv422) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_color_write_yuv444_10_to_yuv444) )
@@ -775,7 +791,11 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_data_reference) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_count) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_sample_padding) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_sample_index_mode) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_ex) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_ref) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_sample_ref_release) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_flags) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_for_media_time) )
@@ -1166,6 +1186,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_disable_auto_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_send_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_get_payload_type) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_set_burst) )
 
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_streamer_new) )
@@ -1329,12 +1350,14 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_current_time) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reset_buffers) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_read_rtp) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_read_rtp_packet) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_read_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_decode_rtp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_decode_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_rtcp_report) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_bye) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_packet) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_packets) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_set_info_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_is_unicast) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_is_interleaved) )
@@ -1375,6 +1398,13 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_reset) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_add) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_get) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_set_pool) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_add_packet) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_get_packet) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_packet_pool_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_packet_pool_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_packet_pool_get) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_packet_pool_release) )
 
 #endif /*GPAC_DISABLE_STREAMING*/
 
@@ -1434,6 +1464,8 @@
 #ifndef GPAC_DISABLE_AV_PARSERS
 #pragma comment (linker, EXPORT_SYMBOL(gf_media_nalu_next_start_code) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_media_nalu_remove_emulation_bytes) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_media_nalu_next_zero_pair) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_media_nalu_set_simd) )
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_avc_get_sps_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_avc_get_pps_info) )
@@ -1476,6 +1508,9 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_crypt_encrypt) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_crypt_set_key) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_crypt_set_IV) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_set_impl) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_encrypt_ranges) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_decrypt_ranges) )
 #endif GPAC_DISABLE_CRYPTO
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_sha1_csum) )
@@ -1535,6 +1570,7 @@
 #if !defined(GPAC_DISABLE_MCRYPT) && !defined(GPAC_DISABLE_ISOM_WRITE)
 /*ismacryp.h exports*/
 #pragma comment (linker, EXPORT_SYMBOL(gf_crypt_file) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_crypt_file_ex) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_decrypt_file) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_ismacryp_encrypt_track) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_ismacryp_decrypt_track) )
@@ -2056,6 +2092,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_get_esd) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_demux_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_demux_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_set_pid_interest) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_reset_pid_interest) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_process_data) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_reset_parsers) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_reset_parsers_for_program) )
@@ -2091,6 +2129,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_program_stream_update_ts_scale) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_update_config) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_process) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_process_burst) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_get_sys_clock) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_get_ts_clock) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_use_single_au_pes_mode) )
@@ -2099,11 +2138,15 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_enable_sdt) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_program_find) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_enable_pcr_only_packets) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_enable_program_threads) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_m2ts_mux_enable_linear_scheduling) )
 
 #endif /*GPAC_DISABLE_MPEG2TS_MUX*/
 /* M3U8 & MPD related functions */
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_init_from_dom) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_init_from_file) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_segment_timeline_merge) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m3u8_to_mpd) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m3u8_solve_representation_xlink) )
@@ -2201,6 +2244,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_cues) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_isobmff_options) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_test_mode) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dasher_set_threads) )
 
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_dasher_next_update_time) )
@@ -2301,6 +2345,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_get_srd_max_size_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_get_srd_info) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_set_threaded_download) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_dash_set_prefetch_depth) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_set_quality_degradation_hint) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_group_set_visible_rect) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dash_get_utc_drift_estimate) )
@@ -30,6 +30,24 @@
 #define MAX_RTP_SN	0x10000
 
 
+/*gives back all pending received packets to the pool*/
+static void gf_rtp_reset_rx(GF_RTPChannel *ch, Bool del_pool)
+{
+	u32 i;
+	ch->rx_nb = ch->rx_pos = 0;
+	if (!ch->rx_pool) return;
+	if (ch->rx_pck) gf_rtp_packet_pool_release(ch->rx_pool, ch->rx_pck);
+	ch->rx_pck = NULL;
+	if (!del_pool) return;
+
+	for (i=0; i<GF_RTP_RX_BATCH; i++) {
+		if (ch->rx_pcks[i]) gf_rtp_packet_pool_release(ch->rx_pool, ch->rx_pcks[i]);
+		ch->rx_pcks[i] = NULL;
+	}
+	gf_rtp_packet_pool_del(ch->rx_pool);
+	ch->rx_pool = NULL;
+}
+
 GF_EXPORT
 GF_RTPChannel *gf_rtp_new()
 {
@@ -52,7 +70,10 @@ void gf_rtp_del(GF_RTPChannel *ch)
 	if (ch->net_info.destination) gf_free(ch->net_info.destination);
 	if (ch->net_info.Profile) gf_free(ch->net_info.Profile);
 	if (ch->po) gf_rtp_reorderer_del(ch->po);
+	gf_rtp_reset_rx(ch, GF_TRUE);
 	if (ch->send_buffer) gf_free(ch->send_buffer);
+	if (ch->batch_hdrs) gf_free(ch->batch_hdrs);
+	if (ch->batch_dgrams) gf_free(ch->batch_dgrams);
 
 	if (ch->CName) gf_free(ch->CName);
 	if (ch->s_name) gf_free(ch->s_name);
@@ -114,6 +135,7 @@ void gf_rtp_reset_buffers(GF_RTPChannel *ch)
 	if (ch->rtp) gf_sk_reset(ch->rtp);
 	if (ch->rtcp) gf_sk_reset(ch->rtcp);
 	if (ch->po) gf_rtp_reorderer_reset(ch->po);
+	gf_rtp_reset_rx(ch, GF_FALSE);
 	/*also reset ssrc*/
 	//ch->SenderSSRC = 0;
 	ch->first_SR = 1;
@@ -157,6 +179,7 @@ GF_Err gf_rtp_stop(GF_RTPChannel *ch)
 	ch->rtcp = NULL;
 	if (ch->po) gf_rtp_reorderer_del(ch->po);
 	ch->po = NULL;
+	gf_rtp_reset_rx(ch, GF_TRUE);
 	return GF_OK;
 }
 
@@ -174,6 +197,7 @@ GF_Err gf_rtp_initialize(GF_RTPChannel *ch, u32 UDPBufferSize, Bool IsSource, u3
 	ch->rtcp = NULL;
 	if (ch->po) gf_rtp_reorderer_del(ch->po);
 	ch->po = NULL;
+	gf_rtp_reset_rx(ch, GF_TRUE);
 
 	ch->CurrentTime = 0;
 	ch->rtp_time = 0;
@@ -238,10 +262,16 @@ GF_Err gf_rtp_initialize(GF_RTPChannel *ch, u32 UDPBufferSize, Bool IsSource, u3
 		}
 
 
-		//create re-ordering queue for UDP only, and receive
+		//create reception pool and re-ordering queue for UDP only, and receive
+		if (!IsSource) {
+			ch->rx_pool = gf_rtp_packet_pool_new(GF_RTP_RX_PCK_SIZE, GF_RTP_RX_BATCH + ReorederingSize);
+			if (!ch->rx_pool) return GF_OUT_OF_MEM;
+		}
 		if (ReorederingSize && !IsSource) {
 			if (!MaxReorderDelay) MaxReorderDelay = 200;
 			ch->po = gf_rtp_reorderer_new(ReorederingSize, MaxReorderDelay);
+			//received packets are queued without copy
+			gf_rtp_reorderer_set_pool(ch->po, ch->rx_pool);
 		}
 
 		//
@@ -330,72 +360,152 @@ void gf_rtp_get_next_report_time(GF_RTPChannel *ch)
 }
 
 
-GF_EXPORT
-u32 gf_rtp_read_rtp(GF_RTPChannel *ch, char *buffer, u32 buffer_size)
+/*gets the next packet received on the RTP socket, reading a new batch of packets when all have been consumed*/
+static char *gf_rtp_fetch_packet(GF_RTPChannel *ch, u32 *size)
 {
-	GF_Err e;
-	u32 seq_num, res;
+	u32 i;
 	char *pck;
 
-	//only if the socket exist (otherwise RTSP interleaved channel)
-	if (!ch || !ch->rtp) return 0;
-
-	e = gf_sk_receive(ch->rtp, buffer, buffer_size, 0, &res);
-	if (!res || e || (res < 12)) res = 0;
-	if (res) {
-		ch->total_bytes+=res;
-		ch->total_pck++;
+	if (ch->rx_pos == ch->rx_nb) {
+		GF_Err e;
+		ch->rx_pos = ch->rx_nb = 0;
+		for (i=0; i<GF_RTP_RX_BATCH; i++) {
+			if (ch->rx_pcks[i]) continue;
+			ch->rx_pcks[i] = gf_rtp_packet_pool_get(ch->rx_pool, 0);
+			if (!ch->rx_pcks[i]) return NULL;
+		}
+		e = gf_sk_receive_batch(ch->rtp, ch->rx_pcks, ch->rx_pool->pck_size, ch->rx_sizes, GF_RTP_RX_BATCH, &ch->rx_nb);
+		if (e) ch->rx_nb = 0;
+	}
+	while (ch->rx_pos < ch->rx_nb) {
+		i = ch->rx_pos++;
+		/*dropped or not an RTP packet, the buffer is reused at the next read*/
+		if (ch->rx_sizes[i] < 12) continue;
+		pck = ch->rx_pcks[i];
+		ch->rx_pcks[i] = NULL;
+		*size = ch->rx_sizes[i];
+		return pck;
 	}
-	//add the packet to our Queue if any
+	return NULL;
+}
+
+/*gets the next packet to process, after reordering*/
+static char *gf_rtp_next_packet(GF_RTPChannel *ch, u32 *size)
+{
+	u32 seq_num;
+	char *pck;
+
+	if (ch->rx_pck) gf_rtp_packet_pool_release(ch->rx_pool, ch->rx_pck);
+	ch->rx_pck = NULL;
+
+	//flush the queue before reading the network
 	if (ch->po) {
-		if (res) {
-			seq_num = ((buffer[2] << 8) & 0xFF00) | (buffer[3] & 0xFF);
-			gf_rtp_reorderer_add(ch->po, (void *) buffer, res, seq_num);
+		pck = gf_rtp_reorderer_get_packet(ch->po, size);
+		if (pck) {
+			ch->rx_pck = pck;
+			return pck;
+		}
+	}
+	while (1) {
+		*size = 0;
+		pck = gf_rtp_fetch_packet(ch, size);
+		if (pck) {
+			ch->total_bytes += *size;
+			ch->total_pck++;
 		}
+		if (!ch->po) break;
 
-		//pck queue may need to be flushed
-		pck = (char *) gf_rtp_reorderer_get(ch->po, &res);
+		//add the packet to our Queue
 		if (pck) {
-			memcpy(buffer, pck, res);
-			gf_free(pck);
+			seq_num = ((pck[2] << 8) & 0xFF00) | (pck[3] & 0xFF);
+			gf_rtp_reorderer_add_packet(ch->po, pck, *size, seq_num);
 		}
+		//pck queue may need to be flushed
+		pck = gf_rtp_reorderer_get_packet(ch->po, size);
+		//nothing to output yet, queue the other packets already received
+		if (pck || (ch->rx_pos == ch->rx_nb)) break;
 	}
-	/*monitor keep-alive period*/
-	if (ch->nat_keepalive_time_period) {
-		u32 now = gf_sys_clock();
-		if (res) {
-			ch->last_nat_keepalive_time = now;
-		} else {
-			if (now - ch->last_nat_keepalive_time >= ch->nat_keepalive_time_period) {
-#if 0
-				char rtp_nat[12];
-				rtp_nat[0] = (u8) 0xC0;
-				rtp_nat[1] = ch->PayloadType;
-				rtp_nat[2] = (ch->last_pck_sn>>8)&0xFF;
-				rtp_nat[3] = (ch->last_pck_sn)&0xFF;
-				rtp_nat[4] = (ch->last_pck_ts>>24)&0xFF;
-				rtp_nat[5] = (ch->last_pck_ts>>16)&0xFF;
-				rtp_nat[6] = (ch->last_pck_ts>>8)&0xFF;
-				rtp_nat[7] = (ch->last_pck_ts)&0xFF;
-				rtp_nat[8] = (ch->SenderSSRC>>24)&0xFF;
-				rtp_nat[9] = (ch->SenderSSRC>>16)&0xFF;
-				rtp_nat[10] = (ch->SenderSSRC>>8)&0xFF;
-				rtp_nat[11] = (ch->SenderSSRC)&0xFF;
-#endif
-				e = gf_sk_send(ch->rtp, buffer, 12);
-				if (e) {
-					GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTP] Error sending NAT keep-alive packet: %s - disabling NAT\n", gf_error_to_string(e) ));
-					ch->nat_keepalive_time_period = 0;
-				} else {
-					GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[RTP] Sending NAT keep-alive packet - response %s\n", gf_error_to_string(e) ));
-				}
-				ch->last_nat_keepalive_time = now;
-			}
-		}
+	ch->rx_pck = pck;
+	if (!pck) *size = 0;
+	return pck;
+}
+
+/*monitors keep-alive period, hdr is the RTP header to send if any*/
+static void gf_rtp_check_nat_keepalive(GF_RTPChannel *ch, Bool received, char *hdr)
+{
+	GF_Err e;
+	u32 now;
+	char rtp_nat[12];
+
+	if (!ch->nat_keepalive_time_period) return;
+	now = gf_sys_clock();
+	if (received) {
+		ch->last_nat_keepalive_time = now;
+		return;
+	}
+	if (now - ch->last_nat_keepalive_time < ch->nat_keepalive_time_period) return;
+
+	if (!hdr) {
+		rtp_nat[0] = (u8) 0xC0;
+		rtp_nat[1] = ch->PayloadType;
+		rtp_nat[2] = (ch->last_pck_sn>>8)&0xFF;
+		rtp_nat[3] = (ch->last_pck_sn)&0xFF;
+		rtp_nat[4] = (ch->last_pck_ts>>24)&0xFF;
+		rtp_nat[5] = (ch->last_pck_ts>>16)&0xFF;
+		rtp_nat[6] = (ch->last_pck_ts>>8)&0xFF;
+		rtp_nat[7] = (ch->last_pck_ts)&0xFF;
+		rtp_nat[8] = (ch->SenderSSRC>>24)&0xFF;
+		rtp_nat[9] = (ch->SenderSSRC>>16)&0xFF;
+		rtp_nat[10] = (ch->SenderSSRC>>8)&0xFF;
+		rtp_nat[11] = (ch->SenderSSRC)&0xFF;
+		hdr = rtp_nat;
+	}
+	e = gf_sk_send(ch->rtp, hdr, 12);
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTP] Error sending NAT keep-alive packet: %s - disabling NAT\n", gf_error_to_string(e) ));
+		ch->nat_keepalive_time_period = 0;
+	} else {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[RTP] Sending NAT keep-alive packet - response %s\n", gf_error_to_string(e) ));
+	}
+	ch->last_nat_keepalive_time = now;
+}
+
+GF_EXPORT
+u32 gf_rtp_read_rtp(GF_RTPChannel *ch, char *buffer, u32 buffer_size)
+{
+	u32 res;
+	char *pck;
+
+	//only if the socket exist (otherwise RTSP interleaved channel)
+	if (!ch || !ch->rtp || !ch->rx_pool) return 0;
+
+	pck = gf_rtp_next_packet(ch, &res);
+	if (pck) {
+		if (res > buffer_size) res = buffer_size;
+		memcpy(buffer, pck, res);
+		gf_rtp_packet_pool_release(ch->rx_pool, pck);
+		ch->rx_pck = NULL;
 	}
+	gf_rtp_check_nat_keepalive(ch, res ? GF_TRUE : GF_FALSE, buffer);
 	return res;
 }
 
+GF_EXPORT
+char *gf_rtp_read_rtp_packet(GF_RTPChannel *ch, u32 *pck_size)
+{
+	char *pck;
+	u32 res;
+
+	if (pck_size) *pck_size = 0;
+	//only if the socket exist (otherwise RTSP interleaved channel)
+	if (!ch || !ch->rtp || !ch->rx_pool || !pck_size) return NULL;
+
+	pck = gf_rtp_next_packet(ch, &res);
+	gf_rtp_check_nat_keepalive(ch, pck ? GF_TRUE : GF_FALSE, NULL);
+	*pck_size = res;
+	return pck;
+}
+
 
 GF_EXPORT
 GF_Err gf_rtp_decode_rtp(GF_RTPChannel *ch, char *pck, u32 pck_size, GF_RTPHeader *rtp_hdr, u32 *PayloadStart)
@@ -566,14 +676,66 @@ Double gf_rtp_get_current_time(GF_RTPChannel *ch)
 
 
 
+/*max RTP header size (12 bytes + 15 CSRC)*/
+#define RTP_MAX_HEADER_SIZE	72
+
+/*writes the RTP header in place and returns its size*/
+static u32 gf_rtp_write_header(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, u8 *hdr)
+{
+	u32 i, pos;
+	hdr[0] = ((rtp_hdr->Version & 0x3) << 6) | ((rtp_hdr->Padding & 0x1) << 5) | ((rtp_hdr->Extension & 0x1) << 4) | (rtp_hdr->CSRCCount & 0xF);
+	hdr[1] = ((rtp_hdr->Marker & 0x1) << 7) | (rtp_hdr->PayloadType & 0x7F);
+	hdr[2] = (rtp_hdr->SequenceNumber >> 8) & 0xFF;
+	hdr[3] = rtp_hdr->SequenceNumber & 0xFF;
+	hdr[4] = (rtp_hdr->TimeStamp >> 24) & 0xFF;
+	hdr[5] = (rtp_hdr->TimeStamp >> 16) & 0xFF;
+	hdr[6] = (rtp_hdr->TimeStamp >> 8) & 0xFF;
+	hdr[7] = rtp_hdr->TimeStamp & 0xFF;
+	hdr[8] = (ch->SSRC >> 24) & 0xFF;
+	hdr[9] = (ch->SSRC >> 16) & 0xFF;
+	hdr[10] = (ch->SSRC >> 8) & 0xFF;
+	hdr[11] = ch->SSRC & 0xFF;
+	pos = 12;
+	for (i=0; i<rtp_hdr->CSRCCount; i++) {
+		hdr[pos] = (rtp_hdr->CSRC[i] >> 24) & 0xFF;
+		hdr[pos+1] = (rtp_hdr->CSRC[i] >> 16) & 0xFF;
+		hdr[pos+2] = (rtp_hdr->CSRC[i] >> 8) & 0xFF;
+		hdr[pos+3] = rtp_hdr->CSRC[i] & 0xFF;
+		pos += 4;
+	}
+	return pos;
+}
+
+/*updates sender report info once packets are sent - NTP is only queried once per call*/
+static void gf_rtp_on_packets_sent(GF_RTPChannel *ch, u32 nb_pck, u32 nb_bytes, u32 last_ts)
+{
+	//Update RTCP for sender reports
+	ch->pck_sent_since_last_sr += nb_pck;
+	if (ch->first_SR) {
+		//get a new report time
+		gf_rtp_get_next_report_time(ch);
+		ch->num_payload_bytes = 0;
+		ch->num_pck_sent = 0;
+		ch->first_SR = 0;
+	}
+
+	ch->num_payload_bytes += nb_bytes;
+	ch->num_pck_sent += nb_pck;
+	//store timing
+	ch->last_pck_ts = last_ts;
+	gf_net_get_ntp(&ch->last_pck_ntp_sec, &ch->last_pck_ntp_frac);
+
+	if (ch->no_auto_rtcp) return;
+	/*same as gf_rtp_get_report_time, no need to query the clock again if no report is due*/
+	if ((u32) ( (ch->last_pck_ntp_frac>>16) + 0x10000L*ch->last_pck_ntp_sec ) < ch->next_report_time) return;
+	gf_rtp_send_rtcp_report(ch, NULL, NULL);
+}
+
 GF_EXPORT
 GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, char *pck, u32 pck_size, Bool fast_send)
 {
 	GF_Err e;
-	u32 i, Start;
-	char *hdr = NULL;
-
-	GF_BitStream *bs;
+	u32 Start;
 
 	if (!ch || !rtp_hdr
 	        || !ch->send_buffer
@@ -585,56 +747,59 @@ GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, char *pck, u
 	if (12 + pck_size + 4*rtp_hdr->CSRCCount > ch->send_buffer_size) return GF_IO_ERR;
 
 	if (fast_send) {
-		hdr = pck - 12;
-		bs = gf_bs_new(hdr, 12, GF_BITSTREAM_WRITE);
-	} else {
-		bs = gf_bs_new(ch->send_buffer, ch->send_buffer_size, GF_BITSTREAM_WRITE);
-	}
-	//write header
-	gf_bs_write_int(bs, rtp_hdr->Version, 2);
-	gf_bs_write_int(bs, rtp_hdr->Padding, 1);
-	gf_bs_write_int(bs, rtp_hdr->Extension, 1);
-	gf_bs_write_int(bs, rtp_hdr->CSRCCount, 4);
-	gf_bs_write_int(bs, rtp_hdr->Marker, 1);
-	gf_bs_write_int(bs, rtp_hdr->PayloadType, 7);
-	gf_bs_write_u16(bs, rtp_hdr->SequenceNumber);
-	gf_bs_write_u32(bs, rtp_hdr->TimeStamp);
-	gf_bs_write_u32(bs, ch->SSRC);
-
-	for (i=0; i<rtp_hdr->CSRCCount; i++) {
-		gf_bs_write_u32(bs, rtp_hdr->CSRC[i]);
-	}
-	//nb: RTP header is always aligned
-	Start = (u32) gf_bs_get_position(bs);
-	gf_bs_del(bs);
-
-	//copy payload
-	if (fast_send) {
-		e = gf_sk_send(ch->rtp, hdr, pck_size+12);
+		gf_rtp_write_header(ch, rtp_hdr, (u8 *) pck - 12);
+		e = gf_sk_send(ch->rtp, pck - 12, pck_size+12);
 	} else {
+		//nb: RTP header is always aligned
+		Start = gf_rtp_write_header(ch, rtp_hdr, (u8 *) ch->send_buffer);
+		//copy payload
 		memcpy(ch->send_buffer + Start, pck, pck_size);
 		e = gf_sk_send(ch->rtp, ch->send_buffer, Start + pck_size);
 	}
 	if (e) return e;
 
-	//Update RTCP for sender reports
-	ch->pck_sent_since_last_sr += 1;
-	if (ch->first_SR) {
-		//get a new report time
-		gf_rtp_get_next_report_time(ch);
-		ch->num_payload_bytes = 0;
-		ch->num_pck_sent = 0;
-		ch->first_SR = 0;
+	gf_rtp_on_packets_sent(ch, 1, pck_size, rtp_hdr->TimeStamp);
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_send_packets(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdrs, char **pcks, u32 *pck_sizes, u32 nb_pcks)
+{
+	GF_Err e;
+	u32 i, nb_sent, nb_bytes;
+
+	if (!ch || !ch->send_buffer || (nb_pcks && (!rtp_hdrs || !pcks || !pck_sizes))) return GF_BAD_PARAM;
+	if (!nb_pcks) return GF_OK;
+
+	if (ch->batch_alloc < nb_pcks) {
+		ch->batch_hdrs = (char*)gf_realloc(ch->batch_hdrs, sizeof(char) * RTP_MAX_HEADER_SIZE * nb_pcks);
+		ch->batch_dgrams = (GF_SockDatagram*)gf_realloc(ch->batch_dgrams, sizeof(GF_SockDatagram) * nb_pcks);
+		if (!ch->batch_hdrs || !ch->batch_dgrams) {
+			ch->batch_alloc = 0;
+			return GF_OUT_OF_MEM;
+		}
+		ch->batch_alloc = nb_pcks;
+	}
+	/*headers are written in a separate buffer and sent together with the payloads, no copy*/
+	for (i=0; i<nb_pcks; i++) {
+		char *hdr = ch->batch_hdrs + i*RTP_MAX_HEADER_SIZE;
+		if (!pcks[i] || (rtp_hdrs[i].CSRCCount > 15)) return GF_BAD_PARAM;
+		if (12 + pck_sizes[i] + 4*rtp_hdrs[i].CSRCCount > ch->send_buffer_size) return GF_IO_ERR;
+
+		ch->batch_dgrams[i].header = hdr;
+		ch->batch_dgrams[i].header_size = gf_rtp_write_header(ch, &rtp_hdrs[i], (u8 *) hdr);
+		ch->batch_dgrams[i].data = pcks[i];
+		ch->batch_dgrams[i].size = pck_sizes[i];
 	}
 
-	ch->num_payload_bytes += pck_size;
-	ch->num_pck_sent += 1;
-	//store timing
-	ch->last_pck_ts = rtp_hdr->TimeStamp;
-	gf_net_get_ntp(&ch->last_pck_ntp_sec, &ch->last_pck_ntp_frac);
+	nb_sent = 0;
+	e = gf_sk_send_batch(ch->rtp, ch->batch_dgrams, nb_pcks, &nb_sent);
+	if (!nb_sent) return e;
 
-	if (!ch->no_auto_rtcp) gf_rtp_send_rtcp_report(ch, NULL, NULL);
-	return GF_OK;
+	nb_bytes = 0;
+	for (i=0; i<nb_sent; i++) nb_bytes += pck_sizes[i];
+	gf_rtp_on_packets_sent(ch, nb_sent, nb_bytes, rtp_hdrs[nb_sent-1].TimeStamp);
+	return e;
 }
 
 GF_EXPORT
@@ -784,6 +949,76 @@ void gf_rtp_get_ports(GF_RTPChannel *ch, u16 *rtp_port, u16 *rtcp_port)
 */
 
 #define SN_CHECK_OFFSET		0x0A
+/*size of the packets pooled by a reorderer copying its input*/
+#define PO_PCK_SIZE			2048
+
+#define PO_ITEM(_pck)	((GF_POItem *) ((char *) (_pck) - sizeof(GF_POItem)))
+
+GF_EXPORT
+GF_RTPPacketPool *gf_rtp_packet_pool_new(u32 pck_size, u32 max_free)
+{
+	GF_RTPPacketPool *tmp;
+	GF_SAFEALLOC(tmp, GF_RTPPacketPool);
+	if (!tmp) return NULL;
+	tmp->pck_size = pck_size;
+	tmp->max_free = max_free;
+	return tmp;
+}
+
+GF_EXPORT
+void gf_rtp_packet_pool_del(GF_RTPPacketPool *pool)
+{
+	if (!pool) return;
+	while (pool->free_items) {
+		GF_POItem *it = pool->free_items;
+		pool->free_items = it->next;
+		gf_free(it);
+	}
+	gf_free(pool);
+}
+
+GF_EXPORT
+char *gf_rtp_packet_pool_get(GF_RTPPacketPool *pool, u32 size)
+{
+	GF_POItem *it;
+	if (!pool) return NULL;
+
+	if (size <= pool->pck_size) {
+		if (pool->free_items) {
+			it = pool->free_items;
+			pool->free_items = it->next;
+			pool->nb_free--;
+			it->next = NULL;
+			return it->pck;
+		}
+		size = pool->pck_size;
+	}
+	/*the packet is stored right after its item*/
+	it = (GF_POItem *) gf_malloc(sizeof(GF_POItem) + size);
+	if (!it) return NULL;
+	memset(it, 0, sizeof(GF_POItem));
+	it->pck = (char *) (it + 1);
+	it->alloc_size = size;
+	return it->pck;
+}
+
+static void gf_rtp_packet_pool_release_item(GF_RTPPacketPool *pool, GF_POItem *it)
+{
+	/*only keep packets of the pool size*/
+	if ((it->alloc_size != pool->pck_size) || (pool->max_free && (pool->nb_free >= pool->max_free))) {
+		gf_free(it);
+		return;
+	}
+	it->next = pool->free_items;
+	pool->free_items = it;
+	pool->nb_free++;
+}
+
+GF_EXPORT
+void gf_rtp_packet_pool_release(GF_RTPPacketPool *pool, char *pck)
+{
+	if (pool && pck) gf_rtp_packet_pool_release_item(pool, PO_ITEM(pck));
+}
 
 GF_EXPORT
 GF_RTPReorder *gf_rtp_reorderer_new(u32 MaxCount, u32 MaxDelay)
@@ -799,12 +1034,12 @@ GF_RTPReorder *gf_rtp_reorderer_new(u32 MaxCount, u32 MaxDelay)
 	return tmp;
 }
 
-static void DelItem(GF_POItem *it)
+static void DelItems(GF_RTPReorder *po)
 {
-	if (it) {
-		if (it->next) DelItem(it->next);
-		gf_free(it->pck);
-		gf_free(it);
+	while (po->in) {
+		GF_POItem *it = po->in;
+		po->in = it->next;
+		gf_rtp_packet_pool_release_item(po->pool, it);
 	}
 }
 
@@ -812,7 +1047,8 @@ static void DelItem(GF_POItem *it)
 GF_EXPORT
 void gf_rtp_reorderer_del(GF_RTPReorder *po)
 {
-	if (po->in) DelItem(po->in);
+	DelItems(po);
+	if (po->own_pool) gf_rtp_packet_pool_del(po->pool);
 	gf_free(po);
 }
 
@@ -821,27 +1057,52 @@ void gf_rtp_reorderer_reset(GF_RTPReorder *po)
 {
 	if (!po) return;
 
-	if (po->in) DelItem(po->in);
+	DelItems(po);
 	po->head_seqnum = 0;
 	po->Count = 0;
 	po->IsInit = 0;
 	po->in = NULL;
 }
 
+GF_EXPORT
+void gf_rtp_reorderer_set_pool(GF_RTPReorder *po, GF_RTPPacketPool *pool)
+{
+	if (!po) return;
+	gf_rtp_reorderer_reset(po);
+	if (po->own_pool) gf_rtp_packet_pool_del(po->pool);
+	po->pool = pool;
+	po->own_pool = GF_FALSE;
+}
+
 GF_EXPORT
 GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u32 pck_seqnum)
+{
+	char *copy;
+	if (!po) return GF_BAD_PARAM;
+
+	if (!po->pool) {
+		po->pool = gf_rtp_packet_pool_new(PO_PCK_SIZE, po->MaxCount);
+		if (!po->pool) return GF_OUT_OF_MEM;
+		po->own_pool = GF_TRUE;
+	}
+	copy = gf_rtp_packet_pool_get(po->pool, pck_size);
+	if (!copy) return GF_OUT_OF_MEM;
+	memcpy(copy, pck, pck_size);
+	return gf_rtp_reorderer_add_packet(po, copy, pck_size, pck_seqnum);
+}
+
+GF_EXPORT
+GF_Err gf_rtp_reorderer_add_packet(GF_RTPReorder *po, char *pck, u32 pck_size, u32 pck_seqnum)
 {
 	GF_POItem *it, *cur;
 	u32 bounds;
 
-	if (!po) return GF_BAD_PARAM;
+	if (!po || !po->pool || !pck) return GF_BAD_PARAM;
 
-	it = (GF_POItem *) gf_malloc(sizeof(GF_POItem));
+	it = PO_ITEM(pck);
 	it->pck_seq_num = pck_seqnum;
 	it->next = NULL;
 	it->size = pck_size;
-	it->pck = gf_malloc(pck_size);
-	memcpy(it->pck, pck, pck_size);
 	/*reset timeout*/
 	po->LastTime = 0;
 
@@ -912,21 +1173,19 @@ GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u
 
 
 discard:
-	gf_free(it->pck);
-	gf_free(it);
+	gf_rtp_packet_pool_release_item(po->pool, it);
 	GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[rtp] Packet Reorderer: Dropping packet %d\n", pck_seqnum));
 	return GF_OK;
 }
 
 //retrieve the first available packet. Note that the behavior will be undefined if the first
 //ever received packet if its SeqNum was unknown
-//the BUFFER is yours, you must delete it
+//the packet must be given back to the pool
 GF_EXPORT
-void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size)
+char *gf_rtp_reorderer_get_packet(GF_RTPReorder *po, u32 *pck_size)
 {
 	GF_POItem *t;
 	u32 bounds;
-	void *ret;
 
 	if (!po || !pck_size) return NULL;
 
@@ -982,9 +1241,21 @@ send_it:
 	//no other output. reset the head seqnum
 	po->head_seqnum = po->in ? po->in->pck_seq_num : 0;
 	po->Count -= 1;
-	//release the item
-	ret = t->pck;
-	gf_free(t);
+	return t->pck;
+}
+
+//the BUFFER is yours, you must delete it
+GF_EXPORT
+void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size)
+{
+	char *pck, *ret;
+
+	pck = gf_rtp_reorderer_get_packet(po, pck_size);
+	if (!pck) return NULL;
+	ret = (char *) gf_malloc(*pck_size);
+	if (ret) memcpy(ret, pck, *pck_size);
+	else *pck_size = 0;
+	gf_rtp_packet_pool_release(po->pool, pck);
 	return ret;
 }
 
@@ -39,13 +39,24 @@ struct __rtp_streamer
 	GP_RTPPacketizer *packetizer;
 	GF_RTPChannel *channel;
 
-	/* The current packet being formed */
+	/* packet storage, one packet or burst_max packets in burst mode*/
 	char *buffer;
+	/* The current packet being formed */
+	char *pck;
 	u32 payload_len, buffer_alloc;
 
+	/*burst mode: packets are queued and sent in a single call at the end of each gf_rtp_streamer_send_data*/
+	u32 burst_max, nb_burst;
+	GF_RTPHeader *burst_hdrs;
+	char **burst_pcks;
+	u32 *burst_sizes;
+
 	Double ts_scale;
 };
 
+/*default number of packets queued per burst*/
+#define RTP_STREAMER_DEFAULT_BURST	32
+
 
 /*callbacks from packetizer to channel*/
 
@@ -53,10 +64,51 @@ static void rtp_stream_on_new_packet(void *cbk, GF_RTPHeader *header)
 {
 }
 
+static GF_Err rtp_stream_flush_burst(GF_RTPStreamer *rtp)
+{
+	GF_Err e;
+	if (!rtp->nb_burst) return GF_OK;
+
+	e = gf_rtp_send_packets(rtp->channel, rtp->burst_hdrs, rtp->burst_pcks, rtp->burst_sizes, rtp->nb_burst);
+
+#ifndef GPAC_DISABLE_LOG
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("Error %s sending RTP packet burst\n", gf_error_to_string(e)));
+	} else if (gf_log_tool_level_on(GF_LOG_RTP, GF_LOG_DEBUG)) {
+		u32 i;
+		for (i=0; i<rtp->nb_burst; i++) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("RTP SN %u - TS %u - M %u - Size %u\n", rtp->burst_hdrs[i].SequenceNumber, rtp->burst_hdrs[i].TimeStamp, rtp->burst_hdrs[i].Marker, rtp->burst_sizes[i] + 12));
+		}
+	}
+#endif
+	rtp->nb_burst = 0;
+	/*packet being formed (aggregation across AUs) is moved to the first slot*/
+	if (rtp->payload_len && (rtp->pck != rtp->buffer)) memmove(rtp->buffer, rtp->pck, rtp->payload_len + 12);
+	rtp->pck = rtp->buffer;
+	return e;
+}
+
 static void rtp_stream_on_packet_done(void *cbk, GF_RTPHeader *header)
 {
 	GF_RTPStreamer *rtp = (GF_RTPStreamer*)cbk;
-	GF_Err e = gf_rtp_send_packet(rtp->channel, header, rtp->buffer+12, rtp->payload_len, GF_TRUE);
+	GF_Err e;
+
+	if (rtp->burst_max) {
+		/*packet bigger than MTU, discarded*/
+		if (rtp->payload_len + 12 > rtp->buffer_alloc) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("Error %s sending RTP packet\n", gf_error_to_string(GF_IO_ERR)));
+		} else {
+			rtp->burst_hdrs[rtp->nb_burst] = *header;
+			rtp->burst_sizes[rtp->nb_burst] = rtp->payload_len;
+			rtp->nb_burst++;
+		}
+		rtp->payload_len = 0;
+		rtp->pck = rtp->buffer + rtp->nb_burst * rtp->buffer_alloc;
+		if (rtp->nb_burst == rtp->burst_max) rtp_stream_flush_burst(rtp);
+		return;
+	}
+
+	e = gf_rtp_send_packet(rtp->channel, header, rtp->pck+12, rtp->payload_len, GF_TRUE);
 
 #ifndef GPAC_DISABLE_LOG
 	if (e) {
@@ -79,10 +131,10 @@ static void rtp_stream_on_data(void *cbk, char *data, u32 data_size, Bool is_hea
 		return;
 	}
 	if (!is_head) {
-		memcpy(rtp->buffer + rtp->payload_len + 12, data, data_size);
+		memcpy(rtp->pck + rtp->payload_len + 12, data, data_size);
 	} else {
-		memmove(rtp->buffer + data_size + 12, rtp->buffer + 12, rtp->payload_len);
-		memcpy(rtp->buffer + 12, data, data_size);
+		memmove(rtp->pck + data_size + 12, rtp->pck + 12, rtp->payload_len);
+		memcpy(rtp->pck + 12, data, data_size);
 	}
 	rtp->payload_len += data_size;
 }
@@ -488,7 +540,10 @@ GF_RTPStreamer *gf_rtp_streamer_new_extended(u32 streamType, u32 oti, u32 timeSc
 	stream->ts_scale /= timeScale;
 
 	stream->buffer_alloc = MTU+12;
-	stream->buffer = (char*)gf_malloc(sizeof(char) * stream->buffer_alloc);
+	if (gf_rtp_streamer_set_burst(stream, RTP_STREAMER_DEFAULT_BURST) != GF_OK) {
+		gf_rtp_streamer_del(stream);
+		return NULL;
+	}
 
 	return stream;
 }
@@ -512,6 +567,9 @@ void gf_rtp_streamer_del(GF_RTPStreamer *streamer)
 		if (streamer->channel) gf_rtp_del(streamer->channel);
 		if (streamer->packetizer) gf_rtp_builder_del(streamer->packetizer);
 		if (streamer->buffer) gf_free(streamer->buffer);
+		if (streamer->burst_hdrs) gf_free(streamer->burst_hdrs);
+		if (streamer->burst_pcks) gf_free(streamer->burst_pcks);
+		if (streamer->burst_sizes) gf_free(streamer->burst_sizes);
 		gf_free(streamer);
 	}
 }
@@ -813,6 +871,7 @@ GF_Err gf_rtp_streamer_append_sdp(GF_RTPStreamer *rtp, u16 ESID, char *dsi, u32
 GF_EXPORT
 GF_Err gf_rtp_streamer_send_data(GF_RTPStreamer *rtp, char *data, u32 size, u32 fullsize, u64 cts, u64 dts, Bool is_rap, Bool au_start, Bool au_end, u32 au_sn, u32 sampleDuration, u32 sampleDescIndex)
 {
+	GF_Err e;
 	rtp->packetizer->sl_header.compositionTimeStamp = (u64) (cts*rtp->ts_scale);
 	rtp->packetizer->sl_header.decodingTimeStamp = (u64) (dts*rtp->ts_scale);
 	rtp->packetizer->sl_header.randomAccessPointFlag = is_rap;
@@ -822,7 +881,34 @@ GF_Err gf_rtp_streamer_send_data(GF_RTPStreamer *rtp, char *data, u32 size, u32
 	rtp->packetizer->sl_header.AU_sequenceNumber = au_sn;
 	sampleDuration = (u32) (sampleDuration * rtp->ts_scale);
 
-	return gf_rtp_builder_process(rtp->packetizer, data, size, (u8) au_end, fullsize, sampleDuration, sampleDescIndex);
+	e = gf_rtp_builder_process(rtp->packetizer, data, size, (u8) au_end, fullsize, sampleDuration, sampleDescIndex);
+	/*send all packets produced for this data - errors are logged, as in non-burst mode*/
+	rtp_stream_flush_burst(rtp);
+	return e;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_streamer_set_burst(GF_RTPStreamer *rtp, u32 max_packets)
+{
+	u32 i, nb_slots;
+	if (!rtp) return GF_BAD_PARAM;
+	if (max_packets == 1) max_packets = 0;
+
+	/*also moves the packet being formed to the first slot*/
+	rtp_stream_flush_burst(rtp);
+	nb_slots = max_packets ? max_packets : 1;
+	rtp->buffer = (char*)gf_realloc(rtp->buffer, sizeof(char) * rtp->buffer_alloc * nb_slots);
+	rtp->burst_hdrs = (GF_RTPHeader*)gf_realloc(rtp->burst_hdrs, sizeof(GF_RTPHeader) * nb_slots);
+	rtp->burst_pcks = (char**)gf_realloc(rtp->burst_pcks, sizeof(char *) * nb_slots);
+	rtp->burst_sizes = (u32*)gf_realloc(rtp->burst_sizes, sizeof(u32) * nb_slots);
+	rtp->pck = rtp->buffer;
+	if (!rtp->buffer || !rtp->burst_hdrs || !rtp->burst_pcks || !rtp->burst_sizes) {
+		rtp->burst_max = 0;
+		return GF_OUT_OF_MEM;
+	}
+	for (i=0; i<nb_slots; i++) rtp->burst_pcks[i] = rtp->buffer + i*rtp->buffer_alloc + 12;
+	rtp->burst_max = max_packets;
+	return GF_OK;
 }
 
 GF_EXPORT
@@ -5274,6 +5274,7 @@ void stbl_del(GF_Box *s)
 		if (ptr->traf_map->sample_num) gf_free(ptr->traf_map->sample_num);
 		gf_free(ptr->traf_map);
 	}
+	if (ptr->sample_index) stbl_del_sample_index(ptr->sample_index);
 
 	gf_free(ptr);
 }
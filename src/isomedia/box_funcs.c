@@ -1303,9 +1303,161 @@ static struct box_registry_entry {
 	BOX_DEFINE_S(GF_ISOM_BOX_TYPE_PNG, video_sample_entry, "stsd", "apple")
 };
 
+/*box registry lookup tables, built once on first use: an open-addressing hash on the box 4CC gives the first registry
+entry for that code, and entries sharing the same 4CC are chained in registry order. Parent strings are split into 4CCs
+so that resolving a box type never goes through strstr nor gf_4cc_to_str*/
+#define BOX_REG_HASH_BITS	11
+#define BOX_REG_HASH_SIZE	(1<<BOX_REG_HASH_BITS)
+#define BOX_REG_MAX_PARENTS	16
+
+enum
+{
+	BOX_REG_PARENT_ANY = 1,
+	BOX_REG_PARENT_FILE = 1<<1,
+	BOX_REG_PARENT_STSD = 1<<2,
+	BOX_REG_PARENT_SAMPLE_ENTRY = 1<<3,
+	BOX_REG_PARENT_VIDEO_SAMPLE_ENTRY = 1<<4,
+};
+
+typedef struct
+{
+	//next registry entry with the same 4CC, 0 if none
+	u16 next;
+	u8 nb_parents;
+	u8 parent_flags;
+	u32 parents[BOX_REG_MAX_PARENTS];
+} BoxRegistryInfo;
+
+static u16 box_reg_hash[BOX_REG_HASH_SIZE];
+static BoxRegistryInfo box_reg_info[sizeof(box_registry) / sizeof(struct box_registry_entry)];
+
+/*the tables are built by the first thread claiming them and published once complete, other threads wait for the publication*/
+enum
+{
+	BOX_REG_NONE = 0,
+	BOX_REG_BUILDING,
+	BOX_REG_READY,
+};
+static volatile u32 box_reg_state = BOX_REG_NONE;
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define box_reg_claim()	(_InterlockedCompareExchange((long volatile *) &box_reg_state, BOX_REG_BUILDING, BOX_REG_NONE) == BOX_REG_NONE)
+#define box_reg_publish()	_InterlockedExchange((long volatile *) &box_reg_state, BOX_REG_READY)
+#define box_reg_ready()	(_InterlockedCompareExchange((long volatile *) &box_reg_state, BOX_REG_READY, BOX_REG_READY) == BOX_REG_READY)
+#elif defined(__GNUC__)
+#define box_reg_claim()	__sync_bool_compare_and_swap(&box_reg_state, BOX_REG_NONE, BOX_REG_BUILDING)
+#define box_reg_publish()	{ __sync_synchronize(); box_reg_state = BOX_REG_READY; }
+#define box_reg_ready()	(__atomic_load_n(&box_reg_state, __ATOMIC_ACQUIRE) == BOX_REG_READY)
+#else
+#define box_reg_claim()	((box_reg_state == BOX_REG_NONE) ? (box_reg_state = BOX_REG_BUILDING, GF_TRUE) : GF_FALSE)
+#define box_reg_publish()	box_reg_state = BOX_REG_READY
+#define box_reg_ready()	(box_reg_state == BOX_REG_READY)
+#endif
+
+#define BOX_REG_HASH(_4cc)	( ((u32) (_4cc) * 2654435761U) >> (32 - BOX_REG_HASH_BITS) )
+
+static void box_registry_parse_parents(u32 idx)
+{
+	BoxRegistryInfo *info = &box_reg_info[idx];
+	const char *str = box_registry[idx].parents_4cc;
+
+	info->nb_parents = 0;
+	info->parent_flags = 0;
+	if (!str) return;
+	while (*str) {
+		u32 len=0;
+		while (*str==' ') str++;
+		while (str[len] && (str[len]!=' ')) len++;
+		if (!len) break;
+
+		if ((len==1) && (str[0]=='*')) {
+			info->parent_flags |= BOX_REG_PARENT_ANY;
+		} else if ((len==3) || (len==4)) {
+			//3-letter codes such as "rtp " are padded with a space
+			u32 code = GF_4CC(str[0], str[1], str[2], (len==4) ? str[3] : ' ');
+			if (code==GF_ISOM_BOX_TYPE_STSD) info->parent_flags |= BOX_REG_PARENT_STSD;
+			else if (code==GF_4CC('f','i','l','e')) info->parent_flags |= BOX_REG_PARENT_FILE;
+
+			if (info->nb_parents<BOX_REG_MAX_PARENTS) {
+				info->parents[info->nb_parents] = code;
+				info->nb_parents++;
+			} else {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[iso file] Too many parents declared for box %s in registry\n", gf_4cc_to_str(box_registry[idx].box_4cc) ));
+			}
+		} else if ((len>=12) && !strncmp(str + len - 12, "sample_entry", 12)) {
+			info->parent_flags |= BOX_REG_PARENT_SAMPLE_ENTRY;
+			if ((len==18) && !strncmp(str, "video_", 6))
+				info->parent_flags |= BOX_REG_PARENT_VIDEO_SAMPLE_ENTRY;
+		}
+		//other names (unknown, text_sample, rtp_packet, ...) are sample formats and never match a parent box
+		str += len;
+	}
+}
+
+static void box_registry_init()
+{
+	u16 last[BOX_REG_HASH_SIZE];
+	u32 i, count = gf_isom_get_num_supported_boxes();
+
+	if (!box_reg_claim()) {
+		//another thread is building the tables, which only takes a few microseconds
+		while (!box_reg_ready()) gf_sleep(0);
+		return;
+	}
+
+	assert(count < BOX_REG_HASH_SIZE/2);
+	memset(last, 0, sizeof(last));
+	for (i=0; i<count; i++) {
+		u32 h;
+		box_registry_parse_parents(i);
+		//entry 0 is the unknown box, never returned by lookups
+		if (!i) continue;
+
+		box_reg_info[i].next = 0;
+		h = BOX_REG_HASH(box_registry[i].box_4cc);
+		while (box_reg_hash[h] && (box_registry[ box_reg_hash[h] ].box_4cc != box_registry[i].box_4cc)) {
+			h = (h+1) & (BOX_REG_HASH_SIZE-1);
+		}
+		if (!box_reg_hash[h]) {
+			box_reg_hash[h] = i;
+		} else {
+			box_reg_info[ last[h] ].next = i;
+		}
+		last[h] = i;
+	}
+	box_reg_publish();
+}
+
+/*returns the first registry entry for the given 4CC, or 0 if none*/
+static GFINLINE u32 box_registry_find(u32 boxCode)
+{
+	u32 h = BOX_REG_HASH(boxCode);
+	while (box_reg_hash[h]) {
+		if (box_registry[ box_reg_hash[h] ].box_4cc == boxCode) return box_reg_hash[h];
+		h = (h+1) & (BOX_REG_HASH_SIZE-1);
+	}
+	return 0;
+}
+
+static GFINLINE Bool box_registry_has_parent(u32 idx, u32 parent_type)
+{
+	u32 i;
+	for (i=0; i<box_reg_info[idx].nb_parents; i++) {
+		if (box_reg_info[idx].parents[i] == parent_type) return GF_TRUE;
+	}
+	return GF_FALSE;
+}
+
+#define BOX_REG_IDX(_reg)	((u32) ((_reg) - box_registry))
+
 Bool gf_box_valid_in_parent(GF_Box *a, const char *parent_4cc)
 {
 	if (!a || !a->registry || !a->registry->parents_4cc) return GF_FALSE;
+	if (!box_reg_ready()) box_registry_init();
+	if (strlen(parent_4cc)==4) {
+		return box_registry_has_parent(BOX_REG_IDX(a->registry), GF_4CC(parent_4cc[0], parent_4cc[1], parent_4cc[2], parent_4cc[3]) );
+	}
 	if (strstr(a->registry->parents_4cc, parent_4cc) != NULL) return GF_TRUE;
 	return GF_FALSE;
 }
@@ -1318,31 +1470,28 @@ u32 gf_isom_get_num_supported_boxes()
 
 void gf_isom_registry_disable(u32 boxCode, Bool disable)
 {
-	u32 i=0, count = gf_isom_get_num_supported_boxes();
-	for (i=1; i<count; i++) {
-		if (box_registry[i].box_4cc==boxCode) {
-			box_registry[i].disabled = disable;
-			return;
-		}
-	}
+	u32 idx;
+	if (!box_reg_ready()) box_registry_init();
+	idx = box_registry_find(boxCode);
+	if (idx) box_registry[idx].disabled = disable;
 }
 
 static u32 get_box_reg_idx(u32 boxCode, u32 parent_type)
 {
-	u32 i=0, count = gf_isom_get_num_supported_boxes();
-	const char *parent_name = parent_type ? gf_4cc_to_str(parent_type) : NULL;
-
-	for (i=1; i<count; i++) {
-		if (box_registry[i].box_4cc==boxCode) {
-			if (!parent_type) return i;
-			if (strstr(box_registry[i].parents_4cc, parent_name) != NULL) return i;
-
-			if (strstr(box_registry[i].parents_4cc, "sample_entry") != NULL) {
-				u32 j = get_box_reg_idx(parent_type, 0);
-				if (box_registry[j].parents_4cc && (strstr(box_registry[j].parents_4cc, "stsd") != NULL))
-					return i;
-			}
+	u32 i;
+	if (!box_reg_ready()) box_registry_init();
+
+	i = box_registry_find(boxCode);
+	while (i) {
+		if (!parent_type) return i;
+		if (box_registry_has_parent(i, parent_type)) return i;
+
+		if (box_reg_info[i].parent_flags & BOX_REG_PARENT_SAMPLE_ENTRY) {
+			u32 j = box_registry_find(parent_type);
+			if (j && (box_reg_info[j].parent_flags & BOX_REG_PARENT_STSD))
+				return i;
 		}
+		i = box_reg_info[i].next;
 	}
 	return 0;
 }
@@ -1437,21 +1586,22 @@ GF_Err gf_isom_box_array_read_ex(GF_Box *parent, GF_BitStream *bs, GF_Err (*add_
 		}
 
 		//check container validity
-		if (strlen(a->registry->parents_4cc)) {
+		if (a->registry->parents_4cc[0]) {
 			Bool parent_OK = GF_FALSE;
-			const char *parent_code = gf_4cc_to_str(parent->type);
+			u32 a_flags = box_reg_info[ BOX_REG_IDX(a->registry) ].parent_flags;
+			u32 parent_code = parent->type;
 			if (parent->type == GF_ISOM_BOX_TYPE_UNKNOWN)
-				parent_code = gf_4cc_to_str( ((GF_UnknownBox*)parent)->original_4cc );
-			if (strstr(a->registry->parents_4cc, parent_code) != NULL) {
+				parent_code = ((GF_UnknownBox*)parent)->original_4cc;
+			if (box_registry_has_parent(BOX_REG_IDX(a->registry), parent_code)) {
 				parent_OK = GF_TRUE;
-			} else if (!strcmp(a->registry->parents_4cc, "*") || strstr(a->registry->parents_4cc, "* ") || strstr(a->registry->parents_4cc, " *")) {
+			} else if (a_flags & BOX_REG_PARENT_ANY) {
 				parent_OK = GF_TRUE;
 			} else {
 				//parent must be a sample entry
-				if (strstr(a->registry->parents_4cc, "sample_entry") !=	NULL) {
+				if (a_flags & BOX_REG_PARENT_SAMPLE_ENTRY) {
 					//parent is in an stsd
-					if (strstr(parent->registry->parents_4cc, "stsd") != NULL) {
-						if (strstr(a->registry->parents_4cc, "video_sample_entry") !=	NULL) {
+					if (box_reg_info[ BOX_REG_IDX(parent->registry) ].parent_flags & BOX_REG_PARENT_STSD) {
+						if (a_flags & BOX_REG_PARENT_VIDEO_SAMPLE_ENTRY) {
 							if (((GF_SampleEntryBox*)parent)->internal_type==GF_ISOM_SAMPLE_ENTRY_VIDEO) {
 								parent_OK = GF_TRUE;
 							}
@@ -1465,7 +1615,7 @@ GF_Err gf_isom_box_array_read_ex(GF_Box *parent, GF_BitStream *bs, GF_Err (*add_
 				else if (a->type==GF_ISOM_BOX_TYPE_UUID) parent_OK = GF_TRUE;
 			}
 			if (! parent_OK && !skip_logs) {
-				GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[iso file] Box \"%s\" is invalid in container %s\n", gf_4cc_to_str(a->type), parent_code));
+				GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[iso file] Box \"%s\" is invalid in container %s\n", gf_4cc_to_str(a->type), gf_4cc_to_str(parent_code) ));
 			}
 		}
 
@@ -1754,8 +1904,8 @@ void gf_isom_box_dump_done(const char *name, GF_Box *ptr, FILE *trace)
 Bool gf_isom_box_is_file_level(GF_Box *s)
 {
 	if (!s || !s->registry) return GF_FALSE;
-	if (strstr(s->registry->parents_4cc, "file")!= NULL) return GF_TRUE;
-	if (strstr(s->registry->parents_4cc, "*")!= NULL) return GF_TRUE;
+	if (!box_reg_ready()) box_registry_init();
+	if (box_reg_info[ BOX_REG_IDX(s->registry) ].parent_flags & (BOX_REG_PARENT_FILE | BOX_REG_PARENT_ANY)) return GF_TRUE;
 	return GF_FALSE;
 }
 #endif
@@ -168,7 +168,12 @@ GF_Err gf_isom_datamap_new(const char *location, const char *parentPath, u8 mode
 		return GF_URL_ERROR;
 	}
 
-	if (mode == GF_ISOM_DATA_MAP_READ_ONLY) {
+	if (mode == GF_ISOM_DATA_MAP_READ_MMAP) {
+		mode = GF_ISOM_DATA_MAP_READ;
+		*outDataMap = gf_isom_fmo_new(sPath, mode);
+		//mapping not possible (empty file, no support, address space too small): use regular IO
+		if (! (*outDataMap)) *outDataMap = gf_isom_fdm_new(sPath, mode);
+	} else if (mode == GF_ISOM_DATA_MAP_READ_ONLY) {
 		mode = GF_ISOM_DATA_MAP_READ;
 		/*It seems win32 file mapping is reported in prog mem usage -> large increases of occupancy. Should not be a pb
 		but unless you want mapping, only regular IO will be used...*/
@@ -555,33 +560,40 @@ GF_Err FDM_AddData(GF_FileDataMap *ptr, char *data, u32 dataSize)
 #endif	/*GPAC_DISABLE_ISOM_WRITE*/
 
 
-#ifdef WIN32
+#if defined(WIN32)
 
 #include <windows.h>
 #include <winerror.h>
 
-GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
-{
-	GF_FileMappingDataMap *tmp;
-	HANDLE fileH, fileMapH;
-#ifdef _WIN32_WCE
-	unsigned short sWPath[MAX_PATH];
-#endif
+#define ISOM_FILE_MAPPING
+#define fmo_atomic_inc(_v)	_InterlockedIncrement((long volatile *) (_v))
+#define fmo_atomic_dec(_v)	_InterlockedDecrement((long volatile *) (_v))
 
-	//only in read only
-	if (mode != GF_ISOM_DATA_MAP_READ) return NULL;
+#elif defined(GPAC_CONFIG_LINUX) || defined(GPAC_CONFIG_FREEBSD) || defined(GPAC_CONFIG_DARWIN) || defined(GPAC_CONFIG_ANDROID)
 
-	GF_SAFEALLOC(tmp, GF_FileMappingDataMap);
-	if (!tmp) return NULL;
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
-	tmp->type = GF_ISOM_DATA_FILE_MAPPING;
-	tmp->mode = mode;
-	tmp->name = gf_strdup(sPath);
+#define ISOM_FILE_MAPPING
+#define fmo_atomic_inc(_v)	__sync_add_and_fetch((_v), 1)
+#define fmo_atomic_dec(_v)	__sync_sub_and_fetch((_v), 1)
+
+#endif
+
+#ifdef ISOM_FILE_MAPPING
+
+#ifdef WIN32
 
-	//
-	//	Open the file
-	//
+static char *fmo_map_file(const char *sPath, u64 *file_size)
+{
+	HANDLE fileH, fileMapH;
+	DWORD size_high;
+	char *byte_map;
 #ifdef _WIN32_WCE
+	unsigned short sWPath[MAX_PATH];
+
 	//convert to WIDE
 	CE_CharToWide((char *)sPath, sWPath);
 
@@ -591,44 +603,97 @@ GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
 	fileH = CreateFile(sPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
 	                   (FILE_ATTRIBUTE_READONLY | FILE_FLAG_RANDOM_ACCESS), NULL );
 #endif
+	if (fileH == INVALID_HANDLE_VALUE) return NULL;
 
-
-	if (fileH == INVALID_HANDLE_VALUE) {
-		gf_free(tmp->name);
-		gf_free(tmp);
+	*file_size = GetFileSize(fileH, &size_high);
+	if ((*file_size == 0xFFFFFFFF) && (GetLastError() != NO_ERROR)) {
+		CloseHandle(fileH);
 		return NULL;
 	}
-
-	tmp->file_size = GetFileSize(fileH, NULL);
-	if (tmp->file_size == 0xFFFFFFFF) {
+	*file_size |= ((u64) size_high) << 32;
+	//a view of the complete file cannot be created in a 32 bit address space for large files
+	if (!*file_size || (*file_size > (u64) ((size_t) -1) )) {
 		CloseHandle(fileH);
-		gf_free(tmp->name);
-		gf_free(tmp);
 		return NULL;
 	}
 
-	//
-	//	Create the mapping
-	//
 	fileMapH = CreateFileMapping(fileH, NULL, PAGE_READONLY, 0, 0, NULL);
 	if (fileMapH == NULL) {
 		CloseHandle(fileH);
-		gf_free(tmp->name);
-		gf_free(tmp);
 		return NULL;
 	}
+	byte_map = MapViewOfFile(fileMapH, FILE_MAP_READ, 0, 0, 0);
 
-	tmp->byte_map = MapViewOfFile(fileMapH, FILE_MAP_READ, 0, 0, 0);
-	if (tmp->byte_map == NULL) {
-		CloseHandle(fileMapH);
-		CloseHandle(fileH);
-		gf_free(tmp->name);
+	CloseHandle(fileMapH);
+	CloseHandle(fileH);
+	return byte_map;
+}
+
+static void fmo_unmap_file(char *byte_map, u64 file_size)
+{
+	UnmapViewOfFile(byte_map);
+}
+
+#else
+
+static char *fmo_map_file(const char *sPath, u64 *file_size)
+{
+	struct stat st;
+	void *byte_map;
+	int fd = open(sPath, O_RDONLY);
+	if (fd < 0) return NULL;
+
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size || ((u64) st.st_size > (u64) ((size_t) -1)) ) {
+		close(fd);
+		return NULL;
+	}
+	*file_size = (u64) st.st_size;
+	byte_map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	//the mapping stays valid once the descriptor is closed
+	close(fd);
+	if (byte_map == MAP_FAILED) return NULL;
+	return (char *) byte_map;
+}
+
+static void fmo_unmap_file(char *byte_map, u64 file_size)
+{
+	munmap(byte_map, (size_t) file_size);
+}
+
+#endif
+
+GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
+{
+	GF_FileMappingDataMap *tmp;
+	char *byte_map;
+	u64 file_size;
+
+	//only in read only
+	if (mode != GF_ISOM_DATA_MAP_READ) return NULL;
+
+	byte_map = fmo_map_file(sPath, &file_size);
+	if (!byte_map) return NULL;
+
+	GF_SAFEALLOC(tmp, GF_FileMappingDataMap);
+	if (!tmp) {
+		fmo_unmap_file(byte_map, file_size);
+		return NULL;
+	}
+	GF_SAFEALLOC(tmp->token, GF_ISOMapToken);
+	if (!tmp->token) {
 		gf_free(tmp);
+		fmo_unmap_file(byte_map, file_size);
 		return NULL;
 	}
 
-	CloseHandle(fileH);
-	CloseHandle(fileMapH);
+	tmp->type = GF_ISOM_DATA_FILE_MAPPING;
+	tmp->mode = mode;
+	tmp->name = gf_strdup(sPath);
+	tmp->file_size = file_size;
+	tmp->byte_map = byte_map;
+	tmp->token->byte_map = byte_map;
+	tmp->token->size = file_size;
+	tmp->token->ref_count = 1;
 
 	//finaly open our bitstream (from buffer)
 	tmp->bs = gf_bs_new(tmp->byte_map, tmp->file_size, GF_BITSTREAM_READ);
@@ -640,7 +705,8 @@ void gf_isom_fmo_del(GF_FileMappingDataMap *ptr)
 	if (!ptr || (ptr->type != GF_ISOM_DATA_FILE_MAPPING)) return;
 
 	if (ptr->bs) gf_bs_del(ptr->bs);
-	if (ptr->byte_map) UnmapViewOfFile(ptr->byte_map);
+	//samples may still be referenced by the user
+	gf_isom_sample_ref_release(ptr->token);
 	gf_free(ptr->name);
 	gf_free(ptr);
 }
@@ -650,12 +716,29 @@ u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, char *buffer, u32 bufferLen
 {
 	//can we seek till that point ???
 	if (fileOffset > ptr->file_size) return 0;
+	if (fileOffset + bufferLength > ptr->file_size)
+		bufferLength = (u32) (ptr->file_size - fileOffset);
 
 	//we do only read operations, so trivial
 	memcpy(buffer, ptr->byte_map + fileOffset, bufferLength);
 	return bufferLength;
 }
 
+GF_ISOMapToken *gf_isom_fmo_ref(GF_FileMappingDataMap *ptr)
+{
+	fmo_atomic_inc(&ptr->token->ref_count);
+	return ptr->token;
+}
+
+GF_EXPORT
+void gf_isom_sample_ref_release(GF_ISOMapToken *token)
+{
+	if (!token) return;
+	if (fmo_atomic_dec(&token->ref_count)) return;
+	fmo_unmap_file(token->byte_map, token->size);
+	gf_free(token);
+}
+
 #else
 
 GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
@@ -673,6 +756,16 @@ u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, char *buffer, u32 bufferLen
 	return gf_isom_fdm_get_data((GF_FileDataMap *)ptr, buffer, bufferLength, fileOffset);
 }
 
+GF_ISOMapToken *gf_isom_fmo_ref(GF_FileMappingDataMap *ptr)
+{
+	return NULL;
+}
+
+GF_EXPORT
+void gf_isom_sample_ref_release(GF_ISOMapToken *token)
+{
+}
+
 #endif
 
 #endif /*GPAC_DISABLE_ISOM*/
@@ -1032,7 +1032,7 @@ static GF_ISOSample *gf_isom_get_data_sample(GF_HintSample *hsamp, GF_TrackBox *
 	}
 
 	samp = gf_isom_sample_new();
-	Media_GetSample(trak->Media, sample_num, &samp, &i, 0, NULL);
+	Media_GetSample(trak->Media, sample_num, &samp, &i, 0, NULL, GF_FALSE);
 	if (!samp) return NULL;
 	GF_SAFEALLOC(hdc, GF_HintDataCache);
 	if (!hdc) return NULL;
@@ -546,7 +546,7 @@ GF_ISOFile *gf_isom_open_file(const char *fileName, u32 OpenMode, const char *tm
 	mov->fileName = gf_strdup(fileName);
 	mov->openMode = OpenMode;
 
-	if ( (OpenMode == GF_ISOM_OPEN_READ) || (OpenMode == GF_ISOM_OPEN_READ_DUMP) ) {
+	if ( (OpenMode == GF_ISOM_OPEN_READ) || (OpenMode == GF_ISOM_OPEN_READ_DUMP) || (OpenMode == GF_ISOM_OPEN_READ_MMAP) ) {
 		//always in read ...
 		mov->openMode = GF_ISOM_OPEN_READ;
 		mov->es_id_default_sync = -1;
@@ -556,7 +556,7 @@ GF_ISOFile *gf_isom_open_file(const char *fileName, u32 OpenMode, const char *tm
 		//the bitstream IS PART OF the GF_DataMap
 		//as this is read-only, use a FileMapping. this is the only place where
 		//we use file mapping
-		e = gf_isom_datamap_new(fileName, NULL, GF_ISOM_DATA_MAP_READ_ONLY, &mov->movieFileMap);
+		e = gf_isom_datamap_new(fileName, NULL, (OpenMode == GF_ISOM_OPEN_READ_MMAP) ? GF_ISOM_DATA_MAP_READ_MMAP : GF_ISOM_DATA_MAP_READ_ONLY, &mov->movieFileMap);
 		if (e) {
 			gf_isom_set_last_error(NULL, e);
 			gf_isom_delete_movie(mov);
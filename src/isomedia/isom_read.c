@@ -85,7 +85,7 @@ GF_EXPORT
 void gf_isom_sample_del(GF_ISOSample **samp)
 {
 	if (! *samp) return;
-	if ((*samp)->data && (*samp)->dataLength) gf_free((*samp)->data);
+	if ((*samp)->data && ((*samp)->dataLength || (*samp)->alloc_size)) gf_free((*samp)->data);
 	gf_free(*samp);
 	*samp = NULL;
 }
@@ -411,6 +411,7 @@ GF_ISOFile *gf_isom_open(const char *fileName, u32 OpenMode, const char *tmp_dir
 	switch (OpenMode & 0xFF) {
 	case GF_ISOM_OPEN_READ_DUMP:
 	case GF_ISOM_OPEN_READ:
+	case GF_ISOM_OPEN_READ_MMAP:
 		movie = gf_isom_open_file(fileName, OpenMode, NULL);
 		break;
 
@@ -1587,7 +1588,7 @@ GF_Err gf_isom_get_sample_flags(GF_ISOFile *the_file, u32 trackNumber, u32 sampl
 //this index allows to retrieve the stream description if needed (2 media in 1 track)
 //return NULL if error
 GF_EXPORT
-GF_ISOSample *gf_isom_get_sample(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex)
+GF_ISOSample *gf_isom_get_sample_ex(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex, GF_ISOSample *static_sample, u64 *data_offset)
 {
 	GF_Err e;
 	u32 descIndex;
@@ -1597,19 +1598,29 @@ GF_ISOSample *gf_isom_get_sample(GF_ISOFile *the_file, u32 trackNumber, u32 samp
 	if (!trak) return NULL;
 
 	if (!sampleNumber) return NULL;
-	samp = gf_isom_sample_new();
-	if (!samp) return NULL;
-
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
 	if (sampleNumber<=trak->sample_count_at_seg_start)
 		return NULL;
 	sampleNumber -= trak->sample_count_at_seg_start;
 #endif
 
-	e = Media_GetSample(trak->Media, sampleNumber, &samp, &descIndex, GF_FALSE, NULL);
+	if (static_sample) {
+		samp = static_sample;
+		/*keep the buffer, reset everything else*/
+		samp->dataLength = 0;
+		samp->DTS = 0;
+		samp->CTS_Offset = 0;
+		samp->IsRAP = RAP_NO;
+		samp->nb_pack = 0;
+	} else {
+		samp = gf_isom_sample_new();
+		if (!samp) return NULL;
+	}
+
+	e = Media_GetSample(trak->Media, sampleNumber, &samp, &descIndex, GF_FALSE, data_offset, static_sample ? GF_TRUE : GF_FALSE);
 	if (e) {
 		gf_isom_set_last_error(the_file, e);
-		gf_isom_sample_del(&samp);
+		if (!static_sample) gf_isom_sample_del(&samp);
 		return NULL;
 	}
 	if (sampleDescriptionIndex) *sampleDescriptionIndex = descIndex;
@@ -1620,6 +1631,51 @@ GF_ISOSample *gf_isom_get_sample(GF_ISOFile *the_file, u32 trackNumber, u32 samp
 	return samp;
 }
 
+GF_EXPORT
+GF_ISOSample *gf_isom_get_sample(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex)
+{
+	return gf_isom_get_sample_ex(the_file, trackNumber, sampleNumber, sampleDescriptionIndex, NULL, NULL);
+}
+
+GF_EXPORT
+GF_Err gf_isom_get_sample_ref(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, GF_ISOSample *samp, u32 *sampleDescriptionIndex, u64 *data_offset, GF_ISOMapToken **token)
+{
+	GF_Err e;
+	u32 descIndex;
+	u64 offset;
+	GF_TrackBox *trak;
+	GF_DataMap *map;
+
+	if (!samp || !token) return GF_BAD_PARAM;
+	*token = NULL;
+	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	if (!trak || !sampleNumber) return GF_BAD_PARAM;
+
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	if (sampleNumber<=trak->sample_count_at_seg_start)
+		return GF_BAD_PARAM;
+	sampleNumber -= trak->sample_count_at_seg_start;
+#endif
+
+	memset(samp, 0, sizeof(GF_ISOSample));
+	e = Media_GetSample(trak->Media, sampleNumber, &samp, &descIndex, GF_TRUE, &offset, GF_FALSE);
+	if (e) return e;
+
+	map = trak->Media->information->dataHandler;
+	if (!map || (map->type != GF_ISOM_DATA_FILE_MAPPING)) return GF_NOT_SUPPORTED;
+	if (offset + samp->dataLength > ((GF_FileMappingDataMap *)map)->file_size) return GF_ISOM_INCOMPLETE_FILE;
+
+	samp->data = ((GF_FileMappingDataMap *)map)->byte_map + offset;
+	*token = gf_isom_fmo_ref((GF_FileMappingDataMap *)map);
+
+	if (sampleDescriptionIndex) *sampleDescriptionIndex = descIndex;
+	if (data_offset) *data_offset = offset;
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	samp->DTS += trak->dts_at_seg_start;
+#endif
+	return GF_OK;
+}
+
 GF_EXPORT
 u32 gf_isom_get_sample_duration(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber)
 {
@@ -1686,7 +1742,7 @@ GF_ISOSample *gf_isom_get_sample_info(GF_ISOFile *the_file, u32 trackNumber, u32
 #endif
 	samp = gf_isom_sample_new();
 	if (!samp) return NULL;
-	e = Media_GetSample(trak->Media, sampleNumber, &samp, sampleDescriptionIndex, GF_TRUE, data_offset);
+	e = Media_GetSample(trak->Media, sampleNumber, &samp, sampleDescriptionIndex, GF_TRUE, data_offset, GF_FALSE);
 	if (e) {
 		gf_isom_set_last_error(the_file, e);
 		gf_isom_sample_del(&samp);
@@ -1871,7 +1927,7 @@ GF_Err gf_isom_get_sample_for_media_time(GF_ISOFile *the_file, u32 trackNumber,
 		}
 	}
 
-	e = Media_GetSample(trak->Media, sampleNumber, sample, StreamDescriptionIndex, GF_FALSE, NULL);
+	e = Media_GetSample(trak->Media, sampleNumber, sample, StreamDescriptionIndex, GF_FALSE, NULL, GF_FALSE);
 	if (e) {
 		gf_isom_sample_del(sample);
 		return e;
@@ -2046,6 +2102,31 @@ GF_Err gf_isom_set_sample_padding(GF_ISOFile *the_file, u32 trackNumber, u32 pad
 
 }
 
+GF_EXPORT
+GF_Err gf_isom_set_sample_index_mode(GF_ISOFile *the_file, u32 trackNumber, Bool use_index)
+{
+	GF_SampleTableBox *stbl;
+	GF_TrackBox *trak;
+	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	if (!trak || !trak->Media || !trak->Media->information || !trak->Media->information->sampleTable) return GF_BAD_PARAM;
+	stbl = trak->Media->information->sampleTable;
+
+	if (!use_index) {
+		if (stbl->TimeToSample) stbl->TimeToSample->r_index = NULL;
+		stbl_del_sample_index(stbl->sample_index);
+		stbl->sample_index = NULL;
+		return GF_OK;
+	}
+	//tables are only appended to in read mode, which the index relies on
+	if (the_file->openMode != GF_ISOM_OPEN_READ) return GF_NOT_SUPPORTED;
+	if (!stbl->sample_index) {
+		GF_SAFEALLOC(stbl->sample_index, GF_SampleTableIndex);
+		if (!stbl->sample_index) return GF_OUT_OF_MEM;
+	}
+	if (stbl->TimeToSample) stbl->TimeToSample->r_index = stbl->sample_index;
+	return GF_OK;
+}
+
 //get the number of edited segment
 GF_EXPORT
 Bool gf_isom_get_edit_list_type(GF_ISOFile *the_file, u32 trackNumber, s64 *mediaOffset)
@@ -2692,6 +2773,7 @@ GF_Err gf_isom_reset_tables(GF_ISOFile *movie, Bool reset_sample_count)
 		RECREATE_BOX(stbl->ShadowSync, (GF_ShadowSyncBox *));
 		RECREATE_BOX(stbl->SyncSample, (GF_SyncSampleBox *));
 		RECREATE_BOX(stbl->TimeToSample, (GF_TimeToSampleBox *));
+		stbl_reset_sample_index(stbl);
 
 		gf_isom_box_array_del(stbl->sai_offsets);
 		stbl->sai_offsets = NULL;
@@ -2798,6 +2880,7 @@ GF_Err gf_isom_release_segment(GF_ISOFile *movie, Bool reset_tables)
 			RECREATE_BOX(stbl->ShadowSync, (GF_ShadowSyncBox *));
 			RECREATE_BOX(stbl->SyncSample, (GF_SyncSampleBox *));
 			RECREATE_BOX(stbl->TimeToSample, (GF_TimeToSampleBox *));
+			stbl_reset_sample_index(stbl);
 
 			gf_isom_box_array_del(stbl->sai_offsets);
 			stbl->sai_offsets = NULL;
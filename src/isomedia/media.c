@@ -384,10 +384,11 @@ Bool Media_IsSampleSyncShadow(GF_ShadowSyncBox *stsh, u32 sampleNumber)
 	return 0;
 }
 
-GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sIDX, Bool no_data, u64 *out_offset)
+GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sIDX, Bool no_data, u64 *out_offset, Bool ext_realloc)
 {
 	GF_Err e;
-	u32 bytesRead;
+	u32 bytesRead, data_size;
+	char *data;
 	u32 dataRefIndex, chunkNumber;
 	u64 offset, new_size;
 	GF_SampleEntryBox *entry;
@@ -487,7 +488,19 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 		}
 
 		/*and finally get the data, include padding if needed*/
-		(*samp)->data = (char *) gf_malloc(sizeof(char) * ( (*samp)->dataLength + mdia->mediaTrack->padding_bytes) );
+		data_size = (*samp)->dataLength + mdia->mediaTrack->padding_bytes;
+		if (!ext_realloc) {
+			(*samp)->data = (char *) gf_malloc(sizeof(char) * data_size);
+		}
+		/*caller-owned sample, only grow the buffer when needed*/
+		else if (!(*samp)->data || ((*samp)->alloc_size < data_size)) {
+			/*keep the caller buffer on failure, it is still owned and freed by the caller*/
+			char *data = (char *) gf_realloc((*samp)->data, sizeof(char) * data_size);
+			if (!data) return GF_OUT_OF_MEM;
+			(*samp)->data = data;
+			(*samp)->alloc_size = data_size;
+		}
+		if (!(*samp)->data) return GF_OUT_OF_MEM;
 		if (mdia->mediaTrack->padding_bytes)
 			memset((*samp)->data + (*samp)->dataLength, 0, sizeof(char) * mdia->mediaTrack->padding_bytes);
 
@@ -512,6 +525,8 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 
 	//finally rewrite the sample if this is an OD Access Unit or NAL-based one
 	//we do this even if sample size is zero because of sample implicit reconstruction rules (especially tile tracks)
+	data = (*samp)->data;
+	data_size = (*samp)->dataLength;
 	if (mdia->handler->handlerType == GF_ISOM_MEDIA_OD) {
 		e = Media_RewriteODFrame(mdia, *samp);
 		if (e) return e;
@@ -537,6 +552,10 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 		e = gf_isom_rewrite_text_sample(*samp, *sIDX, (u32) dur);
 		if (e) return e;
 	}
+	/*rewriters replace or resize the data buffer, only the payload size is known to be allocated*/
+	if (ext_realloc && (((*samp)->data != data) || ((*samp)->dataLength != data_size)) ) {
+		(*samp)->alloc_size = (*samp)->data ? (*samp)->dataLength : 0;
+	}
 	return GF_OK;
 }
 
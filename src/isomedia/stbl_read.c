@@ -27,6 +27,191 @@
 
 #ifndef GPAC_DISABLE_ISOM
 
+void stbl_del_sample_index(GF_SampleTableIndex *idx)
+{
+	if (!idx) return;
+	if (idx->stsc_first_sample) gf_free(idx->stsc_first_sample);
+	if (idx->stts_first_sample) gf_free(idx->stts_first_sample);
+	if (idx->stts_first_dts) gf_free(idx->stts_first_dts);
+	if (idx->size_checkpoints) gf_free(idx->size_checkpoints);
+	gf_free(idx);
+}
+
+void stbl_reset_sample_index(GF_SampleTableBox *stbl)
+{
+	GF_SampleTableIndex *idx = stbl ? stbl->sample_index : NULL;
+	if (!idx) return;
+	idx->nb_stsc = 0;
+	idx->nb_stts = 0;
+	idx->nb_size_checkpoints = 0;
+	idx->size_sample_count = 0;
+	//tables may have been recreated
+	if (stbl->TimeToSample) stbl->TimeToSample->r_index = idx;
+}
+
+//builds the first sample number and DTS of each stts entry
+static GF_Err stbl_index_stts(GF_SampleTableIndex *idx, GF_TimeToSampleBox *stts)
+{
+	u32 i, first_sample = 1;
+	u64 dts = 0;
+
+	if (idx->nb_stts == stts->nb_entries) return GF_OK;
+	if (!stts->nb_entries) return GF_ISOM_INVALID_FILE;
+
+	idx->stts_first_sample = (u32*)gf_realloc(idx->stts_first_sample, sizeof(u32) * stts->nb_entries);
+	idx->stts_first_dts = (u64*)gf_realloc(idx->stts_first_dts, sizeof(u64) * stts->nb_entries);
+	if (!idx->stts_first_sample || !idx->stts_first_dts) {
+		idx->nb_stts = 0;
+		return GF_OUT_OF_MEM;
+	}
+	for (i=0; i<stts->nb_entries; i++) {
+		idx->stts_first_sample[i] = first_sample;
+		idx->stts_first_dts[i] = dts;
+		first_sample += stts->entries[i].sampleCount;
+		dts += (u64) stts->entries[i].sampleCount * stts->entries[i].sampleDelta;
+	}
+	idx->nb_stts = stts->nb_entries;
+	return GF_OK;
+}
+
+//builds the first sample number of each stsc entry
+static GF_Err stbl_index_stsc(GF_SampleTableIndex *idx, GF_SampleTableBox *stbl)
+{
+	u32 i, first_sample = 1;
+	GF_SampleToChunkBox *stsc = stbl->SampleToChunk;
+
+	if (idx->nb_stsc == stsc->nb_entries) return GF_OK;
+	if (!stsc->nb_entries) return GF_ISOM_INVALID_FILE;
+
+	idx->stsc_first_sample = (u32*)gf_realloc(idx->stsc_first_sample, sizeof(u32) * stsc->nb_entries);
+	if (!idx->stsc_first_sample) {
+		idx->nb_stsc = 0;
+		return GF_OUT_OF_MEM;
+	}
+	for (i=0; i<stsc->nb_entries; i++) {
+		idx->stsc_first_sample[i] = first_sample;
+		//number of chunks for all but last entry
+		if (i+1 < stsc->nb_entries) {
+			GF_StscEntry *ent = &stsc->entries[i];
+			u32 nb_chunks = stsc->entries[i+1].firstChunk - ent->firstChunk;
+			if (ent->nextChunk) nb_chunks = (ent->nextChunk > ent->firstChunk) ? (ent->nextChunk - ent->firstChunk) : 1;
+			first_sample += nb_chunks * ent->samplesPerChunk;
+		}
+	}
+	idx->nb_stsc = stsc->nb_entries;
+	return GF_OK;
+}
+
+//builds (or extends) the cumulated sample size checkpoints
+static GF_Err stbl_index_sizes(GF_SampleTableIndex *idx, GF_SampleSizeBox *stsz)
+{
+	u32 i, nb_checkpoints;
+	u64 cumulated_size;
+
+	if (idx->size_sample_count == stsz->sampleCount) return GF_OK;
+	//table was shrunk, rebuild
+	if (idx->size_sample_count > stsz->sampleCount) idx->nb_size_checkpoints = 0;
+
+	nb_checkpoints = 1 + stsz->sampleCount / GF_ISOM_SAMPLE_INDEX_SIZE_STEP;
+	idx->size_checkpoints = (u64*)gf_realloc(idx->size_checkpoints, sizeof(u64) * nb_checkpoints);
+	if (!idx->size_checkpoints) {
+		idx->nb_size_checkpoints = idx->size_sample_count = 0;
+		return GF_OUT_OF_MEM;
+	}
+	if (!idx->nb_size_checkpoints) {
+		idx->size_checkpoints[0] = 0;
+		idx->nb_size_checkpoints = 1;
+	}
+	cumulated_size = idx->size_checkpoints[idx->nb_size_checkpoints-1];
+	for (i = (idx->nb_size_checkpoints-1) * GF_ISOM_SAMPLE_INDEX_SIZE_STEP; i<stsz->sampleCount; i++) {
+		if (stsz->sampleSize && (stsz->type != GF_ISOM_BOX_TYPE_STZ2)) cumulated_size += stsz->sampleSize;
+		else if (stsz->sizes) cumulated_size += stsz->sizes[i];
+
+		if ((i+1) % GF_ISOM_SAMPLE_INDEX_SIZE_STEP == 0) {
+			idx->size_checkpoints[ (i+1) / GF_ISOM_SAMPLE_INDEX_SIZE_STEP ] = cumulated_size;
+		}
+	}
+	idx->nb_size_checkpoints = nb_checkpoints;
+	idx->size_sample_count = stsz->sampleCount;
+	return GF_OK;
+}
+
+//returns the cumulated size of samples [1, sampleNumber[
+static u64 stbl_index_get_size_before(GF_SampleTableIndex *idx, GF_SampleSizeBox *stsz, u32 sampleNumber)
+{
+	u32 i, cp = (sampleNumber-1) / GF_ISOM_SAMPLE_INDEX_SIZE_STEP;
+	u64 size = idx->size_checkpoints[cp];
+	if (!stsz->sizes) return size;
+	for (i = cp * GF_ISOM_SAMPLE_INDEX_SIZE_STEP; i < sampleNumber-1; i++) {
+		size += stsz->sizes[i];
+	}
+	return size;
+}
+
+//returns the index of the last entry with first value less than or equal to (or strictly less than if strict is set) the given value, -1 if none
+#define STBL_INDEX_BSEARCH(_res, _tab, _count, _val, _strict) {\
+	s32 _lo = 0, _hi = (s32) (_count) - 1;\
+	_res = -1;\
+	while (_lo <= _hi) {\
+		s32 _mid = (_lo + _hi) / 2;\
+		if ( (_strict) ? ((_tab)[_mid] < (_val)) : ((_tab)[_mid] <= (_val)) ) { _res = _mid; _lo = _mid + 1; }\
+		else _hi = _mid - 1;\
+	}\
+}
+
+static GF_Err stbl_findEntryForTime_indexed(GF_SampleTableBox *stbl, u64 DTS, u32 *sampleNumber, u32 *prevSampleNumber)
+{
+	s32 i;
+	u32 count, curSampNum;
+	u64 curDTS;
+	GF_SttsEntry *ent = NULL;
+	GF_TimeToSampleBox *stts = stbl->TimeToSample;
+	GF_SampleTableIndex *idx = stbl->sample_index;
+	GF_Err e = stbl_index_stts(idx, stts);
+	if (e) return e;
+
+	count = stts->nb_entries;
+	//the first sample with a DTS greater than or equal to the target is either in the last entry starting strictly before
+	//the target, or is the first sample of the next non-empty entry
+	STBL_INDEX_BSEARCH(i, idx->stts_first_dts, count, DTS, 1);
+	if (i<0) i = 0;
+	curSampNum = idx->stts_first_sample[i];
+	curDTS = idx->stts_first_dts[i];
+	ent = &stts->entries[i];
+	if ((curDTS < DTS) && ent->sampleDelta) {
+		u64 nb_samp = (DTS - curDTS + ent->sampleDelta - 1) / ent->sampleDelta;
+		if (nb_samp < ent->sampleCount) {
+			curSampNum += (u32) nb_samp;
+			curDTS += nb_samp * ent->sampleDelta;
+		}
+	}
+	while (curDTS < DTS) {
+		i++;
+		if ((u32) i == count) {
+			//update the cache to the last entry, and return as is
+			stts->r_currentEntryIndex = count-1;
+			stts->r_FirstSampleInEntry = idx->stts_first_sample[count-1];
+			stts->r_CurrentDTS = idx->stts_first_dts[count-1];
+			return GF_OK;
+		}
+		if (!stts->entries[i].sampleCount) continue;
+		curSampNum = idx->stts_first_sample[i];
+		curDTS = idx->stts_first_dts[i];
+	}
+	//update the cache
+	stts->r_currentEntryIndex = i;
+	stts->r_FirstSampleInEntry = idx->stts_first_sample[i];
+	stts->r_CurrentDTS = idx->stts_first_dts[i];
+
+	if (curDTS == DTS) {
+		(*sampleNumber) = curSampNum;
+	} else {
+		//exception for the first sample (we need to "load" the playback)
+		(*prevSampleNumber) = (curSampNum != 1) ? curSampNum - 1 : 1;
+	}
+	return GF_OK;
+}
+
 //Get the sample number
 GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *sampleNumber, u32 *prevSampleNumber)
 {
@@ -43,6 +228,11 @@ GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *s
 	decoding order. */
 	useCTS = 0;
 
+	if (stbl->sample_index && stbl->TimeToSample->nb_entries) {
+		stbl->TimeToSample->r_index = stbl->sample_index;
+		return stbl_findEntryForTime_indexed(stbl, DTS, sampleNumber, prevSampleNumber);
+	}
+
 	//our cache
 	if (stbl->TimeToSample->r_FirstSampleInEntry &&
 	        (DTS >= stbl->TimeToSample->r_CurrentDTS) ) {
@@ -182,8 +372,24 @@ GF_Err stbl_GetSampleDTS_and_Duration(GF_TimeToSampleBox *stts, u32 SampleNumber
 	if (!stts || !SampleNumber) return GF_BAD_PARAM;
 
 	ent = NULL;
-	//use our cache
 	count = stts->nb_entries;
+	//use the index if any, unless the sample is in the cached entry
+	if (stts->r_index && count
+	        && ((stts->r_FirstSampleInEntry > SampleNumber) || (stts->r_currentEntryIndex >= count)
+	            || (stts->r_FirstSampleInEntry + stts->entries[stts->r_currentEntryIndex].sampleCount <= SampleNumber))
+	   ) {
+		s32 idx_entry;
+		GF_SampleTableIndex *idx = stts->r_index;
+		if (stbl_index_stts(idx, stts) == GF_OK) {
+			STBL_INDEX_BSEARCH(idx_entry, idx->stts_first_sample, count, SampleNumber, 0);
+			if (idx_entry<0) idx_entry = 0;
+			stts->r_currentEntryIndex = idx_entry;
+			stts->r_FirstSampleInEntry = idx->stts_first_sample[idx_entry];
+			stts->r_CurrentDTS = idx->stts_first_dts[idx_entry];
+		}
+	}
+
+	//use our cache
 	if (stts->r_FirstSampleInEntry
 	        && (stts->r_FirstSampleInEntry <= SampleNumber)
 	        //this is for read/write access
@@ -392,6 +598,70 @@ void GetGhostNum(GF_StscEntry *ent, u32 EntryIndex, u32 count, GF_SampleTableBox
 	stbl->SampleToChunk->ghostNumber = ghostNum;
 }
 
+static GF_Err stbl_GetSampleInfos_indexed(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *chunkNumber, u32 *descIndex, GF_StscEntry **out_ent)
+{
+	GF_Err e;
+	s32 i;
+	u32 chunk_in_entry, first_sample_in_chunk;
+	u64 offsetInChunk;
+	GF_StscEntry *ent;
+	GF_SampleToChunkBox *stsc = stbl->SampleToChunk;
+	GF_SampleTableIndex *idx = stbl->sample_index;
+
+	if (stbl->TimeToSample) stbl->TimeToSample->r_index = idx;
+	e = stbl_index_stsc(idx, stbl);
+	if (e) return e;
+
+	STBL_INDEX_BSEARCH(i, idx->stsc_first_sample, stsc->nb_entries, sampleNumber, 0);
+	if (i<0) return GF_ISOM_INVALID_FILE;
+	ent = &stsc->entries[i];
+	//broken table, let the regular code deal with it
+	if (!ent->samplesPerChunk) return GF_NOT_SUPPORTED;
+
+	chunk_in_entry = (sampleNumber - idx->stsc_first_sample[i]) / ent->samplesPerChunk;
+	first_sample_in_chunk = idx->stsc_first_sample[i] + chunk_in_entry * ent->samplesPerChunk;
+
+	//update the cache used by sequential access and sample data fetching
+	GetGhostNum(ent, i, stsc->nb_entries, stbl);
+	if (chunk_in_entry >= stsc->ghostNumber) return GF_ISOM_INVALID_FILE;
+	stsc->currentIndex = i;
+	stsc->currentChunk = chunk_in_entry + 1;
+	stsc->firstSampleInCurrentChunk = first_sample_in_chunk;
+
+	(*descIndex) = ent->sampleDescriptionIndex;
+	(*chunkNumber) = ent->firstChunk + chunk_in_entry;
+	if (out_ent) *out_ent = ent;
+
+	//get the size of all the previous samples in the chunk
+	if (stbl->SampleSize->sampleSize && (stbl->SampleSize->type != GF_ISOM_BOX_TYPE_STZ2)) {
+		offsetInChunk = (u64) (sampleNumber - first_sample_in_chunk) * stbl->SampleSize->sampleSize;
+	} else if (sampleNumber - first_sample_in_chunk <= GF_ISOM_SAMPLE_INDEX_SIZE_STEP) {
+		u32 k, size;
+		offsetInChunk = 0;
+		for (k = first_sample_in_chunk; k < sampleNumber; k++) {
+			e = stbl_GetSampleSize(stbl->SampleSize, k, &size);
+			if (e) return e;
+			offsetInChunk += size;
+		}
+	} else {
+		if (sampleNumber > stbl->SampleSize->sampleCount) return GF_BAD_PARAM;
+		e = stbl_index_sizes(idx, stbl->SampleSize);
+		if (e) return e;
+		offsetInChunk = stbl_index_get_size_before(idx, stbl->SampleSize, sampleNumber) - stbl_index_get_size_before(idx, stbl->SampleSize, first_sample_in_chunk);
+	}
+
+	if ( stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO) {
+		GF_ChunkOffsetBox *stco = (GF_ChunkOffsetBox *)stbl->ChunkOffset;
+		if (stco->nb_entries < (*chunkNumber) ) return GF_ISOM_INVALID_FILE;
+		(*offset) = (u64) stco->offsets[(*chunkNumber) - 1] + offsetInChunk;
+	} else {
+		GF_ChunkLargeOffsetBox *co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
+		if (co64->nb_entries < (*chunkNumber) ) return GF_ISOM_INVALID_FILE;
+		(*offset) = co64->offsets[(*chunkNumber) - 1] + offsetInChunk;
+	}
+	return GF_OK;
+}
+
 //Get the offset, descIndex and chunkNumber of a sample...
 GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offset, u32 *chunkNumber, u32 *descIndex, GF_StscEntry **out_ent)
 {
@@ -423,6 +693,11 @@ GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offse
 		return GF_OK;
 	}
 
+	if (stbl->sample_index) {
+		e = stbl_GetSampleInfos_indexed(stbl, sampleNumber, offset, chunkNumber, descIndex, out_ent);
+		if (e != GF_NOT_SUPPORTED) return e;
+	}
+
 	//check our cache
 	if (stbl->SampleToChunk->firstSampleInCurrentChunk &&
 	        (stbl->SampleToChunk->firstSampleInCurrentChunk < sampleNumber)) {
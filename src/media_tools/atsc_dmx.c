@@ -160,9 +160,12 @@ struct __gf_atscdmx {
 	u64 first_pck_time, last_pck_time;
 };
 
-static void gf_atsc3_route_session_del(GF_ATSCRouteSession *rs)
+static void gf_atsc3_route_session_del(GF_ATSCDmx *atscd, GF_ATSCRouteSession *rs)
 {
-	if (rs->sock) gf_sk_del(rs->sock);
+	if (rs->sock) {
+		gf_sk_group_unregister(atscd->active_sockets, rs->sock);
+		gf_sk_del(rs->sock);
+	}
 	while (gf_list_count(rs->channels)) {
 		GF_ATSCLCTChannel *lc = gf_list_pop_back(rs->channels);
 		if (lc->init_filename) gf_free(lc->init_filename);
@@ -189,7 +192,7 @@ static void gf_atsc3_service_del(GF_ATSCDmx *atscd, GF_ATSCService *s)
 	if (s->output_dir) gf_free(s->output_dir);
 	while (gf_list_count(s->route_sessions)) {
 		GF_ATSCRouteSession *rsess = gf_list_pop_back(s->route_sessions);
-		gf_atsc3_route_session_del(rsess);
+		gf_atsc3_route_session_del(atscd, rsess);
 	}
 	gf_list_del(s->route_sessions);
 
@@ -207,7 +210,10 @@ void gf_atsc3_dmx_del(GF_ATSCDmx *atscd)
 {
 	if (atscd->buffer) gf_free(atscd->buffer);
 	if (atscd->unz_buffer) gf_free(atscd->unz_buffer);
-	if (atscd->sock) gf_sk_del(atscd->sock);
+	if (atscd->sock) {
+		gf_sk_group_unregister(atscd->active_sockets, atscd->sock);
+		gf_sk_del(atscd->sock);
+	}
 	if (atscd->dom) gf_xml_dom_del(atscd->dom);
 	if (atscd->services) {
 		while (gf_list_count(atscd->services)) {
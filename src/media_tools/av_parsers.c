@@ -32,6 +32,27 @@
 #include <gpac/internal/ogg.h>
 #endif
 
+#if defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+#else
+# ifdef __SSE2__
+#  include <emmintrin.h>
+#  define GPAC_HAS_SSE2
+# endif
+#endif
+
+/*AVX2 code is only built for the functions using it and selected at run time*/
+#if defined(GPAC_HAS_SSE2) && (defined(_MSC_VER) || defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+# include <immintrin.h>
+# define GPAC_HAS_AVX2
+# if defined(_MSC_VER)
+#  define GF_AVX2_FUNC
+# else
+#  define GF_AVX2_FUNC __attribute__((target("avx2")))
+# endif
+#endif
+
 static const struct {
 	u32 w, h;
 } std_par[ ] =
@@ -4434,6 +4455,134 @@ const char *gf_avc_hevc_get_chroma_format_name(u8 chroma_format)
 	}
 }
 
+/* NAL unit byte scanning
+
+Start codes and emulation prevention bytes all begin with two zero bytes, so the parsers below only look at the
+data byte by byte once such a pair is found; the search itself is vectorized when possible.
+*/
+
+static u32 nalu_zero_pair_c(const u8 *data, u32 data_len)
+{
+	u32 i = 0;
+	while (i+1 < data_len) {
+		/*no pair can start at i or i+1*/
+		if (data[i+1]) i += 2;
+		else if (!data[i]) return i;
+		else i++;
+	}
+	return data_len;
+}
+
+#ifdef GPAC_HAS_SSE2
+
+static GFINLINE u32 nalu_ctz(u32 v)
+{
+#if defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanForward(&idx, v);
+	return (u32) idx;
+#else
+	return (u32) __builtin_ctz(v);
+#endif
+}
+
+static u32 nalu_zero_pair_sse2(const u8 *data, u32 data_len)
+{
+	u32 i = 0;
+	const __m128i zero = _mm_setzero_si128();
+
+	/*the byte following the block is needed to check a pair starting on the last byte*/
+	while (i + 33 <= data_len) {
+		__m128i za = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (data+i)), zero);
+		__m128i zb = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (data+i+16)), zero);
+		if (_mm_movemask_epi8(_mm_or_si128(za, zb))) {
+			u32 m = (u32) _mm_movemask_epi8(_mm_and_si128(za, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (data+i+1)), zero)));
+			m |= ((u32) _mm_movemask_epi8(_mm_and_si128(zb, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (data+i+17)), zero)))) << 16;
+			if (m) return i + nalu_ctz(m);
+		}
+		i += 32;
+	}
+	return i + nalu_zero_pair_c(data+i, data_len-i);
+}
+
+#ifdef GPAC_HAS_AVX2
+
+static GF_AVX2_FUNC u32 nalu_zero_pair_avx2(const u8 *data, u32 data_len)
+{
+	u32 i = 0;
+	const __m256i zero = _mm256_setzero_si256();
+
+	while (i + 65 <= data_len) {
+		__m256i za = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (data+i)), zero);
+		__m256i zb = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (data+i+32)), zero);
+		if (_mm256_movemask_epi8(_mm256_or_si256(za, zb))) {
+			u32 m = (u32) _mm256_movemask_epi8(_mm256_and_si256(za, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (data+i+1)), zero)));
+			if (m) return i + nalu_ctz(m);
+			m = (u32) _mm256_movemask_epi8(_mm256_and_si256(zb, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (data+i+33)), zero)));
+			if (m) return i + 32 + nalu_ctz(m);
+		}
+		i += 64;
+	}
+	return i + nalu_zero_pair_sse2(data+i, data_len-i);
+}
+
+static Bool nalu_cpu_has_avx2()
+{
+#if defined(_MSC_VER)
+	int regs[4];
+	__cpuid(regs, 0);
+	if (regs[0] < 7) return GF_FALSE;
+	__cpuid(regs, 1);
+	/*AVX and OS support for YMM registers*/
+	if ((regs[2] & ((1<<27) | (1<<28))) != ((1<<27) | (1<<28))) return GF_FALSE;
+	if ((_xgetbv(0) & 6) != 6) return GF_FALSE;
+	__cpuidex(regs, 7, 0);
+	return (regs[1] & (1<<5)) ? GF_TRUE : GF_FALSE;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") ? GF_TRUE : GF_FALSE;
+#endif
+}
+
+#endif /*GPAC_HAS_AVX2*/
+
+#endif /*GPAC_HAS_SSE2*/
+
+static u32 (*nalu_zero_pair)(const u8 *data, u32 data_len) = NULL;
+static u32 nalu_simd_type = GF_NALU_SIMD_NONE;
+
+GF_EXPORT
+u32 gf_media_nalu_set_simd(u32 simd_type)
+{
+	const char *name = "scalar";
+	nalu_zero_pair = nalu_zero_pair_c;
+	nalu_simd_type = GF_NALU_SIMD_NONE;
+
+	if (simd_type != GF_NALU_SIMD_NONE) {
+#ifdef GPAC_HAS_SSE2
+		nalu_zero_pair = nalu_zero_pair_sse2;
+		nalu_simd_type = GF_NALU_SIMD_SSE2;
+		name = "SSE2";
+#ifdef GPAC_HAS_AVX2
+		if ((simd_type != GF_NALU_SIMD_SSE2) && nalu_cpu_has_avx2()) {
+			nalu_zero_pair = nalu_zero_pair_avx2;
+			nalu_simd_type = GF_NALU_SIMD_AVX2;
+			name = "AVX2";
+		}
+#endif
+#endif
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CODING, ("[NALU] Using %s start code scanning\n", name));
+	return nalu_simd_type;
+}
+
+GF_EXPORT
+u32 gf_media_nalu_next_zero_pair(const u8 *data, u32 data_len)
+{
+	if (!nalu_zero_pair) gf_media_nalu_set_simd(GF_NALU_SIMD_AUTO);
+	return nalu_zero_pair(data, data_len);
+}
+
 #ifndef GPAC_DISABLE_AV_PARSERS
 
 
@@ -4508,37 +4657,45 @@ u32 gf_media_nalu_is_start_code(GF_BitStream *bs)
 
 static u32 gf_media_nalu_locate_start_code_bs(GF_BitStream *bs, Bool locate_trailing)
 {
-	u32 v, bpos, nb_cons_zeros=0;
-	char avc_cache[AVC_CACHE_SIZE];
-	u64 end, cache_start, load_size;
+	u32 bpos, load_size, nb_cons_zeros=0;
+	/*the last 4 bytes of the previous load are kept before the cache, for start codes spanning two loads*/
+	u8 avc_cache[4 + AVC_CACHE_SIZE];
+	u64 end, cache_start;
 	u64 start = gf_bs_get_position(bs);
 	if (start<3) return 0;
 
-	load_size = 0;
-	bpos = 0;
-	cache_start = 0;
 	end = 0;
-	v = 0xffffffff;
+	memset(avc_cache, 0xFF, 4);
 	while (!end) {
-		/*refill cache*/
-		if (bpos == (u32) load_size) {
-			if (!gf_bs_available(bs)) break;
-			load_size = gf_bs_available(bs);
-			if (load_size>AVC_CACHE_SIZE) load_size=AVC_CACHE_SIZE;
-			bpos = 0;
-			cache_start = gf_bs_get_position(bs);
-			gf_bs_read_data(bs, avc_cache, (u32) load_size);
+		u64 avail = gf_bs_available(bs);
+		if (!avail) break;
+		load_size = (avail > AVC_CACHE_SIZE) ? AVC_CACHE_SIZE : (u32) avail;
+		cache_start = gf_bs_get_position(bs);
+		gf_bs_read_data(bs, (char *) avc_cache + 4, load_size);
+
+		/*a start code beginning in the first kept byte has been checked with the previous load*/
+		bpos = 1;
+		while (1) {
+			bpos += gf_media_nalu_next_zero_pair(avc_cache + bpos, load_size + 4 - bpos);
+			if (bpos + 2 >= load_size + 4) break;
+			if (avc_cache[bpos+2] == 0x01) {
+				end = cache_start + bpos - 4;
+				if (!avc_cache[bpos-1]) end--;
+				/*the last byte checked is the start code one*/
+				nb_cons_zeros = 0;
+				break;
+			}
+			bpos++;
 		}
-		v = ( (v<<8) & 0xFFFFFF00) | ((u32) avc_cache[bpos]);
+		if (end) break;
 
-		bpos++;
 		if (locate_trailing) {
-			if ( (v & 0x000000FF) == 0) nb_cons_zeros++;
-			else nb_cons_zeros = 0;
+			u32 nb_zeros = 0;
+			while ((nb_zeros < load_size) && !avc_cache[3 + load_size - nb_zeros]) nb_zeros++;
+			if (nb_zeros == load_size) nb_cons_zeros += nb_zeros;
+			else nb_cons_zeros = nb_zeros;
 		}
-
-		if (v == 0x00000001) end = cache_start+bpos-4;
-		else if ( (v & 0x00FFFFFF) == 0x00000001) end = cache_start+bpos-3;
+		memcpy(avc_cache, avc_cache + load_size, 4);
 	}
 	gf_bs_seek(bs, start);
 	if (!end) end = gf_bs_get_size(bs);
@@ -4564,32 +4721,21 @@ u32 gf_media_nalu_payload_end_bs(GF_BitStream *bs)
 GF_EXPORT
 u32 gf_media_nalu_next_start_code(const u8 *data, u32 data_len, u32 *sc_size)
 {
-	u32 v, bpos;
-	u32 end;
-
-	bpos = 0;
-	end = 0;
-	v = 0xffffffff;
-	while (!end) {
-		/*refill cache*/
-		if (bpos == (u32) data_len)
-			break;
-
-		v = ( (v<<8) & 0xFFFFFF00) | ((u32) data[bpos]);
-		bpos++;
-		if (v == 0x00000001) {
-			end = bpos-4;
-			*sc_size = 4;
-			return end;
-		}
-		else if ( (v & 0x00FFFFFF) == 0x00000001) {
-			end = bpos-3;
+	u32 pos = 0;
+	while (1) {
+		pos += gf_media_nalu_next_zero_pair(data + pos, data_len - pos);
+		if (pos + 2 >= data_len) break;
+		if (data[pos+2] == 0x01) {
+			if (pos && !data[pos-1]) {
+				*sc_size = 4;
+				return pos-1;
+			}
 			*sc_size = 3;
-			return end;
+			return pos;
 		}
+		pos++;
 	}
-	if (!end) end = data_len;
-	return (u32) (end);
+	return data_len;
 }
 
 Bool gf_media_avc_slice_is_intra(AVCState *avc)
@@ -4662,6 +4808,11 @@ static u32 gf_media_nalu_emulation_bytes_add_count(char *buffer, u32 nal_size)
 	u8 num_zero = 0;
 
 	while (i < nal_size) {
+		/*nothing to escape before the next two zero bytes*/
+		if (!num_zero) {
+			i += gf_media_nalu_next_zero_pair((u8 *) buffer + i, nal_size - i);
+			if (i == nal_size) break;
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		other than the following sequences shall not occur at any byte-aligned position:
 		\96 0x00000300
@@ -4692,6 +4843,13 @@ static u32 gf_media_nalu_add_emulation_bytes(const char *buffer_src, char *buffe
 	u8 num_zero = 0;
 
 	while (i < nal_size) {
+		/*nothing to escape before the next two zero bytes*/
+		if (!num_zero) {
+			u32 skip = gf_media_nalu_next_zero_pair((u8 *) buffer_src + i, nal_size - i);
+			memcpy(buffer_dst + i + emulation_bytes_count, buffer_src + i, skip);
+			i += skip;
+			if (i == nal_size) break;
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		other than the following sequences shall not occur at any byte-aligned position:
 		0x00000300
@@ -4726,6 +4884,11 @@ u32 gf_media_nalu_emulation_bytes_remove_count(const char *buffer, u32 nal_size)
 
 	while (i < nal_size)
 	{
+		/*no emulation prevention byte before the next two zero bytes*/
+		if (!num_zero) {
+			i += gf_media_nalu_next_zero_pair((u8 *) buffer + i, nal_size - i);
+			if (i == nal_size) break;
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		  other than the following sequences shall not occur at any byte-aligned position:
 		  \96 0x00000300
@@ -4764,6 +4927,14 @@ u32 gf_media_nalu_remove_emulation_bytes(const char *buffer_src, char *buffer_ds
 
 	while (i < nal_size)
 	{
+		/*no emulation prevention byte before the next two zero bytes*/
+		if (!num_zero) {
+			u32 skip = gf_media_nalu_next_zero_pair((u8 *) buffer_src + i, nal_size - i);
+			/*source and destination may be the same buffer*/
+			memmove(buffer_dst + i - emulation_bytes_count, buffer_src + i, skip);
+			i += skip;
+			if (i == nal_size) break;
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		  other than the following sequences shall not occur at any byte-aligned position:
 		  0x00000300
@@ -150,6 +150,9 @@ struct __dash_client
 	Bool use_threaded_download;
 	Bool ignore_xlink;
 
+	/*number of segment requests kept in flight per group, 0 or 1 disables prefetching*/
+	u32 prefetch_depth;
+
 	//0: not atsc - 1: atsc but clock not init 2- atsc clock init
 	u32 atsc_clock_state;
 	//atsc AST shift in ms
@@ -194,6 +197,22 @@ typedef struct
 	Bool has_dep_following;
 } segment_cache_entry;
 
+/*segment request issued ahead of the segment being downloaded*/
+typedef struct
+{
+	GF_DASHFileIOSession sess;
+	GF_Thread *th;
+	/*0: free, 1: downloading, 2: done*/
+	volatile u32 state;
+	GF_Err error;
+	s32 segment_index;
+	u32 representation_index;
+	u64 start_range, end_range;
+	/*number of transfers running for the group when the request was issued*/
+	u32 nb_parallel;
+	GF_DashClient *dash;
+} segment_prefetch_entry;
+
 typedef enum
 {
 	/*set if group cannot be selected (wrong MPD)*/
@@ -260,6 +279,10 @@ struct __dash_group
 	segment_cache_entry *cached;
 
 	GF_DASHFileIOSession segment_download;
+	/*segments prefetched in parallel of segment_download, only used for independent representations*/
+	segment_prefetch_entry *prefetch;
+	u32 nb_prefetch;
+	GF_Mutex *prefetch_mutex;
 	//0: not set, 1: abort because group has been stopped - 2: abort because bandwidth was too low
 	u32 download_abort_type;
 	/*usually 0-0 (no range) but can be non-zero when playing local MPD/DASH sessions*/
@@ -464,13 +487,64 @@ void gf_dash_get_buffer_info(GF_DashClient *dash, u32 *total_buffer, u32 *media_
 static void gf_dash_update_buffering(GF_DASH_Group *group, GF_DashClient *dash)
 {
 	if (dash->nb_buffering) {
+		/*only segments in the cache are accounted, prefetched segments still in flight are not. The cache size may have
+		been clamped below the number of segments to buffer, in which case a full cache ends buffering*/
+		u32 nb_segs = MIN(group->max_buffer_segments, group->max_cached_segments);
 		dash->dash_io->on_dash_event(dash->dash_io, GF_DASH_EVENT_BUFFERING, -1, GF_OK);
 
-		if (group->cached[0].duration && group->nb_cached_segments>=group->max_buffer_segments)
+		if (group->cached[0].duration && group->nb_cached_segments>=nb_segs)
 			gf_dash_buffer_off(group);
 	}
 }
 
+/*aborts a segment prefetch and releases its slot, the session is kept for the next request*/
+static void gf_dash_prefetch_discard(GF_DashClient *dash, segment_prefetch_entry *pf)
+{
+	if (pf->state==1)
+		dash->dash_io->abort(dash->dash_io, pf->sess);
+	if (pf->state) {
+		gf_th_stop(pf->th);
+		/*segment was downloaded but will not be used*/
+		if ((pf->state==2) && (pf->error==GF_OK) && !dash->keep_files) {
+			const char *url = dash->dash_io->get_url(dash->dash_io, pf->sess);
+			if (url) dash->dash_io->delete_cache_file(dash->dash_io, pf->sess, url);
+		}
+	}
+	pf->state = 0;
+	pf->segment_index = -1;
+}
+
+/*aborts all pending segment prefetches of the group - called upon representation switch, seek and stop*/
+static void gf_dash_group_prefetch_cancel(GF_DashClient *dash, GF_DASH_Group *group)
+{
+	u32 i;
+	if (!group->nb_prefetch) return;
+
+	gf_mx_p(group->prefetch_mutex);
+	for (i=0; i<group->nb_prefetch; i++) {
+		gf_dash_prefetch_discard(dash, &group->prefetch[i]);
+	}
+	gf_mx_v(group->prefetch_mutex);
+}
+
+static void gf_dash_group_prefetch_del(GF_DashClient *dash, GF_DASH_Group *group)
+{
+	u32 i;
+	if (!group->nb_prefetch) return;
+
+	gf_dash_group_prefetch_cancel(dash, group);
+	for (i=0; i<group->nb_prefetch; i++) {
+		if (group->prefetch[i].sess)
+			dash->dash_io->del(dash->dash_io, group->prefetch[i].sess);
+		gf_th_del(group->prefetch[i].th);
+	}
+	gf_free(group->prefetch);
+	group->prefetch = NULL;
+	group->nb_prefetch = 0;
+	gf_mx_del(group->prefetch_mutex);
+	group->prefetch_mutex = NULL;
+}
+
 
 GF_EXPORT
 Bool gf_dash_check_mpd_root_type(const char *local_url)
@@ -1477,8 +1551,9 @@ static u32 gf_dash_get_index_in_timeline(GF_MPD_SegmentTimeline *timeline, u64 s
 
 static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient *dash, GF_MPD_SegmentList *old_list, GF_MPD_SegmentTemplate *old_template, GF_MPD_SegmentList *new_list, GF_MPD_SegmentTemplate *new_template, Double min_start_time)
 {
+	GF_Err e;
 	GF_MPD_SegmentTimeline *old_timeline, *new_timeline;
-	u32 i, idx, timescale, nb_new_segs;
+	u32 i, idx, timescale, old_timescale, nb_new_segs;
 	GF_MPD_SegmentTimelineEntry *ent;
 
 	old_timeline = new_timeline = NULL;
@@ -1490,6 +1565,7 @@ static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient
 		old_timeline = old_list->segment_timeline;
 		new_timeline = new_list->segment_timeline;
 		timescale = new_list->timescale;
+		old_timescale = old_list->timescale;
 	} else if (old_template && old_template->segment_timeline) {
 		if (!new_template || !new_template->segment_timeline) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: segment timeline not present in new MPD segmentTemplate\n"));
@@ -1498,6 +1574,7 @@ static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient
 		old_timeline = old_template->segment_timeline;
 		new_timeline = new_template->segment_timeline;
 		timescale = new_template->timescale;
+		old_timescale = old_template->timescale;
 	}
 	if (!old_timeline && !new_timeline) return GF_OK;
 
@@ -1510,6 +1587,20 @@ static GF_Err gf_dash_merge_segment_timeline(GF_DASH_Group *group, GF_DashClient
 		}
 	}
 
+	/*keep the known entries and only append the new segments, the merged timeline is moved to the new MPD.
+	Segments already purged from the timeline are not restored*/
+	if (old_timescale == timescale) {
+		e = gf_mpd_segment_timeline_merge(old_timeline, new_timeline, &nb_new_segs);
+		if (e==GF_OK) {
+			GF_List *entries = old_timeline->entries;
+			old_timeline->entries = new_timeline->entries;
+			new_timeline->entries = entries;
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Merged SegmentTimeline update: %d new segments\n", nb_new_segs));
+		} else {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Cannot merge SegmentTimeline update (%s), using new timeline\n", gf_error_to_string(e) ));
+		}
+	}
+
 	nb_new_segs = 0;
 	idx=0;
 	while ((ent = gf_list_enum(new_timeline->entries, &idx))) {
@@ -1712,8 +1803,7 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 	GF_Err e;
 	Bool force_timeline_setup = GF_FALSE;
 	u32 group_idx, rep_idx, i, j;
-	u64 fetch_time=0;
-	GF_DOMParser *mpd_parser;
+	u64 fetch_time=0, parse_time=0, merge_time;
 	u8 signature[GF_SHA1_DIGEST_SIZE];
 	GF_MPD_Period *period, *new_period;
 	const char *local_url;
@@ -1858,16 +1948,10 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 
 		/* It means we have to reparse the file ... */
 		/* parse the MPD */
-		mpd_parser = gf_xml_dom_new();
-		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
-		if (e != GF_OK) {
-			gf_xml_dom_del(mpd_parser);
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in XML parsing %s\n", gf_error_to_string(e)));
-			return GF_NON_COMPLIANT_BITSTREAM;
-		}
 		new_mpd = gf_mpd_new();
-		e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), new_mpd, purl);
-		gf_xml_dom_del(mpd_parser);
+		parse_time = gf_sys_clock_high_res();
+		e = gf_mpd_init_from_file(local_url, new_mpd, purl);
+		parse_time = gf_sys_clock_high_res() - parse_time;
 		if (e) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in MPD creation %s\n", gf_error_to_string(e)));
 			gf_mpd_del(new_mpd);
@@ -1990,6 +2074,7 @@ restart_period_check:
 		else timeline_start_time = 0;
 	}
 
+	merge_time = gf_sys_clock_high_res();
 	/*update segmentTimeline at Period level*/
 	e = gf_dash_merge_segment_timeline(NULL, dash, period->segment_list, period->segment_template, new_period->segment_list, new_period->segment_template, timeline_start_time);
 	if (e) {
@@ -2035,6 +2120,7 @@ restart_period_check:
 		/*get all representations in both periods*/
 		for (rep_idx = 0; rep_idx <gf_list_count(group->adaptation_set->representations); rep_idx++) {
 			GF_List *segments, *new_segments;
+			u32 search_start;
 			GF_MPD_Representation *rep = gf_list_get(group->adaptation_set->representations, rep_idx);
 			GF_MPD_Representation *new_rep = gf_list_get(new_set->representations, rep_idx);
 
@@ -2137,11 +2223,16 @@ restart_period_check:
 				if (new_rep->segment_list && new_rep->segment_list->segment_URLs) new_segments = new_rep->segment_list->segment_URLs;
 
 
+				search_start = 0;
 				for (i=0; i<gf_list_count(new_segments); i++) {
 					GF_MPD_SegmentURL *new_seg = gf_list_get(new_segments, i);
 					Bool found = GF_FALSE;
-					for (j=0; j<gf_list_count(segments); j++) {
-						GF_MPD_SegmentURL *seg = gf_list_get(segments, j);
+					u32 k, nb_segs = gf_list_count(segments);
+					/*both lists are ordered, start looking after the last match*/
+					for (k=0; k<nb_segs; k++) {
+						GF_MPD_SegmentURL *seg;
+						j = (search_start + k) % nb_segs;
+						seg = gf_list_get(segments, j);
 						if (seg->media && new_seg->media && !strcmp(seg->media, new_seg->media)) {
 							found=1;
 							break;
@@ -2151,6 +2242,7 @@ restart_period_check:
 							break;
 						}
 					}
+					if (found) search_start = j+1;
 					/*this is a new segment, merge it: we remove from new list and push to old one, before doing a final swap
 					this ensures that indexing in the segment_list is still correct after merging*/
 					if (!found) {
@@ -2252,6 +2344,9 @@ restart_period_check:
 			return e;
 		}
 	}
+	merge_time = gf_sys_clock_high_res() - merge_time;
+	GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Manifest update parsed in "LLU" us - merged in "LLU" us\n", parse_time, merge_time));
+
 	//good to go, switch pointers
 	for (group_idx=0; group_idx<gf_list_count(dash->groups); group_idx++) {
 		Double seg_dur;
@@ -2372,6 +2467,9 @@ static void gf_dash_set_group_representation(GF_DASH_Group *group, GF_MPD_Repres
 		group->max_complementary_rep_index = i;
 	else
 		group->active_rep_index = i;
+	/*segments prefetched from the previous representation are no longer needed*/
+	if (group->active_rep_index != prev_active_rep_index)
+		gf_dash_group_prefetch_cancel(group->dash, group);
 	group->active_bitrate = rep->bandwidth;
 	group->max_cached_segments = nb_cached_seg_per_rep * gf_dash_group_count_rep_needed(group);
 	nb_segs = group->nb_segments_in_rep;
@@ -3882,6 +3980,7 @@ static void gf_dash_group_reset(GF_DashClient *dash, GF_DASH_Group *group)
 		dash->dash_io->del(dash->dash_io, group->segment_download);
 		group->segment_download = NULL;
 	}
+	gf_dash_group_prefetch_del(dash, group);
 	while (group->nb_cached_segments) {
 		group->nb_cached_segments --;
 		if (!dash->keep_files && !group->local_files)
@@ -5406,6 +5505,188 @@ typedef enum
 
 static DownloadGroupStatus dash_download_group_download(GF_DashClient *dash, GF_DASH_Group *group, GF_DASH_Group *base_group, Bool has_dep_following);
 
+static u32 dash_prefetch_thread(void *par)
+{
+	GF_Err e = GF_OK;
+	segment_prefetch_entry *pf = (segment_prefetch_entry *) par;
+	GF_DASHFileIO *dash_io = pf->dash->dash_io;
+
+	if (pf->end_range)
+		e = dash_io->set_range(dash_io, pf->sess, pf->start_range, pf->end_range, GF_TRUE);
+	if (!e)
+		e = dash_io->init(dash_io, pf->sess);
+	if (e>=GF_OK) {
+		/*segments which cannot be cached are left to the regular download*/
+		if (dash_io->get_cache_name(dash_io, pf->sess) == NULL)
+			e = GF_NOT_SUPPORTED;
+		else
+			e = dash_io->run(dash_io, pf->sess);
+	}
+	pf->error = e;
+	pf->state = 2;
+	return 0;
+}
+
+/*issues requests for the segments following the one about to be downloaded, so that up to prefetch_depth segments
+are fetched in parallel for the group. Returns the number of prefetches still downloading*/
+static u32 dash_group_prefetch_segments(GF_DashClient *dash, GF_DASH_Group *group, GF_MPD_Representation *rep, u32 representation_index, const char *base_url)
+{
+	u32 i, k, nb_busy = 0, nb_running = 0;
+	GF_MPD_Type dyn_type = dash->mpd->type;
+	if (group->period->origin_base_url)
+		dyn_type = group->period->type;
+
+	if (dash->prefetch_depth<2) return 0;
+	/*only for independent representations played forward*/
+	if (group->groups_depending_on || group->depend_on_group || group->base_rep_index_plus_one) return 0;
+	if (group->local_files || group->segment_must_be_streamed) return 0;
+	if ((dash->speed<0) || dash->atsc_clock_state) return 0;
+
+	if (!group->nb_prefetch) {
+		group->prefetch = gf_malloc(sizeof(segment_prefetch_entry) * (dash->prefetch_depth-1));
+		if (!group->prefetch) return 0;
+		memset(group->prefetch, 0, sizeof(segment_prefetch_entry) * (dash->prefetch_depth-1));
+		group->prefetch_mutex = gf_mx_new("DashGroupPrefetch");
+		group->nb_prefetch = dash->prefetch_depth-1;
+		for (i=0; i<group->nb_prefetch; i++) {
+			group->prefetch[i].th = gf_th_new("DashGroupPrefetch");
+			group->prefetch[i].segment_index = -1;
+			group->prefetch[i].dash = dash;
+		}
+	}
+
+	gf_mx_p(group->prefetch_mutex);
+	/*discard requests not matching the download position or the active representation*/
+	for (i=0; i<group->nb_prefetch; i++) {
+		segment_prefetch_entry *pf = &group->prefetch[i];
+		if (!pf->state) continue;
+		if ((pf->representation_index != representation_index)
+			|| (pf->segment_index < group->download_segment_index)
+			|| (pf->segment_index > group->download_segment_index + (s32) group->nb_prefetch)
+		) {
+			gf_dash_prefetch_discard(dash, pf);
+		} else if (pf->segment_index > group->download_segment_index) {
+			nb_busy++;
+			if (pf->state==1) nb_running++;
+		}
+	}
+
+	for (k=1; k<=group->nb_prefetch; k++) {
+		GF_Err e;
+		char *url = NULL;
+		u64 start_range, end_range, duration;
+		s32 seg_idx = group->download_segment_index + k;
+		segment_prefetch_entry *pf = NULL;
+		Bool found = GF_FALSE;
+
+		/*keep room in the cache for the current segment and all pending requests*/
+		if (group->nb_cached_segments + nb_busy + 2 > group->max_cached_segments) break;
+		if (group->nb_segments_in_rep && (seg_idx >= (s32) group->nb_segments_in_rep)) break;
+
+		for (i=0; i<group->nb_prefetch; i++) {
+			if (group->prefetch[i].state && (group->prefetch[i].segment_index == seg_idx)) found = GF_TRUE;
+			else if (!pf && !group->prefetch[i].state) pf = &group->prefetch[i];
+		}
+		if (found) continue;
+		if (!pf) break;
+
+		/*do not request segments not yet available*/
+		if (!group->broken_timing && (dyn_type==GF_MPD_TYPE_DYNAMIC) && !dash->is_m3u8) {
+			u32 seg_dur_ms = 0;
+			s64 segment_ast = (s64) gf_dash_get_segment_availability_start_time(dash->mpd, group, seg_idx, &seg_dur_ms);
+			if (segment_ast > (s64) gf_net_get_utc()) break;
+		}
+
+		e = gf_dash_resolve_url(dash->mpd, rep, group, base_url, GF_MPD_RESOLVE_URL_MEDIA, seg_idx, &url, &start_range, &end_range, &duration, NULL, NULL, NULL, NULL);
+		if (e || !url) break;
+		if (!strstr(url, "://") || !strnicmp(url, "file://", 7) || !strnicmp(url, "gmem://", 7)) {
+			gf_free(url);
+			break;
+		}
+		/*prefetch sessions are not attached to the group, the user only monitors the current segment download*/
+		if (!pf->sess) {
+			pf->sess = dash->dash_io->create(dash->dash_io, GF_TRUE, url, -1);
+			e = pf->sess ? GF_OK : GF_OUT_OF_MEM;
+		} else {
+			e = dash->dash_io->setup_from_url(dash->dash_io, pf->sess, url, -1);
+		}
+		if (e) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DASH] Cannot setup prefetch of segment %s: %s\n", url, gf_error_to_string(e) ));
+			gf_free(url);
+			break;
+		}
+
+		pf->segment_index = seg_idx;
+		pf->representation_index = representation_index;
+		pf->start_range = start_range;
+		pf->end_range = end_range;
+		pf->nb_parallel = nb_running + 2;
+		pf->error = GF_OK;
+		pf->state = 1;
+		gf_th_stop(pf->th);
+		e = gf_th_run(pf->th, dash_prefetch_thread, pf);
+		if (e) {
+			pf->state = 0;
+			pf->segment_index = -1;
+			gf_free(url);
+			break;
+		}
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Prefetching segment %s (%d requests in flight)\n", url, nb_running+2));
+		gf_free(url);
+		nb_busy++;
+		nb_running++;
+	}
+	gf_mx_v(group->prefetch_mutex);
+	return nb_running;
+}
+
+/*waits for the prefetch of the segment at the download position. Returns the session holding the segment, or NULL
+if the segment was not prefetched, failed or was cancelled*/
+static GF_DASHFileIOSession dash_group_prefetch_wait(GF_DashClient *dash, GF_DASH_Group *group, u32 representation_index, u32 *nb_parallel)
+{
+	u32 i;
+	s32 seg_idx = group->download_segment_index;
+	segment_prefetch_entry *pf = NULL;
+	GF_DASHFileIOSession sess = NULL;
+
+	if (!group->nb_prefetch) return NULL;
+
+	gf_mx_p(group->prefetch_mutex);
+	for (i=0; i<group->nb_prefetch; i++) {
+		if (group->prefetch[i].state && (group->prefetch[i].segment_index == seg_idx) && (group->prefetch[i].representation_index == representation_index)) {
+			pf = &group->prefetch[i];
+			break;
+		}
+	}
+	if (!pf) {
+		gf_mx_v(group->prefetch_mutex);
+		return NULL;
+	}
+	while (pf->state==1) {
+		if (group->download_abort_type) break;
+		gf_mx_v(group->prefetch_mutex);
+		gf_sleep(1);
+		gf_mx_p(group->prefetch_mutex);
+		/*cancelled*/
+		if (pf->segment_index != seg_idx) {
+			gf_mx_v(group->prefetch_mutex);
+			return NULL;
+		}
+	}
+	if ((pf->state==2) && (pf->error==GF_OK)) {
+		gf_th_stop(pf->th);
+		sess = pf->sess;
+		*nb_parallel = pf->nb_parallel;
+		pf->state = 0;
+		pf->segment_index = -1;
+	} else {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Prefetch of segment %d failed (%s), downloading it again\n", seg_idx, gf_error_to_string(pf->error) ));
+		gf_dash_prefetch_discard(dash, pf);
+	}
+	gf_mx_v(group->prefetch_mutex);
+	return sess;
+}
+
 
 /*TODO decide what is the best, fetch from another representation or ignore ...*/
 static DownloadGroupStatus on_group_download_error(GF_DashClient *dash, GF_DASH_Group *group, GF_DASH_Group *base_group, GF_Err e, GF_MPD_Representation *rep, char *new_base_seg_url, char *key_url, Bool has_dep_following)
@@ -5741,14 +6022,28 @@ static DownloadGroupStatus dash_download_group_download(GF_DashClient *dash, GF_
 		group->current_base_url_idx = 0;
 	} else {
 		const char *hdr;
+		GF_DASHFileIOSession seg_sess = NULL;
+		u32 nb_parallel = 1;
 		base_group->max_bitrate = 0;
 		base_group->min_bitrate = (u32)-1;
 
-		/*use persistent connection for segment downloads*/
-		if (use_byterange) {
-			e = gf_dash_download_resource(dash, &(base_group->segment_download), new_base_seg_url, start_range, end_range, 1, base_group);
+		if (group==base_group) {
+			/*request the next segments before fetching this one*/
+			nb_parallel += dash_group_prefetch_segments(dash, group, rep, representation_index, base_url);
+			seg_sess = dash_group_prefetch_wait(dash, group, representation_index, &nb_parallel);
+		}
+		if (seg_sess) {
+			e = GF_OK;
+		} else if (base_group->download_abort_type) {
+			e = GF_IP_CONNECTION_CLOSED;
 		} else {
-			e = gf_dash_download_resource(dash, &(base_group->segment_download), new_base_seg_url, 0, 0, 1, base_group);
+			/*use persistent connection for segment downloads*/
+			if (use_byterange) {
+				e = gf_dash_download_resource(dash, &(base_group->segment_download), new_base_seg_url, start_range, end_range, 1, base_group);
+			} else {
+				e = gf_dash_download_resource(dash, &(base_group->segment_download), new_base_seg_url, 0, 0, 1, base_group);
+			}
+			seg_sess = base_group->segment_download;
 		}
 
 		if ((e==GF_IP_CONNECTION_CLOSED) && group->download_abort_type) {
@@ -5794,19 +6089,20 @@ static DownloadGroupStatus dash_download_group_download(GF_DashClient *dash, GF_
 		group->segment_must_be_streamed = base_group->segment_must_be_streamed;
 
 		if (group->segment_must_be_streamed)
-			local_file_name = dash->dash_io->get_url(dash->dash_io, base_group->segment_download);
+			local_file_name = dash->dash_io->get_url(dash->dash_io, seg_sess);
 		else
-			local_file_name = dash->dash_io->get_cache_name(dash->dash_io, base_group->segment_download);
+			local_file_name = dash->dash_io->get_cache_name(dash->dash_io, seg_sess);
 
-		file_size = dash->dash_io->get_total_size(dash->dash_io, base_group->segment_download);
+		file_size = dash->dash_io->get_total_size(dash->dash_io, seg_sess);
 		if (file_size==0) {
 			empty_file = GF_TRUE;
 		}
-		resource_name = dash->dash_io->get_url(dash->dash_io, base_group->segment_download);
+		resource_name = dash->dash_io->get_url(dash->dash_io, seg_sess);
 
-		Bps = dash->dash_io->get_bytes_per_sec(dash->dash_io, base_group->segment_download);
+		/*parallel transfers of the group share the link, the group rate is estimated from the per-session rate*/
+		Bps = nb_parallel * dash->dash_io->get_bytes_per_sec(dash->dash_io, seg_sess);
 
-		hdr = dash->dash_io->get_header_value(dash->dash_io, base_group->segment_download, "x-atsc");
+		hdr = dash->dash_io->get_header_value(dash->dash_io, seg_sess, "x-atsc");
 		if (hdr && !strcmp(hdr, "yes"))
 			rep->playback.broadcast_flag = GF_TRUE;
 	}
@@ -5843,7 +6139,7 @@ static DownloadGroupStatus dash_download_group_download(GF_DashClient *dash, GF_
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Added file to cache (%u/%u in cache): %s\n", base_group->nb_cached_segments+1, base_group->max_cached_segments, cache_entry->url));
 
 			base_group->nb_cached_segments++;
-			gf_dash_update_buffering(group, dash);
+			gf_dash_update_buffering(base_group, dash);
 		}
 		dash_store_stats(dash, group, Bps, file_size, rep->playback.broadcast_flag);
 
@@ -6299,6 +6595,10 @@ restart_period:
 				gf_mx_v(dash->dash_mutex);
 
 				group_count = gf_list_count(dash->groups);
+				/*segment indexes may have been shifted by the update*/
+				for (i=0; i<group_count; i++) {
+					gf_dash_group_prefetch_cancel(dash, gf_list_get(dash->groups, i));
+				}
 				diff = gf_sys_clock() - diff;
 				if (e) {
 					if (!dash->in_error) {
@@ -6566,6 +6866,7 @@ static void gf_dash_download_stop(GF_DashClient *dash)
 					dash->dash_io->abort(dash->dash_io, group->segment_download);
 				group->done = 1;
 			}
+			gf_dash_group_prefetch_cancel(dash, group);
 		}
 	}
 	/* stop the download thread */
@@ -6694,6 +6995,7 @@ static void gf_dash_seek_group(GF_DashClient *dash, GF_DASH_Group *group, Double
 
 	if (group->segment_download)
 		dash->dash_io->abort(dash->dash_io, group->segment_download);
+	gf_dash_group_prefetch_cancel(dash, group);
 
 	if (group->urlToDeleteNext) {
 		if (!dash->keep_files && !group->local_files)
@@ -6948,26 +7250,28 @@ GF_Err gf_dash_open(GF_DashClient *dash, const char *manifest_url)
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] parsing MPD %s\n", local_url));
 
 		/* parse the MPD */
-		mpd_parser = gf_xml_dom_new();
-		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
+		if (dash->is_smooth) {
+			mpd_parser = gf_xml_dom_new();
+			e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
+		} else {
+			e = gf_mpd_init_from_file(local_url, dash->mpd, manifest_url);
+		}
 
 		if (sep_cgi) sep_cgi[0] = '?';
 		if (sep_frag) sep_frag[0] = '#';
 
 		if (e != GF_OK) {
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD parsing problem %s\n", gf_xml_dom_get_error(mpd_parser) ));
-			gf_xml_dom_del(mpd_parser);
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD parsing problem %s\n", mpd_parser ? gf_xml_dom_get_error(mpd_parser) : gf_error_to_string(e) ));
+			if (mpd_parser) gf_xml_dom_del(mpd_parser);
 			dash->dash_io->del(dash->dash_io, dash->mpd_dnload);
 			dash->mpd_dnload = NULL;
 			return GF_URL_ERROR;
 		}
 
-		if (dash->is_smooth) {
+		if (mpd_parser) {
 			e = gf_mpd_init_smooth_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
-		} else {
-			e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
+			gf_xml_dom_del(mpd_parser);
 		}
-		gf_xml_dom_del(mpd_parser);
 
 		if (dash->ignore_xlink)
 			dash_purge_xlink(dash->mpd);
@@ -7737,6 +8041,8 @@ void gf_dash_set_group_done(GF_DashClient *dash, u32 idx, Bool done)
 			group->download_abort_type = 1;
 			dash->dash_io->abort(dash->dash_io, group->segment_download);
 		}
+		if (done)
+			gf_dash_group_prefetch_cancel(dash, group);
 		gf_mx_v(group->cache_mutex);
 		gf_mx_v(dash->dash_mutex);
 	}
@@ -8583,6 +8889,12 @@ void gf_dash_set_threaded_download(GF_DashClient *dash, Bool use_threads)
 	dash->use_threaded_download = use_threads;
 }
 
+GF_EXPORT
+void gf_dash_set_prefetch_depth(GF_DashClient *dash, u32 depth)
+{
+	dash->prefetch_depth = depth;
+}
+
 GF_EXPORT
 void gf_dash_ignore_xlink(GF_DashClient *dash, Bool ignore_xlink)
 {
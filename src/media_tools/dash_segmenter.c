@@ -156,6 +156,9 @@ struct __gf_dash_segmenter
 
 	Bool mvex_after_traks;
 	u32 sdtp_in_traf;
+
+	/*number of threads used to segment representations of an adaptation set in parallel*/
+	u32 nb_threads;
 };
 
 struct _dash_segment_input
@@ -1056,6 +1059,14 @@ static u32 cicp_get_channel_config(u32 nb_chan,u32 nb_surr, u32 nb_lfe)
 
 
 
+/*returns one of the two samples reused by the fragmenter, the one not currently held in @in_use*/
+static GF_ISOSample *dash_get_static_sample(GF_ISOSample **static_samples, GF_ISOSample *in_use)
+{
+	u32 idx = (static_samples[0] && (static_samples[0]==in_use)) ? 1 : 0;
+	if (!static_samples[idx]) static_samples[idx] = gf_isom_sample_new();
+	return static_samples[idx];
+}
+
 static GF_Err isom_segment_file(GF_ISOFile *input, const char *output_file, GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input, Bool first_in_set)
 {
 	u8 NbBits;
@@ -1070,6 +1081,7 @@ static GF_Err isom_segment_file(GF_ISOFile *input, const char *output_file, GF_D
 	u32 cur_seg, fragment_index, max_sap_type;
 	GF_ISOFile *output, *bs_switch_segment;
 	GF_ISOSample *sample, *next;
+	GF_ISOSample *static_samples[2] = {NULL, NULL};
 	GF_List *fragmenters;
 	u64 MaxFragmentDuration, MaxSegmentDuration, period_duration;
 	Double segment_start_time=0, SegmentDuration, maxFragDurationOverSegment;
@@ -2017,7 +2029,7 @@ restart_fragmentation_pass:
 
 				/*first sample in the fragment */
 				if (!sample) {
-					sample = gf_isom_get_sample(input, tf->OriginalTrack, tf->SampleNum + 1, &descIndex);
+					sample = gf_isom_get_sample_ex(input, tf->OriginalTrack, tf->SampleNum + 1, &descIndex, dash_get_static_sample(static_samples, NULL), NULL);
 					if (!sample) {
 						e = gf_isom_last_error(input);
 						goto err_exit;
@@ -2053,11 +2065,10 @@ restart_fragmentation_pass:
 					next_sample_num_offset = sample->nb_pack;
 				}
 
-				next = gf_isom_get_sample(input, tf->OriginalTrack, tf->SampleNum + 1 + next_sample_num_offset, &nextDescIndex);
+				next = gf_isom_get_sample_ex(input, tf->OriginalTrack, tf->SampleNum + 1 + next_sample_num_offset, &nextDescIndex, dash_get_static_sample(static_samples, sample), NULL);
 
 				if (next) sample_duration = gf_isom_get_sample_duration(input, tf->OriginalTrack, tf->SampleNum+1 + next_sample_num_offset);
 				if (clamp_duration && next && clamp_duration*tf->TimeScale < next->DTS + sample_duration) {
-					gf_isom_sample_del(&next);
 					next = NULL;
 				}
 
@@ -2081,7 +2092,7 @@ restart_fragmentation_pass:
 
 					tf->loop_ts_offset = tf->next_sample_dts + sample_duration;
 					loop_track = GF_TRUE;
-					next = gf_isom_get_sample(input, tf->OriginalTrack, 1, &nextDescIndex);
+					next = gf_isom_get_sample_ex(input, tf->OriginalTrack, 1, &nextDescIndex, dash_get_static_sample(static_samples, sample), NULL);
 					next->DTS += tf->loop_ts_offset;
 				} else if (clamp_duration) {
 					if (tf->MediaType!=GF_ISOM_MEDIA_AUDIO) {
@@ -2206,11 +2217,11 @@ restart_fragmentation_pass:
 				tf->next_sample_dts = sample->DTS + sample_duration;
 				last_sample_dts = sample->DTS;
 
+				/*samples are owned by static_samples, only drop the references*/
 				if (split_sample_duration) {
-					gf_isom_sample_del(&next);
+					next = NULL;
 					sample->DTS += sample_duration;
 				} else {
-					gf_isom_sample_del(&sample);
 					sample = next;
 					descIndex = nextDescIndex;
 					tf->SampleNum += next_sample_num_offset;
@@ -2502,7 +2513,6 @@ restart_fragmentation_pass:
 
 				if (stop_frag) {
 					GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Segment %s, done with fragment %d, fragment length %d\n", SegmentName, nbFragmentInSegment, tf->FragmentLength));
-					gf_isom_sample_del(&sample);
 					sample = next = NULL;
 
 					if (!ref_SAP_type)
@@ -3248,6 +3258,8 @@ err_exit:
 	gf_set_progress("ISO File Fragmenting", nb_samp, nb_samp);
 	if (mpd_bs) gf_bs_del(mpd_bs);
 	if (mpd_timeline_bs) gf_bs_del(mpd_timeline_bs);
+	if (static_samples[0]) gf_isom_sample_del(&static_samples[0]);
+	if (static_samples[1]) gf_isom_sample_del(&static_samples[1]);
 	return e;
 }
 
@@ -6584,6 +6596,104 @@ GF_Err gf_dasher_set_isobmff_options(GF_DASHSegmenter *dasher, Bool mvex_after_t
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_dasher_set_threads(GF_DASHSegmenter *dasher, u32 nb_threads)
+{
+	dasher->nb_threads = nb_threads;
+	return GF_OK;
+}
+
+/*representation segmented on a worker thread: the segmenter state is copied and the MPD
+description of the representation is written in a temp file, appended to the period in input order*/
+typedef struct
+{
+	GF_DASHSegmenter dasher;
+	GF_DashSegInput *dash_input;
+	char szOutName[GF_MAX_PATH];
+	char szSegName[GF_MAX_PATH];
+	Bool first_in_set;
+	GF_Err e;
+} DashRepTask;
+
+typedef struct
+{
+	DashRepTask *tasks;
+	u32 nb_tasks, next_task;
+	GF_Mutex *mx;
+} DashRepPool;
+
+static u32 dash_rep_worker(void *par)
+{
+	DashRepPool *pool = (DashRepPool *)par;
+	while (1) {
+		DashRepTask *task;
+		gf_mx_p(pool->mx);
+		task = (pool->next_task < pool->nb_tasks) ? &pool->tasks[pool->next_task] : NULL;
+		pool->next_task++;
+		gf_mx_v(pool->mx);
+		if (!task) break;
+
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("DASHing file %s\n", task->dash_input->file_name));
+		task->e = task->dash_input->dasher_segment_file(task->dash_input, task->szOutName, &task->dasher, task->first_in_set);
+	}
+	return 0;
+}
+
+/*segments all tasks and writes their MPD descriptions in order in the period, stops at the first error in input order*/
+static GF_Err dash_run_rep_tasks(GF_DASHSegmenter *dasher, DashRepTask *tasks, u32 nb_tasks)
+{
+	DashRepPool pool;
+	GF_Thread *threads[64];
+	GF_Err e = GF_OK;
+	u32 i, nb_threads;
+	char data[4096];
+
+	pool.tasks = tasks;
+	pool.nb_tasks = nb_tasks;
+	pool.next_task = 0;
+	pool.mx = gf_mx_new("DASHRepPool");
+
+	/*the calling thread also segments*/
+	nb_threads = MIN(dasher->nb_threads, nb_tasks) - 1;
+	if (nb_threads > 64) nb_threads = 64;
+	for (i=0; i<nb_threads; i++) {
+		threads[i] = gf_th_new("DASHRepWorker");
+		if (!threads[i] || gf_th_run(threads[i], dash_rep_worker, &pool)) {
+			if (threads[i]) gf_th_del(threads[i]);
+			break;
+		}
+	}
+	nb_threads = i;
+	GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Segmenting %d representations on %d threads\n", nb_tasks, nb_threads+1));
+	dash_rep_worker(&pool);
+	for (i=0; i<nb_threads; i++) {
+		gf_th_del(threads[i]);
+	}
+	gf_mx_del(pool.mx);
+
+	for (i=0; i<nb_tasks; i++) {
+		DashRepTask *task = &tasks[i];
+		if (!e && task->e) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Error while DASH-ing file: %s\n", gf_error_to_string(task->e)));
+			e = task->e;
+		}
+		if (!e) {
+			gf_fseek(task->dasher.mpd, 0, SEEK_SET);
+			while (1) {
+				u32 read = (u32) fread(data, 1, sizeof(data), task->dasher.mpd);
+				if (!read) break;
+				gf_fwrite(data, 1, read, dasher->mpd);
+			}
+			if (task->dasher.max_segment_duration > dasher->max_segment_duration)
+				dasher->max_segment_duration = task->dasher.max_segment_duration;
+			dasher->variable_seg_rad_name = task->dasher.variable_seg_rad_name;
+		}
+		gf_fclose(task->dasher.mpd);
+		task->dasher.mpd = NULL;
+	}
+	return e;
+}
+
 static void dash_input_check_period_id(GF_DASHSegmenter *dasher, GF_DashSegInput *dash_input)
 {
 	if (dash_input->period_id_not_specified) {
@@ -7413,10 +7523,13 @@ GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 			u32 fps_denum = 0;
 			Double seg_duration_in_as = 0;
 			Bool has_scalability = GF_FALSE;
+			Bool has_rep_dependency;
 			u32 use_bs_switching = (dasher->bitstream_switching_mode==GF_DASH_BSMODE_NONE) ? 0 : 1;
 			char *lang;
 			char szFPS[100];
 			Bool is_first_rep = GF_FALSE;
+			DashRepTask *rep_tasks = NULL;
+			u32 nb_rep_tasks;
 			Bool skip_init_segment_creation = GF_FALSE;
 
 			dasher->segment_alignment_disabled = GF_FALSE;
@@ -7558,10 +7671,20 @@ GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 			if (e) goto exit;
 
 			nb_rep_in_set = 0;
+			has_rep_dependency = GF_FALSE;
 			for (i=0; i<dasher->nb_inputs && !e; i++) {
 				GF_DashSegInput *dash_input = &dasher->inputs[i];
-				if (dash_input->adaptation_set==cur_adaptation_set+1)
+				if (dash_input->adaptation_set==cur_adaptation_set+1) {
 					nb_rep_in_set++;
+					if (dash_input->dependencyID) has_rep_dependency = GF_TRUE;
+				}
+			}
+
+			/*segment representations in parallel - not possible when the DASH context is used, since it is shared by all representations,
+			nor for scalable representations, which need the bandwidth of their lower layers once these are segmented*/
+			nb_rep_tasks = 0;
+			if ((dasher->nb_threads>1) && (nb_rep_in_set>1) && !dasher->dash_ctx && !has_rep_dependency) {
+				rep_tasks = (DashRepTask *) gf_malloc(sizeof(DashRepTask) * nb_rep_in_set);
 			}
 
 			is_first_rep = GF_TRUE;
@@ -7662,8 +7785,24 @@ GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 					dasher->fragment_duration = dasher->segment_duration;
 				}
 
-				GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("DASHing file %s\n", dash_input->file_name));
-				e = dash_input->dasher_segment_file(dash_input, szOutName, dasher, is_first_rep);
+				if (rep_tasks) {
+					DashRepTask *task = &rep_tasks[nb_rep_tasks];
+					memcpy(&task->dasher, dasher, sizeof(GF_DASHSegmenter));
+					task->dash_input = dash_input;
+					task->first_in_set = is_first_rep;
+					task->e = GF_OK;
+					strcpy(task->szOutName, szOutName);
+					if (segment_name) {
+						strcpy(task->szSegName, segment_name);
+						task->dasher.seg_rad_name = task->szSegName;
+					}
+					task->dasher.mpd = gf_temp_file_new(NULL);
+					if (!task->dasher.mpd) e = GF_IO_ERR;
+					else nb_rep_tasks++;
+				} else {
+					GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("DASHing file %s\n", dash_input->file_name));
+					e = dash_input->dasher_segment_file(dash_input, szOutName, dasher, is_first_rep);
+				}
 
 				dasher->seg_rad_name = orig_seg_name;
 				dasher->segment_duration = segdur;
@@ -7671,10 +7810,20 @@ GF_Err gf_dasher_process(GF_DASHSegmenter *dasher, Double sub_duration)
 
 				if (e) {
 					GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Error while DASH-ing file: %s\n", gf_error_to_string(e)));
-					goto exit;
+					break;
 				}
 				is_first_rep = GF_FALSE;
 			}
+			if (rep_tasks) {
+				if (!e) {
+					e = dash_run_rep_tasks(dasher, rep_tasks, nb_rep_tasks);
+				} else {
+					for (i=0; i<nb_rep_tasks; i++) gf_fclose(rep_tasks[i].dasher.mpd);
+				}
+				gf_free(rep_tasks);
+				rep_tasks = NULL;
+			}
+			if (e) goto exit;
 			/*close adaptation set*/
 			fprintf(period_mpd, "  </AdaptationSet>\n");
 		}
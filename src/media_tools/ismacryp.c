@@ -31,6 +31,7 @@
 #include <gpac/constants.h>
 #include <gpac/internal/isomedia_dev.h>
 #include <gpac/crypt.h>
+#include <gpac/thread.h>
 #include <math.h>
 
 
@@ -963,6 +964,30 @@ static void increase_counter(char *x, int x_size) {
 	return;
 }
 
+/*encrypted byte ranges of a sample, processed in a single call once the sample is rewritten*/
+typedef struct
+{
+	GF_CryptRange *ranges;
+	u32 nb_ranges, nb_alloc;
+	/*end offset of the last range in the sample*/
+	u32 end;
+	/*pattern to use, only set when the ranges are handed over for pipelined encryption*/
+	u8 crypt_byte_block, skip_byte_block;
+} CENCRanges;
+
+static void cenc_add_range(CENCRanges *cr, u32 offset, u32 size)
+{
+	if (!size) return;
+	if (cr->nb_ranges == cr->nb_alloc) {
+		cr->nb_alloc = cr->nb_alloc ? 2*cr->nb_alloc : 32;
+		cr->ranges = (GF_CryptRange *)gf_realloc(cr->ranges, sizeof(GF_CryptRange)*cr->nb_alloc);
+	}
+	cr->ranges[cr->nb_ranges].clear_bytes = offset - cr->end;
+	cr->ranges[cr->nb_ranges].crypt_bytes = size;
+	cr->nb_ranges++;
+	cr->end = offset + size;
+}
+
 static void cenc_resync_IV(GF_Crypt *mc, char IV[16], u8 IV_size)
 {
 	char next_IV[17];
@@ -1003,6 +1028,52 @@ static void cenc_resync_IV(GF_Crypt *mc, char IV[16], u8 IV_size)
 	memcpy(IV, next_IV+1, 16*sizeof(char));
 }
 
+/*number of bytes going through the CTR keystream for the given ranges*/
+static u64 cenc_ranges_crypt_size(CENCRanges *cr)
+{
+	u32 i;
+	u64 size = 0;
+	u32 crypt = 16 * (u32) cr->crypt_byte_block;
+	u32 skip = 16 * (u32) cr->skip_byte_block;
+
+	for (i=0; i<cr->nb_ranges; i++) {
+		u32 res = cr->ranges[i].crypt_bytes;
+		if (!crypt || !skip) {
+			size += res;
+			continue;
+		}
+		/*same walk as gf_crypt_encrypt_ranges*/
+		while (res) {
+			size += (res >= crypt) ? crypt : res;
+			if (res < crypt + skip) break;
+			res -= crypt + skip;
+		}
+	}
+	return size;
+}
+
+/*computes the IV of the next sample once nb_bytes were encrypted in CTR mode starting from IV,
+giving the same result as cenc_resync_IV without needing the cipher state*/
+static void cenc_next_IV(char IV[16], u8 IV_size, u64 nb_bytes)
+{
+	s32 i;
+	u64 nb_blocks = (nb_bytes + 15) / 16;
+
+	/*the counter was incremented for each started block*/
+	for (i=15; (i>=0) && nb_blocks; i--) {
+		u32 v = (u8) IV[i] + (u32) (nb_blocks & 0xFF);
+		IV[i] = (char) (v & 0xFF);
+		nb_blocks = (nb_blocks >> 8) + (v >> 8);
+	}
+	/*cf notes in cenc_resync_IV*/
+	if (IV_size == 8) {
+		increase_counter(IV, IV_size);
+		memset(IV+8, 0, 8*sizeof(char));
+	} else if (nb_bytes % 16) {
+		increase_counter(IV, IV_size);
+	}
+}
+
 //parses slice header and returns its size
 static u32 gf_cenc_get_clear_bytes(GF_TrackCryptInfo *tci, GF_BitStream *plaintext_bs, char *samp_data, u32 nal_size, u32 bytes_in_nalhr)
 {
@@ -1111,8 +1182,9 @@ typedef enum {
 	ENC_VP9,  /*custom, see https://www.webmproject.org/vp9/mp4/*/
 } GF_Enc_BsFmt;
 
+/*if deferred is set, the sample is not encrypted and the ranges to encrypt are returned in deferred*/
 static GF_Err gf_cenc_encrypt_sample_ctr(GF_Crypt *mc, GF_TrackCryptInfo *tci, GF_ISOSample *samp, GF_Enc_BsFmt bs_type, u32 nalu_size_length_in_bytes, char IV[16], u32 IV_size, char **sai, u32 *saiz,
-										 u32 bytes_in_nalhr, u8 crypt_byte_block, u8 skip_byte_block)
+										 u32 bytes_in_nalhr, u8 crypt_byte_block, u8 skip_byte_block, CENCRanges *deferred)
 {
 	GF_BitStream *plaintext_bs = NULL, *cyphertext_bs, *sai_bs = NULL;
 	GF_CENCSubSampleEntry *prev_entry = NULL;
@@ -1120,7 +1192,9 @@ static GF_Err gf_cenc_encrypt_sample_ctr(GF_Crypt *mc, GF_TrackCryptInfo *tci, G
 	u32 max_size_in_bytes, unit_size = 0;
 	GF_Err e = GF_OK;
 	GF_List *subsamples = NULL;
+	CENCRanges crypt_ranges;
 
+	memset(&crypt_ranges, 0, sizeof(CENCRanges));
 	plaintext_bs = cyphertext_bs = sai_bs = NULL;
 	max_size_in_bytes = 4096;
 	buffer = (char*)gf_malloc(sizeof(char) * max_size_in_bytes);
@@ -1308,28 +1382,10 @@ static GF_Err gf_cenc_encrypt_sample_ctr(GF_Crypt *mc, GF_TrackCryptInfo *tci, G
 
 				gf_bs_write_data(cyphertext_bs, buffer, clear_bytes);
 
-				//read data to encrypt
+				//read data to encrypt, encrypted with the rest of the sample once written
 				if (unit_size > clear_bytes) {
 					gf_bs_read_data(plaintext_bs, buffer, unit_size - clear_bytes);
-
-					//pattern encryption
-					if (crypt_byte_block && skip_byte_block) {
-						u32 pos = 0;
-						u32 res = unit_size - clear_bytes;
-						while (res) {
-							gf_crypt_encrypt(mc, buffer+pos, res >= (u32) (16*crypt_byte_block) ? 16*crypt_byte_block : res);
-							if (res >= (u32) (16 * (crypt_byte_block + skip_byte_block))) {
-								pos += 16 * (crypt_byte_block + skip_byte_block);
-								res -= 16 * (crypt_byte_block + skip_byte_block);
-							} else {
-								res = 0;
-							}
-						}
-					} else {
-						gf_crypt_encrypt(mc, buffer, unit_size - clear_bytes);
-					}
-
-					/*write encrypted data to bitstream*/
+					cenc_add_range(&crypt_ranges, (u32) gf_bs_get_position(cyphertext_bs), unit_size - clear_bytes);
 					gf_bs_write_data(cyphertext_bs, buffer, unit_size - clear_bytes);
 				}
 				//prev entry is not a VCL, append this NAL
@@ -1388,7 +1444,7 @@ static GF_Err gf_cenc_encrypt_sample_ctr(GF_Crypt *mc, GF_TrackCryptInfo *tci, G
 			}
 
 			gf_bs_read_data(plaintext_bs, buffer, samp->dataLength);
-			gf_crypt_encrypt(mc, buffer, samp->dataLength);
+			cenc_add_range(&crypt_ranges, (u32) gf_bs_get_position(cyphertext_bs), samp->dataLength);
 			gf_bs_write_data(cyphertext_bs, buffer, samp->dataLength);
 		}
 	}
@@ -1400,6 +1456,18 @@ static GF_Err gf_cenc_encrypt_sample_ctr(GF_Crypt *mc, GF_TrackCryptInfo *tci, G
 		samp->dataLength = 0;
 	}
 	gf_bs_get_content(cyphertext_bs, &samp->data, &samp->dataLength);
+	//no pattern in full sample mode
+	if (bs_type == ENC_FULL_SAMPLE)
+		crypt_byte_block = skip_byte_block = 0;
+	if (deferred) {
+		crypt_ranges.crypt_byte_block = crypt_byte_block;
+		crypt_ranges.skip_byte_block = skip_byte_block;
+		memcpy(deferred, &crypt_ranges, sizeof(CENCRanges));
+		memset(&crypt_ranges, 0, sizeof(CENCRanges));
+	} else {
+		e = gf_crypt_encrypt_ranges(mc, (u8 *) samp->data, crypt_ranges.ranges, crypt_ranges.nb_ranges, crypt_byte_block, skip_byte_block, NULL);
+		if (e) goto exit;
+	}
 	if (gf_list_count(subsamples)) {
 		gf_bs_write_u16(sai_bs, gf_list_count(subsamples));
 		while (gf_list_count(subsamples)) {
@@ -1412,10 +1480,14 @@ static GF_Err gf_cenc_encrypt_sample_ctr(GF_Crypt *mc, GF_TrackCryptInfo *tci, G
 	}
 	gf_list_del(subsamples);
 	gf_bs_get_content(sai_bs, sai, saiz);
-	cenc_resync_IV(mc, IV, IV_size);
+	if (deferred)
+		cenc_next_IV(IV, IV_size, cenc_ranges_crypt_size(deferred));
+	else
+		cenc_resync_IV(mc, IV, IV_size);
 
 exit:
 	if (buffer) gf_free(buffer);
+	if (crypt_ranges.ranges) gf_free(crypt_ranges.ranges);
 	if (plaintext_bs) gf_bs_del(plaintext_bs);
 	if (cyphertext_bs) gf_bs_del(cyphertext_bs);
 	if (sai_bs) gf_bs_del(sai_bs);
@@ -1423,15 +1495,18 @@ exit:
 }
 
 
+/*if deferred is set, the sample is not encrypted and the ranges to encrypt are returned in deferred - only valid with constant IV*/
 static GF_Err gf_cenc_encrypt_sample_cbc(GF_Crypt *mc, GF_TrackCryptInfo *tci, GF_ISOSample *samp, GF_Enc_BsFmt bs_type, u32 nalu_size_length_in_bytes, char IV[16], u32 IV_size, char **sai, u32 *saiz,
-										u32 bytes_in_nalhr, u8 crypt_byte_block, u8 skip_byte_block) {
+										u32 bytes_in_nalhr, u8 crypt_byte_block, u8 skip_byte_block, CENCRanges *deferred) {
 	GF_BitStream *plaintext_bs = NULL, *cyphertext_bs = NULL, *sai_bs = NULL;
 	GF_CENCSubSampleEntry *prev_entry = NULL;
 	char *buffer = NULL;
 	u32 max_size, unit_size;
 	GF_Err e = GF_OK;
 	GF_List *subsamples;
+	CENCRanges crypt_ranges;
 
+	memset(&crypt_ranges, 0, sizeof(CENCRanges));
 	plaintext_bs = cyphertext_bs = sai_bs = NULL;
 	max_size = 4096;
 	buffer = (char*)gf_malloc(sizeof(char) * max_size);
@@ -1548,28 +1623,8 @@ static GF_Err gf_cenc_encrypt_sample_cbc(GF_Crypt *mc, GF_TrackCryptInfo *tci, G
 					assert(gf_bs_available(plaintext_bs) >= unit_size - clear_bytes);
 					gf_bs_read_data(plaintext_bs, buffer, unit_size - clear_bytes);
 
-					//cbcs scheme (constant IV), reinit at each sub sample,
-					if (!IV_size)
-						gf_crypt_set_IV(mc, IV, 16);
-					//pattern encryption
-					if (crypt_byte_block && skip_byte_block) {
-						u32 pos = 0;
-						u32 res = unit_size - clear_bytes - clear_bytes_at_end;
-						assert((res % 16) == 0);
-
-						while (res) {
-							gf_crypt_encrypt(mc, buffer + pos, res >= (u32) (16*crypt_byte_block) ? 16*crypt_byte_block : res);
-							if (res >= (u32) (16 * (crypt_byte_block + skip_byte_block))) {
-								pos += 16 * (crypt_byte_block + skip_byte_block);
-								res -= 16 * (crypt_byte_block + skip_byte_block);
-							} else {
-								res = 0;
-							}
-						}
-					} else {
-						gf_crypt_encrypt(mc, buffer, unit_size - clear_bytes - clear_bytes_at_end);
-					}
-					//write the cyphered data, including the non encrypted bytes at the end of the block
+					//encrypted with the rest of the sample once written, leaving the incomplete block at the end in the clear
+					cenc_add_range(&crypt_ranges, (u32) gf_bs_get_position(cyphertext_bs), unit_size - clear_bytes - clear_bytes_at_end);
 					gf_bs_write_data(cyphertext_bs, buffer, unit_size - clear_bytes);
 				}
 
@@ -1625,17 +1680,8 @@ static GF_Err gf_cenc_encrypt_sample_cbc(GF_Crypt *mc, GF_TrackCryptInfo *tci, G
 			gf_bs_read_data(plaintext_bs, buffer, samp->dataLength);
 			clear_trailing = samp->dataLength % 16;
 
-			//cbcs scheme with constant IV, reinit at each sample,
-			if (!IV_size)
-				gf_crypt_set_IV(mc, IV, 16);
-
-			if (samp->dataLength >= 16) {
-				gf_crypt_encrypt(mc, buffer, samp->dataLength - clear_trailing);
-				gf_bs_write_data(cyphertext_bs, buffer, samp->dataLength - clear_trailing);
-			}
-			if (clear_trailing) {
-				gf_bs_write_data(cyphertext_bs, buffer+samp->dataLength - clear_trailing, clear_trailing);
-			}
+			cenc_add_range(&crypt_ranges, (u32) gf_bs_get_position(cyphertext_bs), samp->dataLength - clear_trailing);
+			gf_bs_write_data(cyphertext_bs, buffer, samp->dataLength);
 		}
 	}
 
@@ -1645,6 +1691,16 @@ static GF_Err gf_cenc_encrypt_sample_cbc(GF_Crypt *mc, GF_TrackCryptInfo *tci, G
 		samp->dataLength = 0;
 	}
 	gf_bs_get_content(cyphertext_bs, &samp->data, &samp->dataLength);
+	if (deferred) {
+		crypt_ranges.crypt_byte_block = crypt_byte_block;
+		crypt_ranges.skip_byte_block = skip_byte_block;
+		memcpy(deferred, &crypt_ranges, sizeof(CENCRanges));
+		memset(&crypt_ranges, 0, sizeof(CENCRanges));
+	} else {
+		//cbcs scheme (constant IV), reinit at each sub sample
+		e = gf_crypt_encrypt_ranges(mc, (u8 *) samp->data, crypt_ranges.ranges, crypt_ranges.nb_ranges, crypt_byte_block, skip_byte_block, IV_size ? NULL : (u8 *) IV);
+		if (e) goto exit;
+	}
 	if (gf_list_count(subsamples)) {
 		gf_bs_write_u16(sai_bs, gf_list_count(subsamples));
 		while (gf_list_count(subsamples)) {
@@ -1660,14 +1716,310 @@ static GF_Err gf_cenc_encrypt_sample_cbc(GF_Crypt *mc, GF_TrackCryptInfo *tci, G
 
 exit:
 	if (buffer) gf_free(buffer);
+	if (crypt_ranges.ranges) gf_free(crypt_ranges.ranges);
 	if (plaintext_bs) gf_bs_del(plaintext_bs);
 	if (cyphertext_bs) gf_bs_del(cyphertext_bs);
 	if (sai_bs) gf_bs_del(sai_bs);
 	return e;
 }
 
-/*encrypts track - logs, progress: info callbacks, NULL for default*/
-GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*progress)(void *cbk, u64 done, u64 total), void *cbk)
+/*pipelined CENC encryption: samples are parsed and written back in order by the track thread, the AES processing of each
+sample runs on a pool of workers shared by all tracks, each sample starting from its own precomputed IV*/
+typedef struct
+{
+	GF_Crypt *ctr, *cbc;
+	char ctr_key[16], cbc_key[16];
+} CENCCryptCtx;
+
+enum
+{
+	CENC_JOB_PENDING = 0,
+	/*taken by another thread, the job semaphore is notified once done*/
+	CENC_JOB_RUNNING,
+};
+
+typedef struct
+{
+	GF_ISOSample *samp;
+	u32 sample_num, stsd_idx;
+	Bool ctr_mode;
+	char key[16];
+	/*CTR: IV of the sample, CBC: constant IV*/
+	char IV[16];
+	CENCRanges ranges;
+	char *sai;
+	u32 sai_size;
+	u32 state;
+	GF_Semaphore *done;
+	GF_Err e;
+} CENCJob;
+
+typedef struct
+{
+	GF_Mutex *mx;
+	GF_Semaphore *wake;
+	GF_List *pending;
+	GF_Thread *threads[64];
+	u32 nb_threads;
+	Bool stop;
+} CENCPool;
+
+/*in-order writer of a track*/
+typedef struct
+{
+	CENCPool *pool;
+	CENCJob *jobs;
+	u32 nb_alloc, first, count;
+	CENCCryptCtx crypt;
+
+	GF_ISOFile *mp4;
+	GF_TrackCryptInfo *tci;
+	u32 track, nb_samples, crypt_stsd_idx;
+	Bool use_subsamples;
+	/*serializes ISO file access when tracks are encrypted in parallel, NULL otherwise*/
+	GF_Mutex *file_mx;
+	Bool file_locked;
+} CENCPipeline;
+
+static void cenc_crypt_ctx_reset(CENCCryptCtx *ctx)
+{
+	if (ctx->ctr) gf_crypt_close(ctx->ctr);
+	if (ctx->cbc) gf_crypt_close(ctx->cbc);
+	memset(ctx, 0, sizeof(CENCCryptCtx));
+}
+
+static void cenc_job_process(CENCCryptCtx *ctx, CENCJob *job)
+{
+	GF_Crypt **mc = job->ctr_mode ? &ctx->ctr : &ctx->cbc;
+	char *key = job->ctr_mode ? ctx->ctr_key : ctx->cbc_key;
+
+	if (! *mc) {
+		*mc = gf_crypt_open(GF_AES_128, job->ctr_mode ? GF_CTR : GF_CBC);
+		if (! *mc) {
+			job->e = GF_IO_ERR;
+			return;
+		}
+		/*closes the cipher on failure*/
+		job->e = gf_crypt_init(*mc, job->key, job->IV);
+		if (job->e) {
+			*mc = NULL;
+			return;
+		}
+		memcpy(key, job->key, 16);
+	} else if (memcmp(key, job->key, 16)) {
+		gf_crypt_set_key(*mc, job->key);
+		memcpy(key, job->key, 16);
+	}
+
+	if (job->ctr_mode) {
+		char IV[17];
+		IV[0] = 0;
+		memcpy(IV+1, job->IV, 16);
+		job->e = gf_crypt_set_IV(*mc, IV, 17);
+		if (job->e) return;
+	}
+	job->e = gf_crypt_encrypt_ranges(*mc, (u8 *) job->samp->data, job->ranges.ranges, job->ranges.nb_ranges, job->ranges.crypt_byte_block, job->ranges.skip_byte_block, job->ctr_mode ? NULL : (u8 *) job->IV);
+}
+
+/*runs one pending job of any track on the calling thread, returns GF_FALSE if none*/
+static Bool cenc_pool_run_pending(CENCPool *pool, CENCCryptCtx *ctx)
+{
+	CENCJob *job;
+	gf_mx_p(pool->mx);
+	job = (CENCJob *)gf_list_pop_front(pool->pending);
+	if (job) job->state = CENC_JOB_RUNNING;
+	gf_mx_v(pool->mx);
+	if (!job) return GF_FALSE;
+
+	cenc_job_process(ctx, job);
+	gf_sema_notify(job->done, 1);
+	return GF_TRUE;
+}
+
+static u32 cenc_pool_worker(void *par)
+{
+	CENCPool *pool = (CENCPool *)par;
+	CENCCryptCtx ctx;
+	memset(&ctx, 0, sizeof(CENCCryptCtx));
+
+	while (1) {
+		Bool stop;
+		/*one notification per submitted job, jobs run by the track threads leave spurious wake-ups*/
+		gf_sema_wait(pool->wake);
+		if (cenc_pool_run_pending(pool, &ctx)) continue;
+		gf_mx_p(pool->mx);
+		stop = pool->stop;
+		gf_mx_v(pool->mx);
+		if (stop) break;
+	}
+	cenc_crypt_ctx_reset(&ctx);
+	return 0;
+}
+
+static void cenc_pool_del(CENCPool *pool)
+{
+	u32 i;
+	if (!pool) return;
+	if (pool->nb_threads) {
+		gf_mx_p(pool->mx);
+		pool->stop = GF_TRUE;
+		gf_mx_v(pool->mx);
+		gf_sema_notify(pool->wake, pool->nb_threads);
+		for (i=0; i<pool->nb_threads; i++) {
+			gf_th_del(pool->threads[i]);
+		}
+	}
+	if (pool->wake) gf_sema_del(pool->wake);
+	if (pool->mx) gf_mx_del(pool->mx);
+	if (pool->pending) gf_list_del(pool->pending);
+	gf_free(pool);
+}
+
+/*the threads running the tracks also process jobs while waiting for their samples, the pool only adds nb_threads workers*/
+static CENCPool *cenc_pool_new(u32 nb_threads)
+{
+	u32 i;
+	CENCPool *pool;
+	GF_SAFEALLOC(pool, CENCPool);
+	if (!pool) return NULL;
+	pool->mx = gf_mx_new("CENCPool");
+	pool->pending = gf_list_new();
+	pool->wake = gf_sema_new(0x7FFFFFFF, 0);
+	if (!pool->mx || !pool->pending || !pool->wake) {
+		cenc_pool_del(pool);
+		return NULL;
+	}
+	if (nb_threads > 64) nb_threads = 64;
+	for (i=0; i<nb_threads; i++) {
+		pool->threads[i] = gf_th_new("CENCWorker");
+		if (!pool->threads[i] || gf_th_run(pool->threads[i], cenc_pool_worker, pool)) {
+			if (pool->threads[i]) gf_th_del(pool->threads[i]);
+			break;
+		}
+	}
+	pool->nb_threads = i;
+	return pool;
+}
+
+static void cenc_file_lock(CENCPipeline *pipe, Bool lock)
+{
+	if (!pipe->file_mx || (pipe->file_locked == lock)) return;
+	if (lock) gf_mx_p(pipe->file_mx);
+	else gf_mx_v(pipe->file_mx);
+	pipe->file_locked = lock;
+}
+
+/*waits for the oldest job and writes its sample if no error occured, always returns with the file locked*/
+static GF_Err cenc_pipeline_retire(CENCPipeline *pipe, GF_Err e)
+{
+	CENCJob *job = &pipe->jobs[pipe->first];
+	Bool run_here = GF_FALSE;
+
+	gf_mx_p(pipe->pool->mx);
+	if (job->state == CENC_JOB_PENDING) {
+		gf_list_del_item(pipe->pool->pending, job);
+		run_here = GF_TRUE;
+	}
+	gf_mx_v(pipe->pool->mx);
+
+	cenc_file_lock(pipe, GF_FALSE);
+	if (run_here) {
+		if (!e) cenc_job_process(&pipe->crypt, job);
+	} else {
+		/*help with other jobs before waiting*/
+		while (cenc_pool_run_pending(pipe->pool, &pipe->crypt)) { }
+		gf_sema_wait(job->done);
+	}
+	cenc_file_lock(pipe, GF_TRUE);
+
+	if (!e) e = job->e;
+	if (!e) {
+		gf_isom_update_sample(pipe->mp4, pipe->track, job->sample_num, job->samp, 1);
+		if (pipe->crypt_stsd_idx != job->stsd_idx) {
+			gf_isom_change_sample_desc_index(pipe->mp4, pipe->track, job->sample_num, pipe->crypt_stsd_idx);
+		}
+		if (job->sai_size) {
+			e = gf_isom_track_cenc_add_sample_info(pipe->mp4, pipe->track, pipe->tci->sai_saved_box_type, pipe->tci->IV_size, job->sai, job->sai_size, pipe->use_subsamples, NULL);
+		}
+		if (!e) gf_set_progress("CENC Encrypt", job->sample_num, pipe->nb_samples);
+	}
+	gf_isom_sample_del(&job->samp);
+	if (job->sai) gf_free(job->sai);
+	job->sai = NULL;
+	job->sai_size = 0;
+	if (job->ranges.ranges) gf_free(job->ranges.ranges);
+	memset(&job->ranges, 0, sizeof(CENCRanges));
+
+	pipe->first = (pipe->first + 1) % pipe->nb_alloc;
+	pipe->count--;
+	return e;
+}
+
+/*writes (or discards on error) all pending samples, always returns with the file locked*/
+static GF_Err cenc_pipeline_flush(CENCPipeline *pipe, GF_Err e)
+{
+	while (pipe->count) {
+		e = cenc_pipeline_retire(pipe, e);
+	}
+	cenc_file_lock(pipe, GF_TRUE);
+	return e;
+}
+
+/*returns a free job, writing the oldest sample if needed*/
+static GF_Err cenc_pipeline_get_job(CENCPipeline *pipe, CENCJob **out_job)
+{
+	GF_Err e = GF_OK;
+	*out_job = NULL;
+	if (pipe->count == pipe->nb_alloc) {
+		e = cenc_pipeline_retire(pipe, GF_OK);
+		if (e) return e;
+	}
+	*out_job = &pipe->jobs[(pipe->first + pipe->count) % pipe->nb_alloc];
+	return GF_OK;
+}
+
+static void cenc_pipeline_submit(CENCPipeline *pipe, CENCJob *job)
+{
+	job->e = GF_OK;
+	job->state = CENC_JOB_PENDING;
+	pipe->count++;
+	gf_mx_p(pipe->pool->mx);
+	gf_list_add(pipe->pool->pending, job);
+	gf_mx_v(pipe->pool->mx);
+	gf_sema_notify(pipe->pool->wake, 1);
+}
+
+static GF_Err cenc_pipeline_init(CENCPipeline *pipe, CENCPool *pool)
+{
+	u32 i;
+	pipe->pool = pool;
+	/*enough samples in flight to keep all workers busy while the track thread parses the next ones*/
+	pipe->nb_alloc = 2 * (pool->nb_threads + 1) + 2;
+	pipe->jobs = (CENCJob *)gf_malloc(sizeof(CENCJob) * pipe->nb_alloc);
+	if (!pipe->jobs) return GF_OUT_OF_MEM;
+	memset(pipe->jobs, 0, sizeof(CENCJob) * pipe->nb_alloc);
+	for (i=0; i<pipe->nb_alloc; i++) {
+		pipe->jobs[i].done = gf_sema_new(1, 0);
+		if (!pipe->jobs[i].done) return GF_IO_ERR;
+	}
+	return GF_OK;
+}
+
+static void cenc_pipeline_reset(CENCPipeline *pipe)
+{
+	u32 i;
+	if (pipe->jobs) {
+		for (i=0; i<pipe->nb_alloc; i++) {
+			if (pipe->jobs[i].done) gf_sema_del(pipe->jobs[i].done);
+		}
+		gf_free(pipe->jobs);
+		pipe->jobs = NULL;
+	}
+	cenc_crypt_ctx_reset(&pipe->crypt);
+}
+
+/*encrypts track, pipelining the AES processing of samples on the pool if any*/
+static GF_Err cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, CENCPool *pool, GF_Mutex *file_mx)
 {
 	GF_Err e;
 	char IV[16];
@@ -1685,6 +2037,11 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 	u32 clear_stsd_idx = 1;
 	u32 crypt_stsd_idx = 1;
 	GF_BitStream *bs;
+	CENCPipeline pipe;
+
+	memset(&pipe, 0, sizeof(CENCPipeline));
+	pipe.file_mx = file_mx;
+	cenc_file_lock(&pipe, GF_TRUE);
 
 	nalu_size_length = 0;
 	mc = NULL;
@@ -1695,7 +2052,8 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 	track = gf_isom_get_track_by_id(mp4, tci->trackID);
 	if (!track) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] Cannot find TrackID %d in input file - skipping\n", tci->trackID));
-		return GF_OK;
+		e = GF_OK;
+		goto exit;
 	}
 
 	if (gf_isom_has_time_offset(mp4, track)) gf_isom_set_cts_packing(mp4, track, GF_TRUE);
@@ -1704,7 +2062,8 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 	if (esd && (esd->decoderConfig->streamType == GF_STREAM_OD)) {
 		gf_odf_desc_del((GF_Descriptor *) esd);
 		GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] Cannot encrypt OD tracks - skipping"));
-		return GF_NOT_SUPPORTED;
+		e = GF_NOT_SUPPORTED;
+		goto exit;
 	}
 	if (esd) {
 		if ((esd->decoderConfig->objectTypeIndication==GPAC_OTI_VIDEO_AVC) || (esd->decoderConfig->objectTypeIndication==GPAC_OTI_VIDEO_SVC)) {
@@ -1900,11 +2259,24 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 		use_seig = GF_TRUE;
 	}
 
+	/*samples encrypted with a per-sample IV in CBC mode depend on the previous sample and are encrypted inline*/
+	if (pool && (tci->ctr_mode || !tci->IV_size)) {
+		e = cenc_pipeline_init(&pipe, pool);
+		if (e) goto exit;
+		pipe.mp4 = mp4;
+		pipe.tci = tci;
+		pipe.track = track;
+		pipe.nb_samples = count;
+		pipe.crypt_stsd_idx = crypt_stsd_idx;
+		pipe.use_subsamples = use_subsamples;
+	}
+
 	gf_isom_set_nalu_extract_mode(mp4, track, GF_ISOM_NALU_EXTRACT_INSPECT);
 	for (i = 0; i < count; i++) {
 		bin128 NULL_IV;
 		Bool forced_clear = GF_FALSE;
 		saiz_len=0;
+		cenc_file_lock(&pipe, GF_TRUE);
 		samp = gf_isom_get_sample(mp4, track, i+1, &stsd_idx);
 		if (!samp) {
 			e = GF_IO_ERR;
@@ -1917,6 +2289,9 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 				gf_isom_get_sample_rap_roll_info(mp4, track, i+1, (Bool *) &samp->IsRAP, NULL, NULL);
 
 			if (!samp->IsRAP && !all_rap) {
+				//SAI are added in sample order
+				e = cenc_pipeline_flush(&pipe, GF_OK);
+				if (e) goto exit;
 				//sample is not encrypted, put an empty SAI (size 0)
 				e = gf_isom_track_cenc_add_sample_info(mp4, track, tci->sai_saved_box_type, 0, NULL, 0, GF_FALSE, NULL);
 				if (e)
@@ -1936,6 +2311,9 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 			break;
 		case GF_CRYPT_SELENC_NON_RAP:
 			if (samp->IsRAP || all_rap) {
+				//SAI are added in sample order
+				e = cenc_pipeline_flush(&pipe, GF_OK);
+				if (e) goto exit;
 				//sample is not encrypted, put an empty SAI (size 0)
 				e = gf_isom_track_cenc_add_sample_info(mp4, track, tci->sai_saved_box_type, 0, NULL, 0, GF_FALSE, NULL);
 				if (e)
@@ -1956,6 +2334,9 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 		case GF_CRYPT_SELENC_CLEAR_FORCED:
 			forced_clear = GF_TRUE;
 		case GF_CRYPT_SELENC_CLEAR:
+			//SAI are added in sample order
+			e = cenc_pipeline_flush(&pipe, GF_OK);
+			if (e) goto exit;
 			if (!forced_clear || !tci->force_clear_stsd_idx) {
 				memset(NULL_IV, 0, 16);
 
@@ -2023,11 +2404,13 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 					memcpy(IV, tci->constant_IV, sizeof(char)*16);
 				} else {
 					GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] No IV set and invalid constant IV size %d crypt info file\n", tci->constant_IV_size));
-					return GF_BAD_PARAM;
+					e = GF_BAD_PARAM;
+					goto exit;
 				}
 			} else {
 				GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] Invalid IV size %d in crypt info file\n", tci->IV_size));
-				return GF_NOT_SUPPORTED;
+				e = GF_NOT_SUPPORTED;
+				goto exit;
 			}
 
 			e = gf_crypt_init(mc, tci->key, IV);
@@ -2065,8 +2448,39 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 			if (e) goto exit;
 		}
 
+		if (pipe.jobs) {
+			CENCJob *job;
+			e = cenc_pipeline_get_job(&pipe, &job);
+			if (e) goto exit;
+			cenc_file_lock(&pipe, GF_FALSE);
+
+			job->ctr_mode = tci->ctr_mode;
+			memcpy(job->key, tci->key, 16);
+			memcpy(job->IV, IV, 16);
+			//parse the sample and get its encrypted ranges, IV is set to the IV of the next sample in CTR mode
+			if (tci->ctr_mode) {
+				e = gf_cenc_encrypt_sample_ctr(mc, tci, samp, bs_type, nalu_size_length, IV, tci->IV_size, &saiz_buf, &saiz_len, bytes_in_nalhr, tci->crypt_byte_block, tci->skip_byte_block, &job->ranges);
+			} else {
+				e = gf_cenc_encrypt_sample_cbc(mc, tci, samp, bs_type, nalu_size_length, IV, tci->IV_size, &saiz_buf, &saiz_len, bytes_in_nalhr, tci->crypt_byte_block, tci->skip_byte_block, &job->ranges);
+			}
+			if (e) goto exit;
+
+			job->samp = samp;
+			job->sample_num = i+1;
+			job->stsd_idx = stsd_idx;
+			job->sai = saiz_buf;
+			job->sai_size = saiz_len;
+			samp = NULL;
+			saiz_buf = NULL;
+			cenc_pipeline_submit(&pipe, job);
+
+			nb_samp_encrypted++;
+			continue;
+		}
+
+		cenc_file_lock(&pipe, GF_FALSE);
 		if (tci->ctr_mode) {
-			e = gf_cenc_encrypt_sample_ctr(mc, tci, samp, bs_type, nalu_size_length, IV, tci->IV_size, &saiz_buf, &saiz_len, bytes_in_nalhr, tci->crypt_byte_block, tci->skip_byte_block);
+			e = gf_cenc_encrypt_sample_ctr(mc, tci, samp, bs_type, nalu_size_length, IV, tci->IV_size, &saiz_buf, &saiz_len, bytes_in_nalhr, tci->crypt_byte_block, tci->skip_byte_block, NULL);
 			if (e) goto exit;
 		} else {
 			//in cbcs scheme, if Per_Sample_IV_size is not 0 (no constant IV), fetch current IV
@@ -2074,9 +2488,10 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 				u32 IV_size = 16;
 				gf_crypt_get_IV(mc, IV, &IV_size);
 			}
-			e = gf_cenc_encrypt_sample_cbc(mc, tci, samp, bs_type, nalu_size_length, IV, tci->IV_size, &saiz_buf, &saiz_len, bytes_in_nalhr, tci->crypt_byte_block, tci->skip_byte_block);
+			e = gf_cenc_encrypt_sample_cbc(mc, tci, samp, bs_type, nalu_size_length, IV, tci->IV_size, &saiz_buf, &saiz_len, bytes_in_nalhr, tci->crypt_byte_block, tci->skip_byte_block, NULL);
 			if (e) goto exit;
 		}
+		cenc_file_lock(&pipe, GF_TRUE);
 
 		gf_isom_update_sample(mp4, track, i+1, samp, 1);
 
@@ -2097,39 +2512,48 @@ GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 		nb_samp_encrypted++;
 		gf_set_progress("CENC Encrypt", i+1, count);
 	}
+	e = cenc_pipeline_flush(&pipe, GF_OK);
+	if (e) goto exit;
 
 	gf_isom_set_cts_packing(mp4, track, GF_FALSE);
 	//not strictly needed but we call it in case bitrate info in source is wrong
 	gf_media_update_bitrate(mp4, track);
 
 exit:
+	//discard samples still in the pipeline on error
+	if (pipe.count) cenc_pipeline_flush(&pipe, e);
+	cenc_pipeline_reset(&pipe);
 	if (samp) gf_isom_sample_del(&samp);
 	if (mc) gf_crypt_close(mc);
 	if (saiz_buf) gf_free(saiz_buf);
 	if (bs) gf_bs_del(bs);
 	if (tci->av1.config) gf_odf_av1_cfg_del(tci->av1.config);
+	cenc_file_lock(&pipe, GF_FALSE);
 	return e;
 }
 
+/*encrypts track - logs, progress: info callbacks, NULL for default*/
+GF_Err gf_cenc_encrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*progress)(void *cbk, u64 done, u64 total), void *cbk)
+{
+	return cenc_encrypt_track(mp4, tci, NULL, NULL);
+}
+
 /*decrypts track - logs, progress: info callbacks, NULL for default*/
 GF_Err gf_cenc_decrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*progress)(void *cbk, u64 done, u64 total), void *cbk)
 {
 	GF_Err e;
-	u32 track, count, i, j, si, max_size, subsample_count, nb_samp_decrypted;
+	u32 track, count, i, j, si, subsample_count, nb_samp_decrypted;
 	GF_ISOSample *samp = NULL;
 	GF_Crypt *mc;
 	char IV[17];
 	Bool prev_sample_encrypted;
-	GF_BitStream *plaintext_bs, *cyphertext_bs;
 	GF_CENCSampleAuxInfo *sai;
-	char *buffer;
+	CENCRanges crypt_ranges;
 	u32 scheme_type;
 	Bool is_ctr_mode = GF_FALSE;
 
-	plaintext_bs = cyphertext_bs = NULL;
+	memset(&crypt_ranges, 0, sizeof(CENCRanges));
 	mc = NULL;
-	buffer = NULL;
-	max_size = 4096;
 	nb_samp_decrypted = 0;
 	sai = NULL;
 
@@ -2157,7 +2581,6 @@ GF_Err gf_cenc_decrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 
 	/* decrypt each sample */
 	count = gf_isom_get_sample_count(mp4, track);
-	buffer = (char*)gf_malloc(sizeof(char) * max_size);
 	prev_sample_encrypted = GF_FALSE;
 	gf_isom_set_nalu_extract_mode(mp4, track, GF_ISOM_NALU_EXTRACT_INSPECT);
 	for (i = 0; i < count; i++) {
@@ -2183,7 +2606,6 @@ GF_Err gf_cenc_decrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 			memcpy(tci->key, tci->keys[tci->defaultKeyIdx], 16);
 
 		memset(IV, 0, 17);
-		memset(buffer, 0, max_size);
 
 		samp = gf_isom_get_sample(mp4, track, i+1, &si);
 		if (!samp)
@@ -2198,9 +2620,6 @@ GF_Err gf_cenc_decrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 			goto exit;
 		}
 
-		cyphertext_bs = gf_bs_new(samp->data, samp->dataLength, GF_BITSTREAM_READ);
-		plaintext_bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
-
 		if (sai)
 			sai->IV_size = IV_size;
 
@@ -2261,117 +2680,54 @@ GF_Err gf_cenc_decrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 		}
 
 		//sub-sample encryption
+		crypt_ranges.nb_ranges = 0;
+		crypt_ranges.end = 0;
 		if (sai && sai->subsample_count) {
 			u32 nb_done = 0;
 			subsample_count = 0;
-			while (gf_bs_available(cyphertext_bs)) {
-				GF_CENCSubSampleEntry *sai_e;
-				assert(subsample_count < sai->subsample_count);
-				if (!sai->IV_size) {
-					//cbcs scheme mode, use constant IV
-					memmove(IV, constant_IV, constant_IV_size);
-					if (constant_IV_size == 8)
-						memset(IV+8, 0, sizeof(char)*8);
-					gf_crypt_set_IV(mc, IV, GF_AES_128_KEYSIZE);
-				}
-				sai_e = &sai->subsamples[subsample_count];
+			while ((nb_done < samp->dataLength) && (subsample_count < sai->subsample_count)) {
+				GF_CENCSubSampleEntry *sai_e = &sai->subsamples[subsample_count];
+				u32 nb_crypt = sai_e->bytes_encrypted_data;
+
 				if (nb_done + sai_e->bytes_clear_data + sai_e->bytes_encrypted_data > samp->dataLength) {
 					GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] Error in sample %d subsample info: %d bytes in samples but more bytes signaled in subsample data (%d bytes at subsample %d)\n", i+1, samp->dataLength, nb_done + sai_e->bytes_clear_data + sai_e->bytes_encrypted_data, subsample_count+1));
 					e = GF_NON_COMPLIANT_BITSTREAM;
 					goto exit;
 				}
-				nb_done += sai_e->bytes_clear_data + sai_e->bytes_encrypted_data;
-
-				/*read clear data and write it to plaintext bitstream*/
-				if (max_size < sai_e->bytes_clear_data) {
-					buffer = (char*)gf_realloc(buffer, sizeof(char)*sai_e->bytes_clear_data);
-					max_size = sai_e->bytes_clear_data;
-				}
-				gf_bs_read_data(cyphertext_bs, buffer, sai_e->bytes_clear_data);
-				gf_bs_write_data(plaintext_bs, buffer, sai_e->bytes_clear_data);
-
-				/*now read encrypted data, decrypted it and write to pleintext bitstream*/
-				if (max_size < sai_e->bytes_encrypted_data) {
-					buffer = (char*)gf_realloc(buffer, sizeof(char)*sai_e->bytes_encrypted_data);
-					max_size = sai_e->bytes_encrypted_data;
-				}
-				gf_bs_read_data(cyphertext_bs, buffer, sai_e->bytes_encrypted_data);
-				//pattern decryption
-				if (crypt_byte_block && skip_byte_block) {
-					u32 pos = 0;
-					u32 res = sai_e->bytes_encrypted_data;
-
-					if (!is_ctr_mode) {
-						u32 clear_trailing = res % 16;
-						res -= clear_trailing;
-					}
-
-					while (res) {
-						gf_crypt_decrypt(mc, buffer+pos, res >= (u32) (16*crypt_byte_block) ? 16*crypt_byte_block : res);
-						if (res >= (u32) (16 * (crypt_byte_block + skip_byte_block))) {
-							pos += 16 * (crypt_byte_block + skip_byte_block);
-							res -= 16 * (crypt_byte_block + skip_byte_block);
-						} else {
-							res = 0;
-						}
-					}
-				} else {
-					gf_crypt_decrypt(mc, buffer, sai_e->bytes_encrypted_data);
-				}
-				gf_bs_write_data(plaintext_bs, buffer, sai_e->bytes_encrypted_data);
+				//incomplete block at the end is in the clear in CBC mode
+				if (!is_ctr_mode)
+					nb_crypt -= nb_crypt % 16;
 
+				cenc_add_range(&crypt_ranges, nb_done + sai_e->bytes_clear_data, nb_crypt);
+				nb_done += sai_e->bytes_clear_data + sai_e->bytes_encrypted_data;
 				subsample_count++;
 			}
 		}
 		//full sample encryption
 		else {
 			u32 clear_trailing = 0;
-			if (max_size < samp->dataLength) {
-				buffer = (char*)gf_realloc(buffer, sizeof(char)*samp->dataLength);
-				max_size = samp->dataLength;
-			}
-			gf_bs_read_data(cyphertext_bs, buffer,samp->dataLength);
-
 			if (!is_ctr_mode) {
 				clear_trailing = samp->dataLength % 16;
 			}
-			if (skip_byte_block && crypt_byte_block) {
-				u32 pos = 0;
-				u32 res = samp->dataLength - clear_trailing;
-				while (res) {
-					gf_crypt_decrypt(mc, buffer+pos, res >= (u32) (16*crypt_byte_block) ? 16*crypt_byte_block : res);
-					if (res >= (u32) (16 * (crypt_byte_block + skip_byte_block))) {
-						pos += 16 * (crypt_byte_block + skip_byte_block);
-						res -= 16 * (crypt_byte_block + skip_byte_block);
-					} else {
-						res = 0;
-					}
-				}
-			} else {
-				gf_crypt_decrypt(mc, buffer, samp->dataLength - clear_trailing);
-			}
-			gf_bs_write_data(plaintext_bs, buffer, samp->dataLength - clear_trailing);
+			cenc_add_range(&crypt_ranges, 0, samp->dataLength - clear_trailing);
+		}
 
-			if (clear_trailing) {
-				gf_bs_write_data(plaintext_bs, buffer + samp->dataLength - clear_trailing, clear_trailing);
-			}
+		//decrypt in place, using the constant IV for each subsample in cbcs scheme mode
+		if (sai && sai->subsample_count && !sai->IV_size) {
+			memmove(IV, constant_IV, constant_IV_size);
+			if (constant_IV_size == 8)
+				memset(IV+8, 0, sizeof(char)*8);
+			e = gf_crypt_decrypt_ranges(mc, (u8 *) samp->data, crypt_ranges.ranges, crypt_ranges.nb_ranges, crypt_byte_block, skip_byte_block, (u8 *) IV);
+		} else {
+			e = gf_crypt_decrypt_ranges(mc, (u8 *) samp->data, crypt_ranges.ranges, crypt_ranges.nb_ranges, crypt_byte_block, skip_byte_block, NULL);
 		}
+		if (e) goto exit;
 
 		if (sai) {
 			gf_isom_cenc_samp_aux_info_del(sai);
 			sai = NULL;
 		}
 
-		gf_bs_del(cyphertext_bs);
-		cyphertext_bs = NULL;
-		if (samp->data) {
-			gf_free(samp->data);
-			samp->data = NULL;
-			samp->dataLength = 0;
-		}
-		gf_bs_get_content(plaintext_bs, &samp->data, &samp->dataLength);
-		gf_bs_del(plaintext_bs);
-		plaintext_bs = NULL;
 		gf_isom_update_sample(mp4, track, i+1, samp, 1);
 		gf_isom_sample_del(&samp);
 		samp = NULL;
@@ -2418,10 +2774,8 @@ GF_Err gf_cenc_decrypt_track(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*pro
 
 exit:
 	if (mc) gf_crypt_close(mc);
-	if (plaintext_bs) gf_bs_del(plaintext_bs);
-	if (cyphertext_bs) gf_bs_del(cyphertext_bs);
 	if (samp) gf_isom_sample_del(&samp);
-	if (buffer) gf_free(buffer);
+	if (crypt_ranges.ranges) gf_free(crypt_ranges.ranges);
 	if (sai) gf_isom_cenc_samp_aux_info_del(sai);
 	return e;
 }
@@ -2973,15 +3327,107 @@ static GF_Err gf_cenc_parse_drm_system_info(GF_ISOFile *mp4, const char *drm_fil
 }
 
 
+/*CENC track encrypted on its own thread*/
+typedef struct
+{
+	GF_ISOFile *mp4;
+	/*private copy, the same crypt info may be used by several tracks*/
+	GF_TrackCryptInfo tci;
+	GF_Err e;
+} CENCTrackTask;
+
+typedef struct
+{
+	CENCTrackTask *tasks;
+	u32 nb_tasks, next_task;
+	GF_Mutex *mx;
+	CENCPool *pool;
+	GF_Mutex *file_mx;
+} CENCTrackPool;
+
+static u32 cenc_track_worker(void *par)
+{
+	CENCTrackPool *tpool = (CENCTrackPool *)par;
+	while (1) {
+		CENCTrackTask *task;
+		gf_mx_p(tpool->mx);
+		task = (tpool->next_task < tpool->nb_tasks) ? &tpool->tasks[tpool->next_task] : NULL;
+		tpool->next_task++;
+		gf_mx_v(tpool->mx);
+		if (!task) break;
+
+		task->e = cenc_encrypt_track(task->mp4, &task->tci, tpool->pool, tpool->file_mx);
+	}
+	return 0;
+}
+
+/*encrypts tracks in parallel on nb_threads threads, the threads not used for tracks being AES workers*/
+static GF_Err cenc_run_track_tasks(CENCTrackTask *tasks, u32 nb_tasks, u32 nb_threads)
+{
+	CENCTrackPool tpool;
+	GF_Thread *threads[64];
+	GF_Err e = GF_OK;
+	u32 i, nb_track_threads;
+
+	/*the calling thread also encrypts*/
+	nb_track_threads = MIN(nb_threads, nb_tasks);
+	if (nb_track_threads > 64) nb_track_threads = 64;
+
+	memset(&tpool, 0, sizeof(CENCTrackPool));
+	tpool.tasks = tasks;
+	tpool.nb_tasks = nb_tasks;
+	tpool.mx = gf_mx_new("CENCTrackPool");
+	tpool.pool = cenc_pool_new(nb_threads - nb_track_threads);
+	if (nb_track_threads>1) tpool.file_mx = gf_mx_new("CENCFile");
+	if (!tpool.mx || !tpool.pool || ((nb_track_threads>1) && !tpool.file_mx)) {
+		e = GF_OUT_OF_MEM;
+		goto exit;
+	}
+
+	for (i=0; i<nb_track_threads-1; i++) {
+		threads[i] = gf_th_new("CENCTrack");
+		if (!threads[i] || gf_th_run(threads[i], cenc_track_worker, &tpool)) {
+			if (threads[i]) gf_th_del(threads[i]);
+			break;
+		}
+	}
+	nb_track_threads = i;
+	GF_LOG(GF_LOG_INFO, GF_LOG_AUTHOR, ("[CENC] Encrypting %d tracks on %d threads with %d AES workers\n", nb_tasks, nb_track_threads+1, tpool.pool->nb_threads));
+	cenc_track_worker(&tpool);
+	for (i=0; i<nb_track_threads; i++) {
+		gf_th_del(threads[i]);
+	}
+
+	for (i=0; i<nb_tasks; i++) {
+		if (tasks[i].e) {
+			e = tasks[i].e;
+			break;
+		}
+	}
+
+exit:
+	if (tpool.pool) cenc_pool_del(tpool.pool);
+	if (tpool.file_mx) gf_mx_del(tpool.file_mx);
+	if (tpool.mx) gf_mx_del(tpool.mx);
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_crypt_file(GF_ISOFile *mp4, const char *drm_file)
+{
+	return gf_crypt_file_ex(mp4, drm_file, 0);
+}
+
+GF_EXPORT
+GF_Err gf_crypt_file_ex(GF_ISOFile *mp4, const char *drm_file, u32 nb_threads)
 {
 	GF_Err e;
-	u32 i, count, nb_tracks, common_idx, idx;
+	u32 i, count, nb_tracks, common_idx, idx, nb_tasks;
 	GF_CryptInfo *info;
 	Bool is_oma, is_encrypted=GF_FALSE;
 	GF_TrackCryptInfo *tci;
 	Bool check_pssh = GF_FALSE;
+	CENCTrackTask *tasks = NULL;
 	is_oma = 0;
 
 	info = load_crypt_file(drm_file);
@@ -3012,6 +3458,11 @@ GF_Err gf_crypt_file(GF_ISOFile *mp4, const char *drm_file)
 		}
 	}
 	nb_tracks = gf_isom_get_track_count(mp4);
+	nb_tasks = 0;
+	if (nb_threads>1) {
+		tasks = (CENCTrackTask *)gf_malloc(sizeof(CENCTrackTask) * nb_tracks);
+		if (!tasks) nb_threads = 0;
+	}
 	for (i=0; i<nb_tracks; i++) {
 		GF_Err (*gf_encrypt_track)(GF_ISOFile *mp4, GF_TrackCryptInfo *tci, void (*progress)(void *cbk, u64 done, u64 total), void *cbk);
 		u32 trackID = gf_isom_get_track_id(mp4, i+1);
@@ -3045,6 +3496,7 @@ GF_Err gf_crypt_file(GF_ISOFile *mp4, const char *drm_file)
 			break;
 		default:
 			GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC/ISMA] Encryption type not supported\n"));
+			if (tasks) gf_free(tasks);
 			return GF_NOT_SUPPORTED;
 		}
 
@@ -3053,6 +3505,19 @@ GF_Err gf_crypt_file(GF_ISOFile *mp4, const char *drm_file)
 
 		if (tci->IsEncrypted > 0) {
 			GF_TrackCryptInfo bck;
+
+			/*CENC tracks are encrypted in parallel once all tracks are inspected*/
+			if (tasks && (gf_encrypt_track == gf_cenc_encrypt_track)) {
+				CENCTrackTask *task = &tasks[nb_tasks];
+				nb_tasks++;
+				memset(task, 0, sizeof(CENCTrackTask));
+				task->mp4 = mp4;
+				memcpy(&task->tci, tci, sizeof(GF_TrackCryptInfo));
+				if (!task->tci.trackID) task->tci.trackID = trackID;
+				if (tci->enc_type == 1) is_oma = 1;
+				continue;
+			}
+
 			memcpy(&bck, tci, sizeof(GF_TrackCryptInfo));
 			if (!tci->trackID) tci->trackID = trackID;
 
@@ -3065,6 +3530,12 @@ GF_Err gf_crypt_file(GF_ISOFile *mp4, const char *drm_file)
 		}
 	}
 
+	if (!e && nb_tasks) {
+		e = cenc_run_track_tasks(tasks, nb_tasks, nb_threads);
+		if (!e) is_encrypted = GF_TRUE;
+	}
+	if (tasks) gf_free(tasks);
+
 	if (is_oma) {
 #if 0
 		/*set as OMA V2*/
@@ -433,13 +433,24 @@ void gf_m2ts_mux_table_update_mpeg4(GF_M2TS_Mux_Stream *stream, u8 table_id, u16
 	/*MPEG-4 tables are input streams for the mux, the bitrate is updated when fetching AUs*/
 }
 
-static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, GF_BitStream *bs, u16 pid,
+/*writes the 4-byte TS packet header*/
+static GFINLINE void gf_m2ts_write_ts_header(u8 *data, u16 pid, Bool payload_start, u8 adaptation_field_control, u8 continuity_counter)
+{
+	data[0] = 0x47; // sync
+	/*no error indicator, no priority*/
+	data[1] = (payload_start ? 0x40 : 0) | ((pid>>8) & 0x1F);
+	data[2] = pid & 0xFF;
+	/*no scrambling*/
+	data[3] = ((adaptation_field_control & 0x3) << 4) | (continuity_counter & 0xF);
+}
+
+static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, u8 *data, u16 pid,
                                   Bool has_pcr, u64 pcr_time,
                                   Bool is_rap,
                                   u32 padding_length,
                                   char *af_descriptors, u32 af_descriptors_size, Bool set_discontinuity)
 {
-	u32 adaptation_length;
+	u32 adaptation_length, pos;
 
 	adaptation_length = ADAPTATION_FLAGS_LENGTH + (has_pcr?PCR_LENGTH:0) + padding_length;
 
@@ -448,22 +459,22 @@ static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, GF_BitStream *bs, u
 		adaptation_length += ADAPTATION_EXTENSION_LENGTH_LENGTH + ADAPTATION_EXTENSION_FLAGS_LENGTH + af_descriptors_size;
 	}
 
-	gf_bs_write_int(bs,	adaptation_length, 8);
-	gf_bs_write_int(bs,	set_discontinuity ? 1 : 0, 1);			// discontinuity indicator
-	gf_bs_write_int(bs,	is_rap, 1);		// random access indicator
-	gf_bs_write_int(bs,	0, 1);			// es priority indicator
-	gf_bs_write_int(bs,	has_pcr, 1);	// PCR_flag
-	gf_bs_write_int(bs,	0, 1);			// OPCR flag
-	gf_bs_write_int(bs,	0, 1);			// splicing point flag
-	gf_bs_write_int(bs,	0, 1);			// transport private data flag
-	gf_bs_write_int(bs,	af_descriptors_size ? 1 : 0, 1);			// adaptation field extension flag
+	data[0] = adaptation_length;
+	/*discontinuity, random access, ES priority, PCR, OPCR, splicing point, private data, extension flags*/
+	data[1] = (set_discontinuity ? 0x80 : 0) | (is_rap ? 0x40 : 0) | (has_pcr ? 0x10 : 0) | (af_descriptors_size ? 0x01 : 0);
+	pos = 2;
 	if (has_pcr) {
 		u64 PCR_base, PCR_ext;
 		PCR_base = pcr_time/300;
-		gf_bs_write_long_int(bs, PCR_base, 33);
-		gf_bs_write_int(bs,	0, 6); // reserved
 		PCR_ext = pcr_time - PCR_base*300;
-		gf_bs_write_long_int(bs, PCR_ext, 9);
+		/*33 bits base, 6 bits reserved (0), 9 bits extension*/
+		data[2] = (u8) (PCR_base >> 25);
+		data[3] = (u8) (PCR_base >> 17);
+		data[4] = (u8) (PCR_base >> 9);
+		data[5] = (u8) (PCR_base >> 1);
+		data[6] = (u8) (((PCR_base & 0x1) << 7) | ((PCR_ext >> 8) & 0x1));
+		data[7] = (u8) PCR_ext;
+		pos += PCR_LENGTH;
 		if (prog->last_pcr > pcr_time) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[MPEG-2 TS Muxer] PID %d: Sending PCR "LLD" earlier than previous PCR "LLD" - drift %f sec - discontinuity set\n", pid, pcr_time, prog->last_pcr, (prog->last_pcr - pcr_time) /27000000.0 ));
 		}
@@ -478,18 +489,15 @@ static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, GF_BitStream *bs, u
 	}
 
 	if (af_descriptors_size) {
-		gf_bs_write_int(bs,	ADAPTATION_EXTENSION_FLAGS_LENGTH + af_descriptors_size, 8);
-
-		gf_bs_write_int(bs,	0, 1);			// ltw_flag
-		gf_bs_write_int(bs,	0, 1);			// piecewise_rate_flag
-		gf_bs_write_int(bs,	0, 1);			// seamless_splice_flag
-		gf_bs_write_int(bs,	0, 1);			// af_descriptor_not_present_flag
-		gf_bs_write_int(bs,	0xF, 4);			// reserved
-
-		gf_bs_write_data(bs, af_descriptors, af_descriptors_size);
+		data[pos] = ADAPTATION_EXTENSION_FLAGS_LENGTH + af_descriptors_size;
+		/*ltw, piecewise_rate, seamless_splice, af_descriptor_not_present flags to 0, 4 bits reserved*/
+		data[pos+1] = 0x0F;
+		pos += 2;
+		memcpy(data+pos, af_descriptors, af_descriptors_size);
+		pos += af_descriptors_size;
 	}
 
-	gf_bs_write_byte(bs, 0xFF, padding_length); // stuffing byte
+	memset(data+pos, 0xFF, padding_length); // stuffing byte
 
 	return adaptation_length + ADAPTATION_LENGTH_LENGTH;
 }
@@ -498,10 +506,9 @@ static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, GF_BitStream *bs, u
 
 void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 {
-	GF_BitStream *bs;
 	GF_M2TS_Mux_Table *table;
 	GF_M2TS_Mux_Section *section;
-	u32 payload_length, payload_start;
+	u32 payload_length, payload_start, pos;
 	u8 adaptation_field_control = GF_M2TS_ADAPTATION_NONE;
 #ifndef USE_AF_STUFFING
 	u32 padded_bytes=0;
@@ -519,17 +526,6 @@ void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 	section = stream->current_section;
 	assert(section);
 
-	bs = gf_bs_new(packet, 188, GF_BITSTREAM_WRITE);
-
-	gf_bs_write_int(bs,	0x47, 8); // sync
-	gf_bs_write_int(bs,	0, 1);    // error indicator
-	if (stream->current_section_offset == 0) {
-		gf_bs_write_int(bs,	1, 1);    // payload start indicator
-	} else {
-		/* No section concatenation yet!!!*/
-		gf_bs_write_int(bs,	0, 1);    // payload start indicator
-	}
-
 	if (!stream->current_section_offset) payload_length = 183;
 	else payload_length = 184;
 
@@ -565,26 +561,23 @@ void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 		else stream->continuity_counter--;
 	}
 
-	gf_bs_write_int(bs,	0, 1);    /*priority indicator*/
-	gf_bs_write_int(bs,	stream->pid, 13); /*pid*/
-	gf_bs_write_int(bs,	0, 2);    /*scrambling indicator*/
-	gf_bs_write_int(bs,	adaptation_field_control, 2);    /*we do not use adaptation field for sections */
-	gf_bs_write_int(bs,	stream->continuity_counter, 4);   /*continuity counter*/
+	/*payload start only on first packet of the section, no section concatenation yet!!!*/
+	gf_m2ts_write_ts_header((u8 *) packet, stream->pid, stream->current_section_offset ? GF_FALSE : GF_TRUE, adaptation_field_control, stream->continuity_counter);
+	pos = 4;
 
 	if (stream->continuity_counter < 15) stream->continuity_counter++;
 	else stream->continuity_counter=0;
 
 #ifdef USE_AF_STUFFING
 	if (adaptation_field_control != GF_M2TS_ADAPTATION_NONE)
-		gf_m2ts_add_adaptation(stream->program, bs, stream->pid, 0, 0, 0, padding_length, NULL, 0, GF_FALSE);
+		pos += gf_m2ts_add_adaptation(stream->program, (u8 *) packet+pos, stream->pid, 0, 0, 0, padding_length, NULL, 0, GF_FALSE);
 #endif
 
 	/*pointer field*/
 	if (!stream->current_section_offset) {
 		/* no concatenations of sections in ts packets, so start address is 0 */
-		gf_bs_write_u8(bs, 0);
+		packet[pos] = 0;
 	}
-	gf_bs_del(bs);
 
 	memcpy(packet+188-payload_start, section->data + stream->current_section_offset, payload_length);
 	stream->current_section_offset += payload_length;
@@ -968,6 +961,152 @@ static void id3_tag_create(char **input, u32 *len)
 	gf_bs_del(bs);
 }
 
+/*wakes up the program thread - caller must hold the program prep mutex*/
+static void gf_m2ts_program_prep_wake(GF_M2TS_Mux_Program *program)
+{
+	if (program->prep_idle) {
+		program->prep_idle = GF_FALSE;
+		gf_sema_notify(program->prep_sema, 1);
+	} else {
+		program->prep_wake = GF_TRUE;
+	}
+}
+
+static u32 gf_m2ts_program_prep_run(void *par)
+{
+	GF_M2TS_Mux_Program *program = (GF_M2TS_Mux_Program *)par;
+	u32 nb_au_ahead = program->mux->prep_nb_au;
+
+	while (!program->prep_exit) {
+		GF_M2TS_Mux_Stream *stream = program->streams;
+		while (stream) {
+			while (stream->prep_by_thread && !stream->prep_eos) {
+				u32 nb_au_in = stream->prep_nb_au_in;
+				/*keep nb_au_ahead AUs ahead of what the muxer asked for*/
+				if (nb_au_in >= stream->prep_nb_au_fetched + nb_au_ahead) break;
+
+				stream->ifce->input_ctrl(stream->ifce, GF_ESI_INPUT_DATA_FLUSH, NULL);
+				if (stream->ifce->caps & GF_ESI_STREAM_IS_OVER) {
+					gf_mx_p(stream->mx);
+					stream->prep_nb_au_at_eos = stream->prep_nb_au_in;
+					gf_mx_v(stream->mx);
+					stream->prep_eos = GF_TRUE;
+					break;
+				}
+				/*no data from input for now, the muxer will not wait for us*/
+				if (stream->prep_nb_au_in == nb_au_in) {
+					stream->prep_starved = GF_TRUE;
+					break;
+				}
+				stream->prep_starved = GF_FALSE;
+			}
+			stream = stream->next;
+		}
+
+		gf_mx_p(program->prep_mx);
+		if (program->prep_mux_waiting) {
+			program->prep_mux_waiting = GF_FALSE;
+			gf_sema_notify(program->prep_ready_sema, 1);
+		}
+		if (program->prep_wake || program->prep_exit) {
+			program->prep_wake = GF_FALSE;
+			gf_mx_v(program->prep_mx);
+			continue;
+		}
+		program->prep_idle = GF_TRUE;
+		gf_mx_v(program->prep_mx);
+		gf_sema_wait(program->prep_sema);
+	}
+	return 0;
+}
+
+/*end of stream as seen by the muxer: with program threads the input is flushed ahead of time and is only
+reported over once the muxer would have fetched its last AU*/
+static GFINLINE Bool gf_m2ts_stream_is_over(GF_M2TS_Mux_Stream *stream)
+{
+	if (!stream->prep_by_thread)
+		return (stream->ifce->caps & GF_ESI_STREAM_IS_OVER) ? GF_TRUE : GF_FALSE;
+	return (stream->prep_eos && (stream->prep_nb_au_fetched >= stream->prep_nb_au_at_eos)) ? GF_TRUE : GF_FALSE;
+}
+
+/*checks if nb_aus (1 or 2) are available in the stream fifo, as seen by the muxer*/
+static GFINLINE Bool gf_m2ts_stream_has_aus(GF_M2TS_Mux_Stream *stream, u32 nb_aus)
+{
+	if (stream->prep_by_thread)
+		return (stream->prep_nb_au_fetched >= stream->prep_nb_au_out + nb_aus) ? GF_TRUE : GF_FALSE;
+
+	if (!stream->pck_first) return GF_FALSE;
+	if (nb_aus==1) return GF_TRUE;
+	return stream->pck_first->next ? GF_TRUE : GF_FALSE;
+}
+
+/*flushes the input pipe once. With program threads, waits for the AU the flush would have produced*/
+static void gf_m2ts_stream_flush_input(GF_M2TS_Mux_Stream *stream)
+{
+	GF_M2TS_Mux_Program *program = stream->program;
+	if (!stream->ifce->input_ctrl) return;
+
+	if (!stream->prep_by_thread) {
+		stream->ifce->input_ctrl(stream->ifce, GF_ESI_INPUT_DATA_FLUSH, NULL);
+		return;
+	}
+	if (gf_m2ts_stream_is_over(stream)) return;
+
+	stream->prep_nb_au_fetched++;
+	/*less than half the AUs ahead left, let the program thread fetch more*/
+	if (!stream->prep_eos && !stream->prep_starved
+	        && (stream->prep_nb_au_in >= stream->prep_nb_au_fetched)
+	        && (stream->prep_nb_au_in < stream->prep_nb_au_fetched + (program->mux->prep_nb_au+1)/2)) {
+		gf_mx_p(program->prep_mx);
+		gf_m2ts_program_prep_wake(program);
+		gf_mx_v(program->prep_mx);
+	}
+	while (stream->prep_nb_au_in < stream->prep_nb_au_fetched) {
+		if (stream->prep_eos) {
+			stream->prep_nb_au_fetched = stream->prep_nb_au_at_eos;
+			return;
+		}
+		gf_mx_p(program->prep_mx);
+		if (stream->prep_starved) {
+			/*have the thread try again, but don't wait for it*/
+			stream->prep_nb_au_fetched--;
+			gf_m2ts_program_prep_wake(program);
+			gf_mx_v(program->prep_mx);
+			return;
+		}
+		program->prep_mux_waiting = GF_TRUE;
+		gf_m2ts_program_prep_wake(program);
+		gf_mx_v(program->prep_mx);
+		gf_sema_wait(program->prep_ready_sema);
+	}
+}
+
+static void gf_m2ts_program_stop_prep(GF_M2TS_Mux_Program *program)
+{
+	GF_M2TS_Mux_Stream *stream;
+	if (!program->prep_th) return;
+
+	gf_mx_p(program->prep_mx);
+	program->prep_exit = GF_TRUE;
+	gf_m2ts_program_prep_wake(program);
+	gf_mx_v(program->prep_mx);
+	gf_th_stop(program->prep_th);
+	gf_th_del(program->prep_th);
+	gf_mx_del(program->prep_mx);
+	gf_sema_del(program->prep_sema);
+	gf_sema_del(program->prep_ready_sema);
+	program->prep_th = NULL;
+	program->prep_mx = NULL;
+	program->prep_sema = program->prep_ready_sema = NULL;
+	program->prep_idle = program->prep_wake = program->prep_mux_waiting = program->prep_exit = GF_FALSE;
+
+	stream = program->streams;
+	while (stream) {
+		stream->prep_by_thread = GF_FALSE;
+		stream = stream->next;
+	}
+}
+
 static Bool gf_m2ts_adjust_next_stream_time_for_pcr(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *stream)
 {
 	u32 pck_diff;
@@ -1048,11 +1187,11 @@ static u32 gf_m2ts_stream_process_pes(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *st
 	} else {
 		GF_M2TS_Packet *curr_pck;
 
-		if (!stream->pck_first && (stream->ifce->caps & GF_ESI_STREAM_IS_OVER))
+		if (!gf_m2ts_stream_has_aus(stream, 1) && gf_m2ts_stream_is_over(stream))
 			return ret;
 
 		/*flush input pipe*/
-		if (stream->ifce->input_ctrl) stream->ifce->input_ctrl(stream->ifce, GF_ESI_INPUT_DATA_FLUSH, NULL);
+		gf_m2ts_stream_flush_input(stream);
 
 		gf_mx_p(stream->mx);
 
@@ -1076,6 +1215,7 @@ static u32 gf_m2ts_stream_process_pes(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *st
 
 		/*discard first packet*/
 		stream->pck_first = curr_pck->next;
+		stream->prep_nb_au_out++;
 		gf_free(curr_pck);
 		stream->discard_data = GF_TRUE;
 
@@ -1362,15 +1502,15 @@ void gf_m2ts_stream_update_data_following(GF_M2TS_Mux_Stream *stream)
 		}
 	} else {
 		/*flush input*/
-		if (!stream->pck_first && stream->ifce->input_ctrl) stream->ifce->input_ctrl(stream->ifce, GF_ESI_INPUT_DATA_FLUSH, NULL);
-		if (stream->pck_first) {
+		if (!gf_m2ts_stream_has_aus(stream, 1)) gf_m2ts_stream_flush_input(stream);
+		if (gf_m2ts_stream_has_aus(stream, 1)) {
 			stream->next_payload_size = stream->pck_first->data_len;
 			stream->next_pck_cts = stream->pck_first->cts;
 			stream->next_pck_dts = stream->pck_first->dts;
 			stream->next_pck_flags = stream->pck_first->flags;
 
-			if (!stream->pck_first->next && stream->ifce->input_ctrl) stream->ifce->input_ctrl(stream->ifce, GF_ESI_INPUT_DATA_FLUSH, NULL);
-			if (stream->pck_first->next) {
+			if (!gf_m2ts_stream_has_aus(stream, 2)) gf_m2ts_stream_flush_input(stream);
+			if (gf_m2ts_stream_has_aus(stream, 2)) {
 				stream->next_next_payload_size = stream->pck_first->next->data_len;
 			}
 
@@ -1485,7 +1625,7 @@ Bool gf_m2ts_stream_compute_pes_length(GF_M2TS_Mux_Stream *stream, u32 payload_l
 			return GF_FALSE;
 		}
 
-		if (stream->ifce->caps & GF_ESI_STREAM_IS_OVER) {
+		if (gf_m2ts_stream_is_over(stream)) {
 #if 0
 			while (stream->copy_from_next_packets > stream->next_payload_size) {
 				if (stream->copy_from_next_packets < 184) {
@@ -1520,14 +1660,25 @@ static u32 gf_m2ts_stream_get_pes_header_length(GF_M2TS_Mux_Stream *stream)
 	return hdr_len;
 }
 
-u32 gf_m2ts_stream_add_pes_header(GF_BitStream *bs, GF_M2TS_Mux_Stream *stream)
+/*writes a 33 bit PTS or DTS with its 4 bit prefix and marker bits*/
+static GFINLINE void gf_m2ts_write_pes_timestamp(u8 *data, u8 prefix, u64 ts)
+{
+	data[0] = (u8) ((prefix << 4) | (((ts >> 30) & 0x7) << 1) | 1);
+	data[1] = (u8) (ts >> 22);
+	data[2] = (u8) ((((ts >> 15) & 0x7F) << 1) | 1);
+	data[3] = (u8) (ts >> 7);
+	data[4] = (u8) (((ts & 0x7F) << 1) | 1);
+}
+
+u32 gf_m2ts_stream_add_pes_header(u8 *data, GF_M2TS_Mux_Stream *stream)
 {
-	u64 t, dts, cts;
+	u64 dts, cts;
 	u32 pes_len;
 	Bool use_pts, use_dts;
 
-	gf_bs_write_int(bs,	0x1, 24);//packet start code
-	gf_bs_write_u8(bs,	stream->mpeg2_stream_id);// stream id
+	data[0] = data[1] = 0;
+	data[2] = 0x1; //packet start code
+	data[3] = stream->mpeg2_stream_id; // stream id
 
 	/*next AU start in current PES and current AU began in previous PES, use next AU timing*/
 	if (stream->pck_offset && stream->copy_from_next_packets) {
@@ -1554,45 +1705,21 @@ u32 gf_m2ts_stream_add_pes_header(GF_BitStream *bs, GF_M2TS_Mux_Stream *stream)
 	if (use_dts) pes_len += 5;
 
 	if (pes_len>0xFFFF) pes_len = 0;
-	gf_bs_write_int(bs, pes_len, 16); // pes packet length
-
-	gf_bs_write_int(bs, 0x2, 2); // reserved
-	gf_bs_write_int(bs, 0x0, 2); // scrambling
-	gf_bs_write_int(bs, 0x0, 1); // priority
-	gf_bs_write_int(bs, stream->pck_offset ? 0 : 1, 1); // alignment indicator - we could also check start codes to see if we are aligned at slice/video packet level
-	gf_bs_write_int(bs, 0x0, 1); // copyright
-	gf_bs_write_int(bs, 0x0, 1); // original or copy
+	data[4] = (pes_len >> 8) & 0xFF; // pes packet length
+	data[5] = pes_len & 0xFF;
 
-	gf_bs_write_int(bs, use_pts, 1);
-	gf_bs_write_int(bs, use_dts, 1);
-	gf_bs_write_int(bs, 0x0, 6); //6 flags = 0 (ESCR, ES_rate, DSM_trick, additional_copy, PES_CRC, PES_extension)
-
-	gf_bs_write_int(bs, use_dts*5+use_pts*5, 8);
+	/*'10', no scrambling, no priority, alignment indicator, no copyright, copy
+	for the alignment indicator, we could also check start codes to see if we are aligned at slice/video packet level*/
+	data[6] = 0x80 | (stream->pck_offset ? 0 : 0x04);
+	/*PTS/DTS flags, 6 flags = 0 (ESCR, ES_rate, DSM_trick, additional_copy, PES_CRC, PES_extension)*/
+	data[7] = (use_pts ? 0x80 : 0) | (use_dts ? 0x40 : 0);
+	data[8] = use_dts*5+use_pts*5;
 
 	if (use_pts) {
-		gf_bs_write_int(bs, use_dts ? 0x3 : 0x2, 4); // reserved '0011' || '0010'
-		t = ((cts >> 30) & 0x7);
-		gf_bs_write_long_int(bs, t, 3);
-		gf_bs_write_int(bs, 1, 1); // marker bit
-		t = ((cts >> 15) & 0x7fff);
-		gf_bs_write_long_int(bs, t, 15);
-		gf_bs_write_int(bs, 1, 1); // marker bit
-		t = cts & 0x7fff;
-		gf_bs_write_long_int(bs, t, 15);
-		gf_bs_write_int(bs, 1, 1); // marker bit
+		gf_m2ts_write_pes_timestamp(data+9, use_dts ? 0x3 : 0x2, cts); // reserved '0011' || '0010'
 	}
-
 	if (use_dts) {
-		gf_bs_write_int(bs, 0x1, 4); // reserved '0001'
-		t = ((dts >> 30) & 0x7);
-		gf_bs_write_long_int(bs, t, 3);
-		gf_bs_write_int(bs, 1, 1); // marker bit
-		t = ((dts >> 15) & 0x7fff);
-		gf_bs_write_long_int(bs, t, 15);
-		gf_bs_write_int(bs, 1, 1); // marker bit
-		t = dts & 0x7fff;
-		gf_bs_write_long_int(bs, t, 15);
-		gf_bs_write_int(bs, 1, 1); // marker bit
+		gf_m2ts_write_pes_timestamp(data + (use_pts ? 14 : 9), 0x1, dts); // reserved '0001'
 	}
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPEG-2 TS Muxer] PID %d: Adding PES header at PCR "LLD" - has PTS %d ("LLU") - has DTS %d ("LLU") - Payload length %d\n", stream->pid, gf_m2ts_get_pcr(stream)/300, use_pts, cts, use_dts, dts, pes_len));
 
@@ -1601,12 +1728,10 @@ u32 gf_m2ts_stream_add_pes_header(GF_BitStream *bs, GF_M2TS_Mux_Stream *stream)
 
 void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 {
-	GF_BitStream *bs;
 	Bool needs_pcr, first_pass;
 	u32 adaptation_field_control, payload_length, payload_to_copy, padding_length, hdr_len, pos, copy_next;
 
 	assert(stream->pid);
-	bs = gf_bs_new(packet, 188, GF_BITSTREAM_WRITE);
 
 	if (stream->pcr_only_mode) {
 		payload_length = 184 - 8;
@@ -1747,14 +1872,8 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 		else stream->continuity_counter--;
 	}
 
-	gf_bs_write_int(bs,	0x47, 8); // sync byte
-	gf_bs_write_int(bs,	0, 1);    // error indicator
-	gf_bs_write_int(bs,	hdr_len ? 1 : 0, 1); // start ind
-	gf_bs_write_int(bs,	0, 1);	  // transport priority
-	gf_bs_write_int(bs,	stream->pid, 13); // pid
-	gf_bs_write_int(bs,	0, 2);    // scrambling
-	gf_bs_write_int(bs,	adaptation_field_control, 2);    // we do not use adaptation field for sections
-	gf_bs_write_int(bs,	stream->continuity_counter, 4);   // continuity counter
+	gf_m2ts_write_ts_header((u8 *) packet, stream->pid, hdr_len ? GF_TRUE : GF_FALSE, adaptation_field_control, stream->continuity_counter);
+	pos = 4;
 
 	if (stream->continuity_counter < 15) stream->continuity_counter++;
 	else stream->continuity_counter=0;
@@ -1795,7 +1914,7 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 			stream->program->nb_pck_last_pcr = stream->program->mux->tot_pck_sent;
 		}
 		is_rap = (hdr_len && (stream->curr_pck.flags & GF_ESI_DATA_AU_RAP) ) ? GF_TRUE : GF_FALSE;
-		gf_m2ts_add_adaptation(stream->program, bs, stream->pid, needs_pcr, pcr, is_rap, padding_length, hdr_len ? stream->curr_pck.mpeg2_af_descriptors : NULL, hdr_len ? stream->curr_pck.mpeg2_af_descriptors_size : 0, stream->set_initial_disc);
+		pos += gf_m2ts_add_adaptation(stream->program, (u8 *) packet+pos, stream->pid, needs_pcr, pcr, is_rap, padding_length, hdr_len ? stream->curr_pck.mpeg2_af_descriptors : NULL, hdr_len ? stream->curr_pck.mpeg2_af_descriptors_size : 0, stream->set_initial_disc);
 		stream->set_initial_disc = GF_FALSE;
 
 		if (stream->curr_pck.mpeg2_af_descriptors) {
@@ -1807,10 +1926,11 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 		if (padding_length)
 			stream->program->mux->tot_pes_pad_bytes += padding_length;
 	}
-	if (hdr_len) gf_m2ts_stream_add_pes_header(bs, stream);
-
-	pos = (u32) gf_bs_get_position(bs);
-	gf_bs_del(bs);
+	if (hdr_len) {
+		gf_m2ts_stream_add_pes_header((u8 *) packet+pos, stream);
+		/*9 bytes fixed header + PES_header_data_length*/
+		pos += 9 + (u8) packet[pos+8];
+	}
 
 
 	if (adaptation_field_control == GF_M2TS_ADAPTATION_ONLY) {
@@ -1956,6 +2076,7 @@ GF_Err gf_m2ts_output_ctrl(GF_ESInterface *_self, u32 ctrl_type, void *param)
 					stream->pck_last->next = stream->pck_reassembler;
 					stream->pck_last = stream->pck_reassembler;
 				}
+				stream->prep_nb_au_in++;
 				gf_mx_v(stream->mx);
 				stream->pck_reassembler = NULL;
 			}
@@ -1992,6 +2113,7 @@ GF_Err gf_m2ts_output_ctrl(GF_ESInterface *_self, u32 ctrl_type, void *param)
 				stream->pck_last->next = stream->pck_reassembler;
 				stream->pck_last = stream->pck_reassembler;
 			}
+			stream->prep_nb_au_in++;
 			gf_mx_v(stream->mx);
 			stream->pck_reassembler = NULL;
 		}
@@ -2160,6 +2282,7 @@ GF_M2TS_Mux_Stream *gf_m2ts_program_stream_add(GF_M2TS_Mux_Program *program, str
 	} else {
 		program->streams = stream;
 	}
+	program->mux->sched_reset = GF_TRUE;
 	if (program->pmt) program->pmt->table_needs_update = GF_TRUE;
 	stream->bit_rate = ifce->bit_rate;
 	stream->scheduling_priority = 1;
@@ -2363,6 +2486,7 @@ GF_M2TS_Mux_Program *gf_m2ts_mux_program_add(GF_M2TS_Mux *muxer, u32 program_num
 	} else {
 		muxer->programs = program;
 	}
+	muxer->sched_reset = GF_TRUE;
 	program->pmt = gf_m2ts_stream_new(pmt_pid);
 	program->pmt->program = program;
 	program->pmt->table_needs_update = GF_TRUE;
@@ -2477,6 +2601,7 @@ void gf_m2ts_mux_stream_del(GF_M2TS_Mux_Stream *st)
 
 void gf_m2ts_mux_program_del(GF_M2TS_Mux_Program *prog)
 {
+	gf_m2ts_program_stop_prep(prog);
 	while (prog->streams) {
 		GF_M2TS_Mux_Stream *st = prog->streams->next;
 		gf_m2ts_mux_stream_del(prog->streams);
@@ -2507,6 +2632,7 @@ void gf_m2ts_mux_del(GF_M2TS_Mux *mux)
 	}
 	gf_m2ts_mux_stream_del(mux->pat);
 	if (mux->sdt) gf_m2ts_mux_stream_del(mux->sdt);
+	if (mux->sched_heap) gf_free(mux->sched_heap);
 	gf_free(mux);
 }
 
@@ -2553,6 +2679,7 @@ void gf_m2ts_mux_update_config(GF_M2TS_Mux *mux, Bool reset_time)
 
 	/*reset mux time*/
 	if (reset_time) {
+		mux->sched_reset = GF_TRUE;
 		mux->time.sec = mux->time.nanosec = 0;
 		mux->init_sys_time = 0;
 	}
@@ -2594,18 +2721,217 @@ GF_Err gf_m2ts_mux_enable_pcr_only_packets(GF_M2TS_Mux *muxer, Bool enable_force
 {
 	if (!muxer) return GF_BAD_PARAM;
 	muxer->enable_forced_pcr = enable_forced_pcr;
+	muxer->sched_reset = GF_TRUE;
 	return GF_OK;
 }
 
 
 GF_EXPORT
-const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_next)
+GF_Err gf_m2ts_mux_enable_linear_scheduling(GF_M2TS_Mux *muxer, Bool enable)
+{
+	if (!muxer) return GF_BAD_PARAM;
+	muxer->linear_scheduling = enable;
+	muxer->sched_reset = GF_TRUE;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_m2ts_mux_enable_program_threads(GF_M2TS_Mux *muxer, u32 nb_au_ahead)
+{
+	GF_M2TS_Mux_Program *program;
+	if (!muxer) return GF_BAD_PARAM;
+
+	program = muxer->programs;
+	while (program) {
+		gf_m2ts_program_stop_prep(program);
+		program = program->next;
+	}
+	muxer->prep_nb_au = nb_au_ahead;
+	if (!nb_au_ahead) return GF_OK;
+
+	program = muxer->programs;
+	while (program) {
+		u32 nb_streams = 0;
+		GF_M2TS_Mux_Stream *stream = program->streams;
+		while (stream) {
+			/*only push-mode inputs are fetched ahead*/
+			if (stream->ifce && stream->ifce->input_ctrl && !(stream->ifce->caps & GF_ESI_AU_PULL_CAP)) {
+				GF_M2TS_Packet *pck = stream->pck_first;
+				stream->prep_by_thread = GF_TRUE;
+				stream->prep_starved = stream->prep_eos = GF_FALSE;
+				stream->prep_nb_au_in = stream->prep_nb_au_out = 0;
+				/*AUs already in fifo*/
+				while (pck) {
+					stream->prep_nb_au_in++;
+					pck = pck->next;
+				}
+				stream->prep_nb_au_fetched = stream->prep_nb_au_in;
+				nb_streams++;
+			}
+			stream = stream->next;
+		}
+		if (nb_streams) {
+			program->prep_mx = gf_mx_new("M2TSProgramPrep");
+			program->prep_sema = gf_sema_new(1, 0);
+			program->prep_ready_sema = gf_sema_new(1, 0);
+			program->prep_th = gf_th_new("M2TSProgramPrep");
+			if (!program->prep_mx || !program->prep_sema || !program->prep_ready_sema || !program->prep_th
+			        || (gf_th_run(program->prep_th, gf_m2ts_program_prep_run, program) != GF_OK)) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[MPEG-2 TS Muxer] Failed to start preparation thread for program %d\n", program->number));
+				if (program->prep_th) gf_th_del(program->prep_th);
+				if (program->prep_mx) gf_mx_del(program->prep_mx);
+				if (program->prep_sema) gf_sema_del(program->prep_sema);
+				if (program->prep_ready_sema) gf_sema_del(program->prep_ready_sema);
+				program->prep_th = NULL;
+				program->prep_mx = NULL;
+				program->prep_sema = program->prep_ready_sema = NULL;
+				stream = program->streams;
+				while (stream) {
+					stream->prep_by_thread = GF_FALSE;
+					stream = stream->next;
+				}
+			}
+		}
+		program = program->next;
+	}
+	return GF_OK;
+}
+
+/*scheduling order of two candidate streams, matching the linear scan: earliest time first, then highest priority,
+then base streams (last one in stream order) before dependent streams (first one in stream order)*/
+static GFINLINE Bool gf_m2ts_sched_before(GF_M2TS_Mux_Stream *a, u32 prio_a, GF_M2TS_Mux_Stream *b, u32 prio_b)
+{
+	Bool dep_a, dep_b;
+	if (!gf_m2ts_time_equal(&a->time, &b->time)) return gf_m2ts_time_less(&a->time, &b->time);
+	if (prio_a != prio_b) return (prio_a > prio_b) ? GF_TRUE : GF_FALSE;
+	dep_a = a->ifce->depends_on_stream ? GF_TRUE : GF_FALSE;
+	dep_b = b->ifce->depends_on_stream ? GF_TRUE : GF_FALSE;
+	if (dep_a != dep_b) return dep_b;
+	if (!dep_a) return (a->sched_order > b->sched_order) ? GF_TRUE : GF_FALSE;
+	return (a->sched_order < b->sched_order) ? GF_TRUE : GF_FALSE;
+}
+
+/*a stream in the middle of a PES has no side effect in its process function and always returns its priority:
+its position only changes when one of its packets is sent*/
+static GFINLINE Bool gf_m2ts_sched_is_stable(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *stream)
+{
+	if (stream->mpeg2_stream_type==GF_M2TS_SYSTEMS_MPEG4_SECTIONS) return GF_FALSE;
+	if (stream->refresh_rate_ms) return GF_FALSE;
+	if (!stream->curr_pck.data_len || (stream->pck_offset >= stream->curr_pck.data_len)) return GF_FALSE;
+	if (muxer->enable_forced_pcr && (stream == stream->program->pcr)) return GF_FALSE;
+	return GF_TRUE;
+}
+
+#define SCHED_BEFORE(_a, _b)	gf_m2ts_sched_before(_a, (_a)->scheduling_priority, _b, (_b)->scheduling_priority)
+
+static void gf_m2ts_sched_heap_set(GF_M2TS_Mux *muxer, u32 idx, GF_M2TS_Mux_Stream *stream)
+{
+	muxer->sched_heap[idx] = stream;
+	stream->sched_pos = idx+1;
+}
+
+static void gf_m2ts_sched_sift_up(GF_M2TS_Mux *muxer, u32 idx)
+{
+	GF_M2TS_Mux_Stream *stream = muxer->sched_heap[idx];
+	while (idx) {
+		u32 parent = (idx-1) / 2;
+		if (!SCHED_BEFORE(stream, muxer->sched_heap[parent])) break;
+		gf_m2ts_sched_heap_set(muxer, idx, muxer->sched_heap[parent]);
+		idx = parent;
+	}
+	gf_m2ts_sched_heap_set(muxer, idx, stream);
+}
+
+static void gf_m2ts_sched_sift_down(GF_M2TS_Mux *muxer, u32 idx)
+{
+	GF_M2TS_Mux_Stream *stream = muxer->sched_heap[idx];
+	while (1) {
+		u32 child = 2*idx + 1;
+		if (child >= muxer->sched_nb) break;
+		if ((child+1 < muxer->sched_nb) && SCHED_BEFORE(muxer->sched_heap[child+1], muxer->sched_heap[child]))
+			child++;
+		if (!SCHED_BEFORE(muxer->sched_heap[child], stream)) break;
+		gf_m2ts_sched_heap_set(muxer, idx, muxer->sched_heap[child]);
+		idx = child;
+	}
+	gf_m2ts_sched_heap_set(muxer, idx, stream);
+}
+
+static void gf_m2ts_sched_heap_push(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *stream)
+{
+	if (muxer->sched_nb == muxer->sched_alloc) {
+		muxer->sched_alloc = muxer->sched_alloc ? 2*muxer->sched_alloc : 16;
+		muxer->sched_heap = (GF_M2TS_Mux_Stream **)gf_realloc(muxer->sched_heap, sizeof(GF_M2TS_Mux_Stream *) * muxer->sched_alloc);
+	}
+	muxer->sched_heap[muxer->sched_nb] = stream;
+	muxer->sched_nb++;
+	gf_m2ts_sched_sift_up(muxer, muxer->sched_nb-1);
+}
+
+static void gf_m2ts_sched_heap_remove(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *stream)
+{
+	u32 idx = stream->sched_pos - 1;
+	stream->sched_pos = 0;
+	muxer->sched_nb--;
+	if (idx == muxer->sched_nb) return;
+	muxer->sched_heap[idx] = muxer->sched_heap[muxer->sched_nb];
+	gf_m2ts_sched_sift_up(muxer, idx);
+	gf_m2ts_sched_sift_down(muxer, muxer->sched_heap[idx]->sched_pos - 1);
+}
+
+/*puts back a stream in the polled list, keeping stream order*/
+static void gf_m2ts_sched_poll(GF_M2TS_Mux *muxer, GF_M2TS_Mux_Stream *stream)
+{
+	GF_M2TS_Mux_Stream *prev = muxer->sched_polled;
+	if (!prev || (prev->sched_order > stream->sched_order)) {
+		stream->sched_next = prev;
+		muxer->sched_polled = stream;
+		return;
+	}
+	while (prev->sched_next && (prev->sched_next->sched_order < stream->sched_order))
+		prev = prev->sched_next;
+	stream->sched_next = prev->sched_next;
+	prev->sched_next = stream;
+}
+
+/*polls all streams again, in program and stream declaration order*/
+static void gf_m2ts_sched_rebuild(GF_M2TS_Mux *muxer)
+{
+	GF_M2TS_Mux_Program *program;
+	GF_M2TS_Mux_Stream *last = NULL;
+	u32 i;
+
+	for (i=0; i<muxer->sched_nb; i++) muxer->sched_heap[i]->sched_pos = 0;
+	muxer->sched_nb = 0;
+	muxer->sched_polled = NULL;
+	muxer->sched_nb_streams = 0;
+
+	program = muxer->programs;
+	while (program) {
+		GF_M2TS_Mux_Stream *stream = program->streams;
+		while (stream) {
+			stream->sched_order = muxer->sched_nb_streams;
+			stream->sched_next = NULL;
+			if (last) last->sched_next = stream;
+			else muxer->sched_polled = stream;
+			last = stream;
+			muxer->sched_nb_streams++;
+			stream = stream->next;
+		}
+		program = program->next;
+	}
+	muxer->sched_reset = GF_FALSE;
+}
+
+
+/*produces the next TS packet in dst_pck - padding packets are not copied and the muxer null packet is returned instead
+now_us is the system clock, sampled once per burst when not muxing in real time*/
+static const char *gf_m2ts_mux_process_packet(GF_M2TS_Mux *muxer, char *dst_pck, u64 now_us, u32 *status, u32 *usec_till_next)
 {
 	GF_M2TS_Mux_Program *program;
 	GF_M2TS_Mux_Stream *stream, *stream_to_process;
 	GF_M2TS_Time time, max_time;
 	u32 nb_streams, nb_streams_done;
-	u64 now_us;
 	char *ret;
 	u32 res, highest_priority;
 	Bool flush_all_pes = GF_FALSE;
@@ -2614,7 +2940,6 @@ const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_
 	nb_streams = nb_streams_done = 0;
 	*status = GF_M2TS_STATE_IDLE;
 
-	now_us = gf_sys_clock_high_res();
 	if (muxer->real_time) {
 		if (!muxer->init_sys_time) {
 			//init TS time
@@ -2743,6 +3068,50 @@ const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_
 	}
 #endif
 
+	/*streams in the middle of a PES are scheduled from the heap, other ones are polled. Linear scan is used when
+looking for max time or flushing PES, as in these cases all streams are checked*/
+	if (!muxer->linear_scheduling && !flush_all_pes && !check_max_time) {
+		GF_M2TS_Mux_Stream *prev = NULL;
+		u32 cand_priority = 0;
+
+		if (muxer->sched_reset) gf_m2ts_sched_rebuild(muxer);
+		nb_streams = muxer->sched_nb_streams;
+
+		stream = muxer->sched_polled;
+		while (stream) {
+			GF_M2TS_Mux_Stream *next = stream->sched_next;
+			res = stream->process(muxer, stream);
+			if (muxer->force_pat)
+				return gf_m2ts_mux_process_packet(muxer, dst_pck, now_us, status, usec_till_next);
+
+			if (res && gf_m2ts_sched_is_stable(muxer, stream)) {
+				if (prev) prev->sched_next = next;
+				else muxer->sched_polled = next;
+				stream->sched_next = NULL;
+				gf_m2ts_sched_heap_push(muxer, stream);
+				stream = next;
+				continue;
+			}
+			if (res && (!stream_to_process || gf_m2ts_sched_before(stream, res, stream_to_process, cand_priority))) {
+				stream_to_process = stream;
+				cand_priority = res;
+			}
+			if (gf_m2ts_stream_is_over(stream) && (!res || stream->refresh_rate_ms) )
+				nb_streams_done ++;
+			prev = stream;
+			stream = next;
+		}
+		if (muxer->sched_nb && (!stream_to_process || gf_m2ts_sched_before(muxer->sched_heap[0], muxer->sched_heap[0]->scheduling_priority, stream_to_process, cand_priority)))
+			stream_to_process = muxer->sched_heap[0];
+
+		if (stream_to_process && gf_m2ts_time_less_or_equal(&stream_to_process->time, &time)) {
+			time = stream_to_process->time;
+		} else {
+			stream_to_process = NULL;
+		}
+		goto send_pck;
+	}
+
 	/*all streams for each program*/
 	highest_priority = 0;
 	program = muxer->programs;
@@ -2762,7 +3131,7 @@ const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_
 				res = stream->process(muxer, stream);
 				/*next is rap on this stream, check flushing of other pes (we could use a goto)*/
 				if (!flush_all_pes && muxer->force_pat)
-					return gf_m2ts_mux_process(muxer, status, usec_till_next);
+					return gf_m2ts_mux_process_packet(muxer, dst_pck, now_us, status, usec_till_next);
 
 				if (res) {
 					/*always schedule the earliest data*/
@@ -2790,7 +3159,7 @@ const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_
 				}
 			}
 			nb_streams++;
-			if ((stream->ifce->caps & GF_ESI_STREAM_IS_OVER) && (!res || stream->refresh_rate_ms) )
+			if (gf_m2ts_stream_is_over(stream) && (!res || stream->refresh_rate_ms) )
 				nb_streams_done ++;
 
 			stream = stream->next;
@@ -2816,12 +3185,23 @@ send_pck:
 	} else {
 
 		if (stream_to_process->tables) {
-			gf_m2ts_mux_table_get_next_packet(stream_to_process, muxer->dst_pck);
+			gf_m2ts_mux_table_get_next_packet(stream_to_process, dst_pck);
 		} else {
-			gf_m2ts_mux_pes_get_next_packet(stream_to_process, muxer->dst_pck);
+			gf_m2ts_mux_pes_get_next_packet(stream_to_process, dst_pck);
 		}
 
-		ret = muxer->dst_pck;
+		/*update stream position in the scheduler*/
+		if (stream_to_process->sched_pos) {
+			if (gf_m2ts_sched_is_stable(muxer, stream_to_process)) {
+				gf_m2ts_sched_sift_up(muxer, stream_to_process->sched_pos - 1);
+				gf_m2ts_sched_sift_down(muxer, stream_to_process->sched_pos - 1);
+			} else {
+				gf_m2ts_sched_heap_remove(muxer, stream_to_process);
+				gf_m2ts_sched_poll(muxer, stream_to_process);
+			}
+		}
+
+		ret = dst_pck;
 		*status = GF_M2TS_STATE_DATA;
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPEG2-TS Muxer] Sending %s from PID %d at %d:%09d - mux time %d:%09d\n", stream_to_process->tables ? "table" : "PES", stream_to_process->pid, time.sec, time.nanosec, muxer->time.sec, muxer->time.nanosec));
@@ -2861,4 +3241,35 @@ send_pck:
 	return ret;
 }
 
+GF_EXPORT
+const char *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, u32 *status, u32 *usec_till_next)
+{
+	return gf_m2ts_mux_process_packet(muxer, muxer->dst_pck, gf_sys_clock_high_res(), status, usec_till_next);
+}
+
+GF_EXPORT
+GF_Err gf_m2ts_mux_process_burst(GF_M2TS_Mux *muxer, u8 *buffer, u32 nb_max_pck, u32 *nb_pck, u32 *status, u32 *usec_till_next)
+{
+	u32 nb_done = 0;
+	u64 now_us;
+	if (!muxer || !buffer || !nb_max_pck || !nb_pck || !status) return GF_BAD_PARAM;
+
+	*status = GF_M2TS_STATE_IDLE;
+	/*the clock only drives the bitrate window when not in real time, one sample per burst is enough*/
+	now_us = gf_sys_clock_high_res();
+	while (nb_done < nb_max_pck) {
+		char *dst = (char *) buffer + 188*nb_done;
+		const char *pck;
+		if (muxer->real_time && nb_done) now_us = gf_sys_clock_high_res();
+		pck = gf_m2ts_mux_process_packet(muxer, dst, now_us, status, usec_till_next);
+		if (!pck) break;
+		/*null packets are shared by the muxer*/
+		if (pck != dst) memcpy(dst, pck, 188);
+		nb_done++;
+		if (*status == GF_M2TS_STATE_EOS) break;
+	}
+	*nb_pck = nb_done;
+	return GF_OK;
+}
+
 #endif /*GPAC_DISABLE_MPEG2TS_MUX*/
@@ -9304,13 +9304,15 @@ void on_m2ts_import_data(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
 			if (!found || !ts->ess[import->trackID]) return;
 
 			/*make sure all the streams in this programe are in RAW pes framing mode, so that we get notified of the
-			DTS/PTS*/
+			DTS/PTS - packets of other programs are discarded*/
 			for (i=0; i<count; i++) {
 				es = (GF_M2TS_ES *)gf_list_get(prog->streams, i);
 				if (!(es->flags & GF_M2TS_ES_IS_SECTION)) {
 					gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_RAW);
 				}
+				gf_m2ts_set_pid_interest(ts, es->pid, GF_TRUE);
 			}
+			gf_m2ts_set_pid_interest(ts, prog->pcr_pid, GF_TRUE);
 
 			es = ts->ess[import->trackID]; /* import->track_id == pid */
 
@@ -466,11 +466,6 @@ static GF_MPD_SegmentTemplate *gf_mpd_parse_segment_template(GF_MPD *mpd, GF_XML
 	return seg;
 }
 
-static GF_Err gf_mpd_parse_content_component(GF_List *container, GF_XMLNode *root)
-{
-	return GF_OK;
-}
-
 #define MPD_STORE_EXTENSION_ATTR(_elem)	\
 			if (!_elem->attributes) _elem->attributes = gf_list_new();	\
 			i--;	\
@@ -514,6 +509,42 @@ static GF_Err gf_mpd_parse_descriptor(GF_List *container, GF_XMLNode *root)
 	return GF_OK;
 }
 
+static GF_Err gf_mpd_parse_content_component(GF_MPD *mpd, GF_List *container, GF_XMLNode *root)
+{
+	GF_Err e;
+	GF_XMLAttribute *att;
+	GF_XMLNode *child;
+	GF_MPD_ContentComponent *comp;
+	u32 i = 0;
+
+	GF_SAFEALLOC(comp, GF_MPD_ContentComponent);
+	if (!comp) return GF_OUT_OF_MEM;
+	comp->accessibility = gf_list_new();
+	comp->role = gf_list_new();
+	comp->rating = gf_list_new();
+	comp->viewpoint = gf_list_new();
+	e = gf_list_add(container, comp);
+	if (e) return e;
+
+	while ( (att = gf_list_enum(root->attributes, &i)) ) {
+		if (!strcmp(att->name, "id")) comp->id = gf_mpd_parse_int(att->value);
+		else if (!strcmp(att->name, "lang")) comp->lang = gf_mpd_parse_string(att->value);
+		else if (!strcmp(att->name, "contentType")) comp->content_type = gf_mpd_parse_string(att->value);
+		else if (!strcmp(att->name, "par")) comp->par = gf_mpd_parse_frac(att->value, ':');
+	}
+
+	i = 0;
+	while ( (child = gf_list_enum(root->content, &i))) {
+		if (!gf_mpd_valid_child(mpd, child)) continue;
+		if (!strcmp(child->name, "Accessibility")) e = gf_mpd_parse_descriptor(comp->accessibility, child);
+		else if (!strcmp(child->name, "Role")) e = gf_mpd_parse_descriptor(comp->role, child);
+		else if (!strcmp(child->name, "Rating")) e = gf_mpd_parse_descriptor(comp->rating, child);
+		else if (!strcmp(child->name, "Viewpoint")) e = gf_mpd_parse_descriptor(comp->viewpoint, child);
+		if (e) return e;
+	}
+	return GF_OK;
+}
+
 static void gf_mpd_parse_common_representation(GF_MPD *mpd, GF_MPD_CommonAttributes *com, GF_XMLNode *root)
 {
 	GF_XMLAttribute *att;
@@ -702,7 +733,7 @@ static GF_Err gf_mpd_parse_adaptation_set(GF_MPD *mpd, GF_List *container, GF_XM
 			if (e) return e;
 		}
 		else if (!strcmp(child->name, "ContentComponent")) {
-			e = gf_mpd_parse_content_component(set->content_component, child);
+			e = gf_mpd_parse_content_component(mpd, set->content_component, child);
 			if (e) return e;
 		}
 		else if (!strcmp(child->name, "SegmentBase")) {
@@ -914,8 +945,15 @@ void gf_mpd_descriptor_free(void *item)
 
 void gf_mpd_content_component_free(void *item)
 {
-	GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[MPD] content component not implemented\n"));
-	gf_free(item);
+	GF_MPD_ContentComponent *comp = (GF_MPD_ContentComponent *)item;
+	if (comp->lang) gf_free(comp->lang);
+	if (comp->content_type) gf_free(comp->content_type);
+	if (comp->par) gf_free(comp->par);
+	gf_mpd_del_list(comp->accessibility, gf_mpd_descriptor_free, 0);
+	gf_mpd_del_list(comp->role, gf_mpd_descriptor_free, 0);
+	gf_mpd_del_list(comp->rating, gf_mpd_descriptor_free, 0);
+	gf_mpd_del_list(comp->viewpoint, gf_mpd_descriptor_free, 0);
+	gf_free(comp);
 }
 
 void gf_mpd_common_attributes_free(GF_MPD_CommonAttributes *ptr)
@@ -1016,40 +1054,31 @@ void gf_mpd_del(GF_MPD *mpd)
 }
 
 
-GF_EXPORT
-GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *default_base_url)
+static Bool gf_mpd_check_namespace(GF_MPD *mpd, GF_XMLNode *root)
 {
-	GF_Err e;
-	u32 i;
-	Bool ns_ok = GF_FALSE;
+	u32 i=0;
 	GF_XMLAttribute *att;
-	GF_XMLNode *child;
-
-	if (!root || !mpd) return GF_BAD_PARAM;
-	i=0;
 	while ((att = gf_list_enum(root->attributes, &i))) {
 		if (!strcmp(att->name, "xmlns")) {
 			if (!root->ns && (!strcmp(att->value, "urn:mpeg:dash:schema:mpd:2011") || !strcmp(att->value, "urn:mpeg:DASH:schema:MPD:2011")) ) {
-				ns_ok = 1;
-				break;
+				return GF_TRUE;
 			}
 		}
 		else if (!strncmp(att->name, "xmlns:", 6)) {
 			if (root->ns && !strcmp(att->name+6, root->ns) && (!strcmp(att->value, "urn:mpeg:dash:schema:mpd:2011") || !strcmp(att->value, "urn:mpeg:DASH:schema:MPD:2011")) ) {
-				ns_ok = 1;
 				if (!mpd->xml_namespace) mpd->xml_namespace = root->ns;
-				break;
+				return GF_TRUE;
 			}
 		}
 	}
+	GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[MPD] Wrong namespace found for DASH MPD - cannot parse\n"));
+	return GF_FALSE;
+}
 
-	if (!ns_ok) {
-		GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[MPD] Wrong namespace found for DASH MPD - cannot parse\n"));
-	}
-
-	if (!strcmp(root->name, "Period")) {
-		return gf_mpd_parse_period(mpd, root);
-	}
+static void gf_mpd_parse_mpd_attributes(GF_MPD *mpd, GF_XMLNode *root)
+{
+	u32 i;
+	GF_XMLAttribute *att;
 
 	i = 0;
 	while ((att = gf_list_enum(root->attributes, &i))) {
@@ -1086,6 +1115,23 @@ GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *defau
 	}
 	if (mpd->type == GF_MPD_TYPE_STATIC)
 		mpd->minimum_update_period = mpd->time_shift_buffer_depth = 0;
+}
+
+GF_EXPORT
+GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *default_base_url)
+{
+	GF_Err e;
+	u32 i;
+	GF_XMLNode *child;
+
+	if (!root || !mpd) return GF_BAD_PARAM;
+	gf_mpd_check_namespace(mpd, root);
+
+	if (!strcmp(root->name, "Period")) {
+		return gf_mpd_parse_period(mpd, root);
+	}
+
+	gf_mpd_parse_mpd_attributes(mpd, root);
 
 	i = 0;
 	while ( ( child = gf_list_enum(root->content, &i )) ) {
@@ -1116,11 +1162,8 @@ GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *defau
 }
 
 
-GF_EXPORT
-GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *default_base_url)
+static void gf_mpd_init_defaults(GF_MPD *mpd)
 {
-	if (!root || !mpd) return GF_BAD_PARAM;
-
 	assert(!mpd->periods);
 	mpd->periods = gf_list_new();
 	mpd->program_infos = gf_list_new();
@@ -1132,10 +1175,609 @@ GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *default_b
 	mpd->type = GF_MPD_TYPE_STATIC;
 	mpd->time_shift_buffer_depth = (u32) -1; /*infinite by default*/
 	mpd->xml_namespace = NULL;
+}
+
+GF_EXPORT
+GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *default_base_url)
+{
+	if (!root || !mpd) return GF_BAD_PARAM;
 
+	gf_mpd_init_defaults(mpd);
 	return gf_mpd_complete_from_dom(root, mpd, default_base_url);
 }
 
+/*SAX MPD loader: MPD objects are created when their element starts, using the DOM element parsers on a single
+childless node holding the element attributes, and children elements are attached to the object on top of the stack.
+SegmentTimeline entries, which are the bulk of large live manifests, are created directly from the SAX attributes*/
+enum
+{
+	MPD_SAX_SKIP = 0,
+	MPD_SAX_ROOT,
+	MPD_SAX_PROGRAM_INFO,
+	MPD_SAX_TEXT,
+	MPD_SAX_LOCATION,
+	MPD_SAX_PERIOD,
+	MPD_SAX_ADAPTATION_SET,
+	MPD_SAX_REPRESENTATION,
+	MPD_SAX_SEGMENT_BASE,
+	MPD_SAX_SEGMENT_LIST,
+	MPD_SAX_SEGMENT_TEMPLATE,
+	MPD_SAX_SEGMENT_TIMELINE,
+	MPD_SAX_DESCRIPTOR,
+	MPD_SAX_EXTENSION,
+	MPD_SAX_CONTENT_COMPONENT,
+};
+
+#define MPD_SAX_MAX_DEPTH	64
+
+typedef struct
+{
+	u32 type;
+	void *obj;
+	/*for text elements, destination of the text content*/
+	char **text;
+	/*text content of Location elements*/
+	char *str;
+} GF_MPD_SAXElement;
+
+typedef struct
+{
+	GF_MPD *mpd;
+	GF_SAXParser *sax;
+	GF_Err error;
+	/*childless node passed to the element parsers*/
+	GF_XMLNode node;
+	char *root_ns;
+	Bool root_done;
+
+	GF_MPD_SAXElement stack[MPD_SAX_MAX_DEPTH];
+	u32 depth, nb_ignored;
+	u32 nb_timeline_entries;
+} GF_MPD_SAXLoader;
+
+static GF_XMLNode *gf_mpd_sax_node(GF_MPD_SAXLoader *ctx, const char *name, const char *ns, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	for (i=0; i<nb_attributes; i++) {
+		GF_XMLAttribute *att;
+		GF_SAFEALLOC(att, GF_XMLAttribute);
+		if (!att) break;
+		att->name = gf_strdup(attributes[i].name);
+		att->value = gf_strdup(attributes[i].value);
+		gf_list_add(ctx->node.attributes, att);
+	}
+	ctx->node.name = (char *) name;
+	ctx->node.ns = (char *) ns;
+	return &ctx->node;
+}
+
+/*frees attributes not moved to the object by the parsers*/
+static void gf_mpd_sax_node_reset(GF_MPD_SAXLoader *ctx)
+{
+	while (gf_list_count(ctx->node.attributes)) {
+		GF_XMLAttribute *att = gf_list_pop_back(ctx->node.attributes);
+		gf_free(att->name);
+		gf_free(att->value);
+		gf_free(att);
+	}
+	ctx->node.name = ctx->node.ns = NULL;
+}
+
+static Bool gf_mpd_sax_valid_ns(GF_MPD *mpd, const char *ns)
+{
+	if (!mpd->xml_namespace && !ns) return GF_TRUE;
+	if (mpd->xml_namespace && ns && !strcmp(mpd->xml_namespace, ns)) return GF_TRUE;
+	return GF_FALSE;
+}
+
+static void gf_mpd_sax_push(GF_MPD_SAXLoader *ctx, u32 type, void *obj, char **text)
+{
+	GF_MPD_SAXElement *elt = &ctx->stack[ctx->depth];
+	/*object allocation failed*/
+	if ((type != MPD_SAX_SKIP) && (type != MPD_SAX_TEXT) && (type != MPD_SAX_LOCATION) && !obj) {
+		if (!ctx->error) ctx->error = GF_OUT_OF_MEM;
+		type = MPD_SAX_SKIP;
+	}
+	elt->type = type;
+	elt->obj = obj;
+	elt->text = (type == MPD_SAX_LOCATION) ? &elt->str : text;
+	elt->str = NULL;
+	ctx->depth++;
+}
+
+static void gf_mpd_sax_error(GF_MPD_SAXLoader *ctx, GF_Err e)
+{
+	if (!e) return;
+	if (!ctx->error) ctx->error = e;
+	gf_xml_sax_suspend(ctx->sax, GF_TRUE);
+}
+
+static GF_XMLNode *gf_mpd_sax_extension_node(GF_List **container, const char *name, const char *ns, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	GF_XMLNode *node;
+	GF_SAFEALLOC(node, GF_XMLNode);
+	if (!node) return NULL;
+	node->type = GF_XML_NODE_TYPE;
+	node->name = gf_strdup(name);
+	if (ns) node->ns = gf_strdup(ns);
+	node->attributes = gf_list_new();
+	node->content = gf_list_new();
+	for (i=0; i<nb_attributes; i++) {
+		GF_XMLAttribute *att;
+		GF_SAFEALLOC(att, GF_XMLAttribute);
+		if (!att) break;
+		att->name = gf_strdup(attributes[i].name);
+		att->value = gf_strdup(attributes[i].value);
+		gf_list_add(node->attributes, att);
+	}
+	if (! *container) *container = gf_list_new();
+	gf_list_add(*container, node);
+	return node;
+}
+
+static void gf_mpd_sax_timeline_entry(GF_MPD_SAXLoader *ctx, GF_MPD_SegmentTimeline *timeline, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	GF_MPD_SegmentTimelineEntry *seg_tl_ent;
+	GF_SAFEALLOC(seg_tl_ent, GF_MPD_SegmentTimelineEntry);
+	if (!seg_tl_ent) {
+		gf_mpd_sax_error(ctx, GF_OUT_OF_MEM);
+		return;
+	}
+	gf_list_add(timeline->entries, seg_tl_ent);
+	ctx->nb_timeline_entries++;
+
+	for (i=0; i<nb_attributes; i++) {
+		const GF_XMLAttribute *att = &attributes[i];
+		if (att->name[1]) continue;
+		if (att->name[0] == 't')
+			seg_tl_ent->start_time = gf_mpd_parse_long_int(att->value);
+		else if (att->name[0] == 'd')
+			seg_tl_ent->duration = gf_mpd_parse_int(att->value);
+		else if (att->name[0] == 'r') {
+			seg_tl_ent->repeat_count = gf_mpd_parse_int(att->value);
+			if (seg_tl_ent->repeat_count == (u32)-1)
+				seg_tl_ent->repeat_count--;
+		}
+	}
+}
+
+/*SegmentBase, SegmentList and SegmentTemplate children of Period, AdaptationSet and Representation*/
+static Bool gf_mpd_sax_segment_info(GF_MPD_SAXLoader *ctx, GF_XMLNode *node, GF_MPD_SegmentBase **segment_base, GF_MPD_SegmentList **segment_list, GF_MPD_SegmentTemplate **segment_template)
+{
+	if (!strcmp(node->name, "SegmentBase")) {
+		*segment_base = gf_mpd_parse_segment_base(ctx->mpd, node);
+		gf_mpd_sax_push(ctx, MPD_SAX_SEGMENT_BASE, *segment_base, NULL);
+	} else if (!strcmp(node->name, "SegmentList")) {
+		*segment_list = gf_mpd_parse_segment_list(ctx->mpd, node);
+		gf_mpd_sax_push(ctx, MPD_SAX_SEGMENT_LIST, *segment_list, NULL);
+	} else if (!strcmp(node->name, "SegmentTemplate")) {
+		*segment_template = gf_mpd_parse_segment_template(ctx->mpd, node);
+		gf_mpd_sax_push(ctx, MPD_SAX_SEGMENT_TEMPLATE, *segment_template, NULL);
+	} else {
+		return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+static Bool gf_mpd_sax_base_url(GF_MPD_SAXLoader *ctx, GF_XMLNode *node, GF_List *container)
+{
+	GF_Err e;
+	GF_MPD_BaseURL *url;
+	if (strcmp(node->name, "BaseURL")) return GF_FALSE;
+
+	e = gf_mpd_parse_base_url(container, node);
+	if (e) {
+		gf_mpd_sax_error(ctx, e);
+		gf_mpd_sax_push(ctx, MPD_SAX_SKIP, NULL, NULL);
+		return GF_TRUE;
+	}
+	url = gf_list_last(container);
+	gf_mpd_sax_push(ctx, MPD_SAX_TEXT, url, &url->URL);
+	return GF_TRUE;
+}
+
+static Bool gf_mpd_sax_descriptor(GF_MPD_SAXLoader *ctx, GF_XMLNode *node, GF_List *container)
+{
+	GF_Err e;
+	if (!container) return GF_FALSE;
+	e = gf_mpd_parse_descriptor(container, node);
+	if (e) {
+		gf_mpd_sax_error(ctx, e);
+		gf_mpd_sax_push(ctx, MPD_SAX_SKIP, NULL, NULL);
+		return GF_TRUE;
+	}
+	gf_mpd_sax_push(ctx, MPD_SAX_DESCRIPTOR, gf_list_last(container), NULL);
+	return GF_TRUE;
+}
+
+static GF_List *gf_mpd_sax_common_descriptors(GF_MPD_CommonAttributes *com, const char *name)
+{
+	if (!strcmp(name, "FramePacking")) return com->frame_packing;
+	if (!strcmp(name, "AudioChannelConfiguration")) return com->audio_channels;
+	if (!strcmp(name, "ContentProtection")) return com->content_protection;
+	if (!strcmp(name, "EssentialProperty")) return com->essential_properties;
+	if (!strcmp(name, "SupplementalProperty")) return com->supplemental_properties;
+	return NULL;
+}
+
+static void gf_mpd_sax_child_start(GF_MPD_SAXLoader *ctx, GF_MPD_SAXElement *parent, GF_XMLNode *node)
+{
+	GF_Err e;
+	GF_MPD *mpd = ctx->mpd;
+	const char *name = node->name;
+
+	switch (parent->type) {
+	case MPD_SAX_ROOT:
+		if (!strcmp(name, "ProgramInformation")) {
+			e = gf_mpd_parse_program_info(mpd, node);
+			gf_mpd_sax_error(ctx, e);
+			gf_mpd_sax_push(ctx, e ? MPD_SAX_SKIP : MPD_SAX_PROGRAM_INFO, gf_list_last(mpd->program_infos), NULL);
+		} else if (!strcmp(name, "Location")) {
+			gf_mpd_sax_push(ctx, MPD_SAX_LOCATION, NULL, NULL);
+		} else if (!strcmp(name, "Period")) {
+			e = gf_mpd_parse_period(mpd, node);
+			gf_mpd_sax_error(ctx, e);
+			gf_mpd_sax_push(ctx, e ? MPD_SAX_SKIP : MPD_SAX_PERIOD, gf_list_last(mpd->periods), NULL);
+		} else if (!strcmp(name, "Metrics")) {
+			gf_mpd_sax_error(ctx, gf_mpd_parse_metrics(mpd, node));
+			gf_mpd_sax_push(ctx, MPD_SAX_SKIP, NULL, NULL);
+		} else if (!gf_mpd_sax_base_url(ctx, node, mpd->base_URLs)) {
+			GF_XMLNode *ext = gf_mpd_sax_extension_node(&mpd->children, name, node->ns, NULL, 0);
+			if (ext) {
+				gf_list_transfer(ext->attributes, node->attributes);
+			}
+			gf_mpd_sax_push(ctx, MPD_SAX_EXTENSION, ext, NULL);
+		}
+		return;
+	case MPD_SAX_PROGRAM_INFO:
+	{
+		GF_MPD_ProgramInfo *info = parent->obj;
+		if (!strcmp(name, "Title")) gf_mpd_sax_push(ctx, MPD_SAX_TEXT, info, &info->title);
+		else if (!strcmp(name, "Source")) gf_mpd_sax_push(ctx, MPD_SAX_TEXT, info, &info->source);
+		else if (!strcmp(name, "Copyright")) gf_mpd_sax_push(ctx, MPD_SAX_TEXT, info, &info->copyright);
+		else gf_mpd_sax_push(ctx, MPD_SAX_SKIP, NULL, NULL);
+		return;
+	}
+	case MPD_SAX_PERIOD:
+	{
+		GF_MPD_Period *period = parent->obj;
+		if (gf_mpd_sax_base_url(ctx, node, period->base_URLs)) return;
+		if (gf_mpd_sax_segment_info(ctx, node, &period->segment_base, &period->segment_list, &period->segment_template)) return;
+		if (!strcmp(name, "AdaptationSet")) {
+			e = gf_mpd_parse_adaptation_set(mpd, period->adaptation_sets, node);
+			gf_mpd_sax_error(ctx, e);
+			gf_mpd_sax_push(ctx, e ? MPD_SAX_SKIP : MPD_SAX_ADAPTATION_SET, gf_list_last(period->adaptation_sets), NULL);
+			return;
+		}
+		break;
+	}
+	case MPD_SAX_ADAPTATION_SET:
+	{
+		GF_MPD_AdaptationSet *set = parent->obj;
+		if (gf_mpd_sax_base_url(ctx, node, set->base_URLs)) return;
+		if (gf_mpd_sax_segment_info(ctx, node, &set->segment_base, &set->segment_list, &set->segment_template)) return;
+		if (!strcmp(name, "Representation")) {
+			e = gf_mpd_parse_representation(mpd, set->representations, node);
+			gf_mpd_sax_error(ctx, e);
+			gf_mpd_sax_push(ctx, e ? MPD_SAX_SKIP : MPD_SAX_REPRESENTATION, gf_list_last(set->representations), NULL);
+			return;
+		}
+		if (!strcmp(name, "ContentComponent")) {
+			e = gf_mpd_parse_content_component(mpd, set->content_component, node);
+			gf_mpd_sax_error(ctx, e);
+			gf_mpd_sax_push(ctx, e ? MPD_SAX_SKIP : MPD_SAX_CONTENT_COMPONENT, gf_list_last(set->content_component), NULL);
+			return;
+		}
+		if (!strcmp(name, "Accessibility")) gf_mpd_sax_descriptor(ctx, node, set->accessibility);
+		else if (!strcmp(name, "Role")) gf_mpd_sax_descriptor(ctx, node, set->role);
+		else if (!strcmp(name, "Rating")) gf_mpd_sax_descriptor(ctx, node, set->rating);
+		else if (!strcmp(name, "Viewpoint")) gf_mpd_sax_descriptor(ctx, node, set->viewpoint);
+		else if (!gf_mpd_sax_descriptor(ctx, node, gf_mpd_sax_common_descriptors((GF_MPD_CommonAttributes *)set, name)))
+			break;
+		return;
+	}
+	case MPD_SAX_CONTENT_COMPONENT:
+	{
+		GF_MPD_ContentComponent *comp = parent->obj;
+		if (!strcmp(name, "Accessibility")) gf_mpd_sax_descriptor(ctx, node, comp->accessibility);
+		else if (!strcmp(name, "Role")) gf_mpd_sax_descriptor(ctx, node, comp->role);
+		else if (!strcmp(name, "Rating")) gf_mpd_sax_descriptor(ctx, node, comp->rating);
+		else if (!strcmp(name, "Viewpoint")) gf_mpd_sax_descriptor(ctx, node, comp->viewpoint);
+		else break;
+		return;
+	}
+	case MPD_SAX_REPRESENTATION:
+	{
+		GF_MPD_Representation *rep = parent->obj;
+		if (gf_mpd_sax_base_url(ctx, node, rep->base_URLs)) return;
+		if (gf_mpd_sax_segment_info(ctx, node, &rep->segment_base, &rep->segment_list, &rep->segment_template)) return;
+		if (gf_mpd_sax_descriptor(ctx, node, gf_mpd_sax_common_descriptors((GF_MPD_CommonAttributes *)rep, name))) return;
+		break;
+	}
+	case MPD_SAX_SEGMENT_LIST:
+		if (!strcmp(name, "SegmentURL")) {
+			GF_MPD_SegmentList *seg = parent->obj;
+			if (!seg->segment_URLs) seg->segment_URLs = gf_list_new();
+			gf_mpd_parse_segment_url(seg->segment_URLs, node);
+			break;
+		}
+		/*fallthrough*/
+	case MPD_SAX_SEGMENT_TEMPLATE:
+		if (!strcmp(name, "SegmentTimeline")) {
+			GF_MPD_MultipleSegmentBase *seg = parent->obj;
+			GF_SAFEALLOC(seg->segment_timeline, GF_MPD_SegmentTimeline);
+			if (seg->segment_timeline) seg->segment_timeline->entries = gf_list_new();
+			gf_mpd_sax_push(ctx, MPD_SAX_SEGMENT_TIMELINE, seg->segment_timeline, NULL);
+			return;
+		}
+		if (!strcmp(name, "BitstreamSwitching")) {
+			GF_MPD_MultipleSegmentBase *seg = parent->obj;
+			seg->bitstream_switching_url = gf_mpd_parse_url(node);
+			break;
+		}
+		/*fallthrough*/
+	case MPD_SAX_SEGMENT_BASE:
+	{
+		GF_MPD_SegmentBase *seg = parent->obj;
+		if (!strcmp(name, "Initialization")) seg->initialization_segment = gf_mpd_parse_url(node);
+		else if (!strcmp(name, "RepresentationIndex")) seg->representation_index = gf_mpd_parse_url(node);
+		break;
+	}
+	}
+	gf_mpd_sax_push(ctx, MPD_SAX_SKIP, NULL, NULL);
+}
+
+static void gf_mpd_sax_node_start(void *sax_cbck, const char *node_name, const char *name_space, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	GF_MPD_SAXLoader *ctx = (GF_MPD_SAXLoader *) sax_cbck;
+	GF_MPD_SAXElement *parent;
+	GF_XMLNode *node;
+
+	if (ctx->nb_ignored || (ctx->depth==MPD_SAX_MAX_DEPTH)) {
+		ctx->nb_ignored++;
+		return;
+	}
+	/*root element*/
+	if (!ctx->depth) {
+		if (ctx->root_done) {
+			ctx->nb_ignored++;
+			return;
+		}
+		ctx->root_done = GF_TRUE;
+		if (name_space) ctx->root_ns = gf_strdup(name_space);
+		node = gf_mpd_sax_node(ctx, node_name, ctx->root_ns, attributes, nb_attributes);
+		gf_mpd_check_namespace(ctx->mpd, node);
+		if (!strcmp(node_name, "Period")) {
+			GF_Err e = gf_mpd_parse_period(ctx->mpd, node);
+			gf_mpd_sax_error(ctx, e);
+			gf_mpd_sax_push(ctx, e ? MPD_SAX_SKIP : MPD_SAX_PERIOD, gf_list_last(ctx->mpd->periods), NULL);
+		} else {
+			gf_mpd_parse_mpd_attributes(ctx->mpd, node);
+			gf_mpd_sax_push(ctx, MPD_SAX_ROOT, ctx->mpd, NULL);
+		}
+		gf_mpd_sax_node_reset(ctx);
+		return;
+	}
+
+	parent = &ctx->stack[ctx->depth-1];
+	switch (parent->type) {
+	case MPD_SAX_SKIP:
+	case MPD_SAX_TEXT:
+	case MPD_SAX_LOCATION:
+		gf_mpd_sax_push(ctx, MPD_SAX_SKIP, NULL, NULL);
+		return;
+	/*all children of descriptors and extension elements are kept whatever their namespace*/
+	case MPD_SAX_DESCRIPTOR:
+		gf_mpd_sax_push(ctx, MPD_SAX_EXTENSION, gf_mpd_sax_extension_node(&((GF_MPD_Descriptor *)parent->obj)->children, node_name, name_space, attributes, nb_attributes), NULL);
+		return;
+	case MPD_SAX_EXTENSION:
+		gf_mpd_sax_push(ctx, MPD_SAX_EXTENSION, gf_mpd_sax_extension_node(&((GF_XMLNode *)parent->obj)->content, node_name, name_space, attributes, nb_attributes), NULL);
+		return;
+	case MPD_SAX_SEGMENT_TIMELINE:
+		if (!strcmp(node_name, "S") && gf_mpd_sax_valid_ns(ctx->mpd, name_space)) {
+			gf_mpd_sax_timeline_entry(ctx, parent->obj, attributes, nb_attributes);
+		}
+		gf_mpd_sax_push(ctx, MPD_SAX_SKIP, NULL, NULL);
+		return;
+	default:
+		break;
+	}
+	if (!gf_mpd_sax_valid_ns(ctx->mpd, name_space)) {
+		gf_mpd_sax_push(ctx, MPD_SAX_SKIP, NULL, NULL);
+		return;
+	}
+	node = gf_mpd_sax_node(ctx, node_name, (char *) name_space, attributes, nb_attributes);
+	gf_mpd_sax_child_start(ctx, parent, node);
+	gf_mpd_sax_node_reset(ctx);
+}
+
+static void gf_mpd_sax_node_end(void *sax_cbck, const char *node_name, const char *name_space)
+{
+	GF_MPD_SAXLoader *ctx = (GF_MPD_SAXLoader *) sax_cbck;
+	GF_MPD_SAXElement *elt;
+
+	if (ctx->nb_ignored) {
+		ctx->nb_ignored--;
+		return;
+	}
+	if (!ctx->depth) return;
+	ctx->depth--;
+	elt = &ctx->stack[ctx->depth];
+
+	if (elt->type == MPD_SAX_LOCATION) {
+		if (elt->str) gf_list_add(ctx->mpd->locations, elt->str);
+		elt->str = NULL;
+	}
+	/*same as DOM parsing, no segment list if no SegmentURL*/
+	else if (elt->type == MPD_SAX_SEGMENT_LIST) {
+		GF_MPD_SegmentList *seg = elt->obj;
+		if (seg->segment_URLs && !gf_list_count(seg->segment_URLs)) {
+			gf_list_del(seg->segment_URLs);
+			seg->segment_URLs = NULL;
+		}
+	}
+}
+
+static void gf_mpd_sax_text(void *sax_cbck, const char *content, Bool is_cdata)
+{
+	GF_MPD_SAXLoader *ctx = (GF_MPD_SAXLoader *) sax_cbck;
+	GF_MPD_SAXElement *elt;
+	if (ctx->nb_ignored || !ctx->depth) return;
+	elt = &ctx->stack[ctx->depth-1];
+
+	if (elt->type == MPD_SAX_EXTENSION) {
+		GF_XMLNode *txt;
+		GF_SAFEALLOC(txt, GF_XMLNode);
+		if (!txt) return;
+		txt->type = is_cdata ? GF_XML_CDATA_TYPE : GF_XML_TEXT_TYPE;
+		txt->name = gf_strdup(content);
+		gf_list_add(((GF_XMLNode *)elt->obj)->content, txt);
+	}
+	/*only the first text node is used*/
+	else if (elt->text && !is_cdata && ! *elt->text) {
+		*elt->text = gf_strdup(content);
+	}
+}
+
+GF_EXPORT
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *default_base_url)
+{
+	GF_Err e;
+	u64 start;
+	GF_MPD_SAXLoader ctx;
+
+	if (!file || !mpd) return GF_BAD_PARAM;
+	gf_mpd_init_defaults(mpd);
+
+	memset(&ctx, 0, sizeof(GF_MPD_SAXLoader));
+	ctx.mpd = mpd;
+	ctx.node.type = GF_XML_NODE_TYPE;
+	ctx.node.attributes = gf_list_new();
+	ctx.node.content = gf_list_new();
+	ctx.sax = gf_xml_sax_new(gf_mpd_sax_node_start, gf_mpd_sax_node_end, gf_mpd_sax_text, &ctx);
+	if (!ctx.sax || !ctx.node.attributes || !ctx.node.content) {
+		e = GF_OUT_OF_MEM;
+		goto exit;
+	}
+
+	start = gf_sys_clock_high_res();
+	e = gf_xml_sax_parse_file(ctx.sax, file, NULL);
+	if (e<0) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Error parsing %s: %s\n", file, gf_xml_sax_get_error(ctx.sax) ));
+	} else {
+		e = ctx.error;
+		if (!e && !ctx.root_done) e = GF_NON_COMPLIANT_BITSTREAM;
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[MPD] Loaded %s (%d bytes - %d periods - %d timeline entries) in "LLU" us\n", file, gf_xml_sax_get_file_size(ctx.sax), gf_list_count(mpd->periods), ctx.nb_timeline_entries, gf_sys_clock_high_res() - start));
+
+exit:
+	/*unterminated Location element*/
+	while (ctx.depth) {
+		ctx.depth--;
+		if (ctx.stack[ctx.depth].str) gf_free(ctx.stack[ctx.depth].str);
+	}
+	/*the namespace prefix is only needed while parsing*/
+	if (mpd->xml_namespace && (mpd->xml_namespace == ctx.root_ns))
+		mpd->xml_namespace = NULL;
+	if (ctx.root_ns) gf_free(ctx.root_ns);
+	if (ctx.sax) gf_xml_sax_del(ctx.sax);
+	if (ctx.node.attributes) gf_list_del(ctx.node.attributes);
+	if (ctx.node.content) gf_list_del(ctx.node.content);
+	return (e<0) ? e : GF_OK;
+}
+
+/*gets start of first segment and end of last segment of the timeline, returns GF_FALSE if the timeline has an open-ended entry*/
+static Bool gf_mpd_segment_timeline_bounds(GF_MPD_SegmentTimeline *timeline, u64 *first_start, u64 *end)
+{
+	u32 i=0;
+	u64 start=0;
+	GF_MPD_SegmentTimelineEntry *ent;
+	*first_start = *end = 0;
+	while ((ent = gf_list_enum(timeline->entries, &i))) {
+		if (ent->start_time) start = ent->start_time;
+		if (i==1) *first_start = start;
+		if ((s32) ent->repeat_count < 0) return GF_FALSE;
+		start += (u64) ent->duration * (ent->repeat_count+1);
+	}
+	*end = start;
+	return GF_TRUE;
+}
+
+GF_EXPORT
+GF_Err gf_mpd_segment_timeline_merge(GF_MPD_SegmentTimeline *timeline, GF_MPD_SegmentTimeline *update, u32 *nb_new_segments)
+{
+	u32 i;
+	u64 start, end, old_start, old_end, new_start, new_end;
+	GF_MPD_SegmentTimelineEntry *ent, *last;
+
+	if (nb_new_segments) *nb_new_segments = 0;
+	if (!timeline || !update || !gf_list_count(timeline->entries) || !gf_list_count(update->entries)) return GF_BAD_PARAM;
+	if (!gf_mpd_segment_timeline_bounds(timeline, &old_start, &old_end) || !gf_mpd_segment_timeline_bounds(update, &new_start, &new_end))
+		return GF_NOT_SUPPORTED;
+	/*timeline moved backward or update not contiguous with the timeline*/
+	if ((new_end < old_end) || (new_start > old_end))
+		return GF_NOT_SUPPORTED;
+
+	/*remove segments no longer present in the update - segments before the start of the update which are still in the timeline
+	(purged by the client) are not restored*/
+	start = 0;
+	while ((ent = gf_list_get(timeline->entries, 0))) {
+		if (ent->start_time) start = ent->start_time;
+		while (ent->repeat_count && (start < new_start)) {
+			ent->repeat_count--;
+			start += ent->duration;
+		}
+		if (start >= new_start) {
+			ent->start_time = start;
+			break;
+		}
+		start += ent->duration;
+		gf_list_rem(timeline->entries, 0);
+		gf_free(ent);
+	}
+
+	/*append segments of the update starting after the end of the timeline*/
+	last = gf_list_last(timeline->entries);
+	end = old_end;
+	start = 0;
+	i = 0;
+	while ((ent = gf_list_enum(update->entries, &i))) {
+		u32 first = 0, nb_segs;
+		u64 seg_start, ent_end;
+		if (ent->start_time) start = ent->start_time;
+		ent_end = start + (u64) ent->duration * (ent->repeat_count+1);
+		if (!ent->duration || (ent_end <= end)) {
+			start = ent_end;
+			continue;
+		}
+		if (start < end) first = (u32) ((end - start + ent->duration - 1) / ent->duration);
+		seg_start = start + (u64) first * ent->duration;
+		nb_segs = ent->repeat_count + 1 - first;
+		/*last segment of the entry overlaps the end of the timeline*/
+		if (!nb_segs) {
+			start = ent_end;
+			continue;
+		}
+		if (nb_new_segments) *nb_new_segments += nb_segs;
+
+		if (last && (last->duration == ent->duration) && (seg_start == end)) {
+			last->repeat_count += nb_segs;
+		} else {
+			i--;
+			gf_list_rem(update->entries, i);
+			ent->start_time = seg_start;
+			ent->repeat_count = nb_segs - 1;
+			gf_list_add(timeline->entries, ent);
+			last = ent;
+		}
+		end = seg_start + (u64) ent->duration * nb_segs;
+		start = ent_end;
+	}
+	return GF_OK;
+}
+
 GF_EXPORT
 void gf_mpd_getter_del_session(GF_FileDownload *getter) {
 	if (!getter || !getter->del_session)
@@ -2261,6 +2903,7 @@ static void gf_mpd_print_adaptation_set(GF_MPD_AdaptationSet const * const as, F
 {
 	u32 i;
 	GF_MPD_Representation *rep;
+	GF_MPD_ContentComponent *comp;
 	fprintf(out, "  <AdaptationSet");
 
 	if (as->xlink_href) {
@@ -2295,7 +2938,24 @@ static void gf_mpd_print_adaptation_set(GF_MPD_AdaptationSet const * const as, F
 	gf_mpd_print_descriptors(out, as->rating, "Rating", "   ");
 	gf_mpd_print_descriptors(out, as->viewpoint, "Viewpoint", "   ");
 
-//			e = gf_mpd_parse_content_component(set->content_component, child);
+	i=0;
+	while ((comp = (GF_MPD_ContentComponent *)gf_list_enum(as->content_component, &i))) {
+		fprintf(out, "   <ContentComponent");
+		if (comp->id) fprintf(out, " id=\"%d\"", comp->id);
+		if (comp->lang) fprintf(out, " lang=\"%s\"", comp->lang);
+		if (comp->content_type) fprintf(out, " contentType=\"%s\"", comp->content_type);
+		if (comp->par) fprintf(out, " par=\"%d:%d\"", comp->par->num, comp->par->den);
+		if (gf_list_count(comp->accessibility) || gf_list_count(comp->role) || gf_list_count(comp->rating) || gf_list_count(comp->viewpoint)) {
+			fprintf(out, ">\n");
+			gf_mpd_print_descriptors(out, comp->accessibility, "Accessibility", "    ");
+			gf_mpd_print_descriptors(out, comp->role, "Role", "    ");
+			gf_mpd_print_descriptors(out, comp->rating, "Rating", "    ");
+			gf_mpd_print_descriptors(out, comp->viewpoint, "Viewpoint", "    ");
+			fprintf(out, "   </ContentComponent>\n");
+		} else {
+			fprintf(out, "/>\n");
+		}
+	}
 
 	if (as->segment_base) {
 		gf_mpd_print_segment_base(out, as->segment_base, "   ");
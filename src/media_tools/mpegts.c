@@ -54,6 +54,8 @@
 
 #define DEBUG_TS_PACKET 0
 
+#define M2TS_SET_PID_INTEREST(_ts, _pid) (_ts)->pid_interest[(_pid)>>5] |= (1U<<((_pid)&31))
+
 GF_EXPORT
 const char *gf_m2ts_get_stream_name(u32 streamType)
 {
@@ -201,6 +203,12 @@ static u32 gf_m2ts_reframe_reset(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Bool sam
 	return 0;
 }
 
+/*PES packets are not reassembled in scatter-gather mode, see gf_m2ts_process_pes_slices*/
+static u32 gf_m2ts_reframe_slices(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Bool same_pts, unsigned char *data, u32 data_len, GF_M2TS_PESHeader *pes_hdr)
+{
+	return 0;
+}
+
 
 static u32 gf_m2ts_reframe_nalu_video(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Bool same_pts, unsigned char *data, u32 data_len, GF_M2TS_PESHeader *pes_hdr, Bool is_hevc)
 {
@@ -227,9 +235,14 @@ static u32 gf_m2ts_reframe_nalu_video(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Boo
 
 	while (sc_pos<data_len) {
 		/* u32 sctype=0;*/
-		unsigned char *start = (unsigned char *)memchr(data+sc_pos, 0, data_len-sc_pos);
-		if (!start) break;
-		sc_pos = (u32) (start - data);
+		unsigned char *start;
+		u32 skip = gf_media_nalu_next_zero_pair(data+sc_pos, data_len-sc_pos);
+		/*a single zero byte in the skipped data is not a start code and resets the escape code state*/
+		if (esc_code_found && skip && memchr(data+sc_pos, 0, skip))
+			esc_code_found = 0;
+		if (sc_pos + skip >= data_len) break;
+		sc_pos += skip;
+		start = data + sc_pos;
 		/*not enough space to test for start code, don't check it*/
 		if (data_len - sc_pos < 5)
 			break;
@@ -1245,18 +1258,19 @@ static u32 gf_m2ts_reframe_id3_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Bool s
 	return 0;
 }
 
-static u32 gf_m2ts_sync(GF_M2TS_Demuxer *ts, Bool simple_check)
+/*returns the position of the first packet in data, or data_size if not found*/
+static u32 gf_m2ts_sync(GF_M2TS_Demuxer *ts, u8 *data, u32 data_size, Bool simple_check)
 {
 	u32 i=0;
 	/*if first byte is sync assume we're sync*/
-	if (simple_check && (ts->buffer[i]==0x47)) return 0;
+	if (simple_check && (data[i]==0x47)) return 0;
 
-	while (i<ts->buffer_size) {
-		if (i+188>=ts->buffer_size) return ts->buffer_size;
-		if ((ts->buffer[i]==0x47) && (ts->buffer[i+188]==0x47))
+	while (i<data_size) {
+		if (i+188>=data_size) return data_size;
+		if ((data[i]==0x47) && (data[i+188]==0x47))
 			break;
-		if (i+192>=ts->buffer_size) return ts->buffer_size;
-		if ((ts->buffer[i]==0x47) && (ts->buffer[i+192]==0x47)) {
+		if (i+192>=data_size) return data_size;
+		if ((data[i]==0x47) && (data[i+192]==0x47)) {
 			ts->prefix_present = 1;
 			break;
 		}
@@ -1331,6 +1345,23 @@ static void gf_m2ts_section_filter_del(GF_M2TS_SectionFilter *sf)
 	gf_free(sf);
 }
 
+static void gf_m2ts_unlink_pending_slices(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes)
+{
+	GF_M2TS_PES **prev = &ts->pending_slices;
+	if (!pes->slices_pending) return;
+
+	while (*prev) {
+		if (*prev == pes) {
+			*prev = pes->next_pending;
+			break;
+		}
+		prev = &(*prev)->next_pending;
+	}
+	pes->next_pending = NULL;
+	pes->slices_pending = GF_FALSE;
+	pes->nb_slices = 0;
+}
+
 GF_EXPORT
 void gf_m2ts_es_del(GF_M2TS_ES *es, GF_M2TS_Demuxer *ts)
 {
@@ -1351,6 +1382,8 @@ void gf_m2ts_es_del(GF_M2TS_ES *es, GF_M2TS_Demuxer *ts)
 		if ((pes->flags & GF_M2TS_INHERIT_PCR) && ts->ess[es->program->pcr_pid]==es)
 			ts->ess[es->program->pcr_pid] = NULL;
 
+		if (ts) gf_m2ts_unlink_pending_slices(ts, pes);
+		if (pes->slices) gf_free(pes->slices);
 		if (pes->pck_data) gf_free(pes->pck_data);
 		if (pes->prev_data) gf_free(pes->prev_data);
 		if (pes->buf) gf_free(pes->buf);
@@ -2670,6 +2703,8 @@ static void gf_m2ts_process_pat(GF_M2TS_Demuxer *ts, GF_M2TS_SECTION_ES *ses, GF
 			pmt->program = prog;
 			ts->ess[pmt->pid] = (GF_M2TS_ES *)pmt;
 			pmt->sec = gf_m2ts_section_filter_new(gf_m2ts_process_pmt, 0);
+			/*PMTs are always processed*/
+			M2TS_SET_PID_INTEREST(ts, pid);
 		}
 	}
 
@@ -2839,11 +2874,113 @@ static void gf_m2ts_store_temi(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes)
 	pes->temi_pending = 1;
 }
 
+static void gf_m2ts_dispatch_slices(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, u32 flags)
+{
+	GF_M2TS_PES_SLICES sl;
+	memset(&sl, 0, sizeof(GF_M2TS_PES_SLICES));
+	sl.stream = pes;
+	sl.flags = pes->slices_flags | flags;
+	if (!(flags & GF_M2TS_PES_SLICES_DISCARD)) {
+		sl.slices = pes->slices;
+		sl.nb_slices = pes->nb_slices;
+	}
+
+	if ((sl.flags & GF_M2TS_PES_SLICES_START) && sl.nb_slices) {
+		u8 hdr[9+255];
+		const u8 *ptr = sl.slices[0].data;
+		u32 avail = sl.slices[0].size;
+		/*the PES header spans several transport packets, gather it*/
+		if ((avail < 9) || (avail < 9 + (u32) ptr[8])) {
+			u32 i;
+			avail = 0;
+			for (i=0; (i<sl.nb_slices) && (avail<sizeof(hdr)); i++) {
+				u32 copy = MIN(sl.slices[i].size, sizeof(hdr) - avail);
+				memcpy(hdr + avail, sl.slices[i].data, copy);
+				avail += copy;
+			}
+			ptr = hdr;
+		}
+		if ((avail >= 9) && !ptr[0] && !ptr[1] && (ptr[2] == 0x1) && (avail >= 9 + (u32) ptr[8])) {
+			GF_M2TS_PESHeader pesh;
+			gf_m2ts_pes_header(pes, (unsigned char *) ptr + 3, avail - 3, &pesh);
+			sl.PTS = pesh.PTS;
+			sl.DTS = pesh.DTS;
+			sl.hdr_size = 9 + pesh.hdr_data_len;
+			if (pesh.PTS) {
+				pes->PTS = pesh.PTS;
+				pes->DTS = pesh.DTS;
+			}
+		}
+	}
+	if (ts->on_event) ts->on_event(ts, GF_M2TS_EVT_PES_SLICES, &sl);
+
+	pes->nb_slices = 0;
+	pes->slices_flags = 0;
+	if (flags & (GF_M2TS_PES_SLICES_END | GF_M2TS_PES_SLICES_DISCARD)) {
+		pes->pck_data_len = 0;
+		pes->pes_len = 0;
+	}
+}
+
+/*dispatches slices received during this gf_m2ts_process_data call, before the input data is released*/
+static void gf_m2ts_flush_pending_slices(GF_M2TS_Demuxer *ts)
+{
+	while (ts->pending_slices) {
+		GF_M2TS_PES *pes = ts->pending_slices;
+		ts->pending_slices = pes->next_pending;
+		pes->next_pending = NULL;
+		pes->slices_pending = GF_FALSE;
+		if (pes->nb_slices) gf_m2ts_dispatch_slices(ts, pes, 0);
+	}
+}
+
+/*scatter-gather mode: keeps a reference to the transport packet payload instead of copying it*/
+static void gf_m2ts_process_pes_slices(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, GF_M2TS_Header *hdr, unsigned char *data, u32 data_size, GF_M2TS_AdaptationField *paf)
+{
+	if (hdr->payload_start) {
+		/*PES first fragment: previous packet is complete*/
+		if (pes->pck_data_len) gf_m2ts_dispatch_slices(ts, pes, GF_M2TS_PES_SLICES_END);
+		pes->pes_start_packet_number = ts->pck_number;
+		pes->slices_flags = GF_M2TS_PES_SLICES_START;
+		pes->pes_len = (data_size >= 6) ? ((data[4]<<8) | data[5]) : 0;
+	}
+	/*we need to wait for first packet of PES*/
+	else if (!pes->pck_data_len) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPEG-2 TS] PID %d: Waiting for PES header, trashing data\n", hdr->pid));
+		return;
+	}
+
+	if (pes->nb_slices == pes->nb_alloc_slices) {
+		pes->nb_alloc_slices = pes->nb_alloc_slices ? 2*pes->nb_alloc_slices : 16;
+		pes->slices = (GF_M2TS_PESSlice *)gf_realloc(pes->slices, sizeof(GF_M2TS_PESSlice) * pes->nb_alloc_slices);
+	}
+	pes->slices[pes->nb_slices].data = data;
+	pes->slices[pes->nb_slices].size = data_size;
+	pes->nb_slices++;
+	pes->pck_data_len += data_size;
+	if (paf && paf->random_access_indicator) pes->slices_flags |= GF_M2TS_PES_SLICES_RAP;
+
+	if (!pes->slices_pending) {
+		pes->next_pending = ts->pending_slices;
+		ts->pending_slices = pes;
+		pes->slices_pending = GF_TRUE;
+	}
+	/* 6 = startcode+stream_id+length*/
+	if (pes->pes_len && (pes->pck_data_len >= pes->pes_len + 6)) {
+		gf_m2ts_dispatch_slices(ts, pes, GF_M2TS_PES_SLICES_END);
+	}
+}
+
 void gf_m2ts_flush_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes)
 {
 	GF_M2TS_PESHeader pesh;
 	if (!ts) return;
 
+	if (pes->reframe == gf_m2ts_reframe_slices) {
+		if (pes->pck_data_len) gf_m2ts_dispatch_slices(ts, pes, GF_M2TS_PES_SLICES_END);
+		return;
+	}
+
 	/*we need at least a full, valid start code !!*/
 	if ((pes->pck_data_len >= 4) && !pes->pck_data[0] && !pes->pck_data[1] && (pes->pck_data[2] == 0x1)) {
 		u32 len;
@@ -3010,6 +3147,8 @@ static void gf_m2ts_process_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, GF_M2TS_H
 			} else {
 				if (pes->pck_data_len) {
 					GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[MPEG-2 TS] PES %d: Packet discontinuity (%d expected - got %d) - trashing PES packet\n", pes->pid, expect_cc, hdr->continuity_counter));
+					if (pes->reframe == gf_m2ts_reframe_slices)
+						gf_m2ts_dispatch_slices(ts, pes, GF_M2TS_PES_SLICES_DISCARD);
 				}
 				pes->pck_data_len = 0;
 				pes->pes_len = 0;
@@ -3021,6 +3160,11 @@ static void gf_m2ts_process_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, GF_M2TS_H
 
 	if (!pes->reframe) return;
 
+	if (pes->reframe == gf_m2ts_reframe_slices) {
+		gf_m2ts_process_pes_slices(ts, pes, hdr, data, data_size, paf);
+		return;
+	}
+
 	if (hdr->payload_start) {
 		flush_pes = 1;
 		pes->pes_start_packet_number = ts->pck_number;
@@ -3453,65 +3597,146 @@ static GF_Err gf_m2ts_process_packet(GF_M2TS_Demuxer *ts, unsigned char *data)
 	return GF_OK;
 }
 
+/*PID filtering, checked on the packet header before any parsing*/
+static GFINLINE Bool gf_m2ts_skip_packet(GF_M2TS_Demuxer *ts, u8 *data)
+{
+	u32 pid;
+	if (!ts->pid_filter) return GF_FALSE;
+	pid = ((data[1] & 0x1f) << 8) | data[2];
+	if (ts->pid_interest[pid>>5] & (1U<<(pid&31))) return GF_FALSE;
+	ts->pck_number++;
+	return GF_TRUE;
+}
+
+/*returns the number of consecutive packets starting with a sync byte - sync bytes of 8 packets are checked at once*/
+static u32 gf_m2ts_sync_run(u8 *data, u32 nb_pck, u32 pck_size)
+{
+	u32 i=0;
+	while (i+8 <= nb_pck) {
+		u8 *p = data + i*pck_size;
+		u8 diff = (p[0] ^ 0x47) | (p[pck_size] ^ 0x47) | (p[2*pck_size] ^ 0x47) | (p[3*pck_size] ^ 0x47)
+		          | (p[4*pck_size] ^ 0x47) | (p[5*pck_size] ^ 0x47) | (p[6*pck_size] ^ 0x47) | (p[7*pck_size] ^ 0x47);
+		if (diff) break;
+		i += 8;
+	}
+	while ((i<nb_pck) && (data[i*pck_size] == 0x47)) i++;
+	return i;
+}
+
+/*keeps the end of unsynchronized data for the next call*/
+static void gf_m2ts_stash_unsynced(GF_M2TS_Demuxer *ts, u8 *data, u32 data_size)
+{
+	if (data_size>191) {
+		data += data_size-191;
+		data_size = 191;
+	}
+	memmove(ts->partial_pck, data, data_size);
+	ts->partial_size = data_size;
+	ts->partial_synced = GF_FALSE;
+}
+
 GF_EXPORT
 GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
 {
-	GF_Err e;
+	GF_Err e=GF_OK;
 	u32 pos, pck_size;
-	Bool is_align = 1;
-	if (ts->buffer) {
-		if (ts->alloc_size < ts->buffer_size+data_size) {
-			ts->alloc_size = ts->buffer_size+data_size;
-			ts->buffer = (char*)gf_realloc(ts->buffer, sizeof(char)*ts->alloc_size);
-		}
-		memcpy(ts->buffer + ts->buffer_size, data, sizeof(char)*data_size);
-		ts->buffer_size += data_size;
-		is_align = 0;
-	} else {
-		ts->buffer = data;
-		ts->buffer_size = data_size;
+	u8 *buf = (u8 *) data;
+	Bool simple_check = GF_TRUE;
+
+	if (!data_size) return GF_OK;
+
+	/*look for a packet start in the unsynchronized data of the previous call followed by the new data*/
+	if (ts->partial_size && !ts->partial_synced) {
+		u8 tmp[2*192];
+		u32 size, copy = MIN(data_size, 193);
+		memcpy(tmp, ts->partial_pck, ts->partial_size);
+		memcpy(tmp + ts->partial_size, buf, copy);
+		size = ts->partial_size + copy;
+		pos = gf_m2ts_sync(ts, tmp, size, GF_FALSE);
+		if (pos < ts->partial_size) {
+			ts->partial_size -= pos;
+			memmove(ts->partial_pck, ts->partial_pck + pos, ts->partial_size);
+			ts->partial_synced = GF_TRUE;
+		} else if ((pos==size) && (copy==data_size)) {
+			gf_m2ts_stash_unsynced(ts, tmp, size);
+			return GF_OK;
+		} else {
+			ts->partial_size = 0;
+			simple_check = GF_FALSE;
+		}
 	}
 
-	/*sync input data*/
-	pos = gf_m2ts_sync(ts, is_align);
-	if (pos==ts->buffer_size) {
-		if (is_align) {
-			ts->buffer = (char*)gf_malloc(sizeof(char)*data_size);
-			memcpy(ts->buffer, data, sizeof(char)*data_size);
-			ts->alloc_size = ts->buffer_size = data_size;
+	/*complete the packet started in the previous call*/
+	if (ts->partial_size) {
+		u32 missing;
+		pck_size = ts->prefix_present ? 192 : 188;
+		missing = pck_size - ts->partial_size;
+		if (data_size < missing) {
+			memcpy(ts->partial_pck + ts->partial_size, buf, data_size);
+			ts->partial_size += data_size;
+			return GF_OK;
+		}
+		memcpy(ts->partial_pck + ts->partial_size, buf, missing);
+		buf += missing;
+		data_size -= missing;
+		/*partial_pck is not modified until the end of the call, slices may point to it*/
+		ts->partial_size = 0;
+		if (!gf_m2ts_skip_packet(ts, ts->partial_pck))
+			e |= gf_m2ts_process_packet(ts, ts->partial_pck);
+		if (ts->abort_parsing || !data_size) {
+			gf_m2ts_flush_pending_slices(ts);
+			return e;
 		}
-		return GF_OK;
 	}
+
+	/*sync input data*/
+	pos = gf_m2ts_sync(ts, buf, data_size, simple_check);
+	if (pos==data_size) {
+		gf_m2ts_flush_pending_slices(ts);
+		gf_m2ts_stash_unsynced(ts, buf, data_size);
+		return e;
+	}
+	/*process packets in place*/
 	pck_size = ts->prefix_present ? 192 : 188;
-	e=GF_OK;
-	for (;;) {
-		/*wait for a complete packet*/
-		if (ts->buffer_size < pos  + pck_size) {
-			ts->buffer_size -= pos;
-			if (!ts->buffer_size) {
-				if (!is_align) gf_free(ts->buffer);
-				ts->buffer = NULL;
+	while (pos + pck_size <= data_size) {
+		u32 nb_pck = (data_size - pos) / pck_size;
+		u32 nb_sync = gf_m2ts_sync_run(buf+pos, nb_pck, pck_size);
+
+		while (nb_sync) {
+			u8 *pck = buf+pos;
+			pos += pck_size;
+			nb_sync--;
+			nb_pck--;
+			if (gf_m2ts_skip_packet(ts, pck)) continue;
+
+			e |= gf_m2ts_process_packet(ts, pck);
+			if (ts->abort_parsing) {
+				gf_m2ts_flush_pending_slices(ts);
 				return e;
 			}
-			if (is_align) {
-				data = ts->buffer+pos;
-				ts->buffer = (char*)gf_malloc(sizeof(char)*ts->buffer_size);
-				memcpy(ts->buffer, data, sizeof(char)*ts->buffer_size);
-				ts->alloc_size = ts->buffer_size;
-			} else {
-				memmove(ts->buffer, ts->buffer + pos, sizeof(char)*ts->buffer_size);
-			}
-			return e;
 		}
-		/*process*/
-		e |= gf_m2ts_process_packet(ts, (unsigned char *)ts->buffer+pos);
-		pos += pck_size;
+		if (!nb_pck) break;
 
-		if (ts->abort_parsing) {
-			if (!is_align) gf_free(ts->buffer);
-			ts->buffer = NULL;
+		/*sync lost, look for the next packet*/
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[MPEG-2 TS] TS Packet %d does not start with sync marker - resyncing\n", ts->pck_number+1));
+		e |= GF_CORRUPTED_DATA;
+		pos++;
+		nb_pck = gf_m2ts_sync(ts, buf+pos, data_size-pos, GF_FALSE);
+		if (pos + nb_pck == data_size) {
+			gf_m2ts_flush_pending_slices(ts);
+			gf_m2ts_stash_unsynced(ts, buf+pos, data_size-pos);
 			return e;
 		}
+		pos += nb_pck;
+		pck_size = ts->prefix_present ? 192 : 188;
+	}
+	gf_m2ts_flush_pending_slices(ts);
+
+	/*wait for a complete packet*/
+	if (pos < data_size) {
+		memcpy(ts->partial_pck, buf+pos, data_size-pos);
+		ts->partial_size = data_size-pos;
+		ts->partial_synced = GF_TRUE;
 	}
 	return e;
 }
@@ -3580,6 +3805,8 @@ void gf_m2ts_reset_parsers_for_program(GF_M2TS_Demuxer *ts, GF_M2TS_Program *pro
 			pes->cc = -1;
 			pes->frame_state = 0;
 			pes->pck_data_len = 0;
+			pes->nb_slices = 0;
+			pes->slices_flags = 0;
 			if (pes->prev_data) gf_free(pes->prev_data);
 			pes->prev_data = NULL;
 			pes->prev_data_len = 0;
@@ -3638,6 +3865,7 @@ u32 gf_m2ts_pes_get_framing_mode(GF_M2TS_PES *pes)
 	if (!pes->reframe ) return GF_M2TS_PES_FRAMING_SKIP_NO_RESET;
 	if (pes->reframe == gf_m2ts_reframe_default) return GF_M2TS_PES_FRAMING_RAW;
 	if (pes->reframe == gf_m2ts_reframe_reset) return GF_M2TS_PES_FRAMING_SKIP;
+	if (pes->reframe == gf_m2ts_reframe_slices) return GF_M2TS_PES_FRAMING_SLICES;
 	if (pes->single_nal_mode) return GF_M2TS_PES_FRAMING_DEFAULT_NAL;
 	return GF_M2TS_PES_FRAMING_DEFAULT;
 }
@@ -3672,10 +3900,21 @@ GF_Err gf_m2ts_set_pes_framing(GF_M2TS_PES *pes, u32 mode)
 		pes->program->ts->ess[pes->pid] = (GF_M2TS_ES *) pes;
 	}
 
+	/*switching between scatter-gather and reassembly, drop the current PES*/
+	if ((pes->reframe == gf_m2ts_reframe_slices) != (mode == GF_M2TS_PES_FRAMING_SLICES)) {
+		if (pes->reframe == gf_m2ts_reframe_slices) gf_m2ts_unlink_pending_slices(pes->program->ts, pes);
+		pes->pck_data_len = 0;
+		pes->pes_len = 0;
+		pes->slices_flags = 0;
+	}
+
 	switch (mode) {
 	case GF_M2TS_PES_FRAMING_RAW:
 		pes->reframe = gf_m2ts_reframe_default;
 		break;
+	case GF_M2TS_PES_FRAMING_SLICES:
+		pes->reframe = gf_m2ts_reframe_slices;
+		break;
 	case GF_M2TS_PES_FRAMING_SKIP:
 		pes->reframe = gf_m2ts_reframe_reset;
 		break;
@@ -3766,10 +4005,36 @@ GF_M2TS_Demuxer *gf_m2ts_demux_new()
 	ts->nb_prog_pmt_received = 0;
 	ts->ChannelAppList = gf_list_new();
 	ts->udp_buffer_size = GF_M2TS_UDP_BUFFER_SIZE;
+	M2TS_SET_PID_INTEREST(ts, GF_M2TS_PID_PAT);
 
 	return ts;
 }
 
+GF_EXPORT
+void gf_m2ts_set_pid_interest(GF_M2TS_Demuxer *ts, u32 pid, Bool interest)
+{
+	if (pid >= GF_M2TS_MAX_STREAMS) return;
+	if (interest) {
+		M2TS_SET_PID_INTEREST(ts, pid);
+	} else {
+		ts->pid_interest[pid>>5] &= ~(1U<<(pid&31));
+	}
+	ts->pid_filter = GF_TRUE;
+}
+
+GF_EXPORT
+void gf_m2ts_reset_pid_interest(GF_M2TS_Demuxer *ts)
+{
+	u32 i, count = gf_list_count(ts->programs);
+	memset(ts->pid_interest, 0, sizeof(ts->pid_interest));
+	ts->pid_filter = GF_FALSE;
+	M2TS_SET_PID_INTEREST(ts, GF_M2TS_PID_PAT);
+	for (i=0; i<count; i++) {
+		GF_M2TS_Program *prog = (GF_M2TS_Program *)gf_list_get(ts->programs, i);
+		M2TS_SET_PID_INTEREST(ts, prog->pmt_pid);
+	}
+}
+
 GF_EXPORT
 void gf_m2ts_abort_parsing(GF_M2TS_Demuxer *ts, Bool force_reset_pes)
 {
@@ -3830,7 +4095,6 @@ void gf_m2ts_demux_del(GF_M2TS_Demuxer *ts)
 		//bacause of pure PCR streams, en ES might be reassigned on 2 PIDs, one for the ES and one for the PCR
 		if (ts->ess[i] && (ts->ess[i]->pid==i)) gf_m2ts_es_del(ts->ess[i], ts);
 	}
-	if (ts->buffer) gf_free(ts->buffer);
 	while (gf_list_count(ts->programs)) {
 		GF_M2TS_Program *p = (GF_M2TS_Program *)gf_list_last(ts->programs);
 		gf_list_rem_last(ts->programs);
@@ -4022,6 +4286,10 @@ GF_Err gf_m2ts_demux_file(GF_M2TS_Demuxer *ts, const char *fileName, u64 start_b
 	return GF_OK;
 }
 
+/*max number of UDP datagrams read at once*/
+#define M2TS_UDP_BATCH	32
+/*size of each datagram in batch reception, enough for jumbo frames*/
+#define M2TS_UDP_PCK_SIZE	9216
 
 static u32 gf_m2ts_demuxer_run(void *_p)
 {
@@ -4029,7 +4297,7 @@ static u32 gf_m2ts_demuxer_run(void *_p)
 	GF_Err e;
 	u32 size;
 	GF_M2TS_Demuxer *ts = _p;
-	char *data = gf_malloc(ts->udp_buffer_size);
+	char *data = gf_malloc(MAX(ts->udp_buffer_size, M2TS_UDP_BATCH*M2TS_UDP_PCK_SIZE));
 
 	gf_m2ts_reset_parsers(ts);
 	ts->abort_parsing = GF_FALSE;
@@ -4058,13 +4326,23 @@ static u32 gf_m2ts_demuxer_run(void *_p)
 #ifndef GPAC_DISABLE_STREAMING
 			u16 seq_num;
 			GF_RTPReorder *ch = NULL;
+			GF_RTPPacketPool *pool = NULL;
+			Bool pooled = GF_FALSE;
 #endif
+			char *pcks[M2TS_UDP_BATCH];
+			u32 sizes[M2TS_UDP_BATCH];
+			u32 nb_pcks, nb_slots, slot_size, nb_rcv, nb_drop, nb_trunc;
 			u32 nb_empty=0;
 			Bool first_run, is_rtp;
 			FILE *record_to = NULL;
 			if (ts->record_to)
 				record_to = gf_fopen(ts->record_to, "wb");
 
+			/*datagrams are read in batches in slices of the reception buffer*/
+			nb_slots = M2TS_UDP_BATCH;
+			slot_size = M2TS_UDP_PCK_SIZE;
+			for (i=0; i<M2TS_UDP_BATCH; i++) pcks[i] = data + i*M2TS_UDP_PCK_SIZE;
+
 			first_run = 1;
 			is_rtp = 0;
 			while (ts->run_state) {
@@ -4072,10 +4350,10 @@ static u32 gf_m2ts_demuxer_run(void *_p)
 					gf_sleep(1);
 					continue;
 				}
-				size = 0;
+				nb_pcks = 0;
 				/*m2ts chunks by chunks*/
-				e = gf_sk_receive(ts->sock, data, ts->udp_buffer_size, 0, &size);
-				if (!size || e) {
+				e = gf_sk_receive_batch(ts->sock, pcks, slot_size, sizes, nb_slots, &nb_pcks);
+				if (!nb_pcks || e) {
 					nb_empty++;
 					if (nb_empty==1000) {
 						gf_sleep(1);
@@ -4083,48 +4361,96 @@ static u32 gf_m2ts_demuxer_run(void *_p)
 					}
 					continue;
 				}
-				if (first_run) {
-					first_run = 0;
-					/*FIXME: we assume only simple RTP packaging (no CSRC nor extensions)*/
-					if ((data[0] != 0x47) && ((data[1] & 0x7F) == 33) ) {
-						is_rtp = 1;
+				/*process chunks*/
+				for (i=0; i<nb_pcks; i++) {
+					char *buf = pcks[i];
+					size = sizes[i];
+					if (!size) continue;
+
+					if (first_run) {
+						first_run = 0;
+						/*FIXME: we assume only simple RTP packaging (no CSRC nor extensions)*/
+						if ((buf[0] != 0x47) && ((buf[1] & 0x7F) == 33) ) {
+							is_rtp = 1;
 #ifndef GPAC_DISABLE_STREAMING
-						ch = gf_rtp_reorderer_new(100, 500);
+							ch = gf_rtp_reorderer_new(100, 500);
+							pool = gf_rtp_packet_pool_new(M2TS_UDP_PCK_SIZE, M2TS_UDP_BATCH + 100);
+							gf_rtp_reorderer_set_pool(ch, pool);
 #endif
+						}
 					}
-				}
-				/*process chunk*/
-				if (is_rtp) {
+
+					if (is_rtp) {
 #ifndef GPAC_DISABLE_STREAMING
-					char *pck;
-					seq_num = ((data[2] << 8) & 0xFF00) | (data[3] & 0xFF);
-					gf_rtp_reorderer_add(ch, (void *) data, size, seq_num);
+						char *pck;
+						if (size < 12) continue;
+						seq_num = ((buf[2] << 8) & 0xFF00) | (buf[3] & 0xFF);
+						if (pooled) {
+							/*queue the packet and replace it in the batch*/
+							gf_rtp_reorderer_add_packet(ch, buf, size, seq_num);
+							pcks[i] = gf_rtp_packet_pool_get(pool, 0);
+						} else {
+							gf_rtp_reorderer_add(ch, (void *) buf, size, seq_num);
+						}
 
-					pck = (char *) gf_rtp_reorderer_get(ch, &size);
-					if (pck) {
-						gf_m2ts_process_data(ts, pck+12, size-12);
-						if (record_to)
-							fwrite(data+12, size-12, 1, record_to);
-						gf_free(pck);
-					}
+						while ((pck = gf_rtp_reorderer_get_packet(ch, &size)) != NULL) {
+							gf_m2ts_process_data(ts, pck+12, size-12);
+							if (record_to)
+								fwrite(pck+12, size-12, 1, record_to);
+							gf_rtp_packet_pool_release(pool, pck);
+						}
 #else
-					gf_m2ts_process_data(ts, data+12, size-12);
-					if (record_to)
-						fwrite(data+12, size-12, 1, record_to);
+						gf_m2ts_process_data(ts, buf+12, size-12);
+						if (record_to)
+							fwrite(buf+12, size-12, 1, record_to);
 #endif
 
-				} else {
-					gf_m2ts_process_data(ts, data, size);
-					if (record_to)
-						fwrite(data, size, 1, record_to);
+					} else {
+						gf_m2ts_process_data(ts, buf, size);
+						if (record_to)
+							fwrite(buf, size, 1, record_to);
+					}
+				}
+				if ((nb_slots>1) && !is_rtp) {
+					/*datagrams larger than the slices, use the whole buffer for each datagram*/
+					gf_sk_get_receive_stats(ts->sock, NULL, NULL, &nb_trunc);
+					if (nb_trunc) {
+						GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[MPEG-2 TS] UDP datagrams larger than %d bytes, disabling batch reception\n", slot_size));
+						nb_slots = 1;
+						slot_size = ts->udp_buffer_size;
+						pcks[0] = data;
+					}
+				}
+#ifndef GPAC_DISABLE_STREAMING
+				/*from now on RTP packets are received in the reorderer pool*/
+				if (is_rtp && ch) {
+					for (i=0; i<M2TS_UDP_BATCH; i++) {
+						if (!pooled || !pcks[i]) pcks[i] = gf_rtp_packet_pool_get(pool, 0);
+						if (!pcks[i]) break;
+					}
+					pooled = GF_TRUE;
+					if (i<M2TS_UDP_BATCH) {
+						GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[MPEG-2 TS] Out of memory for UDP reception\n"));
+						break;
+					}
 				}
+#endif
 			}
 			if (record_to)
 				gf_fclose(record_to);
 
+			gf_sk_get_receive_stats(ts->sock, &nb_rcv, &nb_drop, &nb_trunc);
+			GF_LOG(nb_drop ? GF_LOG_WARNING : GF_LOG_INFO, GF_LOG_CONTAINER, ("[MPEG-2 TS] UDP reception done: %d datagrams received - %d dropped by the system - %d too large\n", nb_rcv, nb_drop, nb_trunc));
+
 #ifndef GPAC_DISABLE_STREAMING
 			if (ch)
 				gf_rtp_reorderer_del(ch);
+			if (pool) {
+				if (pooled) {
+					for (i=0; i<M2TS_UDP_BATCH; i++) gf_rtp_packet_pool_release(pool, pcks[i]);
+				}
+				gf_rtp_packet_pool_del(pool);
+			}
 #endif
 
 			if (ts->sock && !ts->sock_is_delegate) gf_sk_del(ts->sock);
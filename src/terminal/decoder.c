@@ -1242,6 +1242,7 @@ static GF_Err MediaCodec_Process(GF_Codec *codec, u32 TimeAvailable)
 
 	//cannot output frame, do nothing (we force a channel query before for pull mode)
 	if (codec->CB->Capacity == codec->CB->UnitCount) {
+		gf_cm_input_stalled(codec->CB);
 		//do not stop codec!
 		if (codec->CB->UnitCount > 1) return GF_OK;
 		else if (codec->direct_frame_output|| codec->direct_vout) return GF_OK;
@@ -42,20 +42,422 @@ enum
 	/*only used by threaded decs to signal end of thread*/
 	GF_MM_CE_DEAD = 1<<4,
 	GF_MM_CE_DISCARDED = 1<<5,
+	/*decoder is a task of the worker pool*/
+	GF_MM_CE_POOLED = 1<<6,
+};
+
+/*state of a decoder task in the worker pool*/
+enum
+{
+	/*parked until woken by an event*/
+	GF_MM_TASK_IDLE = 0,
+	/*in the run queue*/
+	GF_MM_TASK_QUEUED,
+	/*being processed by a worker*/
+	GF_MM_TASK_ACTIVE,
 };
 
 typedef struct
 {
 	u32 flags;
 	GF_Codec *dec;
-	/*for threaded decoders*/
+	/*for threaded and pooled decoders*/
 	GF_Thread *thread;
 	GF_Mutex *mx;
+	/*for threaded decoders, signaled when the decoder may have work to do*/
+	GF_Semaphore *sema;
+	u32 wake_pending;
+	/*for pooled decoders*/
+	u32 task_state;
+	/*set when the task is woken while being processed*/
+	Bool task_wake;
+	/*ID of the worker thread processing the task, valid while ACTIVE*/
+	u32 task_thread_id;
 } CodecEntry;
 
+struct _pool_worker
+{
+	GF_Thread *th;
+	GF_Terminal *term;
+	/*task being processed, reset if the task is detached from its own decode call*/
+	CodecEntry *task;
+};
+
+struct _decoder_pool
+{
+	struct _pool_worker *workers;
+	u32 nb_workers;
+	/*all pooled codec entries*/
+	GF_List *tasks;
+	/*codec entries ready to be processed, in wake order*/
+	GF_List *run_queue;
+	/*protects the above lists and the task state of the entries. Never held while decoding*/
+	GF_Mutex *mx;
+	/*one notification per queued task*/
+	GF_Semaphore *sema;
+	/*signaled when an ACTIVE task is done, one notification per waiter*/
+	GF_Semaphore *done_sema;
+	u32 nb_done_waiters;
+	Bool running;
+	/*set when an idle worker is in charge of the periodic wake of parked tasks*/
+	Bool has_timekeeper;
+};
+
+/*pending flags are set by the network and compositor threads and cleared by the woken thread*/
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define mm_atomic_cas(_v, _old, _new)	(_InterlockedCompareExchange((long volatile *) (_v), (_new), (_old)) == (long) (_old))
+#define mm_atomic_clear(_v)	_InterlockedExchange((long volatile *) (_v), 0)
+#elif defined(__GNUC__)
+#define mm_atomic_cas(_v, _old, _new)	__sync_bool_compare_and_swap((_v), (_old), (_new))
+#define mm_atomic_clear(_v)	__sync_fetch_and_and((_v), 0)
+#else
+/*no atomics, a notification may be sent twice*/
+#define mm_atomic_cas(_v, _old, _new)	((*(_v) == (_old)) ? (*(_v) = (_new), GF_TRUE) : GF_FALSE)
+#define mm_atomic_clear(_v)	(*(_v) = 0)
+#endif
+
+/*notifies a waiting thread - the pending flag avoids piling up notifications while the thread is busy*/
+static void mm_signal(GF_Semaphore *sema, u32 *pending)
+{
+	if (!sema) return;
+	if (!mm_atomic_cas(pending, 0, 1)) return;
+	gf_sema_notify(sema, 1);
+}
+
+/*waits for a notification or the timeout. The pending flag is cleared before processing so that no event is lost*/
+static void mm_wait(GF_Semaphore *sema, u32 *pending, u32 timeout)
+{
+	gf_sema_wait_for(sema, timeout);
+	mm_atomic_clear(pending);
+}
+
+/*codec list changes, see gf_term_wake_codec*/
+static void mm_codec_list_insert(GF_Terminal *term, CodecEntry *ce, s32 pos)
+{
+	gf_mx_p(term->mm_wake_mx);
+	if (pos<0) gf_list_add(term->codecs, ce);
+	else gf_list_insert(term->codecs, ce, pos);
+	gf_mx_v(term->mm_wake_mx);
+}
+
+static void mm_codec_list_remove(GF_Terminal *term, u32 pos)
+{
+	gf_mx_p(term->mm_wake_mx);
+	gf_list_rem(term->codecs, pos);
+	gf_mx_v(term->mm_wake_mx);
+}
+
+static void mm_thread_entry_new(GF_Terminal *term, CodecEntry *ce)
+{
+	ce->thread = gf_th_new(ce->dec->decio->module_name);
+	ce->mx = gf_mx_new(ce->dec->decio->module_name);
+	ce->wake_pending = 0;
+	gf_mx_p(term->mm_wake_mx);
+	ce->sema = gf_sema_new(0x7FFFFFFF, 0);
+	ce->flags |= GF_MM_CE_THREADED;
+	gf_mx_v(term->mm_wake_mx);
+}
+
+static void mm_thread_entry_del(GF_Terminal *term, CodecEntry *ce)
+{
+	GF_Semaphore *sema;
+
+	/*wait for thread to die*/
+	if (ce->flags & GF_MM_CE_RUNNING) {
+		ce->flags &= ~GF_MM_CE_RUNNING;
+		gf_sema_notify(ce->sema, 1);
+		while (! (ce->flags & GF_MM_CE_DEAD)) gf_sleep(1);
+	}
+	ce->flags &= ~GF_MM_CE_DEAD;
+	/*in case the thread is still waiting*/
+	gf_sema_notify(ce->sema, 1);
+	gf_th_del(ce->thread);
+	ce->thread = NULL;
+	gf_mx_del(ce->mx);
+	ce->mx = NULL;
+	/*no wake notification may use the semaphore once detached*/
+	gf_mx_p(term->mm_wake_mx);
+	sema = ce->sema;
+	ce->sema = NULL;
+	ce->flags &= ~GF_MM_CE_THREADED;
+	gf_mx_v(term->mm_wake_mx);
+	gf_sema_del(sema);
+}
+
+static void mm_pool_queue_task(struct _decoder_pool *pool, CodecEntry *ce)
+{
+	switch (ce->task_state) {
+	case GF_MM_TASK_IDLE:
+		ce->task_state = GF_MM_TASK_QUEUED;
+		gf_list_add(pool->run_queue, ce);
+		gf_sema_notify(pool->sema, 1);
+		break;
+	case GF_MM_TASK_ACTIVE:
+		/*requeued by the worker once done*/
+		ce->task_wake = GF_TRUE;
+		break;
+	default:
+		break;
+	}
+}
+
+static u32 MM_PoolWorker(void *par)
+{
+	struct _pool_worker *w = (struct _pool_worker *) par;
+	GF_Terminal *term = w->term;
+	struct _decoder_pool *pool = term->dec_pool;
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[MediaDecoder] Entering pool worker thread ID %d\n", gf_th_id() ));
+
+	gf_mx_p(pool->mx);
+	while (pool->running) {
+		GF_Err e;
+		u32 nb_frames;
+		Bool got_task, timekeeper = GF_FALSE;
+		CodecEntry *ce;
+		GF_Mutex *ce_mx;
+
+		/*only one idle worker wakes up periodically, for decoders not waiting on CB or AU events (clock-driven, pull channels)*/
+		if (!pool->has_timekeeper) {
+			pool->has_timekeeper = timekeeper = GF_TRUE;
+		}
+		gf_mx_v(pool->mx);
+
+		if (timekeeper) {
+			got_task = gf_sema_wait_for(pool->sema, term->frame_duration);
+		} else {
+			gf_sema_wait(pool->sema);
+			got_task = GF_TRUE;
+		}
+
+		gf_mx_p(pool->mx);
+		if (timekeeper) pool->has_timekeeper = GF_FALSE;
+
+		if (!got_task) {
+			u32 i = 0;
+			while ((ce = (CodecEntry*)gf_list_enum(pool->tasks, &i))) {
+				if (ce->flags & GF_MM_CE_RUNNING) mm_pool_queue_task(pool, ce);
+			}
+			continue;
+		}
+		ce = (CodecEntry*)gf_list_pop_front(pool->run_queue);
+		if (!ce) continue;
+		ce->task_state = GF_MM_TASK_ACTIVE;
+		ce->task_wake = GF_FALSE;
+		ce->task_thread_id = gf_th_id();
+		w->task = ce;
+		gf_mx_v(pool->mx);
+
+		nb_frames = ce->dec->nb_dec_frames;
+		/*the entry and its codec may be destroyed during the decode call, cf mm_pool_detach*/
+		ce_mx = ce->mx;
+		gf_mx_p(ce_mx);
+		if ((ce->flags & GF_MM_CE_RUNNING) && !ce->dec->force_cb_resize) {
+			e = gf_codec_process(ce->dec, term->frame_duration);
+			if (e && w->task) gf_term_message(term, ce->dec->odm->net_service->url, "Decoding Error", e);
+		}
+		gf_mx_v(ce_mx);
+
+		if (!w->task) {
+			gf_mx_del(ce_mx);
+			gf_mx_p(pool->mx);
+			continue;
+		}
+		w->task = NULL;
+
+		gf_mx_p(pool->mx);
+		ce->task_state = GF_MM_TASK_IDLE;
+		if (pool->nb_done_waiters) {
+			gf_sema_notify(pool->done_sema, pool->nb_done_waiters);
+			pool->nb_done_waiters = 0;
+		}
+		if (ce->flags & GF_MM_CE_RUNNING) {
+			/*keep decoding as long as frames are produced and the CB is not full, otherwise park the task until woken*/
+			if (ce->task_wake
+			        || ((ce->dec->nb_dec_frames != nb_frames) && ce->dec->CB && (ce->dec->CB->UnitCount < ce->dec->CB->Capacity))
+			   ) {
+				mm_pool_queue_task(pool, ce);
+			}
+		}
+	}
+	gf_mx_v(pool->mx);
+	return 0;
+}
+
+static struct _decoder_pool *mm_pool_new(GF_Terminal *term)
+{
+	u32 i;
+	const char *opt;
+	struct _decoder_pool *pool;
+
+	GF_SAFEALLOC(pool, struct _decoder_pool);
+	if (!pool) return NULL;
+
+	opt = gf_cfg_get_key(term->user->config, "Systems", "DecoderThreads");
+	if (opt) pool->nb_workers = atoi(opt);
+	if (!pool->nb_workers) {
+		GF_SystemRTInfo rti;
+		memset(&rti, 0, sizeof(GF_SystemRTInfo));
+		gf_sys_get_rti(500, &rti, GF_RTI_SYSTEM_MEMORY_ONLY);
+		pool->nb_workers = rti.nb_cores ? rti.nb_cores : 2;
+	}
+
+	pool->tasks = gf_list_new();
+	pool->run_queue = gf_list_new();
+	pool->mx = gf_mx_new("DecoderPool");
+	pool->sema = gf_sema_new(0x7FFFFFFF, 0);
+	pool->done_sema = gf_sema_new(0x7FFFFFFF, 0);
+	pool->workers = (struct _pool_worker *) gf_malloc(sizeof(struct _pool_worker) * pool->nb_workers);
+	memset(pool->workers, 0, sizeof(struct _pool_worker) * pool->nb_workers);
+	pool->running = GF_TRUE;
+	term->dec_pool = pool;
+
+	for (i=0; i<pool->nb_workers; i++) {
+		pool->workers[i].term = term;
+		pool->workers[i].th = gf_th_new("DecoderPool");
+		gf_th_run(pool->workers[i].th, MM_PoolWorker, &pool->workers[i]);
+		gf_th_set_priority(pool->workers[i].th, term->priority);
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[Terminal] Decoder pool started with %d worker threads\n", pool->nb_workers));
+	return pool;
+}
+
+static void mm_pool_del(GF_Terminal *term)
+{
+	u32 i;
+	struct _decoder_pool *pool = term->dec_pool;
+	if (!pool) return;
+
+	gf_mx_p(pool->mx);
+	pool->running = GF_FALSE;
+	gf_mx_v(pool->mx);
+	gf_sema_notify(pool->sema, pool->nb_workers);
+	for (i=0; i<pool->nb_workers; i++) {
+		gf_th_stop(pool->workers[i].th);
+		gf_th_del(pool->workers[i].th);
+	}
+	gf_free(pool->workers);
+	assert(!gf_list_count(pool->tasks));
+	gf_list_del(pool->tasks);
+	gf_list_del(pool->run_queue);
+	gf_sema_del(pool->sema);
+	gf_sema_del(pool->done_sema);
+	gf_mx_del(pool->mx);
+	gf_free(pool);
+	term->dec_pool = NULL;
+}
+
+/*only audio and video decoders are scheduled on the pool, systems decoders stay on the media manager thread*/
+static Bool mm_pool_eligible(GF_Codec *codec)
+{
+	if (codec->flags & GF_ESM_CODEC_IS_RAW_MEDIA) return GF_FALSE;
+	if ((codec->type==GF_STREAM_AUDIO) || (codec->type==GF_STREAM_VISUAL)) return GF_TRUE;
+	return GF_FALSE;
+}
+
+static void mm_pool_attach(GF_Terminal *term, CodecEntry *ce)
+{
+	ce->flags |= GF_MM_CE_POOLED;
+	ce->mx = gf_mx_new(ce->dec->decio ? ce->dec->decio->module_name : "RAW");
+	ce->task_state = GF_MM_TASK_IDLE;
+	gf_mx_p(term->dec_pool->mx);
+	gf_list_add(term->dec_pool->tasks, ce);
+	gf_mx_v(term->dec_pool->mx);
+}
+
+static void mm_pool_detach(GF_Terminal *term, CodecEntry *ce)
+{
+	struct _decoder_pool *pool = term->dec_pool;
+	gf_mx_p(pool->mx);
+	if (ce->task_state == GF_MM_TASK_QUEUED) {
+		gf_list_del_item(pool->run_queue, ce);
+		ce->task_state = GF_MM_TASK_IDLE;
+	}
+	if ((ce->task_state == GF_MM_TASK_ACTIVE) && (ce->task_thread_id == gf_th_id())) {
+		u32 i;
+		/*detached from its own decode call (codec removed from a decoder callback): the worker cannot be waited for,
+		hand it over the entry mutex and tell it not to touch the entry once back*/
+		for (i=0; i<pool->nb_workers; i++) {
+			if (pool->workers[i].task == ce) pool->workers[i].task = NULL;
+		}
+		ce->task_state = GF_MM_TASK_IDLE;
+		gf_list_del_item(pool->tasks, ce);
+		gf_mx_v(pool->mx);
+
+		ce->mx = NULL;
+		ce->flags &= ~GF_MM_CE_POOLED;
+		return;
+	}
+	/*wait for the worker to be done with the task*/
+	while (ce->task_state == GF_MM_TASK_ACTIVE) {
+		pool->nb_done_waiters++;
+		gf_mx_v(pool->mx);
+		gf_sema_wait(pool->done_sema);
+		gf_mx_p(pool->mx);
+	}
+	gf_list_del_item(pool->tasks, ce);
+	gf_mx_v(pool->mx);
+
+	gf_mx_del(ce->mx);
+	ce->mx = NULL;
+	ce->flags &= ~GF_MM_CE_POOLED;
+}
+
+static void mm_pool_start_task(GF_Terminal *term, CodecEntry *ce)
+{
+	gf_mx_p(term->dec_pool->mx);
+	mm_pool_queue_task(term->dec_pool, ce);
+	gf_mx_v(term->dec_pool->mx);
+}
+
+static CodecEntry *mm_get_codec(GF_List *list, GF_Codec *codec);
+
+void gf_term_wake_codec(GF_Codec *codec)
+{
+	u32 i;
+	CodecEntry *ce;
+	GF_Terminal *term;
+	struct _decoder_pool *pool;
+	if (!codec || !codec->odm) return;
+	term = codec->odm->term;
+	pool = term->dec_pool;
+
+	if (pool) {
+		gf_mx_p(pool->mx);
+		i=0;
+		while ((ce = (CodecEntry*)gf_list_enum(pool->tasks, &i))) {
+			if (ce->dec != codec) continue;
+			if (ce->flags & GF_MM_CE_RUNNING) mm_pool_queue_task(pool, ce);
+			break;
+		}
+		gf_mx_v(pool->mx);
+		if (ce) return;
+	}
+
+	/*called from network and compositor threads: the entry is looked up and signaled under the wake mutex, so that it cannot be
+	removed or have its semaphore destroyed meanwhile. The media manager mutex cannot be used, it is held while decoding*/
+	gf_mx_p(term->mm_wake_mx);
+	ce = mm_get_codec(term->codecs, codec);
+	if (ce && (ce->flags & GF_MM_CE_RUNNING)) {
+		if (ce->flags & GF_MM_CE_THREADED) {
+			mm_signal(ce->sema, &ce->wake_pending);
+		} else {
+			mm_signal(term->mm_wake, &term->mm_wake_pending);
+		}
+	}
+	gf_mx_v(term->mm_wake_mx);
+}
+
+void gf_term_wake_scheduler(GF_Terminal *term)
+{
+	mm_signal(term->mm_wake, &term->mm_wake_pending);
+}
+
 GF_Err gf_term_init_scheduler(GF_Terminal *term, u32 threading_mode)
 {
 	term->mm_mx = gf_mx_new("MediaManager");
+	term->mm_wake_mx = gf_mx_new("MediaManagerWake");
 	term->codecs = gf_list_new();
 
 	term->frame_duration = 33;
@@ -66,14 +468,22 @@ GF_Err gf_term_init_scheduler(GF_Terminal *term, u32 threading_mode)
 	case GF_TERM_THREAD_MULTI:
 		term->flags |= GF_TERM_MULTI_THREAD;
 		break;
+	case GF_TERM_THREAD_POOL:
+		term->flags |= GF_TERM_POOL_THREAD;
+		break;
 	default:
 		break;
 	}
 
-	if (term->user->init_flags & GF_TERM_NO_DECODER_THREAD)
+	if (term->user->init_flags & GF_TERM_NO_DECODER_THREAD) {
+		term->flags &= ~GF_TERM_POOL_THREAD;
 		return GF_OK;
+	}
+	if (term->flags & GF_TERM_POOL_THREAD)
+		mm_pool_new(term);
 
 	term->mm_thread = gf_th_new("MediaManager");
+	term->mm_wake = gf_sema_new(0x7FFFFFFF, 0);
 	term->flags |= GF_TERM_RUNNING;
 	term->priority = GF_THREAD_PRIORITY_NORMAL;
 	gf_th_run(term->mm_thread, MM_Loop, term);
@@ -86,6 +496,7 @@ void gf_term_stop_scheduler(GF_Terminal *term)
 		u32 count, i;
 
 		term->flags &= ~GF_TERM_RUNNING;
+		gf_sema_notify(term->mm_wake, 1);
 		while (!(term->flags & GF_TERM_DEAD) )
 			gf_sleep(2);
 
@@ -93,8 +504,8 @@ void gf_term_stop_scheduler(GF_Terminal *term)
 		for (i=0; i<count; i++) {
 			CodecEntry *ce = gf_list_get(term->codecs, i);
 			if (ce->flags & GF_MM_CE_DISCARDED) {
+				mm_codec_list_remove(term, i);
 				gf_free(ce);
-				gf_list_rem(term->codecs, i);
 				count--;
 				i--;
 			}
@@ -102,8 +513,11 @@ void gf_term_stop_scheduler(GF_Terminal *term)
 
 		assert(! gf_list_count(term->codecs));
 		gf_th_del(term->mm_thread);
+		gf_sema_del(term->mm_wake);
 	}
+	mm_pool_del(term);
 	gf_list_del(term->codecs);
+	gf_mx_del(term->mm_wake_mx);
 	gf_mx_del(term->mm_mx);
 }
 
@@ -118,6 +532,15 @@ static CodecEntry *mm_get_codec(GF_List *list, GF_Codec *codec)
 }
 
 
+/*decoder and compositor run on different threads, the composition buffer can be used without locking*/
+static void mm_set_lock_free_cb(GF_Terminal *term, GF_Codec *codec)
+{
+	if (!(term->flags & GF_TERM_LOCK_FREE_CB)) return;
+	if (!codec->CB || (codec->flags & GF_ESM_CODEC_IS_RAW_MEDIA)) return;
+	gf_cm_set_lock_free(codec->CB, GF_TRUE);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_MEDIA, ("[Terminal] Using lock-free composition buffer for codec %s\n", codec->decio ? codec->decio->module_name : "RAW"));
+}
+
 void gf_term_add_codec(GF_Terminal *term, GF_Codec *codec)
 {
 	u32 i, count;
@@ -167,11 +590,17 @@ void gf_term_add_codec(GF_Terminal *term, GF_Codec *codec)
 	if (codec->flags & GF_ESM_CODEC_IS_RAW_MEDIA)
 		threaded = 0;
 
+	if ((term->flags & GF_TERM_POOL_THREAD) && term->dec_pool && mm_pool_eligible(codec)) {
+		mm_pool_attach(term, cd);
+		mm_set_lock_free_cb(term, codec);
+		mm_codec_list_insert(term, cd, -1);
+		goto exit;
+	}
+
 	if (threaded) {
-		cd->thread = gf_th_new(cd->dec->decio->module_name);
-		cd->mx = gf_mx_new(cd->dec->decio->module_name);
-		cd->flags |= GF_MM_CE_THREADED;
-		gf_list_add(term->codecs, cd);
+		mm_thread_entry_new(term, cd);
+		mm_set_lock_free_cb(term, codec);
+		mm_codec_list_insert(term, cd, -1);
 		goto exit;
 	}
 
@@ -181,7 +610,7 @@ void gf_term_add_codec(GF_Terminal *term, GF_Codec *codec)
 	count = gf_list_count(term->codecs);
 	for (i=0; i<count; i++) {
 		ptr = (CodecEntry*)gf_list_get(term->codecs, i);
-		if (ptr->flags & GF_MM_CE_THREADED) continue;
+		if (ptr->flags & (GF_MM_CE_THREADED | GF_MM_CE_POOLED)) continue;
 
 		//higher priority, continue
 		if (ptr->dec->Priority > codec->Priority) continue;
@@ -190,38 +619,38 @@ void gf_term_add_codec(GF_Terminal *term, GF_Codec *codec)
 		if (ptr->dec->Priority == codec->Priority) {
 			//we insert audio (0x05) before video (0x04)
 			if (ptr->dec->type < codec->type) {
-				gf_list_insert(term->codecs, cd, i);
+				mm_codec_list_insert(term, cd, i);
 				goto exit;
 			}
 			//same prior, same type: insert after
 			if (ptr->dec->type == codec->type) {
 				if (i+1==count) {
-					gf_list_add(term->codecs, cd);
+					mm_codec_list_insert(term, cd, -1);
 				} else {
-					gf_list_insert(term->codecs, cd, i+1);
+					mm_codec_list_insert(term, cd, i+1);
 				}
 				goto exit;
 			}
 			//we insert video (0x04) after audio (0x05) if next is not audio
 			//last one
 			if (i+1 == count) {
-				gf_list_add(term->codecs, cd);
+				mm_codec_list_insert(term, cd, -1);
 				goto exit;
 			}
 			next = (CodecEntry*)gf_list_get(term->codecs, i+1);
 			//# priority level, insert
-			if ((next->flags & GF_MM_CE_THREADED) || (next->dec->Priority != codec->Priority)) {
-				gf_list_insert(term->codecs, cd, i+1);
+			if ((next->flags & (GF_MM_CE_THREADED | GF_MM_CE_POOLED)) || (next->dec->Priority != codec->Priority)) {
+				mm_codec_list_insert(term, cd, i+1);
 				goto exit;
 			}
 			//same priority level and at least one after : continue
 			continue;
 		}
-		gf_list_insert(term->codecs, cd, i);
+		mm_codec_list_insert(term, cd, i);
 		goto exit;
 	}
 	//if we got here, first in list
-	gf_list_add(term->codecs, cd);
+	mm_codec_list_insert(term, cd, -1);
 
 exit:
 	gf_mx_v(term->mm_mx);
@@ -244,17 +673,14 @@ void gf_term_remove_codec(GF_Terminal *term, GF_Codec *codec)
 		if (ce->dec != codec) continue;
 
 		if (ce->thread) {
-			if (ce->flags & GF_MM_CE_RUNNING) {
-				ce->flags &= ~GF_MM_CE_RUNNING;
-				while (! (ce->flags & GF_MM_CE_DEAD)) gf_sleep(10);
-				ce->flags &= ~GF_MM_CE_DEAD;
-			}
-			gf_th_del(ce->thread);
-			gf_mx_del(ce->mx);
+			mm_thread_entry_del(term, ce);
+		} else if (ce->flags & GF_MM_CE_POOLED) {
+			ce->flags &= ~GF_MM_CE_RUNNING;
+			mm_pool_detach(term, ce);
 		}
 		if (locked) {
+			mm_codec_list_remove(term, i-1);
 			gf_free(ce);
-			gf_list_rem(term->codecs, i-1);
 		} else {
 			ce->flags |= GF_MM_CE_DISCARDED;
 		}
@@ -289,7 +715,9 @@ static void MM_handleServices(GF_Terminal *term)
 
 }
 
-static u32 MM_SimulationStep_Decoder(GF_Terminal *term, u32 *nb_active_decs)
+/*nb_clock_decs is set to the number of active decoders without composition memory, which are only driven by the clock
+and cannot be woken by composition memory or AU events*/
+static u32 MM_SimulationStep_Decoder(GF_Terminal *term, u32 *nb_active_decs, u32 *nb_clock_decs)
 {
 	CodecEntry *ce;
 	GF_Err e;
@@ -303,7 +731,7 @@ static u32 MM_SimulationStep_Decoder(GF_Terminal *term, u32 *nb_active_decs)
 
 	count = gf_list_count(term->codecs);
 	time_left = term->frame_duration;
-	*nb_active_decs = 0;
+	*nb_active_decs = *nb_clock_decs = 0;
 
 	if (term->last_codec >= count) term->last_codec = 0;
 	remain = count;
@@ -312,7 +740,7 @@ static u32 MM_SimulationStep_Decoder(GF_Terminal *term, u32 *nb_active_decs)
 		ce = (CodecEntry*)gf_list_get(term->codecs, term->last_codec);
 		if (!ce) break;
 
-		if (!(ce->flags & GF_MM_CE_RUNNING) || (ce->flags & GF_MM_CE_THREADED) || ce->dec->force_cb_resize) {
+		if (!(ce->flags & GF_MM_CE_RUNNING) || (ce->flags & (GF_MM_CE_THREADED | GF_MM_CE_POOLED)) || ce->dec->force_cb_resize) {
 			remain--;
 			if (!remain) break;
 			term->last_codec = (term->last_codec + 1) % count;
@@ -322,6 +750,7 @@ static u32 MM_SimulationStep_Decoder(GF_Terminal *term, u32 *nb_active_decs)
 		if (ce->dec->PriorityBoost) time_slice *= 2;
 		time_taken = gf_sys_clock();
 		(*nb_active_decs) ++;
+		if (!ce->dec->CB) (*nb_clock_decs) ++;
 		e = gf_codec_process(ce->dec, time_slice);
 		time_taken = gf_sys_clock() - time_taken;
 		/*avoid signaling errors too often...*/
@@ -333,8 +762,8 @@ static u32 MM_SimulationStep_Decoder(GF_Terminal *term, u32 *nb_active_decs)
 		}
 #endif
 		if (ce->flags & GF_MM_CE_DISCARDED) {
+			mm_codec_list_remove(term, term->last_codec);
 			gf_free(ce);
-			gf_list_rem(term->codecs, term->last_codec);
 			count--;
 			if (!count)
 				break;
@@ -373,13 +802,13 @@ u32 MM_Loop(void *par)
 //	GF_LOG(GF_LOG_DEBUG, GF_LOG_RTI, ("(RTI] Terminal Cycle Log\tServices\tDecoders\tCompositor\tSleep\n"));
 
 	while (term->flags & GF_TERM_RUNNING) {
-		u32 nb_decs = 0;
+		u32 nb_decs = 0, nb_clock_decs = 0;
 		u32 left = 0;
 
 		if (!no_compositor_thread) 
 			MM_handleServices(term);
 
-		if (do_codec) left = MM_SimulationStep_Decoder(term, &nb_decs);
+		if (do_codec) left = MM_SimulationStep_Decoder(term, &nb_decs, &nb_clock_decs);
 		else left = term->frame_duration;
 
 		if (do_scene) {
@@ -399,9 +828,9 @@ u32 MM_Loop(void *par)
 				gf_sleep(0);
 			} else {
 				if (left==term->frame_duration) {
-					//if nothing was done during this pass but we have active decoder, just yield. We don't want to sleep since
-					//composition memory could be released at any time. We should have a signal here, rather than a wait
-					gf_sleep(nb_decs ? 0 : term->frame_duration/2);
+					//if nothing was done during this pass, wait for composition memory release, new data or end of buffering
+					//on one of our decoders. Decoders only driven by the clock are checked every ms
+					mm_wait(term->mm_wake, &term->mm_wake_pending, nb_clock_decs ? 1 : term->frame_duration/2);
 				}
 			}
 		}
@@ -419,6 +848,7 @@ u32 RunSingleDec(void *ptr)
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[MediaDecoder %d] Entering thread ID %d\n", ce->dec->odm->OD->objectDescriptorID, gf_th_id() ));
 
 	while (ce->flags & GF_MM_CE_RUNNING) {
+		u32 timeout;
 		time_taken = gf_sys_clock_high_res();
 		if (!ce->dec->force_cb_resize) {
 			gf_mx_p(ce->mx);
@@ -438,7 +868,9 @@ u32 RunSingleDec(void *ptr)
 		if (ce->dec->PriorityBoost) continue;
 
 		if (time_taken<20) {
-			gf_sleep(1);
+			/*wait for composition memory release or new data, decoders without composition memory are only driven by the clock*/
+			timeout = ce->dec->CB ? ce->dec->odm->term->frame_duration : 1;
+			mm_wait(ce->sema, &ce->wake_pending, timeout);
 		}
 	}
 	ce->flags |= GF_MM_CE_DEAD;
@@ -481,11 +913,16 @@ void gf_term_start_codec(GF_Codec *codec, Bool is_resume)
 		if (ce->thread) {
 			gf_th_run(ce->thread, RunSingleDec, ce);
 			gf_th_set_priority(ce->thread, term->priority);
-		} else {
+		} else if (!(ce->flags & GF_MM_CE_POOLED)) {
 			term->cumulated_priority += ce->dec->Priority+1;
 		}
 	}
-
+	if (ce->flags & GF_MM_CE_POOLED)
+		mm_pool_start_task(term, ce);
+	else if (ce->flags & GF_MM_CE_THREADED)
+		mm_signal(ce->sema, &ce->wake_pending);
+	else
+		gf_term_wake_scheduler(term);
 
 	/*unlock dec*/
 	if (ce->mx)
@@ -551,7 +988,9 @@ void gf_term_stop_codec(GF_Codec *codec, u32 reason)
 	/*don't wait for end of thread since this can be triggered within the decoding thread*/
 	if (ce->flags & GF_MM_CE_RUNNING) {
 		ce->flags &= ~GF_MM_CE_RUNNING;
-		if (!ce->thread)
+		if (ce->thread)
+			gf_sema_notify(ce->sema, 1);
+		else if (!(ce->flags & GF_MM_CE_POOLED))
 			term->cumulated_priority -= codec->Priority+1;
 	}
 	if (codec->CB) gf_cm_abort_buffering(codec->CB);
@@ -564,39 +1003,51 @@ void gf_term_stop_codec(GF_Codec *codec, u32 reason)
 void gf_term_set_threading(GF_Terminal *term, u32 mode)
 {
 	u32 i;
-	Bool thread_it, restart_it;
+	Bool thread_it, pool_it, restart_it;
 	CodecEntry *ce;
 
 	switch (mode) {
 	case GF_TERM_THREAD_SINGLE:
 		if (term->flags & GF_TERM_SINGLE_THREAD) return;
-		term->flags &= ~GF_TERM_MULTI_THREAD;
+		term->flags &= ~(GF_TERM_MULTI_THREAD | GF_TERM_POOL_THREAD);
 		term->flags |= GF_TERM_SINGLE_THREAD;
 		break;
 	case GF_TERM_THREAD_MULTI:
 		if (term->flags & GF_TERM_MULTI_THREAD) return;
-		term->flags &= ~GF_TERM_SINGLE_THREAD;
+		term->flags &= ~(GF_TERM_SINGLE_THREAD | GF_TERM_POOL_THREAD);
 		term->flags |= GF_TERM_MULTI_THREAD;
 		break;
+	case GF_TERM_THREAD_POOL:
+		if (term->flags & GF_TERM_POOL_THREAD) return;
+		/*no decoder threads at all in this mode*/
+		if (!term->mm_thread) return;
+		term->flags &= ~(GF_TERM_SINGLE_THREAD | GF_TERM_MULTI_THREAD);
+		term->flags |= GF_TERM_POOL_THREAD;
+		break;
 	default:
-		if (!(term->flags & (GF_TERM_MULTI_THREAD | GF_TERM_SINGLE_THREAD) ) ) return;
+		if (!(term->flags & (GF_TERM_MULTI_THREAD | GF_TERM_SINGLE_THREAD | GF_TERM_POOL_THREAD) ) ) return;
 		term->flags &= ~GF_TERM_SINGLE_THREAD;
 		term->flags &= ~GF_TERM_MULTI_THREAD;
+		term->flags &= ~GF_TERM_POOL_THREAD;
 		break;
 	}
 
 	gf_mx_p(term->mm_mx);
 
+	/*the pool is kept once created, idle workers don't consume any CPU*/
+	if ((mode == GF_TERM_THREAD_POOL) && !term->dec_pool) mm_pool_new(term);
 
 	i=0;
 	while ((ce = (CodecEntry*)gf_list_enum(term->codecs, &i))) {
-		thread_it = 0;
+		thread_it = pool_it = 0;
 		/*free mode, decoder wants threading - do */
 		if ((mode == GF_TERM_THREAD_FREE) && (ce->flags & GF_MM_CE_REQ_THREAD)) thread_it = 1;
 		else if (mode == GF_TERM_THREAD_MULTI) thread_it = 1;
+		else if (mode == GF_TERM_THREAD_POOL) pool_it = mm_pool_eligible(ce->dec);
 
 		if (thread_it && (ce->flags & GF_MM_CE_THREADED)) continue;
-		if (!thread_it && !(ce->flags & GF_MM_CE_THREADED)) continue;
+		if (pool_it && (ce->flags & GF_MM_CE_POOLED)) continue;
+		if (!thread_it && !pool_it && !(ce->flags & (GF_MM_CE_THREADED | GF_MM_CE_POOLED))) continue;
 
 		restart_it = 0;
 		if (ce->flags & GF_MM_CE_RUNNING) {
@@ -606,21 +1057,21 @@ void gf_term_set_threading(GF_Terminal *term, u32 mode)
 
 		if (ce->flags & GF_MM_CE_THREADED) {
 			/*wait for thread to die*/
-			while (!(ce->flags & GF_MM_CE_DEAD)) gf_sleep(1);
-			ce->flags &= ~GF_MM_CE_DEAD;
-			gf_th_del(ce->thread);
-			ce->thread = NULL;
-			gf_mx_del(ce->mx);
-			ce->mx = NULL;
-			ce->flags &= ~GF_MM_CE_THREADED;
+			if (restart_it) {
+				gf_sema_notify(ce->sema, 1);
+				while (!(ce->flags & GF_MM_CE_DEAD)) gf_sleep(1);
+			}
+			mm_thread_entry_del(term, ce);
+		} else if (ce->flags & GF_MM_CE_POOLED) {
+			mm_pool_detach(term, ce);
 		} else {
 			term->cumulated_priority -= ce->dec->Priority+1;
 		}
 
 		if (thread_it) {
-			ce->flags |= GF_MM_CE_THREADED;
-			ce->thread = gf_th_new(ce->dec->decio->module_name);
-			ce->mx = gf_mx_new(ce->dec->decio->module_name);
+			mm_thread_entry_new(term, ce);
+		} else if (pool_it) {
+			mm_pool_attach(term, ce);
 		}
 
 		if (restart_it) {
@@ -628,6 +1079,8 @@ void gf_term_set_threading(GF_Terminal *term, u32 mode)
 			if (ce->thread) {
 				gf_th_run(ce->thread, RunSingleDec, ce);
 				gf_th_set_priority(ce->thread, term->priority);
+			} else if (ce->flags & GF_MM_CE_POOLED) {
+				mm_pool_start_task(term, ce);
 			} else {
 				term->cumulated_priority += ce->dec->Priority+1;
 			}
@@ -681,6 +1134,10 @@ void gf_term_set_priority(GF_Terminal *term, s32 Priority)
 		if (ce->flags & GF_MM_CE_THREADED)
 			gf_th_set_priority(ce->thread, Priority);
 	}
+	if (term->dec_pool) {
+		for (i=0; i<term->dec_pool->nb_workers; i++)
+			gf_th_set_priority(term->dec_pool->workers[i].th, Priority);
+	}
 	term->priority = Priority;
 	gf_mx_v(term->mm_mx);
 }
@@ -688,14 +1145,14 @@ void gf_term_set_priority(GF_Terminal *term, s32 Priority)
 GF_EXPORT
 u32 gf_term_process_step(GF_Terminal *term)
 {
-	u32 nb_decs=0;
+	u32 nb_decs=0, nb_clock_decs=0;
 	u32 sleep_time=0;
 	u32 dec_time = 0, step_start_time = gf_sys_clock();
 
 	MM_handleServices(term);
 
 	if (term->flags & GF_TERM_NO_DECODER_THREAD) {
-		MM_SimulationStep_Decoder(term, &nb_decs);
+		MM_SimulationStep_Decoder(term, &nb_decs, &nb_clock_decs);
 		dec_time = gf_sys_clock() - step_start_time;
 	}
 
@@ -31,6 +31,20 @@
 #include "media_memory.h"
 #include "media_control.h"
 
+/*unit count updates in lock-free mode - full memory barriers*/
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define cm_atomic_inc(_v)	_InterlockedIncrement((long volatile *) (_v))
+#define cm_atomic_dec(_v)	_InterlockedDecrement((long volatile *) (_v))
+#define cm_atomic_get(_v)	((u32) _InterlockedOr((long volatile *) (_v), 0))
+#elif defined(__GNUC__)
+#define cm_atomic_inc(_v)	__sync_add_and_fetch((_v), 1)
+#define cm_atomic_dec(_v)	__sync_sub_and_fetch((_v), 1)
+#define cm_atomic_get(_v)	__sync_add_and_fetch((_v), 0)
+#else
+#define GPAC_DISABLE_CM_LOCK_FREE
+#endif
+
 GF_DBUnit *gf_db_unit_new()
 {
 	GF_DBUnit *tmp;
@@ -167,6 +181,19 @@ void gf_cm_del(GF_CompositionMemory *cb)
 
 void gf_cm_rewind_input(GF_CompositionMemory *cb)
 {
+#ifndef GPAC_DISABLE_CM_LOCK_FREE
+	if (cb->lock_free) {
+		/*the unit may be read by the consumer, rewind under lock (only used when seeking in pause)*/
+		gf_odm_lock(cb->odm, 1);
+		if (!cb->reorder_count && cb->UnitCount) {
+			cb->input = cb->input->prev;
+			cb->input->dataLength = 0;
+			cm_atomic_dec(&cb->UnitCount);
+		}
+		gf_odm_lock(cb->odm, 0);
+		return;
+	}
+#endif
 	if (cb->UnitCount) {
 		cb->UnitCount--;
 		cb->input = cb->input->prev;
@@ -174,8 +201,131 @@ void gf_cm_rewind_input(GF_CompositionMemory *cb)
 	}
 }
 
+void gf_cm_set_lock_free(GF_CompositionMemory *cb, Bool lock_free)
+{
+#ifndef GPAC_DISABLE_CM_LOCK_FREE
+	/*image buffers are directly modified by the decoder*/
+	if (cb->Capacity==1) lock_free = GF_FALSE;
+	cb->lock_free = lock_free;
+	cb->reorder_count = 0;
+#endif
+}
+
+static void cm_update_stall(u64 *stall_start, u64 *stall_time, Bool stalled)
+{
+	if (stalled) {
+		if (!*stall_start) *stall_start = gf_sys_clock_high_res();
+	} else if (*stall_start) {
+		*stall_time += gf_sys_clock_high_res() - *stall_start;
+		*stall_start = 0;
+	}
+}
+
+void gf_cm_input_stalled(GF_CompositionMemory *cb)
+{
+	cm_update_stall(&cb->producer_stall_start, &cb->producer_stall_time, GF_TRUE);
+}
+
+#ifndef GPAC_DISABLE_CM_LOCK_FREE
+/*input is the first unit of the reorder window, the window is followed by free units*/
+static GF_CMUnit *cm_lock_free_input(GF_CompositionMemory *cb, u32 TS)
+{
+	u32 i;
+	GF_CMUnit *cu = cb->input;
+
+	/*spatial scalability: unit with same TS not yet published*/
+	for (i=0; i<cb->reorder_count; i++) {
+		if (cu->TS == TS) return cu;
+		cu = cu->next;
+	}
+	/*published units belong to the consumer*/
+	if (cm_atomic_get(&cb->UnitCount) + cb->reorder_count >= cb->Capacity) return NULL;
+	cu->TS = TS;
+	return cu;
+}
+
+static void cm_swap_units(GF_CMUnit *a, GF_CMUnit *b)
+{
+	GF_CMUnit tmp;
+	tmp.TS = a->TS;
+	tmp.RenderedLength = a->RenderedLength;
+	tmp.dataLength = a->dataLength;
+	tmp.data = a->data;
+	tmp.sender_ntp = a->sender_ntp;
+	tmp.frame = a->frame;
+
+	a->TS = b->TS;
+	a->RenderedLength = b->RenderedLength;
+	a->dataLength = b->dataLength;
+	a->data = b->data;
+	a->sender_ntp = b->sender_ntp;
+	a->frame = b->frame;
+
+	b->TS = tmp.TS;
+	b->RenderedLength = tmp.RenderedLength;
+	b->dataLength = tmp.dataLength;
+	b->data = tmp.data;
+	b->sender_ntp = tmp.sender_ntp;
+	b->frame = tmp.frame;
+}
+
+static void cm_publish_input(GF_CompositionMemory *cb)
+{
+	cb->input = cb->input->next;
+	cb->reorder_count--;
+	/*barrier: unit content is visible before the count*/
+	cm_atomic_inc(&cb->UnitCount);
+}
+
+static void cm_lock_free_unlock_input(GF_CompositionMemory *cb, GF_CMUnit *cu, u32 cu_size, u32 reorder_window)
+{
+	Bool is_new = cu->dataLength ? GF_FALSE : GF_TRUE;
+
+	cu->dataLength = cu_size;
+	cu->RenderedLength = 0;
+	/*enhancement of a unit still in the window*/
+	if (!is_new) return;
+
+	cb->reorder_count++;
+	/*insert in CTS order in the window. Units are swapped by content, the window is never accessed by the consumer*/
+	while ((cu != cb->input) && (cu->prev->TS > cu->TS)) {
+		cm_swap_units(cu->prev, cu);
+		cu = cu->prev;
+	}
+	/*publish once the window is full or when no more units are free*/
+	while (cb->reorder_count) {
+		if ((cb->reorder_count <= reorder_window) && (cm_atomic_get(&cb->UnitCount) + cb->reorder_count < cb->Capacity))
+			break;
+		cm_publish_input(cb);
+	}
+}
+
+static void cm_lock_free_flush(GF_CompositionMemory *cb)
+{
+	while (cb->reorder_count)
+		cm_publish_input(cb);
+}
+#endif
+
+static GF_CMUnit *cm_lock_input(GF_CompositionMemory *cb, u32 TS, Bool codec_reordering);
+
 /*access to the input buffer - return NULL if no input is available (buffer full)*/
 GF_CMUnit *gf_cm_lock_input(GF_CompositionMemory *cb, u32 TS, Bool codec_reordering)
+{
+	GF_CMUnit *cu;
+#ifndef GPAC_DISABLE_CM_LOCK_FREE
+	if (cb->lock_free) {
+		cu = cm_lock_free_input(cb, TS);
+		cm_update_stall(&cb->producer_stall_start, &cb->producer_stall_time, cu ? GF_FALSE : GF_TRUE);
+		return cu;
+	}
+#endif
+	cu = cm_lock_input(cb, TS, codec_reordering);
+	cm_update_stall(&cb->producer_stall_start, &cb->producer_stall_time, cu ? GF_FALSE : GF_TRUE);
+	return cu;
+}
+
+static GF_CMUnit *cm_lock_input(GF_CompositionMemory *cb, u32 TS, Bool codec_reordering)
 {
 	GF_CMUnit *cu;
 	if (codec_reordering) {
@@ -333,6 +483,8 @@ void gf_cm_unlock_input(GF_CompositionMemory *cb, GF_CMUnit *cu, u32 cu_size, Bo
 {
 	/*nothing dispatched, ignore*/
 	if (!cu_size || (!cu->data && !cu->frame && !cb->pY) ) {
+		/*unit already in the reorder window*/
+		if (cb->lock_free && cu->dataLength) return;
 		if (cu->frame) {
 			cu->frame->Release(cu->frame);
 			cu->frame = NULL;
@@ -341,6 +493,25 @@ void gf_cm_unlock_input(GF_CompositionMemory *cb, GF_CMUnit *cu, u32 cu_size, Bo
 		cu->TS = 0;
 		return;
 	}
+#ifndef GPAC_DISABLE_CM_LOCK_FREE
+	if (cb->lock_free) {
+		/*codecs not reordering frames and not dispatching in CTS order are only visual ones (temporal scalability)*/
+		cm_lock_free_unlock_input(cb, cu, cu_size, (codec_reordering || (cb->odm->codec->type != GF_STREAM_VISUAL)) ? 0 : GF_CM_REORDER_WINDOW);
+		/*buffering state is shared with the consumer, lock only for the transition*/
+		if ( (cb->Status == CB_BUFFER) && (cm_atomic_get(&cb->UnitCount) + cb->reorder_count >= cb->Capacity) ) {
+			gf_odm_lock(cb->odm, 1);
+			cm_lock_free_flush(cb);
+			if (cb->Status == CB_BUFFER) {
+				cb->Status = CB_BUFFER_DONE;
+				if (cb->odm->codec->type == GF_STREAM_AUDIO)
+					cb_set_buffer_off(cb);
+				gf_term_wake_scheduler(cb->odm->term);
+			}
+			gf_odm_lock(cb->odm, 0);
+		}
+		return;
+	}
+#endif
 	gf_odm_lock(cb->odm, 1);
 //		assert(cu->frame);
 
@@ -366,6 +537,9 @@ void gf_cm_unlock_input(GF_CompositionMemory *cb, GF_CMUnit *cu, u32 cu_size, Bo
 			//for audio, turn off buffering now. For video, we will wait for the first frame to be drawn
 			if (cb->odm->codec->type == GF_STREAM_AUDIO)
 				cb_set_buffer_off(cb);
+
+			/*decoders waiting for the end of buffering can resume*/
+			gf_term_wake_scheduler(cb->odm->term);
 		}
 
 		//new FPS regulation doesn't need this signaling
@@ -412,7 +586,9 @@ void gf_cm_reset(GF_CompositionMemory *cb)
 		cu = cu->next;
 	}
 	cb->UnitCount = 0;
+	cb->reorder_count = 0;
 	cb->HasSeenEOS = 0;
+	cb->producer_stall_start = cb->consumer_stall_start = 0;
 
 	if (cb->odm->mo) cb->odm->mo->timestamp = 0;
 
@@ -469,6 +645,7 @@ void gf_cm_resize(GF_CompositionMemory *cb, u32 newCapacity)
 	}
 	
 	cb->UnitCount = 0;
+	cb->reorder_count = 0;
 	cb->output = cb->input;
 	gf_odm_lock(cb->odm, 0);
 }
@@ -493,6 +670,7 @@ void gf_cm_reinit(GF_CompositionMemory *cb, u32 UnitSize, u32 Capacity)
 	cu = NULL;
 	cb->Capacity = Capacity;
 	cb->UnitSize = UnitSize;
+	cb->reorder_count = 0;
 
 	prev = NULL;
 	i = 1;
@@ -520,6 +698,21 @@ void gf_cm_reinit(GF_CompositionMemory *cb, u32 UnitSize, u32 Capacity)
 	gf_odm_lock(cb->odm, 0);
 }
 
+static GFINLINE u32 cm_unit_count(GF_CompositionMemory *cb)
+{
+#ifndef GPAC_DISABLE_CM_LOCK_FREE
+	if (cb->lock_free) return cm_atomic_get(&cb->UnitCount);
+#endif
+	return cb->UnitCount;
+}
+
+/*checks if a unit is ready after the output one - in lock-free mode, units after the last published one may be filled but not ready*/
+static GFINLINE Bool cm_has_next_output(GF_CompositionMemory *cb)
+{
+	if (cb->lock_free) return (cm_unit_count(cb) > 1) ? GF_TRUE : GF_FALSE;
+	return cb->output->next->dataLength ? GF_TRUE : GF_FALSE;
+}
+
 /*access to the first available CU for rendering
 this is a blocking call since input may change the output (temporal scalability)*/
 GF_CMUnit *gf_cm_get_output(GF_CompositionMemory *cb)
@@ -542,7 +735,10 @@ GF_CMUnit *gf_cm_get_output(GF_CompositionMemory *cb)
 	}
 
 	/*no output*/
-	if (!cb->UnitCount || !cb->output->dataLength) {
+	if (!cm_unit_count(cb) || !cb->output->dataLength) {
+		if (!cb->HasSeenEOS && (cb->Status == CB_PLAY))
+			cm_update_stall(&cb->consumer_stall_start, &cb->consumer_stall_time, GF_TRUE);
+
 		if ((cb->Status != CB_STOP) && cb->HasSeenEOS && (cb->odm && cb->odm->codec)) {
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_MEDIA, ("[ODM%d] Switching composition memory to stop state - time %d\n", cb->odm->OD->objectDescriptorID, (u32) cb->odm->media_stop_time));
 
@@ -569,7 +765,7 @@ GF_CMUnit *gf_cm_get_output(GF_CompositionMemory *cb)
 		}
 
 		/*handle visual object - EOS if no more data (we keep the last CU for rendering, so check next one)*/
-		if (cb->HasSeenEOS && (cb->odm->codec->type == GF_STREAM_VISUAL) && (!cb->output->next->dataLength || (cb->Capacity==1))) {
+		if (cb->HasSeenEOS && (cb->odm->codec->type == GF_STREAM_VISUAL) && (!cm_has_next_output(cb) || (cb->Capacity==1))) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[ODM%d] Switching composition memory to stop state - time %d\n", cb->odm->OD->objectDescriptorID, (u32) cb->odm->media_stop_time));
 			if (cb->Status==CB_BUFFER_DONE) {
 				gf_clock_buffer_off(cb->odm->codec->ck);
@@ -587,6 +783,7 @@ GF_CMUnit *gf_cm_get_output(GF_CompositionMemory *cb)
 		cb->LastRenderedNTPDiff = gf_net_get_ntp_diff_ms(cb->output->sender_ntp);
 		cb->LastRenderedNTP = cb->output->sender_ntp;
 	}
+	cm_update_stall(&cb->consumer_stall_start, &cb->consumer_stall_time, GF_FALSE);
 
 	return cb->output;
 }
@@ -617,7 +814,7 @@ void gf_cm_drop_output(GF_CompositionMemory *cb)
 
 	/*on visual streams (except raw oness), always keep the last AU*/
 	if (cb->output->dataLength && (cb->odm->codec->type == GF_STREAM_VISUAL) ) {
-		if ( !cb->output->next->dataLength || (cb->Capacity == 1) )  {
+		if ( !cm_has_next_output(cb) || (cb->Capacity == 1) )  {
 			Bool no_drop = 1;
 			if (cb->no_allocation ) {
 				if (cb->odm->term->bench_mode)
@@ -643,7 +840,13 @@ void gf_cm_drop_output(GF_CompositionMemory *cb)
 	}
 	cb->output->TS = 0;
 	cb->output = cb->output->next;
-	cb->UnitCount -= 1;
+#ifndef GPAC_DISABLE_CM_LOCK_FREE
+	/*barrier: the unit is released to the producer once we are done with it*/
+	if (cb->lock_free)
+		cm_atomic_dec(&cb->UnitCount);
+	else
+#endif
+		cb->UnitCount -= 1;
 
 	if (!cb->HasSeenEOS && cb->UnitCount <= cb->Min) {
 		cb->odm->codec->PriorityBoost = 1;
@@ -652,6 +855,8 @@ void gf_cm_drop_output(GF_CompositionMemory *cb)
 	if (cb->odm->raw_frame_sema) {
 		gf_sema_notify(cb->odm->raw_frame_sema, 1);
 	}
+	/*space available in CB, decoder can resume*/
+	gf_term_wake_codec(cb->odm->codec);
 }
 
 void gf_cm_set_status(GF_CompositionMemory *cb, u32 Status)
@@ -707,6 +912,10 @@ void gf_cm_set_status(GF_CompositionMemory *cb, u32 Status)
 void gf_cm_set_eos(GF_CompositionMemory *cb)
 {
 	gf_odm_lock(cb->odm, 1);
+#ifndef GPAC_DISABLE_CM_LOCK_FREE
+	/*no more units to reorder*/
+	if (cb->lock_free) cm_lock_free_flush(cb);
+#endif
 	/*we may have a pb if the stream is so short that the EOS is signaled
 	while we're buffering. In this case we shall turn the clock on and
 	keep a trace of the EOS notif*/
@@ -739,6 +948,7 @@ Bool gf_cm_is_running(GF_CompositionMemory *cb)
 
 	if ((cb->odm->codec->type == GF_STREAM_VISUAL)
 	        && (cb->Status == CB_STOP)
+	        && (!cb->lock_free || cm_unit_count(cb))
 	        && cb->output->dataLength) return 1;
 
 	return 0;
@@ -140,8 +140,21 @@ struct _composition_memory
 
 	u64 LastRenderedNTP;
 	s32 LastRenderedNTPDiff;
+
+	/*single producer / single consumer mode: units are published by the decoder without locking the object manager,
+	the consumer only sees published units (UnitCount). Units delivered out of CTS order by non-reordering visual codecs
+	are kept in a small reorder window starting at input before being published*/
+	Bool lock_free;
+	u32 reorder_count;
+
+	/*stall statistics in microseconds: time spent by the decoder with a full CB, and by the compositor with an empty CB*/
+	u64 producer_stall_start, producer_stall_time;
+	u64 consumer_stall_start, consumer_stall_time;
 };
 
+/*max number of units kept for reordering in lock-free mode*/
+#define GF_CM_REORDER_WINDOW	3
+
 /*a composition buffer only has fixed-size unit*/
 GF_CompositionMemory *gf_cm_new(u32 UnitSize, u32 capacity, Bool no_allocation);
 void gf_cm_del(GF_CompositionMemory *cb);
@@ -156,6 +169,10 @@ of buffers*/
 void gf_cm_unlock_input(GF_CompositionMemory *cb, GF_CMUnit *cu, u32 cu_size, Bool codec_reordering);
 /*rewind input of 1 unit - used when doing precise seeking*/
 void gf_cm_rewind_input(GF_CompositionMemory *cb);
+/*switches the composition memory to lock-free mode - must be called before any unit is dispatched*/
+void gf_cm_set_lock_free(GF_CompositionMemory *cb, Bool lock_free);
+/*signals the decoder cannot output because the CB is full (stall time accounting)*/
+void gf_cm_input_stalled(GF_CompositionMemory *cb);
 
 /*fetch output buffer, NULL if output is empty*/
 GF_CMUnit *gf_cm_get_output(GF_CompositionMemory *cb);
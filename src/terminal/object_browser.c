@@ -319,6 +319,9 @@ GF_Err gf_term_get_object_info(GF_Terminal *term, GF_ObjectManager *odm, GF_Medi
 		if (codec->CB) {
 			info->cb_max_count = codec->CB->Capacity;
 			info->cb_unit_count = codec->CB->UnitCount;
+			info->cb_lock_free = codec->CB->lock_free;
+			info->cb_producer_stall_time = codec->CB->producer_stall_time;
+			info->cb_consumer_stall_time = codec->CB->consumer_stall_time;
 			if (codec->direct_vout) {
 				info->direct_video_memory = 1;
 			}
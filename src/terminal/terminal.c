@@ -375,11 +375,16 @@ static void gf_term_reload_cfg(GF_Terminal *term)
 		}
 		gf_term_set_priority(term, prio);
 
+		sOpt = gf_cfg_get_key(term->user->config, "Systems", "LockFreeCB");
+		if (sOpt && !stricmp(sOpt, "yes")) term->flags |= GF_TERM_LOCK_FREE_CB;
+		else term->flags &= ~GF_TERM_LOCK_FREE_CB;
+
 		sOpt = gf_cfg_get_key(term->user->config, "Systems", "ThreadingPolicy");
 		if (sOpt) {
 			mode = GF_TERM_THREAD_FREE;
 			if (!stricmp(sOpt, "Single")) mode = GF_TERM_THREAD_SINGLE;
 			else if (!stricmp(sOpt, "Multi")) mode = GF_TERM_THREAD_MULTI;
+			else if (!stricmp(sOpt, "Pool")) mode = GF_TERM_THREAD_POOL;
 			gf_term_set_threading(term, mode);
 		}
 	} else {
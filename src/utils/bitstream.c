@@ -301,11 +301,52 @@ u8 gf_bs_read_bit(GF_BitStream *bs)
 
 }
 
+/*loads 8 bytes in big-endian order - compilers turn this into a single load and byte swap*/
+static GFINLINE u64 bs_load_word(const u8 *p)
+{
+	return ((u64)p[0]<<56) | ((u64)p[1]<<48) | ((u64)p[2]<<40) | ((u64)p[3]<<32)
+	       | ((u64)p[4]<<24) | ((u64)p[5]<<16) | ((u64)p[6]<<8) | (u64)p[7];
+}
+
+/*fast path for memory read streams: serves up to 32 bits from the remaining bits of the current byte
+and a 64-bit word loaded from the buffer, then restores the byte-oriented state (current byte shifted by
+the number of bits consumed) so that all other functions work unchanged.
+Reads crossing the last 8 bytes of the buffer go through the byte reader, which handles EOS*/
+static GFINLINE Bool bs_read_int_mem(GF_BitStream *bs, u32 nBits, u32 *val)
+{
+	u64 word;
+	u32 avail, rem, need, nb_bytes, last_bits;
+
+	avail = 8 - bs->nbBits;
+	rem = (bs->current & 0xFF) >> bs->nbBits;
+	if (nBits <= avail) {
+		*val = rem >> (avail - nBits);
+		bs->current <<= nBits;
+		bs->nbBits += nBits;
+		return GF_TRUE;
+	}
+	if (bs->position + 8 > bs->size) return GF_FALSE;
+
+	need = nBits - avail;
+	nb_bytes = (need + 7) >> 3;
+	word = bs_load_word((u8 *) bs->original + bs->position);
+	*val = (u32) ( ((u64) rem << need) | (word >> (64 - need)) );
+
+	last_bits = need - 8*(nb_bytes-1);
+	bs->current = ((u32) (word >> (64 - 8*nb_bytes)) & 0xFF) << last_bits;
+	bs->nbBits = last_bits;
+	bs->position += nb_bytes;
+	return GF_TRUE;
+}
+
 GF_EXPORT
 u32 gf_bs_read_int(GF_BitStream *bs, u32 nBits)
 {
 	u32 ret;
 
+	if ((bs->bsmode == GF_BITSTREAM_READ) && nBits && (nBits <= 32) && bs_read_int_mem(bs, nBits, &ret))
+		return ret;
+
 #ifndef NO_OPTS
 	if (nBits + bs->nbBits <= 8) {
 		bs->nbBits += nBits;
@@ -356,6 +397,11 @@ u32 gf_bs_read_u16(GF_BitStream *bs)
 {
 	u32 ret;
 	assert(bs->nbBits==8);
+	if ((bs->bsmode == GF_BITSTREAM_READ) && (bs->position + 2 <= bs->size)) {
+		u8 *p = (u8 *) bs->original + bs->position;
+		bs->position += 2;
+		return ((u32)p[0]<<8) | (u32)p[1];
+	}
 	ret = BS_ReadByte(bs);
 	ret<<=8;
 	ret |= BS_ReadByte(bs);
@@ -368,6 +414,11 @@ u32 gf_bs_read_u24(GF_BitStream *bs)
 {
 	u32 ret;
 	assert(bs->nbBits==8);
+	if ((bs->bsmode == GF_BITSTREAM_READ) && (bs->position + 3 <= bs->size)) {
+		u8 *p = (u8 *) bs->original + bs->position;
+		bs->position += 3;
+		return ((u32)p[0]<<16) | ((u32)p[1]<<8) | (u32)p[2];
+	}
 	ret = BS_ReadByte(bs);
 	ret<<=8;
 	ret |= BS_ReadByte(bs);
@@ -381,6 +432,11 @@ u32 gf_bs_read_u32(GF_BitStream *bs)
 {
 	u32 ret;
 	assert(bs->nbBits==8);
+	if ((bs->bsmode == GF_BITSTREAM_READ) && (bs->position + 4 <= bs->size)) {
+		u8 *p = (u8 *) bs->original + bs->position;
+		bs->position += 4;
+		return ((u32)p[0]<<24) | ((u32)p[1]<<16) | ((u32)p[2]<<8) | (u32)p[3];
+	}
 	ret = BS_ReadByte(bs);
 	ret<<=8;
 	ret |= BS_ReadByte(bs);
@@ -408,11 +464,12 @@ u64 gf_bs_read_long_int(GF_BitStream *bs, u32 nBits)
 	if (nBits>64) {
 		gf_bs_read_long_int(bs, nBits-64);
 		ret = gf_bs_read_long_int(bs, 64);
+	} else if (nBits>32) {
+		ret = gf_bs_read_int(bs, nBits-32);
+		ret <<= 32;
+		ret |= gf_bs_read_int(bs, 32);
 	} else {
-		while (nBits-- > 0) {
-			ret <<= 1;
-			ret |= gf_bs_read_bit(bs);
-		}
+		ret = gf_bs_read_int(bs, nBits);
 	}
 	return ret;
 }
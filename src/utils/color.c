@@ -27,9 +27,37 @@
 #include <gpac/tools.h>
 #include <gpac/constants.h>
 #include <gpac/color.h>
+#include <gpac/thread.h>
+#include <gpac/list.h>
 
 #ifndef GPAC_DISABLE_PLAYER
 
+#if defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+#else
+# ifdef __SSE2__
+#  include <emmintrin.h>
+#  define GPAC_HAS_SSE2
+# endif
+#endif
+
+/*AVX2 code is only built for the functions using it and selected at run time*/
+#if defined(GPAC_HAS_SSE2) && (defined(_MSC_VER) || defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+# include <immintrin.h>
+# define GPAC_HAS_AVX2
+# if defined(_MSC_VER)
+#  define GF_AVX2_FUNC
+# else
+#  define GF_AVX2_FUNC __attribute__((target("avx2")))
+# endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define GPAC_HAS_NEON
+#endif
+
 /* YUV -> RGB conversion loading two lines at each call */
 
 #define col_clip(a) MAX(0, MIN(255, a))
@@ -44,6 +72,8 @@ static s32 R_V[256];
 
 
 static s32 yuv2rgb_is_init = 0;
+static Bool yuv_simd_is_init = GF_FALSE;
+
 static void yuv2rgb_init(void)
 {
 	s32 i;
@@ -57,6 +87,479 @@ static void yuv2rgb_init(void)
 		G_V[i] = FIX_OUT(0.813) * (i - 128);
 		R_V[i] = FIX_OUT(1.596) * (i - 128);
 	}
+	if (!yuv_simd_is_init) gf_color_set_simd(GF_COLOR_SIMD_AUTO);
+}
+
+/* SIMD YUV -> RGB row kernels
+
+Kernels compute exactly what the lookup tables above give: each table entry is the integer product of the coefficient
+and the offset component, so R = (cy*(y-16) + crv*(v-128)) >> 13 in 32 bits, clipped to [0, 255]. The two lines
+loaders call one row kernel per line, the kernel processes blocks of pixels and converts remaining pixels with the
+scalar tail functions*/
+
+typedef void (*yuv_row_proto)(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width);
+
+static struct
+{
+	u32 type;
+	/*chroma horizontally subsampled (420 and 422), optional alpha plane*/
+	yuv_row_proto row_420;
+	/*full resolution chroma*/
+	yuv_row_proto row_444;
+	/*same as above with 16 bit samples, 10 bits used*/
+	yuv_row_proto row_420_10;
+	yuv_row_proto row_444_10;
+	/*packed YUYV, y_src, u_src and v_src point to the first Y, U and V bytes of the row*/
+	yuv_row_proto row_yuyv;
+} yuv_simd;
+
+static void yuv_row_tail(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 x, u32 width, u32 c_shift)
+{
+	for (; x<width; x++) {
+		u32 c = x >> c_shift;
+		s32 rgb_y = RGB_Y[y_src[x]];
+		dst[4*x] = col_clip( (rgb_y + R_V[v_src[c]]) >> SCALEBITS_OUT);
+		dst[4*x+1] = col_clip( (rgb_y - G_U[u_src[c]] - G_V[v_src[c]]) >> SCALEBITS_OUT);
+		dst[4*x+2] = col_clip( (rgb_y + B_U[u_src[c]]) >> SCALEBITS_OUT);
+		dst[4*x+3] = a_src ? a_src[x] : 0xFF;
+	}
+}
+
+static void yuv_row_tail_10(u8 *dst, u8 *_y_src, u8 *_u_src, u8 *_v_src, u32 x, u32 width, u32 c_shift)
+{
+	u16 *y_src = (u16 *) _y_src;
+	u16 *u_src = (u16 *) _u_src;
+	u16 *v_src = (u16 *) _v_src;
+	for (; x<width; x++) {
+		u32 c = x >> c_shift;
+		s32 rgb_y = RGB_Y[y_src[x] >> 2];
+		dst[4*x] = col_clip( (rgb_y + R_V[v_src[c] >> 2]) >> SCALEBITS_OUT);
+		dst[4*x+1] = col_clip( (rgb_y - G_U[u_src[c] >> 2] - G_V[v_src[c] >> 2]) >> SCALEBITS_OUT);
+		dst[4*x+2] = col_clip( (rgb_y + B_U[u_src[c] >> 2]) >> SCALEBITS_OUT);
+		dst[4*x+3] = 0xFF;
+	}
+}
+
+static void yuv_row_tail_packed(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u32 x, u32 width)
+{
+	for (; x<width; x++) {
+		u32 c = 4 * (x/2);
+		s32 rgb_y = RGB_Y[y_src[2*x]];
+		dst[4*x] = col_clip( (rgb_y + R_V[v_src[c]]) >> SCALEBITS_OUT);
+		dst[4*x+1] = col_clip( (rgb_y - G_U[u_src[c]] - G_V[v_src[c]]) >> SCALEBITS_OUT);
+		dst[4*x+2] = col_clip( (rgb_y + B_U[u_src[c]]) >> SCALEBITS_OUT);
+		dst[4*x+3] = 0xFF;
+	}
+}
+
+/*coefficient pairs for madd on (u, v) interleaved 16 bit values*/
+#define YUV_C_Y		FIX_OUT(1.164)
+#define YUV_C_RV	(FIX_OUT(1.596) << 16)
+#define YUV_C_GUV	(FIX_OUT(0.391) | (FIX_OUT(0.813) << 16))
+#define YUV_C_BU	FIX_OUT(2.018)
+
+#ifdef GPAC_HAS_SSE2
+
+/*converts 8 pixels - y, u and v hold one unsigned 16 bit value per pixel, alpha is in the lower 8 bytes of a*/
+static GFINLINE void yuv_sse2_8px(u8 *dst, __m128i y, __m128i u, __m128i v, __m128i a)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c_y = _mm_set1_epi32(YUV_C_Y);
+	const __m128i c_rv = _mm_set1_epi32(YUV_C_RV);
+	const __m128i c_guv = _mm_set1_epi32(YUV_C_GUV);
+	const __m128i c_bu = _mm_set1_epi32(YUV_C_BU);
+	__m128i y_lo, y_hi, uv_lo, uv_hi, r, g, b, rg, ba;
+
+	y = _mm_sub_epi16(y, _mm_set1_epi16(16));
+	u = _mm_sub_epi16(u, _mm_set1_epi16(128));
+	v = _mm_sub_epi16(v, _mm_set1_epi16(128));
+
+	y_lo = _mm_madd_epi16(_mm_unpacklo_epi16(y, zero), c_y);
+	y_hi = _mm_madd_epi16(_mm_unpackhi_epi16(y, zero), c_y);
+	uv_lo = _mm_unpacklo_epi16(u, v);
+	uv_hi = _mm_unpackhi_epi16(u, v);
+
+	r = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(y_lo, _mm_madd_epi16(uv_lo, c_rv)), SCALEBITS_OUT),
+	                    _mm_srai_epi32(_mm_add_epi32(y_hi, _mm_madd_epi16(uv_hi, c_rv)), SCALEBITS_OUT));
+	g = _mm_packs_epi32(_mm_srai_epi32(_mm_sub_epi32(y_lo, _mm_madd_epi16(uv_lo, c_guv)), SCALEBITS_OUT),
+	                    _mm_srai_epi32(_mm_sub_epi32(y_hi, _mm_madd_epi16(uv_hi, c_guv)), SCALEBITS_OUT));
+	b = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(y_lo, _mm_madd_epi16(uv_lo, c_bu)), SCALEBITS_OUT),
+	                    _mm_srai_epi32(_mm_add_epi32(y_hi, _mm_madd_epi16(uv_hi, c_bu)), SCALEBITS_OUT));
+
+	rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g));
+	ba = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), a);
+	_mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi16(rg, ba));
+	_mm_storeu_si128((__m128i *) (dst+16), _mm_unpackhi_epi16(rg, ba));
+}
+
+static void yuv_row_420_sse2(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const __m128i zero = _mm_setzero_si128();
+	__m128i a = _mm_set1_epi8((char) 0xFF);
+
+	for (x=0; x+16<=width; x+=16) {
+		__m128i y = _mm_loadu_si128((const __m128i *) (y_src + x));
+		__m128i u = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (u_src + x/2)), zero);
+		__m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (v_src + x/2)), zero);
+		if (a_src) a = _mm_loadu_si128((const __m128i *) (a_src + x));
+
+		yuv_sse2_8px(dst + 4*x, _mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi16(u, u), _mm_unpacklo_epi16(v, v), a);
+		yuv_sse2_8px(dst + 4*x + 32, _mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi16(u, u), _mm_unpackhi_epi16(v, v), _mm_srli_si128(a, 8));
+	}
+	yuv_row_tail(dst, y_src, u_src, v_src, a_src, x, width, 1);
+}
+
+static void yuv_row_444_sse2(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i a = _mm_set1_epi8((char) 0xFF);
+
+	for (x=0; x+16<=width; x+=16) {
+		__m128i y = _mm_loadu_si128((const __m128i *) (y_src + x));
+		__m128i u = _mm_loadu_si128((const __m128i *) (u_src + x));
+		__m128i v = _mm_loadu_si128((const __m128i *) (v_src + x));
+
+		yuv_sse2_8px(dst + 4*x, _mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi8(u, zero), _mm_unpacklo_epi8(v, zero), a);
+		yuv_sse2_8px(dst + 4*x + 32, _mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi8(u, zero), _mm_unpackhi_epi8(v, zero), a);
+	}
+	yuv_row_tail(dst, y_src, u_src, v_src, NULL, x, width, 0);
+}
+
+static void yuv_row_420_10_sse2(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const __m128i a = _mm_set1_epi8((char) 0xFF);
+
+	for (x=0; x+8<=width; x+=8) {
+		__m128i y = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (y_src + 2*x)), 2);
+		__m128i u = _mm_srli_epi16(_mm_loadl_epi64((const __m128i *) (u_src + x)), 2);
+		__m128i v = _mm_srli_epi16(_mm_loadl_epi64((const __m128i *) (v_src + x)), 2);
+
+		yuv_sse2_8px(dst + 4*x, y, _mm_unpacklo_epi16(u, u), _mm_unpacklo_epi16(v, v), a);
+	}
+	yuv_row_tail_10(dst, y_src, u_src, v_src, x, width, 1);
+}
+
+static void yuv_row_444_10_sse2(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const __m128i a = _mm_set1_epi8((char) 0xFF);
+
+	for (x=0; x+8<=width; x+=8) {
+		__m128i y = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (y_src + 2*x)), 2);
+		__m128i u = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (u_src + 2*x)), 2);
+		__m128i v = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (v_src + 2*x)), 2);
+
+		yuv_sse2_8px(dst + 4*x, y, u, v, a);
+	}
+	yuv_row_tail_10(dst, y_src, u_src, v_src, x, width, 0);
+}
+
+static void yuv_row_yuyv_sse2(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const __m128i y_mask = _mm_set1_epi16(0xFF);
+	const __m128i c_mask = _mm_set1_epi32(0xFF);
+	const __m128i a = _mm_set1_epi8((char) 0xFF);
+
+	/*V loads end 3 bytes after the block, keep one macro pixel after it*/
+	for (x=0; x+10<=width; x+=8) {
+		__m128i y = _mm_and_si128(_mm_loadu_si128((const __m128i *) (y_src + 2*x)), y_mask);
+		__m128i u = _mm_and_si128(_mm_loadu_si128((const __m128i *) (u_src + 2*x)), c_mask);
+		__m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i *) (v_src + 2*x)), c_mask);
+
+		yuv_sse2_8px(dst + 4*x, y, _mm_or_si128(u, _mm_slli_epi32(u, 16)), _mm_or_si128(v, _mm_slli_epi32(v, 16)), a);
+	}
+	yuv_row_tail_packed(dst, y_src, u_src, v_src, x, width);
+}
+
+#ifdef GPAC_HAS_AVX2
+
+/*converts 16 pixels - y, u and v hold one unsigned 16 bit value per pixel*/
+static GF_AVX2_FUNC void yuv_avx2_16px(u8 *dst, __m256i y, __m256i u, __m256i v, __m128i a)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i c_y = _mm256_set1_epi32(YUV_C_Y);
+	const __m256i c_rv = _mm256_set1_epi32(YUV_C_RV);
+	const __m256i c_guv = _mm256_set1_epi32(YUV_C_GUV);
+	const __m256i c_bu = _mm256_set1_epi32(YUV_C_BU);
+	__m256i y_lo, y_hi, uv_lo, uv_hi, r, g, b;
+	__m128i r8, g8, b8, rg, ba;
+
+	y = _mm256_sub_epi16(y, _mm256_set1_epi16(16));
+	u = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+	v = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+
+	/*unpack works per 128 bit lane: lo holds pixels 0-3 and 8-11, hi pixels 4-7 and 12-15, pack restores the order*/
+	y_lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(y, zero), c_y);
+	y_hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(y, zero), c_y);
+	uv_lo = _mm256_unpacklo_epi16(u, v);
+	uv_hi = _mm256_unpackhi_epi16(u, v);
+
+	r = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_add_epi32(y_lo, _mm256_madd_epi16(uv_lo, c_rv)), SCALEBITS_OUT),
+	                       _mm256_srai_epi32(_mm256_add_epi32(y_hi, _mm256_madd_epi16(uv_hi, c_rv)), SCALEBITS_OUT));
+	g = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_sub_epi32(y_lo, _mm256_madd_epi16(uv_lo, c_guv)), SCALEBITS_OUT),
+	                       _mm256_srai_epi32(_mm256_sub_epi32(y_hi, _mm256_madd_epi16(uv_hi, c_guv)), SCALEBITS_OUT));
+	b = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_add_epi32(y_lo, _mm256_madd_epi16(uv_lo, c_bu)), SCALEBITS_OUT),
+	                       _mm256_srai_epi32(_mm256_add_epi32(y_hi, _mm256_madd_epi16(uv_hi, c_bu)), SCALEBITS_OUT));
+
+	r8 = _mm_packus_epi16(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+	g8 = _mm_packus_epi16(_mm256_castsi256_si128(g), _mm256_extracti128_si256(g, 1));
+	b8 = _mm_packus_epi16(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+
+	rg = _mm_unpacklo_epi8(r8, g8);
+	ba = _mm_unpacklo_epi8(b8, a);
+	_mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi16(rg, ba));
+	_mm_storeu_si128((__m128i *) (dst+16), _mm_unpackhi_epi16(rg, ba));
+	rg = _mm_unpackhi_epi8(r8, g8);
+	ba = _mm_unpackhi_epi8(b8, a);
+	_mm_storeu_si128((__m128i *) (dst+32), _mm_unpacklo_epi16(rg, ba));
+	_mm_storeu_si128((__m128i *) (dst+48), _mm_unpackhi_epi16(rg, ba));
+}
+
+/*duplicates 8 chroma values to 16 pixels*/
+static GF_AVX2_FUNC __m256i yuv_avx2_dup_chroma(__m128i c)
+{
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(c, c)), _mm_unpackhi_epi16(c, c), 1);
+}
+
+static GF_AVX2_FUNC void yuv_row_420_avx2(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const __m128i zero = _mm_setzero_si128();
+	__m128i a = _mm_set1_epi8((char) 0xFF);
+
+	for (x=0; x+16<=width; x+=16) {
+		__m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (y_src + x)));
+		__m128i u = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (u_src + x/2)), zero);
+		__m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (v_src + x/2)), zero);
+		if (a_src) a = _mm_loadu_si128((const __m128i *) (a_src + x));
+
+		yuv_avx2_16px(dst + 4*x, y, yuv_avx2_dup_chroma(u), yuv_avx2_dup_chroma(v), a);
+	}
+	yuv_row_tail(dst, y_src, u_src, v_src, a_src, x, width, 1);
+}
+
+static GF_AVX2_FUNC void yuv_row_444_avx2(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const __m128i a = _mm_set1_epi8((char) 0xFF);
+
+	for (x=0; x+16<=width; x+=16) {
+		__m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (y_src + x)));
+		__m256i u = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (u_src + x)));
+		__m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (v_src + x)));
+
+		yuv_avx2_16px(dst + 4*x, y, u, v, a);
+	}
+	yuv_row_tail(dst, y_src, u_src, v_src, NULL, x, width, 0);
+}
+
+static GF_AVX2_FUNC void yuv_row_420_10_avx2(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const __m128i a = _mm_set1_epi8((char) 0xFF);
+
+	for (x=0; x+16<=width; x+=16) {
+		__m256i y = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i *) (y_src + 2*x)), 2);
+		__m128i u = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (u_src + x)), 2);
+		__m128i v = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (v_src + x)), 2);
+
+		yuv_avx2_16px(dst + 4*x, y, yuv_avx2_dup_chroma(u), yuv_avx2_dup_chroma(v), a);
+	}
+	yuv_row_tail_10(dst, y_src, u_src, v_src, x, width, 1);
+}
+
+static GF_AVX2_FUNC void yuv_row_444_10_avx2(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const __m128i a = _mm_set1_epi8((char) 0xFF);
+
+	for (x=0; x+16<=width; x+=16) {
+		__m256i y = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i *) (y_src + 2*x)), 2);
+		__m256i u = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i *) (u_src + 2*x)), 2);
+		__m256i v = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i *) (v_src + 2*x)), 2);
+
+		yuv_avx2_16px(dst + 4*x, y, u, v, a);
+	}
+	yuv_row_tail_10(dst, y_src, u_src, v_src, x, width, 0);
+}
+
+static Bool yuv_cpu_has_avx2()
+{
+#if defined(_MSC_VER)
+	int regs[4];
+	__cpuid(regs, 0);
+	if (regs[0] < 7) return GF_FALSE;
+	__cpuid(regs, 1);
+	/*AVX and OS support for YMM registers*/
+	if ((regs[2] & ((1<<27) | (1<<28))) != ((1<<27) | (1<<28))) return GF_FALSE;
+	if ((_xgetbv(0) & 6) != 6) return GF_FALSE;
+	__cpuidex(regs, 7, 0);
+	return (regs[1] & (1<<5)) ? GF_TRUE : GF_FALSE;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") ? GF_TRUE : GF_FALSE;
+#endif
+}
+
+#endif /*GPAC_HAS_AVX2*/
+
+#endif /*GPAC_HAS_SSE2*/
+
+#ifdef GPAC_HAS_NEON
+
+/*converts 8 pixels - y, u and v hold one unsigned 16 bit value per pixel*/
+static GFINLINE void yuv_neon_8px(u8 *dst, uint16x8_t _y, uint16x8_t _u, uint16x8_t _v, uint8x8_t a)
+{
+	int16x8_t y = vsubq_s16(vreinterpretq_s16_u16(_y), vdupq_n_s16(16));
+	int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(_u), vdupq_n_s16(128));
+	int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(_v), vdupq_n_s16(128));
+	int32x4_t y_lo = vmull_n_s16(vget_low_s16(y), FIX_OUT(1.164));
+	int32x4_t y_hi = vmull_n_s16(vget_high_s16(y), FIX_OUT(1.164));
+	int32x4_t r_lo = vmlal_n_s16(y_lo, vget_low_s16(v), FIX_OUT(1.596));
+	int32x4_t r_hi = vmlal_n_s16(y_hi, vget_high_s16(v), FIX_OUT(1.596));
+	int32x4_t g_lo = vmlsl_n_s16(vmlsl_n_s16(y_lo, vget_low_s16(u), FIX_OUT(0.391)), vget_low_s16(v), FIX_OUT(0.813));
+	int32x4_t g_hi = vmlsl_n_s16(vmlsl_n_s16(y_hi, vget_high_s16(u), FIX_OUT(0.391)), vget_high_s16(v), FIX_OUT(0.813));
+	int32x4_t b_lo = vmlal_n_s16(y_lo, vget_low_s16(u), FIX_OUT(2.018));
+	int32x4_t b_hi = vmlal_n_s16(y_hi, vget_high_s16(u), FIX_OUT(2.018));
+	uint8x8x4_t rgba;
+
+	rgba.val[0] = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(r_lo, SCALEBITS_OUT)), vqmovn_s32(vshrq_n_s32(r_hi, SCALEBITS_OUT))));
+	rgba.val[1] = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(g_lo, SCALEBITS_OUT)), vqmovn_s32(vshrq_n_s32(g_hi, SCALEBITS_OUT))));
+	rgba.val[2] = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(b_lo, SCALEBITS_OUT)), vqmovn_s32(vshrq_n_s32(b_hi, SCALEBITS_OUT))));
+	rgba.val[3] = a;
+	vst4_u8(dst, rgba);
+}
+
+static void yuv_row_420_neon(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	uint8x16_t a = vdupq_n_u8(0xFF);
+
+	for (x=0; x+16<=width; x+=16) {
+		uint8x16_t y = vld1q_u8(y_src + x);
+		uint8x8_t u8 = vld1_u8(u_src + x/2);
+		uint8x8_t v8 = vld1_u8(v_src + x/2);
+		uint8x8x2_t u = vzip_u8(u8, u8);
+		uint8x8x2_t v = vzip_u8(v8, v8);
+		if (a_src) a = vld1q_u8(a_src + x);
+
+		yuv_neon_8px(dst + 4*x, vmovl_u8(vget_low_u8(y)), vmovl_u8(u.val[0]), vmovl_u8(v.val[0]), vget_low_u8(a));
+		yuv_neon_8px(dst + 4*x + 32, vmovl_u8(vget_high_u8(y)), vmovl_u8(u.val[1]), vmovl_u8(v.val[1]), vget_high_u8(a));
+	}
+	yuv_row_tail(dst, y_src, u_src, v_src, a_src, x, width, 1);
+}
+
+static void yuv_row_444_neon(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const uint8x8_t a = vdup_n_u8(0xFF);
+
+	for (x=0; x+16<=width; x+=16) {
+		uint8x16_t y = vld1q_u8(y_src + x);
+		uint8x16_t u = vld1q_u8(u_src + x);
+		uint8x16_t v = vld1q_u8(v_src + x);
+
+		yuv_neon_8px(dst + 4*x, vmovl_u8(vget_low_u8(y)), vmovl_u8(vget_low_u8(u)), vmovl_u8(vget_low_u8(v)), a);
+		yuv_neon_8px(dst + 4*x + 32, vmovl_u8(vget_high_u8(y)), vmovl_u8(vget_high_u8(u)), vmovl_u8(vget_high_u8(v)), a);
+	}
+	yuv_row_tail(dst, y_src, u_src, v_src, NULL, x, width, 0);
+}
+
+static void yuv_row_420_10_neon(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const uint8x8_t a = vdup_n_u8(0xFF);
+
+	for (x=0; x+8<=width; x+=8) {
+		uint16x8_t y = vshrq_n_u16(vld1q_u16((const u16 *) (y_src + 2*x)), 2);
+		uint16x4_t u = vshr_n_u16(vld1_u16((const u16 *) (u_src + x)), 2);
+		uint16x4_t v = vshr_n_u16(vld1_u16((const u16 *) (v_src + x)), 2);
+		uint16x4x2_t u2 = vzip_u16(u, u);
+		uint16x4x2_t v2 = vzip_u16(v, v);
+
+		yuv_neon_8px(dst + 4*x, y, vcombine_u16(u2.val[0], u2.val[1]), vcombine_u16(v2.val[0], v2.val[1]), a);
+	}
+	yuv_row_tail_10(dst, y_src, u_src, v_src, x, width, 1);
+}
+
+static void yuv_row_444_10_neon(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const uint8x8_t a = vdup_n_u8(0xFF);
+
+	for (x=0; x+8<=width; x+=8) {
+		uint16x8_t y = vshrq_n_u16(vld1q_u16((const u16 *) (y_src + 2*x)), 2);
+		uint16x8_t u = vshrq_n_u16(vld1q_u16((const u16 *) (u_src + 2*x)), 2);
+		uint16x8_t v = vshrq_n_u16(vld1q_u16((const u16 *) (v_src + 2*x)), 2);
+
+		yuv_neon_8px(dst + 4*x, y, u, v, a);
+	}
+	yuv_row_tail_10(dst, y_src, u_src, v_src, x, width, 0);
+}
+
+static void yuv_row_yuyv_neon(u8 *dst, u8 *y_src, u8 *u_src, u8 *v_src, u8 *a_src, u32 width)
+{
+	u32 x;
+	const uint8x8_t a = vdup_n_u8(0xFF);
+
+	/*YUYV layout as set by load_line_yuyv, deinterleaved by the load*/
+	for (x=0; x+16<=width; x+=16) {
+		uint8x8x4_t p = vld4_u8(y_src + 2*x);
+		uint8x8x2_t y = vzip_u8(p.val[0], p.val[2]);
+		uint8x8x2_t u = vzip_u8(p.val[1], p.val[1]);
+		uint8x8x2_t v = vzip_u8(p.val[3], p.val[3]);
+
+		yuv_neon_8px(dst + 4*x, vmovl_u8(y.val[0]), vmovl_u8(u.val[0]), vmovl_u8(v.val[0]), a);
+		yuv_neon_8px(dst + 4*x + 32, vmovl_u8(y.val[1]), vmovl_u8(u.val[1]), vmovl_u8(v.val[1]), a);
+	}
+	yuv_row_tail_packed(dst, y_src, u_src, v_src, x, width);
+}
+
+#endif /*GPAC_HAS_NEON*/
+
+GF_EXPORT
+u32 gf_color_set_simd(u32 simd_type)
+{
+	const char *name = "scalar";
+	yuv_simd_is_init = GF_TRUE;
+	memset(&yuv_simd, 0, sizeof(yuv_simd));
+
+	if (simd_type != GF_COLOR_SIMD_NONE) {
+#ifdef GPAC_HAS_SSE2
+		yuv_simd.type = GF_COLOR_SIMD_SSE2;
+		yuv_simd.row_420 = yuv_row_420_sse2;
+		yuv_simd.row_444 = yuv_row_444_sse2;
+		yuv_simd.row_420_10 = yuv_row_420_10_sse2;
+		yuv_simd.row_444_10 = yuv_row_444_10_sse2;
+		yuv_simd.row_yuyv = yuv_row_yuyv_sse2;
+		name = "SSE2";
+#ifdef GPAC_HAS_AVX2
+		if ((simd_type != GF_COLOR_SIMD_SSE2) && yuv_cpu_has_avx2()) {
+			yuv_simd.type = GF_COLOR_SIMD_AVX2;
+			yuv_simd.row_420 = yuv_row_420_avx2;
+			yuv_simd.row_444 = yuv_row_444_avx2;
+			yuv_simd.row_420_10 = yuv_row_420_10_avx2;
+			yuv_simd.row_444_10 = yuv_row_444_10_avx2;
+			/*packed YUV is bound by shuffling, AVX2 brings nothing*/
+			name = "AVX2";
+		}
+#endif
+#elif defined(GPAC_HAS_NEON)
+		yuv_simd.type = GF_COLOR_SIMD_NEON;
+		yuv_simd.row_420 = yuv_row_420_neon;
+		yuv_simd.row_444 = yuv_row_444_neon;
+		yuv_simd.row_420_10 = yuv_row_420_10_neon;
+		yuv_simd.row_444_10 = yuv_row_444_10_neon;
+		yuv_simd.row_yuyv = yuv_row_yuyv_neon;
+		name = "NEON";
+#endif
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[Color] Using %s YUV to RGB conversion\n", name));
+	return yuv_simd.type;
 }
 
 static void gf_yuv_load_lines_planar(unsigned char *dst, s32 dststride, unsigned char *y_src, unsigned char *u_src, unsigned char * v_src, s32 y_stride, s32 uv_stride, s32 width)
@@ -65,6 +568,12 @@ static void gf_yuv_load_lines_planar(unsigned char *dst, s32 dststride, unsigned
 	unsigned char *dst2 = (unsigned char *) dst + dststride;
 	unsigned char *y_src2 = (unsigned char *) y_src + y_stride;
 
+	if (yuv_simd.row_420) {
+		yuv_simd.row_420(dst, y_src, u_src, v_src, NULL, width & ~1);
+		yuv_simd.row_420(dst + dststride, y_src + y_stride, u_src, v_src, NULL, width & ~1);
+		return;
+	}
+
 	hw = width / 2;
 	for (x = 0; x < hw; x++) {
 		s32 u, v;
@@ -117,6 +626,12 @@ static void gf_yuv422_load_lines_planar(unsigned char *dst, s32 dststride, unsig
 	unsigned char *u_src2 = (unsigned char *)u_src + uv_stride;
 	unsigned char *v_src2 = (unsigned char *)v_src + uv_stride;
 
+	if (yuv_simd.row_420) {
+		yuv_simd.row_420(dst, y_src, u_src, v_src, NULL, width & ~1);
+		yuv_simd.row_420(dst + dststride, y_src + y_stride, u_src + uv_stride, v_src + uv_stride, NULL, width & ~1);
+		return;
+	}
+
 	hw = width / 2;
 	for (x = 0; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
@@ -175,6 +690,12 @@ static void gf_yuv444_load_lines_planar(unsigned char *dst, s32 dststride, unsig
 	unsigned char *u_src2 = (unsigned char *)u_src + uv_stride;
 	unsigned char *v_src2 = (unsigned char *)v_src + uv_stride;
 
+	if (yuv_simd.row_444) {
+		yuv_simd.row_444(dst, y_src, u_src, v_src, NULL, width & ~1);
+		yuv_simd.row_444(dst + dststride, y_src + y_stride, u_src + uv_stride, v_src + uv_stride, NULL, width & ~1);
+		return;
+	}
+
 	hw = width / 2;
 	for (x = 0; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
@@ -246,6 +767,12 @@ static void gf_yuv_10_load_lines_planar(unsigned char *dst, s32 dststride, unsig
 	unsigned short *u_src = (unsigned short *)_u_src;
 	unsigned short *v_src = (unsigned short *)_v_src;
 
+	if (yuv_simd.row_420_10) {
+		yuv_simd.row_420_10(dst, _y_src, _u_src, _v_src, NULL, width & ~1);
+		yuv_simd.row_420_10(dst + dststride, _y_src + y_stride, _u_src, _v_src, NULL, width & ~1);
+		return;
+	}
+
 
 	hw = width / 2;
 	for (x = 0; x < hw; x++) {
@@ -302,6 +829,12 @@ static void gf_yuv422_10_load_lines_planar(unsigned char *dst, s32 dststride, un
 	unsigned short *u_src = (unsigned short *)_u_src;
 	unsigned short *v_src = (unsigned short *)_v_src;
 
+	if (yuv_simd.row_420_10) {
+		yuv_simd.row_420_10(dst, _y_src, _u_src, _v_src, NULL, width & ~1);
+		yuv_simd.row_420_10(dst + dststride, _y_src + y_stride, _u_src + uv_stride, _v_src + uv_stride, NULL, width & ~1);
+		return;
+	}
+
 
 
 	hw = width / 2;
@@ -365,6 +898,12 @@ static void gf_yuv444_10_load_lines_planar(unsigned char *dst, s32 dststride, un
 	unsigned short * u_src = (unsigned short *)_u_src;
 	unsigned short * v_src = (unsigned short *)_v_src;
 
+	if (yuv_simd.row_444_10) {
+		yuv_simd.row_444_10(dst, _y_src, _u_src, _v_src, NULL, width & ~1);
+		yuv_simd.row_444_10(dst + dststride, _y_src + y_stride, _u_src + uv_stride, _v_src + uv_stride, NULL, width & ~1);
+		return;
+	}
+
 
 
 	hw = width / 2;
@@ -433,6 +972,11 @@ static void gf_yuv_load_lines_packed(unsigned char *dst, s32 dststride, unsigned
 {
 	u32 hw, x;
 
+	if (yuv_simd.row_yuyv) {
+		yuv_simd.row_yuyv(dst, y_src, u_src, v_src, NULL, width & ~1);
+		return;
+	}
+
 	hw = width / 2;
 	for (x = 0; x < hw; x++) {
 		s32 u, v;
@@ -475,6 +1019,12 @@ static void gf_yuva_load_lines(unsigned char *dst, s32 dststride, unsigned char
 
 	yuv2rgb_init();
 
+	if (yuv_simd.row_420) {
+		yuv_simd.row_420(dst, y_src, u_src, v_src, a_src, width & ~1);
+		yuv_simd.row_420(dst2, y_src2, u_src, v_src, a_src2, width & ~1);
+		return;
+	}
+
 	hw = width / 2;
 	for (x = 0; x < hw; x++) {
 		s32 u, v;
@@ -1182,9 +1732,10 @@ static void load_line_yv12_10(char *src_bits, u32 x_offset, u32 y_offset, u32 y_
 		pV = (u8 *)src_bits + 5*y_pitch*height/4;
 	}
 
-	pY += x_offset + y_offset*y_pitch;
-	pU += x_offset/2 + y_offset*y_pitch/4;
-	pV += x_offset/2 + y_offset*y_pitch/4;
+	/*x_offset is in samples*/
+	pY += 2*x_offset + y_offset*y_pitch;
+	pU += 2*(x_offset/2) + y_offset*y_pitch/4;
+	pV += 2*(x_offset/2) + y_offset*y_pitch/4;
 	gf_yuv_10_load_lines_planar((unsigned char*)dst_bits, 4*width, pY, pU, pV, y_pitch, y_pitch/2, width);
 }
 static void load_line_yuv422_10(char *src_bits, u32 x_offset, u32 y_offset, u32 y_pitch, u32 width, u32 height, u8 *dst_bits, u8 *pU, u8 *pV)
@@ -1302,203 +1853,69 @@ static void gf_cmx_apply_argb(GF_ColorMatrix *_this, u8 *a_, u8 *r_, u8 *g_, u8
 
 //#define COLORKEY_MPEG4_STRICT
 
-GF_EXPORT
-GF_Err gf_stretch_bits(GF_VideoSurface *dst, GF_VideoSurface *src, GF_Window *dst_wnd, GF_Window *src_wnd, u8 alpha, Bool flip, GF_ColorKey *key, GF_ColorMatrix *cmat)
+typedef struct
+{
+	GF_VideoSurface *dst, *src;
+	GF_ColorMatrix *cmat;
+	GF_ColorKey *key;
+	u8 alpha, ka, kr, kg, kb, kl, kh;
+	Bool flip, has_alpha, no_memcpy, force_load_odd_yuv_lines;
+	u32 yuv_planar_type, dst_bpp, src_w, dst_w;
+	s32 inc_y, inc_x, x_off, src_row, dst_x_pitch;
+	/*first row of the destination window*/
+	u8 *dst_bits;
+	copy_row_proto copy_row;
+	load_line_proto load_line;
+} StretchParams;
+
+/*converts nb_rows destination rows starting at first_row - the state of the conversion loop is rebuilt for the first row
+of the band, so that bands give the same pixels as a single pass*/
+static void stretch_rows(StretchParams *p, u32 first_row, u32 nb_rows)
 {
 	u8 *tmp, *rows;
-	u8 ka=0, kr=0, kg=0, kb=0, kl=0, kh=0;
-	s32 src_row;
-	u32 i, yuv_planar_type = 0;
-	Bool no_memcpy;
-	Bool force_load_odd_yuv_lines = GF_FALSE;
+	u32 i;
+	s32 src_row, pos_y, prev_row;
+	u64 start_pos;
 	Bool yuv_init = GF_FALSE;
-	Bool has_alpha = (alpha!=0xFF) ? GF_TRUE : GF_FALSE;
-	u32 dst_bpp, dst_w_size;
-	s32 pos_y, inc_y, inc_x, prev_row, x_off;
-	u32 src_w, src_h, dst_w, dst_h;
-	u8 *dst_bits = NULL, *dst_bits_prev = NULL, *dst_temp_bits = NULL;
-	s32 dst_x_pitch = dst->pitch_x;
+	u8 *dst_bits, *dst_bits_prev = NULL, *dst_temp_bits = NULL;
+	GF_VideoSurface *dst = p->dst;
+	GF_VideoSurface *src = p->src;
+	GF_ColorMatrix *cmat = p->cmat;
+	GF_ColorKey *key = p->key;
+	u8 alpha = p->alpha;
+	u8 ka = p->ka, kr = p->kr, kg = p->kg, kb = p->kb, kh = p->kh;
+#ifdef COLORKEY_MPEG4_STRICT
+	u8 kl = p->kl;
+#endif
+	Bool flip = p->flip;
+	Bool no_memcpy = p->no_memcpy;
+	Bool force_load_odd_yuv_lines = p->force_load_odd_yuv_lines;
+	u32 yuv_planar_type = p->yuv_planar_type;
+	u32 src_w = p->src_w;
+	u32 dst_w = p->dst_w;
+	u32 dst_h = nb_rows;
+	u32 dst_w_size = p->dst_bpp * p->dst_w;
+	s32 inc_y = p->inc_y;
+	s32 inc_x = p->inc_x;
+	s32 x_off = p->x_off;
+	s32 dst_x_pitch = p->dst_x_pitch;
+	copy_row_proto copy_row = p->copy_row;
+	load_line_proto load_line = p->load_line;
 
-	copy_row_proto copy_row = NULL;
-	load_line_proto load_line = NULL;
+	tmp = (u8 *) gf_malloc(sizeof(u8) * src_w * (yuv_planar_type ? 8 : 4) );
+	rows = tmp;
 
-	if (cmat && (cmat->m[15] || cmat->m[16] || cmat->m[17] || (cmat->m[18]!=FIX_ONE) || cmat->m[19] )) has_alpha = GF_TRUE;
-	else if (key && (key->alpha<0xFF)) has_alpha = GF_TRUE;
+	start_pos = 0x10000 + (u64) first_row * inc_y;
+	src_row = p->src_row + (s32) (start_pos >> 16);
+	pos_y = (s32) (start_pos & 0xFFFF);
+	prev_row = -1;
 
-	switch (src->pixel_format) {
-	case GF_PIXEL_GREYSCALE:
-		load_line = load_line_grey;
-		break;
-	case GF_PIXEL_ALPHAGREY:
-		load_line = load_line_alpha_grey;
-		has_alpha = GF_TRUE;
-		break;
-	case GF_PIXEL_RGB_555:
-		load_line = load_line_rgb_555;
-		break;
-	case GF_PIXEL_RGB_565:
-		load_line = load_line_rgb_565;
-		break;
-	case GF_PIXEL_RGB_24:
-	case GF_PIXEL_RGBS:
-		load_line = load_line_rgb_24;
-		break;
-	case GF_PIXEL_BGR_24:
-		load_line = load_line_bgr_24;
-		break;
-	case GF_PIXEL_ARGB:
-		has_alpha = GF_TRUE;
-		load_line = load_line_argb;
-		break;
-	case GF_PIXEL_RGBA:
-	case GF_PIXEL_RGBAS:
-		has_alpha = GF_TRUE;
-	case GF_PIXEL_RGB_32:
-		load_line = load_line_rgb_32;
-		break;
-	case GF_PIXEL_RGBDS:
-		load_line = load_line_rgbds;
-		has_alpha = GF_TRUE;
-		break;
-	case GF_PIXEL_RGBD:
-		load_line = load_line_rgbd;
-		break;
-	case GF_PIXEL_BGR_32:
-		load_line = load_line_bgr_32;
-		break;
-	case GF_PIXEL_YV12:
-	case GF_PIXEL_IYUV:
-	case GF_PIXEL_I420:
-		yuv2rgb_init();
-		yuv_planar_type = 1;
-		break;
-	case GF_PIXEL_YUV422:
-		yuv2rgb_init();
-		yuv_planar_type = 4;
-		break;
-	case GF_PIXEL_YUV444:
-		yuv2rgb_init();
-		yuv_planar_type = 5;
-		break;
-
-	case GF_PIXEL_YV12_10:
-		yuv2rgb_init();
-		yuv_planar_type = 3;
-		break;
-	case GF_PIXEL_YUV422_10:
-		yuv2rgb_init();
-		yuv_planar_type = 6;
-		break;
-	case GF_PIXEL_YUV444_10:
-		yuv2rgb_init();
-		yuv_planar_type = 7;
-		break;
-	case GF_PIXEL_NV21:
-	case GF_PIXEL_NV12:
-		load_line = load_line_YUV420SP;
-		break;
-	case GF_PIXEL_YUVA:
-		has_alpha = GF_TRUE;
-	case GF_PIXEL_YUVD:
-		yuv_planar_type = 2;
-		yuv2rgb_init();
-		break;
-	case GF_PIXEL_YUY2:
-		yuv_planar_type = 0;
-		yuv2rgb_init();
-		load_line = load_line_yuyv;
-		break;
-	default:
-		return GF_NOT_SUPPORTED;
-	}
-
-	/*only RGB output supported*/
-	switch (dst->pixel_format) {
-	case GF_PIXEL_RGB_555:
-		dst_bpp = sizeof(unsigned char)*2;
-		copy_row = has_alpha ? merge_row_rgb_555 : copy_row_rgb_555;
-		break;
-	case GF_PIXEL_RGB_565:
-		dst_bpp = sizeof(unsigned char)*2;
-		copy_row = has_alpha ? merge_row_rgb_565 : copy_row_rgb_565;
-		break;
-	case GF_PIXEL_RGB_24:
-		dst_bpp = sizeof(unsigned char)*3;
-		copy_row = has_alpha ? merge_row_rgb_24 : copy_row_rgb_24;
-		break;
-	case GF_PIXEL_BGR_24:
-		dst_bpp = sizeof(unsigned char)*3;
-		copy_row = has_alpha ? merge_row_bgr_24 : copy_row_bgr_24;
-		break;
-	case GF_PIXEL_RGB_32:
-		dst_bpp = sizeof(unsigned char)*4;
-		copy_row = has_alpha ? merge_row_bgrx : copy_row_bgrx;
-		break;
-	case GF_PIXEL_ARGB:
-		dst_bpp = sizeof(unsigned char)*4;
-		copy_row = has_alpha ? merge_row_bgra : copy_row_bgrx;
-		break;
-	case GF_PIXEL_RGBD:
-		dst_bpp = sizeof(unsigned char)*4;
-		copy_row = has_alpha ? merge_row_bgrx : copy_row_rgbd;
-		break;
-	case GF_PIXEL_RGBA:
-		dst_bpp = sizeof(unsigned char)*4;
-		copy_row = has_alpha ? merge_row_rgba : copy_row_rgbx;
-		break;
-	case GF_PIXEL_BGR_32:
-		dst_bpp = sizeof(unsigned char)*4;
-		copy_row = has_alpha ? merge_row_rgbx : copy_row_rgbx;
-		break;
-	default:
-		return GF_NOT_SUPPORTED;
-	}
-	/*x_pitch 0 means linear framebuffer*/
-	if (!dst_x_pitch) dst_x_pitch = dst_bpp;
-
-
-	src_w = src_wnd ? src_wnd->w : src->width;
-	src_h = src_wnd ? src_wnd->h : src->height;
-	dst_w = dst_wnd ? dst_wnd->w : dst->width;
-	dst_h = dst_wnd ? dst_wnd->h : dst->height;
-
-	if (yuv_planar_type && (src_w%2)) src_w++;
-
-	tmp = (u8 *) gf_malloc(sizeof(u8) * src_w * (yuv_planar_type ? 8 : 4) );
-	rows = tmp;
-
-	if ( (src_h / dst_h) * dst_h != src_h) force_load_odd_yuv_lines = GF_TRUE;
-
-	pos_y = 0x10000;
-	inc_y = (src_h << 16) / dst_h;
-	inc_x = (src_w << 16) / dst_w;
-	x_off = src_wnd ? src_wnd->x : 0;
-	src_row = src_wnd ? src_wnd->y : 0;
-
-	prev_row = -1;
-
-	dst_bits = (u8 *) dst->video_buffer;
-	if (dst_wnd) dst_bits += ((s32)dst_wnd->x) * dst_x_pitch + ((s32)dst_wnd->y) * dst->pitch_y;
-
-	dst_w_size = dst_bpp*dst_w;
+	dst_bits = p->dst_bits + (s32) first_row * dst->pitch_y;
 
 	/*small opt here: if we need to fetch data from destination, and if destination is
 	hardware memory, we work on a copy of the destination line*/
-	if (has_alpha && dst->is_hardware_memory)
-		dst_temp_bits = (u8 *) gf_malloc(sizeof(u8) * dst_bpp * dst_w);
-
-	if (key) {
-		ka = key->alpha;
-		kr = key->r;
-		kg = key->g;
-		kb = key->b;
-		kl = key->low;
-		kh = key->high;
-		if (kh==kl) kh++;
-	}
-
-	/*do NOT use memcpy if the target buffer is not in systems memory*/
-	no_memcpy = (has_alpha || dst->is_hardware_memory || (dst_bpp!=dst_x_pitch)) ? GF_TRUE : GF_FALSE;
+	if (p->has_alpha && dst->is_hardware_memory)
+		dst_temp_bits = (u8 *) gf_malloc(sizeof(u8) * dst_w_size);
 
 	while (dst_h) {
 		while ( pos_y >= 0x10000L ) {
@@ -1677,6 +2094,455 @@ GF_Err gf_stretch_bits(GF_VideoSurface *dst, GF_VideoSurface *src, GF_Window *ds
 	}
 	if (dst_temp_bits) gf_free(dst_temp_bits);
 	gf_free(tmp);
+}
+
+/*multi-threaded stretch: the destination window is split in horizontal bands, the calling thread converts the
+first band and worker threads shared by all callers convert the other ones*/
+
+/*minimum number of destination rows per band*/
+#define STRETCH_MIN_BAND_ROWS	32
+#define STRETCH_MAX_THREADS		64
+
+typedef struct
+{
+	StretchParams *params;
+	u32 first_row, nb_rows;
+	GF_Semaphore *done;
+} StretchBand;
+
+typedef struct
+{
+	GF_Thread *threads[STRETCH_MAX_THREADS];
+	u32 nb_threads;
+	/*number of worker threads requested at creation*/
+	u32 nb_req;
+	GF_List *bands;
+	GF_Mutex *mx;
+	GF_Semaphore *sema;
+	Bool run;
+	/*one reference held by the pool users while the pool is current, plus one per stretch in progress*/
+	u32 refs;
+} StretchPool;
+
+static struct
+{
+	/*created by gf_sys_init. Only protects the pool pointer, the reference counts and the user counts, never held while converting or while creating threads*/
+	GF_Mutex *mx;
+	StretchPool *pool;
+	/*number of registered users per requested thread count*/
+	u32 nb_users[STRETCH_MAX_THREADS+1];
+} stretch_ctrl;
+
+static u32 stretch_worker(void *par)
+{
+	StretchPool *pool = (StretchPool *) par;
+	while (1) {
+		StretchBand *band;
+		gf_sema_wait(pool->sema);
+		gf_mx_p(pool->mx);
+		band = (StretchBand *) gf_list_pop_front(pool->bands);
+		gf_mx_v(pool->mx);
+
+		/*queued bands are always processed before exiting*/
+		if (!band) {
+			if (!pool->run) break;
+			continue;
+		}
+		stretch_rows(band->params, band->first_row, band->nb_rows);
+		gf_sema_notify(band->done, 1);
+	}
+	return 0;
+}
+
+static void stretch_pool_del(StretchPool *pool)
+{
+	u32 i;
+	gf_mx_p(pool->mx);
+	pool->run = GF_FALSE;
+	gf_mx_v(pool->mx);
+	gf_sema_notify(pool->sema, pool->nb_threads);
+	for (i=0; i<pool->nb_threads; i++) {
+		gf_th_del(pool->threads[i]);
+	}
+	gf_sema_del(pool->sema);
+	gf_list_del(pool->bands);
+	gf_mx_del(pool->mx);
+	gf_free(pool);
+}
+
+static StretchPool *stretch_pool_new(u32 nb_threads)
+{
+	u32 i;
+	StretchPool *pool;
+	GF_SAFEALLOC(pool, StretchPool);
+	if (!pool) return NULL;
+	pool->nb_req = nb_threads;
+	pool->refs = 1;
+	pool->mx = gf_mx_new("StretchPool");
+	pool->bands = gf_list_new();
+	/*one notification per queued band, plus one per thread on exit*/
+	pool->sema = gf_sema_new(0xFFFF, 0);
+	pool->run = GF_TRUE;
+	for (i=0; i<nb_threads; i++) {
+		pool->threads[i] = gf_th_new("StretchWorker");
+		if (!pool->threads[i]) break;
+		if (gf_th_run(pool->threads[i], stretch_worker, pool) != GF_OK) {
+			gf_th_del(pool->threads[i]);
+			pool->threads[i] = NULL;
+			break;
+		}
+		pool->nb_threads++;
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[Color] Stretch using %d worker threads\n", pool->nb_threads));
+	return pool;
+}
+
+static StretchPool *stretch_pool_get()
+{
+	StretchPool *pool;
+	if (!stretch_ctrl.mx) return NULL;
+	gf_mx_p(stretch_ctrl.mx);
+	pool = stretch_ctrl.pool;
+	if (pool) pool->refs++;
+	gf_mx_v(stretch_ctrl.mx);
+	return pool;
+}
+
+/*the last reference holder destroys the pool, possibly a stretch finishing after the pool was replaced*/
+static void stretch_pool_put(StretchPool *pool)
+{
+	u32 refs;
+	if (!pool) return;
+	gf_mx_p(stretch_ctrl.mx);
+	refs = --pool->refs;
+	gf_mx_v(stretch_ctrl.mx);
+	if (!refs) stretch_pool_del(pool);
+}
+
+/*number of worker threads wanted by the registered users, must be called with the lock held*/
+static u32 stretch_get_nb_req()
+{
+	u32 i = STRETCH_MAX_THREADS;
+	while (i && !stretch_ctrl.nb_users[i]) i--;
+	/*the calling thread converts one band*/
+	return i ? i-1 : 0;
+}
+
+static void stretch_update_users(u32 nb_threads, Bool add)
+{
+	u32 nb_req, cur_req;
+	StretchPool *pool, *old_pool = NULL;
+	if (!stretch_ctrl.mx) return;
+	if (nb_threads > STRETCH_MAX_THREADS) nb_threads = STRETCH_MAX_THREADS;
+
+	gf_mx_p(stretch_ctrl.mx);
+	if (add) stretch_ctrl.nb_users[nb_threads]++;
+	else if (stretch_ctrl.nb_users[nb_threads]) stretch_ctrl.nb_users[nb_threads]--;
+	nb_req = stretch_get_nb_req();
+	cur_req = stretch_ctrl.pool ? stretch_ctrl.pool->nb_req : 0;
+	gf_mx_v(stretch_ctrl.mx);
+	if (nb_req == cur_req) return;
+
+	pool = nb_req ? stretch_pool_new(nb_req) : NULL;
+
+	gf_mx_p(stretch_ctrl.mx);
+	/*users changed while creating the pool, the caller which changed them installs its own*/
+	if ((stretch_get_nb_req() != nb_req) || ((stretch_ctrl.pool ? stretch_ctrl.pool->nb_req : 0) == nb_req)) {
+		gf_mx_v(stretch_ctrl.mx);
+		stretch_pool_put(pool);
+		return;
+	}
+	old_pool = stretch_ctrl.pool;
+	stretch_ctrl.pool = pool;
+	gf_mx_v(stretch_ctrl.mx);
+	stretch_pool_put(old_pool);
+}
+
+/*called by gf_sys_init and gf_sys_close, before any stretch thread is registered and after all users are gone*/
+void gf_stretch_init(Bool init)
+{
+	if (init) {
+		if (!stretch_ctrl.mx) stretch_ctrl.mx = gf_mx_new("StretchControl");
+	} else if (stretch_ctrl.mx) {
+		gf_mx_del(stretch_ctrl.mx);
+		stretch_ctrl.mx = NULL;
+	}
+}
+
+GF_EXPORT
+void gf_stretch_bits_add_threads(u32 nb_threads)
+{
+	stretch_update_users(nb_threads, GF_TRUE);
+}
+
+GF_EXPORT
+void gf_stretch_bits_remove_threads(u32 nb_threads)
+{
+	stretch_update_users(nb_threads, GF_FALSE);
+}
+
+static u32 stretch_get_nb_bands(StretchPool *pool, GF_VideoSurface *dst, u32 dst_w, u32 dst_h)
+{
+	u32 nb_bands;
+	/*video memory is written by a single thread*/
+	if (!pool || !pool->nb_threads || dst->is_hardware_memory) return 1;
+	if (dst_w * dst_h < 128*128) return 1;
+	nb_bands = dst_h / STRETCH_MIN_BAND_ROWS;
+	if (nb_bands > pool->nb_threads + 1) nb_bands = pool->nb_threads + 1;
+	return nb_bands;
+}
+
+static void stretch_bands(StretchPool *pool, StretchParams *params, u32 dst_h, u32 nb_bands)
+{
+	u32 i, nb_queued, band_rows;
+	StretchBand bands[STRETCH_MAX_THREADS];
+	GF_Semaphore *done = gf_sema_new(STRETCH_MAX_THREADS, 0);
+
+	band_rows = dst_h / nb_bands;
+	nb_queued = 0;
+	if (done) {
+		gf_mx_p(pool->mx);
+		for (i=1; i<nb_bands; i++) {
+			bands[i].params = params;
+			bands[i].first_row = i * band_rows;
+			bands[i].nb_rows = (i+1 == nb_bands) ? dst_h - i * band_rows : band_rows;
+			bands[i].done = done;
+			gf_list_add(pool->bands, &bands[i]);
+			nb_queued++;
+		}
+		gf_mx_v(pool->mx);
+		if (nb_queued) gf_sema_notify(pool->sema, nb_queued);
+	}
+	/*semaphore not available, convert everything here*/
+	if (!nb_queued) {
+		stretch_rows(params, 0, dst_h);
+	} else {
+		stretch_rows(params, 0, band_rows);
+		for (i=0; i<nb_queued; i++)
+			gf_sema_wait(done);
+	}
+	if (done) gf_sema_del(done);
+}
+
+GF_EXPORT
+GF_Err gf_stretch_bits(GF_VideoSurface *dst, GF_VideoSurface *src, GF_Window *dst_wnd, GF_Window *src_wnd, u8 alpha, Bool flip, GF_ColorKey *key, GF_ColorMatrix *cmat)
+{
+	StretchParams params;
+	u8 ka=0, kr=0, kg=0, kb=0, kl=0, kh=0;
+	u32 yuv_planar_type = 0;
+	Bool no_memcpy;
+	Bool force_load_odd_yuv_lines = GF_FALSE;
+	Bool has_alpha = (alpha!=0xFF) ? GF_TRUE : GF_FALSE;
+	u32 dst_bpp, nb_bands;
+	StretchPool *pool;
+	s32 inc_y, inc_x, x_off;
+	u32 src_w, src_h, dst_w, dst_h;
+	u8 *dst_bits = NULL;
+	s32 dst_x_pitch = dst->pitch_x;
+
+	copy_row_proto copy_row = NULL;
+	load_line_proto load_line = NULL;
+
+	if (cmat && (cmat->m[15] || cmat->m[16] || cmat->m[17] || (cmat->m[18]!=FIX_ONE) || cmat->m[19] )) has_alpha = GF_TRUE;
+	else if (key && (key->alpha<0xFF)) has_alpha = GF_TRUE;
+
+	switch (src->pixel_format) {
+	case GF_PIXEL_GREYSCALE:
+		load_line = load_line_grey;
+		break;
+	case GF_PIXEL_ALPHAGREY:
+		load_line = load_line_alpha_grey;
+		has_alpha = GF_TRUE;
+		break;
+	case GF_PIXEL_RGB_555:
+		load_line = load_line_rgb_555;
+		break;
+	case GF_PIXEL_RGB_565:
+		load_line = load_line_rgb_565;
+		break;
+	case GF_PIXEL_RGB_24:
+	case GF_PIXEL_RGBS:
+		load_line = load_line_rgb_24;
+		break;
+	case GF_PIXEL_BGR_24:
+		load_line = load_line_bgr_24;
+		break;
+	case GF_PIXEL_ARGB:
+		has_alpha = GF_TRUE;
+		load_line = load_line_argb;
+		break;
+	case GF_PIXEL_RGBA:
+	case GF_PIXEL_RGBAS:
+		has_alpha = GF_TRUE;
+	case GF_PIXEL_RGB_32:
+		load_line = load_line_rgb_32;
+		break;
+	case GF_PIXEL_RGBDS:
+		load_line = load_line_rgbds;
+		has_alpha = GF_TRUE;
+		break;
+	case GF_PIXEL_RGBD:
+		load_line = load_line_rgbd;
+		break;
+	case GF_PIXEL_BGR_32:
+		load_line = load_line_bgr_32;
+		break;
+	case GF_PIXEL_YV12:
+	case GF_PIXEL_IYUV:
+	case GF_PIXEL_I420:
+		yuv2rgb_init();
+		yuv_planar_type = 1;
+		break;
+	case GF_PIXEL_YUV422:
+		yuv2rgb_init();
+		yuv_planar_type = 4;
+		break;
+	case GF_PIXEL_YUV444:
+		yuv2rgb_init();
+		yuv_planar_type = 5;
+		break;
+
+	case GF_PIXEL_YV12_10:
+		yuv2rgb_init();
+		yuv_planar_type = 3;
+		break;
+	case GF_PIXEL_YUV422_10:
+		yuv2rgb_init();
+		yuv_planar_type = 6;
+		break;
+	case GF_PIXEL_YUV444_10:
+		yuv2rgb_init();
+		yuv_planar_type = 7;
+		break;
+	case GF_PIXEL_NV21:
+	case GF_PIXEL_NV12:
+		load_line = load_line_YUV420SP;
+		break;
+	case GF_PIXEL_YUVA:
+		has_alpha = GF_TRUE;
+	case GF_PIXEL_YUVD:
+		yuv_planar_type = 2;
+		yuv2rgb_init();
+		break;
+	case GF_PIXEL_YUY2:
+		yuv_planar_type = 0;
+		yuv2rgb_init();
+		load_line = load_line_yuyv;
+		break;
+	default:
+		return GF_NOT_SUPPORTED;
+	}
+
+	/*only RGB output supported*/
+	switch (dst->pixel_format) {
+	case GF_PIXEL_RGB_555:
+		dst_bpp = sizeof(unsigned char)*2;
+		copy_row = has_alpha ? merge_row_rgb_555 : copy_row_rgb_555;
+		break;
+	case GF_PIXEL_RGB_565:
+		dst_bpp = sizeof(unsigned char)*2;
+		copy_row = has_alpha ? merge_row_rgb_565 : copy_row_rgb_565;
+		break;
+	case GF_PIXEL_RGB_24:
+		dst_bpp = sizeof(unsigned char)*3;
+		copy_row = has_alpha ? merge_row_rgb_24 : copy_row_rgb_24;
+		break;
+	case GF_PIXEL_BGR_24:
+		dst_bpp = sizeof(unsigned char)*3;
+		copy_row = has_alpha ? merge_row_bgr_24 : copy_row_bgr_24;
+		break;
+	case GF_PIXEL_RGB_32:
+		dst_bpp = sizeof(unsigned char)*4;
+		copy_row = has_alpha ? merge_row_bgrx : copy_row_bgrx;
+		break;
+	case GF_PIXEL_ARGB:
+		dst_bpp = sizeof(unsigned char)*4;
+		copy_row = has_alpha ? merge_row_bgra : copy_row_bgrx;
+		break;
+	case GF_PIXEL_RGBD:
+		dst_bpp = sizeof(unsigned char)*4;
+		copy_row = has_alpha ? merge_row_bgrx : copy_row_rgbd;
+		break;
+	case GF_PIXEL_RGBA:
+		dst_bpp = sizeof(unsigned char)*4;
+		copy_row = has_alpha ? merge_row_rgba : copy_row_rgbx;
+		break;
+	case GF_PIXEL_BGR_32:
+		dst_bpp = sizeof(unsigned char)*4;
+		copy_row = has_alpha ? merge_row_rgbx : copy_row_rgbx;
+		break;
+	default:
+		return GF_NOT_SUPPORTED;
+	}
+	/*x_pitch 0 means linear framebuffer*/
+	if (!dst_x_pitch) dst_x_pitch = dst_bpp;
+
+
+	src_w = src_wnd ? src_wnd->w : src->width;
+	src_h = src_wnd ? src_wnd->h : src->height;
+	dst_w = dst_wnd ? dst_wnd->w : dst->width;
+	dst_h = dst_wnd ? dst_wnd->h : dst->height;
+
+	if (yuv_planar_type && (src_w%2)) src_w++;
+
+	if ( (src_h / dst_h) * dst_h != src_h) force_load_odd_yuv_lines = GF_TRUE;
+
+	inc_y = (src_h << 16) / dst_h;
+	inc_x = (src_w << 16) / dst_w;
+	x_off = src_wnd ? src_wnd->x : 0;
+
+	dst_bits = (u8 *) dst->video_buffer;
+	if (dst_wnd) dst_bits += ((s32)dst_wnd->x) * dst_x_pitch + ((s32)dst_wnd->y) * dst->pitch_y;
+
+	if (key) {
+		ka = key->alpha;
+		kr = key->r;
+		kg = key->g;
+		kb = key->b;
+		kl = key->low;
+		kh = key->high;
+		if (kh==kl) kh++;
+	}
+
+	/*do NOT use memcpy if the target buffer is not in systems memory*/
+	no_memcpy = (has_alpha || dst->is_hardware_memory || (dst_bpp!=dst_x_pitch)) ? GF_TRUE : GF_FALSE;
+
+	params.dst = dst;
+	params.src = src;
+	params.cmat = cmat;
+	params.key = key;
+	params.alpha = alpha;
+	params.ka = ka;
+	params.kr = kr;
+	params.kg = kg;
+	params.kb = kb;
+	params.kl = kl;
+	params.kh = kh;
+	params.flip = flip;
+	params.has_alpha = has_alpha;
+	params.no_memcpy = no_memcpy;
+	params.force_load_odd_yuv_lines = force_load_odd_yuv_lines;
+	params.yuv_planar_type = yuv_planar_type;
+	params.dst_bpp = dst_bpp;
+	params.src_w = src_w;
+	params.dst_w = dst_w;
+	params.inc_y = inc_y;
+	params.inc_x = inc_x;
+	params.x_off = x_off;
+	params.src_row = src_wnd ? src_wnd->y : 0;
+	params.dst_x_pitch = dst_x_pitch;
+	params.dst_bits = dst_bits;
+	params.copy_row = copy_row;
+	params.load_line = load_line;
+
+	/*the pool is kept alive until the stretch is done, even if the thread settings change meanwhile*/
+	pool = stretch_pool_get();
+	nb_bands = stretch_get_nb_bands(pool, dst, dst_w, dst_h);
+	if (nb_bands > 1)
+		stretch_bands(pool, &params, dst_h, nb_bands);
+	else
+		stretch_rows(&params, 0, dst_h);
+	stretch_pool_put(pool);
 	return GF_OK;
 }
 
@@ -1851,16 +2717,6 @@ void gf_cmx_apply_fixed(GF_ColorMatrix *_this, Fixed *a, Fixed *r, Fixed *g, Fix
 
 
 
-#if defined(WIN32) && !defined(__GNUC__)
-# include <intrin.h>
-# define GPAC_HAS_SSE2
-#else
-# ifdef __SSE2__
-#  include <emmintrin.h>
-#  define GPAC_HAS_SSE2
-# endif
-#endif
-
 #ifdef GPAC_HAS_SSE2
 
 static GF_Err gf_color_write_yv12_10_to_yuv_intrin(GF_VideoSurface *vs_dst,  unsigned char *pY, unsigned char *pU, unsigned char*pV, u32 src_stride, u32 src_width, u32 src_height, const GF_Window *_src_wnd, Bool swap_uv)
@@ -55,6 +55,10 @@
 #define GF_DOWNLOAD_AGENT_NAME		"GPAC/" GPAC_FULL_VERSION
 //let's be agressive with socket buffer size
 #define GF_DOWNLOAD_BUFFER_SIZE		131072
+//default idle connection pool limits
+#define GF_DOWNLOAD_MAX_IDLE_CONNECTIONS		16
+#define GF_DOWNLOAD_MAX_IDLE_CONNECTIONS_PER_HOST	4
+#define GF_DOWNLOAD_IDLE_CONNECTION_TIMEOUT	10000
 
 
 static void gf_dm_connect(GF_DownloadSession *sess);
@@ -89,6 +93,20 @@ typedef struct
 } GF_HTTPHeader;
 
 
+/*an idle keep-alive connection, kept by the download manager for later sessions to the same server*/
+typedef struct
+{
+	char *server_name;
+	u16 port;
+	Bool use_ssl;
+	GF_Socket *sock;
+#ifdef GPAC_HAS_SSL
+	SSL *ssl;
+#endif
+	/*time at which the connection became idle, in ms*/
+	u32 idle_since;
+} GF_DMConnection;
+
 /**
  * This structure handles partial downloads
  */
@@ -138,6 +156,8 @@ struct __gf_download_session
 	u64 start_time_utc;
 	Bool last_chunk_found;
 	Bool connection_close;
+	/*set once a complete response has been read on a keep-alive connection, the socket can then go to the idle pool*/
+	Bool connection_idle;
 	Bool is_range_continuation;
 	/*0: no cache reconfig before next GET request: 1: try to rematch the cache entry: 2: force to create a new cache entry (for byte-range cases)*/
 	u32 needs_cache_reconfig;
@@ -213,6 +233,11 @@ struct __gf_download_manager
 
 	Bool (*local_cache_url_provider_cbk)(void *udta, char *url, Bool cache_destroy);
 	void *lc_udta;
+
+	/*idle keep-alive connections, most recently used last - protected by cache_mx*/
+	GF_List *idle_connections;
+	u32 max_idle_connections, max_idle_per_host, idle_timeout;
+	u32 nb_conn_hits, nb_conn_misses, nb_conn_evicted;
 };
 
 #ifdef GPAC_HAS_SSL
@@ -700,6 +725,128 @@ static void gf_dm_clear_headers(GF_DownloadSession *sess)
 	}
 }
 
+static void gf_dm_connection_del(GF_DMConnection *conn)
+{
+#ifdef GPAC_HAS_SSL
+	if (conn->ssl) {
+		SSL_shutdown(conn->ssl);
+		SSL_free(conn->ssl);
+	}
+#endif
+	if (conn->sock) gf_sk_del(conn->sock);
+	if (conn->server_name) gf_free(conn->server_name);
+	gf_free(conn);
+}
+
+/*removes timed out idle connections, oldest first - dm->cache_mx must be held*/
+static void gf_dm_purge_idle_connections(GF_DownloadManager *dm, u32 now)
+{
+	while (gf_list_count(dm->idle_connections)) {
+		GF_DMConnection *conn = (GF_DMConnection *) gf_list_get(dm->idle_connections, 0);
+		if (now - conn->idle_since < dm->idle_timeout) break;
+		gf_list_rem(dm->idle_connections, 0);
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[HTTP] Closing idle connection to %s:%d\n", conn->server_name, conn->port));
+		gf_dm_connection_del(conn);
+		dm->nb_conn_evicted++;
+	}
+}
+
+/*moves the session connection to the idle pool of the download manager, returns GF_FALSE if the connection cannot be reused*/
+static Bool gf_dm_release_connection(GF_DownloadSession *sess, const char *server_name, u16 port, Bool use_ssl)
+{
+	u32 i, count, nb_host, first_host, now;
+	GF_DMConnection *conn;
+	GF_DownloadManager *dm = sess->dm;
+
+	if (!dm || !dm->max_idle_connections || !sess->sock || !server_name) return GF_FALSE;
+	//only keep connections with a complete response read, and not going through a proxy
+	if (!sess->connection_idle || (sess->proxy_enabled==1)) return GF_FALSE;
+	sess->connection_idle = GF_FALSE;
+
+	GF_SAFEALLOC(conn, GF_DMConnection);
+	if (!conn) return GF_FALSE;
+	conn->server_name = gf_strdup(server_name);
+	conn->port = port;
+	conn->use_ssl = use_ssl;
+	conn->sock = sess->sock;
+	sess->sock = NULL;
+#ifdef GPAC_HAS_SSL
+	conn->ssl = sess->ssl;
+	sess->ssl = NULL;
+#endif
+	now = gf_sys_clock();
+	conn->idle_since = now;
+
+	gf_mx_p(dm->cache_mx);
+	gf_dm_purge_idle_connections(dm, now);
+	count = gf_list_count(dm->idle_connections);
+	nb_host = first_host = 0;
+	for (i=0; i<count; i++) {
+		GF_DMConnection *a_conn = (GF_DMConnection *) gf_list_get(dm->idle_connections, i);
+		if ((a_conn->port != port) || strcmp(a_conn->server_name, server_name)) continue;
+		if (!nb_host) first_host = i;
+		nb_host++;
+	}
+	//over the limits, drop the oldest connection to this server or the oldest connection
+	if (dm->max_idle_per_host && (nb_host >= dm->max_idle_per_host)) {
+		gf_dm_connection_del(gf_list_get(dm->idle_connections, first_host));
+		gf_list_rem(dm->idle_connections, first_host);
+		dm->nb_conn_evicted++;
+	} else if (count >= dm->max_idle_connections) {
+		gf_dm_connection_del(gf_list_get(dm->idle_connections, 0));
+		gf_list_rem(dm->idle_connections, 0);
+		dm->nb_conn_evicted++;
+	}
+	gf_list_add(dm->idle_connections, conn);
+	gf_mx_v(dm->cache_mx);
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[HTTP] Keeping idle connection to %s:%d\n", server_name, port));
+	return GF_TRUE;
+}
+
+/*assigns an idle connection to the session server if any, most recent one first*/
+static Bool gf_dm_get_idle_connection(GF_DownloadSession *sess)
+{
+	u32 i;
+	GF_DMConnection *conn = NULL;
+	GF_DownloadManager *dm = sess->dm;
+	Bool use_ssl = (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? GF_TRUE : GF_FALSE;
+
+	if (!dm || !dm->max_idle_connections || !sess->server_name) return GF_FALSE;
+
+	gf_mx_p(dm->cache_mx);
+	gf_dm_purge_idle_connections(dm, gf_sys_clock());
+	i = gf_list_count(dm->idle_connections);
+	while (i) {
+		GF_DMConnection *a_conn = (GF_DMConnection *) gf_list_get(dm->idle_connections, --i);
+		if ((a_conn->port != sess->port) || (a_conn->use_ssl != use_ssl) || strcmp(a_conn->server_name, sess->server_name)) continue;
+
+		gf_list_rem(dm->idle_connections, i);
+		//closed by the server while idle
+		if (gf_sk_probe(a_conn->sock) != GF_OK) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[HTTP] Idle connection to %s:%d closed by server\n", a_conn->server_name, a_conn->port));
+			gf_dm_connection_del(a_conn);
+			dm->nb_conn_evicted++;
+			continue;
+		}
+		conn = a_conn;
+		break;
+	}
+	if (conn) dm->nb_conn_hits++;
+	else dm->nb_conn_misses++;
+	gf_mx_v(dm->cache_mx);
+
+	if (!conn) return GF_FALSE;
+
+	sess->sock = conn->sock;
+#ifdef GPAC_HAS_SSL
+	sess->ssl = conn->ssl;
+#endif
+	gf_free(conn->server_name);
+	gf_free(conn);
+	GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Reusing idle connection to %s:%d\n", sess->server_name, sess->port));
+	return GF_TRUE;
+}
 
 static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
 {
@@ -723,6 +870,8 @@ static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
 	gf_mx_p(sess->mx);
 
 	if (force_close || !(sess->flags & GF_NETIO_SESSION_PERSISTENT)) {
+		/*keep the connection for later sessions to this server*/
+		gf_dm_release_connection(sess, sess->server_name, sess->port, (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? GF_TRUE : GF_FALSE);
 #ifdef GPAC_HAS_SSL
 		if (sess->ssl) {
 			SSL_shutdown(sess->ssl);
@@ -767,6 +916,8 @@ void gf_dm_sess_del(GF_DownloadSession *sess)
 		gf_th_del(sess->th);
 		sess->th = NULL;
 	}
+	//persistent session done with its last request
+	gf_dm_release_connection(sess, sess->server_name, sess->port, (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? GF_TRUE : GF_FALSE);
 
 	if (sess->dm) {
 		gf_mx_p(sess->dm->cache_mx);
@@ -1048,6 +1199,9 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url)
 	Bool socket_changed = GF_FALSE;
 	GF_URL_Info info;
 	char *sep_frag=NULL;
+	char *prev_server_name = NULL;
+	u16 prev_port = sess->port;
+	Bool prev_ssl = (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? GF_TRUE : GF_FALSE;
 	if (!url) return GF_BAD_PARAM;
 
 	gf_dm_clear_headers(sess);
@@ -1118,7 +1272,7 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url)
 	if (sess->server_name && info.server_name && !strcmp(sess->server_name, info.server_name)) {
 	} else {
 		socket_changed = GF_TRUE;
-		if (sess->server_name) gf_free(sess->server_name);
+		prev_server_name = sess->server_name;
 		sess->server_name = info.server_name ? gf_strdup(info.server_name) : NULL;
 	}
 
@@ -1149,7 +1303,9 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url)
 		sess->num_retry = SESSION_RETRY_COUNT;
 		sess->needs_cache_reconfig = 1;
 	} else {
-		if (sess->sock) gf_sk_del(sess->sock);
+		/*keep the previous connection for later sessions to this server*/
+		if (sess->sock && !gf_dm_release_connection(sess, prev_server_name ? prev_server_name : sess->server_name, prev_port, prev_ssl))
+			gf_sk_del(sess->sock);
 		sess->sock = NULL;
 		sess->status = GF_NETIO_SETUP;
 #ifdef GPAC_HAS_SSL
@@ -1161,6 +1317,7 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url)
 #endif
 
 	}
+	if (prev_server_name) gf_free(prev_server_name);
 	sess->total_size=0;
 	sess->bytes_done=0;
 	assert(sess->remaining_data_size==0);
@@ -1383,11 +1540,6 @@ static void gf_dm_connect(GF_DownloadSession *sess)
 	u16 proxy_port = 0;
 	const char *proxy, *ip;
 
-	if (!sess->sock) {
-		sess->num_retry = 40;
-		sess->sock = gf_sk_new(GF_SOCK_TYPE_TCP);
-	}
-
 	/*connect*/
 	sess->status = GF_NETIO_SETUP;
 	gf_dm_sess_notify_state(sess, sess->status, GF_OK);
@@ -1433,6 +1585,20 @@ static void gf_dm_connect(GF_DownloadSession *sess)
 		ip = NULL;
 	}
 
+	if (!sess->sock) {
+		sess->num_retry = 40;
+		/*reuse an idle connection to the same server if any*/
+		if (!proxy && gf_dm_get_idle_connection(sess)) {
+			sess->connect_time = 0;
+			sess->ssl_setup_time = 0;
+			sess->status = GF_NETIO_CONNECTED;
+			gf_dm_sess_notify_state(sess, GF_NETIO_CONNECTED, GF_OK);
+			gf_dm_configure_cache(sess);
+			return;
+		}
+		sess->sock = gf_sk_new(GF_SOCK_TYPE_TCP);
+	}
+
 	if (!proxy) {
 		proxy = sess->server_name;
 		proxy_port = sess->port;
@@ -1952,6 +2118,19 @@ retry_cache:
 		}
 	}
 
+	dm->idle_connections = gf_list_new();
+	dm->max_idle_connections = GF_DOWNLOAD_MAX_IDLE_CONNECTIONS;
+	dm->max_idle_per_host = GF_DOWNLOAD_MAX_IDLE_CONNECTIONS_PER_HOST;
+	dm->idle_timeout = GF_DOWNLOAD_IDLE_CONNECTION_TIMEOUT;
+	if (cfg) {
+		opt = gf_cfg_get_key(cfg, "Downloader", "MaxIdleConnections");
+		if (opt) dm->max_idle_connections = atoi(opt);
+		opt = gf_cfg_get_key(cfg, "Downloader", "MaxIdleConnectionsPerHost");
+		if (opt) dm->max_idle_per_host = atoi(opt);
+		opt = gf_cfg_get_key(cfg, "Downloader", "IdleConnectionTimeout");
+		if (opt) dm->idle_timeout = atoi(opt);
+	}
+
 	gf_mx_v( dm->cache_mx );
 	if (default_cache_dir)
 		gf_free(default_cache_dir);
@@ -2001,6 +2180,14 @@ void gf_dm_del(GF_DownloadManager *dm)
 	}
 	gf_list_del(dm->sessions);
 	dm->sessions = NULL;
+
+	GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Connection pool: %d reused connections, %d new connections, %d closed while idle\n", dm->nb_conn_hits, dm->nb_conn_misses, dm->nb_conn_evicted));
+	while (gf_list_count(dm->idle_connections)) {
+		GF_DMConnection *conn = (GF_DMConnection *) gf_list_pop_back(dm->idle_connections);
+		gf_dm_connection_del(conn);
+	}
+	gf_list_del(dm->idle_connections);
+	dm->idle_connections = NULL;
 	assert( dm->skip_proxy_servers );
 	while (gf_list_count(dm->skip_proxy_servers)) {
 		char *serv = (char*)gf_list_get(dm->skip_proxy_servers, 0);
@@ -2306,6 +2493,8 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload,
 	}
 	//and we're done
 	if (sess->total_size && (sess->bytes_done == sess->total_size)) {
+		//response fully read, the connection can be reused unless the server closes it
+		sess->connection_idle = sess->connection_close ? GF_FALSE : GF_TRUE;
 		gf_dm_disconnect(sess, GF_FALSE);
 		par.msg_type = GF_NETIO_DATA_TRANSFERED;
 		par.error = GF_OK;
@@ -2472,6 +2661,7 @@ static GF_Err http_send_headers(GF_DownloadSession *sess, char * sHTTP) {
 	assert (sess->status == GF_NETIO_CONNECTED);
 
 	gf_dm_clear_headers(sess);
+	sess->connection_idle = GF_FALSE;
 
 	assert(sess->remaining_data_size == 0);
 
@@ -2879,6 +3069,8 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 	s32 LinePos, Pos;
 	u32 rsp_code, ContentLength, first_byte, last_byte, total_size, range, no_range;
 	Bool connection_closed = GF_FALSE;
+	Bool connection_keep_alive = GF_FALSE;
+	Bool is_http10 = GF_FALSE;
 	char buf[1025];
 	char comp[400];
 	GF_Err e;
@@ -2991,6 +3183,8 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 	} else if ((strncmp("HTTP", comp, 4) != 0)) {
 		e = GF_REMOTE_SERVICE_ERROR;
 		goto exit;
+	} else if (!strncmp(comp, "HTTP/1.0", 8)) {
+		is_http10 = GF_TRUE;
 	}
 	Pos = gf_token_get(buf, Pos, " ", comp, 400);
 	if (Pos <= 0) {
@@ -3116,6 +3310,8 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		else if (!stricmp(hdrp->name, "Connection") ) {
 			if (strstr(hdrp->value, "close"))
 				connection_closed = GF_TRUE;
+			else if (!stricmp(hdrp->value, "keep-alive"))
+				connection_keep_alive = GF_TRUE;
 		}
 
 		if (sess->status==GF_NETIO_DISCONNECTED) return GF_OK;
@@ -3161,9 +3357,12 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		if (BodyStart + ContentLength > (u32) bytesRead) {
 			ContentLength = 0;
 			//cannot flush, discard socket
-			sess->connection_close = GF_TRUE;
+			connection_closed = GF_TRUE;
 		}
 	}
+	//HTTP/1.0 servers close the connection unless keep-alive is announced
+	if (is_http10 && !connection_keep_alive)
+		connection_closed = GF_TRUE;
 	//remember if we can keep the session alive after the transfer is done
 	sess->connection_close = connection_closed;
 
@@ -3883,6 +4082,35 @@ u32 gf_dm_get_global_rate(GF_DownloadManager *dm)
 	return 8*ret;
 }
 
+GF_EXPORT
+void gf_dm_set_connection_pool(GF_DownloadManager *dm, u32 max_idle, u32 max_idle_per_host, u32 idle_timeout)
+{
+	if (!dm) return;
+	gf_mx_p(dm->cache_mx);
+	dm->max_idle_connections = max_idle;
+	dm->max_idle_per_host = max_idle_per_host;
+	dm->idle_timeout = idle_timeout;
+	while (gf_list_count(dm->idle_connections) > max_idle) {
+		GF_DMConnection *conn = (GF_DMConnection *) gf_list_get(dm->idle_connections, 0);
+		gf_list_rem(dm->idle_connections, 0);
+		gf_dm_connection_del(conn);
+		dm->nb_conn_evicted++;
+	}
+	gf_mx_v(dm->cache_mx);
+}
+
+GF_EXPORT
+void gf_dm_get_connection_pool_stats(GF_DownloadManager *dm, u32 *nb_idle, u32 *nb_hits, u32 *nb_misses, u32 *nb_evicted)
+{
+	if (!dm) return;
+	gf_mx_p(dm->cache_mx);
+	if (nb_idle) *nb_idle = gf_list_count(dm->idle_connections);
+	if (nb_hits) *nb_hits = dm->nb_conn_hits;
+	if (nb_misses) *nb_misses = dm->nb_conn_misses;
+	if (nb_evicted) *nb_evicted = dm->nb_conn_evicted;
+	gf_mx_v(dm->cache_mx);
+}
+
 GF_EXPORT
 const char *gf_dm_sess_get_header(GF_DownloadSession *sess, const char *name)
 {
@@ -711,6 +711,11 @@ const char *gf_sys_get_arg(u32 arg)
 }
 
 
+#ifndef GPAC_DISABLE_PLAYER
+/*creates or destroys the lock of the stretch thread pool, cf color.c*/
+void gf_stretch_init(Bool init);
+#endif
+
 GF_EXPORT
 void gf_sys_init(GF_MemTrackerType mem_tracker_type)
 {
@@ -809,6 +814,10 @@ void gf_sys_init(GF_MemTrackerType mem_tracker_type)
 #ifndef _WIN32_WCE
 		setlocale( LC_NUMERIC, "C" );
 #endif
+
+#ifndef GPAC_DISABLE_PLAYER
+		gf_stretch_init(GF_TRUE);
+#endif
 	}
 	sys_init += 1;
 
@@ -834,6 +843,10 @@ void gf_sys_close()
 		/*prevent any call*/
 		last_update_time = 0xFFFFFFFF;
 
+#ifndef GPAC_DISABLE_PLAYER
+		gf_stretch_init(GF_FALSE);
+#endif
+
 #if defined(WIN32) && !defined(_WIN32_WCE)
 		timeEndPeriod(1);
 
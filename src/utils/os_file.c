@@ -373,6 +373,14 @@ u64 gf_file_modification_time(const char *filename)
 }
 
 static u32 gpac_file_handles = 0;
+/*files may be opened and closed from several threads (parallel DASH segmentation)*/
+#if defined(WIN32) && !defined(__GNUC__)
+#define file_handles_inc()	_InterlockedIncrement((long volatile *) &gpac_file_handles)
+#define file_handles_dec()	_InterlockedDecrement((long volatile *) &gpac_file_handles)
+#else
+#define file_handles_inc()	__sync_add_and_fetch(&gpac_file_handles, 1)
+#define file_handles_dec()	__sync_sub_and_fetch(&gpac_file_handles, 1)
+#endif
 GF_EXPORT
 u32 gf_file_handles_count()
 {
@@ -412,7 +420,7 @@ FILE *gf_temp_file_new(char ** const fileName)
 				return 0;
 			res = gf_fopen(mbs_t_file, "w+b");
 			if (res) {
-				gpac_file_handles--;
+				file_handles_dec();
 				if (fileName) {
 					*fileName = gf_strdup(mbs_t_file);
 				} else {
@@ -428,7 +436,7 @@ FILE *gf_temp_file_new(char ** const fileName)
 #endif
 
 	if (res) {
-		gpac_file_handles++;
+		file_handles_inc();
 	}
 	return res;
 }
@@ -791,7 +799,7 @@ FILE *gf_fopen(const char *file_name, const char *mode)
 #endif
 
 	if (res) {
-		gpac_file_handles++;
+		file_handles_inc();
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_CORE, ("[Core] file %s opened in mode %s - %d file handles\n", file_name, mode, gpac_file_handles));
 	} else {
 		if (strchr(mode, 'w') || strchr(mode, 'a')) {
@@ -811,7 +819,7 @@ s32 gf_fclose(FILE *file)
 {
 	if (file) {
 		assert(gpac_file_handles);
-		gpac_file_handles--;
+		file_handles_dec();
 	}
 	return fclose(file);
 }
@@ -23,6 +23,11 @@
  *
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/*for sendmmsg*/
+#define _GNU_SOURCE
+#endif
+
 #ifndef GPAC_DISABLE_CORE_TOOLS
 
 #if defined(WIN32) || defined(_WIN32_WCE)
@@ -109,9 +114,27 @@ static int wsa_init = 0;
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <arpa/inet.h>
+#ifndef __SYMBIAN32__
+#include <sys/uio.h>
+#endif
 
 #include <gpac/network.h>
 
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define GPAC_HAS_MMSG
+#endif
+
+#if defined(__linux__) && defined(SO_MEMINFO)
+#include <linux/sock_diag.h>
+#endif
+
+/*socket groups use epoll rather than select on linux*/
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <poll.h>
+#define GPAC_HAS_EPOLL
+#endif
+
 /*not defined on solaris*/
 #if !defined(INADDR_NONE)
 # if (defined(sun) && defined(__SVR4))
@@ -170,7 +193,11 @@ enum
 	GF_SOCK_IS_LISTENING = 1<<13,
 	/*socket is bound to a specific dest (server) or source (client) */
 	GF_SOCK_HAS_PEER = 1<<14,
-	GF_SOCK_IS_MIP = 1<<15
+	GF_SOCK_IS_MIP = 1<<15,
+	/*sendmmsg/recvmmsg not available in the running kernel*/
+	GF_SOCK_NO_MMSG = 1<<16,
+	/*kernel drop counter requested on the socket*/
+	GF_SOCK_RXQ_OVFL = 1<<17
 };
 
 struct __tag_socket
@@ -186,6 +213,15 @@ struct __tag_socket
 	u32 dest_addr_len;
 
 	u32 usec_wait;
+
+	/*reception stats of gf_sk_receive_batch*/
+	u32 nb_rcv, nb_dropped, nb_truncated;
+
+#ifdef GPAC_HAS_EPOLL
+	/*socket group and select round for which the socket was last found readable*/
+	GF_SockGroup *ready_group;
+	u32 ready_epoch;
+#endif
 };
 
 
@@ -852,23 +888,22 @@ GF_Err gf_sk_bind(GF_Socket *sock, const char *local_ip, u16 port, const char *p
 }
 
 //send length bytes of a buffer
-GF_EXPORT
-GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
+/*checks if the socket is writable, waiting at most usec_wait*/
+static GF_Err gf_sk_wait_write(GF_Socket *sock, Bool *not_ready)
 {
-	u32 count;
-	s32 res;
-	Bool not_ready = GF_FALSE;
 #ifndef __SYMBIAN32__
 	int ready;
+#ifdef GPAC_HAS_EPOLL
+	/*poll does not limit descriptor values to FD_SETSIZE*/
+	struct pollfd pfd;
+	pfd.fd = sock->socket;
+	pfd.events = POLLOUT;
+	pfd.revents = 0;
+	ready = poll(&pfd, 1, (sock->usec_wait + 999) / 1000);
+#else
 	struct timeval timeout;
 	fd_set Group;
-#endif
 
-	//the socket must be bound or connected
-	if (!sock || !sock->socket) return GF_BAD_PARAM;
-
-#ifndef __SYMBIAN32__
-	//can we write?
 	FD_ZERO(&Group);
 	FD_SET(sock->socket, &Group);
 	timeout.tv_sec = 0;
@@ -876,6 +911,7 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
 
 	//TODO CHECK IF THIS IS CORRECT
 	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+#endif
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -886,10 +922,50 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
 	}
 
 	//should never happen (to check: is writeability is guaranteed for not-connected sockets)
+#ifdef GPAC_HAS_EPOLL
+	if (!ready || !(pfd.revents & (POLLOUT|POLLERR|POLLHUP))) {
+#else
 	if (!ready || !FD_ISSET(sock->socket, &Group)) {
-		not_ready = GF_TRUE;
+#endif
+		*not_ready = GF_TRUE;
 	}
 #endif
+	return GF_OK;
+}
+
+/*maps the last send error*/
+static GF_Err gf_sk_send_error(Bool not_ready)
+{
+	if (not_ready)
+		return GF_IP_NETWORK_EMPTY;
+
+	switch (LASTSOCKERROR) {
+	case EAGAIN:
+		return GF_IP_SOCK_WOULD_BLOCK;
+#ifndef __SYMBIAN32__
+	case ENOTCONN:
+	case ECONNRESET:
+		return GF_IP_CONNECTION_CLOSED;
+#endif
+	default:
+		return GF_IP_NETWORK_FAILURE;
+	}
+}
+
+GF_EXPORT
+GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
+{
+	GF_Err e;
+	u32 count;
+	s32 res;
+	Bool not_ready = GF_FALSE;
+
+	//the socket must be bound or connected
+	if (!sock || !sock->socket) return GF_BAD_PARAM;
+
+	//can we write?
+	e = gf_sk_wait_write(sock, &not_ready);
+	if (e) return e;
 
 	//direct writing
 	count = 0;
@@ -900,23 +976,154 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length)
 			res = (s32) send(sock->socket, (char *) buffer+count, length - count, 0);
 		}
 		if (res == SOCKET_ERROR) {
-			if (not_ready)
-				return GF_IP_NETWORK_EMPTY;
+			return gf_sk_send_error(not_ready);
+		}
+		count += res;
+	}
+	return GF_OK;
+}
 
-			switch (res = LASTSOCKERROR) {
-			case EAGAIN:
-				return GF_IP_SOCK_WOULD_BLOCK;
-#ifndef __SYMBIAN32__
-			case ENOTCONN:
-			case ECONNRESET:
-				return GF_IP_CONNECTION_CLOSED;
+/*sends a single datagram made of header and payload*/
+static s32 gf_sk_send_datagram(GF_Socket *sock, const GF_SockDatagram *dg)
+{
+#if !defined(WIN32) && !defined(_WIN32_WCE) && !defined(__SYMBIAN32__)
+	struct msghdr msg;
+	struct iovec iov[2];
+	u32 nb_iov = 0;
+
+	memset(&msg, 0, sizeof(struct msghdr));
+	if (dg->header_size) {
+		iov[nb_iov].iov_base = (void *) dg->header;
+		iov[nb_iov].iov_len = dg->header_size;
+		nb_iov++;
+	}
+	iov[nb_iov].iov_base = (void *) dg->data;
+	iov[nb_iov].iov_len = dg->size;
+	nb_iov++;
+	msg.msg_iov = iov;
+	msg.msg_iovlen = nb_iov;
+	if (sock->flags & GF_SOCK_HAS_PEER) {
+		msg.msg_name = &sock->dest_addr;
+		msg.msg_namelen = sock->dest_addr_len;
+	}
+	return (s32) sendmsg(sock->socket, &msg, 0);
+#else
+	s32 res;
+	char stack_buf[2048], *buf = (char *) dg->data;
+	u32 size = dg->size;
+
+	/*no gather send, rebuild the datagram*/
+	if (dg->header_size) {
+		size += dg->header_size;
+		buf = (size <= sizeof(stack_buf)) ? stack_buf : (char*)gf_malloc(sizeof(char)*size);
+		if (!buf) return SOCKET_ERROR;
+		memcpy(buf, dg->header, dg->header_size);
+		memcpy(buf + dg->header_size, dg->data, dg->size);
+	}
+	if (sock->flags & GF_SOCK_HAS_PEER) {
+		res = (s32) sendto(sock->socket, buf, size, 0, (struct sockaddr *) &sock->dest_addr, sock->dest_addr_len);
+	} else {
+		res = (s32) send(sock->socket, buf, size, 0);
+	}
+	if ((buf != dg->data) && (buf != stack_buf)) gf_free(buf);
+	return res;
 #endif
-			default:
-				return GF_IP_NETWORK_FAILURE;
+}
+
+/*max number of datagrams per sendmmsg/recvmmsg call*/
+#define GF_SK_MAX_BATCH	64
+
+GF_EXPORT
+GF_Err gf_sk_send_batch(GF_Socket *sock, const GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_sent)
+{
+	GF_Err e;
+	u32 i, done;
+	s32 res;
+	Bool not_ready = GF_FALSE;
+	Bool retried = GF_FALSE;
+
+	if (nb_sent) *nb_sent = 0;
+	//the socket must be bound or connected
+	if (!sock || !sock->socket || (nb_dgrams && !dgrams)) return GF_BAD_PARAM;
+	if (!nb_dgrams) return GF_OK;
+
+	/*no datagram boundaries on TCP, send the buffers one after the other*/
+	if (sock->flags & GF_SOCK_IS_TCP) {
+		for (i=0; i<nb_dgrams; i++) {
+			if (dgrams[i].header_size) {
+				e = gf_sk_send(sock, dgrams[i].header, dgrams[i].header_size);
+				if (e) return e;
 			}
+			e = gf_sk_send(sock, dgrams[i].data, dgrams[i].size);
+			if (e) return e;
+			if (nb_sent) *nb_sent = i+1;
 		}
-		count += res;
+		return GF_OK;
+	}
+
+	e = gf_sk_wait_write(sock, &not_ready);
+	if (e) return e;
+
+	done = 0;
+	while (done < nb_dgrams) {
+#ifdef GPAC_HAS_MMSG
+		if (!(sock->flags & GF_SOCK_NO_MMSG)) {
+			struct mmsghdr msgs[GF_SK_MAX_BATCH];
+			struct iovec iov[2*GF_SK_MAX_BATCH];
+			u32 nb = MIN(nb_dgrams - done, GF_SK_MAX_BATCH);
+
+			memset(msgs, 0, sizeof(struct mmsghdr) * nb);
+			for (i=0; i<nb; i++) {
+				const GF_SockDatagram *dg = &dgrams[done+i];
+				struct iovec *io = &iov[2*i];
+				u32 nb_iov = 0;
+				if (dg->header_size) {
+					io[nb_iov].iov_base = (void *) dg->header;
+					io[nb_iov].iov_len = dg->header_size;
+					nb_iov++;
+				}
+				io[nb_iov].iov_base = (void *) dg->data;
+				io[nb_iov].iov_len = dg->size;
+				nb_iov++;
+				msgs[i].msg_hdr.msg_iov = io;
+				msgs[i].msg_hdr.msg_iovlen = nb_iov;
+				if (sock->flags & GF_SOCK_HAS_PEER) {
+					msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+					msgs[i].msg_hdr.msg_namelen = sock->dest_addr_len;
+				}
+			}
+			res = sendmmsg(sock->socket, msgs, nb, 0);
+			if ((res == SOCKET_ERROR) && (LASTSOCKERROR == ENOSYS)) {
+				GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[Socket] sendmmsg not supported, using one call per datagram\n"));
+				sock->flags |= GF_SOCK_NO_MMSG;
+				continue;
+			}
+		} else
+#endif
+		{
+			res = gf_sk_send_datagram(sock, &dgrams[done]);
+			if (res != SOCKET_ERROR) res = 1;
+		}
+
+		if (res == SOCKET_ERROR) {
+			/*output queue full, wait for the socket once before giving up*/
+			if ((LASTSOCKERROR == EAGAIN) && !retried) {
+				retried = GF_TRUE;
+				not_ready = GF_FALSE;
+				e = gf_sk_wait_write(sock, &not_ready);
+				if (e) {
+					if (nb_sent) *nb_sent = done;
+					return e;
+				}
+				if (!not_ready) continue;
+			}
+			if (nb_sent) *nb_sent = done;
+			return gf_sk_send_error(not_ready);
+		}
+		done += res;
+		if (res) retried = GF_FALSE;
 	}
+	if (nb_sent) *nb_sent = done;
 	return GF_OK;
 }
 
@@ -1164,40 +1371,204 @@ GF_Err gf_sk_setup_multicast(GF_Socket *sock, const char *multi_IPAdd, u16 Multi
 }
 
 #include <gpac/list.h>
+/*max number of events fetched per epoll_wait call*/
+#define GF_SK_GROUP_MAX_EVENTS	256
+
 struct __tag_sock_group
 {
 	GF_List *sockets;
 	fd_set group;
+#ifdef GPAC_HAS_EPOLL
+	/*edge-triggered epoll instance, -1 if not available (select is then used)*/
+	int epoll_fd;
+	struct epoll_event events[GF_SK_GROUP_MAX_EVENTS];
+	/*sockets readable at the last select*/
+	GF_Socket **ready;
+	struct pollfd *ready_poll;
+	u32 nb_ready, alloc_ready;
+	u32 epoch;
+	/*sockets registered before their descriptor was created*/
+	GF_List *pending;
+#endif
 };
 
+GF_EXPORT
 GF_SockGroup *gf_sk_group_new()
 {
 	GF_SockGroup *tmp;
 	GF_SAFEALLOC(tmp, GF_SockGroup);
+	if (!tmp) return NULL;
 	tmp->sockets = gf_list_new();
 	FD_ZERO(&tmp->group);
+#ifdef GPAC_HAS_EPOLL
+	tmp->pending = gf_list_new();
+	tmp->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (tmp->epoll_fd < 0) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot create epoll instance (error %d), using select\n", LASTSOCKERROR));
+	}
+#endif
 	return tmp;
 }
 
+GF_EXPORT
 void gf_sk_group_del(GF_SockGroup *sg)
 {
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epoll_fd >= 0) close(sg->epoll_fd);
+	if (sg->ready) gf_free(sg->ready);
+	if (sg->ready_poll) gf_free(sg->ready_poll);
+	gf_list_del(sg->pending);
+#endif
 	gf_list_del(sg->sockets);
 	gf_free(sg);
 }
 
+#ifdef GPAC_HAS_EPOLL
+static Bool gf_sk_group_epoll_add(GF_SockGroup *sg, GF_Socket *sk)
+{
+	struct epoll_event ev;
+	if (!sk->socket) return GF_FALSE;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN | EPOLLET;
+	ev.data.ptr = sk;
+	if (epoll_ctl(sg->epoll_fd, EPOLL_CTL_ADD, sk->socket, &ev) < 0) {
+		//socket registered several times
+		if (LASTSOCKERROR == EEXIST) return GF_TRUE;
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot add socket to epoll group (error %d)\n", LASTSOCKERROR));
+		return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+static Bool gf_sk_group_add_ready(GF_SockGroup *sg, GF_Socket *sk)
+{
+	if (sg->nb_ready == sg->alloc_ready) {
+		u32 alloc = sg->alloc_ready ? 2*sg->alloc_ready : 64;
+		GF_Socket **ready = (GF_Socket **) gf_realloc(sg->ready, sizeof(GF_Socket *) * alloc);
+		struct pollfd *ready_poll;
+		if (!ready) return GF_FALSE;
+		sg->ready = ready;
+		ready_poll = (struct pollfd *) gf_realloc(sg->ready_poll, sizeof(struct pollfd) * alloc);
+		if (!ready_poll) return GF_FALSE;
+		sg->ready_poll = ready_poll;
+		sg->alloc_ready = alloc;
+	}
+	sg->ready[sg->nb_ready] = sk;
+	sg->nb_ready++;
+	sk->ready_group = sg;
+	sk->ready_epoch = sg->epoch;
+	return GF_TRUE;
+}
+#endif
+
+GF_EXPORT
 void gf_sk_group_register(GF_SockGroup *sg, GF_Socket *sk)
 {
 	if (sg && sk) {
 		gf_list_add(sg->sockets, sk);
+#ifdef GPAC_HAS_EPOLL
+		/*the descriptor may be created later on, try again at select time*/
+		if ((sg->epoll_fd >= 0) && !gf_sk_group_epoll_add(sg, sk))
+			gf_list_add(sg->pending, sk);
+#endif
 	}
 }
+
+GF_EXPORT
 void gf_sk_group_unregister(GF_SockGroup *sg, GF_Socket *sk)
 {
 	if (sg && sk) {
 		gf_list_del_item(sg->sockets, sk);
+#ifdef GPAC_HAS_EPOLL
+		//still registered
+		if ((sg->epoll_fd < 0) || (gf_list_find(sg->sockets, sk) >= 0)) return;
+
+		gf_list_del_item(sg->pending, sk);
+		if (sk->socket) epoll_ctl(sg->epoll_fd, EPOLL_CTL_DEL, sk->socket, NULL);
+		if (sk->ready_group == sg) {
+			u32 i;
+			sk->ready_group = NULL;
+			for (i=0; i<sg->nb_ready; i++) {
+				if (sg->ready[i] != sk) continue;
+				sg->nb_ready--;
+				memmove(&sg->ready[i], &sg->ready[i+1], sizeof(GF_Socket *) * (sg->nb_ready - i));
+				break;
+			}
+		}
+#endif
+	}
+}
+
+#ifdef GPAC_HAS_EPOLL
+static GF_Err gf_sk_group_select_epoll(GF_SockGroup *sg, u32 usec_wait)
+{
+	s32 i, nb, timeout;
+	u32 nb_prev;
+	GF_Socket *sock;
+
+	sg->epoch++;
+	i=0;
+	while ((sock = gf_list_enum(sg->pending, &i))) {
+		if (gf_sk_group_epoll_add(sg, sock)) {
+			i--;
+			gf_list_rem(sg->pending, i);
+		}
+	}
+
+	/*edge-triggered events are not signaled again for sockets still holding data after the last select, check them*/
+	nb_prev = sg->nb_ready;
+	sg->nb_ready = 0;
+	if (nb_prev) {
+		for (i=0; i<(s32) nb_prev; i++) {
+			sg->ready_poll[i].fd = sg->ready[i]->socket;
+			sg->ready_poll[i].events = POLLIN;
+			sg->ready_poll[i].revents = 0;
+		}
+		nb = poll(sg->ready_poll, nb_prev, 0);
+		if (nb > 0) {
+			for (i=0; i<(s32) nb_prev; i++) {
+				if (!sg->ready_poll[i].revents) continue;
+				sock = sg->ready[i];
+				sg->ready[sg->nb_ready] = sock;
+				sg->nb_ready++;
+				sock->ready_group = sg;
+				sock->ready_epoch = sg->epoch;
+			}
+		}
+	}
+
+	/*don't wait if some sockets are already readable*/
+	timeout = sg->nb_ready ? 0 : (s32) ((usec_wait + 999) / 1000);
+	nb = epoll_wait(sg->epoll_fd, sg->events, GF_SK_GROUP_MAX_EVENTS, timeout);
+	if (nb < 0) {
+		switch (LASTSOCKERROR) {
+		case EBADF:
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot select, BAD descriptor\n"));
+			return GF_IP_CONNECTION_CLOSED;
+		case EINTR:
+			/* Interrupted system call, not really important... */
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] network is lost\n"));
+			return GF_IP_NETWORK_EMPTY;
+		default:
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot select (error %d)\n", LASTSOCKERROR));
+			return GF_IP_NETWORK_FAILURE;
+		}
 	}
+	for (i=0; i<nb; i++) {
+		sock = (GF_Socket *) sg->events[i].data.ptr;
+		//already signaled
+		if ((sock->ready_group == sg) && (sock->ready_epoch == sg->epoch)) continue;
+		if (!gf_sk_group_add_ready(sg, sock)) return GF_OUT_OF_MEM;
+	}
+	if (!sg->nb_ready) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[socket] nothing to be read\n"));
+		return GF_IP_NETWORK_EMPTY;
+	}
+	return GF_OK;
 }
+#endif
 
+GF_EXPORT
 GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait)
 {
 	s32 ready;
@@ -1206,8 +1577,18 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait)
 	u32 max_fd=0;
 	GF_Socket *sock;
 
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epoll_fd >= 0) return gf_sk_group_select_epoll(sg, usec_wait);
+#endif
+
 	FD_ZERO(&sg->group);
 	while ((sock = gf_list_enum(sg->sockets, &i))) {
+#ifndef WIN32
+		if (sock->socket >= FD_SETSIZE) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] socket descriptor %d too large for select, ignoring\n", sock->socket));
+			continue;
+		}
+#endif
 		FD_SET(sock->socket, &sg->group);
 		if (max_fd < (u32) sock->socket) max_fd = (u32) sock->socket;
 	}
@@ -1243,12 +1624,127 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait)
 	return GF_OK;
 }
 
+GF_EXPORT
 Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk)
 {
-	if (sg && sk && FD_ISSET(sk->socket, &sg->group)) return GF_TRUE;
+	if (!sg || !sk) return GF_FALSE;
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epoll_fd >= 0) {
+		u32 i;
+		if (sk->ready_group == sg) return (sk->ready_epoch == sg->epoch) ? GF_TRUE : GF_FALSE;
+		/*socket signaled since then in another group*/
+		for (i=0; i<sg->nb_ready; i++) {
+			if (sg->ready[i] == sk) return GF_TRUE;
+		}
+		return GF_FALSE;
+	}
+#endif
+#ifndef WIN32
+	if (sk->socket >= FD_SETSIZE) return GF_FALSE;
+#endif
+	if (FD_ISSET(sk->socket, &sg->group)) return GF_TRUE;
 	return GF_FALSE;
 }
 
+GF_EXPORT
+GF_Socket *gf_sk_group_enum_ready(GF_SockGroup *sg, u32 *pos)
+{
+	GF_Socket *sk;
+	if (!sg || !pos) return NULL;
+#ifdef GPAC_HAS_EPOLL
+	if (sg->epoll_fd >= 0) {
+		if (*pos >= sg->nb_ready) return NULL;
+		sk = sg->ready[*pos];
+		(*pos)++;
+		return sk;
+	}
+#endif
+	while ((sk = gf_list_enum(sg->sockets, pos))) {
+		if (gf_sk_group_sock_is_set(sg, sk)) return sk;
+	}
+	return NULL;
+}
+
+
+#ifndef __SYMBIAN32__
+/*waits at most usec microseconds for data to be available on the socket*/
+static GF_Err gf_sk_wait_read(GF_Socket *sock, u32 usec)
+{
+	s32 ready;
+#ifdef GPAC_HAS_EPOLL
+	struct pollfd pfd;
+
+	//can we read?
+	pfd.fd = sock->socket;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	ready = poll(&pfd, 1, (usec + 999) / 1000);
+#else
+	struct timeval timeout;
+	fd_set Group;
+
+	//can we read?
+	timeout.tv_sec = 0;
+	timeout.tv_usec = usec;
+	FD_ZERO(&Group);
+	FD_SET(sock->socket, &Group);
+	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+#endif
+
+	if (ready == SOCKET_ERROR) {
+		switch (LASTSOCKERROR) {
+		case EBADF:
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot select, BAD descriptor\n"));
+			return GF_IP_CONNECTION_CLOSED;
+		case EAGAIN:
+			return GF_IP_SOCK_WOULD_BLOCK;
+		case EINTR:
+			/* Interrupted system call, not really important... */
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] network is lost\n"));
+			return GF_IP_NETWORK_EMPTY;
+		default:
+			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot select (error %d)\n", LASTSOCKERROR));
+			return GF_IP_NETWORK_FAILURE;
+		}
+	}
+#ifdef GPAC_HAS_EPOLL
+	if (!ready || !(pfd.revents & (POLLIN|POLLERR|POLLHUP))) {
+#else
+	if (!ready || !FD_ISSET(sock->socket, &Group)) {
+#endif
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[socket] nothing to be read - ready %d\n", ready));
+		return GF_IP_NETWORK_EMPTY;
+	}
+	return GF_OK;
+}
+#endif
+
+/*maps the last socket error after a failed read*/
+static GF_Err gf_sk_receive_error()
+{
+	s32 res = LASTSOCKERROR;
+	switch (res) {
+	case EAGAIN:
+		return GF_IP_SOCK_WOULD_BLOCK;
+#ifndef __SYMBIAN32__
+	case EMSGSIZE:
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - socket error %d\n",  res));
+		return GF_OUT_OF_MEM;
+	case ENOTCONN:
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - not connected\n"));
+		return GF_IP_CONNECTION_CLOSED;
+	case ECONNRESET:
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - connection reset\n"));
+		return GF_IP_CONNECTION_CLOSED;
+	case ECONNABORTED:
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - connection aborted\n"));
+		return GF_IP_CONNECTION_CLOSED;
+#endif
+	default:
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - socket error %d\n",  res));
+		return GF_IP_NETWORK_FAILURE;
+	}
+}
 
 //fetch nb bytes on a socket and fill the buffer from startFrom
 //length is the allocated size of the receiving buffer
@@ -1256,11 +1752,6 @@ Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk)
 GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 startFrom, u32 *BytesRead, Bool do_select)
 {
 	s32 res;
-#ifndef __SYMBIAN32__
-	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
-#endif
 
 	*BytesRead = 0;
 	if (!sock || !sock->socket) return GF_BAD_PARAM;
@@ -1268,33 +1759,8 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 sta
 
 #ifndef __SYMBIAN32__
 	if (do_select) {
-		//can we read?
-		timeout.tv_sec = 0;
-		timeout.tv_usec = sock->usec_wait;
-		FD_ZERO(&Group);
-		FD_SET(sock->socket, &Group);
-		ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
-
-		if (ready == SOCKET_ERROR) {
-			switch (LASTSOCKERROR) {
-			case EBADF:
-				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot select, BAD descriptor\n"));
-				return GF_IP_CONNECTION_CLOSED;
-			case EAGAIN:
-				return GF_IP_SOCK_WOULD_BLOCK;
-			case EINTR:
-				/* Interrupted system call, not really important... */
-				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] network is lost\n"));
-				return GF_IP_NETWORK_EMPTY;
-			default:
-				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] cannot select (error %d)\n", LASTSOCKERROR));
-				return GF_IP_NETWORK_FAILURE;
-			}
-		}
-		if (!ready || !FD_ISSET(sock->socket, &Group)) {
-			GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[socket] nothing to be read - ready %d\n", ready));
-			return GF_IP_NETWORK_EMPTY;
-		}
+		GF_Err e = gf_sk_wait_read(sock, sock->usec_wait);
+		if (e) return e;
 	}
 #endif
 	if (sock->flags & GF_SOCK_HAS_PEER)
@@ -1305,30 +1771,7 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 sta
 			return GF_IP_CONNECTION_CLOSED;
 	}
 
-	if (res == SOCKET_ERROR) {
-		res = LASTSOCKERROR;
-		switch (res) {
-		case EAGAIN:
-			return GF_IP_SOCK_WOULD_BLOCK;
-#ifndef __SYMBIAN32__
-		case EMSGSIZE:
-			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - socket error %d\n",  res));
-			return GF_OUT_OF_MEM;
-		case ENOTCONN:
-			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - not connected\n"));
-			return GF_IP_CONNECTION_CLOSED;
-		case ECONNRESET:
-			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - connection reset\n"));
-			return GF_IP_CONNECTION_CLOSED;
-		case ECONNABORTED:
-			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - connection aborted\n"));
-			return GF_IP_CONNECTION_CLOSED;
-#endif
-		default:
-			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading - socket error %d\n",  res));
-			return GF_IP_NETWORK_FAILURE;
-		}
-	}
+	if (res == SOCKET_ERROR) return gf_sk_receive_error();
 	if (!res) return GF_IP_NETWORK_EMPTY;
 	*BytesRead = res;
 	return GF_OK;
@@ -1346,6 +1789,164 @@ GF_Err gf_sk_receive_no_select(GF_Socket *sock, char *buffer, u32 length, u32 st
 	return gf_sk_receive_internal(sock, buffer, length, startFrom, BytesRead, GF_FALSE);
 }
 
+GF_EXPORT
+GF_Err gf_sk_probe(GF_Socket *sock)
+{
+	s32 res;
+	char c;
+	if (!sock || !sock->socket) return GF_BAD_PARAM;
+#ifndef __SYMBIAN32__
+	{
+		GF_Err e = gf_sk_wait_read(sock, 0);
+		if (e == GF_IP_NETWORK_EMPTY) return GF_OK;
+		if (e) return GF_IP_CONNECTION_CLOSED;
+	}
+#endif
+	//readable idle connection: either closed by peer or holding unexpected data
+	res = (s32) recv(sock->socket, &c, 1, MSG_PEEK);
+	if (res == SOCKET_ERROR) {
+		if (LASTSOCKERROR == EAGAIN) return GF_OK;
+		return GF_IP_CONNECTION_CLOSED;
+	}
+	if (!res) return GF_IP_CONNECTION_CLOSED;
+	return GF_IP_NETWORK_FAILURE;
+}
+
+GF_EXPORT
+GF_Err gf_sk_receive_batch(GF_Socket *sock, char **buffers, u32 buffer_size, u32 *sizes, u32 nb_buffers, u32 *nb_received)
+{
+	GF_Err e;
+	u32 i;
+
+	if (nb_received) *nb_received = 0;
+	if (!sock || !sock->socket || !buffers || !sizes || !nb_received || !buffer_size) return GF_BAD_PARAM;
+	if (!nb_buffers) return GF_OK;
+
+	/*no datagram boundaries on TCP*/
+	if (sock->flags & GF_SOCK_IS_TCP) {
+		e = gf_sk_receive_internal(sock, buffers[0], buffer_size, 0, &sizes[0], GF_TRUE);
+		if (!e) *nb_received = 1;
+		return e;
+	}
+
+#ifndef __SYMBIAN32__
+	e = gf_sk_wait_read(sock, sock->usec_wait);
+	if (e) return e;
+#endif
+
+#ifdef GPAC_HAS_MMSG
+	if (!(sock->flags & GF_SOCK_NO_MMSG)) {
+		struct mmsghdr msgs[GF_SK_MAX_BATCH];
+		struct iovec iov[GF_SK_MAX_BATCH];
+		union {
+			struct cmsghdr align;
+			char buf[CMSG_SPACE(sizeof(u32))];
+		} ctrl[GF_SK_MAX_BATCH];
+		s32 res;
+
+#ifdef SO_RXQ_OVFL
+		/*ask the kernel to report the number of datagrams dropped on this socket*/
+		if (!(sock->flags & GF_SOCK_RXQ_OVFL)) {
+			s32 on = 1;
+			if (setsockopt(sock->socket, SOL_SOCKET, SO_RXQ_OVFL, (char *) &on, sizeof(on)) < 0) {
+				GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[Socket] cannot enable drop counter (error %d)\n", LASTSOCKERROR));
+			}
+			sock->flags |= GF_SOCK_RXQ_OVFL;
+		}
+#endif
+		if (nb_buffers > GF_SK_MAX_BATCH) nb_buffers = GF_SK_MAX_BATCH;
+		memset(msgs, 0, sizeof(struct mmsghdr) * nb_buffers);
+		for (i=0; i<nb_buffers; i++) {
+			iov[i].iov_base = buffers[i];
+			iov[i].iov_len = buffer_size;
+			msgs[i].msg_hdr.msg_iov = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_control = ctrl[i].buf;
+			msgs[i].msg_hdr.msg_controllen = sizeof(ctrl[i].buf);
+			if (sock->flags & GF_SOCK_HAS_PEER) {
+				msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+				msgs[i].msg_hdr.msg_namelen = sizeof(sock->dest_addr);
+			}
+		}
+		/*the socket is readable, fetch everything pending without blocking*/
+		res = recvmmsg(sock->socket, msgs, nb_buffers, MSG_DONTWAIT, NULL);
+		if ((res == SOCKET_ERROR) && (LASTSOCKERROR == ENOSYS)) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[Socket] recvmmsg not supported, using one call per datagram\n"));
+			sock->flags |= GF_SOCK_NO_MMSG;
+		} else {
+			if (res == SOCKET_ERROR) return gf_sk_receive_error();
+			for (i=0; i<(u32) res; i++) {
+				struct msghdr *msg = &msgs[i].msg_hdr;
+#ifdef SO_RXQ_OVFL
+				struct cmsghdr *cmsg;
+				for (cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+					if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SO_RXQ_OVFL)) {
+						u32 drops;
+						memcpy(&drops, CMSG_DATA(cmsg), sizeof(u32));
+						/*cumulative count since the socket creation*/
+						if (drops > sock->nb_dropped) sock->nb_dropped = drops;
+					}
+				}
+#endif
+				if (msg->msg_flags & MSG_TRUNC) {
+					GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[Socket] datagram larger than %d bytes, dropping\n", buffer_size));
+					sock->nb_truncated++;
+					sizes[i] = 0;
+				} else {
+					sizes[i] = msgs[i].msg_len;
+					sock->nb_rcv++;
+				}
+			}
+			if (res && (sock->flags & GF_SOCK_HAS_PEER))
+				sock->dest_addr_len = msgs[res-1].msg_hdr.msg_namelen;
+			*nb_received = res;
+			return res ? GF_OK : GF_IP_NETWORK_EMPTY;
+		}
+	}
+#endif
+
+#ifdef __SYMBIAN32__
+	/*no way to check for pending data, read a single datagram*/
+	nb_buffers = 1;
+#endif
+	/*one call per datagram, only waiting for the first one*/
+	for (i=0; i<nb_buffers; i++) {
+#ifndef __SYMBIAN32__
+		if (i && gf_sk_wait_read(sock, 0)) break;
+#endif
+		e = gf_sk_receive_internal(sock, buffers[i], buffer_size, 0, &sizes[i], GF_FALSE);
+		if (e == GF_OUT_OF_MEM) {
+			sock->nb_truncated++;
+			sizes[i] = 0;
+		} else if (e) {
+			if (!i) return e;
+			break;
+		} else {
+			sock->nb_rcv++;
+		}
+	}
+	*nb_received = i;
+	return GF_OK;
+}
+
+GF_EXPORT
+void gf_sk_get_receive_stats(GF_Socket *sock, u32 *nb_received, u32 *nb_dropped, u32 *nb_truncated)
+{
+#if defined(__linux__) && defined(SO_MEMINFO)
+	/*drop counter of the socket, also counting datagrams dropped after the last read*/
+	if (sock && sock->socket) {
+		u32 meminfo[SK_MEMINFO_VARS];
+		socklen_t len = sizeof(meminfo);
+		if (!getsockopt(sock->socket, SOL_SOCKET, SO_MEMINFO, meminfo, &len) && (len > SK_MEMINFO_DROPS*sizeof(u32))) {
+			if (meminfo[SK_MEMINFO_DROPS] > sock->nb_dropped) sock->nb_dropped = meminfo[SK_MEMINFO_DROPS];
+		}
+	}
+#endif
+	if (nb_received) *nb_received = sock ? sock->nb_rcv : 0;
+	if (nb_dropped) *nb_dropped = sock ? sock->nb_dropped : 0;
+	if (nb_truncated) *nb_truncated = sock ? sock->nb_truncated : 0;
+}
+
 GF_EXPORT
 GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 {
@@ -43,6 +43,7 @@ typedef HANDLE TH_HANDLE;
 #include <pthread.h>
 #include <semaphore.h>
 #include <errno.h>
+#include <time.h>
 typedef pthread_t TH_HANDLE ;
 
 #endif
@@ -779,12 +780,30 @@ Bool gf_sema_wait_for(GF_Semaphore *sm, u32 TimeOut)
 		if (!sem_trywait(hSem)) return GF_TRUE;
 		return GF_FALSE;
 	}
+#if defined(__DARWIN__) || defined(__APPLE__)
+	/*no sem_timedwait on OSX, poll*/
 	TimeOut += gf_sys_clock();
 	do {
 		if (!sem_trywait(hSem)) return GF_TRUE;
 		gf_sleep(1);
 	} while (gf_sys_clock() < TimeOut);
 	return GF_FALSE;
+#else
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_sec += TimeOut / 1000;
+		ts.tv_nsec += (TimeOut % 1000) * 1000000;
+		if (ts.tv_nsec >= 1000000000) {
+			ts.tv_sec += 1;
+			ts.tv_nsec -= 1000000000;
+		}
+		while (sem_timedwait(hSem, &ts) < 0) {
+			if (errno != EINTR) return GF_FALSE;
+		}
+		return GF_TRUE;
+	}
+#endif
 #endif
 }
 
@@ -151,7 +151,7 @@ endif
 ifeq ($(DISABLE_SVG), no)
 OBJS+=../modules/laser_dec/laser_dec.o
 endif
-OBJS+=../modules/soft_raster/ftgrays.o ../modules/soft_raster/raster_load.o ../modules/soft_raster/raster_565.o ../modules/soft_raster/raster_argb.o ../modules/soft_raster/raster_rgb.o ../modules/soft_raster/stencil.o ../modules/soft_raster/surface.o
+OBJS+=../modules/soft_raster/ftgrays.o ../modules/soft_raster/raster_load.o ../modules/soft_raster/raster_565.o ../modules/soft_raster/raster_argb.o ../modules/soft_raster/raster_rgb.o ../modules/soft_raster/raster_simd.o ../modules/soft_raster/stencil.o ../modules/soft_raster/surface.o
 
 OBJS+=../modules/mp3_in/mp3_in.o
 ifneq ($(CONFIG_MAD), no)